@@ -28,6 +28,7 @@ option(PACKAGEONLY "Build without dependencies" OFF)
 option(CLIENT "Build only client packages" OFF)
 option(BUILD_XRDCL_RAIN_PLUGIN "Enable XrdCl RAIN plugin" OFF)
 option(BUILD_CSS_PLUGIN "Enable CSS plugin" ON)
+option(BUILD_PARQUET_EXPORT "Enable the Parquet export of eos-ns-inspect" OFF)
 
 # Find default versions of Python with higher priority
 set(Python_FIND_UNVERSIONED_NAMES  "FIRST" CACHE STRING "")
@@ -62,6 +63,12 @@ if(NOT PACKAGEONLY)
   find_package(isal_crypto)
   find_package(isal)
   find_package(xxhash)
+  if (BUILD_PARQUET_EXPORT)
+    find_package(parquet)
+  else()
+    add_library(PARQUET::PARQUET INTERFACE IMPORTED)
+  endif()
+
   find_package(libbfd)
   find_package(davix)
   find_package(nfs)
@@ -184,6 +191,7 @@ else()
   add_library(ISAL::ISAL                   INTERFACE IMPORTED)
   add_library(ISAL::ISAL_CRYPTO            INTERFACE IMPORTED)
   add_library(XXHASH::XXHASH               INTERFACE IMPORTED)
+  add_library(PARQUET::PARQUET             INTERFACE IMPORTED)
   add_library(JEMALLOC::JEMALLOC           INTERFACE IMPORTED)
   add_library(EosGrpcGateway::EosGrpcGateway INTERFACE IMPORTED)
   add_library(fmt::fmt-header-only         INTERFACE IMPORTED)
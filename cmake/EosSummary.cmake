@@ -54,6 +54,7 @@ message(STATUS "grpc-build    : ${GRPC_FOUND}")
 message(STATUS "isa-l_crypto  : ${ISAL_CRYPTO_FOUND}")
 message(STATUS "isa-l         : ${ISAL_FOUND}")
 message(STATUS "xxhash        : ${XXHASH_FOUND}")
+message(STATUS "parquet       : ${PARQUET_FOUND}")
 message(STATUS "davix         : ${DAVIX_FOUND}")
 message( STATUS "................................................." )
 message( STATUS "C Compiler    : " ${CMAKE_C_COMPILER} )
@@ -0,0 +1,52 @@
+# Try to find Apache Parquet (and Arrow) C++ libraries (devel)
+# Once done, this will define
+#
+# PARQUET_FOUND          - system has parquet and arrow
+# PARQUET_INCLUDE_DIRS   - parquet/arrow include directories
+# PARQUET_LIBRARIES      - parquet and arrow libraries
+#
+# and the following imported target
+#
+# PARQUET::PARQUET
+
+find_path(PARQUET_INCLUDE_DIR
+  NAMES parquet/arrow/writer.h
+  HINTS ${PARQUET_ROOT} ${ARROW_ROOT}
+  PATH_SUFFIXES include)
+
+find_path(ARROW_INCLUDE_DIR
+  NAMES arrow/api.h
+  HINTS ${ARROW_ROOT} ${PARQUET_ROOT}
+  PATH_SUFFIXES include)
+
+find_library(PARQUET_LIBRARY
+  NAMES parquet
+  HINTS ${PARQUET_ROOT} ${ARROW_ROOT}
+  PATH_SUFFIXES ${CMAKE_INSTALL_LIBDIR})
+
+find_library(ARROW_LIBRARY
+  NAMES arrow
+  HINTS ${ARROW_ROOT} ${PARQUET_ROOT}
+  PATH_SUFFIXES ${CMAKE_INSTALL_LIBDIR})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(parquet
+  REQUIRED_VARS PARQUET_LIBRARY PARQUET_INCLUDE_DIR
+                ARROW_LIBRARY ARROW_INCLUDE_DIR)
+mark_as_advanced(PARQUET_LIBRARY PARQUET_INCLUDE_DIR
+                 ARROW_LIBRARY ARROW_INCLUDE_DIR)
+
+if (PARQUET_FOUND AND NOT TARGET PARQUET::PARQUET)
+  add_library(PARQUET::PARQUET UNKNOWN IMPORTED)
+  set_target_properties(PARQUET::PARQUET PROPERTIES
+    IMPORTED_LOCATION "${PARQUET_LIBRARY}"
+    INTERFACE_INCLUDE_DIRECTORIES "${PARQUET_INCLUDE_DIR};${ARROW_INCLUDE_DIR}"
+    INTERFACE_LINK_LIBRARIES "${ARROW_LIBRARY}")
+  target_compile_definitions(PARQUET::PARQUET INTERFACE PARQUET_FOUND)
+else()
+  message(WARNING "Notice: Parquet not found, no columnar export support")
+  add_library(PARQUET::PARQUET INTERFACE IMPORTED)
+endif()
+
+set(PARQUET_INCLUDE_DIRS ${PARQUET_INCLUDE_DIR} ${ARROW_INCLUDE_DIR})
+set(PARQUET_LIBRARIES ${PARQUET_LIBRARY} ${ARROW_LIBRARY})
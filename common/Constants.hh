@@ -153,5 +153,13 @@ static constexpr auto SPACE_CACHE_HIGH_WATERMARK_NAME = "cache.high_watermark";
 //! Default cache watermarks (percent of filesystem capacity used)
 static constexpr auto SPACE_CACHE_LOW_WATERMARK_DEFAULT = "70";
 static constexpr auto SPACE_CACHE_HIGH_WATERMARK_DEFAULT = "85";
+//! Backend space config: popularity driven prefetch into the cache space
+static constexpr auto SPACE_CACHE_PREFETCH_NAME = "cache.prefetch";
+//! Backend space config: prefetch bandwidth budget in MB/s
+static constexpr auto SPACE_CACHE_PREFETCH_BANDWIDTH_NAME =
+  "cache.prefetch.bandwidth";
+static constexpr auto SPACE_CACHE_PREFETCH_BANDWIDTH_DEFAULT = "100";
+//! Backend space config: comma separated directories always kept warm
+static constexpr auto SPACE_CACHE_PREFETCH_PATHS_NAME = "cache.prefetch.paths";
 
 EOSCOMMONNAMESPACE_END
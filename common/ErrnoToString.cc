@@ -24,6 +24,7 @@
 #include "common/Strerror_r_wrapper.hh"
 #include "common/ErrnoToString.hh"
 #include <sstream>
+#include <utility>
 
 EOSCOMMONNAMESPACE_BEGIN
 
@@ -63,4 +64,26 @@ std::string ErrnoToString(int errnum)
   }
 }
 
+//------------------------------------------------------------------------------
+// Get the error number from the tag embedded in an error message
+//------------------------------------------------------------------------------
+int ErrnoFromMsgTag(const std::string& msg, int default_errnum)
+{
+  // If several tags are present the last one in this list wins
+  static const std::pair<const char*, int> tags[] = {
+    {"[EIDRM]", EIDRM}, {"[EBADE]", EBADE}, {"[EBADR]", EBADR},
+    {"[EINVAL]", EINVAL}, {"[EADV]", EADV}, {"[EAGAIN]", EAGAIN},
+    {"[ENOTCONN]", ENOTCONN}, {"[EPROTO]", EPROTO}, {"[EREMCHG]", EREMCHG}
+  };
+  int errnum = default_errnum;
+
+  for (const auto& tag : tags) {
+    if (msg.find(tag.first) != std::string::npos) {
+      errnum = tag.second;
+    }
+  }
+
+  return errnum;
+}
+
 EOSCOMMONNAMESPACE_END
@@ -36,4 +36,16 @@ EOSCOMMONNAMESPACE_BEGIN
 //------------------------------------------------------------------------------
 std::string ErrnoToString(int errnum);
 
+//------------------------------------------------------------------------------
+//! Get the error number from the "[E...]" tag embedded in an error message
+//! returned by the MGM e.g. "commit - file is already removed [EIDRM]". Only
+//! the tags the FSTs act upon are recognized.
+//!
+//! @param msg error message
+//! @param default_errnum value returned if no known tag is found
+//!
+//! @return error number
+//------------------------------------------------------------------------------
+int ErrnoFromMsgTag(const std::string& msg, int default_errnum);
+
 EOSCOMMONNAMESPACE_END
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+// File: HyperLogLog.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "common/Namespace.hh"
+#include "common/Murmur3.hh"
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class HyperLogLog - estimator of the number of distinct values in a stream
+//! e.g. the number of different uids owning files in a subtree.
+//!
+//! The sketch uses 2^sPrecision one byte registers (4 KB) and has a relative
+//! standard error of about 1.04/sqrt(2^sPrecision) i.e. 1.6%. Small
+//! cardinalities are estimated with linear counting and are exact in
+//! practice. Sketches are mergeable but values can not be removed. The object
+//! is not thread-safe, the caller must serialize the accesses.
+//------------------------------------------------------------------------------
+class HyperLogLog
+{
+public:
+  static constexpr uint32_t sPrecision = 12;
+  static constexpr uint32_t sNumRegisters = (1u << sPrecision);
+
+  //----------------------------------------------------------------------------
+  //! Record a value
+  //----------------------------------------------------------------------------
+  inline void
+  Add(uint64_t value)
+  {
+    AddHash(Murmur3::MurmurHasher<uint64_t>()(value));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Record an already hashed value, the hash must be uniformly distributed
+  //----------------------------------------------------------------------------
+  inline void
+  AddHash(uint64_t hash)
+  {
+    const uint32_t index = hash >> (64 - sPrecision);
+    const uint64_t rest = (hash << sPrecision) | (1ull << (sPrecision - 1));
+    const uint8_t rank = __builtin_clzll(rest) + 1;
+
+    if (rank > mRegisters[index]) {
+      mRegisters[index] = rank;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Merge the contents of another sketch into the current one
+  //----------------------------------------------------------------------------
+  void
+  Merge(const HyperLogLog& other)
+  {
+    for (uint32_t i = 0; i < sNumRegisters; ++i) {
+      if (other.mRegisters[i] > mRegisters[i]) {
+        mRegisters[i] = other.mRegisters[i];
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Reset the sketch
+  //----------------------------------------------------------------------------
+  void
+  Reset()
+  {
+    mRegisters.fill(0);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get estimated number of distinct values recorded
+  //----------------------------------------------------------------------------
+  uint64_t
+  Estimate() const
+  {
+    const double m = sNumRegisters;
+    double sum = 0.0;
+    uint32_t zeros = 0;
+
+    for (const auto reg : mRegisters) {
+      sum += std::ldexp(1.0, -reg);
+
+      if (reg == 0) {
+        ++zeros;
+      }
+    }
+
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+
+    // Small range correction
+    if ((estimate <= 2.5 * m) && zeros) {
+      estimate = m * std::log(m / zeros);
+    }
+
+    return (uint64_t) std::llround(estimate);
+  }
+
+private:
+  std::array<uint8_t, sNumRegisters> mRegisters {};
+};
+
+EOSCOMMONNAMESPACE_END
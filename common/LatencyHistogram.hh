@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+// File: LatencyHistogram.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "common/Namespace.hh"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class LatencyHistogram - lock-free log-linear histogram of unsigned values
+//! e.g. latencies in microseconds or sizes in bytes.
+//!
+//! Every power of two interval is split in sSubBuckets linear sub-buckets,
+//! therefore the relative error of any reported percentile is bounded by
+//! 1/sSubBuckets (12.5%) while the whole uint64_t range fits in a few hundred
+//! counters. Recording a value is a couple of relaxed atomic increments so the
+//! object can be shared by any number of threads. Histograms are mergeable,
+//! which allows keeping one per thread/shard and aggregating on demand.
+//------------------------------------------------------------------------------
+class LatencyHistogram
+{
+public:
+  //! Number of linear sub-buckets per power of two, must be a power of two
+  static constexpr uint64_t sSubBuckets = 8;
+  static constexpr uint64_t sSubBits = 3;
+  //! Total number of buckets needed to cover the uint64_t range
+  static constexpr size_t sNumBuckets = (64 - sSubBits + 1) * sSubBuckets;
+
+  //----------------------------------------------------------------------------
+  //! Record a value
+  //!
+  //! @param value value to record
+  //! @param count number of times the value is recorded
+  //----------------------------------------------------------------------------
+  inline void
+  Add(uint64_t value, uint64_t count = 1)
+  {
+    mBuckets[GetBucketIndex(value)].fetch_add(count, std::memory_order_relaxed);
+    mCount.fetch_add(count, std::memory_order_relaxed);
+    mSum.fetch_add(value * count, std::memory_order_relaxed);
+    uint64_t max = mMax.load(std::memory_order_relaxed);
+
+    while ((value > max) &&
+           !mMax.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+  }
+
+  //----------------------------------------------------------------------------
+  //! Merge the contents of another histogram into the current one
+  //----------------------------------------------------------------------------
+  void
+  Merge(const LatencyHistogram& other)
+  {
+    for (size_t i = 0; i < sNumBuckets; ++i) {
+      const uint64_t val = other.mBuckets[i].load(std::memory_order_relaxed);
+
+      if (val) {
+        mBuckets[i].fetch_add(val, std::memory_order_relaxed);
+      }
+    }
+
+    mCount.fetch_add(other.GetCount(), std::memory_order_relaxed);
+    mSum.fetch_add(other.GetSum(), std::memory_order_relaxed);
+    const uint64_t other_max = other.GetMax();
+    uint64_t max = mMax.load(std::memory_order_relaxed);
+
+    while ((other_max > max) &&
+           !mMax.compare_exchange_weak(max, other_max,
+                                       std::memory_order_relaxed)) {}
+  }
+
+  //----------------------------------------------------------------------------
+  //! Reset all the counters
+  //----------------------------------------------------------------------------
+  void
+  Reset()
+  {
+    for (auto& bucket : mBuckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+
+    mCount.store(0, std::memory_order_relaxed);
+    mSum.store(0, std::memory_order_relaxed);
+    mMax.store(0, std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get value below which the given percentage of the recorded values fall.
+  //! The result is the upper bound of the matching bucket capped by the
+  //! maximum recorded value.
+  //!
+  //! @param percentile value in the range [0, 100]
+  //!
+  //! @return percentile value or 0 if nothing was recorded
+  //----------------------------------------------------------------------------
+  uint64_t
+  GetPercentile(double percentile) const
+  {
+    const uint64_t total = GetCount();
+
+    if (total == 0) {
+      return 0;
+    }
+
+    if (percentile < 0.0) {
+      percentile = 0.0;
+    } else if (percentile > 100.0) {
+      percentile = 100.0;
+    }
+
+    uint64_t rank = (uint64_t) std::ceil(total * percentile / 100.0);
+
+    if (rank == 0) {
+      rank = 1;
+    }
+
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < sNumBuckets; ++i) {
+      seen += mBuckets[i].load(std::memory_order_relaxed);
+
+      if (seen >= rank) {
+        const uint64_t upper = GetBucketUpperBound(i);
+        const uint64_t max = GetMax();
+        return (upper < max) ? upper : max;
+      }
+    }
+
+    return GetMax();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of recorded values
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetCount() const
+  {
+    return mCount.load(std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get sum of recorded values
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetSum() const
+  {
+    return mSum.load(std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get maximum recorded value
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetMax() const
+  {
+    return mMax.load(std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get average of the recorded values
+  //----------------------------------------------------------------------------
+  inline double
+  GetMean() const
+  {
+    const uint64_t count = GetCount();
+    return count ? (double) GetSum() / count : 0.0;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of values recorded in the given bucket
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetBucketCount(size_t index) const
+  {
+    return (index < sNumBuckets) ?
+           mBuckets[index].load(std::memory_order_relaxed) : 0;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get index of the bucket holding the given value
+  //----------------------------------------------------------------------------
+  static inline size_t
+  GetBucketIndex(uint64_t value)
+  {
+    if (value < sSubBuckets) {
+      return value;
+    }
+
+    const uint64_t msb = 63 - __builtin_clzll(value);
+    const uint64_t shift = msb - sSubBits;
+    return ((msb - sSubBits + 1) * sSubBuckets) +
+           ((value >> shift) & (sSubBuckets - 1));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get smallest value that falls in the given bucket
+  //----------------------------------------------------------------------------
+  static inline uint64_t
+  GetBucketLowerBound(size_t index)
+  {
+    if (index < sSubBuckets) {
+      return index;
+    }
+
+    const uint64_t shift = (index / sSubBuckets) - 1;
+    return (sSubBuckets + (index % sSubBuckets)) << shift;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get largest value that falls in the given bucket
+  //----------------------------------------------------------------------------
+  static inline uint64_t
+  GetBucketUpperBound(size_t index)
+  {
+    if (index < sSubBuckets) {
+      return index;
+    }
+
+    const uint64_t shift = (index / sSubBuckets) - 1;
+    return GetBucketLowerBound(index) + ((1ull << shift) - 1);
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, sNumBuckets> mBuckets {};
+  std::atomic<uint64_t> mCount {0};
+  std::atomic<uint64_t> mSum {0};
+  std::atomic<uint64_t> mMax {0};
+};
+
+EOSCOMMONNAMESPACE_END
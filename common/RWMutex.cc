@@ -26,6 +26,7 @@
 #include "common/RWMutex.hh"
 #include "common/PthreadRWMutex.hh"
 #include "common/SharedMutex.hh"
+#include "common/Tracing.hh"
 #include <sys/syscall.h>
 #include <sstream>
 #include <exception>
@@ -1371,7 +1372,14 @@ RWMutexWriteLock::Grab(RWMutex& mutex, const char* function,
   mWrMutex = &mutex;
   RWMutex::RecordMutexOp((uint64_t)mWrMutex->GetRawPtr(),
                          RWMutex::LOCK_T::eWantLockWrite);
+  TraceSpan wait_span;
+
+  if (Tracer::IsTracing()) {
+    wait_span.Begin(("wr." + mWrMutex->getName()).c_str(), SpanKind::kLockWait);
+  }
+
   mWrMutex->LockWrite();
+  wait_span.End();
   RWMutex::RecordMutexOp((uint64_t)mWrMutex->GetRawPtr(),
                          RWMutex::LOCK_T::eLockWrite);
   mAcquiredAt = std::chrono::steady_clock::now();
@@ -1449,7 +1457,14 @@ RWMutexReadLock::Grab(RWMutex& mutex, const char* function,
   mRdMutex = &mutex;
   RWMutex::RecordMutexOp((uint64_t)mRdMutex->GetRawPtr(),
                          RWMutex::LOCK_T::eWantLockRead);
+  TraceSpan wait_span;
+
+  if (Tracer::IsTracing()) {
+    wait_span.Begin(("rd." + mRdMutex->getName()).c_str(), SpanKind::kLockWait);
+  }
+
   mRdMutex->LockRead();
+  wait_span.End();
   RWMutex::RecordMutexOp((uint64_t)mRdMutex->GetRawPtr(),
                          RWMutex::LOCK_T::eLockRead);
   // mAcquiredAt must be updated _after_ we get the lock, since LockRead
@@ -23,6 +23,10 @@
 
 #include <sstream>
 #include <iomanip>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <strings.h>
 #include <openssl/evp.h>
 #include <openssl/opensslv.h>
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
@@ -800,12 +804,100 @@ SymKeyStore::GetCurrentKey()
   return 0;
 }
 
+namespace
+{
+//------------------------------------------------------------------------------
+//! Cache of recently verified compact capabilities. The same capability is
+//! typically extracted several times per open (open, stat, checksum etc.), so
+//! we key the entries by the trailing part of the token holding the
+//! authentication tag and compare the full token on a hit.
+//------------------------------------------------------------------------------
+class VerifiedCapabilityCache
+{
+public:
+  static constexpr size_t sMaxEntries = 16384;
+  static constexpr size_t sKeyLen = 24; ///< Covers the 16 bytes tag
+
+  bool Get(std::string_view token, std::string& plaintext, uint64_t& expiry)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mEntries.find(GetKey(token));
+
+    if ((it == mEntries.end()) || (it->second.mToken != token)) {
+      return false;
+    }
+
+    plaintext = it->second.mPlaintext;
+    expiry = it->second.mExpiry;
+    return true;
+  }
+
+  void Put(std::string_view token, const std::string& plaintext,
+           uint64_t expiry)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::string key = GetKey(token);
+
+    if (mEntries.count(key)) {
+      return;
+    }
+
+    // Evict in insertion order, expired entries go first anyway
+    while (mOrder.size() >= sMaxEntries) {
+      mEntries.erase(mOrder.front());
+      mOrder.pop_front();
+    }
+
+    mEntries.emplace(key, Entry{std::string(token), plaintext, expiry});
+    mOrder.push_back(std::move(key));
+  }
+
+private:
+  struct Entry {
+    std::string mToken;
+    std::string mPlaintext;
+    uint64_t mExpiry;
+  };
+
+  static std::string GetKey(std::string_view token)
+  {
+    return std::string(token.size() > sKeyLen ?
+                       token.substr(token.size() - sKeyLen) : token);
+  }
+
+  std::mutex mMutex;
+  std::unordered_map<std::string, Entry> mEntries;
+  std::deque<std::string> mOrder;
+};
+
+VerifiedCapabilityCache sVerifiedCaps;
+
+//------------------------------------------------------------------------------
+//! Resolve the default capability format
+//------------------------------------------------------------------------------
+SymKey::CapabilityFormat
+GetDefaultCapabilityFormat()
+{
+  static const SymKey::CapabilityFormat sFormat = []() {
+    const char* ptr = getenv("EOS_CAPABILITY_FORMAT");
+
+    if (ptr && (strcasecmp(ptr, "compact") == 0)) {
+      return SymKey::CapabilityFormat::Compact;
+    }
+
+    return SymKey::CapabilityFormat::Aead;
+  }();
+  return sFormat;
+}
+}
+
 //------------------------------------------------------------------------------
 // Create EOS specific capability and append to the output env object
 //------------------------------------------------------------------------------
 int
 SymKey::CreateCapability(XrdOucEnv* inenv, XrdOucEnv*& outenv,
-                         SymKey* key, std::chrono::seconds validity)
+                         SymKey* key, std::chrono::seconds validity,
+                         CapabilityFormat format)
 {
   if (!key) {
     return ENOKEY;
@@ -820,14 +912,38 @@ SymKey::CreateCapability(XrdOucEnv* inenv, XrdOucEnv*& outenv,
     outenv = nullptr;
   }
 
+  if (format == CapabilityFormat::Default) {
+    format = GetDefaultCapabilityFormat();
+  }
+
   int envlen;
   XrdOucString toencrypt = inenv->Env(envlen);
   // Add the validity time
+  const uint64_t expiry = time(NULL) + validity.count();
   toencrypt += "&cap.valid=";
   char svalidity[32];
-  snprintf(svalidity, 32, "%llu",
-           (long long unsigned int)(time(NULL) + validity.count()));
+  snprintf(svalidity, 32, "%llu", (long long unsigned int) expiry);
   toencrypt += svalidity;
+  XrdOucString encenv = "";
+  encenv += "cap.key=";
+  encenv += key->GetDigest64();
+  encenv += "&";
+
+  if (format == CapabilityFormat::Compact) {
+    std::string token;
+
+    try {
+      token = key->GetUriCapCipher().encryptCompact(toencrypt.c_str(), expiry);
+    } catch (...) {
+      return EKEYREJECTED;
+    }
+
+    encenv += "cap.format=AEAD2&cap.bin=";
+    encenv += token.c_str();
+    outenv = new XrdOucEnv(encenv.c_str());
+    return 0;
+  }
+
   std::string cgi;
   try {
     cgi = key->GetUriCapCipher().encryptToCgiFields(toencrypt.c_str());
@@ -835,10 +951,6 @@ SymKey::CreateCapability(XrdOucEnv* inenv, XrdOucEnv*& outenv,
     return EKEYREJECTED;
   }
 
-  XrdOucString encenv = "";
-  encenv += "cap.key=";
-  encenv += key->GetDigest64();
-  encenv += "&";
   encenv += "cap.format=AEAD";
   encenv += "&";
   encenv += cgi.c_str();
@@ -865,6 +977,46 @@ SymKey::ExtractCapability(XrdOucEnv* inenv, XrdOucEnv*& outenv)
     return EINVAL;
   }
 
+  const char* informat = inenv->Get("cap.format");
+
+  if (informat && (strcmp(informat, "AEAD2") == 0)) {
+    // Compact format is URI-safe, no need to rebuild and re-parse the env
+    const char* keydigest = inenv->Get("cap.key");
+    const char* token = inenv->Get("cap.bin");
+
+    if (!keydigest || !token) {
+      return EINVAL;
+    }
+
+    eos::common::SymKey* key = eos::common::gSymKeyStore.GetKey(keydigest);
+
+    if (!key) {
+      return ENOKEY;
+    }
+
+    std::string decrypted;
+    uint64_t expiry = 0;
+
+    if (!sVerifiedCaps.Get(token, decrypted, expiry)) {
+      decrypted = key->GetUriCapCipher().decryptCompact(token, expiry);
+
+      if (decrypted.empty()) {
+        return EKEYREJECTED;
+      }
+
+      sVerifiedCaps.Put(token, decrypted, expiry);
+    }
+
+    outenv = new XrdOucEnv(decrypted.c_str());
+
+    // Capability expired!!!
+    if ((time_t) expiry < time(NULL)) {
+      return ETIME;
+    }
+
+    return 0;
+  }
+
   int envlen;
   XrdOucString instring = inenv->Env(envlen);
 
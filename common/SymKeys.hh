@@ -111,6 +111,20 @@ public:
   static bool SymmetricStringDecrypt(XrdOucString& in, XrdOucString& out,
                                      char* key);
 
+  //----------------------------------------------------------------------------
+  //! Capability wire formats
+  //!
+  //! Aead: cap.sym (KDF header) and cap.msg fields, see UriCapCipher
+  //! Compact: single cap.bin token with a fixed binary header holding the
+  //! expiry, authenticated together with the ciphertext. Verified compact
+  //! capabilities are cached so repeated extractions skip the decryption.
+  //! Default: Aead unless EOS_CAPABILITY_FORMAT=compact is set, which must only
+  //! be done once all the FSTs understand the compact format.
+  //----------------------------------------------------------------------------
+  enum class CapabilityFormat {
+    Default, Aead, Compact
+  };
+
   //----------------------------------------------------------------------------
   //! Create EOS specific capability and append to the output env object
   //!
@@ -118,11 +132,13 @@ public:
   //! @param outenv output env object
   //! @param key key object used for encrypting the capability
   //! @param validity duration for which the capability is valid
+  //! @param format capability wire format
   //!
   //! @return 0 if successful, otherwise errno
   //----------------------------------------------------------------------------
   static int CreateCapability(XrdOucEnv* inenv, XrdOucEnv*& outenv,
-                              SymKey* key, std::chrono::seconds validity);
+                              SymKey* key, std::chrono::seconds validity,
+                              CapabilityFormat format = CapabilityFormat::Default);
 
   //----------------------------------------------------------------------------
   //! Extract EOS specific capability encoded in the env object
@@ -0,0 +1,566 @@
+//------------------------------------------------------------------------------
+// File: Tracing.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/Tracing.hh"
+#include "common/Logging.hh"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+thread_local Tracer::ThreadState Tracer::tState {0, 0, 0};
+std::atomic<uint64_t> Tracer::sSampleRate {0};
+
+namespace
+{
+//! Interval between two polls of the sample rate provider
+constexpr auto kConfigInterval = std::chrono::seconds(10);
+
+//------------------------------------------------------------------------------
+// Get current steady clock time in nanoseconds
+//------------------------------------------------------------------------------
+inline int64_t
+SteadyNowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>
+         (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+// Get the kernel thread id of the calling thread
+//------------------------------------------------------------------------------
+inline uint32_t
+GetTid()
+{
+  static thread_local uint32_t tid = (uint32_t) syscall(SYS_gettid);
+  return tid;
+}
+
+//------------------------------------------------------------------------------
+// Get the name of the given span kind
+//------------------------------------------------------------------------------
+const char*
+KindToString(SpanKind kind)
+{
+  switch (kind) {
+  case SpanKind::kRequest:
+    return "request";
+
+  case SpanKind::kLockWait:
+    return "lock";
+
+  default:
+    return "phase";
+  }
+}
+
+//------------------------------------------------------------------------------
+// Write the given string escaped as a JSON string
+//------------------------------------------------------------------------------
+void
+WriteJsonString(std::ostream& os, const char* str)
+{
+  os << '"';
+
+  for (const char* ptr = str; *ptr; ++ptr) {
+    const unsigned char c = *ptr;
+
+    if ((c == '"') || (c == '\\')) {
+      os << '\\' << c;
+    } else if (c < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      os << buf;
+    } else {
+      os << c;
+    }
+  }
+
+  os << '"';
+}
+
+//------------------------------------------------------------------------------
+// Get the hex representation of the given identifier
+//------------------------------------------------------------------------------
+std::string
+ToHex(uint64_t val)
+{
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx", (unsigned long long) val);
+  return buf;
+}
+}
+
+//------------------------------------------------------------------------------
+// Get the process wide instance
+//------------------------------------------------------------------------------
+Tracer&
+Tracer::Instance()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+Tracer::Tracer():
+  mEpochSteadyNs(SteadyNowNs()),
+  mEpochUnixNs(std::chrono::duration_cast<std::chrono::nanoseconds>
+               (std::chrono::system_clock::now().time_since_epoch()).count()),
+  mTraceIdHigh(std::random_device()() | ((uint64_t) std::random_device()() << 32)),
+  mNextId((std::random_device()() | 1ull) << 24)
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+Tracer::~Tracer()
+{
+  StopDumper();
+}
+
+//------------------------------------------------------------------------------
+// Start the thread writing the trace files upon request
+//------------------------------------------------------------------------------
+void
+Tracer::StartDumper(const std::string& service, const std::string& dir,
+                    std::function<int64_t()> sample_rate_provider)
+{
+  StopDumper();
+  mService = service;
+  mDumpDir = dir;
+  mSampleRateProvider = std::move(sample_rate_provider);
+  mDumper.reset(&Tracer::DumperLoop, this);
+}
+
+//------------------------------------------------------------------------------
+// Stop the dumper thread
+//------------------------------------------------------------------------------
+void
+Tracer::StopDumper()
+{
+  mDumper.join();
+}
+
+//------------------------------------------------------------------------------
+// Signal handler calling RequestDump
+//------------------------------------------------------------------------------
+void
+Tracer::DumpSignalHandler(int sig)
+{
+  (void) sig;
+  Instance().RequestDump();
+}
+
+//------------------------------------------------------------------------------
+// Dumper thread loop
+//------------------------------------------------------------------------------
+void
+Tracer::DumperLoop(ThreadAssistant& assistant) noexcept
+{
+  ThreadAssistant::setSelfThreadName("TraceDumper");
+  auto next_config = std::chrono::steady_clock::now();
+
+  while (!assistant.terminationRequested()) {
+    if (mSampleRateProvider &&
+        (std::chrono::steady_clock::now() >= next_config)) {
+      const int64_t rate = mSampleRateProvider();
+
+      if ((rate >= 0) && ((uint64_t) rate != GetSampleRate())) {
+        eos_static_info("msg=\"tracing sample rate changed\" rate=%lli", rate);
+        SetSampleRate(rate);
+      }
+
+      next_config = std::chrono::steady_clock::now() + kConfigInterval;
+    }
+
+    if (mDumpRequested.exchange(false)) {
+      std::string prefix;
+
+      if (WriteFiles(mDumpDir, prefix)) {
+        eos_static_notice("msg=\"wrote trace files\" prefix=\"%s\"",
+                          prefix.c_str());
+      } else {
+        eos_static_err("msg=\"failed to write trace files\" prefix=\"%s\"",
+                       prefix.c_str());
+      }
+    }
+
+    assistant.wait_for(std::chrono::seconds(1));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the ring buffer of the calling thread
+//------------------------------------------------------------------------------
+Tracer::ThreadBuffer*
+Tracer::GetThreadBuffer()
+{
+  static thread_local std::shared_ptr<ThreadBuffer> tBuffer;
+
+  if (!tBuffer) {
+    tBuffer = std::make_shared<ThreadBuffer>();
+    tBuffer->mEvents.resize(sRingCapacity);
+    std::unique_lock<std::mutex> lock(mBuffersMutex);
+
+    // The spans of the exited threads are kept until there are too many
+    // buffers around
+    if (mBuffers.size() >= sMaxBuffers) {
+      mBuffers.erase(std::remove_if(mBuffers.begin(), mBuffers.end(),
+      [](const std::shared_ptr<ThreadBuffer>& buff) {
+        return (buff.use_count() == 1);
+      }), mBuffers.end());
+    }
+
+    mBuffers.push_back(tBuffer);
+  }
+
+  return tBuffer.get();
+}
+
+//------------------------------------------------------------------------------
+// Get the histogram for the given span
+//------------------------------------------------------------------------------
+std::shared_ptr<LatencyHistogram>
+Tracer::GetHistogram(const TraceEvent& event)
+{
+  std::string key = (event.mKind == SpanKind::kLockWait) ? "lock." : "";
+  key += event.mName;
+  std::unique_lock<std::mutex> lock(mHistMutex);
+  auto& hist = mHistograms[key];
+
+  if (!hist) {
+    hist = std::make_shared<LatencyHistogram>();
+  }
+
+  return hist;
+}
+
+//------------------------------------------------------------------------------
+// Record a finished span
+//------------------------------------------------------------------------------
+void
+Tracer::Record(const TraceEvent& event)
+{
+  const int64_t start = SteadyNowNs();
+  ThreadBuffer* buffer = GetThreadBuffer();
+  {
+    std::unique_lock<std::mutex> lock(buffer->mMutex);
+
+    if (buffer->mNext >= sRingCapacity) {
+      mOverwritten.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    buffer->mEvents[buffer->mNext % sRingCapacity] = event;
+    ++buffer->mNext;
+  }
+  GetHistogram(event)->Add(event.mDurationNs);
+  mSpans.fetch_add(1, std::memory_order_relaxed);
+  mRecordNs.fetch_add(SteadyNowNs() - start, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Get a copy of the spans held by the ring buffers ordered by start time
+//------------------------------------------------------------------------------
+std::vector<TraceEvent>
+Tracer::GetEvents() const
+{
+  std::vector<TraceEvent> events;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::unique_lock<std::mutex> lock(mBuffersMutex);
+    buffers = mBuffers;
+  }
+
+  for (const auto& buffer : buffers) {
+    std::unique_lock<std::mutex> lock(buffer->mMutex);
+    const uint64_t count = std::min<uint64_t>(buffer->mNext, sRingCapacity);
+
+    for (uint64_t i = buffer->mNext - count; i < buffer->mNext; ++i) {
+      events.push_back(buffer->mEvents[i % sRingCapacity]);
+    }
+  }
+
+  std::sort(events.begin(), events.end(),
+  [](const TraceEvent & lhs, const TraceEvent & rhs) {
+    return lhs.mStartNs < rhs.mStartNs;
+  });
+  return events;
+}
+
+//------------------------------------------------------------------------------
+// Convert a steady clock time to nanoseconds since the epoch
+//------------------------------------------------------------------------------
+int64_t
+Tracer::ToUnixNs(int64_t steady_ns) const
+{
+  return mEpochUnixNs + (steady_ns - mEpochSteadyNs);
+}
+
+//------------------------------------------------------------------------------
+// Write the given spans in Chrome trace event format
+//------------------------------------------------------------------------------
+void
+Tracer::WriteChromeTrace(std::ostream& os,
+                         const std::vector<TraceEvent>& events) const
+{
+  const pid_t pid = getpid();
+  os << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"service\":";
+  WriteJsonString(os, mService.c_str());
+  os << "},\"traceEvents\":[";
+  bool first = true;
+  os << std::fixed << std::setprecision(3);
+
+  for (const auto& event : events) {
+    os << (first ? "\n" : ",\n") << "{\"name\":";
+    WriteJsonString(os, event.mName);
+    os << ",\"cat\":\"" << KindToString(event.mKind) << "\",\"ph\":\"X\""
+       << ",\"ts\":" << ToUnixNs(event.mStartNs) / 1000.0
+       << ",\"dur\":" << event.mDurationNs / 1000.0
+       << ",\"pid\":" << pid << ",\"tid\":" << event.mTid
+       << ",\"args\":{\"trace_id\":\"" << ToHex(event.mTraceId)
+       << "\",\"span_id\":\"" << ToHex(event.mSpanId)
+       << "\",\"parent_id\":\"" << ToHex(event.mParentId) << "\"}}";
+    first = false;
+  }
+
+  os << "\n]}\n";
+}
+
+//------------------------------------------------------------------------------
+// Write the given spans in OTLP/JSON format
+//------------------------------------------------------------------------------
+void
+Tracer::WriteOtlp(std::ostream& os, const std::vector<TraceEvent>& events) const
+{
+  // Span kind 2 is SERVER for the requests, 1 is INTERNAL for the rest
+  os << "{\"resourceSpans\":[{\"resource\":{\"attributes\":["
+     << "{\"key\":\"service.name\",\"value\":{\"stringValue\":";
+  WriteJsonString(os, mService.c_str());
+  os << "}},{\"key\":\"process.pid\",\"value\":{\"intValue\":\"" << getpid()
+     << "\"}}]},\"scopeSpans\":[{\"scope\":{\"name\":\"eos.tracing\"},"
+     << "\"spans\":[";
+  bool first = true;
+
+  for (const auto& event : events) {
+    const int64_t start = ToUnixNs(event.mStartNs);
+    os << (first ? "\n" : ",\n")
+       << "{\"traceId\":\"" << ToHex(mTraceIdHigh) << ToHex(event.mTraceId)
+       << "\",\"spanId\":\"" << ToHex(event.mSpanId) << "\"";
+
+    if (event.mParentId) {
+      os << ",\"parentSpanId\":\"" << ToHex(event.mParentId) << "\"";
+    }
+
+    os << ",\"name\":";
+    WriteJsonString(os, event.mName);
+    os << ",\"kind\":" << ((event.mKind == SpanKind::kRequest) ? 2 : 1)
+       << ",\"startTimeUnixNano\":\"" << start
+       << "\",\"endTimeUnixNano\":\"" << start + (int64_t) event.mDurationNs
+       << "\",\"attributes\":[{\"key\":\"eos.span.kind\",\"value\":"
+       << "{\"stringValue\":\"" << KindToString(event.mKind) << "\"}},"
+       << "{\"key\":\"thread.id\",\"value\":{\"intValue\":\"" << event.mTid
+       << "\"}}]}";
+    first = false;
+  }
+
+  os << "\n]}]}]}\n";
+}
+
+//------------------------------------------------------------------------------
+// Write the Chrome trace, OTLP and histogram summary files
+//------------------------------------------------------------------------------
+bool
+Tracer::WriteFiles(const std::string& dir, std::string& prefix)
+{
+  std::ostringstream oss;
+  oss << dir;
+
+  if (!dir.empty() && (dir.back() != '/')) {
+    oss << '/';
+  }
+
+  oss << "trace." << mService << "." << time(nullptr);
+  prefix = oss.str();
+  const auto events = GetEvents();
+  std::ofstream chrome(prefix + ".chrome.json");
+  WriteChromeTrace(chrome, events);
+  std::ofstream otlp(prefix + ".otlp.json");
+  WriteOtlp(otlp, events);
+  std::ofstream summary(prefix + ".phases");
+  summary << GetStats("", true);
+  chrome.close();
+  otlp.close();
+  summary.close();
+  return chrome.good() && otlp.good() && summary.good();
+}
+
+//------------------------------------------------------------------------------
+// Get the latency histograms per span name
+//------------------------------------------------------------------------------
+std::map<std::string, std::shared_ptr<LatencyHistogram>>
+Tracer::GetHistograms() const
+{
+  std::unique_lock<std::mutex> lock(mHistMutex);
+  return mHistograms;
+}
+
+//------------------------------------------------------------------------------
+// Get summary of the tracing counters and per span latency percentiles
+//------------------------------------------------------------------------------
+std::string
+Tracer::GetStats(const std::string& prefix, bool monitoring) const
+{
+  std::ostringstream oss;
+  const uint64_t spans = GetNumSpans();
+  const uint64_t record_ns = spans ? mRecordNs.load() / spans : 0;
+
+  if (monitoring) {
+    oss << prefix << "sample=" << GetSampleRate() << std::endl
+        << prefix << "traces=" << GetNumTraces() << std::endl
+        << prefix << "spans=" << spans << std::endl
+        << prefix << "overwritten=" << GetNumOverwritten() << std::endl
+        << prefix << "record_ns=" << record_ns << std::endl;
+  } else {
+    oss << prefix << "sample=" << GetSampleRate()
+        << " traces=" << GetNumTraces()
+        << " spans=" << spans
+        << " overwritten=" << GetNumOverwritten()
+        << " record_ns=" << record_ns << std::endl;
+  }
+
+  for (const auto& elem : GetHistograms()) {
+    const auto& hist = *elem.second;
+
+    if (monitoring) {
+      oss << prefix << "span=" << elem.first;
+    } else {
+      oss << prefix << std::left << std::setw(32) << elem.first << std::right;
+    }
+
+    oss << " count=" << hist.GetCount()
+        << " mean_us=" << std::fixed << std::setprecision(1)
+        << hist.GetMean() / 1000.0
+        << " p50_us=" << hist.GetPercentile(50) / 1000.0
+        << " p90_us=" << hist.GetPercentile(90) / 1000.0
+        << " p99_us=" << hist.GetPercentile(99) / 1000.0
+        << " max_us=" << hist.GetMax() / 1000.0 << std::endl;
+  }
+
+  return oss.str();
+}
+
+//------------------------------------------------------------------------------
+// Drop all the recorded spans and histograms
+//------------------------------------------------------------------------------
+void
+Tracer::Reset()
+{
+  {
+    std::unique_lock<std::mutex> lock(mBuffersMutex);
+
+    for (auto& buffer : mBuffers) {
+      std::unique_lock<std::mutex> buff_lock(buffer->mMutex);
+      buffer->mNext = 0;
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lock(mHistMutex);
+    mHistograms.clear();
+  }
+  mTraces = 0;
+  mSpans = 0;
+  mOverwritten = 0;
+  mRecordNs = 0;
+}
+
+//------------------------------------------------------------------------------
+// Start the span
+//------------------------------------------------------------------------------
+void
+TraceSpan::Begin(const char* name, SpanKind kind)
+{
+  if (mEvent || !Tracer::IsTracing()) {
+    return;
+  }
+
+  mEvent.reset(new TraceEvent());
+  mEvent->mTraceId = Tracer::tState.mTraceId;
+  mEvent->mParentId = Tracer::tState.mSpanId;
+  mEvent->mSpanId = Tracer::Instance().NextId();
+  mEvent->mKind = kind;
+  mEvent->mTid = GetTid();
+  (void) strncpy(mEvent->mName, name ? name : "unknown",
+                 TraceEvent::sMaxNameLen - 1);
+  Tracer::tState.mSpanId = mEvent->mSpanId;
+  mEvent->mStartNs = SteadyNowNs();
+}
+
+//------------------------------------------------------------------------------
+// Record the span and restore the parent one
+//------------------------------------------------------------------------------
+void
+TraceSpan::Finish()
+{
+  mEvent->mDurationNs = SteadyNowNs() - mEvent->mStartNs;
+
+  // A span outliving its trace is dropped, one closed before its children
+  // leaves them as the innermost open span
+  if (Tracer::tState.mTraceId == mEvent->mTraceId) {
+    Tracer::Instance().Record(*mEvent);
+
+    if (Tracer::tState.mSpanId == mEvent->mSpanId) {
+      Tracer::tState.mSpanId = mEvent->mParentId;
+    }
+  }
+
+  if (mRoot) {
+    Tracer::tState.mTraceId = 0;
+    Tracer::tState.mSpanId = 0;
+  }
+
+  mEvent.reset();
+}
+
+//------------------------------------------------------------------------------
+// Start a new trace with this request as root span
+//------------------------------------------------------------------------------
+void
+TraceRequest::BeginTrace(const char* name)
+{
+  Tracer& tracer = Tracer::Instance();
+  tracer.AddTrace();
+  Tracer::tState.mTraceId = tracer.NextId();
+  Tracer::tState.mSpanId = 0;
+  mRoot = true;
+  Begin(name, SpanKind::kRequest);
+}
+
+EOSCOMMONNAMESPACE_END
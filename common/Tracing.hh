@@ -0,0 +1,392 @@
+//------------------------------------------------------------------------------
+// File: Tracing.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "common/Namespace.hh"
+#include "common/AssistedThread.hh"
+#include "common/LatencyHistogram.hh"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Kind of a traced span
+//------------------------------------------------------------------------------
+enum class SpanKind : uint8_t {
+  kRequest,  ///< Root span of a sampled request
+  kPhase,    ///< Phase of a request e.g. namespace lookup, disk read
+  kLockWait  ///< Time spent waiting for a lock
+};
+
+//------------------------------------------------------------------------------
+//! Finished span as stored in the per-thread ring buffers
+//------------------------------------------------------------------------------
+struct TraceEvent {
+  //! Maximum length of a span name including the terminating null character
+  static constexpr size_t sMaxNameLen = 48;
+
+  uint64_t mTraceId {0};
+  uint64_t mSpanId {0};
+  uint64_t mParentId {0};
+  int64_t mStartNs {0}; ///< Steady clock start time
+  uint64_t mDurationNs {0};
+  uint32_t mTid {0};
+  SpanKind mKind {SpanKind::kPhase};
+  char mName[sMaxNameLen] {0};
+};
+
+//------------------------------------------------------------------------------
+//! Class Tracer - process wide collector of sampled request traces.
+//!
+//! One request out of sample rate is traced: its root span and all the spans
+//! opened by the same thread while it is active (phases, lock waits) are
+//! recorded in a ring buffer owned by the thread and their durations are
+//! aggregated into per span name latency histograms. When sampling is off or
+//! the current request is not sampled, opening a span costs one thread local
+//! load and a branch.
+//!
+//! The ring buffers can be dumped as Chrome trace (chrome://tracing,
+//! Perfetto) and OTLP/JSON files together with a summary of the histograms,
+//! either on demand or upon RequestDump() which is async-signal-safe.
+//------------------------------------------------------------------------------
+class Tracer
+{
+public:
+  //! Number of spans kept per thread
+  static constexpr size_t sRingCapacity = 1024;
+  //! Number of ring buffers above which those of exited threads are dropped
+  static constexpr size_t sMaxBuffers = 512;
+
+  //----------------------------------------------------------------------------
+  //! Per-thread tracing state, trivially initialized to keep the access
+  //! cheap
+  //----------------------------------------------------------------------------
+  struct ThreadState {
+    uint64_t mTraceId;  ///< Active trace, 0 if none
+    uint64_t mSpanId;   ///< Innermost open span
+    uint64_t mRequests; ///< Requests seen by the thread, used for sampling
+  };
+
+  static thread_local ThreadState tState;
+  static std::atomic<uint64_t> sSampleRate;
+
+  //----------------------------------------------------------------------------
+  //! Get the process wide instance
+  //----------------------------------------------------------------------------
+  static Tracer& Instance();
+
+  //----------------------------------------------------------------------------
+  //! Check if the calling thread is currently tracing a request
+  //----------------------------------------------------------------------------
+  static inline bool IsTracing()
+  {
+    return (tState.mTraceId != 0);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Set the sample rate, 0 disables tracing, n traces one request out of n
+  //----------------------------------------------------------------------------
+  static void SetSampleRate(uint64_t rate)
+  {
+    sSampleRate.store(rate, std::memory_order_relaxed);
+  }
+
+  static uint64_t GetSampleRate()
+  {
+    return sSampleRate.load(std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~Tracer();
+
+  //----------------------------------------------------------------------------
+  //! Start the thread writing the trace files upon request
+  //!
+  //! @param service name of the service used in the files
+  //! @param dir directory where the files are written
+  //! @param sample_rate_provider optional function polled for the sample
+  //!        rate, negative values leave it unchanged
+  //----------------------------------------------------------------------------
+  void StartDumper(const std::string& service, const std::string& dir,
+                   std::function<int64_t()> sample_rate_provider = nullptr);
+
+  //----------------------------------------------------------------------------
+  //! Stop the dumper thread
+  //----------------------------------------------------------------------------
+  void StopDumper();
+
+  //----------------------------------------------------------------------------
+  //! Ask the dumper thread to write the trace files, async-signal-safe
+  //----------------------------------------------------------------------------
+  inline void RequestDump()
+  {
+    mDumpRequested.store(true);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Signal handler calling RequestDump
+  //----------------------------------------------------------------------------
+  static void DumpSignalHandler(int sig);
+
+  //----------------------------------------------------------------------------
+  //! Write the Chrome trace, OTLP and histogram summary files
+  //!
+  //! @param dir output directory
+  //! @param prefix set to the common prefix of the files written
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool WriteFiles(const std::string& dir, std::string& prefix);
+
+  //----------------------------------------------------------------------------
+  //! Get a copy of the spans held by the ring buffers ordered by start time
+  //----------------------------------------------------------------------------
+  std::vector<TraceEvent> GetEvents() const;
+
+  //----------------------------------------------------------------------------
+  //! Write the given spans in Chrome trace event format
+  //----------------------------------------------------------------------------
+  void WriteChromeTrace(std::ostream& os,
+                        const std::vector<TraceEvent>& events) const;
+
+  //----------------------------------------------------------------------------
+  //! Write the given spans in OTLP/JSON format
+  //----------------------------------------------------------------------------
+  void WriteOtlp(std::ostream& os, const std::vector<TraceEvent>& events) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the latency histograms per span name in nanoseconds
+  //----------------------------------------------------------------------------
+  std::map<std::string, std::shared_ptr<LatencyHistogram>>
+  GetHistograms() const;
+
+  //----------------------------------------------------------------------------
+  //! Get summary of the tracing counters and per span latency percentiles
+  //!
+  //! @param prefix prefix of every line e.g. "uid=all gid=all ns.trace."
+  //! @param monitoring if true use the key=value monitoring format
+  //----------------------------------------------------------------------------
+  std::string GetStats(const std::string& prefix, bool monitoring) const;
+
+  //----------------------------------------------------------------------------
+  //! Drop all the recorded spans and histograms
+  //----------------------------------------------------------------------------
+  void Reset();
+
+  //----------------------------------------------------------------------------
+  //! Record a finished span, called by the span scopes
+  //----------------------------------------------------------------------------
+  void Record(const TraceEvent& event);
+
+  //----------------------------------------------------------------------------
+  //! Get a new span/trace identifier
+  //----------------------------------------------------------------------------
+  inline uint64_t NextId()
+  {
+    return mNextId.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Tracing statistics
+  //----------------------------------------------------------------------------
+  inline uint64_t GetNumTraces() const
+  {
+    return mTraces.load(std::memory_order_relaxed);
+  }
+
+  inline uint64_t GetNumSpans() const
+  {
+    return mSpans.load(std::memory_order_relaxed);
+  }
+
+  inline uint64_t GetNumOverwritten() const
+  {
+    return mOverwritten.load(std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Account a new sampled trace
+  //----------------------------------------------------------------------------
+  inline void AddTrace()
+  {
+    mTraces.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Ring buffer of the spans recorded by one thread
+  //----------------------------------------------------------------------------
+  struct ThreadBuffer {
+    mutable std::mutex mMutex;
+    std::vector<TraceEvent> mEvents;
+    uint64_t mNext {0};
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  Tracer();
+
+  //----------------------------------------------------------------------------
+  //! Get the ring buffer of the calling thread
+  //----------------------------------------------------------------------------
+  ThreadBuffer* GetThreadBuffer();
+
+  //----------------------------------------------------------------------------
+  //! Get the histogram for the given span
+  //----------------------------------------------------------------------------
+  std::shared_ptr<LatencyHistogram> GetHistogram(const TraceEvent& event);
+
+  //----------------------------------------------------------------------------
+  //! Convert a steady clock time to nanoseconds since the epoch
+  //----------------------------------------------------------------------------
+  int64_t ToUnixNs(int64_t steady_ns) const;
+
+  //----------------------------------------------------------------------------
+  //! Dumper thread loop
+  //----------------------------------------------------------------------------
+  void DumperLoop(ThreadAssistant& assistant) noexcept;
+
+  const int64_t mEpochSteadyNs;
+  const int64_t mEpochUnixNs;
+  const uint64_t mTraceIdHigh; ///< High part of the 128-bit OTLP trace ids
+  std::atomic<uint64_t> mNextId;
+  mutable std::mutex mBuffersMutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> mBuffers;
+  mutable std::mutex mHistMutex;
+  std::map<std::string, std::shared_ptr<LatencyHistogram>> mHistograms;
+  std::atomic<uint64_t> mTraces {0};
+  std::atomic<uint64_t> mSpans {0};
+  std::atomic<uint64_t> mOverwritten {0};
+  std::atomic<uint64_t> mRecordNs {0};
+  std::atomic<bool> mDumpRequested {false};
+  std::string mService {"eos"};
+  std::string mDumpDir;
+  std::function<int64_t()> mSampleRateProvider;
+  AssistedThread mDumper;
+};
+
+//------------------------------------------------------------------------------
+//! Class TraceSpan - scope timing a phase of the request traced by the
+//! current thread, if any
+//------------------------------------------------------------------------------
+class TraceSpan
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor of an inactive span, see Begin
+  //----------------------------------------------------------------------------
+  TraceSpan() = default;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param name span name, copied
+  //! @param kind span kind
+  //----------------------------------------------------------------------------
+  explicit TraceSpan(const char* name, SpanKind kind = SpanKind::kPhase)
+  {
+    if (Tracer::IsTracing()) {
+      Begin(name, kind);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~TraceSpan()
+  {
+    End();
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  //----------------------------------------------------------------------------
+  //! Start the span if the calling thread is tracing a request
+  //----------------------------------------------------------------------------
+  void Begin(const char* name, SpanKind kind = SpanKind::kPhase);
+
+  //----------------------------------------------------------------------------
+  //! End the span before the end of the scope
+  //----------------------------------------------------------------------------
+  inline void End()
+  {
+    if (mEvent) {
+      Finish();
+    }
+  }
+
+protected:
+  //----------------------------------------------------------------------------
+  //! Record the span and restore the parent one
+  //----------------------------------------------------------------------------
+  void Finish();
+
+  std::unique_ptr<TraceEvent> mEvent; ///< Set only while the span is active
+  bool mRoot {false};
+};
+
+//------------------------------------------------------------------------------
+//! Class TraceRequest - scope of a request which is traced if sampled. Inside
+//! an already traced request it behaves like a TraceSpan.
+//------------------------------------------------------------------------------
+class TraceRequest: public TraceSpan
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param name request name e.g. "mgm.open"
+  //----------------------------------------------------------------------------
+  explicit TraceRequest(const char* name)
+  {
+    const uint64_t rate = Tracer::sSampleRate.load(std::memory_order_relaxed);
+
+    if (rate) {
+      if (Tracer::tState.mTraceId) {
+        Begin(name, SpanKind::kPhase);
+      } else if ((++Tracer::tState.mRequests % rate) == 0) {
+        BeginTrace(name);
+      }
+    }
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Start a new trace with this request as root span
+  //----------------------------------------------------------------------------
+  void BeginTrace(const char* name);
+};
+
+EOSCOMMONNAMESPACE_END
@@ -32,6 +32,7 @@
 #include <cstring>
 #include <fstream>
 #include <iterator>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 
@@ -387,64 +388,137 @@ UriCapCipher::kdf_scrypt(const std::string& password_bytes,
   return key;
 }
 
-void
-UriCapCipher::aead_encrypt_chacha20poly1305(
-    const std::vector<uint8_t>& key,
-    const std::vector<uint8_t>& nonce12,
-    const std::string& aad,
-    const std::vector<uint8_t>& plaintext,
-    std::vector<uint8_t>& ciphertext_out,
-    std::vector<uint8_t>& tag16_out)
+namespace
 {
-  if (nonce12.size() != kNonceLen) {
-    throw std::runtime_error("nonce must be 12 bytes");
+// Cipher contexts are expensive to allocate, keep one per thread and only
+// reset it between operations
+struct CipherCtxDeleter {
+  void operator()(EVP_CIPHER_CTX* ctx) const
+  {
+    EVP_CIPHER_CTX_free(ctx);
   }
+};
 
-  tag16_out.assign(kTagLen, 0);
-  ciphertext_out.assign(plaintext.size(), 0);
+EVP_CIPHER_CTX*
+threadCipherCtx()
+{
+  thread_local std::unique_ptr<EVP_CIPHER_CTX, CipherCtxDeleter> ctx(
+    EVP_CIPHER_CTX_new());
 
-  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-  if (!ctx) throw std::runtime_error("EVP_CIPHER_CTX_new failed");
+  if (!ctx) {
+    throw std::runtime_error("EVP_CIPHER_CTX_new failed");
+  }
+
+  EVP_CIPHER_CTX_reset(ctx.get());
+  return ctx.get();
+}
+}
 
+void
+UriCapCipher::aead_seal(const uint8_t* key, const uint8_t* nonce12,
+                        const uint8_t* aad, size_t aad_len,
+                        const uint8_t* pt, size_t pt_len,
+                        uint8_t* ct_out, uint8_t* tag16_out)
+{
+  EVP_CIPHER_CTX* ctx = threadCipherCtx();
   int len = 0;
   if (EVP_EncryptInit_ex(ctx, EVP_chacha20_poly1305(), nullptr, nullptr, nullptr) != 1) {
     throw_openssl("EncryptInit");
   }
 
-  if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, (int)nonce12.size(), nullptr) != 1) {
+  if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, (int)kNonceLen, nullptr) != 1) {
     throw_openssl("SET_IVLEN");
   }
 
-  if (EVP_EncryptInit_ex(ctx, nullptr, nullptr, key.data(), nonce12.data()) != 1) {
+  if (EVP_EncryptInit_ex(ctx, nullptr, nullptr, key, nonce12) != 1) {
     throw_openssl("EncryptInit key/iv");
   }
 
-  if (!aad.empty()) {
-    if (EVP_EncryptUpdate(ctx, nullptr, &len,
-                          reinterpret_cast<const unsigned char*>(aad.data()),
-                          (int)aad.size()) != 1) {
+  if (aad_len) {
+    if (EVP_EncryptUpdate(ctx, nullptr, &len, aad, (int)aad_len) != 1) {
       throw_openssl("EncryptUpdate AAD");
     }
   }
 
-  if (!plaintext.empty()) {
-    if (EVP_EncryptUpdate(ctx, ciphertext_out.data(), &len,
-                          plaintext.data(), (int)plaintext.size()) != 1) {
+  len = 0;
+  if (pt_len) {
+    if (EVP_EncryptUpdate(ctx, ct_out, &len, pt, (int)pt_len) != 1) {
       throw_openssl("EncryptUpdate PT");
     }
   }
 
   int finallen = 0;
-  if (EVP_EncryptFinal_ex(ctx, ciphertext_out.data() + len, &finallen) != 1) {
+  if (EVP_EncryptFinal_ex(ctx, ct_out + len, &finallen) != 1) {
     throw_openssl("EncryptFinal");
   }
 
   if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, (int)kTagLen,
-                          tag16_out.data()) != 1) {
+                          tag16_out) != 1) {
     throw_openssl("GET_TAG");
   }
+}
+
+bool
+UriCapCipher::aead_open(const uint8_t* key, const uint8_t* nonce12,
+                        const uint8_t* aad, size_t aad_len,
+                        const uint8_t* ct, size_t ct_len,
+                        const uint8_t* tag16, uint8_t* pt_out)
+{
+  EVP_CIPHER_CTX* ctx = threadCipherCtx();
+  int len = 0;
+  if (EVP_DecryptInit_ex(ctx, EVP_chacha20_poly1305(), nullptr, nullptr, nullptr) != 1) {
+    throw_openssl("DecryptInit");
+  }
+
+  if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, (int)kNonceLen, nullptr) != 1) {
+    throw_openssl("SET_IVLEN");
+  }
+
+  if (EVP_DecryptInit_ex(ctx, nullptr, nullptr, key, nonce12) != 1) {
+    throw_openssl("DecryptInit key/iv");
+  }
+
+  if (aad_len) {
+    if (EVP_DecryptUpdate(ctx, nullptr, &len, aad, (int)aad_len) != 1) {
+      throw_openssl("DecryptUpdate AAD");
+    }
+  }
+
+  len = 0;
+  if (ct_len) {
+    if (EVP_DecryptUpdate(ctx, pt_out, &len, ct, (int)ct_len) != 1) {
+      throw_openssl("DecryptUpdate CT");
+    }
+  }
+
+  if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, (int)kTagLen,
+                          (void*)tag16) != 1) {
+    throw_openssl("SET_TAG");
+  }
+
+  int finallen = 0;
+  return (EVP_DecryptFinal_ex(ctx, pt_out + len, &finallen) == 1);
+}
+
+void
+UriCapCipher::aead_encrypt_chacha20poly1305(
+    const std::vector<uint8_t>& key,
+    const std::vector<uint8_t>& nonce12,
+    const std::string& aad,
+    const std::vector<uint8_t>& plaintext,
+    std::vector<uint8_t>& ciphertext_out,
+    std::vector<uint8_t>& tag16_out)
+{
+  if (nonce12.size() != kNonceLen) {
+    throw std::runtime_error("nonce must be 12 bytes");
+  }
 
-  EVP_CIPHER_CTX_free(ctx);
+  tag16_out.assign(kTagLen, 0);
+  ciphertext_out.assign(plaintext.size(), 0);
+  aead_seal(key.data(), nonce12.data(),
+            reinterpret_cast<const uint8_t*>(aad.data()), aad.size(),
+            plaintext.data(), plaintext.size(),
+            ciphertext_out.data(), tag16_out.data());
 }
 
 std::vector<uint8_t>
@@ -464,50 +538,74 @@ UriCapCipher::aead_decrypt_chacha20poly1305(
 
   std::vector<uint8_t> plaintext(ciphertext.size());
 
-  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-  if (!ctx) throw std::runtime_error("EVP_CIPHER_CTX_new failed");
-
-  int len = 0;
-  if (EVP_DecryptInit_ex(ctx, EVP_chacha20_poly1305(), nullptr, nullptr, nullptr) != 1) {
-    throw_openssl("DecryptInit");
+  if (!aead_open(key.data(), nonce12.data(),
+                 reinterpret_cast<const uint8_t*>(aad.data()), aad.size(),
+                 ciphertext.data(), ciphertext.size(), tag16.data(),
+                 plaintext.data())) {
+    throw std::runtime_error("Auth failed");
   }
 
-  if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, (int)nonce12.size(), nullptr) != 1) {
-    throw_openssl("SET_IVLEN");
+  return plaintext;
+}
+
+std::string
+UriCapCipher::encryptCompact(const std::string& plaintext,
+                             uint64_t expiry) const
+{
+  if (!has_cached_key_) {
+    throw std::runtime_error("compact format requires a cached key");
   }
 
-  if (EVP_DecryptInit_ex(ctx, nullptr, nullptr, key.data(), nonce12.data()) != 1) {
-    throw_openssl("DecryptInit key/iv");
+  // header || ciphertext || tag in one buffer, the header is the AAD
+  std::vector<uint8_t> buf(kCompactHeaderLen + plaintext.size() + kTagLen);
+  buf[0] = kCompactVersion;
+
+  for (int i = 0; i < 8; ++i) {
+    buf[4 + i] = (uint8_t)((expiry >> (8 * i)) & 0xFF);
   }
 
-  if (!aad.empty()) {
-    if (EVP_DecryptUpdate(ctx, nullptr, &len,
-                          reinterpret_cast<const unsigned char*>(aad.data()),
-                          (int)aad.size()) != 1) {
-      throw_openssl("DecryptUpdate AAD");
-    }
+  uint8_t* nonce = &buf[12];
+  if (RAND_bytes(nonce, kNonceLen) != 1) {
+    throw_openssl("RAND_bytes(nonce)");
   }
 
-  if (!ciphertext.empty()) {
-    if (EVP_DecryptUpdate(ctx, plaintext.data(), &len,
-                          ciphertext.data(), (int)ciphertext.size()) != 1) {
-      throw_openssl("DecryptUpdate CT");
+  aead_seal(cached_key_.data(), nonce, buf.data(), kCompactHeaderLen,
+            reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
+            buf.data() + kCompactHeaderLen,
+            buf.data() + kCompactHeaderLen + plaintext.size());
+  return b64url_encode(buf);
+}
+
+std::string
+UriCapCipher::decryptCompact(std::string_view token, uint64_t& expiry) const
+{
+  try {
+    if (!has_cached_key_) {
+      return "";
     }
-  }
 
-  if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, (int)kTagLen,
-                          (void*)tag16.data()) != 1) {
-    throw_openssl("SET_TAG");
-  }
+    std::vector<uint8_t> buf = b64url_decode(std::string(token));
 
-  int finallen = 0;
-  int ok = EVP_DecryptFinal_ex(ctx, plaintext.data() + len, &finallen);
-  EVP_CIPHER_CTX_free(ctx);
+    if ((buf.size() < kCompactHeaderLen + kTagLen) ||
+        (buf[0] != kCompactVersion)) {
+      return "";
+    }
 
-  if (ok != 1) throw std::runtime_error("Auth failed");
+    const size_t ct_len = buf.size() - kCompactHeaderLen - kTagLen;
+    std::string plaintext(ct_len, '\0');
 
-  plaintext.resize((size_t)len + (size_t)finallen);
-  return plaintext;
+    if (!aead_open(cached_key_.data(), &buf[12], buf.data(), kCompactHeaderLen,
+                   buf.data() + kCompactHeaderLen, ct_len,
+                   buf.data() + kCompactHeaderLen + ct_len,
+                   reinterpret_cast<uint8_t*>(&plaintext[0]))) {
+      return "";
+    }
+
+    expiry = get_u64_le(&buf[4]);
+    return plaintext;
+  } catch (...) {
+    return "";
+  }
 }
 
 EOSCOMMONNAMESPACE_END
@@ -76,6 +76,16 @@ public:
   // Returns decrypted string, or "" on any failure.
   std::string decryptFromCgiFields(const std::string& cgi) const;
 
+  // Encrypt into a compact URI-safe token b64url(header || ciphertext || tag)
+  // with header = version | reserved | expiry (u64 LE) | nonce, authenticated
+  // as AAD. Requires the FixedSaltTag constructor (cached key).
+  std::string encryptCompact(const std::string& plaintext,
+                             uint64_t expiry) const;
+
+  // Decrypt a compact token, returns "" on any failure. The expiry is taken
+  // from the authenticated header.
+  std::string decryptCompact(std::string_view token, uint64_t& expiry) const;
+
 private:
   // ----- Tunables -----
   static constexpr uint64_t kN = 1ull << 15; // scrypt N (CPU/mem cost)
@@ -85,6 +95,8 @@ private:
   static constexpr size_t kSaltLen = 16;
   static constexpr size_t kNonceLen = 12;
   static constexpr size_t kTagLen = 16;
+  static constexpr uint8_t kCompactVersion = 2;
+  static constexpr size_t kCompactHeaderLen = 1 + 3 + 8 + kNonceLen;
 
   // Fixed binary header (packed manually; do not rely on struct packing)
   struct Header {
@@ -136,6 +148,17 @@ private:
                                          uint64_t N, uint64_t r, uint64_t p,
                                          size_t key_len);
 
+  // ----- AEAD on raw buffers using a per-thread reusable cipher context -----
+  static void aead_seal(const uint8_t* key, const uint8_t* nonce12,
+                        const uint8_t* aad, size_t aad_len,
+                        const uint8_t* pt, size_t pt_len,
+                        uint8_t* ct_out, uint8_t* tag16_out);
+
+  static bool aead_open(const uint8_t* key, const uint8_t* nonce12,
+                        const uint8_t* aad, size_t aad_len,
+                        const uint8_t* ct, size_t ct_len,
+                        const uint8_t* tag16, uint8_t* pt_out);
+
   // ----- AEAD encrypt/decrypt -----
   static void aead_encrypt_chacha20poly1305(
       const std::vector<uint8_t>& key,
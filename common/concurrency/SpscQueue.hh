@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+// File: SpscQueue.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "common/concurrency/AlignMacros.hh"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace eos::common
+{
+
+//------------------------------------------------------------------------------
+//! Bounded lock-free queue for exactly one producer and one consumer thread.
+//!
+//! The producer only writes the tail index and the consumer only writes the
+//! head index, so a push/pop is a relaxed load of the own index, an acquire
+//! load of the other one and a release store. Both indices live on their own
+//! cache line and each side keeps a cached copy of the other index to avoid
+//! bouncing cache lines while there is enough slack in the ring.
+//------------------------------------------------------------------------------
+template <typename T>
+class SpscQueue
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param capacity maximum number of elements, rounded up to a power of 2
+  //----------------------------------------------------------------------------
+  explicit SpscQueue(size_t capacity)
+  {
+    size_t sz = 2;
+
+    while (sz < capacity) {
+      sz <<= 1;
+    }
+
+    mMask = sz - 1;
+    mSlots.reset(new std::optional<T>[sz]);
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  //----------------------------------------------------------------------------
+  //! Push an element, producer side only
+  //!
+  //! @return false if the queue is full and the element was not moved
+  //----------------------------------------------------------------------------
+  bool
+  try_push(T&& elem)
+  {
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+
+    if (tail - mHeadCache == mMask + 1) {
+      mHeadCache = mHead.load(std::memory_order_acquire);
+
+      if (tail - mHeadCache == mMask + 1) {
+        return false;
+      }
+    }
+
+    mSlots[tail & mMask].emplace(std::move(elem));
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Pop an element, consumer side only
+  //!
+  //! @return false if the queue is empty
+  //----------------------------------------------------------------------------
+  bool
+  try_pop(T& elem)
+  {
+    const size_t head = mHead.load(std::memory_order_relaxed);
+
+    if (head == mTailCache) {
+      mTailCache = mTail.load(std::memory_order_acquire);
+
+      if (head == mTailCache) {
+        return false;
+      }
+    }
+
+    auto& slot = mSlots[head & mMask];
+    elem = std::move(*slot);
+    slot.reset();
+    mHead.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if the queue is empty - only exact when called by the consumer
+  //----------------------------------------------------------------------------
+  bool
+  empty() const
+  {
+    return (mHead.load(std::memory_order_acquire) ==
+            mTail.load(std::memory_order_acquire));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get approximate number of queued elements
+  //----------------------------------------------------------------------------
+  size_t
+  size() const
+  {
+    const size_t head = mHead.load(std::memory_order_acquire);
+    const size_t tail = mTail.load(std::memory_order_acquire);
+    return (tail >= head) ? tail - head : 0;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get queue capacity
+  //----------------------------------------------------------------------------
+  size_t
+  capacity() const
+  {
+    return mMask + 1;
+  }
+
+private:
+  size_t mMask {0};
+  std::unique_ptr<std::optional<T>[]> mSlots;
+  //! Consumer index and the consumer's cached copy of the producer index
+  alignas(hardware_destructive_interference_size) std::atomic<size_t> mHead {0};
+  size_t mTailCache {0};
+  //! Producer index and the producer's cached copy of the consumer index
+  alignas(hardware_destructive_interference_size) std::atomic<size_t> mTail {0};
+  size_t mHeadCache {0};
+};
+
+} // namespace eos::common
@@ -61,6 +61,8 @@ std::string MakeFindHelp()
       << "\t         [--fileinfo] : invoke `eos fileinfo` on the entry\n"
       << "\t              --count : print aggregated number of file and directory "
          "including the search path\n"
+      << "\t                        With --du, print as well the number of files and "
+         "directories and the tree size per depth\n"
       << "\t         --childcount : print the number of children in each directory\n"
       << "\t          --treecount : print the aggregated number of filesand directory "
          "children excluding the search path\n"
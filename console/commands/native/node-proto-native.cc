@@ -62,6 +62,14 @@ std::string MakeNodeHelp()
          "levels\n"
       << "\t    <key> : stripexs=on|off        - enable/disable synchronously "
          "stripe checksum computation\n"
+      << "\t    <key> : tracing=off|<n>        - trace one request out of <n> "
+         "on the node, dumped with signal 43 [default=off]\n"
+      << "\t    <key> : resync.nparallel=<n>   - number of threads per "
+         "filesystem updating the local metadata during the boot resync "
+         "[default=1, max=64]\n"
+      << "\t    <key> : resync.ioprio=<class>:<level> - IO priority of the "
+         "boot resync threads, class idle|be|rt and level 0..7 "
+         "[default=inherited]\n"
       << "\t    <key> : cbox_forbid_rw_sync=true|false|remove - control CernBox "
          " behavior to forbid synchronization of files opened in RW mode.\n"
          "t             By default false.\n"
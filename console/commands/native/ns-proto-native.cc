@@ -564,7 +564,11 @@ std::string MakeNsHelp()
       << std::endl
       << "  ns recompute_quotanode <path>|cid:<decimal_id>|cxid:<hex_id>"
       << std::endl
-      << "    recompute the specified quotanode" << std::endl
+      << "    recompute the specified quotanode. The tree is scanned in "
+         "parallel while" << std::endl
+      << "    concurrent quota updates are tracked, an interrupted "
+         "recomputation is" << std::endl
+      << "    resumed by running the command again" << std::endl
       << std::endl
       << "  ns update_quotanode "
          "<path>|cid:<decimal_id>|cxid:<hex_id> "
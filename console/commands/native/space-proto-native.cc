@@ -71,6 +71,18 @@ std::string MakeSpaceHelp()
       << "space config <space-name> space.groupdrainer.ntx                      : configure the max file transfer queue size [default=10000]\n"
       << "space config <space-name> space.lru=on|off                            : enable/disable the LRU policy engine [ default=off ]\n"
       << "space config <space-name> space.lru.interval=<sec>                    : configure the default lru scan interval\n"
+      << "space config default space.nsscan=on|off                              : enable/disable the shared namespace scan bus feeding LRU, inspector and tape GC [ default=off ]\n"
+      << "space config default space.nsscan.interval=<sec>                      : configure the interval between two namespace scan bus cycles [ default=14400 ]\n"
+      << "space config default space.nsstats=on|off                             : enable/disable the size/age/layout distribution per quota node shown by 'ns stat' [ default=off ]\n"
+      << "space config default space.nsstats.sample=<n>                         : account one file out of <n> in the namespace statistics [ default=100 ]\n"
+      << "space config default space.tracing=on|off                             : enable/disable sampled tracing of the MGM requests, dumped with signal 43 [ default=off ]\n"
+      << "space config default space.tracing.sample=<n>                         : trace one request out of <n> [ default=1000 ]\n"
+      << "space config default space.recycle.purge.threads=<n>                  : configure the number of recycle bin subtrees purged in parallel [ default=4 ]\n"
+      << "space config default space.recycle.purge.batch=<n>                    : configure the number of files removed under one namespace lock [ default=1000 ]\n"
+      << "space config default space.recycle.purge.rate=<files/s>               : limit the recycle bin purge rate, 0 means unlimited [ default=0 ]\n"
+      << "space config default space.find.threads=<n>                           : configure the number of threads exploring the namespace for one find, 0 explores from the command thread only [ default=0 ]\n"
+      << "space config default space.ns.hotset.size=<n>                         : configure the number of hot containers saved by the master to warm up the cache of the next boot, 0 disables saving [ default=100000 ]\n"
+      << "space config default space.ns.hotset.interval=<sec>                   : configure the interval between two saves of the hot containers, 0 saves only at shutdown [ default=600 ]\n"
       << "space config <space-name> fs.max.ropen=<n>                            : allow more than <n> read streams per disk in the given space\n"
       << "space config <space-name> fs.max.wopen=<n>                            : allow more than <n> write streams per disk in the given space\n"
       << "space config <space-name> space.wfe=on|off|paused                     : enable/disable the Workflow Engine [ default=off ]\n"
@@ -89,6 +101,7 @@ std::string MakeSpaceHelp()
       << "space config <space-name> space.tracker=on|off                        : enable/disable the space layout creation tracker [ default=off ]\n"
       << "space config <space-name> space.inspector=on|off                      : enable/disable the file inspector [ default=off ]\n"
       << "space config <space-name> space.inspector.interval=<sec>              : time interval after which the inspector will run, default 4h\n"
+      << "space config <space-name> space.inspector.scan.partitions=<n>         : scan the namespace over <n> parallel QuarkDB connections, default 0 (single cursor)\n"
       << "space config <space-name> space.inspector.price.currency=[0-5]        : currency printed by the cost evaluation ( 0=EOS, 1=CHF, 2=EUR, 3=USD, 4=AUD, 5=YEN )\n"
       << "space config <space-name> space.inspector.price.disk.tbyear=<price>   : set the price of a tb year of data on disk without redundancy (default=20)\n"
       << "space config <space-name> space.inspector.price.tape.tbyear=<price>   : set the price of a tb year of data on disk without redundancy (default=10)\n"
@@ -109,6 +122,10 @@ std::string MakeSpaceHelp()
       << "                                                                        => value 'remove' or empty clears the binding\n"
       << "space config <space-name> space.cache.low_watermark=<0-100>           : cache used-capacity low watermark percent [ default=70 ]\n"
       << "space config <space-name> space.cache.high_watermark=<0-100>          : cache used-capacity high watermark percent [ default=85 ]\n"
+      << "space config <space-name> space.cache.prefetch=on|off                 : enable/disable prefetching of popular files into the cache space [ default=off ]\n"
+      << "space config <space-name> space.cache.prefetch.bandwidth=<MB/s>       : backend bandwidth used for prefetching [ default=100 ]\n"
+      << "space config <space-name> space.cache.prefetch.paths=<dir>[,<dir>]    : directories whose files are always prefetched\n"
+      << "                                                                        => value 'remove' or empty clears the list\n"
       << std::endl
       << "TAPE REST API specific parameters:\n"
       << "space config default " << eos::mgm::rest::TAPE_REST_API_SWITCH_ON_OFF
@@ -42,6 +42,7 @@
 #include "fst/storage/FileSystem.hh"
 #include "fst/utils/IoPriority.hh"
 #include "fst/utils/ScanRate.hh"
+#include "fst/utils/ScanReader.hh"
 #include "mgm/misc/Constants.hh"
 #include "namespace/ns_quarkdb/Constants.hh"
 #include "qclient/structures/QSet.hh"
@@ -123,8 +124,9 @@ ScanDir::ScanDir(const char* dirpath, eos::common::FileSystem::fsid_t fsid,
   mAltXsInterval(0), // by default it's disabled
   mNumScannedFiles(0), mNumCorruptedFiles(0),
   mNumHWCorruptedFiles(0),  mTotalScanSize(0), mNumTotalFiles(0),
-  mNumSkippedFiles(0), mBuffer(nullptr),
-  mBufferSize(0), mBgThread(bgthread), mClock(fake_clock), mRateLimit(nullptr)
+  mNumSkippedFiles(0), mBuffer(nullptr), mBuffer2(nullptr),
+  mBufferSize(0), mDirectIo(false), mBgThread(bgthread), mClock(fake_clock),
+  mRateLimit(nullptr)
 {
   long alignment = pathconf((mDirPath[0] != '/') ? "/" : mDirPath.c_str(),
                             _PC_REC_XFER_ALIGN);
@@ -132,14 +134,18 @@ ScanDir::ScanDir(const char* dirpath, eos::common::FileSystem::fsid_t fsid,
   if (alignment > 0) {
     mBufferSize = 256 * alignment;
 
-    if (posix_memalign((void**) &mBuffer, alignment, mBufferSize)) {
+    if (posix_memalign((void**) &mBuffer, alignment, mBufferSize) ||
+        posix_memalign((void**) &mBuffer2, alignment, mBufferSize)) {
       fprintf(stderr, "error: error calling posix_memaling on dirpath=%s. \n",
               mDirPath.c_str());
       std::abort();
     }
+
+    mDirectIo = true;
   } else {
     mBufferSize = 256 * 1024;
     mBuffer = (char*) malloc(mBufferSize);
+    mBuffer2 = (char*) malloc(mBufferSize);
     fprintf(stderr,
             "error: OS does not provide alignment or path does not exist\n");
   }
@@ -169,6 +175,10 @@ ScanDir::~ScanDir()
   if (mBuffer) {
     free(mBuffer);
   }
+
+  if (mBuffer2) {
+    free(mBuffer2);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -745,15 +755,21 @@ ScanDir::RunDiskScan(ThreadAssistant& assistant) noexcept
 
     if (mDiskInterval.get()) {
       auto start_ts = std::chrono::system_clock::now();
+      ScanPassStarted();
       // Do the heavy work
       CheckTree(assistant);
+      ScanPassDone();
       auto finish_ts = std::chrono::system_clock::now();
       seconds duration = duration_cast<seconds>(finish_ts - start_ts);
+      double rate_mbs = 0.0;
+      uint64_t eta_sec = 0ull;
+      GetScanStats(0ull, rate_mbs, eta_sec);
       std::string log_msg =
           SSTR("[ScanDir] Directory: "
                << mDirPath << " files=" << mNumTotalFiles << " scanduration="
                << duration.count() << " [s] scansize=" << mTotalScanSize << " [Bytes] [ "
-               << (mTotalScanSize / 1e6) << " MB ] scannedfiles=" << mNumScannedFiles
+               << (mTotalScanSize / 1e6) << " MB ] scanrate=" << rate_mbs
+               << " [MB/s] scannedfiles=" << mNumScannedFiles
                << " corruptedfiles=" << mNumCorruptedFiles << " hwcorrupted="
                << mNumHWCorruptedFiles << " skippedfiles=" << mNumSkippedFiles
                << " disk_scan_interval_sec=" << mDiskInterval.get());
@@ -1018,6 +1034,7 @@ ScanDir::CheckFile(eos::fst::FileIo* io, const std::string& fpath)
   }
 
   ++mNumTotalFiles;
+  ScanPassAccount(info.st_size, 0ull);
 
   if (mBgThread) {
     if (gOFS.openedForWriting.isOpen(mFsId, fid)) {
@@ -1202,6 +1219,7 @@ ScanDir::ScanFile(eos::fst::FileIo* io, const std::string& fpath,
 
   // Collect statistics
   mTotalScanSize += scan_size;
+  ScanPassAccount(0ull, scan_size);
 
   if ((io->attrSet("user.eos.timestamp", GetTimestampSmearedSec())) ||
       (io->attrSet("user.eos.filecxerror", filexs_err ? "1" : "0")) ||
@@ -1267,12 +1285,24 @@ ScanDir::ScanFileLoadAware(eos::fst::FileIo* io, eos::common::FmdHelper* fmd,
                        file_path.c_str());
   }
 
+  // Local files are read through a dedicated descriptor bypassing the page
+  // cache, the next chunk being read while the current one is checksummed
+  eos::fst::utils::ScanReader reader(mBuffer, mBuffer2, mBufferSize);
+
+  if ((io->GetIoType() != "FsIo") ||
+      !reader.OpenUncached(file_path, mDirectIo)) {
+    reader.SetReadFunc([io](off_t offset, char* buff, uint32_t len) {
+      return io->fileRead(offset, buff, len);
+    });
+  }
+
   int64_t nread = 0;
   off_t offset = 0;
+  char* data = nullptr;
   const auto open_ts = std::chrono::system_clock::now();
 
   do {
-    nread = io->fileRead(offset, mBuffer, mBufferSize);
+    nread = reader.Next(data, offset);
 
     if (nread < 0) {
       if (blockXS) {
@@ -1297,13 +1327,13 @@ ScanDir::ScanFileLoadAware(eos::fst::FileIo* io, eos::common::FmdHelper* fmd,
       }
 
       if (blockXS && (blockxs_err == false)) {
-        if (!blockXS->CheckBlockSum(offset, mBuffer, nread)) {
+        if (!blockXS->CheckBlockSum(offset, data, nread)) {
           blockxs_err = true;
         }
       }
 
       if (comp_file_xs) {
-        comp_file_xs->Add(mBuffer, nread, offset);
+        comp_file_xs->Add(data, nread, offset);
       }
 
       offset += nread;
@@ -1958,4 +1988,70 @@ ScanDir::GetTimestampSmearedSec(bool rain_ts) const
 
   return std::to_string(ts_sec);
 }
+
+//------------------------------------------------------------------------------
+// Disk scan pass accounting
+//------------------------------------------------------------------------------
+void
+ScanDir::ScanPassStarted()
+{
+  std::lock_guard<std::mutex> lock(mPassMutex);
+  mPassRunning = true;
+  mPassStart = mClock.GetTime();
+  mPassVisitedBytes = mPassReadBytes = 0ull;
+}
+
+void
+ScanDir::ScanPassAccount(uint64_t visited_bytes, uint64_t read_bytes)
+{
+  std::lock_guard<std::mutex> lock(mPassMutex);
+  mPassVisitedBytes += visited_bytes;
+  mPassReadBytes += read_bytes;
+}
+
+void
+ScanDir::ScanPassDone()
+{
+  using namespace std::chrono;
+  std::lock_guard<std::mutex> lock(mPassMutex);
+  const double elapsed_sec =
+    duration_cast<milliseconds>(mClock.GetTime() - mPassStart).count() / 1000.0;
+  mLastPassRateMbs = (elapsed_sec > 0) ?
+                     (mPassReadBytes / 1e6) / elapsed_sec : 0.0;
+  mPassRunning = false;
+}
+
+//------------------------------------------------------------------------------
+// Get the scan throughput and the estimated time left of the current pass
+//------------------------------------------------------------------------------
+void
+ScanDir::GetScanStats(uint64_t used_bytes, double& rate_mbs,
+                      uint64_t& eta_sec) const
+{
+  using namespace std::chrono;
+  std::lock_guard<std::mutex> lock(mPassMutex);
+  rate_mbs = mLastPassRateMbs;
+  eta_sec = 0ull;
+
+  if (!mPassRunning) {
+    return;
+  }
+
+  const double elapsed_sec =
+    duration_cast<milliseconds>(mClock.GetTime() - mPassStart).count() / 1000.0;
+
+  if (elapsed_sec <= 0) {
+    return;
+  }
+
+  rate_mbs = (mPassReadBytes / 1e6) / elapsed_sec;
+
+  // The pass walks through all the files but only reads those due for a
+  // rescan, therefore the progress is estimated from the bytes walked
+  if (mPassVisitedBytes && (used_bytes > mPassVisitedBytes)) {
+    eta_sec = (uint64_t)((used_bytes - mPassVisitedBytes) * elapsed_sec /
+                         mPassVisitedBytes);
+  }
+}
+
 EOSFSTNAMESPACE_END
@@ -35,6 +35,7 @@
 #include "namespace/interface/IFileMD.hh"
 #include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
 #include <deque>
+#include <mutex>
 
 EOSFSTNAMESPACE_BEGIN
 
@@ -307,6 +308,19 @@ public:
   //----------------------------------------------------------------------------
   std::string GetTimestampSmearedSec(bool rain_ts = false) const;
 
+  //----------------------------------------------------------------------------
+  //! Get the scan throughput of the current disk scan pass, or of the last
+  //! one if no pass is running, and the estimated time left until the
+  //! current pass completes
+  //!
+  //! @param used_bytes bytes used on the file system
+  //! @param rate_mbs scan rate in MB/s
+  //! @param eta_sec estimated seconds until the end of the pass, 0 if no pass
+  //!        is running
+  //----------------------------------------------------------------------------
+  void GetScanStats(uint64_t used_bytes, double& rate_mbs,
+                    uint64_t& eta_sec) const;
+
 private:
 #ifdef IN_TEST_HARNESS
 public:
@@ -322,6 +336,16 @@ public:
   //----------------------------------------------------------------------------
   std::deque<eos::IFileMD::id_t> CollectNsFids(const std::string& type) const;
 
+  //----------------------------------------------------------------------------
+  //! Disk scan pass accounting used for the throughput and ETA reporting
+  //!
+  //! @param visited_bytes size of the files walked, scanned or not
+  //! @param read_bytes bytes actually read and checksummed
+  //----------------------------------------------------------------------------
+  void ScanPassStarted();
+  void ScanPassAccount(uint64_t visited_bytes, uint64_t read_bytes);
+  void ScanPassDone();
+
   //----------------------------------------------------------------------------
   //! Account for missing replicas
   //----------------------------------------------------------------------------
@@ -419,7 +443,17 @@ public:
   long int mNumTotalFiles;
   long int mNumSkippedFiles;
   char* mBuffer; ///< Buffer used for reading
-  uint32_t mBufferSize; ///< Size of the reading buffer
+  char* mBuffer2; ///< Second buffer used for the read-ahead
+  uint32_t mBufferSize; ///< Size of each of the reading buffers
+  bool mDirectIo; ///< True if the buffers are suitable for O_DIRECT reads
+  //! Disk scan pass statistics, updated by the disk scan thread and read by
+  //! the publisher
+  mutable std::mutex mPassMutex;
+  bool mPassRunning {false};
+  std::chrono::steady_clock::time_point mPassStart;
+  uint64_t mPassVisitedBytes {0};
+  uint64_t mPassReadBytes {0};
+  double mLastPassRateMbs {0.0}; ///< Scan rate of the last completed pass
   bool mBgThread; ///< If true running as background thread inside the FST
   AssistedThread mDiskThread; ///< Thread doing the scanning of the disk
   AssistedThread mNsThread; ///< Thread doing the scanning of NS entries
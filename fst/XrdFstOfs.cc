@@ -24,6 +24,7 @@
 #include "fst/XrdFstOfs.hh"
 #include "fst/XrdFstOss.hh"
 #include "fst/cache/CacheLru.hh"
+#include "fst/cache/CacheWarmer.hh"
 #include "fst/Config.hh"
 #include "fst/filemd/FmdAttr.hh"
 #include "fst/checksum/ChecksumPlugins.hh"
@@ -41,6 +42,7 @@
 #include "common/BuildVersion.hh"
 #include "common/Constants.hh"
 #include "common/CrashHandler.hh"
+#include "common/ErrnoToString.hh"
 #include "common/FileId.hh"
 #include "common/FileSystem.hh"
 #include "common/PasswordHandler.hh"
@@ -53,6 +55,7 @@
 #include "common/SymKeys.hh"
 #include "common/SyncAll.hh"
 #include "common/Timing.hh"
+#include "common/Tracing.hh"
 #include "common/Utils.hh"
 #include "common/XattrCompat.hh"
 #include "common/async/ExecutorMgr.hh"
@@ -346,6 +349,7 @@ XrdFstOfs::XrdFstOfs() :
   mHostName(NULL), mHttpd(nullptr),
   mGeoTag("nogeotag"), mXrdBuffPool(eos::common::KB, 32 * eos::common::MB),
   mAsyncOpThreadPool(8, 64, 5, 6, 5, "async_op"),
+  mAsyncCloseThreadPool(8, 64, 5, 6, 5, "async_close"),
   mMgmXrdPool(nullptr),
   mSimOpenDelay(false), mSimOpenDelaySec(120),
   mSimFmdOpenErr(false), mSimIoReadErr(false),
@@ -443,6 +447,9 @@ XrdFstOfs::XrdFstOfs() :
 //------------------------------------------------------------------------------
 XrdFstOfs::~XrdFstOfs()
 {
+  // Stop the batcher before the MGM connection pool goes away
+  mCommitBatcher.reset();
+
   if (mHostName) {
     free(const_cast<char*>(mHostName));
   }
@@ -787,6 +794,39 @@ XrdFstOfs::Configure(XrdSysError& Eroute, XrdOucEnv* envP)
     Eroute.Say("=====> fstofs.filemd_handler : attr");
   }
 
+  // Batch the MGM commits done during close if requested
+  if (getenv("EOS_FST_COMMIT_BATCH_WINDOW_MS")) {
+    uint64_t window_ms = 0ull;
+    uint64_t max_items = 0ull;
+    eos::common::StringToNumeric(std::string
+                                 (getenv("EOS_FST_COMMIT_BATCH_WINDOW_MS")),
+                                 window_ms, 0ull);
+
+    if (getenv("EOS_FST_COMMIT_BATCH_MAX_ITEMS")) {
+      eos::common::StringToNumeric(std::string
+                                   (getenv("EOS_FST_COMMIT_BATCH_MAX_ITEMS")),
+                                   max_items, 64ull);
+    } else {
+      max_items = 64ull;
+    }
+
+    if (window_ms) {
+      auto send = [this](const std::string & manager, const std::string & request,
+      std::string & response) {
+        XrdOucErrInfo error;
+        return CallManager(&error, "/commitbatch",
+                           (manager.empty() ? nullptr : manager.c_str()),
+                           request, 0, true, false, &response);
+      };
+      mCommitBatcher.reset(new fst::utils::CommitBatcher
+                           (send, std::chrono::milliseconds(window_ms),
+                            max_items));
+      Eroute.Say("=====> fstofs.commitbatch window_ms : ",
+                 std::to_string(window_ms).c_str(), " max_items : ",
+                 std::to_string(max_items).c_str());
+    }
+  }
+
   gConfig.FstDefaultReceiverQueue = gConfig.FstOfsBrokerUrl;
   gConfig.FstOfsBrokerUrl += mHostName;
   gConfig.FstOfsBrokerUrl += ":";
@@ -910,6 +950,15 @@ XrdFstOfs::Configure(XrdSysError& Eroute, XrdOucEnv* envP)
                           : std::string();
     });
 
+  // Sampled request tracing, the sample rate comes from the node config and
+  // the traces are dumped in the meta log dir upon signal 43
+  eos::common::Tracer::Instance().StartDumper("fst",
+      gConfig.FstMetaLogDir.c_str());
+
+  if (SIGRTMIN <= 43 && 43 <= SIGRTMAX) {
+    (void) signal(43, eos::common::Tracer::DumpSignalHandler);
+  }
+
   // Start the embedded HTTP server
   mHttpdPort = 8001;
 
@@ -1109,11 +1158,12 @@ int
 XrdFstOfs::CallManager(XrdOucErrInfo* error, const char* path,
                        const char* manager, const std::string& opaque,
                        unsigned short timeout,
-                       bool use_xrd_conn_pool, bool retry)
+                       bool use_xrd_conn_pool, bool retry,
+                       std::string* response)
 {
   XrdOucString ouc_opaque = opaque.c_str();
   int rc = CallManager(error, path, manager, ouc_opaque, timeout,
-                       use_xrd_conn_pool, retry);
+                       use_xrd_conn_pool, retry, response);
   return rc;
 }
 
@@ -1124,7 +1174,8 @@ int
 XrdFstOfs::CallManager(XrdOucErrInfo* error, const char* path,
                        const char* manager, XrdOucString& capOpaqueFile,
                        unsigned short timeout,
-                       bool use_xrd_conn_pool, bool retry)
+                       bool use_xrd_conn_pool, bool retry,
+                       std::string* response_data)
 {
   EPNAME("CallManager");
   int rc = SFS_OK;
@@ -1195,46 +1246,19 @@ again:
   if (status.IsOK()) {
     eos_static_debug("msg=\"MGM query succeeded\" opaque=\"%s\"", opaque.c_str());
     rc = SFS_OK;
-  } else {
-    eos_static_err("msg=\"MGM query failed\" opaque=\"%s\"", opaque.c_str());
-    msg = (status.GetErrorMessage().c_str());
-    rc = SFS_ERROR;
-
-    if (msg.find("[EIDRM]") != STR_NPOS) {
-      rc = EIDRM;
-    }
-
-    if (msg.find("[EBADE]") != STR_NPOS) {
-      rc = EBADE;
-    }
-
-    if (msg.find("[EBADR]") != STR_NPOS) {
-      rc = EBADR;
-    }
-
-    if (msg.find("[EINVAL]") != STR_NPOS) {
-      rc = EINVAL;
-    }
 
-    if (msg.find("[EADV]") != STR_NPOS) {
-      rc = EADV;
-    }
+    if (response_data) {
+      response_data->clear();
 
-    if (msg.find("[EAGAIN]") != STR_NPOS) {
-      rc = EAGAIN;
-    }
-
-    if (msg.find("[ENOTCONN]") != STR_NPOS) {
-      rc = ENOTCONN;
-    }
-
-    if (msg.find("[EPROTO]") != STR_NPOS) {
-      rc = EPROTO;
-    }
-
-    if (msg.find("[EREMCHG]") != STR_NPOS) {
-      rc = EREMCHG;
+      if (response && response->GetBuffer()) {
+        response_data->assign(response->GetBuffer(),
+                              strnlen(response->GetBuffer(), response->GetSize()));
+      }
     }
+  } else {
+    eos_static_err("msg=\"MGM query failed\" opaque=\"%s\"", opaque.c_str());
+    msg = (status.GetErrorMessage().c_str());
+    rc = eos::common::ErrnoFromMsgTag(msg.c_str(), SFS_ERROR);
 
     if (rc != SFS_ERROR) {
       return gOFS.Emsg(epname, *error, rc, msg.c_str(), path);
@@ -1572,6 +1596,80 @@ XrdFstOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
       return SFS_DATA;
     }
 
+    if (execmd == "cacheprefetch") {
+      XrdOucEnv* cap_env = nullptr;
+      int caprc = eos::common::SymKey::ExtractCapability(&env, cap_env);
+
+      if (caprc || !cap_env) {
+        delete cap_env;
+        return Emsg(epname, error, EINVAL, "extract cacheprefetch capability", "");
+      }
+
+      std::unique_ptr<XrdOucEnv> cap(cap_env);
+      const char* sfid = cap->Get("mgm.fid");
+      const char* cache_fsid = cap->Get("mgm.cache.fsid");
+      const char* host = cap->Get("mgm.cache.backend.host");
+      const char* sport = cap->Get("mgm.cache.backend.port");
+      const char* cpath = cap->Get("mgm.path");
+      const char* ssize = cap->Get("mgm.size");
+      const char* smtime = cap->Get("mgm.cache.mtime");
+
+      if (!sfid || !cache_fsid || !host || !sport || !cpath || !ssize) {
+        return Emsg(epname, error, EINVAL, "prefetch - missing cache info", "");
+      }
+
+      eos::fst::CacheWarmer::Job job;
+      job.mFid = eos::common::FileId::Hex2Fid(sfid);
+      job.mCacheFsId = atoi(cache_fsid);
+      job.mCacheFsPath = gOFS.Storage->GetStoragePath(job.mCacheFsId);
+
+      if (job.mCacheFsPath.empty()) {
+        return Emsg(epname, error, ENOENT, "prefetch - cache filesystem is not "
+                    "attached to this FST", cache_fsid);
+      }
+
+      job.mSize = strtoull(ssize, nullptr, 10);
+      job.mMTime = smtime ? (time_t) strtoll(smtime, nullptr, 10) : 0;
+      const char* val = cap->Get("mgm.cache.low_watermark");
+      job.mLowWatermark = val ? val : "";
+      val = cap->Get("mgm.cache.high_watermark");
+      job.mHighWatermark = val ? val : "";
+      // The capability is forwarded as is to the backend FST, it carries the
+      // backend fsid. The bridge flag prevents the backend from serving the
+      // open through the cache layout again.
+      std::string open_opaque = opaque.c_str();
+      const std::string pcmd_tag = "fst.pcmd=cacheprefetch";
+      const size_t pos = open_opaque.find(pcmd_tag);
+
+      if (pos != std::string::npos) {
+        open_opaque.erase(pos, pcmd_tag.length());
+      }
+
+      job.mUrl = SSTR("root://" << host << ":" << sport << "/" << cpath
+                      << "?" << open_opaque << "&eos.cache.bridge=1");
+      // The MGM records the cache location only once the warm-up is done
+      job.mOnWarmed = [](const eos::fst::CacheWarmer::Job & done) {
+        XrdOucErrInfo lerror;
+        const std::string report = SSTR("/?mgm.pcmd=cachewarmed&mgm.fid="
+                                        << eos::common::FileId::Fid2Hex(done.mFid)
+                                        << "&mgm.cache.fsid=" << done.mCacheFsId);
+
+        if (gOFS.CallManager(&lerror, nullptr, nullptr, report)) {
+          eos_static_err("msg=\"failed to report cache warm-up\" fxid=%08llx "
+                         "fsid=%u", done.mFid, done.mCacheFsId);
+        }
+      };
+      const int rc = eos::fst::CacheWarmer::Instance().Submit(std::move(job));
+
+      if (rc) {
+        return Emsg(epname, error, rc, "queue cache prefetch", "");
+      }
+
+      const char* okmsg = "OK";
+      error.setErrInfo(strlen(okmsg) + 1, okmsg);
+      return SFS_DATA;
+    }
+
     if (execmd == "clean_orphans") {
       return HandleCleanOrphans(env, error);
     }
@@ -30,6 +30,8 @@
 #include "common/XrdConnPool.hh"
 #include "fst/Namespace.hh"
 #include "fst/storage/TrafficShaping.hh"
+#include "fst/utils/CloseStats.hh"
+#include "fst/utils/CommitBatcher.hh"
 #include "fst/utils/OpenFileTracker.hh"
 #include "fst/utils/TpcInfo.hh"
 #include "mq/MessagingRealm.hh"
@@ -330,7 +332,8 @@ public:
                   XrdOucString& capOpaqueFile,
                   unsigned short timeout = 0,
                   bool use_xrd_conn_pool = false,
-                  bool retry = true);
+                  bool retry = true,
+                  std::string* response = nullptr);
 
   //----------------------------------------------------------------------------
   //! Callback to MGM node - std::string version
@@ -341,7 +344,8 @@ public:
                   const std::string& capOpaqueFile,
                   unsigned short timeout = 0,
                   bool use_xrd_conn_pool = false,
-                  bool retry = true);
+                  bool retry = true,
+                  std::string* response = nullptr);
 
   //----------------------------------------------------------------------------
   //! Function dealing with plugin calls
@@ -440,6 +444,9 @@ public:
   std::optional<std::string> ConcatenatedServerRootCA;
   fst::traffic_shaping::IoStatsCollector mIoStatsCollector;
   fst::traffic_shaping::IoDelayConfig mIoDelayConfig;
+  fst::utils::CloseStats mCloseStats; ///< Close latency statistics
+  //! Batcher for the MGM commits done on close, null if batching is disabled
+  std::unique_ptr<fst::utils::CommitBatcher> mCommitBatcher;
 
 private:
 #ifdef IN_TEST_HARNESS
@@ -450,6 +457,9 @@ public:
   XrdOucBuffPool mXrdBuffPool;
   //! Thread pool for async file  operations
   eos::common::ThreadPool mAsyncOpThreadPool;
+  //! Thread pool dedicated to async close operations so that long closes
+  //! (checksum rescans, MGM commits) don't starve the other async operations
+  eos::common::ThreadPool mAsyncCloseThreadPool;
   //! Xrd connection pool for interaction with the MGM, used from CallManager
   std::unique_ptr<eos::common::XrdConnPool> mMgmXrdPool;
   std::atomic<bool> mSimOpenDelay; ///< simulate an open timeout for client
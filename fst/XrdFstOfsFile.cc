@@ -27,6 +27,7 @@
 #include "common/StringTokenizer.hh"
 #include "common/StringUtils.hh"
 #include "common/Timing.hh"
+#include "common/Tracing.hh"
 #include "common/WFEClient.hh"
 #include "common/http/OwnCloud.hh"
 #include "common/xrootd-ssi-protobuf-interface/eos_cta/include/CtaFrontendApi.hpp"
@@ -179,6 +180,7 @@ XrdFstOfsFile::open(const char* path, XrdSfsFileOpenMode open_mode,
   XrdOucString maskOpaque = opaque ? opaque : "";
   eos::common::StringConversion::MaskTag(maskOpaque, "cap.sym");
   eos::common::StringConversion::MaskTag(maskOpaque, "cap.msg");
+  eos::common::StringConversion::MaskTag(maskOpaque, "cap.bin");
   eos::common::StringConversion::MaskTag(maskOpaque, "authz");
   eos_info("path=%s info=%s open_mode=%x", mNsPath.c_str(),
            maskOpaque.c_str(), open_mode);
@@ -937,11 +939,16 @@ XrdFstOfsFile::read(XrdSfsFileOffset fileOffset, char* buffer,
                     XrdSfsXferSize buffer_size)
 {
   gettimeofday(&rStart, &tz);
+  eos::common::TraceRequest trace_request("fst.read");
   // Throttle before grabbing the scheduling mutex so that a limited stream
   // does not block the other streams of the same application
-  RegulateBandwidth();
+  {
+    eos::common::TraceSpan shaping_span("fst.read.shaping");
+    RegulateBandwidth();
+  }
   // use RR scheduling if there is a round-robin app name
   std::mutex* mutex = nullptr;
+  eos::common::TraceSpan rr_span;
 
   if (!mAppRR.empty()) {
     if (mIsRW) {
@@ -949,11 +956,14 @@ XrdFstOfsFile::read(XrdSfsFileOffset fileOffset, char* buffer,
     } else {
       mutex = gOFS.openedForReading.scheduleRR(mFsId, mAppRR);
     }
+
+    rr_span.Begin("fst.read.rr", eos::common::SpanKind::kLockWait);
   }
 
   auto lockScope = (mutex == nullptr) ?
                    std::unique_lock<std::mutex>() :
                    std::unique_lock<std::mutex>(*mutex);
+  rr_span.End();
   eos_debug("fileOffset=%lli, buffer_size=%i", fileOffset, buffer_size);
 
   if (mTpcFlag == kTpcSrcRead) {
@@ -967,11 +977,15 @@ XrdFstOfsFile::read(XrdSfsFileOffset fileOffset, char* buffer,
     }
   }
 
-  gOFS.mIoDelayConfig.WaitForRead(vid, static_cast<uint64_t>(buffer_size));
-
+  {
+    eos::common::TraceSpan delay_span("fst.read.delay");
+    gOFS.mIoDelayConfig.WaitForRead(vid, static_cast<uint64_t>(buffer_size));
+  }
+  eos::common::TraceSpan layout_span("fst.read.layout");
   // Must stay signed - Layout::Read returns -1 on error and an unsigned type
   // would turn this into a huge positive value corrupting all the checks below
   const int64_t rc = mLayout->Read(fileOffset, buffer, buffer_size);
+  layout_span.End();
 
   if (rc > 0) {
     gOFS.mIoStatsCollector.RecordRead(vid.app, vid.uid, vid.gid, mFsId, rc);
@@ -988,6 +1002,7 @@ XrdFstOfsFile::read(XrdSfsFileOffset fileOffset, char* buffer,
   /* maintaining a checksum is tricky if there have been writes,
    * but the read + append case can be supported in "Add" */
   if (rc > 0 && mChecksumGroup->HasChecksums() && !mHasWrite) {
+    eos::common::TraceSpan xs_span("fst.read.checksum");
     mChecksumGroup->Add(buffer, static_cast<size_t>(rc),
                         static_cast<off_t>(fileOffset));
   }
@@ -1141,6 +1156,7 @@ XrdFstOfsFile::write(XrdSfsFileOffset fileOffset, const char* buffer,
                      XrdSfsXferSize buffer_size)
 {
   gettimeofday(&wStart, &tz);
+  eos::common::TraceRequest trace_request("fst.write");
 
   if (gOFS.mSimUnresponsive) {
     eos_warning("msg=\"simulate unresponsive write, delay by 120s\" "
@@ -1158,7 +1174,11 @@ XrdFstOfsFile::write(XrdSfsFileOffset fileOffset, const char* buffer,
 
   // Throttle before grabbing the scheduling mutexes so that a limited stream
   // does not block the other streams of the same application
-  RegulateBandwidth();
+  {
+    eos::common::TraceSpan shaping_span("fst.write.shaping");
+    RegulateBandwidth();
+  }
+  eos::common::TraceSpan rr_span;
   {
     // use global RR serialization (we just use fsid 0 for that)
     std::mutex* mutex = nullptr;
@@ -1169,6 +1189,8 @@ XrdFstOfsFile::write(XrdSfsFileOffset fileOffset, const char* buffer,
       } else {
         mutex = gOFS.openedForReading.scheduleRR(0, mAppRR);
       }
+
+      rr_span.Begin("fst.write.rr", eos::common::SpanKind::kLockWait);
     }
 
     auto lockScope = (mutex == nullptr) ?
@@ -1190,6 +1212,7 @@ XrdFstOfsFile::write(XrdSfsFileOffset fileOffset, const char* buffer,
   auto lockScope = (mutex == nullptr) ?
                    std::unique_lock<std::mutex>() :
                    std::unique_lock<std::mutex>(*mutex);
+  rr_span.End();
 
   // if the write position moves the checksum is dirty
   if (mChecksumGroup->HasChecksums()) {
@@ -1208,9 +1231,13 @@ XrdFstOfsFile::write(XrdSfsFileOffset fileOffset, const char* buffer,
   }
 
   int64_t rc = 0;
-  gOFS.mIoDelayConfig.WaitForWrite(vid, static_cast<uint64_t>(buffer_size));
-
+  {
+    eos::common::TraceSpan delay_span("fst.write.delay");
+    gOFS.mIoDelayConfig.WaitForWrite(vid, static_cast<uint64_t>(buffer_size));
+  }
+  eos::common::TraceSpan layout_span("fst.write.layout");
   rc = mLayout->Write(fileOffset, const_cast<char*>(buffer), buffer_size);
+  layout_span.End();
   if (rc > 0) {
     gOFS.mIoStatsCollector.RecordWrite(vid.app, vid.uid, vid.gid, mFsId, rc);
   }
@@ -1233,6 +1260,7 @@ XrdFstOfsFile::write(XrdSfsFileOffset fileOffset, const char* buffer,
   // Evt. add checksum
   if (rc > 0) {
     if (mChecksumGroup->HasChecksums()) {
+      eos::common::TraceSpan xs_span("fst.write.checksum");
       mChecksumGroup->Add(buffer, static_cast<size_t>(rc),
                           static_cast<off_t>(fileOffset));
     }
@@ -1582,9 +1610,25 @@ XrdFstOfsFile::close()
   // value at the end of the close.
   error.setErrCode(0);
   static bool async_close_cfg = IsAsyncCloseConfigured();
+  static uint64_t max_pending_async_close = GetAsyncCloseMaxPending();
 
   if (!async_close_cfg || DoSyncClose()) {
-    return _close();
+    int rc = _close();
+    AccountCloseLatency(false);
+    return rc;
+  }
+
+  // Bound the number of closes waiting in the async thread pool, once the
+  // backlog is full the close is done in the current thread which naturally
+  // throttles the clients. The slot reserved here is released once the async
+  // close is done.
+  if (!gOFS.mCloseStats.TryAsyncQueue(max_pending_async_close)) {
+    eos_warning("msg=\"async close backlog full, doing sync close\" "
+                "fxid=%08llx pending=%llu", mFileId,
+                gOFS.mCloseStats.GetAsyncPending());
+    int rc = _close();
+    AccountCloseLatency(false);
+    return rc;
   }
 
   // Delegate close to a different thread while the client is waiting for the
@@ -1597,12 +1641,19 @@ XrdFstOfsFile::close()
   auto close_cb = std::make_shared<XrdOucCallBack>();
   close_cb->Init(&error);
   error.setErrInfo(1800, "delay client up to 30 minutes for close");
-  gOFS.mAsyncOpThreadPool.PushTask<void>([&, close_cb]() -> void {
+  gOFS.mAsyncCloseThreadPool.PushTask<void>([&, close_cb]() -> void {
     // Make a local copy since the XrdFstOfsFile object is destroyed after
     // the callback reply is called!
     const auto fid = mFileId;
     eos_info("msg=\"doing close in the async thread\" fxid=%08llx", fid);
     int rc = _close();
+    // The reply is sent only once the replica is committed locally and at
+    // the MGM, therefore the durability guarantees are the same as for a
+    // synchronous close. This includes the checksum finalization (and the
+    // rescan of files not written sequentially) since the MGM commit must
+    // carry the final checksum.
+    AccountCloseLatency(true);
+    gOFS.mCloseStats.AsyncDone();
     // During Reply() we expect the enclosing XrdFstOfsFile to be destroyed,
     // so we don't refer to anything captured by reference once done
     int reply_rc = close_cb->Reply(rc, (rc ? error.getErrInfo() : 0),
@@ -1933,10 +1984,7 @@ XrdFstOfsFile::_close_wr()
           // dropping a good replica for a failed reconstruction which we
           // can not get back.
           if ((mRainReconstruct == false) && (rc = CommitToMgm())) {
-            if ((error.getErrInfo() == EIDRM) ||
-                (error.getErrInfo() == EBADE) ||
-                (error.getErrInfo() == EBADR) ||
-                (error.getErrInfo() == EREMCHG)) {
+            if (utils::CommitBatcher::IsReplicaRejected(error.getErrInfo())) {
               if (error.getErrInfo() == EIDRM) {
                 // File has been deleted in the meanwhile ... we can unlink
                 eos_err("msg=\"unlink file since already removed in the ns\"  "
@@ -2048,10 +2096,7 @@ XrdFstOfsFile::_close_wr()
   // Commit to MGM in case of rain reconstruction and not del on close
   if (mRainReconstruct && mLayout->IsEntryServer() && !mDelOnClose) {
     if ((rc = CommitToMgm())) {
-      if ((error.getErrInfo() == EIDRM) ||
-          (error.getErrInfo() == EBADE) ||
-          (error.getErrInfo() == EBADR) ||
-          (error.getErrInfo() == EREMCHG)) {
+      if (utils::CommitBatcher::IsReplicaRejected(error.getErrInfo())) {
         eos_err("msg=\"failed commit to MGM for RAIN reconstruct\" "
                 "fxid=%08llx", mFileId);
         mDelOnClose = true;
@@ -2294,7 +2339,9 @@ XrdFstOfsFile::readofs(XrdSfsFileOffset fileOffset, char* buffer,
     }
   }
 
+  eos::common::TraceSpan disk_span("fst.disk.read");
   int rc = XrdOfsFile::read(fileOffset, buffer, buffer_size);
+  disk_span.End();
   eos_debug("read %llu %llu %i rc=%d", this, fileOffset, buffer_size, rc);
 
   if (!getenv("EOS_FST_NO_IOPRIORITY")) {
@@ -2451,6 +2498,7 @@ XrdFstOfsFile::writeofs(XrdSfsFileOffset fileOffset, const char* buffer,
     XrdFstOfsFile::truncateofs(fileOffset);
     rc = buffer_size;
   } else {
+    eos::common::TraceSpan disk_span("fst.disk.write");
     rc = XrdOfsFile::write(fileOffset, buffer, buffer_size);
   }
 
@@ -4452,6 +4500,44 @@ XrdFstOfsFile::GetAsyncCloseMinSize()
   return min_size_async_close;
 }
 
+//------------------------------------------------------------------------------
+// Get configured maximum number of closes pending in the async thread pool
+//------------------------------------------------------------------------------
+uint64_t
+XrdFstOfsFile::GetAsyncCloseMaxPending()
+{
+  uint64_t max_pending = 4096ull;
+  const char* ptr = getenv("EOS_FST_ASYNC_CLOSE_MAX_PENDING");
+
+  if (ptr) {
+    if (!eos::common::StringToNumeric(std::string(ptr), max_pending,
+                                      max_pending)) {
+      eos_static_err("%s", "msg=\"failed to convert "
+                     "EOS_FST_ASYNC_CLOSE_MAX_PENDING, using by default 4096\"");
+    }
+  }
+
+  return max_pending;
+}
+
+//------------------------------------------------------------------------------
+// Account the latency of a close operation for files opened for writing
+//------------------------------------------------------------------------------
+void
+XrdFstOfsFile::AccountCloseLatency(bool async)
+{
+  if (!mIsRW || mIsDevNull) {
+    return;
+  }
+
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  const int64_t latency_us = ((now.tv_sec - closeStart.tv_sec) * 1000000) +
+                             (now.tv_usec - closeStart.tv_usec);
+  gOFS.mCloseStats.Add(mCloseSize, std::chrono::microseconds(latency_us),
+                       async);
+}
+
 //------------------------------------------------------------------------------
 // Populate and commit FMD info locally
 //------------------------------------------------------------------------------
@@ -4539,9 +4625,9 @@ XrdFstOfsFile::CommitToMgm()
                                 mFmd->mProtoFmd.mtime_ns());
   int envlen = 0;
   char* ptr = nullptr;
-  oss << "/?" << mCapOpaque->Env(envlen)
-      << "&mgm.pcmd=commit"
-      << "&mgm.size=" << mCloseSize
+  // Build only the commit specific information, the capability is added
+  // depending on whether the commit is batched or not
+  oss << "&mgm.size=" << mCloseSize
       << "&mgm.mtime=" << smtime
       << "&mgm.mtime_ns=" << smtime_ns
       << "&mgm.logid=" << logId;
@@ -4649,8 +4735,34 @@ XrdFstOfsFile::CommitToMgm()
     oss << eos::common::OwnCloud::FilterOcQuery(mOpenOpaque->Env(envlen));
   }
 
-  int retc = gOFS.CallManager(&error, mNsPath.c_str(), mRdrManager.c_str(),
-                              oss.str(), 0, true);
+  int retc = SFS_OK;
+  bool batched = false;
+
+  // OC chunk and RAIN reconstruction commits are not supported in batches
+  if (gOFS.mCommitBatcher && !mIsOCchunk && !mRainReconstruct) {
+    std::ostringstream item;
+    ptr = mCapOpaque->Get("mgm.path");
+    item << "mgm.path=" << (ptr ? ptr : "");
+    ptr = mCapOpaque->Get("mgm.fid");
+    item << "&mgm.fid=" << (ptr ? ptr : "") << oss.str();
+    retc = gOFS.mCommitBatcher->Submit(mRdrManager.c_str(), item.str()).get();
+
+    if (retc >= 0) {
+      batched = true;
+
+      if (retc) {
+        retc = gOFS.Emsg("CommitToMgm", error, retc, "commit file metadata "
+                         "in batch", mNsPath.c_str());
+      }
+    }
+  }
+
+  if (!batched) {
+    const std::string request = SSTR("/?" << mCapOpaque->Env(envlen)
+                                     << "&mgm.pcmd=commit" << oss.str());
+    retc = gOFS.CallManager(&error, mNsPath.c_str(), mRdrManager.c_str(),
+                            request, 0, true);
+  }
 
   if (gOFS.mSimCloseCommitMgmErr) {
     eos_err("msg=\"simulate error during MGM commit\" path=\"%s\"",
@@ -529,6 +529,14 @@ public:
   //----------------------------------------------------------------------------
   static bool IsAsyncCloseConfigured();
 
+  //----------------------------------------------------------------------------
+  //! Get configured maximum number of closes that can be pending in the async
+  //! close thread pool before falling back to synchronous closes.
+  //!
+  //! @return max number of pending async closes
+  //----------------------------------------------------------------------------
+  static uint64_t GetAsyncCloseMaxPending();
+
   //----------------------------------------------------------------------------
   //! Check if async sycn is configured - a bit of an oxymoron ...
   //!
@@ -928,6 +936,14 @@ public:
   //----------------------------------------------------------------------------
   bool DoSyncClose();
 
+  //----------------------------------------------------------------------------
+  //! Account the latency of a close operation for files opened for writing,
+  //! measured from the moment the close request was received.
+  //!
+  //! @param async true if the close was done in the async thread pool
+  //----------------------------------------------------------------------------
+  void AccountCloseLatency(bool async);
+
   //----------------------------------------------------------------------------
   //! Decide if sync should be done synchronously. There are cases when sync
   //! should happen in the same thread eg. read, http tx, sink writes etc.
@@ -4,6 +4,7 @@
 
 #include "fst/cache/CacheLru.hh"
 #include "fst/cache/SparseJournal.hh"
+#include "common/Constants.hh"
 #include "common/Logging.hh"
 #include <dirent.h>
 #include <sys/stat.h>
@@ -440,6 +441,54 @@ CacheLruRegistry::GetConfig(eos::common::FileSystem::fsid_t fsid,
   return resolver(fsid, key);
 }
 
+namespace
+{
+//------------------------------------------------------------------------------
+//! Parse a watermark percent string; returns fallback when out of range
+//------------------------------------------------------------------------------
+unsigned
+ParseWatermark(const char* value, unsigned fallback)
+{
+  if (!value || !*value) {
+    return fallback;
+  }
+
+  char* end = nullptr;
+  const long v = std::strtol(value, &end, 10);
+
+  if ((end == value) || (v < 0) || (v > 100)) {
+    return fallback;
+  }
+
+  return (unsigned) v;
+}
+}
+
+void
+CacheLruRegistry::ConfigureWatermarks(CacheLru* lru, const char* cap_low,
+                                      const char* cap_high)
+{
+  if (!lru) {
+    return;
+  }
+
+  unsigned low = ParseWatermark(
+                   eos::common::SPACE_CACHE_LOW_WATERMARK_DEFAULT, 70);
+  unsigned high = ParseWatermark(
+                    eos::common::SPACE_CACHE_HIGH_WATERMARK_DEFAULT, 85);
+  low = ParseWatermark(cap_low, low);
+  high = ParseWatermark(cap_high, high);
+  // The resolver is registered by the FST server; in standalone tools it
+  // is absent and the capability values apply
+  const std::string fs_low = GetConfig(lru->GetFsId(),
+                                       eos::common::SPACE_CACHE_LOW_WATERMARK_NAME);
+  const std::string fs_high = GetConfig(lru->GetFsId(),
+                                        eos::common::SPACE_CACHE_HIGH_WATERMARK_NAME);
+  low = ParseWatermark(fs_low.c_str(), low);
+  high = ParseWatermark(fs_high.c_str(), high);
+  lru->SetWatermarks(low, high);
+}
+
 int
 CacheLruRegistry::TruncateJournal(eos::common::FileSystem::fsid_t fsid,
                                   uint64_t fid,
@@ -73,6 +73,8 @@ public:
   std::atomic<uint64_t> mMisses{0};
   std::atomic<uint64_t> mBridges{0};
   std::atomic<uint64_t> mEvictions{0};
+  std::atomic<uint64_t> mPrefetched{0};
+  std::atomic<uint64_t> mPrefetchedBytes{0};
 
 private:
   using FidList = std::list<uint64_t>;
@@ -133,6 +135,11 @@ public:
   std::string GetConfig(eos::common::FileSystem::fsid_t fsid,
                         const std::string& key);
 
+  //! Apply the watermarks to lru: local filesystem config first, then the
+  //! capability values (may be null), then the compiled-in defaults
+  void ConfigureWatermarks(CacheLru* lru, const char* cap_low,
+                           const char* cap_high);
+
 private:
   CacheLruRegistry() = default;
   std::mutex mMutex;
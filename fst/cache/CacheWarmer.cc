@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+//! @file CacheWarmer.cc
+//------------------------------------------------------------------------------
+
+#include "fst/cache/CacheWarmer.hh"
+#include "fst/cache/CacheLru.hh"
+#include "fst/cache/SparseJournal.hh"
+#include "fst/io/FileIoPlugin.hh"
+#include "common/Logging.hh"
+#include <XrdSfs/XrdSfsInterface.hh>
+#include <algorithm>
+#include <memory>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace
+{
+//! Size of the backend reads
+constexpr size_t kChunkSize = 4 * 1024 * 1024;
+}
+
+CacheWarmer&
+CacheWarmer::Instance()
+{
+  static CacheWarmer inst;
+  return inst;
+}
+
+CacheWarmer::~CacheWarmer()
+{
+  for (auto& worker : mWorkers) {
+    worker->stop();
+  }
+
+  mCv.notify_all();
+  mWorkers.clear();
+}
+
+//------------------------------------------------------------------------------
+// Queue a job, the workers are started on first use
+//------------------------------------------------------------------------------
+int
+CacheWarmer::Submit(Job&& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mWorkers.empty()) {
+      for (size_t i = 0; i < sNumWorkers; ++i) {
+        mWorkers.emplace_back(new AssistedThread());
+        mWorkers.back()->reset(&CacheWarmer::Worker, this);
+      }
+    }
+
+    if (mQueuedFids.count(job.mFid)) {
+      return 0;
+    }
+
+    if (mQueue.size() >= sMaxQueued) {
+      ++mRejected;
+      return EBUSY;
+    }
+
+    mQueuedFids.insert(job.mFid);
+    mQueue.push_back(std::move(job));
+  }
+
+  mCv.notify_one();
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Worker loop
+//------------------------------------------------------------------------------
+void
+CacheWarmer::Worker(ThreadAssistant& assistant) noexcept
+{
+  while (!assistant.terminationRequested()) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+
+      if (!mCv.wait_for(lock, std::chrono::seconds(1),
+      [&]() {
+      return !mQueue.empty() || assistant.terminationRequested();
+      }) || mQueue.empty()) {
+        continue;
+      }
+
+      job = std::move(mQueue.front());
+      mQueue.pop_front();
+    }
+    const int rc = Warm(job);
+
+    if (rc == 0) {
+      ++mWarmed;
+
+      if (job.mOnWarmed) {
+        job.mOnWarmed(job);
+      }
+    } else {
+      ++mFailed;
+      eos_static_info("msg=\"cache prefetch failed\" fxid=%08llx fsid=%u "
+                      "errno=%d", job.mFid, job.mCacheFsId, rc);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQueuedFids.erase(job.mFid);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Fill the journal of the job's file from the backend
+//------------------------------------------------------------------------------
+int
+CacheWarmer::Warm(const Job& job)
+{
+  CacheLru* lru = CacheLruRegistry::Instance().GetOrCreate(job.mCacheFsId,
+                  job.mCacheFsPath);
+
+  if (!lru) {
+    return EIO;
+  }
+
+  CacheLruRegistry::Instance().ConfigureWatermarks(lru,
+      job.mLowWatermark.c_str(), job.mHighWatermark.c_str());
+
+  // Never evict user data for speculative reads
+  if (!lru->CanAdmit(0)) {
+    return ENOSPC;
+  }
+
+  auto journal = lru->GetJournal(job.mFid, job.mSize, job.mMTime);
+
+  if (!journal) {
+    return EIO;
+  }
+
+  const auto missing = journal->MissingRanges(0, job.mSize);
+
+  if (missing.empty()) {
+    lru->FileAccessed(job.mFid, journal->CachedBytes());
+    return 0;
+  }
+
+  std::unique_ptr<FileIo> io(FileIoPlugin::GetIoObject(job.mUrl));
+
+  if (!io || io->fileOpen(SFS_O_RDONLY)) {
+    return EIO;
+  }
+
+  std::unique_ptr<char[]> buffer(new char[kChunkSize]);
+  uint64_t fetched = 0;
+  int rc = 0;
+
+  for (const auto& range : missing) {
+    size_t done = 0;
+
+    while (!rc && (done < range.size)) {
+      const size_t len = std::min(kChunkSize, range.size - done);
+      const off_t offset = range.offset + done;
+
+      if (!lru->CanAdmit(len)) {
+        rc = ENOSPC;
+        break;
+      }
+
+      const int64_t nread = io->fileRead(offset, buffer.get(), len);
+
+      if (nread <= 0) {
+        rc = EIO;
+        break;
+      }
+
+      if (journal->Write(buffer.get(), nread, offset)) {
+        rc = EIO;
+        break;
+      }
+
+      done += nread;
+      fetched += nread;
+    }
+
+    if (rc) {
+      break;
+    }
+  }
+
+  (void) io->fileClose();
+  lru->mPrefetchedBytes += fetched;
+
+  if (!rc) {
+    ++lru->mPrefetched;
+  }
+
+  lru->FileAccessed(job.mFid, journal->CachedBytes());
+  return rc;
+}
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+//! @file CacheWarmer.hh
+//! @brief Background filling of read-through cache journals (prefetching)
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "fst/Namespace.hh"
+#include "common/AssistedThread.hh"
+#include "common/FileSystem.hh"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Queue of prefetch requests sent by the MGM. Each job copies the ranges of
+//! a file missing from its cache journal from the backend filesystem, the
+//! same way a read through the CacheLayout would. Speculative data is only
+//! admitted below the high watermark, the warmer never evicts by itself.
+//------------------------------------------------------------------------------
+class CacheWarmer
+{
+public:
+  struct Job {
+    uint64_t mFid {0};
+    eos::common::FileSystem::fsid_t mCacheFsId {0};
+    std::string mCacheFsPath;
+    uint64_t mSize {0};
+    time_t mMTime {0};
+    //! Backend URL including the opaque info (capability) for the open
+    std::string mUrl;
+    std::string mLowWatermark;
+    std::string mHighWatermark;
+    //! Called by the worker once the journal is completely filled
+    std::function<void(const Job&)> mOnWarmed;
+  };
+
+  static CacheWarmer& Instance();
+
+  //----------------------------------------------------------------------------
+  //! Destructor - stops the workers, pending jobs are dropped
+  //----------------------------------------------------------------------------
+  ~CacheWarmer();
+
+  //----------------------------------------------------------------------------
+  //! Queue a job
+  //!
+  //! @return 0 if queued (or the file is already queued), EBUSY if the
+  //!         queue is full
+  //----------------------------------------------------------------------------
+  int Submit(Job&& job);
+
+  //----------------------------------------------------------------------------
+  //! Fill the journal of the job's file
+  //!
+  //! @return 0 if successful, ENOSPC if the cache is above its high
+  //!         watermark, otherwise an errno value
+  //----------------------------------------------------------------------------
+  static int Warm(const Job& job);
+
+  // Stats
+  std::atomic<uint64_t> mWarmed {0};
+  std::atomic<uint64_t> mFailed {0};
+  std::atomic<uint64_t> mRejected {0};
+
+private:
+  //! Maximum number of queued jobs
+  static constexpr size_t sMaxQueued = 1024;
+  //! Number of worker threads
+  static constexpr size_t sNumWorkers = 2;
+
+  CacheWarmer() = default;
+  void Worker(ThreadAssistant& assistant) noexcept;
+
+  std::mutex mMutex;
+  std::condition_variable mCv;
+  std::deque<Job> mQueue;
+  std::unordered_set<uint64_t> mQueuedFids;
+  std::vector<std::unique_ptr<AssistedThread>> mWorkers;
+};
+
+EOSFSTNAMESPACE_END
@@ -23,12 +23,14 @@
 
 #include "FmdAttr.hh"
 #include "FmdHandler.hh"
+#include "FmdIndex.hh"
 #include "fst/io/FileIoPluginCommon.hh"
 #include "fst/XrdFstOfs.hh"
 #include "fst/utils/FTSWalkTree.hh"
 #include "fst/utils/FSPathHandler.hh"
 #include "fst/utils/TransformAttr.hh"
 #include <functional>
+#include <vector>
 
 EOSFSTNAMESPACE_BEGIN
 
@@ -39,6 +41,149 @@ FmdAttrHandler::FmdAttrHandler(std::unique_ptr<FSPathHandler>&& _FSPathHandler)
   : mFSPathHandler(std::move(_FSPathHandler))
 {}
 
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+FmdAttrHandler::~FmdAttrHandler()
+{
+  std::unique_lock<std::mutex> lock(mIndexMutex);
+  mIndexes.clear();
+}
+
+//------------------------------------------------------------------------------
+// Attach the Fmd index of the given file system, rebuilding it from the
+// xattrs if it can not be trusted
+//------------------------------------------------------------------------------
+bool
+FmdAttrHandler::AttachIndex(eos::common::FileSystem::fsid_t fsid)
+{
+  const std::string mount = mFSPathHandler->GetFSPath(fsid);
+
+  // Only local file systems have an index
+  if (mount.empty() || (mount[0] != '/')) {
+    return true;
+  }
+
+  DetachIndex(fsid);
+  auto index = std::make_shared<FmdIndex>(mount);
+  bool rebuild = false;
+
+  if (!index->Open(rebuild)) {
+    eos_err("msg=\"failed to open fmd index\" fsid=%u mount=%s", fsid,
+            mount.c_str());
+    return false;
+  }
+
+  if (rebuild) {
+    eos_info("msg=\"rebuilding fmd index from xattrs\" fsid=%u", fsid);
+    std::error_code ec;
+    uint64_t count = 0;
+    bool put_ok = true;
+    WalkFSTree(mount, [&](const char* path) {
+      auto [status, fmd] = LocalRetrieveFmd(path);
+
+      if (status && fmd.mProtoFmd.fid()) {
+        if (index->Put(fmd)) {
+          ++count;
+        } else {
+          put_ok = false;
+        }
+      }
+    }, ec);
+
+    // An index missing some records would make full scans skip files
+    if (ec || !put_ok) {
+      eos_err("msg=\"failed to rebuild fmd index\" fsid=%u error=\"%s\"", fsid,
+              ec ? ec.message().c_str() : "failed to add record");
+      index->Close();
+      FmdIndex::Remove(mount);
+      return false;
+    }
+
+    eos_info("msg=\"rebuilt fmd index from xattrs\" fsid=%u entries=%llu",
+             fsid, (unsigned long long) count);
+  }
+
+  std::unique_lock<std::mutex> lock(mIndexMutex);
+  mIndexes[fsid] = std::move(index);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Detach and close the Fmd index of the given file system
+//------------------------------------------------------------------------------
+void
+FmdAttrHandler::DetachIndex(eos::common::FileSystem::fsid_t fsid)
+{
+  std::shared_ptr<FmdIndex> index;
+  {
+    std::unique_lock<std::mutex> lock(mIndexMutex);
+    auto it = mIndexes.find(fsid);
+
+    if (it == mIndexes.end()) {
+      return;
+    }
+
+    index = std::move(it->second);
+    mIndexes.erase(it);
+  }
+  // Closed once the last user releases it
+  index.reset();
+}
+
+//------------------------------------------------------------------------------
+// Update the index entry of the given record, an index which failed to
+// record it is dropped so that it is rebuilt from the xattrs on next attach
+//------------------------------------------------------------------------------
+bool
+FmdAttrHandler::UpdateIndex(const std::shared_ptr<FmdIndex>& index,
+                            const eos::common::FmdHelper& fmd)
+{
+  if (index->Put(fmd)) {
+    return true;
+  }
+
+  const auto fsid = fmd.mProtoFmd.fsid();
+  eos_err("msg=\"failed to update fmd index, dropping it\" fsid=%u "
+          "fxid=%08llx", fsid, fmd.mProtoFmd.fid());
+  {
+    std::unique_lock<std::mutex> lock(mIndexMutex);
+    auto it = mIndexes.find(fsid);
+
+    // Leave alone an index attached again in the meantime
+    if ((it == mIndexes.end()) || (it->second != index)) {
+      return false;
+    }
+
+    mIndexes.erase(it);
+  }
+  FmdIndex::Remove(mFSPathHandler->GetFSPath(fsid));
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Get the index of the given file system
+//------------------------------------------------------------------------------
+std::shared_ptr<FmdIndex>
+FmdAttrHandler::GetIndex(eos::common::FileSystem::fsid_t fsid)
+{
+  std::unique_lock<std::mutex> lock(mIndexMutex);
+  auto it = mIndexes.find(fsid);
+  return (it == mIndexes.end()) ? nullptr : it->second;
+}
+
+//------------------------------------------------------------------------------
+// Drop the index entry of a file moved away
+//------------------------------------------------------------------------------
+void
+FmdAttrHandler::DropIndexEntry(eos::common::FileId::fileid_t fid,
+                               eos::common::FileSystem::fsid_t fsid)
+{
+  if (auto index = GetIndex(fsid)) {
+    (void) index->Delete(fid);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Low level Fmd retrieve method
 //------------------------------------------------------------------------------
@@ -47,11 +192,35 @@ FmdAttrHandler::LocalRetrieveFmd(eos::common::FileId::fileid_t fid,
                                  eos::common::FileSystem::fsid_t fsid,
                                  const std::string& path)
 {
-  if (path.empty()) {
-    return LocalRetrieveFmd(mFSPathHandler->GetPath(fid, fsid));
-  } else {
+  if (!path.empty()) {
     return LocalRetrieveFmd(path);
   }
+
+  auto index = GetIndex(fsid);
+
+  if (index) {
+    eos::common::FmdHelper fmd;
+
+    if (index->Get(fid, fmd)) {
+      return {true, std::move(fmd)};
+    }
+  }
+
+  if (!index) {
+    return LocalRetrieveFmd(mFSPathHandler->GetPath(fid, fsid));
+  }
+
+  // Record missed by the index e.g. xattr set by an external tool, a
+  // concurrent update must not be overwritten by the xattr read before it
+  std::unique_lock<std::mutex> lock(GetFidMutex(fid));
+  auto result = LocalRetrieveFmd(mFSPathHandler->GetPath(fid, fsid));
+
+  if (result.first && (result.second.mProtoFmd.fid() == fid) &&
+      (result.second.mProtoFmd.fsid() == fsid)) {
+    (void) UpdateIndex(index, result.second);
+  }
+
+  return result;
 }
 
 //------------------------------------------------------------------------------
@@ -113,14 +282,22 @@ FmdAttrHandler::LocalPutFmd(const eos::common::FmdHelper& fmd,
 
   std::string attrval;
   fmd.mProtoFmd.SerializePartialToString(&attrval);
+  // The index must end up with the same record as the xattr
+  std::unique_lock<std::mutex> lock(GetFidMutex(fmd.mProtoFmd.fid()));
   int rc = io->attrSet(gFmdAttrName, attrval.c_str(), attrval.length());
 
   if (rc != 0) {
     eos_err("msg=\"failed to set xattr\" path=\"%s\" errno=%d",
             path.c_str(), errno);
+    return false;
+  }
+
+  // The index must not keep serving the previous record
+  if (auto index = GetIndex(fmd.mProtoFmd.fsid())) {
+    (void) UpdateIndex(index, fmd);
   }
 
-  return rc == 0;
+  return true;
 }
 
 //------------------------------------------------------------------------------
@@ -131,6 +308,8 @@ FmdAttrHandler::LocalDeleteFmd(eos::common::FileId::fileid_t fid,
                                eos::common::FileSystem::fsid_t fsid,
                                bool drop_file)
 {
+  std::unique_lock<std::mutex> lock(GetFidMutex(fid));
+  DropIndexEntry(fid, fsid);
   return LocalDeleteFmd(mFSPathHandler->GetPath(fid, fsid), drop_file);
 }
 
@@ -277,38 +456,102 @@ FmdAttrHandler::LocalGetFmd(eos::common::FileId::fileid_t fid,
   return nullptr;
 }
 
+//------------------------------------------------------------------------------
+// Reset the disk information of all the Fmd records of a file system
+//------------------------------------------------------------------------------
 bool
 FmdAttrHandler::ResetDiskInformation(eos::common::FileSystem::fsid_t fsid)
 {
-  std::error_code ec;
-  WalkFSTree(mFSPathHandler->GetFSPath(fsid),
-  [](std::string path) {
-    TransformAttr(path, gFmdAttrName,
-                  &FmdHandler::ResetFmdDiskInfo);
-  }, ec);
-
-  if (ec) {
-    eos_err("msg=\"Failed to walk FST Tree\" error=%s", ec.message().c_str());
-  }
-
-  return !ec;
+  return ResetInformation(fsid, &FmdHandler::ResetFmdDiskInfo);
 }
 
+//------------------------------------------------------------------------------
+// Reset the mgm information of all the Fmd records of a file system
+//------------------------------------------------------------------------------
 bool
 FmdAttrHandler::ResetMgmInformation(eos::common::FileSystem::fsid_t fsid)
 {
-  std::error_code ec;
-  WalkFSTree(mFSPathHandler->GetFSPath(fsid),
-  [](std::string path) {
-    TransformAttr(path, gFmdAttrName,
-                  &FmdHandler::ResetFmdMgmInfo);
-  }, ec);
-
-  if (ec) {
-    eos_err("msg=\"Failed to walk FST Tree\" error=%s", ec.message().c_str());
+  return ResetInformation(fsid, &FmdHandler::ResetFmdMgmInfo);
+}
+
+//------------------------------------------------------------------------------
+// Apply the given transformation to all the Fmd records of a file system
+//------------------------------------------------------------------------------
+bool
+FmdAttrHandler::ResetInformation(eos::common::FileSystem::fsid_t fsid,
+                                 std::string(*reset_fn)(const std::string&))
+{
+  auto index = GetIndex(fsid);
+
+  if (!index) {
+    std::error_code ec;
+    WalkFSTree(mFSPathHandler->GetFSPath(fsid),
+    [reset_fn](std::string path) {
+      TransformAttr(path, gFmdAttrName, reset_fn);
+    }, ec);
+
+    if (ec) {
+      eos_err("msg=\"Failed to walk FST Tree\" error=%s", ec.message().c_str());
+    }
+
+    return !ec;
+  }
+
+  // The index only lists the files instead of walking the whole tree, the
+  // xattrs are transformed in place and the index updated from the result.
+  // The index holds every file with an Fmd xattr, it is dropped otherwise.
+  // Entries of files which are gone are dropped.
+  std::vector<eos::common::FileId::fileid_t> fids;
+  std::vector<eos::common::FileId::fileid_t> gone;
+  bool index_ok = true;
+  index->ForEach([&](const eos::common::FmdHelper & fmd) {
+    fids.push_back(fmd.mProtoFmd.fid());
+  });
+
+  for (const auto fid : fids) {
+    const std::string path = mFSPathHandler->GetPath(fid, fsid);
+    struct stat info;
+
+    if (stat(path.c_str(), &info) && (errno == ENOENT)) {
+      gone.push_back(fid);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(GetFidMutex(fid));
+
+    if (!TransformAttr(path, gFmdAttrName, reset_fn) || !index_ok) {
+      continue;
+    }
+
+    auto [status, fmd] = LocalRetrieveFmd(path);
+
+    if (status && (fmd.mProtoFmd.fid() == fid) &&
+        (fmd.mProtoFmd.fsid() == fsid)) {
+      index_ok = UpdateIndex(index, fmd);
+    }
+  }
+
+  if (!index_ok) {
+    return true;
+  }
+
+  for (const auto fid : gone) {
+    std::unique_lock<std::mutex> lock(GetFidMutex(fid));
+    struct stat info;
+
+    // Unless the file was created again meanwhile
+    if (stat(mFSPathHandler->GetPath(fid, fsid).c_str(), &info) &&
+        (errno == ENOENT)) {
+      (void) index->Delete(fid);
+    }
+  }
+
+  if (!gone.empty()) {
+    eos_info("msg=\"dropped fmd index entries of missing files\" fsid=%u "
+             "count=%llu", fsid, (unsigned long long) gone.size());
   }
 
-  return !ec;
+  return true;
 }
 
 EOSFSTNAMESPACE_END
@@ -24,6 +24,9 @@
 #pragma once
 #include "fst/Namespace.hh"
 #include "fst/filemd/FmdHandler.hh"
+#include <array>
+#include <map>
+#include <mutex>
 
 EOSFSTNAMESPACE_BEGIN
 
@@ -32,6 +35,7 @@ static constexpr auto gFmdAttrName = "user.eos.fmd";
 //! Forward declarations
 class FSPathHandler;
 class FileIo;
+class FmdIndex;
 
 //------------------------------------------------------------------------------
 //! Class FmdAttrHandler
@@ -45,9 +49,13 @@ public:
   FmdAttrHandler(std::unique_ptr<FSPathHandler>&& _FSPathHandler);
 
   //----------------------------------------------------------------------------
-  //! Destructor
+  //! Destructor - closes all the attached indexes
   //----------------------------------------------------------------------------
-  ~FmdAttrHandler() = default;
+  ~FmdAttrHandler();
+
+  bool AttachIndex(eos::common::FileSystem::fsid_t fsid) override;
+
+  void DetachIndex(eos::common::FileSystem::fsid_t fsid) override;
 
   void LocalDeleteFmd(eos::common::FileId::fileid_t fid,
                       eos::common::FileSystem::fsid_t fsid,
@@ -75,6 +83,50 @@ public:
 
 private:
   std::unique_ptr<FSPathHandler> mFSPathHandler;
+  //! Fmd index of every local file system, the xattrs stay the reference
+  //! copy and the index serves the lookups by file id and full scans
+  std::map<eos::common::FileSystem::fsid_t, std::shared_ptr<FmdIndex>> mIndexes;
+  std::mutex mIndexMutex;
+  //! Mutexes striped by file id keeping the xattr and the index entry of a
+  //! file in the same order when they are updated concurrently
+  std::array<std::mutex, 64> mFidMutexes;
+
+  //----------------------------------------------------------------------------
+  //! Get the mutex serializing the Fmd updates of the given file
+  //----------------------------------------------------------------------------
+  std::mutex& GetFidMutex(eos::common::FileId::fileid_t fid)
+  {
+    return mFidMutexes[fid % mFidMutexes.size()];
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the index of the given file system or null if not attached
+  //----------------------------------------------------------------------------
+  std::shared_ptr<FmdIndex> GetIndex(eos::common::FileSystem::fsid_t fsid);
+
+  //----------------------------------------------------------------------------
+  //! Update the index entry of the given Fmd record. If this fails the index
+  //! is detached and removed so that it never serves a stale record, it is
+  //! rebuilt from the xattrs on the next attach.
+  //!
+  //! @param index index of the record's file system
+  //! @param fmd Fmd record
+  //!
+  //! @return true if the index was updated, otherwise false
+  //----------------------------------------------------------------------------
+  bool UpdateIndex(const std::shared_ptr<FmdIndex>& index,
+                   const eos::common::FmdHelper& fmd);
+
+  //----------------------------------------------------------------------------
+  //! Apply the given transformation to all the Fmd records of a file system
+  //!
+  //! @param fsid file system identifier
+  //! @param reset_fn function transforming the serialized Fmd
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool ResetInformation(eos::common::FileSystem::fsid_t fsid,
+                        std::string(*reset_fn)(const std::string&));
 
   //----------------------------------------------------------------------------
   //! Attach Fmd metadata info to the current file identifier
@@ -98,6 +150,9 @@ private:
   bool ResetMgmInformation(eos::common::FileSystem::fsid_t fsid) override;
 
   void SetSyncStatus(eos::common::FileSystem::fsid_t, bool) override {}
+
+  void DropIndexEntry(eos::common::FileId::fileid_t fid,
+                      eos::common::FileSystem::fsid_t fsid) override;
 };
 
 
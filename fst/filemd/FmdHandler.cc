@@ -30,6 +30,8 @@
 #include "namespace/ns_quarkdb/QdbContactDetails.hh"
 #include "qclient/structures/QSet.hh"
 #include "fst/utils/FTSWalkTree.hh"
+#include "fst/utils/IoPriority.hh"
+#include "fst/utils/PipelineStage.hh"
 #include "fst/checksum/ChecksumPlugins.hh"
 #include "fst/XrdFstOfs.hh"
 #include "fst/io/local/LocalIo.hh"
@@ -39,6 +41,50 @@
 #include "fst/filemd/FmdHandler.hh"
 EOSFSTNAMESPACE_BEGIN
 
+namespace
+{
+//! Minimum interval between two progress reports of a resync
+constexpr std::chrono::seconds sResyncProgressInterval {5};
+
+//------------------------------------------------------------------------------
+// Build the per thread init function of the resync workers which applies the
+// configured IO priority
+//------------------------------------------------------------------------------
+std::function<void()>
+GetResyncWorkerInit(const FmdResyncOptions& opts)
+{
+  if (opts.mIoPriority == 0) {
+    return nullptr;
+  }
+
+  const int prio = opts.mIoPriority;
+  return [prio]() {
+    if (ioprio_set(IOPRIO_WHO_PROCESS, prio)) {
+      eos_static_err("msg=\"failed to set resync worker io priority\" "
+                     "prio=%i errno=%i", prio, errno);
+    }
+  };
+}
+
+//------------------------------------------------------------------------------
+// Report the resync progress if enough time passed since the last report
+//------------------------------------------------------------------------------
+void
+ReportResyncProgress(const FmdResyncOptions& opts, const std::string& phase,
+                     uint64_t done, uint64_t total,
+                     std::chrono::steady_clock::time_point& last_report,
+                     bool force = false)
+{
+  auto now = std::chrono::steady_clock::now();
+
+  if (opts.mProgress &&
+      (force || (now - last_report >= sResyncProgressInterval))) {
+    last_report = now;
+    opts.mProgress(phase, done, total);
+  }
+}
+}
+
 
 //------------------------------------------------------------------------------
 // Check if entry has a file checksum error
@@ -83,8 +129,18 @@ FmdHandler::UpdateFmd(const std::string& path,
     return false;
   }
 
+  const eos::common::FileId::fileid_t old_fid = fmd.mProtoFmd.fid();
   fmd.mProtoFmd.set_fid(fid);
-  return LocalPutFmd(fmd, 0ull, 0ul, path);
+
+  if (!LocalPutFmd(fmd, 0ull, 0ul, path)) {
+    return false;
+  }
+
+  if (old_fid && (old_fid != fid)) {
+    DropIndexEntry(old_fid, fmd.mProtoFmd.fsid());
+  }
+
+  return true;
 }
 
 
@@ -389,8 +445,11 @@ FmdHandler::ResyncDisk(const char* path,
 bool
 FmdHandler::ResyncAllDisk(const char* path,
                           eos::common::FileSystem::fsid_t fsid,
-                          bool flaglayouterror)
+                          bool flaglayouterror,
+                          const FmdResyncOptions& opts)
 {
+  using namespace std::chrono;
+
   if (flaglayouterror) {
     SetSyncStatus(fsid, true);
   }
@@ -401,13 +460,28 @@ FmdHandler::ResyncAllDisk(const char* path,
     return false;
   }
 
-  uint64_t scan_sz = 0;
-  std::string scan_xs_hex;
+  // The tree walk runs in the current thread and feeds the workers which
+  // read the extended attributes and update the local metadata
+  auto start = steady_clock::now();
+  auto last_report = start;
   std::error_code ec;
+  uint64_t num_files = 0ull;
+  utils::PipelineStage<std::string> stage(opts.mNumWorkers, opts.mMaxInFlight,
+  [&](std::string & fpath) {
+    (void) this->ResyncDisk(fpath.c_str(), fsid, flaglayouterror);
+  }, GetResyncWorkerInit(opts));
   WalkFSTree(path,
-  [&](const char* path) {
-    this->ResyncDisk(path, fsid, flaglayouterror, scan_sz, scan_xs_hex);
+  [&](const char* fpath) {
+    stage.Push(std::string(fpath));
+    ++num_files;
+    ReportResyncProgress(opts, "disk", stage.GetProcessed(), 0ull, last_report);
   }, ec);
+  stage.Finish();
+  ReportResyncProgress(opts, "disk", stage.GetProcessed(), num_files,
+                       last_report, true);
+  auto ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+  eos_info("msg=\"fsid=%u resynced %llu files from disk in %lld ms\" "
+           "workers=%u", fsid, num_files, ms, opts.mNumWorkers);
 
   if (ec) {
     eos_err("msg=\"Walk FST tree failed\" error=%s", ec.message().c_str());
@@ -518,7 +592,7 @@ FmdHandler::ResyncMgm(eos::common::FileSystem::fsid_t fsid,
 // Move given file to orphans directory and also set its extended attribute
 // to reflect the original path to the file.
 //------------------------------------------------------------------------------
-void
+bool
 FmdHandler::MoveToOrphans(const std::string& fpath)
 {
   eos::common::Path cpath(fpath.c_str());
@@ -527,7 +601,7 @@ FmdHandler::MoveToOrphans(const std::string& fpath)
   if (cpath_sz <= 2) {
     eos_static_err("msg=\"failed to extract FST mount/fid hex\" path=%s",
                    fpath.c_str());
-    return;
+    return false;
   }
 
   std::string fid_hex = cpath.GetName();
@@ -542,10 +616,12 @@ FmdHandler::MoveToOrphans(const std::string& fpath)
   if (!rename(fpath.c_str(), forphan.c_str())) {
     eos_static_warning("msg=\"orphaned/unregistered quarantined\" "
                        "fst-path=%s orphan-path=%s", fpath.c_str(), forphan.c_str());
-  } else {
-    eos_static_err("msg=\"failed to quarantine orphaned/unregistered\" "
-                   "fst-path=%s orphan-path=%s", fpath.c_str(), forphan.c_str());
+    return true;
   }
+
+  eos_static_err("msg=\"failed to quarantine orphaned/unregistered\" "
+                 "fst-path=%s orphan-path=%s", fpath.c_str(), forphan.c_str());
+  return false;
 }
 
 //------------------------------------------------------------------------------
@@ -609,7 +685,10 @@ FmdHandler::ResyncFileFromQdb(eos::common::FileId::fileid_t fid,
               fid, fsid);
     }
 
-    FmdHandler::MoveToOrphans(fpath);
+    if (FmdHandler::MoveToOrphans(fpath)) {
+      DropIndexEntry(fid, fsid);
+    }
+
     gOFS.Storage->PublishFsckError(fid, fsid, eos::common::FsckErr::Orphans);
     return ENOENT;
   }
@@ -648,7 +727,8 @@ FmdHandler::ResyncFileFromQdb(eos::common::FileId::fileid_t fid,
 //------------------------------------------------------------------------------
 bool
 FmdHandler::ResyncAllFromQdb(const QdbContactDetails& contact_details,
-                             eos::common::FileSystem::fsid_t fsid)
+                             eos::common::FileSystem::fsid_t fsid,
+                             const FmdResyncOptions& opts)
 {
   using namespace std::chrono;
 
@@ -660,6 +740,7 @@ FmdHandler::ResyncAllFromQdb(const QdbContactDetails& contact_details,
 
   // Collect all file ids on the desired file system
   auto start = steady_clock::now();
+  auto last_report = start;
   qclient::QClient qcl(contact_details.members,
                        contact_details.constructOptions());
   std::unordered_set<eos::IFileMD::id_t> file_ids;
@@ -681,85 +762,45 @@ FmdHandler::ResyncAllFromQdb(const QdbContactDetails& contact_details,
 
   uint64_t total = file_ids.size();
   eos_info("msg=\"resyncing %llu files for file_system %u\"", total, fsid);
-  uint64_t num_files = 0;
+  ReportResyncProgress(opts, "qdb", 0ull, total, last_report, true);
+  // The QuarkDB requests are issued from the current thread while the
+  // workers merge the results into the local metadata
+  using FidFmdPair = std::pair<eos::common::FileId::fileid_t,
+        eos::common::FmdHelper>;
+  utils::PipelineStage<FidFmdPair> stage(opts.mNumWorkers, opts.mMaxInFlight,
+  [&](FidFmdPair & entry) {
+    this->UpdateFromQdbFmd(entry.first, fsid, entry.second);
+  }, GetResyncWorkerInit(opts));
+  const size_t max_in_flight = std::max(opts.mMaxInFlight, 1u);
   auto it = file_ids.begin();
   std::list<std::pair<eos::common::FileId::fileid_t,
       folly::Future<eos::ns::FileMdProto>>> files;
 
-  // Pre-fetch the first 1000 files
-  while ((it != file_ids.end()) && (num_files < 1000)) {
-    ++num_files;
-    files.emplace_back(*it, MetadataFetcher::getFileFromId(qcl,
-                       FileIdentifier(*it)));
-    ++it;
-  }
+  while ((it != file_ids.end()) || !files.empty()) {
+    // Keep the window of in-flight requests full
+    while ((it != file_ids.end()) && (files.size() < max_in_flight)) {
+      files.emplace_back(*it, MetadataFetcher::getFileFromId(qcl,
+                         FileIdentifier(*it)));
+      ++it;
+    }
 
-  while (!files.empty()) {
-    eos::common::FmdHelper ns_fmd;
-    eos::common::FileId::fileid_t fid = files.front().first;
+    FidFmdPair entry(files.front().first, eos::common::FmdHelper());
 
     try {
-      FmdMgmHandler::NsFileProtoToFmd(std::move(files.front().second).get(), ns_fmd);
+      FmdMgmHandler::NsFileProtoToFmd(std::move(files.front().second).get(),
+                                      entry.second);
     } catch (const eos::MDException& e) {
       eos_err("msg=\"failed to get metadata from QDB: %s\"", e.what());
     }
 
     files.pop_front();
-    // Mark any possible layout error, if fid not found in QDB then this is
-    // marked as orphan
-    ns_fmd.mProtoFmd.set_layouterror(ns_fmd.LayoutError(fsid));
-    // Get an existing local record without creating the record!!!
-    std::unique_ptr<eos::common::FmdHelper> local_fmd {
-      LocalGetFmd(fid, fsid, true, false)};
-
-    if (!local_fmd) {
-      // Create the local record
-      if (!(local_fmd = LocalGetFmd(fid, fsid, true, true))) {
-        eos_err("msg=\"failed to create local fmd entry\" fxid=%08llx", fid);
-        continue;
-      }
-    }
-
-    // If file does not exist on disk and is not 0-size then mark as missing
-    if ((local_fmd->mProtoFmd.disksize() == eos::common::FmdHelper::UNDEF) &&
-        (ns_fmd.mProtoFmd.mgmsize())) {
-      ns_fmd.mProtoFmd.set_layouterror(ns_fmd.mProtoFmd.layouterror() |
-                                       LayoutId::kMissing);
-      eos_warning("msg=\"mark missing replica\" fxid=%08llx fsid=%u", fid, fsid);
-    }
-
-    if (!UpdateWithMgmInfo(fsid, fid, ns_fmd.mProtoFmd.cid(),
-                           ns_fmd.mProtoFmd.lid(), ns_fmd.mProtoFmd.mgmsize(),
-                           ns_fmd.mProtoFmd.mgmchecksum(), ns_fmd.mProtoFmd.uid(),
-                           ns_fmd.mProtoFmd.gid(), ns_fmd.mProtoFmd.ctime(),
-                           ns_fmd.mProtoFmd.ctime_ns(), ns_fmd.mProtoFmd.mtime(),
-                           ns_fmd.mProtoFmd.mtime_ns(), ns_fmd.mProtoFmd.layouterror(),
-                           ns_fmd.mProtoFmd.locations())) {
-      eos_err("msg=\"failed to update fmd with qdb info\" fxid=%08llx", fid);
-      continue;
-    }
-
-    if (it != file_ids.end()) {
-      files.emplace_back(*it, MetadataFetcher::getFileFromId(qcl,
-                         FileIdentifier(*it)));
-      ++num_files;
-      ++it;
-    }
-
-    if (num_files % 10000 == 0) {
-      double rate = 0;
-      auto duration = steady_clock::now() - start;
-      auto ms = duration_cast<milliseconds>(duration);
-
-      if (ms.count()) {
-        rate = (num_files * 1000.0) / (double)ms.count();
-      }
-
-      eos_info("fsid=%u resynced %llu/%llu files at a rate of %.2f Hz",
-               fsid, num_files, total, rate);
-    }
+    stage.Push(std::move(entry));
+    ReportResyncProgress(opts, "qdb", stage.GetProcessed(), total, last_report);
   }
 
+  stage.Finish();
+  const uint64_t num_files = stage.GetProcessed();
+  ReportResyncProgress(opts, "qdb", num_files, total, last_report, true);
   double rate = 0;
   auto duration = steady_clock::now() - start;
   auto ms = duration_cast<milliseconds>(duration);
@@ -769,8 +810,53 @@ FmdHandler::ResyncAllFromQdb(const QdbContactDetails& contact_details,
   }
 
   SetSyncStatus(fsid, false);
-  eos_info("msg=\"fsid=%u resynced %llu/%llu files at a rate of %.2f Hz\"",
-           fsid, num_files, total, rate);
+  eos_info("msg=\"fsid=%u resynced %llu/%llu files at a rate of %.2f Hz\" "
+           "workers=%u", fsid, num_files, total, rate, opts.mNumWorkers);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Update the local metadata of a file with the info retrieved from QuarkDB
+//------------------------------------------------------------------------------
+bool
+FmdHandler::UpdateFromQdbFmd(eos::common::FileId::fileid_t fid,
+                             eos::common::FileSystem::fsid_t fsid,
+                             eos::common::FmdHelper& ns_fmd)
+{
+  // Mark any possible layout error, if fid not found in QDB then this is
+  // marked as orphan
+  ns_fmd.mProtoFmd.set_layouterror(ns_fmd.LayoutError(fsid));
+  // Get an existing local record without creating the record!!!
+  std::unique_ptr<eos::common::FmdHelper> local_fmd {
+    LocalGetFmd(fid, fsid, true, false)};
+
+  if (!local_fmd) {
+    // Create the local record
+    if (!(local_fmd = LocalGetFmd(fid, fsid, true, true))) {
+      eos_err("msg=\"failed to create local fmd entry\" fxid=%08llx", fid);
+      return false;
+    }
+  }
+
+  // If file does not exist on disk and is not 0-size then mark as missing
+  if ((local_fmd->mProtoFmd.disksize() == eos::common::FmdHelper::UNDEF) &&
+      (ns_fmd.mProtoFmd.mgmsize())) {
+    ns_fmd.mProtoFmd.set_layouterror(ns_fmd.mProtoFmd.layouterror() |
+                                     LayoutId::kMissing);
+    eos_warning("msg=\"mark missing replica\" fxid=%08llx fsid=%u", fid, fsid);
+  }
+
+  if (!UpdateWithMgmInfo(fsid, fid, ns_fmd.mProtoFmd.cid(),
+                         ns_fmd.mProtoFmd.lid(), ns_fmd.mProtoFmd.mgmsize(),
+                         ns_fmd.mProtoFmd.mgmchecksum(), ns_fmd.mProtoFmd.uid(),
+                         ns_fmd.mProtoFmd.gid(), ns_fmd.mProtoFmd.ctime(),
+                         ns_fmd.mProtoFmd.ctime_ns(), ns_fmd.mProtoFmd.mtime(),
+                         ns_fmd.mProtoFmd.mtime_ns(), ns_fmd.mProtoFmd.layouterror(),
+                         ns_fmd.mProtoFmd.locations())) {
+    eos_err("msg=\"failed to update fmd with qdb info\" fxid=%08llx", fid);
+    return false;
+  }
+
   return true;
 }
 
@@ -26,6 +26,7 @@
 #include "common/Fmd.hh"
 #include "common/FileId.hh"
 #include "common/LayoutId.hh"
+#include <functional>
 #include <set>
 
 //! Forward declaration
@@ -41,6 +42,22 @@ class QClient;
 
 EOSFSTNAMESPACE_BEGIN
 
+//------------------------------------------------------------------------------
+//! Options of the full resync of a file system
+//------------------------------------------------------------------------------
+struct FmdResyncOptions {
+  //! Number of threads updating the local metadata, the updates are applied
+  //! one at a time unless more threads are configured
+  uint32_t mNumWorkers {1};
+  //! Maximum number of queued entries and of in-flight QuarkDB requests
+  uint32_t mMaxInFlight {1000};
+  //! IO priority value of the worker threads, 0 keeps the default
+  int mIoPriority {0};
+  //! Called periodically with the phase, the number of processed entries
+  //! and the total number of entries if known, otherwise 0
+  std::function<void(const std::string&, uint64_t, uint64_t)> mProgress;
+};
+
 class FmdHandler: public eos::common::LogId
 {
 public:
@@ -69,8 +86,10 @@ public:
   //! to reflect the original path to the file.
   //!
   //! @param fpath file to move
+  //!
+  //! @return true if the file was moved, otherwise false
   //----------------------------------------------------------------------------
-  static void MoveToOrphans(const std::string& fpath);
+  static bool MoveToOrphans(const std::string& fpath);
 
   //----------------------------------------------------------------------------
   //! Constructor
@@ -93,6 +112,27 @@ public:
   virtual bool FileHasXsError(const std::string& lpath,
                               eos::common::FileSystem::fsid_t fsid);
 
+  //----------------------------------------------------------------------------
+  //! Attach the metadata index of the given file system, if the handler keeps
+  //! one, building it if needed. Must be called before the file system is
+  //! used.
+  //!
+  //! @param fsid file system identifier
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  virtual bool AttachIndex(eos::common::FileSystem::fsid_t fsid)
+  {
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Detach and close the metadata index of the given file system
+  //!
+  //! @param fsid file system identifier
+  //----------------------------------------------------------------------------
+  virtual void DetachIndex(eos::common::FileSystem::fsid_t fsid) {}
+
   // Meta data handling functions
 
   //----------------------------------------------------------------------------
@@ -276,12 +316,16 @@ public:
   //! @param path path to scan
   //! @param fsid file system id
   //! @param flaglayouterror flag to indicate a layout error
+  //! @param opts resync options, the tree walk runs in the calling thread
+  //!        while the extended attributes are read and the local metadata
+  //!        updated by the worker threads
   //!
   //! @return true if successful, otherwise false
   //----------------------------------------------------------------------------
   bool ResyncAllDisk(const char* path,
                      eos::common::FileSystem::fsid_t fsid,
-                     bool flaglayouterror);
+                     bool flaglayouterror,
+                     const FmdResyncOptions& opts = FmdResyncOptions());
 
   //----------------------------------------------------------------------------
   //! Resync file meta data from MGM into local database
@@ -316,13 +360,31 @@ public:
   //!
   //! @param contact_details QDB contact details
   //! @param fsid filesystem id
+  //! @param opts resync options, the QuarkDB requests are issued from the
+  //!        calling thread while the local metadata is updated by the worker
+  //!        threads
   //!
   //! @return true if successful, otherwise false
   //----------------------------------------------------------------------------
   bool ResyncAllFromQdb(const QdbContactDetails& contact_details,
-                        eos::common::FileSystem::fsid_t fsid);
+                        eos::common::FileSystem::fsid_t fsid,
+                        const FmdResyncOptions& opts = FmdResyncOptions());
 
 private:
+  //----------------------------------------------------------------------------
+  //! Update the local metadata of a file with the info retrieved from QuarkDB,
+  //! creating the local record if needed
+  //!
+  //! @param fid file identifier
+  //! @param fsid file system identifier
+  //! @param ns_fmd metadata converted from the namespace entry
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool UpdateFromQdbFmd(eos::common::FileId::fileid_t fid,
+                        eos::common::FileSystem::fsid_t fsid,
+                        eos::common::FmdHelper& ns_fmd);
+
   //----------------------------------------------------------------------------
   // Virtual private methods are overrideable in derived classes, this allows
   // for the interface to remain the same while the specific implementation is
@@ -354,6 +416,16 @@ private:
   //----------------------------------------------------------------------------
   virtual bool ResetMgmInformation(eos::common::FileSystem::fsid_t fsid) = 0;
 
+  //----------------------------------------------------------------------------
+  //! Drop the index entry of a file whose local replica was moved away
+  //! without going through LocalDeleteFmd e.g. renamed or quarantined
+  //!
+  //! @param fid file identifier
+  //! @param fsid file system identifier
+  //----------------------------------------------------------------------------
+  virtual void DropIndexEntry(eos::common::FileId::fileid_t fid,
+                              eos::common::FileSystem::fsid_t fsid) {}
+
   // TODO: Technically we could hold move the mIsSyncing map & mutex to this class. Do
   // this if AttrHandler also needs a syncing lock vs noop
   virtual void SetSyncStatus(eos::common::FileSystem::fsid_t fsid,
@@ -0,0 +1,988 @@
+//------------------------------------------------------------------------------
+//! @file FmdIndex.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/filemd/FmdIndex.hh"
+#include "common/crc32c/crc32c.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace
+{
+constexpr uint32_t kRecordMagic = 0x52444d46; // "FMDR"
+constexpr uint32_t kTableMagic = 0x49444d46; // "FMDI"
+constexpr uint32_t kTableVersion = 1;
+constexpr uint32_t kOpPut = 0;
+constexpr uint32_t kOpDelete = 1;
+constexpr uint64_t kMinCapacity = 1ull << 16;
+constexpr uint64_t kTombstone = ~0ull;
+//! The record length is stored in the low bits of the slot location
+constexpr uint64_t kLenBits = 24;
+constexpr uint64_t kMaxRecordLen = (1ull << kLenBits) - 1;
+constexpr size_t kReadChunk = 4 * 1024 * 1024;
+
+//------------------------------------------------------------------------------
+//! Header of every log record, followed by the serialized FmdBase for puts
+//------------------------------------------------------------------------------
+struct RecordHeader {
+  uint32_t mMagic;
+  uint32_t mLen; ///< Payload length
+  uint64_t mFid;
+  uint32_t mCrc; ///< CRC32C of fid, op, length and payload
+  uint32_t mOp;
+};
+
+static_assert(sizeof(RecordHeader) == 24, "unexpected record header size");
+
+//------------------------------------------------------------------------------
+//! Compute the checksum of a record
+//------------------------------------------------------------------------------
+uint32_t
+RecordCrc(const RecordHeader& hdr, const char* payload)
+{
+  uint32_t crc = checksum::crc32cInit();
+  crc = checksum::crc32c(crc, &hdr.mFid, sizeof(hdr.mFid));
+  crc = checksum::crc32c(crc, &hdr.mOp, sizeof(hdr.mOp));
+  crc = checksum::crc32c(crc, &hdr.mLen, sizeof(hdr.mLen));
+  crc = checksum::crc32c(crc, payload, hdr.mLen);
+  return checksum::crc32cFinish(crc);
+}
+
+//------------------------------------------------------------------------------
+//! Read the boot id of the machine
+//------------------------------------------------------------------------------
+std::string
+GetBootId()
+{
+  std::string boot_id;
+  std::ifstream file("/proc/sys/kernel/random/boot_id");
+
+  if (file.good()) {
+    std::getline(file, boot_id);
+  }
+
+  return boot_id;
+}
+
+//------------------------------------------------------------------------------
+//! Positional write of the whole buffer
+//------------------------------------------------------------------------------
+bool
+PwriteAll(int fd, const char* buff, size_t len, off_t offset)
+{
+  while (len) {
+    ssize_t nwrite = pwrite(fd, buff, len, offset);
+
+    if (nwrite < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return false;
+    }
+
+    buff += nwrite;
+    len -= nwrite;
+    offset += nwrite;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//! Positional read of the whole buffer
+//------------------------------------------------------------------------------
+bool
+PreadAll(int fd, char* buff, size_t len, off_t offset)
+{
+  while (len) {
+    ssize_t nread = pread(fd, buff, len, offset);
+
+    if (nread < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return false;
+    }
+
+    if (nread == 0) {
+      return false;
+    }
+
+    buff += nread;
+    len -= nread;
+    offset += nread;
+  }
+
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+//! Table header, padded to one page so that the slots stay page aligned
+//------------------------------------------------------------------------------
+struct FmdIndex::TableHeader {
+  uint32_t mMagic;
+  uint32_t mVersion;
+  uint32_t mClean; ///< 1 if closed cleanly
+  uint32_t mPad;
+  uint64_t mCapacity; ///< Number of slots, power of two
+  uint64_t mCount; ///< Live entries
+  uint64_t mUsed; ///< Live entries and tombstones
+  uint64_t mLogSize; ///< Log size when closed cleanly
+  uint64_t mLiveBytes; ///< Log bytes held by live records
+  char mBootId[64];
+  char mReserved[4096 - 120];
+};
+
+//------------------------------------------------------------------------------
+//! Table slot, fid 0 means empty
+//------------------------------------------------------------------------------
+struct FmdIndex::Slot {
+  uint64_t mFid;
+  uint64_t mLoc; ///< Log offset << kLenBits | record length
+};
+
+//------------------------------------------------------------------------------
+// Remove the index files of the given mountpoint
+//------------------------------------------------------------------------------
+void
+FmdIndex::Remove(const std::string& mount)
+{
+  (void) unlink((mount + "/" + sLogName).c_str());
+  (void) unlink((mount + "/" + sTableName).c_str());
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+FmdIndex::FmdIndex(const std::string& mount):
+  mLogPath(mount + "/" + sLogName), mTablePath(mount + "/" + sTableName)
+{
+  static_assert(sizeof(TableHeader) == 4096, "unexpected table header size");
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+FmdIndex::~FmdIndex()
+{
+  Close();
+}
+
+//------------------------------------------------------------------------------
+// Table accessors
+//------------------------------------------------------------------------------
+FmdIndex::TableHeader*
+FmdIndex::Header() const
+{
+  return reinterpret_cast<TableHeader*>(mMap);
+}
+
+FmdIndex::Slot*
+FmdIndex::Slots() const
+{
+  return reinterpret_cast<Slot*>(mMap + sizeof(TableHeader));
+}
+
+//------------------------------------------------------------------------------
+// Find the slot of the given file id
+//------------------------------------------------------------------------------
+FmdIndex::Slot*
+FmdIndex::FindSlot(eos::common::FileId::fileid_t fid) const
+{
+  const uint64_t cap = Header()->mCapacity;
+  // Fibonacci hashing spreads the mostly sequential file ids
+  uint64_t pos = (fid * 11400714819323198485ull) >> (64 - __builtin_ctzll(cap));
+  Slot* slots = Slots();
+
+  for (uint64_t i = 0; i < cap; ++i) {
+    Slot* slot = &slots[(pos + i) & (cap - 1)];
+
+    if (slot->mFid == fid) {
+      return slot;
+    }
+
+    if (slot->mFid == 0) {
+      return nullptr;
+    }
+  }
+
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+// Insert or update the location of the given file id
+//------------------------------------------------------------------------------
+bool
+FmdIndex::InsertSlot(eos::common::FileId::fileid_t fid, uint64_t loc)
+{
+  TableHeader* hdr = Header();
+
+  if (Slot* slot = FindSlot(fid)) {
+    hdr->mLiveBytes -= (slot->mLoc & kMaxRecordLen);
+    hdr->mLiveBytes += (loc & kMaxRecordLen);
+    slot->mLoc = loc;
+    return true;
+  }
+
+  // Keep the load factor, including tombstones, below 70%
+  if ((hdr->mUsed + 1) * 10 > hdr->mCapacity * 7) {
+    uint64_t cap = hdr->mCapacity;
+
+    while ((hdr->mCount + 1) * 10 > cap * 4) {
+      cap <<= 1;
+    }
+
+    if (!ResizeTable(cap)) {
+      return false;
+    }
+
+    hdr = Header();
+  }
+
+  const uint64_t cap = hdr->mCapacity;
+  uint64_t pos = (fid * 11400714819323198485ull) >> (64 - __builtin_ctzll(cap));
+  Slot* slots = Slots();
+
+  for (uint64_t i = 0; i < cap; ++i) {
+    Slot* slot = &slots[(pos + i) & (cap - 1)];
+
+    if ((slot->mFid == 0) || (slot->mFid == kTombstone)) {
+      if (slot->mFid == 0) {
+        ++hdr->mUsed;
+      }
+
+      slot->mFid = fid;
+      slot->mLoc = loc;
+      ++hdr->mCount;
+      hdr->mLiveBytes += (loc & kMaxRecordLen);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Remove the given file id from the table
+//------------------------------------------------------------------------------
+void
+FmdIndex::RemoveSlot(eos::common::FileId::fileid_t fid)
+{
+  if (Slot* slot = FindSlot(fid)) {
+    TableHeader* hdr = Header();
+    hdr->mLiveBytes -= (slot->mLoc & kMaxRecordLen);
+    --hdr->mCount;
+    slot->mFid = kTombstone;
+    slot->mLoc = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Map the table file at the given path
+//------------------------------------------------------------------------------
+bool
+FmdIndex::MapTable(const std::string& path)
+{
+  int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+
+  if (fstat(fd, &info) || (info.st_size < (off_t)sizeof(TableHeader))) {
+    (void) close(fd);
+    return false;
+  }
+
+  void* map = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd, 0);
+
+  if (map == MAP_FAILED) {
+    (void) close(fd);
+    return false;
+  }
+
+  const TableHeader* hdr = reinterpret_cast<TableHeader*>(map);
+
+  if ((hdr->mMagic != kTableMagic) || (hdr->mVersion != kTableVersion) ||
+      (hdr->mCapacity < kMinCapacity) ||
+      (hdr->mCapacity & (hdr->mCapacity - 1)) ||
+      ((uint64_t)info.st_size != sizeof(TableHeader) + hdr->mCapacity *
+       sizeof(Slot))) {
+    (void) munmap(map, info.st_size);
+    (void) close(fd);
+    return false;
+  }
+
+  UnmapTable();
+  mTableFd = fd;
+  mMap = static_cast<char*>(map);
+  mMapSize = info.st_size;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Unmap the table
+//------------------------------------------------------------------------------
+void
+FmdIndex::UnmapTable()
+{
+  if (mMap) {
+    (void) munmap(mMap, mMapSize);
+    mMap = nullptr;
+    mMapSize = 0;
+  }
+
+  if (mTableFd >= 0) {
+    (void) close(mTableFd);
+    mTableFd = -1;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Create an empty table with the given capacity
+//------------------------------------------------------------------------------
+bool
+FmdIndex::CreateTable(uint64_t capacity)
+{
+  const std::string tmp_path = mTablePath + ".tmp";
+  int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                S_IRUSR | S_IWUSR);
+
+  if (fd < 0) {
+    eos_err("msg=\"failed to create fmd index table\" path=%s errno=%d",
+            tmp_path.c_str(), errno);
+    return false;
+  }
+
+  // The file is sparse, the empty slots are all zeros
+  TableHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.mMagic = kTableMagic;
+  hdr.mVersion = kTableVersion;
+  hdr.mCapacity = capacity;
+  strncpy(hdr.mBootId, mBootId.c_str(), sizeof(hdr.mBootId) - 1);
+
+  if (!PwriteAll(fd, (const char*)&hdr, sizeof(hdr), 0) ||
+      ftruncate(fd, sizeof(TableHeader) + capacity * sizeof(Slot))) {
+    eos_err("msg=\"failed to initialize fmd index table\" path=%s errno=%d",
+            tmp_path.c_str(), errno);
+    (void) close(fd);
+    (void) unlink(tmp_path.c_str());
+    return false;
+  }
+
+  (void) close(fd);
+
+  if (rename(tmp_path.c_str(), mTablePath.c_str())) {
+    (void) unlink(tmp_path.c_str());
+    return false;
+  }
+
+  return MapTable(mTablePath);
+}
+
+//------------------------------------------------------------------------------
+// Rehash the table into a new one with the given capacity
+//------------------------------------------------------------------------------
+bool
+FmdIndex::ResizeTable(uint64_t capacity)
+{
+  std::vector<Slot> live;
+  live.reserve(Header()->mCount);
+  const uint64_t old_cap = Header()->mCapacity;
+  const uint32_t clean = Header()->mClean;
+
+  for (uint64_t i = 0; i < old_cap; ++i) {
+    const Slot& slot = Slots()[i];
+
+    if ((slot.mFid != 0) && (slot.mFid != kTombstone)) {
+      live.push_back(slot);
+    }
+  }
+
+  if (!CreateTable(capacity)) {
+    return false;
+  }
+
+  Header()->mClean = clean;
+
+  for (const auto& slot : live) {
+    if (!InsertSlot(slot.mFid, slot.mLoc)) {
+      return false;
+    }
+  }
+
+  eos_debug("msg=\"resized fmd index table\" path=%s capacity=%llu entries=%llu",
+            mTablePath.c_str(), (unsigned long long) capacity,
+            (unsigned long long) live.size());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Append a record to the log
+//------------------------------------------------------------------------------
+uint64_t
+FmdIndex::AppendRecord(eos::common::FileId::fileid_t fid, uint32_t op,
+                       const std::string& payload)
+{
+  const uint64_t len = sizeof(RecordHeader) + payload.size();
+
+  if (len > kMaxRecordLen) {
+    return 0;
+  }
+
+  std::string buff(len, '\0');
+  RecordHeader hdr;
+  hdr.mMagic = kRecordMagic;
+  hdr.mLen = payload.size();
+  hdr.mFid = fid;
+  hdr.mOp = op;
+  hdr.mCrc = RecordCrc(hdr, payload.data());
+  memcpy(&buff[0], &hdr, sizeof(hdr));
+  memcpy(&buff[sizeof(hdr)], payload.data(), payload.size());
+
+  if (!PwriteAll(mLogFd, buff.data(), buff.size(), mLogSize)) {
+    eos_err("msg=\"failed to append to fmd index log\" path=%s errno=%d",
+            mLogPath.c_str(), errno);
+    return 0;
+  }
+
+  const uint64_t loc = (mLogSize << kLenBits) | len;
+  mLogSize += len;
+  return loc;
+}
+
+//------------------------------------------------------------------------------
+// Read the record at the given location
+//------------------------------------------------------------------------------
+bool
+FmdIndex::ReadRecord(uint64_t loc, eos::common::FileId::fileid_t fid,
+                     eos::common::FmdHelper& fmd) const
+{
+  const uint64_t len = loc & kMaxRecordLen;
+  std::string buff(len, '\0');
+
+  if ((len < sizeof(RecordHeader)) ||
+      !PreadAll(mLogFd, &buff[0], len, loc >> kLenBits)) {
+    return false;
+  }
+
+  RecordHeader hdr;
+  memcpy(&hdr, buff.data(), sizeof(hdr));
+  const char* payload = buff.data() + sizeof(hdr);
+
+  if ((hdr.mMagic != kRecordMagic) || (hdr.mFid != fid) ||
+      (hdr.mOp != kOpPut) || (sizeof(hdr) + hdr.mLen != len) ||
+      (hdr.mCrc != RecordCrc(hdr, payload))) {
+    eos_err("msg=\"corrupted fmd index record\" path=%s fxid=%08llx",
+            mLogPath.c_str(), (unsigned long long) fid);
+    return false;
+  }
+
+  return fmd.mProtoFmd.ParsePartialFromArray(payload, hdr.mLen);
+}
+
+//------------------------------------------------------------------------------
+// Rebuild the table from the log, truncating any torn tail
+//------------------------------------------------------------------------------
+bool
+FmdIndex::ReplayLog()
+{
+  if (!CreateTable(Header() ? Header()->mCapacity : kMinCapacity)) {
+    return false;
+  }
+
+  std::string buff;
+  uint64_t buff_off = 0; // log offset of buff[0]
+  uint64_t offset = 0;
+
+  // Make sure [offset, offset + len) is in the buffer
+  auto fill = [&](uint64_t len) {
+    if (offset + len <= buff_off + buff.size()) {
+      return true;
+    }
+
+    if (offset + len > mLogSize) {
+      return false;
+    }
+
+    buff.resize(std::max<uint64_t>(kReadChunk, len));
+    const uint64_t to_read = std::min<uint64_t>(buff.size(), mLogSize - offset);
+
+    if (!PreadAll(mLogFd, &buff[0], to_read, offset)) {
+      return false;
+    }
+
+    buff.resize(to_read);
+    buff_off = offset;
+    return true;
+  };
+
+  while (offset < mLogSize) {
+    RecordHeader hdr;
+
+    if (!fill(sizeof(hdr))) {
+      break;
+    }
+
+    memcpy(&hdr, &buff[offset - buff_off], sizeof(hdr));
+
+    if ((hdr.mMagic != kRecordMagic) ||
+        (sizeof(hdr) + hdr.mLen > kMaxRecordLen) ||
+        !fill(sizeof(hdr) + hdr.mLen) ||
+        (hdr.mCrc != RecordCrc(hdr, &buff[offset - buff_off + sizeof(hdr)]))) {
+      break;
+    }
+
+    const uint64_t len = sizeof(hdr) + hdr.mLen;
+
+    if (hdr.mOp == kOpPut) {
+      if (!InsertSlot(hdr.mFid, (offset << kLenBits) | len)) {
+        return false;
+      }
+    } else {
+      RemoveSlot(hdr.mFid);
+    }
+
+    offset += len;
+  }
+
+  if (offset < mLogSize) {
+    eos_warning("msg=\"truncating torn fmd index log\" path=%s size=%llu "
+                "valid=%llu", mLogPath.c_str(), (unsigned long long) mLogSize,
+                (unsigned long long) offset);
+
+    if (ftruncate(mLogFd, offset)) {
+      return false;
+    }
+
+    mLogSize = offset;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get the locations of all the live records sorted by log offset
+//------------------------------------------------------------------------------
+std::vector<uint64_t>
+FmdIndex::GetSortedLocations() const
+{
+  std::vector<uint64_t> locs;
+  locs.reserve(Header()->mCount);
+
+  for (uint64_t i = 0; i < Header()->mCapacity; ++i) {
+    const Slot& slot = Slots()[i];
+
+    if ((slot.mFid != 0) && (slot.mFid != kTombstone)) {
+      locs.push_back(slot.mLoc);
+    }
+  }
+
+  std::sort(locs.begin(), locs.end());
+  return locs;
+}
+
+//------------------------------------------------------------------------------
+// Rewrite the log keeping only the live records
+//------------------------------------------------------------------------------
+bool
+FmdIndex::Compact()
+{
+  const std::string tmp_path = mLogPath + ".tmp";
+  int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                S_IRUSR | S_IWUSR);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  std::vector<uint64_t> locs = GetSortedLocations();
+  std::vector<Slot> slots;
+  slots.reserve(locs.size());
+  std::string out;
+  uint64_t new_size = 0;
+  bool ok = true;
+
+  for (const auto loc : locs) {
+    const uint64_t len = loc & kMaxRecordLen;
+    std::string rec(len, '\0');
+    RecordHeader hdr;
+
+    if (!PreadAll(mLogFd, &rec[0], len, loc >> kLenBits)) {
+      ok = false;
+      break;
+    }
+
+    memcpy(&hdr, rec.data(), sizeof(hdr));
+    slots.push_back({hdr.mFid, ((new_size + out.size()) << kLenBits) | len});
+    out += rec;
+
+    if (out.size() >= kReadChunk) {
+      if (!PwriteAll(fd, out.data(), out.size(), new_size)) {
+        ok = false;
+        break;
+      }
+
+      new_size += out.size();
+      out.clear();
+    }
+  }
+
+  if (ok && !out.empty()) {
+    ok = PwriteAll(fd, out.data(), out.size(), new_size);
+    new_size += out.size();
+  }
+
+  if (!ok || fdatasync(fd) || rename(tmp_path.c_str(), mLogPath.c_str())) {
+    (void) close(fd);
+    (void) unlink(tmp_path.c_str());
+    return false;
+  }
+
+  const uint64_t old_size = mLogSize;
+  (void) close(mLogFd);
+  mLogFd = fd;
+  mLogSize = new_size;
+
+  // The table is still marked unclean, if we crash now the log is replayed.
+  // The old table points into the old log, it can not be used any more.
+  if (!CreateTable(Header()->mCapacity)) {
+    UnmapTable();
+    return false;
+  }
+
+  for (const auto& slot : slots) {
+    if (!InsertSlot(slot.mFid, slot.mLoc)) {
+      UnmapTable();
+      return false;
+    }
+  }
+
+  eos_info("msg=\"compacted fmd index log\" path=%s old_size=%llu "
+           "new_size=%llu", mLogPath.c_str(), (unsigned long long) old_size,
+           (unsigned long long) new_size);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Compact the log if it holds mostly stale records
+//------------------------------------------------------------------------------
+void
+FmdIndex::MaybeCompact()
+{
+  if ((mLogSize <= mCompactMinLogSize) ||
+      (mLogSize <= 2 * Header()->mLiveBytes) ||
+      (mLogSize < mNextCompactSize)) {
+    return;
+  }
+
+  if (!Compact()) {
+    // Do not retry on every update
+    eos_err("msg=\"failed to compact fmd index log\" path=%s size=%llu",
+            mLogPath.c_str(), (unsigned long long) mLogSize);
+    mNextCompactSize = 2 * mLogSize;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Open the index, creating it if needed
+//------------------------------------------------------------------------------
+bool
+FmdIndex::Open(bool& rebuild)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  rebuild = false;
+  mBootId = GetBootId();
+  mLogFd = open(mLogPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC,
+                S_IRUSR | S_IWUSR);
+
+  if (mLogFd < 0) {
+    eos_err("msg=\"failed to open fmd index log\" path=%s errno=%d",
+            mLogPath.c_str(), errno);
+    return false;
+  }
+
+  struct stat info;
+
+  if (fstat(mLogFd, &info)) {
+    return false;
+  }
+
+  mLogSize = info.st_size;
+  bool trusted = false;
+
+  if (MapTable(mTablePath)) {
+    TableHeader* hdr = Header();
+
+    if (hdr->mClean && (hdr->mLogSize == mLogSize)) {
+      trusted = true;
+    } else if (!mBootId.empty() &&
+               (strncmp(hdr->mBootId, mBootId.c_str(), sizeof(hdr->mBootId)) == 0)) {
+      // Only the daemon died, the log written so far is in the page cache
+      eos_info("msg=\"replaying fmd index log\" path=%s", mLogPath.c_str());
+      trusted = ReplayLog();
+    }
+  }
+
+  if (!trusted) {
+    eos_info("msg=\"resetting fmd index\" path=%s", mTablePath.c_str());
+
+    if (ftruncate(mLogFd, 0) || !CreateTable(kMinCapacity)) {
+      eos_err("msg=\"failed to reset fmd index\" path=%s", mTablePath.c_str());
+      UnmapTable();
+      return false;
+    }
+
+    mLogSize = 0;
+    rebuild = true;
+  } else {
+    MaybeCompact();
+
+    if (!mMap) {
+      eos_err("msg=\"lost fmd index table while compacting\" path=%s",
+              mTablePath.c_str());
+      return false;
+    }
+  }
+
+  TableHeader* hdr = Header();
+  hdr->mClean = 0;
+  memset(hdr->mBootId, 0, sizeof(hdr->mBootId));
+  strncpy(hdr->mBootId, mBootId.c_str(), sizeof(hdr->mBootId) - 1);
+  (void) msync(mMap, sizeof(TableHeader), MS_SYNC);
+  eos_info("msg=\"opened fmd index\" path=%s entries=%llu log_size=%llu",
+           mTablePath.c_str(), (unsigned long long) hdr->mCount,
+           (unsigned long long) mLogSize);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Close the index
+//------------------------------------------------------------------------------
+void
+FmdIndex::Close()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (mLogFd < 0) {
+    return;
+  }
+
+  if (mMap && (fdatasync(mLogFd) == 0) &&
+      (msync(mMap, mMapSize, MS_SYNC) == 0)) {
+    // Mark clean only once both the log and the slots are on disk
+    Header()->mLogSize = mLogSize;
+    Header()->mClean = 1;
+    (void) msync(mMap, sizeof(TableHeader), MS_SYNC);
+  }
+
+  UnmapTable();
+  (void) close(mLogFd);
+  mLogFd = -1;
+}
+
+//------------------------------------------------------------------------------
+// Add or update the record of a file
+//------------------------------------------------------------------------------
+bool
+FmdIndex::Put(const eos::common::FmdHelper& fmd)
+{
+  const uint64_t fid = fmd.mProtoFmd.fid();
+
+  if ((fid == 0) || (fid == kTombstone)) {
+    return false;
+  }
+
+  std::string payload;
+
+  if (!fmd.mProtoFmd.SerializePartialToString(&payload)) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (!mMap) {
+    return false;
+  }
+
+  const uint64_t loc = AppendRecord(fid, kOpPut, payload);
+
+  if (!loc || !InsertSlot(fid, loc)) {
+    return false;
+  }
+
+  MaybeCompact();
+  return mMap != nullptr;
+}
+
+//------------------------------------------------------------------------------
+// Delete the record of a file
+//------------------------------------------------------------------------------
+bool
+FmdIndex::Delete(eos::common::FileId::fileid_t fid)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (!mMap) {
+    return false;
+  }
+
+  if (!FindSlot(fid)) {
+    return true;
+  }
+
+  if (!AppendRecord(fid, kOpDelete, "")) {
+    return false;
+  }
+
+  RemoveSlot(fid);
+  MaybeCompact();
+  return mMap != nullptr;
+}
+
+//------------------------------------------------------------------------------
+// Get the record of a file
+//------------------------------------------------------------------------------
+bool
+FmdIndex::Get(eos::common::FileId::fileid_t fid,
+              eos::common::FmdHelper& fmd) const
+{
+  // The log may be compacted or closed as soon as the lock is released
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (!mMap) {
+    return false;
+  }
+
+  const Slot* slot = FindSlot(fid);
+  return slot && ReadRecord(slot->mLoc, fid, fmd);
+}
+
+//------------------------------------------------------------------------------
+// Check if the index holds a record for the given file
+//------------------------------------------------------------------------------
+bool
+FmdIndex::Contains(eos::common::FileId::fileid_t fid) const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mMap && (FindSlot(fid) != nullptr);
+}
+
+//------------------------------------------------------------------------------
+// Get the number of records
+//------------------------------------------------------------------------------
+uint64_t
+FmdIndex::Size() const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mMap ? Header()->mCount : 0;
+}
+
+//------------------------------------------------------------------------------
+// Apply the given function to all the records
+//------------------------------------------------------------------------------
+uint64_t
+FmdIndex::ForEach(const std::function<void(const eos::common::FmdHelper&)>&
+                  fn) const
+{
+  std::vector<uint64_t> locs;
+  int fd = -1;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (!mMap) {
+      return 0;
+    }
+
+    locs = GetSortedLocations();
+    // Records are never overwritten in place and a compaction replaces the
+    // log by a new file, the duplicate keeps the current one readable
+    fd = dup(mLogFd);
+
+    if (fd < 0) {
+      eos_err("msg=\"failed to duplicate fmd index log descriptor\" path=%s "
+              "errno=%d", mLogPath.c_str(), errno);
+      return 0;
+    }
+  }
+  uint64_t count = 0;
+  std::string buff;
+  uint64_t buff_off = 0;
+
+  // Records are read in log order through a large buffer
+  for (const auto loc : locs) {
+    const uint64_t offset = loc >> kLenBits;
+    const uint64_t len = loc & kMaxRecordLen;
+
+    if ((offset < buff_off) || (offset + len > buff_off + buff.size())) {
+      buff.resize(std::max<uint64_t>(kReadChunk, len));
+      ssize_t nread = 0;
+
+      do {
+        nread = pread(fd, &buff[0], buff.size(), offset);
+      } while ((nread < 0) && (errno == EINTR));
+
+      if (nread < (ssize_t)len) {
+        buff.clear();
+        continue;
+      }
+
+      buff.resize(nread);
+      buff_off = offset;
+    }
+
+    RecordHeader hdr;
+    const char* rec = buff.data() + (offset - buff_off);
+    memcpy(&hdr, rec, sizeof(hdr));
+
+    if ((hdr.mMagic != kRecordMagic) || (sizeof(hdr) + hdr.mLen != len) ||
+        (hdr.mCrc != RecordCrc(hdr, rec + sizeof(hdr)))) {
+      continue;
+    }
+
+    eos::common::FmdHelper fmd;
+
+    if (fmd.mProtoFmd.ParsePartialFromArray(rec + sizeof(hdr), hdr.mLen)) {
+      fn(fmd);
+      ++count;
+    }
+  }
+
+  (void) close(fd);
+  return count;
+}
+
+EOSFSTNAMESPACE_END
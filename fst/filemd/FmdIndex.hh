@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+//! @file FmdIndex.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include "common/Fmd.hh"
+#include "common/FileId.hh"
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class FmdIndex - compact index of the Fmd records of one file system.
+//!
+//! The records are appended to a log file and an open addressing hash table,
+//! mapped in memory, points to the latest record of every file id. Both live
+//! at the top of the file system mountpoint as dot files so that they are
+//! skipped by the tree walks. The extended attributes of the data files stay
+//! the reference copy of the Fmd, the index is a cache kept up to date on
+//! every commit and delete.
+//!
+//! The table header records whether the index was closed cleanly and the
+//! boot id of the machine. After a crash of the daemon the table is rebuilt
+//! from the log, which is complete since it is written before returning to
+//! the caller. After a crash of the machine the tail of the log might have
+//! been lost, therefore the caller has to repopulate the index from the
+//! extended attributes.
+//------------------------------------------------------------------------------
+class FmdIndex: public eos::common::LogId
+{
+public:
+  //! Name of the log and table files inside the mountpoint
+  static constexpr auto sLogName = ".eosfmdindex.log";
+  static constexpr auto sTableName = ".eosfmdindex.tbl";
+
+  //----------------------------------------------------------------------------
+  //! Remove the index files of the given mountpoint, used whenever the
+  //! extended attributes are modified without going through the index
+  //!
+  //! @param mount file system mountpoint
+  //----------------------------------------------------------------------------
+  static void Remove(const std::string& mount);
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param mount file system mountpoint
+  //----------------------------------------------------------------------------
+  FmdIndex(const std::string& mount);
+
+  //----------------------------------------------------------------------------
+  //! Destructor - closes the index cleanly
+  //----------------------------------------------------------------------------
+  ~FmdIndex();
+
+  //----------------------------------------------------------------------------
+  //! Open the index, creating it if needed
+  //!
+  //! @param rebuild set to true if the index is empty because it did not
+  //!        exist or could not be trusted, the caller must then Put all the
+  //!        Fmd records of the file system
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool Open(bool& rebuild);
+
+  //----------------------------------------------------------------------------
+  //! Close the index, flushing everything to disk and marking it clean
+  //----------------------------------------------------------------------------
+  void Close();
+
+  //----------------------------------------------------------------------------
+  //! Add or update the record of a file
+  //!
+  //! @param fmd file metadata, the file id must not be 0
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool Put(const eos::common::FmdHelper& fmd);
+
+  //----------------------------------------------------------------------------
+  //! Delete the record of a file
+  //!
+  //! @param fid file identifier
+  //!
+  //! @return true if successful or not present, otherwise false
+  //----------------------------------------------------------------------------
+  bool Delete(eos::common::FileId::fileid_t fid);
+
+  //----------------------------------------------------------------------------
+  //! Get the record of a file
+  //!
+  //! @param fid file identifier
+  //! @param fmd filled with the record
+  //!
+  //! @return true if found, otherwise false
+  //----------------------------------------------------------------------------
+  bool Get(eos::common::FileId::fileid_t fid,
+           eos::common::FmdHelper& fmd) const;
+
+  //----------------------------------------------------------------------------
+  //! Check if the index holds a record for the given file
+  //----------------------------------------------------------------------------
+  bool Contains(eos::common::FileId::fileid_t fid) const;
+
+  //----------------------------------------------------------------------------
+  //! Apply the given function to all the records, in log order. The function
+  //! may update the index, records added meanwhile are not visited.
+  //!
+  //! @param fn function to apply
+  //!
+  //! @return number of records visited
+  //----------------------------------------------------------------------------
+  uint64_t ForEach(const std::function<void(const eos::common::FmdHelper&)>&
+                   fn) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the number of records
+  //----------------------------------------------------------------------------
+  uint64_t Size() const;
+
+private:
+#ifdef IN_TEST_HARNESS
+public:
+#endif
+  struct TableHeader;
+  struct Slot;
+
+  //----------------------------------------------------------------------------
+  //! Table helpers, all called with mMutex locked
+  //----------------------------------------------------------------------------
+  TableHeader* Header() const;
+  Slot* Slots() const;
+  Slot* FindSlot(eos::common::FileId::fileid_t fid) const;
+  bool InsertSlot(eos::common::FileId::fileid_t fid, uint64_t loc);
+  void RemoveSlot(eos::common::FileId::fileid_t fid);
+  bool MapTable(const std::string& path);
+  void UnmapTable();
+  bool CreateTable(uint64_t capacity);
+  bool ResizeTable(uint64_t capacity);
+
+  //----------------------------------------------------------------------------
+  //! Append a record to the log
+  //!
+  //! @return location of the record or 0 on error
+  //----------------------------------------------------------------------------
+  uint64_t AppendRecord(eos::common::FileId::fileid_t fid, uint32_t op,
+                        const std::string& payload);
+
+  //----------------------------------------------------------------------------
+  //! Read the record at the given location
+  //----------------------------------------------------------------------------
+  bool ReadRecord(uint64_t loc, eos::common::FileId::fileid_t fid,
+                  eos::common::FmdHelper& fmd) const;
+
+  //----------------------------------------------------------------------------
+  //! Rebuild the table from the log, truncating any torn tail
+  //----------------------------------------------------------------------------
+  bool ReplayLog();
+
+  //----------------------------------------------------------------------------
+  //! Rewrite the log keeping only the live records
+  //----------------------------------------------------------------------------
+  bool Compact();
+
+  //----------------------------------------------------------------------------
+  //! Compact the log once it is large and mostly made of stale records
+  //----------------------------------------------------------------------------
+  void MaybeCompact();
+
+  //----------------------------------------------------------------------------
+  //! Get the locations of all the live records sorted by log offset
+  //----------------------------------------------------------------------------
+  std::vector<uint64_t> GetSortedLocations() const;
+
+  std::string mLogPath;
+  std::string mTablePath;
+  std::string mBootId; ///< Boot id of the current machine
+  int mLogFd {-1};
+  uint64_t mLogSize {0ull};
+  //! Compact the log if larger than this and more than twice the live
+  //! records, checked on open and after every update
+  uint64_t mCompactMinLogSize {64ull << 20};
+  uint64_t mNextCompactSize {0ull}; ///< Log size to reach after a failed compaction
+  int mTableFd {-1};
+  char* mMap {nullptr};
+  size_t mMapSize {0ull};
+  mutable std::mutex mMutex;
+};
+
+EOSFSTNAMESPACE_END
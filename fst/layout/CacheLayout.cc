@@ -18,29 +18,6 @@
 
 EOSFSTNAMESPACE_BEGIN
 
-namespace
-{
-//------------------------------------------------------------------------------
-//! Parse a watermark percent string; returns fallback when out of range
-//------------------------------------------------------------------------------
-unsigned
-ParseWatermark(const char* value, unsigned fallback)
-{
-  if (!value || !*value) {
-    return fallback;
-  }
-
-  char* end = nullptr;
-  const long v = std::strtol(value, &end, 10);
-
-  if ((end == value) || (v < 0) || (v > 100)) {
-    return fallback;
-  }
-
-  return (unsigned) v;
-}
-}
-
 CacheLayout::CacheLayout(XrdFstOfsFile* file, unsigned long lid,
                          const XrdSecEntity* client, XrdOucErrInfo* outError,
                          const char* path, eos::fst::FmdHandler* fmdHandler,
@@ -102,23 +79,9 @@ CacheLayout::Open(XrdSfsFileOpenMode flags, mode_t mode, const char* opaque)
     // Watermarks: local filesystem config (pushed by the MGM via
     // "space config") takes precedence, the capability value is the
     // fallback, then the compiled-in defaults.
-    unsigned low = ParseWatermark(
-                     eos::common::SPACE_CACHE_LOW_WATERMARK_DEFAULT, 70);
-    unsigned high = ParseWatermark(
-                      eos::common::SPACE_CACHE_HIGH_WATERMARK_DEFAULT, 85);
-    low = ParseWatermark(cap->Get("mgm.cache.low_watermark"), low);
-    high = ParseWatermark(cap->Get("mgm.cache.high_watermark"), high);
-    // The resolver is registered by the FST server; in standalone tools it
-    // is absent and the capability values apply
-    const std::string fs_low = CacheLruRegistry::Instance().GetConfig(
-                                 mCacheFsId,
-                                 eos::common::SPACE_CACHE_LOW_WATERMARK_NAME);
-    const std::string fs_high = CacheLruRegistry::Instance().GetConfig(
-                                  mCacheFsId,
-                                  eos::common::SPACE_CACHE_HIGH_WATERMARK_NAME);
-    low = ParseWatermark(fs_low.c_str(), low);
-    high = ParseWatermark(fs_high.c_str(), high);
-    mLru->SetWatermarks(low, high);
+    CacheLruRegistry::Instance().ConfigureWatermarks(
+      mLru, cap->Get("mgm.cache.low_watermark"),
+      cap->Get("mgm.cache.high_watermark"));
   }
 
   // Under pressure trigger background eviction; the journal is still opened
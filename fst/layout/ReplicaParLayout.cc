@@ -185,6 +185,7 @@ ReplicaParLayout::Open(XrdSfsFileOpenMode flags, mode_t mode,
       // Mask some opaque parameters to shorten the logging
       eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
       eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+      eos::common::StringConversion::MaskTag(maskUrl, "cap.bin");
       eos::common::StringConversion::MaskTag(maskUrl, "authz");
       eos_err("msg=\"failed %s %s open\" path=\"%s\"",
               (is_local ? "local" : "remote"), (is_rw ? "write" : "read"),
@@ -216,6 +217,7 @@ ReplicaParLayout::Read(XrdSfsFileOffset offset, char* buffer,
       // mask some opaque parameters to shorten the logging
       eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
       eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+      eos::common::StringConversion::MaskTag(maskUrl, "cap.bin");
       eos::common::StringConversion::MaskTag(maskUrl, "authz");
       eos_warning("Failed to read from replica off=%lld, length=%i, mask_url=%s",
                   offset, length, maskUrl.c_str());
@@ -253,6 +255,7 @@ ReplicaParLayout::ReadV(XrdCl::ChunkList& chunkList, uint32_t len)
       // Mask some opaque parameters to shorten the logging
       eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
       eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+      eos::common::StringConversion::MaskTag(maskUrl, "cap.bin");
       eos::common::StringConversion::MaskTag(maskUrl, "authz");
       eos_warning("msg=\"failed replica readv \" url=\"%s\"", maskUrl.c_str());
       continue;
@@ -289,6 +292,7 @@ ReplicaParLayout::Write(XrdSfsFileOffset offset, const char* buffer,
       // mask some opaque parameters to shorten the logging
       eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
       eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+      eos::common::StringConversion::MaskTag(maskUrl, "cap.bin");
       eos::common::StringConversion::MaskTag(maskUrl, "authz");
       errno = (i == 0) ? EIO : EREMOTEIO;
 
@@ -326,6 +330,7 @@ ReplicaParLayout::WriteAsync(XrdSfsFileOffset offset, const char* buffer,
       XrdOucString maskUrl = mReplicaUrl[i].c_str() ? mReplicaUrl[i].c_str() : "";
       eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
       eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+      eos::common::StringConversion::MaskTag(maskUrl, "cap.bin");
       eos::common::StringConversion::MaskTag(maskUrl, "authz");
 
       // Show only the first write error as an error to broadcast upstream
@@ -364,6 +369,7 @@ ReplicaParLayout::Truncate(XrdSfsFileOffset offset)
       // mask some opaque parameters to shorten the logging
       eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
       eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+      eos::common::StringConversion::MaskTag(maskUrl, "cap.bin");
       eos::common::StringConversion::MaskTag(maskUrl, "authz");
       eos_err("Failed to truncate replica %i", i);
       return Emsg("ReplicaParTuncate", *mError, errno, "truncate failed",
@@ -407,6 +413,7 @@ ReplicaParLayout::Sync()
     // mask some opaque parameters to shorten the logging
     eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
     eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+    eos::common::StringConversion::MaskTag(maskUrl, "cap.bin");
     eos::common::StringConversion::MaskTag(maskUrl, "authz");
     rc = mReplicaFile[i]->fileSync(mTimeout);
 
@@ -22,8 +22,10 @@
  ************************************************************************/
 
 #include "common/Constants.hh"
+#include "common/ParseUtils.hh"
 #include "common/StringTokenizer.hh"
 #include "common/SymKeys.hh"
+#include "common/Tracing.hh"
 #include "common/mq/SharedHashWrapper.hh"
 #include "fst/Config.hh"
 #include "fst/XrdFstOfs.hh"
@@ -55,6 +57,7 @@ std::set<std::string> Storage::sNodeUpdateKeys{
     "debug.level",
     "error.simulation",
     "stripexs",
+    "tracing",
     common::FST_CBOX_FORBID_RW_SYNC,
     common::FST_TRAFFIC_SHAPING_IO_LIMITS,
     common::FST_TRAFFIC_SHAPING_ENABLE_TOGGLE,
@@ -116,6 +119,7 @@ void Storage::UnregisterFileSystem(const std::string& queuepath) {
 
   mFsMutex.UnLockWrite();
   eos_static_info("msg=\"deleting file system\" qpath=%s", fs->GetQueuePath().c_str());
+  gOFS.mFmdHandler->DetachIndex(fs->GetLocalId());
   delete fs;
 }
 
@@ -388,6 +392,17 @@ try {
     mComputeStripeChecksum = (value == "on");
     eos_static_info("msg=\"stripe checksum calculation changed\" new_value=\"%s\" mComputeStripeChecksum=%s",
                     value.c_str(), mComputeStripeChecksum ? "enabled" : "disabled");
+  } else if (key == "tracing") {
+    // value can be "off" or the sample rate i.e. trace one request out of N
+    int64_t rate = 0;
+
+    if ((value != "off") && (!common::ParseInt64(value, rate) || (rate < 0))) {
+      eos_static_err("msg=\"invalid tracing value\" value=\"%s\"", value.c_str());
+    } else {
+      common::Tracer::SetSampleRate(rate);
+      eos_static_info("msg=\"tracing sample rate changed\" new_value=\"%s\"",
+                      value.c_str());
+    }
   } else {
     eos_static_err("msg=\"unhandled FST node configuration change because "
                    "of missing implementation\" key=\"%s\" value=\"%s\". "
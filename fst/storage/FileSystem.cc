@@ -399,6 +399,21 @@ FileSystem::GetFileIOStats(std::map<std::string, std::string>& map)
          map, "=", ",");
 }
 
+//------------------------------------------------------------------------------
+// Get the scanner throughput and the ETA of the current disk scan pass
+//------------------------------------------------------------------------------
+bool
+FileSystem::GetScanStats(uint64_t used_bytes, double& rate_mbs,
+                         uint64_t& eta_sec)
+{
+  if (!mScanDir) {
+    return false;
+  }
+
+  mScanDir->GetScanStats(used_bytes, rate_mbs, eta_sec);
+  return true;
+}
+
 //------------------------------------------------------------------------------
 // Get health information from the `sys.health` xattr
 //------------------------------------------------------------------------------
@@ -215,6 +215,18 @@ public:
   //----------------------------------------------------------------------------
   bool GetHealthInfo(std::map<std::string, std::string>& map);
 
+  //----------------------------------------------------------------------------
+  //! Get the scanner throughput and the estimated time left until the current
+  //! disk scan pass completes
+  //!
+  //! @param used_bytes bytes used on the file system
+  //! @param rate_mbs scan rate in MB/s
+  //! @param eta_sec estimated seconds until the end of the pass
+  //!
+  //! @return true if the file system has a scanner, otherwise false
+  //----------------------------------------------------------------------------
+  bool GetScanStats(uint64_t used_bytes, double& rate_mbs, uint64_t& eta_sec);
+
   //----------------------------------------------------------------------------
   //! Decide if we should run the boot procedure for current file system
   //!
@@ -478,6 +478,14 @@ std::map<std::string, std::string> Storage::GetFstStatistics(const std::string&
   output["stat.net.ethratemib"] = SSTR(netspeed / (8 * 1024 * 1024));
   output["stat.net.inratemib"] = SSTR(mFstLoad.GetNetRate(GetNetworkInterface().c_str(), "rxbytes") / 1024.0 / 1024.0);
   output["stat.net.outratemib"] = SSTR(mFstLoad.GetNetRate(GetNetworkInterface().c_str(), "txbytes") / 1024.0 / 1024.0);
+  // close latency statistics
+  gOFS.mCloseStats.Publish(output);
+
+  // deletion queue length and unlink rate
+  if (mDeletionExecutor) {
+    mDeletionExecutor->Publish(output);
+  }
+
   // publish timestamp
   output["stat.publishtimestamp"] = SSTR(eos::common::getEpochInMilliseconds().count());
 
@@ -553,6 +561,20 @@ std::map<std::string, std::string> Storage::GetFsStatistics(FileSystem* fs) {
   output["stat.disk.readratemb"] = std::to_string(readratemb);
   output["stat.disk.writeratemb"] = std::to_string(writeratemb);
   output["stat.disk.load"] = std::to_string(diskload);
+  // Publish stat.scan.*
+  double scan_rate_mbs = 0.0;
+  uint64_t scan_eta_sec = 0ull;
+  uint64_t used_bytes = 0ull;
+
+  if (auto kv = output.find("stat.statfs.usedbytes"); kv != output.end()) {
+    used_bytes = strtoull(kv->second.c_str(), 0, 10);
+  }
+
+  if (fs->GetScanStats(used_bytes, scan_rate_mbs, scan_eta_sec)) {
+    output["stat.scan.ratemb"] = std::to_string(scan_rate_mbs);
+    output["stat.scan.eta"] = std::to_string(scan_eta_sec);
+  }
+
   // Publish stat.health.*
   std::map<std::string, std::string> health;
 
@@ -22,10 +22,13 @@
  ************************************************************************/
 
 #include "common/SymKeys.hh"
+#include "common/StringUtils.hh"
+#include "common/StringConversion.hh"
 #include "fst/storage/Storage.hh"
 #include "fst/XrdFstOfs.hh"
 #include "fst/Deletion.hh"
 #include "fst/Config.hh"
+#include "fst/utils/IoPriority.hh"
 
 EOSFSTNAMESPACE_BEGIN
 
@@ -55,49 +58,22 @@ Storage::Remover()
   // Check for deletions when starting
   (void) gOFS.Query2Delete();
 
-  // Thread that unlinks stored files
+  // Thread handing over the deletions to the executor which unlinks the files
   while (true) {
-    num_deleted = 0ull;
+    const uint64_t done_before = mDeletionExecutor->GetNumDeleted() +
+                                 mDeletionExecutor->GetNumFailed();
     std::unique_ptr<Deletion> to_del;
 
-    while ((to_del = GetDeletion())) {
-      for (unsigned int i = 0; i < to_del->mFidVect.size(); ++i) {
-        eos_static_debug("msg=\"delete file\" fxid=%08llx fsid=%u",
-                         to_del->mFidVect[i], to_del->mFsid);
-        ++num_deleted;
-        const std::string hex_fid = eos::common::FileId::Fid2Hex(to_del->mFidVect[i]);
-        XrdOucErrInfo error;
-        XrdOucString capOpaqueString = "/?mgm.pcmd=drop";
-        XrdOucString OpaqueString = "";
-        OpaqueString += "&mgm.fsid=";
-        OpaqueString += (int) to_del->mFsid;
-        OpaqueString += "&mgm.fid=";
-        OpaqueString += hex_fid.c_str();
-        XrdOucEnv Opaque(OpaqueString.c_str());
-        capOpaqueString += OpaqueString;
-        // Delete local file
-        std::string deletionreport;
-        std::string deletionreport64;
-
-        if ((gOFS._rem("/DELETION", error, (const XrdSecEntity*) 0, &Opaque,
-                       0, 0, 0, true, &deletionreport) != SFS_OK)) {
-          eos_static_warning("msg=\"unable to remove local file\" fxid=%s "
-                             "fsid=%lu", hex_fid.c_str(), to_del->mFsid);
-        } else {
-          // Encode the deletion report only if deletion is successful
-          eos::common::SymKey::ZBase64(deletionreport, deletionreport64);
-          capOpaqueString += "&mgm.report=";
-          capOpaqueString += deletionreport64.c_str();
-        }
-
-        // Update the manager
-        if (gOFS.CallManager(&error, 0, 0, capOpaqueString)) {
-          eos_static_err("msg=\"unable to drop file\" fxid=\"%s\" fsid=\"%u\"",
-                         hex_fid.c_str(), to_del->mFsid);
-        }
+    // Wait for the current deletions to be done before asking for more,
+    // otherwise the same files would be handed over again
+    do {
+      while ((to_del = GetDeletion())) {
+        mDeletionExecutor->Submit(to_del->mFsid, to_del->mFidVect);
       }
-    }
+    } while (!mDeletionExecutor->WaitIdle(std::chrono::seconds(10)));
 
+    num_deleted = mDeletionExecutor->GetNumDeleted() +
+                  mDeletionExecutor->GetNumFailed() - done_before;
     auto now_ts = std::chrono::system_clock::now();
     bool request_del = (std::chrono::duration_cast<std::chrono::seconds>
                         (now_ts - last_request_ts) > request_interval);
@@ -114,4 +90,113 @@ Storage::Remover()
   }
 }
 
+//------------------------------------------------------------------------------
+// Delete one file scheduled for deletion and drop its replica at the MGM
+//------------------------------------------------------------------------------
+bool
+Storage::DeleteFile(eos::common::FileSystem::fsid_t fsid,
+                    eos::common::FileId::fileid_t fid)
+{
+  eos_static_debug("msg=\"delete file\" fxid=%08llx fsid=%u", fid, fsid);
+  const std::string hex_fid = eos::common::FileId::Fid2Hex(fid);
+  XrdOucErrInfo error;
+  XrdOucString capOpaqueString = "/?mgm.pcmd=drop";
+  XrdOucString OpaqueString = "";
+  OpaqueString += "&mgm.fsid=";
+  OpaqueString += (int) fsid;
+  OpaqueString += "&mgm.fid=";
+  OpaqueString += hex_fid.c_str();
+  XrdOucEnv Opaque(OpaqueString.c_str());
+  capOpaqueString += OpaqueString;
+  // Delete local file
+  std::string deletionreport;
+  std::string deletionreport64;
+  bool removed = true;
+
+  if ((gOFS._rem("/DELETION", error, (const XrdSecEntity*) 0, &Opaque,
+                 0, 0, 0, true, &deletionreport) != SFS_OK)) {
+    eos_static_warning("msg=\"unable to remove local file\" fxid=%s "
+                       "fsid=%lu", hex_fid.c_str(), fsid);
+    removed = false;
+  } else {
+    // Encode the deletion report only if deletion is successful
+    eos::common::SymKey::ZBase64(deletionreport, deletionreport64);
+    capOpaqueString += "&mgm.report=";
+    capOpaqueString += deletionreport64.c_str();
+  }
+
+  // Update the manager
+  if (gOFS.CallManager(&error, 0, 0, capOpaqueString)) {
+    eos_static_err("msg=\"unable to drop file\" fxid=\"%s\" fsid=\"%u\"",
+                   hex_fid.c_str(), fsid);
+  }
+
+  return removed;
+}
+
+//------------------------------------------------------------------------------
+// Check if the file system is busy with client IO
+//------------------------------------------------------------------------------
+bool
+Storage::IsFsBusy(eos::common::FileSystem::fsid_t fsid)
+{
+  // Client IO currently delayed by the traffic shaping
+  const auto stats = gOFS.mIoDelayConfig.GetActuatorStats();
+
+  if (stats.read_active_waiters || stats.write_active_waiters) {
+    return true;
+  }
+
+  const std::string path = GetStoragePath(fsid);
+
+  if (path.empty() || (path[0] != '/')) {
+    return false;
+  }
+
+  return ((mFstLoad.GetDiskRate(path.c_str(), "millisIO") / 1000.0) > 0.7);
+}
+
+//------------------------------------------------------------------------------
+// Get the deletion executor options from the environment
+//------------------------------------------------------------------------------
+utils::DeletionExecutor::Options
+Storage::GetDeletionOptions()
+{
+  utils::DeletionExecutor::Options opts;
+  const std::list<std::pair<const char*, uint32_t*>> num_opts {
+    {"EOS_FST_DELETION_THREADS", &opts.mNumThreads},
+    {"EOS_FST_DELETION_PER_FS", &opts.mMaxPerFs},
+    {"EOS_FST_DELETION_BATCH_SIZE", &opts.mBatchSize}};
+
+  for (const auto& elem : num_opts) {
+    const char* ptr = getenv(elem.first);
+
+    if (ptr && !eos::common::StringToNumeric(std::string(ptr), *elem.second,
+        *elem.second)) {
+      eos_static_err("msg=\"failed to convert %s, using by default %u\"",
+                     elem.first, *elem.second);
+    }
+  }
+
+  // Deletions run with the lowest best-effort IO priority by default
+  std::string key = "be", value = "7";
+  const char* ptr = getenv("EOS_FST_DELETION_IOPRIO");
+
+  if (ptr && !eos::common::StringConversion::SplitKeyValue(ptr, key, value,
+      ":")) {
+    eos_static_err("%s", "msg=\"failed to parse EOS_FST_DELETION_IOPRIO, "
+                   "using by default be:7\"");
+    key = "be";
+    value = "7";
+  }
+
+  const int prio_class = ioprio_class(key);
+
+  if (prio_class != IOPRIO_CLASS_NONE) {
+    opts.mIoPriority = IOPRIO_PRIO_VALUE(prio_class, ioprio_value(value));
+  }
+
+  return opts;
+}
+
 EOSFSTNAMESPACE_END
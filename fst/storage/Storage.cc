@@ -38,6 +38,7 @@
 #include "common/ShellCmd.hh"
 #include "common/StringUtils.hh"
 #include "fst/utils/FTSWalkTree.hh"
+#include "fst/utils/IoPriority.hh"
 #include "MonitorVarPartition.hh"
 #include "qclient/structures/QSet.hh"
 #include <google/dense_hash_map>
@@ -345,6 +346,12 @@ Storage::Storage(const char* meta_dir)
   XrdSysMutexHelper tsLock(mThreadsMutex);
   mThreadSet.insert(tid);
   eos_info("starting deletion thread");
+  mDeletionExecutor.reset(new utils::DeletionExecutor(
+  [this](uint32_t fsid, uint64_t fid) {
+    return DeleteFile(fsid, fid);
+  }, [this](uint32_t fsid) {
+    return IsFsBusy(fsid);
+  }, GetDeletionOptions()));
 
   if ((rc = XrdSysThread::Run(&tid, Storage::StartFsRemover,
                               static_cast<void*>(this),
@@ -504,6 +511,10 @@ Storage::ShutdownThreads()
     eos_warning("op=shutdown thread_id=%llx", (unsigned long long) *it);
     XrdSysThread::Cancel(*it);
   }
+
+  if (mDeletionExecutor) {
+    mDeletionExecutor->Stop();
+  }
 }
 
 bool
@@ -644,6 +655,34 @@ Storage::StartBoot(void* pp)
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// Get the options of the boot resync from the node configuration
+//------------------------------------------------------------------------------
+FmdResyncOptions
+Storage::GetResyncOptions() const
+{
+  FmdResyncOptions opts;
+  unsigned long long nparallel = 0ull;
+
+  // Sequential unless more threads are configured for the node
+  if (GetFstConfigValue("resync.nparallel", nparallel) && nparallel) {
+    opts.mNumWorkers = std::min(nparallel, 64ull);
+  }
+
+  std::string ioprio, key, value;
+
+  if (GetFstConfigValue("resync.ioprio", ioprio) &&
+      eos::common::StringConversion::SplitKeyValue(ioprio, key, value, ":")) {
+    int prio_class = ioprio_class(key);
+
+    if (prio_class != IOPRIO_CLASS_NONE) {
+      opts.mIoPriority = IOPRIO_PRIO_VALUE(prio_class, ioprio_value(value));
+    }
+  }
+
+  return opts;
+}
+
 //------------------------------------------------------------------------------
 // Boot file system
 //------------------------------------------------------------------------------
@@ -779,6 +818,12 @@ Storage::Boot(FileSystem* fs)
                     "fs_path=%s", fs->GetPath().c_str());
   }
 
+  // The xattrs stay the reference copy, without the index the lookups and
+  // full scans just go through the xattrs
+  if (!gOFS.mFmdHandler->AttachIndex(fsid)) {
+    eos_static_warning("msg=\"running without fmd index\" fsid=%u", fsid);
+  }
+
   {
     XrdSysMutexHelper scope_lock(gOFS.OpenFidMutex);
     gOFS.WNoDeleteOnCloseFid[fsid].clear_deleted_key();
@@ -794,12 +839,20 @@ Storage::Boot(FileSystem* fs)
   fs->SetLongLong("bootcheck", 0);
   eos_info("msg=\"booting\" fsid=%u resync_mgm=%d resync_disk=%d", fsid,
            resyncmgm, resyncdisk);
+  FmdResyncOptions resync_opts = GetResyncOptions();
+  resync_opts.mProgress = [fs](const std::string & phase, uint64_t done,
+  uint64_t total) {
+    fs->SetString("stat.resync.phase", phase.c_str());
+    fs->SetLongLong("stat.resync.done", done);
+    fs->SetLongLong("stat.resync.total", total);
+  };
 
   // Sync only local disks
   if (resyncdisk && (fs->GetPath()[0] == '/')) {
     eos_info("msg=\"start disk synchronisation\" fsid=%u", fsid);
 
-    if (!gOFS.mFmdHandler->ResyncAllDisk(fs->GetPath().c_str(), fsid, resyncmgm)) {
+    if (!gOFS.mFmdHandler->ResyncAllDisk(fs->GetPath().c_str(), fsid, resyncmgm,
+                                         resync_opts)) {
       fs->SetStatus(eos::common::BootStatus::kBootFailure);
       fs->SetError(EFAULT, "cannot resync the DB from local disk");
       return;
@@ -817,7 +870,8 @@ Storage::Boot(FileSystem* fs)
       // Resync meta data connecting directly to QuarkDB
       eos_info("msg=\"synchronizing from QuarkDB backend\" fsid=%u", fsid);
 
-      if (!gOFS.mFmdHandler->ResyncAllFromQdb(gOFS.mQdbContactDetails, fsid)) {
+      if (!gOFS.mFmdHandler->ResyncAllFromQdb(gOFS.mQdbContactDetails, fsid,
+                                              resync_opts)) {
         fs->SetStatus(eos::common::BootStatus::kBootFailure);
         fs->SetError(EFAULT, "cannot resync meta data from QuarkDB");
         return;
@@ -832,6 +886,10 @@ Storage::Boot(FileSystem* fs)
     eos_info("msg=\"skip mgm resynchronization\" fsid=%u", fsid);
   }
 
+  if (resyncdisk || resyncmgm) {
+    fs->SetString("stat.resync.phase", "done");
+  }
+
   fs->SetLongLong("stat.bootdonetime", (unsigned long long) time(NULL));
   fs->IoPing();
   fs->SetStatus(eos::common::BootStatus::kBooted);
@@ -1109,6 +1167,10 @@ Storage::GetNumDeletions()
     total += (*it)->mFidVect.size();
   }
 
+  if (mDeletionExecutor) {
+    total += mDeletionExecutor->GetPending();
+  }
+
   return total;
 }
 
@@ -33,6 +33,7 @@
 #include "fst/Load.hh"
 #include "fst/Namespace.hh"
 #include "fst/filemd/FmdHandler.hh"
+#include "fst/utils/DeletionExecutor.hh"
 #include "namespace/ns_quarkdb/QdbContactDetails.hh"
 
 #include <atomic>
@@ -288,6 +289,8 @@ private:
   std::queue<eos::fst::Verify*> mVerifications;
   XrdSysMutex mDeletionsMutex;                         ///< Mutex protecting the list of deletions
   std::list<std::unique_ptr<Deletion>> mListDeletions; ///< List of deletions
+  //! Executor unlinking the files of the deletions taken from the list
+  std::unique_ptr<utils::DeletionExecutor> mDeletionExecutor;
   Load mFstLoad;                                       ///< Net/IO load monitor
   Health mFstHealth;                                   ///< Local disk S.M.A.R.T monitor
   AssistedThread mQdbCommunicatorThread;
@@ -454,6 +457,33 @@ private:
 
   void Scrub();
   void Remover();
+
+  //----------------------------------------------------------------------------
+  //! Delete one file scheduled for deletion and drop its replica at the MGM
+  //!
+  //! @param fsid file system identifier
+  //! @param fid file identifier
+  //!
+  //! @return true if the local file was removed, otherwise false
+  //----------------------------------------------------------------------------
+  bool DeleteFile(eos::common::FileSystem::fsid_t fsid,
+                  eos::common::FileId::fileid_t fid);
+
+  //----------------------------------------------------------------------------
+  //! Check if the file system is busy with client IO i.e. the disk is
+  //! highly utilized or client IO is being delayed by the traffic shaping,
+  //! used by the deletions to yield to the clients
+  //!
+  //! @param fsid file system identifier
+  //!
+  //! @return true if busy, otherwise false
+  //----------------------------------------------------------------------------
+  bool IsFsBusy(eos::common::FileSystem::fsid_t fsid);
+
+  //----------------------------------------------------------------------------
+  //! Get the deletion executor options from the environment
+  //----------------------------------------------------------------------------
+  static utils::DeletionExecutor::Options GetDeletionOptions();
   void Report();
   void Verify();
   void Publish(ThreadAssistant& assistant) noexcept;
@@ -461,6 +491,12 @@ private:
   void MgmSyncer();
   void Boot(fst::FileSystem* fs);
 
+  //----------------------------------------------------------------------------
+  //! Get the options of the boot resync from the node configuration i.e.
+  //! resync.nparallel and resync.ioprio
+  //----------------------------------------------------------------------------
+  FmdResyncOptions GetResyncOptions() const;
+
   //----------------------------------------------------------------------------
   //! Scrub filesystem
   //----------------------------------------------------------------------------
@@ -20,6 +20,7 @@
 #include "common/Logging.hh"
 #include "common/StringUtils.hh"
 #include "fst/filemd/FmdAttr.hh"
+#include "fst/filemd/FmdIndex.hh"
 #include "fst/utils/FSPathHandler.hh"
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/message.h>
@@ -191,6 +192,21 @@ main(int argc, char* argv[])
       return -1;
     }
 
+    // The xattr was changed behind the back of the FST, drop the Fmd index
+    // of the file system (<mount>/<hash dir>/<fid>) so that it gets rebuilt
+    // from the xattrs at the next boot
+    std::string mount = modify_path;
+
+    for (int i = 0; (i < 2) && (mount.rfind('/') != std::string::npos); ++i) {
+      mount.erase(mount.rfind('/'));
+    }
+
+    if (!mount.empty()) {
+      eos::fst::FmdIndex::Remove(mount);
+      std::cerr << "info: dropped the fmd index of mount=" << mount
+                << ", restart the FST to pick up the change" << std::endl;
+    }
+
     std::cout << fmd.mProtoFmd.DebugString() << std::endl;
   }
 
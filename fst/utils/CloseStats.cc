@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+// File: CloseStats.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/CloseStats.hh"
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+// Get size class for the given file size
+//------------------------------------------------------------------------------
+CloseStats::SizeClass
+CloseStats::GetSizeClass(uint64_t size)
+{
+  static constexpr uint64_t MB = 1024 * 1024;
+
+  if (size <= MB) {
+    return SizeClass::k1MB;
+  } else if (size <= 10 * MB) {
+    return SizeClass::k10MB;
+  } else if (size <= 100 * MB) {
+    return SizeClass::k100MB;
+  } else if (size <= 1024 * MB) {
+    return SizeClass::k1GB;
+  }
+
+  return SizeClass::k10GB;
+}
+
+//------------------------------------------------------------------------------
+// Get tag used when publishing the given size class
+//------------------------------------------------------------------------------
+const char*
+CloseStats::GetSizeClassTag(SizeClass sc)
+{
+  switch (sc) {
+  case SizeClass::k1MB:
+    return "1mb";
+
+  case SizeClass::k10MB:
+    return "10mb";
+
+  case SizeClass::k100MB:
+    return "100mb";
+
+  case SizeClass::k1GB:
+    return "1gb";
+
+  default:
+    return "10gb";
+  }
+}
+
+//------------------------------------------------------------------------------
+// Record the latency of a close operation
+//------------------------------------------------------------------------------
+void
+CloseStats::Add(uint64_t size, std::chrono::microseconds latency, bool async)
+{
+  const auto sc = static_cast<size_t>(GetSizeClass(size));
+  mLatency[sc].Add(latency.count() > 0 ? latency.count() : 0);
+
+  if (async) {
+    ++mAsyncCount;
+  } else {
+    ++mSyncCount;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Reserve a slot for a close in the asynchronous close thread pool
+//------------------------------------------------------------------------------
+bool
+CloseStats::TryAsyncQueue(uint64_t max_pending)
+{
+  int64_t pending = mAsyncPending.load();
+
+  do {
+    if (pending >= (int64_t) max_pending) {
+      ++mAsyncRejected;
+      return false;
+    }
+  } while (!mAsyncPending.compare_exchange_weak(pending, pending + 1));
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Add the close statistics to the given map used for publishing
+//------------------------------------------------------------------------------
+void
+CloseStats::Publish(std::map<std::string, std::string>& output) const
+{
+  output["stat.close.sync"] = std::to_string(mSyncCount.load());
+  output["stat.close.async"] = std::to_string(mAsyncCount.load());
+  output["stat.close.async.pending"] = std::to_string(mAsyncPending.load());
+  output["stat.close.async.rejected"] = std::to_string(mAsyncRejected.load());
+
+  for (size_t i = 0; i < static_cast<size_t>(SizeClass::kCount); ++i) {
+    const std::string prefix = std::string("stat.close.") +
+                               GetSizeClassTag(static_cast<SizeClass>(i));
+    // Latencies are recorded in microseconds and published in milliseconds
+    output[prefix + ".p50_ms"] = std::to_string(mLatency[i].GetPercentile(50) / 1000.0);
+    output[prefix + ".p99_ms"] = std::to_string(mLatency[i].GetPercentile(99) / 1000.0);
+  }
+}
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// File: CloseStats.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include "common/LatencyHistogram.hh"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+//! Class CloseStats - collects the latency of close operations for files
+//! opened for writing, classified by the final file size, and keeps track of
+//! the closes currently handled by the asynchronous close thread pool.
+//------------------------------------------------------------------------------
+class CloseStats
+{
+public:
+  //! File size classes for which latencies are tracked separately
+  enum class SizeClass : size_t {
+    k1MB = 0, k10MB, k100MB, k1GB, k10GB, kCount
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get size class for the given file size
+  //----------------------------------------------------------------------------
+  static SizeClass GetSizeClass(uint64_t size);
+
+  //----------------------------------------------------------------------------
+  //! Get tag used when publishing the given size class
+  //----------------------------------------------------------------------------
+  static const char* GetSizeClassTag(SizeClass sc);
+
+  //----------------------------------------------------------------------------
+  //! Record the latency of a close operation as observed by the client
+  //!
+  //! @param size final file size
+  //! @param latency time between the close request and the reply
+  //! @param async true if the close was delegated to the async thread pool
+  //----------------------------------------------------------------------------
+  void Add(uint64_t size, std::chrono::microseconds latency, bool async);
+
+  //----------------------------------------------------------------------------
+  //! Reserve a slot for a close in the asynchronous close thread pool. The
+  //! check against the limit and the reservation are done in one step so
+  //! that concurrent closes can not exceed the limit. If the backlog is full
+  //! the close is accounted as rejected i.e. handled synchronously.
+  //!
+  //! @param max_pending max number of closes pending in the thread pool
+  //!
+  //! @return true if the slot was reserved, otherwise false
+  //----------------------------------------------------------------------------
+  bool TryAsyncQueue(uint64_t max_pending);
+
+  //----------------------------------------------------------------------------
+  //! Mark a close as finished by the asynchronous close thread pool
+  //----------------------------------------------------------------------------
+  inline void
+  AsyncDone()
+  {
+    --mAsyncPending;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of closes currently pending in the async thread pool
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetAsyncPending() const
+  {
+    return mAsyncPending.load();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get latency histogram (in microseconds) for the given size class
+  //----------------------------------------------------------------------------
+  inline const eos::common::LatencyHistogram&
+  GetHistogram(SizeClass sc) const
+  {
+    return mLatency[static_cast<size_t>(sc)];
+  }
+
+  //----------------------------------------------------------------------------
+  //! Add the close statistics to the given map used for publishing
+  //!
+  //! @param output map to be populated with stat.close.* entries
+  //----------------------------------------------------------------------------
+  void Publish(std::map<std::string, std::string>& output) const;
+
+private:
+  std::array<eos::common::LatencyHistogram,
+             static_cast<size_t>(SizeClass::kCount)> mLatency;
+  std::atomic<uint64_t> mSyncCount {0};
+  std::atomic<uint64_t> mAsyncCount {0};
+  std::atomic<uint64_t> mAsyncRejected {0};
+  std::atomic<int64_t> mAsyncPending {0};
+};
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
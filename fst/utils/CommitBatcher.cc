@@ -0,0 +1,257 @@
+//------------------------------------------------------------------------------
+// File: CommitBatcher.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/CommitBatcher.hh"
+#include "common/SymKeys.hh"
+#include "common/StringUtils.hh"
+#include "common/Logging.hh"
+#include <map>
+#include <sstream>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+CommitBatcher::CommitBatcher(SendFunction send,
+                             std::chrono::milliseconds window,
+                             size_t max_items, size_t max_bytes):
+  mSend(std::move(send)), mWindow(window),
+  mMaxItems(max_items ? max_items : 1), mMaxBytes(max_bytes)
+{
+  mThread.reset(&CommitBatcher::Run, this);
+  mThread.setName("CommitBatcher");
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+CommitBatcher::~CommitBatcher()
+{
+  mThread.join();
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (auto& pending : mQueue) {
+    pending.mPromise.set_value(sNotDelivered);
+  }
+
+  mQueue.clear();
+}
+
+//------------------------------------------------------------------------------
+// Submit a commit to be sent in the next batch
+//------------------------------------------------------------------------------
+std::future<int>
+CommitBatcher::Submit(const std::string& manager, const std::string& item)
+{
+  PendingCommit pending;
+  pending.mManager = manager;
+  pending.mItem = item;
+  std::future<int> fut = pending.mPromise.get_future();
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mQueue.push_back(std::move(pending));
+  }
+  mCv.notify_one();
+  return fut;
+}
+
+//------------------------------------------------------------------------------
+// Build the batch request sent to the MGM for the given items
+//------------------------------------------------------------------------------
+std::string
+CommitBatcher::BuildRequest(const std::vector<std::string>& items)
+{
+  std::ostringstream oss;
+  oss << "/?mgm.pcmd=commitbatch&mgm.commit.n=" << items.size();
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    std::string encoded;
+
+    if (!eos::common::SymKey::Base64Encode(items[i].c_str(), items[i].length(),
+                                           encoded)) {
+      return std::string();
+    }
+
+    oss << "&mgm.commit." << i << "=" << encoded;
+  }
+
+  return oss.str();
+}
+
+//------------------------------------------------------------------------------
+// Parse the batch response received from the MGM
+//------------------------------------------------------------------------------
+bool
+CommitBatcher::ParseResponse(const std::string& response, size_t num_items,
+                             std::vector<int>& retcs)
+{
+  std::istringstream iss(response);
+  std::string token;
+  size_t num = 0;
+
+  if (!(iss >> token) || (token.find("n=") != 0) ||
+      !eos::common::StringToNumeric(token.substr(2), num) ||
+      (num != num_items)) {
+    return false;
+  }
+
+  retcs.assign(num_items, sNotDelivered);
+
+  while (iss >> token) {
+    // Skip informative key=value entries e.g. lock_us=<hold_time>
+    if (token.find('=') != std::string::npos) {
+      continue;
+    }
+
+    const size_t pos = token.find(':');
+    size_t index = 0;
+    int retc = 0;
+
+    if ((pos == std::string::npos) ||
+        !eos::common::StringToNumeric(token.substr(0, pos), index) ||
+        !eos::common::StringToNumeric(token.substr(pos + 1), retc) ||
+        (index >= num_items)) {
+      return false;
+    }
+
+    retcs[index] = retc;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Loop collecting and sending batches
+//------------------------------------------------------------------------------
+void
+CommitBatcher::Run(ThreadAssistant& assistant) noexcept
+{
+  assistant.registerCallback([this]() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCv.notify_all();
+  });
+
+  while (!assistant.terminationRequested()) {
+    std::vector<PendingCommit> commits;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mCv.wait(lock, [&]() {
+        return !mQueue.empty() || assistant.terminationRequested();
+      });
+
+      if (assistant.terminationRequested()) {
+        break;
+      }
+
+      // Give other commits the chance to join the batch
+      const auto deadline = std::chrono::steady_clock::now() + mWindow;
+      mCv.wait_until(lock, deadline, [&]() {
+        return (mQueue.size() >= mMaxItems) || assistant.terminationRequested();
+      });
+
+      while (!mQueue.empty()) {
+        commits.push_back(std::move(mQueue.front()));
+        mQueue.pop_front();
+      }
+    }
+    SendBatches(commits);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Send the given commits grouped per manager and respecting the size limits
+//------------------------------------------------------------------------------
+void
+CommitBatcher::SendBatches(std::vector<PendingCommit>& commits)
+{
+  std::map<std::string, std::vector<PendingCommit*>> per_manager;
+
+  for (auto& commit : commits) {
+    per_manager[commit.mManager].push_back(&commit);
+  }
+
+  for (auto& elem : per_manager) {
+    std::vector<PendingCommit*> batch;
+    size_t batch_bytes = 0;
+
+    for (auto* commit : elem.second) {
+      // Base64 encoding expands the payload by 4/3 plus the key overhead
+      const size_t item_bytes = ((commit->mItem.length() + 2) / 3) * 4 + 24;
+
+      if (!batch.empty() && ((batch.size() >= mMaxItems) ||
+                             (batch_bytes + item_bytes > mMaxBytes))) {
+        SendOne(elem.first, batch);
+        batch.clear();
+        batch_bytes = 0;
+      }
+
+      batch.push_back(commit);
+      batch_bytes += item_bytes;
+    }
+
+    if (!batch.empty()) {
+      SendOne(elem.first, batch);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Send one batch of commits for the same manager
+//------------------------------------------------------------------------------
+void
+CommitBatcher::SendOne(const std::string& manager,
+                       std::vector<PendingCommit*>& batch)
+{
+  std::vector<std::string> items;
+  items.reserve(batch.size());
+
+  for (const auto* commit : batch) {
+    items.push_back(commit->mItem);
+  }
+
+  std::vector<int> retcs;
+  std::string response;
+  const std::string request = BuildRequest(items);
+
+  if (request.empty() || mSend(manager, request, response) ||
+      !ParseResponse(response, batch.size(), retcs)) {
+    eos_static_warning("msg=\"commit batch not delivered, fall back to single "
+                       "commits\" manager=\"%s\" items=%zu response=\"%s\"",
+                       manager.c_str(), batch.size(), response.c_str());
+    retcs.assign(batch.size(), sNotDelivered);
+  } else {
+    ++mNumBatches;
+    mNumCommits += batch.size();
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i]->mPromise.set_value(retcs[i]);
+  }
+}
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+// File: CommitBatcher.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include "common/AssistedThread.hh"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+//! Class CommitBatcher - aggregates the MGM commit requests issued by file
+//! closes during a short time window and sends them to the MGM as a single
+//! "commitbatch" request. The MGM applies all the items of a batch under one
+//! namespace lock acquisition and replies with a result code per item.
+//!
+//! While one batch is in flight new commits keep accumulating, therefore the
+//! batch size adapts naturally to the commit rate and the MGM latency.
+//------------------------------------------------------------------------------
+class CommitBatcher
+{
+public:
+  //! Return code of a commit which was not delivered as part of a batch e.g.
+  //! MGM does not support batching, the caller should do a single commit
+  static constexpr int sNotDelivered = -1;
+
+  //----------------------------------------------------------------------------
+  //! Function used to send a batch request to the given manager. It returns
+  //! 0 if successful and fills in the response, otherwise an error code.
+  //----------------------------------------------------------------------------
+  using SendFunction = std::function<int(const std::string& manager,
+                                         const std::string& request,
+                                         std::string& response)>;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param send function used to send a batch request to the MGM
+  //! @param window max time a commit waits for other commits to join the batch
+  //! @param max_items max number of commits in one batch
+  //! @param max_bytes max size of one batch request, needs to stay below the
+  //!        opaque length accepted by the MGM fsctl
+  //----------------------------------------------------------------------------
+  CommitBatcher(SendFunction send, std::chrono::milliseconds window,
+                size_t max_items = 64, size_t max_bytes = 15 * 1024);
+
+  //----------------------------------------------------------------------------
+  //! Destructor - fails all the commits still pending with sNotDelivered
+  //----------------------------------------------------------------------------
+  ~CommitBatcher();
+
+  //----------------------------------------------------------------------------
+  //! Submit a commit to be sent in the next batch
+  //!
+  //! @param manager MGM endpoint host:port, empty means default manager
+  //! @param item commit opaque information i.e. mgm.* key value pairs
+  //!
+  //! @return future holding 0 if commit successful, errno if the commit
+  //!         failed at the MGM or sNotDelivered if the batch request failed
+  //----------------------------------------------------------------------------
+  std::future<int> Submit(const std::string& manager, const std::string& item);
+
+  //----------------------------------------------------------------------------
+  //! Check if the result of a commit means that the MGM rejected the replica
+  //! for good i.e. file already removed, size or checksum mismatch or an
+  //! overlapping atomic upload, in which case the local replica is unlinked.
+  //! Applies both to single and batched commits.
+  //!
+  //! @param retc commit result code
+  //----------------------------------------------------------------------------
+  static inline bool
+  IsReplicaRejected(int retc)
+  {
+    return ((retc == EIDRM) || (retc == EBADE) || (retc == EBADR) ||
+            (retc == EREMCHG));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Build the batch request sent to the MGM for the given items
+  //----------------------------------------------------------------------------
+  static std::string BuildRequest(const std::vector<std::string>& items);
+
+  //----------------------------------------------------------------------------
+  //! Parse the batch response received from the MGM
+  //!
+  //! @param response MGM response "n=<num> [key=val ...] <index>:<retc> ..."
+  //! @param num_items expected number of items
+  //! @param retcs per item return code
+  //!
+  //! @return true if response is valid, otherwise false
+  //----------------------------------------------------------------------------
+  static bool ParseResponse(const std::string& response, size_t num_items,
+                            std::vector<int>& retcs);
+
+  //----------------------------------------------------------------------------
+  //! Get number of batches sent and of commits handled
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetNumBatches() const
+  {
+    return mNumBatches.load();
+  }
+
+  inline uint64_t
+  GetNumCommits() const
+  {
+    return mNumCommits.load();
+  }
+
+private:
+  //! Commit waiting to be sent
+  struct PendingCommit {
+    std::string mManager;
+    std::string mItem;
+    std::promise<int> mPromise;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Loop collecting and sending batches
+  //----------------------------------------------------------------------------
+  void Run(ThreadAssistant& assistant) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Send the given commits grouped per manager and respecting the size limits
+  //----------------------------------------------------------------------------
+  void SendBatches(std::vector<PendingCommit>& commits);
+
+  //----------------------------------------------------------------------------
+  //! Send one batch of commits for the same manager
+  //----------------------------------------------------------------------------
+  void SendOne(const std::string& manager,
+               std::vector<PendingCommit*>& batch);
+
+  SendFunction mSend;
+  const std::chrono::milliseconds mWindow;
+  const size_t mMaxItems;
+  const size_t mMaxBytes;
+  std::mutex mMutex;
+  std::condition_variable mCv;
+  std::deque<PendingCommit> mQueue;
+  std::atomic<uint64_t> mNumBatches {0};
+  std::atomic<uint64_t> mNumCommits {0};
+  AssistedThread mThread; ///< Must be the last member
+};
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,261 @@
+//------------------------------------------------------------------------------
+// File: DeletionExecutor.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/DeletionExecutor.hh"
+#include "fst/utils/IoPriority.hh"
+#include "common/Logging.hh"
+#include <algorithm>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+DeletionExecutor::DeletionExecutor(DeleteFn delete_fn, BusyFn busy_fn,
+                                   const Options& opts):
+  mDeleteFn(std::move(delete_fn)), mBusyFn(std::move(busy_fn)), mOpts(opts),
+  mRateLastTs(std::chrono::steady_clock::now())
+{
+  mOpts.mNumThreads = std::max(mOpts.mNumThreads, 1u);
+  mOpts.mMaxPerFs = std::max(mOpts.mMaxPerFs, 1u);
+  mOpts.mBatchSize = std::max(mOpts.mBatchSize, 1u);
+
+  for (uint32_t i = 0; i < mOpts.mNumThreads; ++i) {
+    mWorkers.emplace_back(&DeletionExecutor::Worker, this);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+DeletionExecutor::~DeletionExecutor()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+// Stop the workers
+//------------------------------------------------------------------------------
+void
+DeletionExecutor::Stop()
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mCondWork.notify_all();
+
+  for (auto& worker : mWorkers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Queue files for deletion
+//------------------------------------------------------------------------------
+void
+DeletionExecutor::Submit(uint32_t fsid,
+                         const std::vector<unsigned long long>& fids)
+{
+  if (fids.empty()) {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto& queue = mQueues[fsid];
+    queue.mFids.insert(queue.mFids.end(), fids.begin(), fids.end());
+    mPending += fids.size();
+  }
+  mCondWork.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Wait until all the queued deletions are done or the timeout expires
+//------------------------------------------------------------------------------
+bool
+DeletionExecutor::WaitIdle(std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mCondIdle.wait_for(lock, timeout, [&] {
+    return (mPending == 0);
+  });
+}
+
+//------------------------------------------------------------------------------
+// Get the number of deletions queued or in progress
+//------------------------------------------------------------------------------
+uint64_t
+DeletionExecutor::GetPending() const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mPending;
+}
+
+//------------------------------------------------------------------------------
+// Get the deletion rate since the previous call
+//------------------------------------------------------------------------------
+double
+DeletionExecutor::GetRate()
+{
+  using namespace std::chrono;
+  std::unique_lock<std::mutex> lock(mRateMutex);
+  const auto now = steady_clock::now();
+  const auto ms = duration_cast<milliseconds>(now - mRateLastTs).count();
+
+  if (ms >= 1000) {
+    const uint64_t count = mNumDeleted.load() + mNumFailed.load();
+    mRate = ((count - mRateLastCount) * 1000.0) / ms;
+    mRateLastCount = count;
+    mRateLastTs = now;
+  }
+
+  return mRate;
+}
+
+//------------------------------------------------------------------------------
+// Add the deletion statistics to the given map used for publishing
+//------------------------------------------------------------------------------
+void
+DeletionExecutor::Publish(std::map<std::string, std::string>& output)
+{
+  char rate[32];
+  snprintf(rate, sizeof(rate), "%.02f", GetRate());
+  output["stat.deletion.pending"] = std::to_string(GetPending());
+  output["stat.deletion.rate"] = rate;
+  output["stat.deletion.done"] = std::to_string(GetNumDeleted());
+  output["stat.deletion.failed"] = std::to_string(GetNumFailed());
+  output["stat.deletion.yields"] = std::to_string(GetNumYields());
+}
+
+//------------------------------------------------------------------------------
+// Pick the file system to take the next batch from
+//------------------------------------------------------------------------------
+std::map<uint32_t, DeletionExecutor::FsQueue>::iterator
+DeletionExecutor::PickFs(std::chrono::steady_clock::time_point now,
+                         std::chrono::steady_clock::time_point& wake_up)
+{
+  auto pick = mQueues.end();
+
+  for (auto it = mQueues.begin(); it != mQueues.end(); ++it) {
+    auto& queue = it->second;
+
+    if (queue.mFids.empty() ||
+        (queue.mActive >= (queue.mBusy ? 1u : mOpts.mMaxPerFs))) {
+      continue;
+    }
+
+    if (queue.mBackoffUntil > now) {
+      wake_up = std::min(wake_up, queue.mBackoffUntil);
+      continue;
+    }
+
+    if ((pick == mQueues.end()) ||
+        (queue.mFids.size() > pick->second.mFids.size())) {
+      pick = it;
+    }
+  }
+
+  return pick;
+}
+
+//------------------------------------------------------------------------------
+// Worker loop
+//------------------------------------------------------------------------------
+void
+DeletionExecutor::Worker()
+{
+  using namespace std::chrono;
+
+  if (mOpts.mIoPriority && ioprio_set(IOPRIO_WHO_PROCESS, mOpts.mIoPriority)) {
+    eos_static_err("msg=\"failed to set deletion worker io priority\" "
+                   "prio=%i errno=%i", mOpts.mIoPriority, errno);
+  }
+
+  std::vector<unsigned long long> batch;
+  batch.reserve(mOpts.mBatchSize);
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  while (!mStop) {
+    const auto now = steady_clock::now();
+    auto wake_up = steady_clock::time_point::max();
+    auto it = PickFs(now, wake_up);
+
+    if (it == mQueues.end()) {
+      if (wake_up == steady_clock::time_point::max()) {
+        mCondWork.wait(lock);
+      } else {
+        mCondWork.wait_until(lock, wake_up);
+      }
+
+      continue;
+    }
+
+    const uint32_t fsid = it->first;
+    auto& fids = it->second.mFids;
+    const size_t count = std::min<size_t>(fids.size(), mOpts.mBatchSize);
+    batch.assign(fids.begin(), fids.begin() + count);
+    fids.erase(fids.begin(), fids.begin() + count);
+    ++it->second.mActive;
+    lock.unlock();
+
+    for (const auto fid : batch) {
+      if (mDeleteFn(fsid, fid)) {
+        ++mNumDeleted;
+      } else {
+        ++mNumFailed;
+      }
+    }
+
+    const bool busy = (mBusyFn && mBusyFn(fsid));
+    lock.lock();
+    // The queue entry is never erased while a batch is active
+    auto& queue = mQueues[fsid];
+    --queue.mActive;
+    queue.mBusy = busy;
+    mPending -= batch.size();
+
+    if (busy) {
+      queue.mBackoffUntil = steady_clock::now() + mOpts.mBackoff;
+      ++mNumYields;
+    }
+
+    // Keep the busy state around so that new deletions on a busy file system
+    // don't start at full concurrency
+    if (queue.mFids.empty() && (queue.mActive == 0) && !busy) {
+      mQueues.erase(fsid);
+    }
+
+    mCondIdle.notify_all();
+    // Other workers might have been waiting for this file system
+    mCondWork.notify_all();
+  }
+}
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
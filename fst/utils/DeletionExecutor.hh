@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+// File: DeletionExecutor.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+//! Class DeletionExecutor - removes the files scheduled for deletion using a
+//! pool of worker threads. The file ids are queued per file system and the
+//! workers take them in batches, running at most a given number of batches
+//! per file system at the same time so that one disk is not flooded with
+//! unlinks while the others are idle.
+//!
+//! After every batch the executor asks whether the file system is busy
+//! serving clients. If so, only one batch at a time runs on it and the
+//! next batch starts after a back-off period. The worker threads can also
+//! run with a lower IO priority.
+//------------------------------------------------------------------------------
+class DeletionExecutor
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Function deleting one file, returns true if successful
+  //----------------------------------------------------------------------------
+  using DeleteFn = std::function<bool(uint32_t fsid, uint64_t fid)>;
+
+  //----------------------------------------------------------------------------
+  //! Function returning true if the given file system is busy with client IO
+  //----------------------------------------------------------------------------
+  using BusyFn = std::function<bool(uint32_t fsid)>;
+
+  //! Executor options
+  struct Options {
+    uint32_t mNumThreads {16}; ///< Total number of worker threads
+    uint32_t mMaxPerFs {2}; ///< Max concurrent batches per file system
+    uint32_t mBatchSize {128}; ///< Max number of files per batch
+    int mIoPriority {0}; ///< IO priority of the workers, 0 keeps the default
+    //! Pause between two batches on a busy file system
+    std::chrono::milliseconds mBackoff {200};
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param delete_fn function deleting one file
+  //! @param busy_fn function checking the client load of a file system, if
+  //!        null then the executor never yields
+  //! @param opts executor options
+  //----------------------------------------------------------------------------
+  DeletionExecutor(DeleteFn delete_fn, BusyFn busy_fn, const Options& opts);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~DeletionExecutor();
+
+  //----------------------------------------------------------------------------
+  //! Stop the workers once their current batch is done, the queued
+  //! deletions are dropped
+  //----------------------------------------------------------------------------
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  //! Queue files for deletion
+  //!
+  //! @param fsid file system identifier
+  //! @param fids file identifiers
+  //----------------------------------------------------------------------------
+  void Submit(uint32_t fsid, const std::vector<unsigned long long>& fids);
+
+  //----------------------------------------------------------------------------
+  //! Wait until all the queued deletions are done or the timeout expires
+  //!
+  //! @return true if no more deletions are pending, otherwise false
+  //----------------------------------------------------------------------------
+  bool WaitIdle(std::chrono::milliseconds timeout);
+
+  //----------------------------------------------------------------------------
+  //! Get the number of deletions queued or in progress
+  //----------------------------------------------------------------------------
+  uint64_t GetPending() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the number of successful and failed deletions so far
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetNumDeleted() const
+  {
+    return mNumDeleted.load();
+  }
+
+  inline uint64_t
+  GetNumFailed() const
+  {
+    return mNumFailed.load();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the number of times a busy file system made the executor back off
+  //----------------------------------------------------------------------------
+  inline uint64_t
+  GetNumYields() const
+  {
+    return mNumYields.load();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the deletion rate in Hz since the previous call, refreshed at most
+  //! once per second
+  //----------------------------------------------------------------------------
+  double GetRate();
+
+  //----------------------------------------------------------------------------
+  //! Add the deletion statistics to the given map used for publishing
+  //!
+  //! @param output map to be populated with stat.deletion.* entries
+  //----------------------------------------------------------------------------
+  void Publish(std::map<std::string, std::string>& output);
+
+private:
+#ifdef IN_TEST_HARNESS
+public:
+#endif
+  //! Deletions pending on one file system
+  struct FsQueue {
+    std::deque<unsigned long long> mFids;
+    uint32_t mActive {0}; ///< Number of batches in progress
+    bool mBusy {false}; ///< File system reported busy after the last batch
+    //! Time before which no new batch is started
+    std::chrono::steady_clock::time_point mBackoffUntil;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Worker loop
+  //----------------------------------------------------------------------------
+  void Worker();
+
+  //----------------------------------------------------------------------------
+  //! Pick the file system to take the next batch from, the one with the
+  //! largest backlog among those allowed to run one more batch. Called with
+  //! mMutex locked.
+  //!
+  //! @param now current time
+  //! @param wake_up updated with the earliest end of a back-off period
+  //!
+  //! @return file system queue or end of the map if none
+  //----------------------------------------------------------------------------
+  std::map<uint32_t, FsQueue>::iterator
+  PickFs(std::chrono::steady_clock::time_point now,
+         std::chrono::steady_clock::time_point& wake_up);
+
+  DeleteFn mDeleteFn;
+  BusyFn mBusyFn;
+  Options mOpts;
+  mutable std::mutex mMutex;
+  std::condition_variable mCondWork; ///< Signalled when work is available
+  std::condition_variable mCondIdle; ///< Signalled when a batch is done
+  std::map<uint32_t, FsQueue> mQueues;
+  uint64_t mPending {0}; ///< Deletions queued or in progress
+  bool mStop {false};
+  std::atomic<uint64_t> mNumDeleted {0};
+  std::atomic<uint64_t> mNumFailed {0};
+  std::atomic<uint64_t> mNumYields {0};
+  std::mutex mRateMutex;
+  uint64_t mRateLastCount {0};
+  std::chrono::steady_clock::time_point mRateLastTs;
+  double mRate {0.0};
+  std::vector<std::thread> mWorkers;
+};
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+// File: PipelineStage.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+//! Class PipelineStage - stage of a processing pipeline made of a bounded
+//! queue served by a fixed number of worker threads. The producer blocks
+//! once the queue is full, so a fast stage e.g. the directory walk can not
+//! run arbitrarily ahead of a slower one e.g. the metadata updates.
+//------------------------------------------------------------------------------
+template <typename T>
+class PipelineStage
+{
+public:
+  using ProcessFn = std::function<void(T&)>;
+  using InitFn = std::function<void()>;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param num_workers number of worker threads, at least one is started
+  //! @param capacity maximum number of queued items
+  //! @param process_fn function applied to every item
+  //! @param init_fn optional function run by every worker when starting e.g.
+  //!        to set its IO priority
+  //----------------------------------------------------------------------------
+  PipelineStage(uint32_t num_workers, size_t capacity, ProcessFn process_fn,
+                InitFn init_fn = nullptr):
+    mCapacity(capacity ? capacity : 1), mProcessFn(std::move(process_fn)),
+    mInitFn(std::move(init_fn))
+  {
+    for (uint32_t i = 0; i < std::max(num_workers, 1u); ++i) {
+      mWorkers.emplace_back(&PipelineStage::Worker, this);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Destructor - processes the queued items and joins the workers
+  //----------------------------------------------------------------------------
+  ~PipelineStage()
+  {
+    Finish();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Queue an item, blocking while the queue is full
+  //----------------------------------------------------------------------------
+  void Push(T&& item)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondFull.wait(lock, [&] {
+      return mQueue.size() < mCapacity;
+    });
+    mQueue.push_back(std::move(item));
+    mCondEmpty.notify_one();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Wait for all the queued items to be processed and join the workers, no
+  //! more items can be pushed afterwards
+  //----------------------------------------------------------------------------
+  void Finish()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mDone = true;
+    }
+    mCondEmpty.notify_all();
+
+    for (auto& worker : mWorkers) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the number of items processed so far
+  //----------------------------------------------------------------------------
+  uint64_t GetProcessed() const
+  {
+    return mProcessed.load();
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Worker loop
+  //----------------------------------------------------------------------------
+  void Worker()
+  {
+    if (mInitFn) {
+      mInitFn();
+    }
+
+    while (true) {
+      T item;
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondEmpty.wait(lock, [&] {
+          return mDone || !mQueue.empty();
+        });
+
+        if (mQueue.empty()) {
+          return;
+        }
+
+        item = std::move(mQueue.front());
+        mQueue.pop_front();
+      }
+      mCondFull.notify_one();
+      mProcessFn(item);
+      ++mProcessed;
+    }
+  }
+
+  const size_t mCapacity;
+  ProcessFn mProcessFn;
+  InitFn mInitFn;
+  std::mutex mMutex;
+  std::condition_variable mCondEmpty; ///< Signalled when items are queued
+  std::condition_variable mCondFull; ///< Signalled when items are taken
+  std::deque<T> mQueue;
+  bool mDone {false};
+  std::atomic<uint64_t> mProcessed {0};
+  std::vector<std::thread> mWorkers;
+};
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
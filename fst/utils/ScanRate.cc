@@ -95,8 +95,10 @@ ScanRateLimiter::AdjustRate()
     if (mRate > sMinRate) {
       mRate = std::max(sMinRate, (int)(0.9 * mRate));
     }
-  } else if (mMaxRate) {
-    mRate = mMaxRate;
+  } else if (mMaxRate && (load < 0.5) && (mRate < mMaxRate)) {
+    // Recover in steps of 10% of the maximum rate, jumping straight back to
+    // it would saturate the disk again and make the rate oscillate
+    mRate = std::min(mMaxRate, mRate + std::max(1, mMaxRate / 10));
   }
 }
 
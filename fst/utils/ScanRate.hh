@@ -56,8 +56,8 @@ public:
   //!        limiting is disabled
   //! @param fst_load load object, if null then no rate adjustment is done
   //! @param dir_path path of the mountpoint being scanned
-  //! @param max_rate maximum allowed scan rate in MB/s, restored whenever the
-  //!        disk load drops below the threshold, 0 disables the restore
+  //! @param max_rate maximum allowed scan rate in MB/s, gradually restored
+  //!        while the disk load stays low, 0 disables the restore
   //----------------------------------------------------------------------------
   ScanRateLimiter(int rate, Load* fst_load = nullptr, const std::string& dir_path = "",
                   int max_rate = 0);
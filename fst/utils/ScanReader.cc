@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+// File: ScanReader.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/ScanReader.hh"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#define O_DIRECT 0
+#endif
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ScanReader::ScanReader(char* buff1, char* buff2, uint32_t buff_sz):
+  mBuff{buff1, buff2}, mBuffSz(buff_sz)
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ScanReader::~ScanReader()
+{
+  if (mThread.joinable()) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mTerminate = true;
+    }
+    mCond.notify_all();
+    mThread.join();
+  }
+
+  if (mFd >= 0) {
+    (void) close(mFd);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the next chunk of the file
+//------------------------------------------------------------------------------
+int64_t
+ScanReader::Next(char*& data, off_t& offset)
+{
+  data = nullptr;
+  offset = mOffset;
+
+  if (mDone) {
+    return 0;
+  }
+
+  int64_t nread = 0;
+
+  if (!mThread.joinable()) {
+    // Inline read, the read-ahead thread is started only if the first read
+    // filled the whole buffer i.e. there is more data to come
+    nread = mReadFunc(mOffset, mBuff[0], mBuffSz);
+    data = mBuff[0];
+
+    if (!mStarted && mBuff[1] && (nread == (int64_t)mBuffSz)) {
+      // Buffer 0 is held by the caller until the next call
+      mResult[0] = nread;
+      mCurrent = 1;
+      mThread = std::thread(&ScanReader::ReadAhead, this);
+    }
+  } else {
+    std::unique_lock<std::mutex> lock(mMutex);
+    // Release the buffer handed out by the previous call
+    mResult[mCurrent ^ 1] = -1;
+    mCond.notify_all();
+    mCond.wait(lock, [&] {
+      return (mResult[mCurrent] != -1);
+    });
+    // Errors are stored as -2 to distinguish them from an empty buffer
+    nread = (mResult[mCurrent] == -2) ? -1 : mResult[mCurrent];
+    data = mBuff[mCurrent];
+    mCurrent ^= 1;
+  }
+
+  mStarted = true;
+
+  if (nread > 0) {
+    mOffset += nread;
+  } else {
+    mDone = true;
+  }
+
+  return nread;
+}
+
+//------------------------------------------------------------------------------
+// Helper thread loop reading ahead into the free buffer
+//------------------------------------------------------------------------------
+void
+ScanReader::ReadAhead()
+{
+  int idx = 1;
+  off_t offset = mBuffSz;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mCond.wait(lock, [&] {
+        return mTerminate || (mResult[idx] == -1);
+      });
+
+      if (mTerminate) {
+        return;
+      }
+    }
+
+    int64_t nread = mReadFunc(offset, mBuff[idx], mBuffSz);
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mResult[idx] = (nread < 0) ? -2 : nread;
+    }
+    mCond.notify_all();
+
+    if (nread <= 0) {
+      return;
+    }
+
+    offset += nread;
+    idx ^= 1;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Open a local file for scanning bypassing the page cache
+//------------------------------------------------------------------------------
+bool
+ScanReader::OpenUncached(const std::string& path, bool try_direct)
+{
+  mIsDirect = false;
+
+  if (try_direct && O_DIRECT) {
+    mFd = open(path.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+
+    // EINVAL means that the file system does not support O_DIRECT e.g tmpfs
+    if ((mFd < 0) && (errno != EINVAL)) {
+      return false;
+    }
+
+    mIsDirect = (mFd >= 0);
+  }
+
+  if (mFd < 0) {
+    mFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (mFd < 0) {
+      return false;
+    }
+
+#ifndef __APPLE__
+    (void) posix_fadvise(mFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  }
+
+  const int fd = mFd;
+  const bool is_direct = mIsDirect;
+  mReadFunc = [fd, is_direct](off_t offset, char* buff, uint32_t len) {
+    int64_t nread = 0;
+
+    do {
+      nread = pread(fd, buff, len, offset);
+    } while ((nread < 0) && (errno == EINTR));
+
+#ifndef __APPLE__
+
+    // The scanner reads every file only once per pass, so keeping the data
+    // in the page cache would only evict the pages used by the clients
+    if (!is_direct && (nread > 0)) {
+      (void) posix_fadvise(fd, offset, nread, POSIX_FADV_DONTNEED);
+    }
+
+#endif
+    return nread;
+  };
+  return true;
+}
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
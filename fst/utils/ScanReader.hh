@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+// File: ScanReader.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+
+EOSFSTNAMESPACE_BEGIN
+
+namespace utils
+{
+
+//------------------------------------------------------------------------------
+//! Class ScanReader - sequential double-buffered reader used by the scanner.
+//!
+//! While the caller computes the checksums of one buffer, the next chunk of
+//! the file is read into the other buffer by a helper thread, so that the
+//! checksum computation overlaps with the disk IO. The helper thread is only
+//! started once the first read filled a whole buffer, therefore small files
+//! are read inline without any thread handover.
+//------------------------------------------------------------------------------
+class ScanReader
+{
+public:
+  //! Read callback: read at most len bytes at offset into buff and return the
+  //! number of bytes read, 0 at end of file or negative on error
+  using ReadFunc = std::function<int64_t(off_t offset, char* buff,
+                                         uint32_t len)>;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param buff1 first buffer
+  //! @param buff2 second buffer, if null then no read-ahead is done
+  //! @param buff_sz size of each of the buffers
+  //----------------------------------------------------------------------------
+  ScanReader(char* buff1, char* buff2, uint32_t buff_sz);
+
+  //----------------------------------------------------------------------------
+  //! Destructor - waits for any read in flight and closes the file
+  //----------------------------------------------------------------------------
+  ~ScanReader();
+
+  //----------------------------------------------------------------------------
+  //! Get the next chunk of the file. The returned buffer stays valid until the
+  //! next call.
+  //!
+  //! @param data set to the buffer holding the data
+  //! @param offset set to the file offset of the data
+  //!
+  //! @return number of bytes available, 0 at end of file or negative on error
+  //----------------------------------------------------------------------------
+  int64_t Next(char*& data, off_t& offset);
+
+  //----------------------------------------------------------------------------
+  //! Read through the given callback e.g. a remote io object
+  //----------------------------------------------------------------------------
+  inline void
+  SetReadFunc(ReadFunc read_func)
+  {
+    mReadFunc = std::move(read_func);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Open a local file for scanning bypassing the page cache. O_DIRECT is
+  //! tried first if requested and if not supported by the underlying file
+  //! system the file is read buffered and the pages read are dropped from
+  //! the cache once consumed.
+  //!
+  //! @param path local file path
+  //! @param try_direct if true try O_DIRECT, the buffers and their size must
+  //!        then be aligned to the transfer alignment of the file system
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool OpenUncached(const std::string& path, bool try_direct);
+
+  //----------------------------------------------------------------------------
+  //! Check if the file is read with O_DIRECT
+  //----------------------------------------------------------------------------
+  inline bool
+  IsDirect() const
+  {
+    return mIsDirect;
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Helper thread loop reading ahead into the free buffer
+  //----------------------------------------------------------------------------
+  void ReadAhead();
+
+  ReadFunc mReadFunc;
+  int mFd {-1}; ///< Descriptor opened by OpenUncached
+  bool mIsDirect {false}; ///< True if mFd uses O_DIRECT
+  char* mBuff[2];
+  uint32_t mBuffSz;
+  off_t mOffset {0}; ///< Offset of the next chunk handed to the caller
+  int mCurrent {0}; ///< Buffer index of the next chunk handed to the caller
+  bool mStarted {false}; ///< True once the first chunk was handed out
+  bool mDone {false}; ///< True once the end of file or an error was reached
+  std::thread mThread; ///< Read-ahead thread
+  std::mutex mMutex;
+  std::condition_variable mCond;
+  //! Per buffer state, -1 empty, -2 read error, otherwise the bytes read
+  int64_t mResult[2] {-1, -1};
+  bool mTerminate {false}; ///< Tell the read-ahead thread to exit
+};
+
+} // namespace utils
+
+EOSFSTNAMESPACE_END
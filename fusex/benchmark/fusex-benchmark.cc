@@ -3,6 +3,7 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
@@ -10,6 +11,8 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <atomic>
+#include <thread>
 
 #include "common/ShellCmd.hh"
 #include "common/Timing.hh"
@@ -36,6 +39,10 @@
 #define LOOP_21 10000
 #define LOOP_22 5
 #define LOOP_23 260
+#define LOOP_25 1000
+#define LOOP_26 2000
+#define LOOP_27 1000
+#define LOOP_27_OPS 20000
 // Upper bound for the depth-probe loops below: it only needs to be a little
 // larger than the maximum namespace path depth (eos::common::Path::MAX_LEVELS)
 // so the probe reliably reaches ENAMETOOLONG and stops - it is not the depth we
@@ -1175,6 +1182,214 @@ int main(int argc, char* argv[])
     COMMONTIMING("deep-mv", &tm);
   }
 
+  // ------------------------------------------------------------------------ //
+  testno = 25;
+
+  if ((testno >= test_start) && (testno <= test_stop)) {
+    fprintf(stderr, ">>> test %04d\n", testno);
+
+    if (mkdir("test25", S_IRWXU)) {
+      fprintf(stderr, "[test=%03d] mkdir failed errno=%d\n", testno, errno);
+      exit(testno);
+    }
+
+    // small-file write throughput: 16kB files written with 512 byte writes as
+    // done by compilers and many scripting tools
+    char wbuf[512];
+    memset(wbuf, 'w', sizeof(wbuf));
+    eos::common::Timing wtm("small-write");
+    COMMONTIMING("start", &wtm);
+
+    for (size_t i = 0; i < LOOP_25; i++) {
+      snprintf(name, sizeof(name), "test25/small-%lu", i);
+      int fd = open(name, O_CREAT | O_TRUNC | O_WRONLY, S_IRWXU);
+
+      if (fd < 0) {
+        fprintf(stderr, "[test=%03d] creat failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+
+      for (size_t off = 0; off < 16384; off += sizeof(wbuf)) {
+        if (write(fd, wbuf, sizeof(wbuf)) != (ssize_t) sizeof(wbuf)) {
+          fprintf(stderr, "[test=%03d] write failed i=%lu off=%lu\n", testno, i, off);
+          exit(testno);
+        }
+      }
+
+      if (close(fd)) {
+        fprintf(stderr, "[test=%03d] close failed i=%lu errno=%d\n", testno, i,
+                errno);
+        exit(testno);
+      }
+    }
+
+    COMMONTIMING("stop", &wtm);
+    const double wsec = wtm.RealTime() / 1000.0;
+    fprintf(stderr, "[test=%03d] small-file write files=%d files/s=%.02f "
+            "MB/s=%.02f\n", testno, LOOP_25, wsec ? LOOP_25 / wsec : 0,
+            wsec ? (LOOP_25 * 16384.0) / wsec / 1000000.0 : 0);
+
+    for (size_t i = 0; i < LOOP_25; i++) {
+      snprintf(name, sizeof(name), "test25/small-%lu", i);
+
+      if (stat(name, &buf) || (buf.st_size != 16384)) {
+        fprintf(stderr, "[test=%03d] size mismatch i=%lu\n", testno, i);
+        exit(testno);
+      }
+    }
+
+    eos::common::ShellCmd removedir("rm -rf test25");
+    eos::common::cmd_status rc = removedir.wait(60);
+
+    if (rc.exit_code) {
+      fprintf(stderr, "[test=%03d] rm -r test25 dir failed\n", testno);
+      exit(testno);
+    }
+
+    COMMONTIMING("small-file-write", &tm);
+  }
+
+  // ------------------------------------------------------------------------ //
+  testno = 26;
+
+  if ((testno >= test_start) && (testno <= test_stop)) {
+    fprintf(stderr, ">>> test %04d\n", testno);
+    // build a source-tree like tarball on local disk and untar it into the mount
+    std::string tmpdir = "/tmp/fusex-benchmark-untar." + std::to_string(getpid());
+    std::string mkcmd = "mkdir -p " + tmpdir + "/src && cd " + tmpdir +
+                        "/src && for d in $(seq 0 19); do mkdir -p dir$d; "
+                        "for f in $(seq 0 " + std::to_string(LOOP_26 / 20 - 1) +
+                        "); do head -c $(( (d * 7919 + f * 104729) % 16384 )) "
+                        "/dev/urandom > "
+                        "dir$d/file$f.c; done; done && tar cf " + tmpdir +
+                        "/src.tar -C " + tmpdir + "/src .";
+    eos::common::ShellCmd mktar(mkcmd.c_str());
+    eos::common::cmd_status rc = mktar.wait(600);
+
+    if (rc.exit_code || mkdir("test26", S_IRWXU)) {
+      fprintf(stderr, "[test=%03d] preparing tarball failed\n", testno);
+      exit(testno);
+    }
+
+    eos::common::Timing utm("untar");
+    COMMONTIMING("start", &utm);
+    std::string untar = "tar xf " + tmpdir + "/src.tar -C test26";
+    eos::common::ShellCmd untarcmd(untar.c_str());
+    rc = untarcmd.wait(600);
+    COMMONTIMING("stop", &utm);
+
+    if (rc.exit_code) {
+      fprintf(stderr, "[test=%03d] untar failed\n", testno);
+      exit(testno);
+    }
+
+    const double usec = utm.RealTime() / 1000.0;
+    fprintf(stderr, "[test=%03d] untar files=%d seconds=%.02f files/s=%.02f\n",
+            testno, LOOP_26, usec, usec ? LOOP_26 / usec : 0);
+    std::string diff = "diff -r " + tmpdir + "/src test26";
+    eos::common::ShellCmd diffcmd(diff.c_str());
+    rc = diffcmd.wait(600);
+
+    if (rc.exit_code) {
+      fprintf(stderr, "[test=%03d] untarred tree differs from source\n", testno);
+      exit(testno);
+    }
+
+    std::string cleanup = "rm -rf test26 " + tmpdir;
+    eos::common::ShellCmd cleanupcmd(cleanup.c_str());
+    rc = cleanupcmd.wait(600);
+
+    if (rc.exit_code) {
+      fprintf(stderr, "[test=%03d] rm -r test26 dir failed\n", testno);
+      exit(testno);
+    }
+
+    COMMONTIMING("untar", &tm);
+  }
+
+  // ------------------------------------------------------------------------ //
+  testno = 27;
+
+  if ((testno >= test_start) && (testno <= test_stop)) {
+    fprintf(stderr, ">>> test %04d\n", testno);
+
+    if (mkdir("test27", S_IRWXU)) {
+      fprintf(stderr, "[test=%03d] mkdir failed errno=%d\n", testno, errno);
+      exit(testno);
+    }
+
+    for (size_t i = 0; i < LOOP_27; i++) {
+      snprintf(name, sizeof(name), "test27/f%lu.h", i);
+      int fd = open(name, O_CREAT | O_TRUNC | O_WRONLY, S_IRWXU);
+
+      if ((fd < 0) || close(fd)) {
+        fprintf(stderr, "[test=%03d] creat failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+    }
+
+    // stat/lookup storm as produced by a parallel build probing headers: every
+    // thread stats existing and missing files spread over the whole directory
+    for (size_t nthreads = 1; nthreads <= 128; nthreads *= 2) {
+      std::atomic<size_t> failed {0};
+      std::vector<std::thread> workers;
+      eos::common::Timing stm("stat-storm");
+      COMMONTIMING("start", &stm);
+
+      for (size_t t = 0; t < nthreads; t++) {
+        workers.emplace_back([t, &failed]() {
+          char fname[1024];
+          struct stat sbuf;
+
+          for (size_t i = 0; i < LOOP_27_OPS; i++) {
+            const size_t n = (i * 7919 + t * 104729) % LOOP_27;
+
+            if (i % 4) {
+              snprintf(fname, sizeof(fname), "test27/f%lu.h", n);
+
+              if (stat(fname, &sbuf)) {
+                ++failed;
+              }
+            } else {
+              snprintf(fname, sizeof(fname), "test27/missing%lu.h", n);
+
+              if (!stat(fname, &sbuf)) {
+                ++failed;
+              }
+            }
+          }
+        });
+      }
+
+      for (auto& w : workers) {
+        w.join();
+      }
+
+      COMMONTIMING("stop", &stm);
+
+      if (failed) {
+        fprintf(stderr, "[test=%03d] stat storm threads=%lu failed=%lu\n", testno,
+                nthreads, failed.load());
+        exit(testno);
+      }
+
+      const double ssec = stm.RealTime() / 1000.0;
+      fprintf(stderr, "[test=%03d] stat storm threads=%lu ops=%lu ops/s=%.02f\n",
+              testno, nthreads, nthreads * LOOP_27_OPS,
+              ssec ? (nthreads * LOOP_27_OPS) / ssec : 0);
+    }
+
+    eos::common::ShellCmd removedir("rm -rf test27");
+    eos::common::cmd_status rc = removedir.wait(60);
+
+    if (rc.exit_code) {
+      fprintf(stderr, "[test=%03d] rm -r test27 dir failed\n", testno);
+      exit(testno);
+    }
+
+    COMMONTIMING("stat-storm", &tm);
+  }
+
   tm.Print();
   fprintf(stdout, "realtime = %.02f\n", tm.RealTime());
 }
@@ -36,7 +36,8 @@ struct cacheconfig {
     total_file_cache_size = total_file_cache_inodes = per_file_cache_max_size =
                               total_file_journal_size = total_file_journal_inodes = per_file_journal_max_size
                                   = default_read_ahead_size = max_inflight_read_ahead_buffer_size =
-                                        max_inflight_write_buffer_size = max_read_ahead_size = 0 ;
+                                        max_inflight_write_buffer_size = max_read_ahead_size =
+                                              write_coalesce_size = 0 ;
     max_read_ahead_blocks = 0;
     read_ahead_sparse_ratio = 0;
     clean_threshold = 0;
@@ -55,6 +56,7 @@ struct cacheconfig {
   uint64_t default_read_ahead_size; // default start value for read-ahead
   uint64_t max_inflight_read_ahead_buffer_size; // max size of read-ahead-buffers
   uint64_t max_inflight_write_buffer_size; // max size of write buffers
+  uint64_t write_coalesce_size; // size of aligned upstream writes built from small sequential writes, 0 disables coalescing
   uint64_t max_read_ahead_size; // max value for read-ahead block size
   size_t max_read_ahead_blocks; // max  number of read-ahead blocks
   float clean_threshold; // filling percentage of the cache disk when we start to delete
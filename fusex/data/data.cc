@@ -334,6 +334,10 @@ data::datax::flush_nolock(fuse_req_t req, bool wait_open, bool wait_writes)
   bool journal_recovery = false;
   errno = 0;
 
+  if (flush_coalesced_nolock()) {
+    return errno ? errno : EIO;
+  }
+
   if (mFile->journal() && mFile->has_xrdiorw(req)) {
     eos_info("flushing journal");
     ssize_t truncate_size = mFile->journal()->get_truncatesize();
@@ -480,6 +484,121 @@ data::datax::flush_nolock(fuse_req_t req, bool wait_open, bool wait_writes)
   return 0;
 }
 
+/* -------------------------------------------------------------------------- */
+int
+/* -------------------------------------------------------------------------- */
+data::datax::flush_coalesced_nolock(size_t align)
+/* -------------------------------------------------------------------------- */
+{
+  // call this with a mLock locked
+  if (mWbBuffer.empty()) {
+    return 0;
+  }
+
+  size_t len = mWbBuffer.size();
+
+  if (align) {
+    // only send up to the last aligned offset, keep the tail for later writes
+    const uint64_t aligned_end = ((mWbOffset + len) / align) * align;
+
+    if (aligned_end <= (uint64_t) mWbOffset) {
+      return 0;
+    }
+
+    len = aligned_end - mWbOffset;
+  }
+
+  eos_debug("offset=%llu count=%lu", mWbOffset, len);
+
+  // a write recovery might have replaced the proxy in the meantime
+  if (mFile->has_xrdiorw(0) && (mFile->xrdiorw(0) != mWbProxy)) {
+    eos_info("msg=\"coalesced writes switch to the recovered proxy\"");
+    mWbProxy = mFile->xrdiorw(0);
+  }
+
+  XrdCl::shared_proxy proxy = mWbProxy;
+  XrdCl::Proxy::write_handler handler =
+    proxy->WriteAsyncPrepare(proxy, len, mWbOffset, 60);
+  XrdCl::XRootDStatus status =
+    proxy->ScheduleWriteAsync(mWbBuffer.data(), handler);
+  mWbBuffer.erase(mWbBuffer.begin(), mWbBuffer.begin() + len);
+  mWbOffset += len;
+
+  if (mWbBuffer.empty()) {
+    mWbProxy.reset();
+  }
+
+  while (proxy->HasTooManyWritesInFlight()) {
+    EosFuse::instance().datas.set_xoff();
+    mXoff = true;
+    std::string msg;
+
+    if (proxy->HadFailures(msg)) {
+      eos_err("file state failure during xoff - switching to sync mode msg='%s'",
+              msg.c_str());
+      mFlags |= O_SYNC;
+      break;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  mXoff = false;
+
+  if ((!status.IsOK()) && (!EosFuse::Instance().Config().recovery.write)) {
+    int error = XrdCl::Proxy::status2errno(status);
+    eos_err("async remote-io failed msg=\"%s\"", status.ToString().c_str());
+    reply_coalesced_nolock(error);
+    errno = error;
+    return -1;
+  }
+
+  reply_coalesced_nolock();
+  return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+void
+/* -------------------------------------------------------------------------- */
+data::datax::reply_coalesced_nolock(int error)
+/* -------------------------------------------------------------------------- */
+{
+  // call this with a mLock locked
+  size_t n = 0;
+
+  for (; n < mWbReplies.size(); ++n) {
+    if (error) {
+      fuse_reply_err(mWbReplies[n].req, error);
+    } else if (mWbReplies[n].end <= mWbOffset) {
+      fuse_reply_write(mWbReplies[n].req, mWbReplies[n].count);
+    } else {
+      break;
+    }
+  }
+
+  mWbReplies.erase(mWbReplies.begin(), mWbReplies.begin() + n);
+
+  if (error) {
+    // the data of the failed writes is not sent anymore
+    mWbBuffer.clear();
+    mWbProxy.reset();
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+void
+/* -------------------------------------------------------------------------- */
+data::datax::flush_coalesced_replies()
+/* -------------------------------------------------------------------------- */
+{
+  XrdSysMutexHelper lLock(mLock);
+
+  if (!mWbReplies.empty()) {
+    // failures are replied to the waiting writes
+    (void) flush_coalesced_nolock();
+  }
+}
+
 /* -------------------------------------------------------------------------- */
 int
 /* -------------------------------------------------------------------------- */
@@ -2082,11 +2201,18 @@ data::datax::detach(fuse_req_t req, std::string& cookie, int flags)
 
   eos_info("cookie=%s flags=%o isrw=%d", cookie.c_str(), flags, isRW);
   XrdSysMutexHelper lLock(mLock);
+
+  int xio = 0;
+
+  if (isRW && flush_coalesced_nolock()) {
+    xio = errno ? errno : EIO;
+    eos_err("coalesced writes failed errno=%d", xio);
+  }
+
   int bcache = mFile->file() ? mFile->file()->detach(cookie) : 0;
   int jcache = mFile->journal() ? ((isRW ||
                                     (mFlags & O_CACHE)) ? mFile->journal()->detach(
                                      cookie) : 0) : 0;
-  int xio = 0;
 
   if (isRW) {
     if (mFile->has_xrdiorw(req)) {
@@ -2138,6 +2264,11 @@ data::datax::pread(fuse_req_t req, void* buf, size_t count, off_t offset)
   eos_info("offset=%llu count=%lu", offset, count);
   mLock.Lock();
 
+  if (flush_coalesced_nolock()) {
+    mLock.UnLock();
+    return -1;
+  }
+
   if (mFile->journal()) {
     ssize_t jts = ((mFile->journal()))->get_truncatesize();
 
@@ -2324,7 +2455,8 @@ data::datax::pread(fuse_req_t req, void* buf, size_t count, off_t offset)
 /* -------------------------------------------------------------------------- */
 ssize_t
 /* -------------------------------------------------------------------------- */
-data::datax::pwrite(fuse_req_t req, const void* buf, size_t count, off_t offset)
+data::datax::pwrite(fuse_req_t req, const void* buf, size_t count, off_t offset,
+                    bool* reply_deferred)
 /* -------------------------------------------------------------------------- */
 {
   XrdSysMutexHelper lLock(mLock);
@@ -2391,6 +2523,48 @@ data::datax::pwrite(fuse_req_t req, const void* buf, size_t count, off_t offset)
       }
     }
 
+    // coalesce small sequential writes into large aligned upstream writes,
+    // the writes are replied only once their data was sent upstream
+    const size_t coalesce_size =
+      cachehandler::instance().get_config().write_coalesce_size;
+    const bool coalesce = reply_deferred && coalesce_size &&
+                          !(mFlags & O_SYNC) && (count < coalesce_size);
+
+    if (!mWbBuffer.empty() &&
+        (!coalesce || (mFile->xrdiorw(req) != mWbProxy) ||
+         (offset != (off_t)(mWbOffset + mWbBuffer.size())))) {
+      if (flush_coalesced_nolock()) {
+        return -1;
+      }
+    }
+
+    if (coalesce) {
+      if (mWbBuffer.empty()) {
+        mWbProxy = mFile->xrdiorw(req);
+        mWbOffset = offset;
+        mWbBuffer.reserve(coalesce_size);
+      }
+
+      mWbBuffer.insert(mWbBuffer.end(), (const char*) buf,
+                       (const char*) buf + count);
+
+      if (flush_coalesced_nolock(coalesce_size)) {
+        return -1;
+      }
+
+      if ((off_t)(offset + count) > mWbOffset) {
+        mWbReplies.push_back({req, count, (off_t)(offset + count)});
+        *reply_deferred = true;
+      }
+
+      if ((off_t)(offset + count) > mSize) {
+        mSize = count + offset;
+      }
+
+      eos_info("offset=%llu count=%lu result=%d coalesced", offset, count, dw);
+      return dw;
+    }
+
     // send an asynchronous upstream write, which does not wait for the file open to be done
     XrdCl::Proxy::write_handler handler =
       mFile->xrdiorw(req)->WriteAsyncPrepare(mFile->xrdiorw(req), count, offset, 60);
@@ -2519,6 +2693,8 @@ data::datax::peek_pread(fuse_req_t req, char*& buf, size_t count, off_t offset)
   }
   mLock.Lock();
   eos_info("offset=%llu count=%lu size=%lu", offset, count, md_size);
+  // write errors of coalesced writes are replied to the waiting writes
+  (void) flush_coalesced_nolock();
 
   if (mFile->journal()) {
     ssize_t jts = ((mFile->journal()))->get_truncatesize();
@@ -2812,6 +2988,10 @@ data::datax::truncate(fuse_req_t req, off_t offset)
   eos_info("offset=%llu size=%llu", offset, mSize);
   int dt = 0;
 
+  if (flush_coalesced_nolock()) {
+    return -1;
+  }
+
   if (inline_buffer) {
     if (inlined()) {
       if (((size_t) offset) < mInlineMaxSize) {
@@ -2880,6 +3060,13 @@ data::datax::sync()
 {
   eos_info("");
   int ds = 0;
+  {
+    XrdSysMutexHelper lLock(mLock);
+
+    if (flush_coalesced_nolock()) {
+      return -1;
+    }
+  }
 
   if (mFile->file()) {
     ds = mFile->file()->sync();
@@ -3219,6 +3406,9 @@ data::dmap::ioflush(ThreadAssistant& assistant)
       }
 
       for (auto it = data.begin(); it != data.end(); ++it) {
+        // coalesced writes are replied only once sent, so don't let them wait
+        // for more than one flush interval
+        (*it)->flush_coalesced_replies();
         {
           XrdSysMutexHelper lLock((*it)->Locker());
           eos_static_info("dbmap-in => ino:%16lx %lx attached=%d", (*it)->id(), &(*it),
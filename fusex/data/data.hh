@@ -50,6 +50,7 @@
 #include <exception>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
 class data
 {
@@ -68,7 +69,7 @@ public:
       mSimulateWriteErrorInFlusher(false),
       mFlags(0), mXoff(false), mIsInlined(false), mInlineMaxSize(0),
       mInlineCompressor("none"), mIsUnlinked(false),
-      mCanRecoverRead(true)
+      mCanRecoverRead(true), mWbOffset(0)
 
     {
       inline_buffer = nullptr;
@@ -80,7 +81,7 @@ public:
       mSimulateWriteErrorInFlusher(false),
       mFlags(0), mXoff(false),
       mIsInlined(false), mInlineMaxSize(0), mInlineCompressor("none"),
-      mIsUnlinked(false), mCanRecoverRead(true) { }
+      mIsUnlinked(false), mCanRecoverRead(true), mWbOffset(0) { }
 
     virtual ~datax()
     {
@@ -120,6 +121,14 @@ public:
     }
 
     int flush(fuse_req_t req);
+    // send coalesced writes upstream, with align only up to the last aligned
+    // offset - failures are also replied to the waiting writes
+    int flush_coalesced_nolock(size_t align = 0);
+    // reply the coalesced writes which have been sent upstream or all of them
+    // with the given error
+    void reply_coalesced_nolock(int error = 0);
+    // send all coalesced writes which wait for their reply
+    void flush_coalesced_replies();
     int flush_nolock(fuse_req_t req, bool wait_open = true,
                      bool wait_writes = false);
     bool is_wopen(fuse_req_t req);
@@ -143,7 +152,10 @@ public:
 
     // IO bridge interface
     ssize_t pread(fuse_req_t req, void* buf, size_t count, off_t offset);
-    ssize_t pwrite(fuse_req_t req, const void* buf, size_t count, off_t offset);
+    // if reply_deferred is given the write can be coalesced and then it is
+    // replied once its data was sent upstream, indicated by reply_deferred
+    ssize_t pwrite(fuse_req_t req, const void* buf, size_t count, off_t offset,
+                   bool* reply_deferred = 0);
     ssize_t peek_pread(fuse_req_t req, char*& buf, size_t count, off_t offset);
     void release_pread();
     int truncate(fuse_req_t req, off_t offset);
@@ -310,6 +322,19 @@ public:
     bufferllmanager::shared_buffer inline_buffer;
     bool mIsUnlinked;
     bool mCanRecoverRead;
+
+    // small sequential writes waiting to be sent upstream as one write
+    std::vector<char> mWbBuffer;
+    off_t mWbOffset;
+    XrdCl::shared_proxy mWbProxy;
+    // write requests waiting for their coalesced data to be sent upstream
+    struct wb_reply {
+      fuse_req_t req;
+      size_t count;
+      off_t end;
+    };
+
+    std::vector<wb_reply> mWbReplies;
   };
 
   typedef std::shared_ptr<datax> shared_data;
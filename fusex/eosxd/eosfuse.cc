@@ -853,6 +853,18 @@ EosFuse::run(int argc, char* argv[], void* userdata)
         root["options"]["data-kernelcache"] = 1;
       }
 
+      if (!root["options"].isMember("data-writeback-cache")) {
+        root["options"]["data-writeback-cache"] = 0;
+      }
+
+      if (!root["options"].isMember("md-persistent-cache")) {
+        root["options"]["md-persistent-cache"] = 0;
+      }
+
+      if (!root["options"].isMember("md-persistent-cache.grace")) {
+        root["options"]["md-persistent-cache.grace"] = 60;
+      }
+
       if (!root["options"].isMember("rename-is-sync")) {
         root["options"]["rename-is-sync"] = 1;
       }
@@ -1149,6 +1161,12 @@ EosFuse::run(int argc, char* argv[], void* userdata)
     config.options.md_backend_put_timeout =
       root["options"]["md-backend.put.timeout"].asDouble();
     config.options.data_kernelcache = root["options"]["data-kernelcache"].asInt();
+    config.options.data_writeback_cache =
+      (root["options"]["data-writeback-cache"].asInt() != 0);
+    config.options.md_persistent_cache =
+      (root["options"]["md-persistent-cache"].asInt() != 0);
+    config.options.md_persistent_cache_grace =
+      root["options"]["md-persistent-cache.grace"].asInt();
     config.options.rename_is_sync = root["options"]["rename-is-sync"].asInt();
     config.options.rmdir_is_sync = root["options"]["rmdir-is-sync"].asInt();
     config.options.global_flush = root["options"]["global-flush"].asInt();
@@ -1328,6 +1346,12 @@ EosFuse::run(int argc, char* argv[], void* userdata)
     // the store directory is the tree before we append individual UUIDs for each mount
     store_directory = config.mdcachedir;
 
+    // the persistent md cache lives next to it, it is neither cleaned on
+    // startup nor removed on exit
+    if (config.mdcachedir.length() && config.options.md_persistent_cache) {
+      config.mdpersistdir = store_directory + ".persistent";
+    }
+
     // default settings
     if (!config.statfilesuffix.length()) {
       config.statfilesuffix = "stats";
@@ -1455,6 +1479,12 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       root["cache"]["max-write-buffer"] = (Json::Value::UInt64)best_io_buffer_size;
     }
 
+    if (!root["cache"].isMember("write-coalesce-bytes")) {
+      // coalesce small writes by default only in write-back cache mode
+      root["cache"]["write-coalesce-bytes"] = (Json::Value::UInt64)
+                                              (config.options.data_writeback_cache ? 4 * 1024 * 1024 : 0);
+    }
+
     cconfig.location = root["cache"]["location"].asString();
     cconfig.journal = root["cache"]["journal"].asString();
     cconfig.default_read_ahead_size =
@@ -1477,6 +1507,12 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       root["cache"]["max-read-ahead-buffer"].asInt();
     cconfig.max_inflight_write_buffer_size =
       root["cache"]["max-write-buffer"].asInt();
+    cconfig.write_coalesce_size =
+      root["cache"]["write-coalesce-bytes"].asUInt64();
+
+    if (cconfig.write_coalesce_size > cconfig.max_inflight_write_buffer_size) {
+      cconfig.write_coalesce_size = cconfig.max_inflight_write_buffer_size;
+    }
 
     // set defaults for journal and file-start cache
     if (geteuid()) {
@@ -1672,8 +1708,14 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       (void) system(mk_credentialdir.c_str());
     }
 
+    if (config.mdpersistdir.length()) {
+      std::string mk_persistdir = "mkdir -p " + config.mdpersistdir;
+      (void) system(mk_persistdir.c_str());
+    }
+
     // make the cache directories private to root
     chmod_to_700_or_die(config.mdcachedir);
+    chmod_to_700_or_die(config.mdpersistdir);
     chmod_to_700_or_die(cconfig.journal);
     chmod_to_700_or_die(cconfig.location);
     chmod_to_700_or_die(config.auth.credentialStore);
@@ -2031,11 +2073,25 @@ EosFuse::run(int argc, char* argv[], void* userdata)
         mKV.reset(kv);
       }
 
+      if (!config.mdpersistdir.empty()) {
+        RocksKV* pkv = new RocksKV();
+
+        if (pkv->connect(config.name, config.mdpersistdir) != 0) {
+          // not fatal, we just start cold
+          fprintf(stderr, "warning: failed to open persistent md cache - path=%s\n",
+                  config.mdpersistdir.c_str());
+          delete pkv;
+        } else {
+          mPKV.reset(pkv);
+        }
+      }
+
 #endif // HAVE_ROCKSDB
       mdbackend.init(config.hostport, config.remotemountdir,
                      config.options.md_backend_timeout,
                      config.options.md_backend_put_timeout);
       mds.init(&mdbackend);
+      mds.persist_init(mPKV.get(), config.options.md_persistent_cache_grace);
       caps.init(&mdbackend, &mds);
       datas.init();
       eos::common::Mapping::Init();
@@ -2098,6 +2154,11 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       tStatCirculate.reset(&EosFuse::StatCirculate, this);
       tMetaCacheFlush.reset(&metad::mdcflush, &mds);
       tMetaStackFree.reset(&metad::mdstackfree, &mds);
+
+      if (mds.persist_enabled()) {
+        tMetaPersist.reset(&metad::mdpersist, &mds);
+      }
+
       tMetaCommunicate.reset(&metad::mdcommunicate, &mds);
       tMetaCallback.reset(&metad::mdcallback, &mds);
       tCapFlush.reset(&cap::capflush, &caps);
@@ -2163,6 +2224,12 @@ EosFuse::run(int argc, char* argv[], void* userdata)
                          config.options.inmemory_inodes,
                          config.options.flock
                         );
+      if (mds.persist_enabled()) {
+        eos_static_warning("md-persistent-cache    := %s grace=%ds",
+                           config.mdpersistdir.c_str(),
+                           config.options.md_persistent_cache_grace);
+      }
+
       eos_static_warning("cache                  := rh-type:%s rh-nom:%d rh-max:%d rh-blocks:%d rh-sparse-ratio:%.01f max-rh-buffer=%lu max-wr-buffer=%lu tot-size=%ld tot-ino=%ld jc-size=%ld jc-ino=%ld dc-loc:%s jc-loc:%s clean-thrs:%02f%%%",
                          cconfig.read_ahead_strategy.c_str(),
                          cconfig.default_read_ahead_size,
@@ -2183,6 +2250,9 @@ EosFuse::run(int argc, char* argv[], void* userdata)
                          config.recovery.read_open,
                          config.recovery.read_open_noserver,
                          config.recovery.read_open_noserver_retrywindow);
+      eos_static_warning("write-back             := kernel-cache:%d coalesce-bytes:%lu",
+                         config.options.data_writeback_cache,
+                         cconfig.write_coalesce_size);
       eos_static_warning("write-recovery         := enabled:%d wopen:%d wopen-noserv:%d wopen-noserv-window:%u",
                          config.recovery.write,
                          config.recovery.write_open,
@@ -2267,6 +2337,7 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       tStatCirculate.join();
       tMetaCacheFlush.join();
       tMetaStackFree.join();
+      tMetaPersist.join();
       tMetaCallback.join();
       tMetaCommunicate.join();
       tCapFlush.join();
@@ -2311,6 +2382,7 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       cmdet.Unlock();
       alarm(0);
       mKV.reset();
+      mPKV.reset();
 
       if (config.mdcachedir_unlink.length()) {
         // clean rocksdb directory
@@ -2417,11 +2489,22 @@ EosFuse::init(void* userdata, struct fuse_conn_info* conn)
   conn->want |= FUSE_CAP_EXPORT_SUPPORT | FUSE_CAP_POSIX_LOCKS;
   // We don't honor TRUNC on open, so require fuse to still send the truncate separately
   conn->want &= ~FUSE_CAP_ATOMIC_O_TRUNC;
-  // FUSE_CAP_WRITEBACK_CACHE => when we enable write back cache, inode invalidation does not work anymore, so don't enable it
   Instance().Config().options.writebackcache = true;
+
+  // FUSE_CAP_WRITEBACK_CACHE => when we enable write back cache the kernel
+  // keeps dirty pages and trusts its own file size, so it is only enabled on
+  // request and cached pages are invalidated explicitly on cap revocation
+  if (Instance().Config().options.data_writeback_cache &&
+      (conn->capable & FUSE_CAP_WRITEBACK_CACHE)) {
+    conn->want |= FUSE_CAP_WRITEBACK_CACHE;
+  } else {
+    Instance().Config().options.data_writeback_cache = false;
+  }
+
   //  conn->want |= FUSE_CAP_EXPORT_SUPPORT | FUSE_CAP_POSIX_LOCKS ; // | FUSE_CAP_CACHE_SYMLINKS;
 #else
   Instance().Config().options.writebackcache = false;
+  Instance().Config().options.data_writeback_cache = false;
   conn->want |= FUSE_CAP_EXPORT_SUPPORT | FUSE_CAP_POSIX_LOCKS |
                 FUSE_CAP_BIG_WRITES;
 #endif
@@ -2483,6 +2566,10 @@ EosFuse::DumpStatistic(ThreadAssistant& assistant)
                               XrdCl::Proxy::ReadAsyncHandler::nexpired();
       inodes["proxies"]     = (Json::UInt64) XrdCl::Proxy::Proxies();
       inodes["lrureset"]    = (Json::UInt64) this->getMdStat().lru_resets();
+      inodes["restored"]    = (Json::UInt64) this->getMdStat().inodes_restored();
+      inodes["restoredhits"] = (Json::UInt64) this->getMdStat().restored_hits();
+      inodes["upstreamgets"] = (Json::UInt64) this->getMdStat().upstream_gets();
+      inodes["firstlistms"] = (Json::Int64) this->getMdStat().first_listing_ms();
       jsonstats["inodes"] = inodes;
     }
 
@@ -2504,6 +2591,10 @@ EosFuse::DumpStatistic(ThreadAssistant& assistant)
              "ALL        rh-expired          := %lu\n"
              "ALL        proxies             := %d\n"
              "ALL        lrureset            := %ld\n"
+             "ALL        inodes-restored     := %ld\n"
+             "ALL        restored-hits       := %ld\n"
+             "ALL        md-upstream-gets    := %ld\n"
+             "ALL        first-listing-ms    := %ld\n"
              "# -----------------------------------------------------------------------------------------------------------\n",
              this->getMdStat().inodes(),
              this->getMdStat().inodes_stacked(),
@@ -2517,7 +2608,11 @@ EosFuse::DumpStatistic(ThreadAssistant& assistant)
              this->Tracker().size(),
              XrdCl::Proxy::ReadAsyncHandler::nexpired(),
              XrdCl::Proxy::Proxies(),
-             this->getMdStat().lru_resets()
+             this->getMdStat().lru_resets(),
+             this->getMdStat().inodes_restored(),
+             this->getMdStat().restored_hits(),
+             this->getMdStat().upstream_gets(),
+             this->getMdStat().first_listing_ms()
             );
     sout += ino_stat;
     {
@@ -3501,6 +3596,10 @@ EosFuse::listdir(fuse_req_t req, fuse_ino_t ino, metad::shared_md& md,
     }
   }
 
+  if (!rc) {
+    Instance().getMdStat().first_listing();
+  }
+
   return rc;
 }
 
@@ -4989,6 +5088,13 @@ EosFuse::open(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi)
     mode = U_OK;
   }
 
+  if (Instance().Config().options.data_writeback_cache &&
+      ((fi->flags & O_ACCMODE) == O_WRONLY)) {
+    // with the kernel write-back cache the kernel reads from files opened
+    // write-only to fill partially written pages, so serve them as read-write
+    fi->flags = (fi->flags & ~O_ACCMODE) | O_RDWR;
+  }
+
   {
     metad::shared_md md;
     md = Instance().mds.get(req, ino);
@@ -5413,6 +5519,12 @@ The O_NONBLOCK flag was specified, and an incompatible lease was held on the fil
                 fi->direct_io = 0;
               }
 
+              if (Instance().Config().options.data_writeback_cache &&
+                  ((fi->flags & O_ACCMODE) == O_WRONLY)) {
+                // the kernel write-back cache reads from write-only files too
+                fi->flags = (fi->flags & ~O_ACCMODE) | O_RDWR;
+              }
+
               std::string md_name = (*md)()->name();
               uint64_t md_ino = (*md)()->md_ino();
               uint64_t md_pino = (*md)()->md_pino();
@@ -5563,7 +5675,13 @@ EosFuse::write(fuse_req_t req, fuse_ino_t ino, const char* buf, size_t size,
         io->set_edquota();
         rc = EDQUOT;
       } else {
-        if (io->ioctx()->pwrite(req, buf, size, off) == -1) {
+        // small writes are coalesced only with the kernel write-back cache,
+        // which does not wait for the reply of one write to send the next
+        bool reply_deferred = false;
+
+        if (io->ioctx()->pwrite(req, buf, size, off,
+                                Instance().Config().options.data_writeback_cache ?
+                                &reply_deferred : nullptr) == -1) {
           eos_static_err("io-error: inode=%lld size=%lld off=%lld buf=%lld errno=%d", ino,
                          size,
                          off, buf, errno);
@@ -5613,7 +5731,9 @@ EosFuse::write(fuse_req_t req, fuse_ino_t ino, const char* buf, size_t size,
               }
             }
           }
-          fuse_reply_write(req, size);
+          if (!reply_deferred) {
+            fuse_reply_write(req, size);
+          }
         }
       }
     }
@@ -5669,7 +5789,11 @@ EosFuse::release(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi)
     }
 
     std::string cookie = "";
-    io->ioctx()->detach(req, cookie, io->rw);
+
+    if (io->ioctx()->detach(req, cookie, io->rw) && !rc) {
+      rc = EIO;
+    }
+
     Instance().caps.close_writer_inode(io->cap_);
     data::shared_data ioctx = io->ioctx();
     delete io;
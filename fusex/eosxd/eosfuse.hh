@@ -230,6 +230,7 @@ public:
     std::string logfilepath;
     std::string mdcachedir;
     std::string mdcachedir_unlink;
+    std::string mdpersistdir;
     std::string mqtargethost;
     std::string mqidentity;
     std::string mqname;
@@ -267,6 +268,9 @@ public:
       size_t flush_wait_open_size;
 
       bool writebackcache;
+      bool data_writeback_cache; // kernel write-back cache requested and granted
+      bool md_persistent_cache;
+      int md_persistent_cache_grace;
       int global_locking;
       uint64_t fdlimit;
       int rm_rf_protect_levels;
@@ -427,6 +431,11 @@ public:
     return mKV.get();
   }
 
+  kv* getPersistentKV()
+  {
+    return mPKV.get();
+  }
+
   cap& getCap()
   {
     return caps;
@@ -523,6 +532,7 @@ private:
   stringTS lastMgmHostPort;
 
   std::unique_ptr<kv> mKV;
+  std::unique_ptr<kv> mPKV; // md cache surviving restarts
   Stat fusestat;
 
   FILE* fstderr;
@@ -555,6 +565,7 @@ private:
   AssistedThread tStatCirculate;
   AssistedThread tMetaCacheFlush;
   AssistedThread tMetaStackFree;
+  AssistedThread tMetaPersist;
   AssistedThread tMetaCommunicate;
   AssistedThread tMetaCallback;
   AssistedThread tCapFlush;
@@ -210,9 +210,11 @@ metad::lookup(fuse_req_t req, fuse_ino_t parent, const char* name)
     // --------------------------------------------------
     // STEP 2: check if we hold a cap for that directory
     // --------------------------------------------------
-    if (pmd->cap_count() && !pmd->needs_refresh()) {
+    if ((pmd->cap_count() && !pmd->needs_refresh()) || serve_restored(pmd)) {
       // --------------------------------------------------
       // if we have a cap and we listed this directory, we trust the child information
+      // - the same applies to a listing restored from the persistent md cache
+      // within its grace period, once we hold a cap for the directory
       // --------------------------------------------------
       if (pmd->local_children().count(
             eos::common::StringConversion::EncodeInvalidUTF8(name))) {
@@ -729,7 +731,7 @@ metad::get(fuse_req_t req,
   auto getLockHelper = GetMtxAcquire(ino);
 
   if (ino) {
-    if (!mdmap.retrieveTS(ino, md)) {
+    if (!mdmap.retrieveTS(ino, md) && !restore(ino, md)) {
       md = std::make_shared<mdx>();
       (*md)()->set_md_ino(inomap.backward(ino));
     } else {
@@ -750,6 +752,16 @@ metad::get(fuse_req_t req,
     md = std::make_shared<mdx>();
   }
 
+  if (md && serve_restored(md) &&
+      (!listing || ((*md)()->type() == (*md)()->MDLS))) {
+    // -------------------------------------------------------------------------
+    // restored from the persistent md cache and still in the grace period
+    // -------------------------------------------------------------------------
+    eos_static_info("returning restored entry ino=%#lx", ino);
+    stat.restored_hits_inc();
+    return md;
+  }
+
   if (!md || !(*md)()->id()) {
     // -------------------------------------------------------------------------
     // there is no local meta data available, this can only be found upstream
@@ -837,6 +849,7 @@ metad::get(fuse_req_t req,
     // -------------------------------------------------------------------------
     std::string root_path = "/";
     // request the root meta data
+    stat.upstream_gets_inc();
     rc = mdbackend->getMD(req, root_path, contv, listing, authid);
     // set ourselfs as parent of root since we might mount
     // a remote directory != '/'
@@ -867,6 +880,7 @@ metad::get(fuse_req_t req,
       pmd->Locker().UnLock();
 
       if (pmd_ino) {
+        stat.upstream_gets_inc();
         rc = mdbackend->getMD(req, pmd_ino, name, contv, listing, authid);
       } else {
         rc = ENOENT;
@@ -898,6 +912,7 @@ metad::get(fuse_req_t req,
       }
        */
       eos_static_info("ino=%016lx type=%d", (*md)()->md_ino(), (*md)()->type());
+      stat.upstream_gets_inc();
       rc = mdbackend->getMD(req, (*md)()->md_ino(),
                             listing ? (((*md)()->type() != (*md)()->MDLS)
                                        ? 0 : (*md)()->clock()) : (*md)()->clock(),
@@ -991,6 +1006,11 @@ metad::get(fuse_req_t req,
   }
 
   if (rc) {
+    if ((rc == ENOENT) && (thecase == 3) && md->restored()) {
+      // the restored record is gone upstream
+      unpersist(ino);
+    }
+
     shared_md md = std::make_shared<mdx>();
     (*md)()->set_err(rc);
 
@@ -1891,9 +1911,19 @@ metad::cleanup(shared_md md)
   md->setop_none();     /* so that wait_flush() returns */
   md->Locker().UnLock();
 
-  if ((EosFuse::Instance().Config().options.data_kernelcache) ||
-      (EosFuse::Instance().Config().options.md_kernelcache)) {
-    for (auto it = inval_files.begin(); it != inval_files.end(); ++it) {
+  const bool writeback =
+    EosFuse::Instance().Config().options.data_writeback_cache;
+  const bool kcache = (EosFuse::Instance().Config().options.data_kernelcache) ||
+                      (EosFuse::Instance().Config().options.md_kernelcache);
+
+  for (auto it = inval_files.begin(); it != inval_files.end(); ++it) {
+    if (writeback) {
+      // with the kernel write-back cache the kernel trusts its cached pages
+      // and file size, so drop them explicitly once the capability is gone
+      kernelcache::inval_inode(*it, true);
+    }
+
+    if (kcache) {
       forget(0, *it, 0);
     }
   }
@@ -2017,11 +2047,12 @@ metad::apply(fuse_req_t req, eos::fusex::container& cont, bool listing)
     eos_static_info("store local pino=%016lx for %016lx", (*md)()->pid(),
                     (*md)()->id());
     inomap.insert(md_ino, ino);
+    persist(md);
     md->Locker().UnLock();
 
     if (is_new) {
       XrdSysMutexHelper mLock(mdmap);
-      mdmap[ino] = md;
+      mdmap.assign(ino, md);
       stat.inodes_inc();
       stat.inodes_ever_inc();
     }
@@ -2172,6 +2203,7 @@ metad::apply(fuse_req_t req, eos::fusex::container& cont, bool listing)
             eos_static_debug("%s", md->dump().c_str());
           }
 
+          persist(md);
           md->Locker().UnLock();
 
           if (!child) {
@@ -2250,6 +2282,8 @@ metad::apply(fuse_req_t req, eos::fusex::container& cont, bool listing)
           stat.inodes_ever_inc();
         }
 
+        persist(md);
+
         if ((pmd == md)) {
           if (EOS_LOGS_DEBUG) {
             eos_static_debug("cap count %d\n", pmd->cap_count());
@@ -2303,6 +2337,7 @@ metad::apply(fuse_req_t req, eos::fusex::container& cont, bool listing)
 
       // now flag as a complete listing
       (*pmd)()->set_type((*pmd)()->MDLS);
+      persist(pmd);
     }
 
     if (pmd) {
@@ -2441,15 +2476,15 @@ metad::mdcflush(ThreadAssistant& assistant)
 
             if ((op == metad::mdx::ADD) || (op == metad::mdx::UPDATE) ||
                 (op == metad::mdx::LSTORE)) {
-              // TODO: local MD store is now disabled - delete this code
-              //! std::string mdstream;
-              //! md->SerializeToString(&mdstream);
-              //! EosFuse::Instance().getKV()->put(ino, mdstream);
+              // keep the persistent md cache in sync with local changes
+              persist(md);
               md->Locker().UnLock();
             } else {
               md->Locker().UnLock();
 
               if (op == metad::mdx::RM) {
+                unpersist(ino);
+
                 // this step is coupled to the forget function, since we cannot
                 // forget an entry if we didn't process the outstanding KV changes
                 stat.inodes_deleted_dec();
@@ -2605,6 +2640,18 @@ metad::mdstackfree(ThreadAssistant& assistant)
           if (mdmap.count(inode_to_swap)) {
             shared_md md = mdmap[inode_to_swap];
 
+            if (md && md->lru_referenced()) {
+              // looked up without the map lock since it entered the LRU
+              // tail - give it a second chance
+              mdmap.lru_update(inode_to_swap, md);
+              mdmap.UnLock();
+              continue;
+            }
+
+            // drop it from the lookup index first, so that lock-free readers
+            // either hold a reference already or have to wait for the lock
+            mdmap.assign(inode_to_swap, 0);
+
             if ((md.use_count() > 2) ||
                 (md && md->LockTable().size())) {
               eos_static_info("swap-out skipping referenced ino=%#llx ref-count=%lu\n",
@@ -2612,6 +2659,7 @@ metad::mdstackfree(ThreadAssistant& assistant)
                               md.use_count());
 
               if (md) {
+                mdmap.assign(inode_to_swap, md);
                 mdmap.lru_update(inode_to_swap, md);
               }
 
@@ -2623,7 +2671,6 @@ metad::mdstackfree(ThreadAssistant& assistant)
               eos_static_info("swap-out lru-removed ino=%#llx oldest=%#llx", inode_to_swap,
                               mdmap.lru_oldest());
               mdmap.lru_remove(inode_to_swap);
-              mdmap[inode_to_swap] = 0;
 
               if (mdmap.swap_out(inode_to_swap, md)) {
                 eos_static_err("swap-out failed for ino=%#llx", inode_to_swap);
@@ -2646,6 +2693,228 @@ metad::mdstackfree(ThreadAssistant& assistant)
   return;
 }
 
+/* -------------------------------------------------------------------------- */
+void
+metad::persist_init(kv* store, int grace)
+{
+  pstore = store;
+  pstore_grace = grace;
+
+  if (!pstore) {
+    return;
+  }
+
+  // the root record is always resident, restore it in place
+  std::string value;
+  eos::fusex::md record;
+
+  if (pstore->get(1, value, "p") || !record.ParseFromString(value) ||
+      (record.id() != 1)) {
+    return;
+  }
+
+  shared_md md1;
+  mdmap.retrieveTS(1, md1);
+  XrdSysMutexHelper mLock(md1->Locker());
+  (*md1)()->CopyFrom(record);
+  md1->local_children().clear();
+
+  if (record.type() == record.MDLS) {
+    for (auto it = record.children().begin(); it != record.children().end(); ++it) {
+      md1->local_children()[it->first] = it->second;
+    }
+  }
+
+  inomap.insert(record.md_ino(), 1);
+  md1->force_refresh();
+  md1->set_restored(time(NULL));
+  stat.inodes_restored_inc();
+  eos_static_notice("restored root md remote-ino=%#lx children=%lu",
+                    record.md_ino(), md1->local_children().size());
+}
+
+/* -------------------------------------------------------------------------- */
+void
+metad::persist(shared_md md)
+{
+  if (!pstore) {
+    return;
+  }
+
+  const uint64_t ino = (*md)()->id();
+
+  if (!ino) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(pstore_mutex);
+  pstore_queue[ino] = true;
+  pstore_cv.notify_one();
+}
+
+/* -------------------------------------------------------------------------- */
+void
+metad::unpersist(fuse_ino_t ino)
+{
+  if (!pstore || !ino) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(pstore_mutex);
+  pstore_queue[ino] = false;
+  pstore_cv.notify_one();
+}
+
+/* -------------------------------------------------------------------------- */
+bool
+metad::restore(fuse_ino_t ino, shared_md& md)
+{
+  std::string value;
+
+  if (!pstore || (ino <= 1) || pstore->get(ino, value, "p")) {
+    return false;
+  }
+
+  shared_md rmd = std::make_shared<mdx>();
+
+  if (!(*rmd)()->ParseFromString(value) || ((*rmd)()->id() != ino)) {
+    eos_static_err("dropping corrupted persistent md record ino=%#lx", ino);
+    unpersist(ino);
+    return false;
+  }
+
+  if ((*rmd)()->type() == (*rmd)()->MDLS) {
+    for (auto it = (*rmd)()->children().begin();
+         it != (*rmd)()->children().end(); ++it) {
+      rmd->local_children()[it->first] = it->second;
+    }
+  }
+
+  rmd->setop_none();
+  rmd->force_refresh();
+  rmd->set_restored(time(NULL));
+  {
+    XrdSysMutexHelper mLock(mdmap);
+    shared_md existing;
+
+    if (mdmap.retrieve(ino, existing)) {
+      // somebody was faster
+      md = existing;
+      return true;
+    }
+
+    mdmap.assign(ino, rmd);
+    mdmap.lru_add(ino, rmd);
+  }
+  // the remote inode has to map to the restored local one, as done for
+  // records received from upstream in apply
+  inomap.insert((*rmd)()->md_ino(), ino);
+  stat.inodes_inc();
+  stat.inodes_ever_inc();
+  stat.inodes_restored_inc();
+  eos_static_info("restored md ino=%#lx type=%d", ino, (*rmd)()->type());
+  md = rmd;
+  return true;
+}
+
+/* -------------------------------------------------------------------------- */
+bool
+metad::serve_restored(shared_md md)
+{
+  const time_t restored = md->restored();
+
+  if (!restored || !md->needs_refresh() ||
+      (time(NULL) >= (restored + pstore_grace))) {
+    return false;
+  }
+
+  // a restored record is only trusted while we hold the cap covering it,
+  // which for a directory is its own and for a file the one of its parent
+  if (S_ISDIR((*md)()->mode())) {
+    return md->cap_count();
+  }
+
+  shared_md pmd;
+  return mdmap.retrieveTS((*md)()->pid(), pmd) && pmd->cap_count();
+}
+
+/* -------------------------------------------------------------------------- */
+void
+metad::mdpersist(ThreadAssistant& assistant)
+{
+  ThreadAssistant::setSelfThreadName("metad::mdpersist");
+  bool last = false;
+
+  do {
+    last = assistant.terminationRequested();
+    std::map<uint64_t, bool> batch;
+    {
+      std::unique_lock<std::mutex> lock(pstore_mutex);
+
+      if (!last) {
+        pstore_cv.wait_for(lock, std::chrono::seconds(1),
+        [this] { return !pstore_queue.empty(); });
+      }
+
+      batch.swap(pstore_queue);
+    }
+
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+      const uint64_t ino = it->first;
+      shared_md md;
+
+      if (!it->second || !mdmap.retrieveTS(ino, md)) {
+        if (!it->second) {
+          pstore->erase(ino, "p");
+        }
+
+        continue;
+      }
+
+      std::string value;
+      {
+        XrdSysMutexHelper mLock(md->Locker());
+
+        if (md->deleted()) {
+          pstore->erase(ino, "p");
+          continue;
+        }
+
+        if (!(*md)()->md_ino() || (*md)()->err()) {
+          // not yet known upstream or an error record
+          continue;
+        }
+
+        // only what is needed to serve the record again goes to disk
+        eos::fusex::md record(*(*md)());
+        record.clear_capability();
+        record.clear_authid();
+        record.clear_clientid();
+        record.clear_clientuuid();
+        record.clear_implied_authid();
+        record.clear_mv_authid();
+        record.clear_flock();
+        record.clear_operation();
+        record.clear_children();
+
+        if (record.type() == record.MDLS) {
+          // store the local view of the listing
+          for (auto c = md->local_children().begin(); c != md->local_children().end();
+               ++c) {
+            (*record.mutable_children())[c->first] = c->second;
+          }
+        }
+
+        record.SerializeToString(&value);
+      }
+
+      if (pstore->put(ino, value, "p")) {
+        eos_static_err("failed to persist md ino=%#lx", ino);
+      }
+    }
+  } while (!last);
+}
+
 /* -------------------------------------------------------------------------- */
 bool
 metad::determineLockOrder(shared_md md1, shared_md md2)
@@ -3101,7 +3370,8 @@ metad::mdcallback(ThreadAssistant& assistant)
         eos_static_debug("%s", dump_md(md).c_str());
       }
 
-      if (EosFuse::Instance().Config().options.md_kernelcache) {
+      if (EosFuse::Instance().Config().options.md_kernelcache ||
+          EosFuse::Instance().Config().options.data_writeback_cache) {
         eos_static_info("invalidate metadata cache for ino=%#lx", ino);
         kernelcache::inval_inode(ino, S_ISDIR(mode) ? false : true);
       }
@@ -3589,7 +3859,7 @@ metad::vmap::insert(fuse_ino_t a, fuse_ino_t b)
   }
 
   eos_static_info("inserting %llx <=> %llx", a, b);
-  XrdSysMutexHelper mLock(mMutex);
+  std::unique_lock<std::shared_mutex> mLock(mMutex);
 
   if (fwd_map.count(a) && fwd_map[a] == b) {
     return;
@@ -3635,7 +3905,7 @@ metad::vmap::dump()
 void
 metad::vmap::erase_fwd(fuse_ino_t lookup)
 {
-  XrdSysMutexHelper mLock(mMutex);
+  std::unique_lock<std::shared_mutex> mLock(mMutex);
 
   if (fwd_map.count(lookup)) {
     bwd_map.erase(fwd_map[lookup]);
@@ -3648,7 +3918,7 @@ metad::vmap::erase_fwd(fuse_ino_t lookup)
 void
 metad::vmap::erase_bwd(fuse_ino_t lookup)
 {
-  XrdSysMutexHelper mLock(mMutex);
+  std::unique_lock<std::shared_mutex> mLock(mMutex);
 
   if (bwd_map.count(lookup)) {
     fwd_map.erase(bwd_map[lookup]);
@@ -3661,7 +3931,7 @@ metad::vmap::erase_bwd(fuse_ino_t lookup)
 fuse_ino_t
 metad::vmap::forward(fuse_ino_t lookup)
 {
-  XrdSysMutexHelper mLock(mMutex);
+  std::shared_lock<std::shared_mutex> mLock(mMutex);
   auto it = fwd_map.find(lookup);
   fuse_ino_t ino = (it == fwd_map.end()) ? 0 : it->second;
 
@@ -3676,7 +3946,7 @@ metad::vmap::forward(fuse_ino_t lookup)
 fuse_ino_t
 metad::vmap::backward(fuse_ino_t lookup)
 {
-  XrdSysMutexHelper mLock(mMutex);
+  std::shared_lock<std::shared_mutex> mLock(mMutex);
   auto it = bwd_map.find(lookup);
   return (it == bwd_map.end()) ? lookup : it->second;
 }
@@ -3703,7 +3973,7 @@ metad::pmap::retrieveOrCreateTS(fuse_ino_t ino, shared_md& ret)
   ret = std::make_shared<mdx>();
 
   if (ino) {
-    (*this)[ino] = ret;
+    assign(ino, ret);
   }
 
   return true;
@@ -3713,6 +3983,13 @@ metad::pmap::retrieveOrCreateTS(fuse_ino_t ino, shared_md& ret)
 bool
 metad::pmap::retrieveTS(fuse_ino_t ino, shared_md& ret)
 {
+  // resident inodes are served from the sharded index without taking the
+  // map mutex, the LRU position is refreshed lazily by the swap-out thread
+  if (index.get(ino, ret)) {
+    ret->lru_touch();
+    return true;
+  }
+
   XrdSysMutexHelper mLock(this);
   return this->retrieve(ino, ret);
 }
@@ -3752,7 +4029,7 @@ metad::pmap::retrieve(fuse_ino_t ino, shared_md& ret)
     }
 
     // attach the new object
-    (*this)[ino] = md;
+    assign(ino, md);
     // add to the lru list
     lru_add(ino, md);
   }
@@ -4177,7 +4454,7 @@ metad::pmap::insertTS(fuse_ino_t ino, shared_md& md)
     lru_remove(ino);
   }
 
-  (*this)[ino] = md;
+  assign(ino, md);
   // lru list handling
 
   if (!same) {
@@ -4214,6 +4491,35 @@ metad::pmap::eraseTS(fuse_ino_t ino)
   return exists;
 }
 
+/* -------------------------------------------------------------------------- */
+void
+metad::pmap::assign(fuse_ino_t ino, shared_md md)
+{
+  (*this)[ino] = md;
+
+  if (md) {
+    index.set(ino, md);
+  } else {
+    index.erase(ino);
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+metad::pmap::iterator
+metad::pmap::erase(iterator it)
+{
+  index.erase(it->first);
+  return std::map<fuse_ino_t, shared_md>::erase(it);
+}
+
+/* -------------------------------------------------------------------------- */
+void
+metad::pmap::clear()
+{
+  index.clear();
+  std::map<fuse_ino_t, shared_md>::clear();
+}
+
 /* -------------------------------------------------------------------------- */
 void
 metad::pmap::retrieveWithParentTS(fuse_ino_t ino, shared_md& md, shared_md& pmd,
@@ -37,14 +37,19 @@
 #include "common/AssistedThread.hh"
 #include "common/SymKeys.hh"
 #include "kv/kv.hh"
+#include "md/shardmap.hh"
 #include "misc/FuseId.hh"
 #include <XrdSys/XrdSysPthread.hh>
 #include <memory>
 #include <map>
+#include <shared_mutex>
 #include <set>
 #include <deque>
 #include <vector>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <exception>
 #include <stdexcept>
@@ -83,6 +88,8 @@ public:
       inline_size = 0;
       _lru_prev.store(0, std::memory_order_seq_cst);
       _lru_next.store(0, std::memory_order_seq_cst);
+      _lru_ref.store(false, std::memory_order_relaxed);
+      _restored.store(0, std::memory_order_relaxed);
     }
 
     mdx(fuse_ino_t ino) : mdx()
@@ -433,6 +440,21 @@ public:
     void clear_refresh()
     {
       refresh.store(0, std::memory_order_seq_cst);
+      // a record refreshed from upstream is not a restored one anymore
+      _restored.store(0, std::memory_order_relaxed);
+    }
+
+    //! mark as loaded from the persistent md cache at the given time
+    void set_restored(time_t when)
+    {
+      _restored.store(when, std::memory_order_relaxed);
+    }
+
+    //! time when the record was loaded from the persistent md cache, 0 if
+    //! it has been refreshed from upstream since
+    time_t restored() const
+    {
+      return _restored.load(std::memory_order_relaxed);
     }
 
     void set_lru_prev(uint64_t prev)
@@ -454,6 +476,21 @@ public:
       return _lru_next.load();
     }
 
+    //! mark as recently used from the lock-free lookup path, the LRU list is
+    //! updated lazily when the entry becomes a swap-out candidate
+    void lru_touch()
+    {
+      if (!_lru_ref.load(std::memory_order_relaxed)) {
+        _lru_ref.store(true, std::memory_order_relaxed);
+      }
+    }
+
+    //! return and clear the recently used mark
+    bool lru_referenced()
+    {
+      return _lru_ref.exchange(false, std::memory_order_relaxed);
+    }
+
     void set_rmrf()
     {
       rmrf = true;
@@ -495,9 +532,11 @@ public:
     std::atomic<int> lookup_cnt;
     std::atomic<int> cap_cnt;
     std::atomic<int> opendir_cnt;
-    bool lock_remote;
     std::atomic<int> refresh;
+    bool lock_remote;
     bool rmrf;
+    std::atomic<bool> _lru_ref;
+    std::atomic<time_t> _restored;
     uint64_t inline_size;
     std::vector<struct flock> locktable;
     std::map<std::string, uint64_t> todelete;
@@ -507,13 +546,6 @@ public:
     std::atomic<uint64_t> _lru_prev;
     std::atomic<uint64_t> _lru_next;
     eos::fusex::md proto;
-
-    struct hmac_t {
-      std::string key;
-      std::string hmac;
-    };
-
-    hmac_t hmac;
   };
 
   typedef std::shared_ptr<mdx> shared_md;
@@ -598,14 +630,14 @@ public:
 
     void clear()
     {
-      XrdSysMutexHelper mLock(mMutex);
+      std::unique_lock<std::shared_mutex> mLock(mMutex);
       fwd_map.clear();
       bwd_map.clear();
     }
 
     size_t size()
     {
-      XrdSysMutexHelper mLock(mMutex);
+      std::shared_lock<std::shared_mutex> mLock(mMutex);
       return fwd_map.size();
     }
 
@@ -615,7 +647,7 @@ public:
     std::map<fuse_ino_t, fuse_ino_t>
     bwd_map; // backward map points from local remote inode
 
-    XrdSysMutex mMutex;
+    std::shared_mutex mMutex;
   };
 
   class pmap : public std::map<fuse_ino_t, shared_md>, public XrdSysMutex
@@ -649,6 +681,18 @@ public:
     void retrieveWithParentTS(fuse_ino_t ino, shared_md& md, shared_md& pmd,
                               std::string& md_name);
 
+    // the following have to be called with the map mutex held, they keep
+    // the sharded index of resident inodes in sync with the map
+
+    void assign(fuse_ino_t ino, shared_md md);
+    iterator erase(iterator it);
+    void clear();
+
+    size_t index_size() const
+    {
+      return index.size();
+    }
+
     uint64_t lru_oldest() const;
     uint64_t lru_newest() const;
     void lru_add(fuse_ino_t ino, shared_md md);
@@ -665,6 +709,8 @@ public:
     uint64_t lru_first;
     uint64_t lru_last;
     kv* store;
+    // resident (not swapped-out) inodes, readable without the map mutex
+    shardmap<fuse_ino_t, shared_md> index;
   };
 
   //----------------------------------------------------------------------------
@@ -762,6 +808,39 @@ public:
   void mdstackfree(ThreadAssistant&
                    assistant); // thread removing stacked inodes
 
+  void mdpersist(ThreadAssistant&
+                 assistant); // thread writing into the persistent md cache
+
+  //----------------------------------------------------------------------------
+  //! Persistent md cache surviving a restart of the mount
+  //!
+  //! Every md record received from upstream or modified locally is queued and
+  //! written by the mdpersist thread into the persistent KV store, directory
+  //! records keep their listing. After a restart records are loaded on demand
+  //! and served without contacting the MGM for a grace period. Once the grace
+  //! period is over they are flagged for refresh and revalidated by the
+  //! regular get path, which sends the persisted clock upstream.
+  //----------------------------------------------------------------------------
+  void persist_init(kv* store, int grace);
+
+  bool persist_enabled() const
+  {
+    return pstore != nullptr;
+  }
+
+  //! queue an md record for persisting - has to be called with the md locked
+  void persist(shared_md md);
+
+  //! queue the removal of a persisted md record
+  void unpersist(fuse_ino_t ino);
+
+  //! load an md record from the persistent cache into the md map
+  bool restore(fuse_ino_t ino, shared_md& md);
+
+  //! check if a restored md record can be served without upstream validation,
+  //! which requires the covering cap to be held
+  bool serve_restored(shared_md md);
+
   int connect(std::string zmqtarget, std::string zmqidentity = "",
               std::string zmqname = "", std::string zmqclienthost = "",
               std::string zmqclientuuid = "");
@@ -807,6 +886,37 @@ public:
       _inodes_deleted_ever.store(0, std::memory_order_seq_cst);
       _inodes_backlog.store(0, std::memory_order_seq_cst);
       _lru_resets.store(0, std::memory_order_seq_cst);
+      _inodes_restored.store(0, std::memory_order_seq_cst);
+      _restored_hits.store(0, std::memory_order_seq_cst);
+      _upstream_gets.store(0, std::memory_order_seq_cst);
+      _first_listing_ms.store(-1, std::memory_order_seq_cst);
+      _start = std::chrono::steady_clock::now();
+    }
+
+    void inodes_restored_inc()
+    {
+      _inodes_restored.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    void restored_hits_inc()
+    {
+      _restored_hits.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    void upstream_gets_inc()
+    {
+      _upstream_gets.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    //! remember the time from startup until the first directory listing
+    void first_listing()
+    {
+      if (_first_listing_ms.load() < 0) {
+        ssize_t ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                     (std::chrono::steady_clock::now() - _start).count();
+        ssize_t unset = -1;
+        _first_listing_ms.compare_exchange_strong(unset, ms);
+      }
     }
 
     void inodes_inc()
@@ -895,6 +1005,26 @@ public:
       return _lru_resets.load();
     }
 
+    ssize_t inodes_restored()
+    {
+      return _inodes_restored.load();
+    }
+
+    ssize_t restored_hits()
+    {
+      return _restored_hits.load();
+    }
+
+    ssize_t upstream_gets()
+    {
+      return _upstream_gets.load();
+    }
+
+    ssize_t first_listing_ms()
+    {
+      return _first_listing_ms.load();
+    }
+
   private:
     std::atomic<ssize_t> _inodes;
     std::atomic<ssize_t> _inodes_stacked;
@@ -903,6 +1033,11 @@ public:
     std::atomic<ssize_t> _inodes_ever;
     std::atomic<ssize_t> _inodes_deleted_ever;
     std::atomic<ssize_t> _lru_resets;
+    std::atomic<ssize_t> _inodes_restored;
+    std::atomic<ssize_t> _restored_hits;
+    std::atomic<ssize_t> _upstream_gets;
+    std::atomic<ssize_t> _first_listing_ms;
+    std::chrono::steady_clock::time_point _start;
   };
 
   mdstat& stats()
@@ -922,7 +1057,7 @@ public:
     (*md1)()->set_type((*md1)()->MD);
     md1->force_refresh();
     mdmap.clear();
-    mdmap[1] = md1;
+    mdmap.assign(1, md1);
     uint64_t i_root = inomap.backward(1);
     inomap.clear();
     inomap.insert(i_root, 1);
@@ -1206,7 +1341,12 @@ private:
   std::atomic<int> fusex_visible;
   backend* mdbackend;
 
-
+  // persistent md cache
+  kv* pstore {nullptr};
+  int pstore_grace {0};
+  std::mutex pstore_mutex;
+  std::condition_variable pstore_cv;
+  std::map<uint64_t, bool> pstore_queue; // inode, store (true) or erase (false)
 };
 
 #endif /* FUSE_MD_HH_ */
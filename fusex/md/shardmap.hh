@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+//! @file shardmap.hh
+//! @author Elvin Sindrilaru CERN
+//! @brief sharded hash map with shared-lock reads
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef FUSE_SHARDMAP_HH_
+#define FUSE_SHARDMAP_HH_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+//------------------------------------------------------------------------------
+//! Hash map split in a fixed number of shards, each protected by its own
+//! reader-writer lock. Readers of different keys never touch the same cache
+//! line unless the keys fall in the same shard, readers of the same shard
+//! only take the lock in shared mode. Keys are integers which are mixed with
+//! a Fibonacci hash so that sequential inode numbers spread over all shards.
+//------------------------------------------------------------------------------
+template<typename K, typename V, unsigned ShardBits = 6>
+class shardmap
+{
+public:
+  static constexpr size_t kShards = 1ul << ShardBits;
+
+  bool get(const K& key, V& value) const
+  {
+    const shard_t& s = shard(key);
+    std::shared_lock<std::shared_mutex> lock(s.mtx);
+    auto it = s.map.find(key);
+
+    if (it == s.map.end()) {
+      return false;
+    }
+
+    value = it->second;
+    return true;
+  }
+
+  void set(const K& key, const V& value)
+  {
+    shard_t& s = shard(key);
+    std::unique_lock<std::shared_mutex> lock(s.mtx);
+    s.map[key] = value;
+  }
+
+  bool erase(const K& key)
+  {
+    shard_t& s = shard(key);
+    std::unique_lock<std::shared_mutex> lock(s.mtx);
+    return s.map.erase(key);
+  }
+
+  void clear()
+  {
+    for (auto& s : shards) {
+      std::unique_lock<std::shared_mutex> lock(s.mtx);
+      s.map.clear();
+    }
+  }
+
+  size_t size() const
+  {
+    size_t total = 0;
+
+    for (auto& s : shards) {
+      std::shared_lock<std::shared_mutex> lock(s.mtx);
+      total += s.map.size();
+    }
+
+    return total;
+  }
+
+  static size_t shard_index(const K& key)
+  {
+    return (size_t)(((uint64_t) key * 0x9E3779B97F4A7C15ull) >>
+                    (64 - ShardBits));
+  }
+
+private:
+  struct alignas(64) shard_t {
+    mutable std::shared_mutex mtx;
+    std::unordered_map<K, V> map;
+  };
+
+  shard_t& shard(const K& key)
+  {
+    return shards[shard_index(key)];
+  }
+
+  const shard_t& shard(const K& key) const
+  {
+    return shards[shard_index(key)];
+  }
+
+  std::array<shard_t, kShards> shards;
+};
+
+#endif /* FUSE_SHARDMAP_HH_ */
@@ -28,6 +28,8 @@
 #include "mgm/ofs/XrdMgmOfs.hh"
 #include "mgm/stat/Stat.hh"
 #include "namespace/interface/IView.hh"
+#include <algorithm>
+#include <map>
 #include <regex.h>
 #include <thread>
 #include <string>
@@ -35,6 +37,110 @@
 
 EOSMGMNAMESPACE_BEGIN
 
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+FuseServer::Caps::Caps()
+{
+  const time_t now = time(NULL);
+
+  for (auto& shard : mCapShards) {
+    shard.mWheel.resize(kWheelSlots);
+    shard.mCursor = now;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Store a cap in all the indexes
+//------------------------------------------------------------------------------
+void
+FuseServer::Caps::InsertLocked(CapShard& shard, const shared_cap& cap)
+{
+  const authid_t& authid = (*cap)()->authid();
+  const uint64_t ino = (*cap)()->id();
+
+  if (auto kv = shard.mCaps.find(authid); kv != shard.mCaps.end()) {
+    if ((*kv->second)()->id() != ino) {
+      eos_static_info("got inode change for %s from %x to %x",
+                      authid.c_str(), (*kv->second)()->id(), ino);
+      RemoveLocked(shard, kv);
+      shard.mCaps.emplace(authid, cap);
+      ++mNumCaps;
+    } else {
+      kv->second = cap;
+    }
+  } else {
+    shard.mCaps.emplace(authid, cap);
+    ++mNumCaps;
+  }
+
+  {
+    InodeShard& ishard = GetInodeShard(ino);
+    std::unique_lock<std::shared_mutex> lock(ishard.mMutex);
+    ishard.mInodes[ino][authid] = cap;
+  }
+  {
+    ClientShard& cshard = GetClientShard((*cap)()->clientid());
+    std::unique_lock<std::shared_mutex> lock(cshard.mMutex);
+    ClientEntry& entry = cshard.mClients[(*cap)()->clientid()];
+    entry.mAuthIds.insert(authid);
+    entry.mInodes[ino].insert(authid);
+  }
+  // Timers are never removed before they are due, a renewed cap simply gets
+  // a new one and the old one is discarded upon expiry
+  const time_t tick = (time_t)(*cap)()->vtime() + kExpiryGrace;
+  const time_t slot = std::max(tick, shard.mCursor);
+  shard.mWheel[slot % kWheelSlots].push_back(TimerEntry{tick, authid});
+  ++mNumTimers;
+}
+
+//------------------------------------------------------------------------------
+// Remove a cap from all the indexes
+//------------------------------------------------------------------------------
+void
+FuseServer::Caps::RemoveLocked(CapShard& shard, cap_map_t::iterator it)
+{
+  shared_cap cap = it->second;
+  shard.mCaps.erase(it);
+  --mNumCaps;
+  const authid_t& authid = (*cap)()->authid();
+  const uint64_t ino = (*cap)()->id();
+  {
+    InodeShard& ishard = GetInodeShard(ino);
+    std::unique_lock<std::shared_mutex> lock(ishard.mMutex);
+
+    if (auto kv = ishard.mInodes.find(ino); kv != ishard.mInodes.end()) {
+      kv->second.erase(authid);
+
+      if (kv->second.empty()) {
+        ishard.mInodes.erase(kv);
+      }
+    }
+  }
+  ClientShard& cshard = GetClientShard((*cap)()->clientid());
+  std::unique_lock<std::shared_mutex> lock(cshard.mMutex);
+  auto kv = cshard.mClients.find((*cap)()->clientid());
+
+  if (kv == cshard.mClients.end()) {
+    return;
+  }
+
+  ClientEntry& entry = kv->second;
+  entry.mAuthIds.erase(authid);
+
+  if (auto ino_kv = entry.mInodes.find(ino); ino_kv != entry.mInodes.end()) {
+    ino_kv->second.erase(authid);
+
+    if (ino_kv->second.empty()) {
+      entry.mInodes.erase(ino_kv);
+    }
+  }
+
+  if (entry.mAuthIds.empty() && entry.mInodes.empty()) {
+    cshard.mClients.erase(kv);
+  }
+}
+
 //------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------
@@ -44,34 +150,22 @@ FuseServer::Caps::Store(const eos::fusex::cap& ecap,
 {
   gOFS->MgmStats.Add("Eosxd::int::Store", 0, 0, 1);
   EXEC_TIMING_BEGIN("Eosxd::int::Store");
-  std::lock_guard lg(mtx);
   eos_static_info("id=%lx clientid=%s authid=%s",
                   ecap.id(),
                   ecap.clientid().c_str(),
                   ecap.authid().c_str());
-  // register this clientid to a given client uuid
-  ClientIds()[ecap.clientuuid()].insert(ecap.clientid());
-
-  // avoid to have multiple time entries for the same cap
-  if (auto kv = mCaps.find(ecap.authid());
-      kv != mCaps.end()) {
-    shared_cap cap = kv->second;
-
-    if ((*cap)()->id() != ecap.id()) {
-      eos_static_info("got inode change for %s from %x to %x",
-                      ecap.authid().c_str(), (*cap)()->id(), ecap.id());
-      Remove(cap);
-    }
+  {
+    // register this clientid to a given client uuid
+    UuidShard& ushard = GetUuidShard(ecap.clientuuid());
+    std::lock_guard lg(ushard.mMutex);
+    ushard.mClientIds[ecap.clientuuid()].insert(ecap.clientid());
   }
-
-  mTimeOrderedCap.emplace(std::make_pair(ecap.vtime(), ecap.authid()));
-  mClientCaps[ecap.clientid()].insert(ecap.authid());
-  mClientInoCaps[ecap.clientid()][ecap.id()].insert(ecap.authid());
   shared_cap cap = std::make_shared<capx>();
   *cap = ecap;
   cap->set_vid(vid);
-  mCaps[ecap.authid()] = cap;
-  mInodeCaps[ecap.id()].insert(ecap.authid());
+  CapShard& shard = GetCapShard(ecap.authid());
+  std::unique_lock<std::shared_mutex> lock(shard.mMutex);
+  InsertLocked(shard, cap);
   EXEC_TIMING_END("Eosxd::int::Store");
 }
 
@@ -108,32 +202,348 @@ FuseServer::Caps::Imply(uint64_t md_ino,
     }
     (*implied_cap)()->set_vtime(ts.tv_sec + (leasetime ? leasetime : 300));
     (*implied_cap)()->set_vtime_ns(ts.tv_nsec);
-    // fill the three views on caps
-    std::lock_guard lg(mtx);
-    mTimeOrderedCap.insert(std::pair<time_t, authid_t>((*implied_cap)()->vtime(),
-                           implied_authid));
-    mClientCaps[(*cap)()->clientid()].insert(implied_authid);
-    mClientInoCaps[(*cap)()->clientid()][(*cap)()->id()].insert(implied_authid);
-    mCaps[implied_authid] = implied_cap;
-    mInodeCaps[md_ino].insert(implied_authid);
+    // fill the views on caps
+    CapShard& shard = GetCapShard(implied_authid);
+    std::unique_lock<std::shared_mutex> lock(shard.mMutex);
+    InsertLocked(shard, implied_cap);
   }
   return true;
 }
 
 //------------------------------------------------------------------------------
-// Get shared capability - one needs to hold (at least) the read lock
+// Get shared capability
 //------------------------------------------------------------------------------
 FuseServer::Caps::shared_cap
-FuseServer::Caps::Get(const FuseServer::Caps::authid_t& id, bool make_default)
+FuseServer::Caps::Get(const FuseServer::Caps::authid_t& id,
+                      bool make_default) const
 {
-  if (auto kv = mCaps.find(id);
-      kv != mCaps.end()) {
-    return kv->second;
-  }
+  {
+    const CapShard& shard = GetCapShard(id);
+    std::shared_lock<std::shared_mutex> lock(shard.mMutex);
 
+    if (auto kv = shard.mCaps.find(id);
+        kv != shard.mCaps.end()) {
+      return kv->second;
+    }
+  }
   return make_default ? std::make_shared<capx>() : nullptr;
 }
 
+//------------------------------------------------------------------------------
+// Remove the cap stored under the authid of the given cap
+//------------------------------------------------------------------------------
+bool
+FuseServer::Caps::Remove(shared_cap cap)
+{
+  if (!cap) {
+    return false;
+  }
+
+  CapShard& shard = GetCapShard((*cap)()->authid());
+  std::unique_lock<std::shared_mutex> lock(shard.mMutex);
+  auto kv = shard.mCaps.find((*cap)()->authid());
+
+  if (kv == shard.mCaps.end()) {
+    return false;
+  }
+
+  RemoveLocked(shard, kv);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Drop all the caps of a client mount
+//------------------------------------------------------------------------------
+void
+FuseServer::Caps::dropCaps(const std::string& uuid)
+{
+  eos_static_info("drop client caps: %s", uuid.c_str());
+  clientid_set_t client_ids;
+  {
+    UuidShard& ushard = GetUuidShard(uuid);
+    std::lock_guard lg(ushard.mMutex);
+    auto kv = ushard.mClientIds.find(uuid);
+
+    if (kv == ushard.mClientIds.end()) {
+      return;
+    }
+
+    client_ids = std::move(kv->second);
+    ushard.mClientIds.erase(kv);
+  }
+
+  for (const auto& client_id : client_ids) {
+    ClientShard& cshard = GetClientShard(client_id);
+    authid_set_t auth_ids;
+    {
+      std::shared_lock<std::shared_mutex> lock(cshard.mMutex);
+
+      if (auto kv = cshard.mClients.find(client_id);
+          kv != cshard.mClients.end()) {
+        auth_ids = kv->second.mAuthIds;
+      }
+    }
+
+    for (const auto& authid : auth_ids) {
+      CapShard& shard = GetCapShard(authid);
+      std::unique_lock<std::shared_mutex> lock(shard.mMutex);
+
+      if (auto kv = shard.mCaps.find(authid);
+          (kv != shard.mCaps.end()) && ((*kv->second)()->clientuuid() == uuid)) {
+        RemoveLocked(shard, kv);
+      }
+    }
+
+    // cleanup by client ids
+    std::unique_lock<std::shared_mutex> lock(cshard.mMutex);
+    cshard.mClients.erase(client_id);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Expire the due timers of a shard
+//------------------------------------------------------------------------------
+size_t
+FuseServer::Caps::ExpireLocked(CapShard& shard, time_t now)
+{
+  size_t expired = 0;
+
+  if (now < shard.mCursor) {
+    return expired;
+  }
+
+  // after a pause longer than a wheel turn every slot is visited once
+  const time_t first = std::max(shard.mCursor,
+                                now - (time_t) kWheelSlots + 1);
+
+  for (time_t tick = first; tick <= now; ++tick) {
+    auto& slot = shard.mWheel[tick % kWheelSlots];
+
+    for (size_t i = 0; i < slot.size();) {
+      // entries of a later turn of the wheel stay
+      if (slot[i].mTick > now) {
+        ++i;
+        continue;
+      }
+
+      authid_t authid = std::move(slot[i].mAuthId);
+      slot[i] = std::move(slot.back());
+      slot.pop_back();
+      --mNumTimers;
+      auto kv = shard.mCaps.find(authid);
+
+      // caps renewed in the meantime have a later timer
+      if ((kv != shard.mCaps.end()) &&
+          ((time_t)(*kv->second)()->vtime() + kExpiryGrace <= now)) {
+        RemoveLocked(shard, kv);
+        ++expired;
+      }
+    }
+  }
+
+  shard.mCursor = now + 1;
+  return expired;
+}
+
+//------------------------------------------------------------------------------
+// Expire the caps whose validity ended
+//------------------------------------------------------------------------------
+size_t
+FuseServer::Caps::ExpireCaps(time_t now)
+{
+  size_t expired = 0;
+
+  if (!now) {
+    now = time(NULL);
+  }
+
+  for (auto& shard : mCapShards) {
+    std::unique_lock<std::shared_mutex> lock(shard.mMutex);
+    expired += ExpireLocked(shard, now);
+  }
+
+  return expired;
+}
+
+//------------------------------------------------------------------------------
+// Snapshot of the caps of an inode
+//------------------------------------------------------------------------------
+std::vector<FuseServer::Caps::shared_cap>
+FuseServer::Caps::GetInodeCaps(uint64_t ino) const
+{
+  std::vector<shared_cap> caps;
+  const InodeShard& ishard = GetInodeShard(ino);
+  std::shared_lock<std::shared_mutex> lock(ishard.mMutex);
+
+  if (auto kv = ishard.mInodes.find(ino); kv != ishard.mInodes.end()) {
+    caps.reserve(kv->second.size());
+
+    for (const auto& elem : kv->second) {
+      caps.push_back(elem.second);
+    }
+  }
+
+  return caps;
+}
+
+//------------------------------------------------------------------------------
+// Snapshot of the authid=>cap map
+//------------------------------------------------------------------------------
+FuseServer::Caps::cap_map_t
+FuseServer::Caps::GetCaps() const
+{
+  cap_map_t caps;
+
+  for (const auto& shard : mCapShards) {
+    std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+    caps.insert(shard.mCaps.begin(), shard.mCaps.end());
+  }
+
+  return caps;
+}
+
+//------------------------------------------------------------------------------
+// Get all the caps
+//------------------------------------------------------------------------------
+std::vector<FuseServer::Caps::shared_cap>
+FuseServer::Caps::GetAllCaps() const
+{
+  std::vector<shared_cap> results;
+  results.reserve(Size());
+
+  for (const auto& shard : mCapShards) {
+    std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+
+    for (const auto& kv : shard.mCaps) {
+      results.push_back(kv.second);
+    }
+  }
+
+  return results;
+}
+
+//------------------------------------------------------------------------------
+// Check if a cap exists
+//------------------------------------------------------------------------------
+bool
+FuseServer::Caps::HasCap(const authid_t& authid) const
+{
+  const CapShard& shard = GetCapShard(authid);
+  std::shared_lock<std::shared_mutex> lock(shard.mMutex);
+  return shard.mCaps.count(authid);
+}
+
+//------------------------------------------------------------------------------
+// Check if a client has a cap for an inode
+//------------------------------------------------------------------------------
+bool
+FuseServer::Caps::HasInodeId(const std::string& client_id, uint64_t id) const
+{
+  const ClientShard& cshard = GetClientShard(client_id);
+  std::shared_lock<std::shared_mutex> lock(cshard.mMutex);
+
+  if (auto kv = cshard.mClients.find(client_id);
+      kv != cshard.mClients.end()) {
+    return kv->second.mInodes.count(id) > 0;
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Get the authids of the caps of a client for an inode
+//------------------------------------------------------------------------------
+FuseServer::Caps::authid_set_t
+FuseServer::Caps::GetInodeCapAuthIds(const std::string& client_id,
+                                     uint64_t id) const
+{
+  authid_set_t results;
+  const ClientShard& cshard = GetClientShard(client_id);
+  std::shared_lock<std::shared_mutex> lock(cshard.mMutex);
+
+  if (auto kv = cshard.mClients.find(client_id);
+      kv != cshard.mClients.end()) {
+    if (auto auth_ids = kv->second.mInodes.find(id);
+        auth_ids != kv->second.mInodes.end()) {
+      results = auth_ids->second;
+    }
+  }
+
+  return results;
+}
+
+//------------------------------------------------------------------------------
+// Snapshot of the clientid=>authids view
+//------------------------------------------------------------------------------
+FuseServer::Caps::client_set_t
+FuseServer::Caps::ClientCaps() const
+{
+  client_set_t results;
+
+  for (const auto& cshard : mClientShards) {
+    std::shared_lock<std::shared_mutex> lock(cshard.mMutex);
+
+    for (const auto& kv : cshard.mClients) {
+      if (!kv.second.mAuthIds.empty()) {
+        results.emplace(kv.first, kv.second.mAuthIds);
+      }
+    }
+  }
+
+  return results;
+}
+
+//------------------------------------------------------------------------------
+// Snapshot of the clientid=>inode=>authids view
+//------------------------------------------------------------------------------
+FuseServer::Caps::client_ino_map_t
+FuseServer::Caps::ClientInoCaps() const
+{
+  client_ino_map_t results;
+
+  for (const auto& cshard : mClientShards) {
+    std::shared_lock<std::shared_mutex> lock(cshard.mMutex);
+
+    for (const auto& kv : cshard.mClients) {
+      if (!kv.second.mInodes.empty()) {
+        results.emplace(kv.first, kv.second.mInodes);
+      }
+    }
+  }
+
+  return results;
+}
+
+//------------------------------------------------------------------------------
+// Summary of the index sizes
+//------------------------------------------------------------------------------
+std::string
+FuseServer::Caps::Dump() const
+{
+  size_t n_client_caps = 0;
+  size_t n_client_ino_caps = 0;
+  size_t n_inode_caps = 0;
+
+  for (const auto& cshard : mClientShards) {
+    std::shared_lock<std::shared_mutex> lock(cshard.mMutex);
+
+    for (const auto& kv : cshard.mClients) {
+      n_client_caps += !kv.second.mAuthIds.empty();
+      n_client_ino_caps += !kv.second.mInodes.empty();
+    }
+  }
+
+  for (const auto& ishard : mInodeShards) {
+    std::shared_lock<std::shared_mutex> lock(ishard.mMutex);
+    n_inode_caps += ishard.mInodes.size();
+  }
+
+  return std::to_string(ncaps()) + " c: " + std::to_string(Size()) + " cc: "
+         + std::to_string(n_client_caps) + " cic: " +
+         std::to_string(n_client_ino_caps) + " ic: " +
+         std::to_string(n_inode_caps);
+}
+
 //------------------------------------------------------------------------------
 // Get Broadcast Caps
 //----------------------------------------------------------------------------
@@ -145,21 +555,13 @@ std::vector<std::shared_ptr<eos::mgm::FuseServer::Caps::capx>>
         std::string suppress_stat_tag)
 {
   std::vector<shared_cap> bccaps;
-  std::vector<authid_t> auth_ids;
   size_t n_suppressed {0};
   regex_t regex;
-  {
-    std::lock_guard lg(mtx);
-    auto ids = mInodeCaps.find(id);
-
-    if (ids == mInodeCaps.end()) {
-      return bccaps;
-    }
+  // only the shard of the inode is locked, in shared mode
+  std::vector<shared_cap> inode_caps = GetInodeCaps(id);
 
-    auth_ids.reserve(ids->second.size());
-    std::copy(ids->second.begin(),
-              ids->second.end(),
-              std::back_inserter(auth_ids));
+  if (inode_caps.empty()) {
+    return bccaps;
   }
 
   if (suppress) {
@@ -168,7 +570,7 @@ std::vector<std::shared_ptr<eos::mgm::FuseServer::Caps::capx>>
     std::string match =
       gOFS->zMQ->gFuseServer.Client().BroadCastAudienceSuppressMatch();
 
-    if (audience && ((auth_ids.size() > (size_t)audience))) {
+    if (audience && ((inode_caps.size() > (size_t)audience))) {
       if (regcomp(&regex, match.c_str(), REG_ICASE | REG_EXTENDED | REG_NOSUB)) {
         suppress = false;
         eos_static_err("msg=\"broadcast audience suppress match not valid regex\" regex=\"%s\"",
@@ -179,18 +581,16 @@ std::vector<std::shared_ptr<eos::mgm::FuseServer::Caps::capx>>
     }
   }
 
-  eos_static_debug("id=%lx mInodeCaps.count=1", id);
+  eos_static_debug("id=%lx inode_caps.count=%zu", id, inode_caps.size());
 
-  for (const auto& it : auth_ids) {
-    // TODO: do we need to debug log mCaps.found
-    // eos_static_debug("mCaps.found=1")
-    shared_cap cap = GetTS(it);
+  bccaps.reserve(inode_caps.size());
 
+  for (auto& cap : inode_caps) {
     if (!(*cap)()->id()) {
       continue;
     }
 
-    if ((*refcap)() && mdptr) {
+    if (refcap && mdptr) {
       // skip our own cap!
       if ((*cap)()->authid() == mdptr->authid()) {
         continue;
@@ -319,23 +719,14 @@ FuseServer::Caps::BroadcastRefresh(uint64_t inode,
   EXEC_TIMING_BEGIN("Eosxd::int::BcRefresh");
   eos_static_debug("id=%lx parent=%lx", inode, parent_inode);
   size_t n_suppressed = 0;
-  std::vector<authid_t> auth_ids;
-  FuseServer::Caps::shared_cap refcap {nullptr};
-  {
-    std::lock_guard lg(mtx);
-    refcap = Get(md.authid(), false);
-    auto kv = mInodeCaps.find(parent_inode);
+  std::vector<shared_cap> inode_caps = GetInodeCaps(parent_inode);
 
-    if (kv == mInodeCaps.end()) {
-      EXEC_TIMING_END("Eosxd::int::BcRefresh");
-      return 0; // nothing to process here
-    }
-
-    auth_ids.reserve(kv->second.size());
-    std::copy(kv->second.begin(),
-              kv->second.end(),
-              std::back_inserter(auth_ids));
+  if (inode_caps.empty()) {
+    EXEC_TIMING_END("Eosxd::int::BcRefresh");
+    return 0; // nothing to process here
   }
+
+  FuseServer::Caps::shared_cap refcap = Get(md.authid(), false);
   bool suppress_audience = false;
   regex_t regex;
   // audience check
@@ -343,7 +734,7 @@ FuseServer::Caps::BroadcastRefresh(uint64_t inode,
   std::string match =
     gOFS->zMQ->gFuseServer.Client().BroadCastAudienceSuppressMatch();
 
-  if (audience && ((auth_ids.size() > (size_t)audience))) {
+  if (audience && ((inode_caps.size() > (size_t)audience))) {
     suppress_audience = true;
 
     if (regcomp(&regex, match.c_str(), REG_ICASE | REG_EXTENDED | REG_NOSUB)) {
@@ -353,9 +744,7 @@ FuseServer::Caps::BroadcastRefresh(uint64_t inode,
     }
   }
 
-  for (const auto& it : auth_ids) {
-    shared_cap cap = GetTS(it);
-
+  for (const auto& cap : inode_caps) {
     // avoid processing if the cap doesn't exist
     if (!(*cap)()->id()) {
       continue;
@@ -420,31 +809,22 @@ FuseServer::Caps::BroadcastMD(const eos::fusex::md& md,
   size_t n_suppressed = 0;
   std::vector<shared_cap> bccaps;
   std::unordered_set<std::string> clients_sent;
-  std::vector<authid_t> auth_ids;
   FuseServer::Caps::shared_cap refcap {nullptr};
-  {
-    std::lock_guard lg(mtx);
-
-    if (md.authid().length()) {
-      refcap = Get(md.authid(), false);
-
-      if (refcap == nullptr) {
-        EXEC_TIMING_END("Eosxd::int::BcMD");
-        return 0;
-      }
-    }
 
-    auto kv = mInodeCaps.find(md_pino);
+  if (md.authid().length()) {
+    refcap = Get(md.authid(), false);
 
-    if (kv == mInodeCaps.end()) {
+    if (refcap == nullptr) {
       EXEC_TIMING_END("Eosxd::int::BcMD");
-      return 0; // nothing to process here
+      return 0;
     }
+  }
 
-    auth_ids.reserve(kv->second.size());
-    std::copy(kv->second.begin(),
-              kv->second.end(),
-              std::back_inserter(auth_ids));
+  std::vector<shared_cap> inode_caps = GetInodeCaps(md_pino);
+
+  if (inode_caps.empty()) {
+    EXEC_TIMING_END("Eosxd::int::BcMD");
+    return 0; // nothing to process here
   }
 
   if (refcap != nullptr) {
@@ -460,7 +840,7 @@ FuseServer::Caps::BroadcastMD(const eos::fusex::md& md,
   std::string match =
     gOFS->zMQ->gFuseServer.Client().BroadCastAudienceSuppressMatch();
 
-  if (audience && (auth_ids.size() > (size_t) audience)) {
+  if (audience && (inode_caps.size() > (size_t) audience)) {
     suppress_audience = true;
 
     if (regcomp(&regex, match.c_str(), REG_ICASE | REG_EXTENDED | REG_NOSUB)) {
@@ -470,14 +850,7 @@ FuseServer::Caps::BroadcastMD(const eos::fusex::md& md,
     }
   }
 
-  for (const auto& it : auth_ids) {
-    shared_cap cap = GetTS(it, false);
-
-    // avoid processing if the cap doesn't exist
-    if (!cap) {
-      continue;
-    }
-
+  for (const auto& cap : inode_caps) {
     // avoid processing if the cap doesn't exist or to a sent client
     if (!(*cap)()->id() || (clients_sent.count((*cap)()->clientuuid()))) {
       continue;
@@ -559,17 +932,15 @@ FuseServer::Caps::Print(const std::string& option,
   }
 
   if (option == "t") {
-    std::lock_guard lg(mtx);
+    std::vector<shared_cap> caps = GetAllCaps();
+    std::stable_sort(caps.begin(), caps.end(),
+    [](const shared_cap & a, const shared_cap & b) {
+      return (*a)()->vtime() < (*b)()->vtime();
+    });
 
     // print by time order
-    for (auto it = mTimeOrderedCap.begin(); it != mTimeOrderedCap.end();) {
-      if (!mCaps.count(it->second)) {
-        it = mTimeOrderedCap.erase(it);
-        continue;
-      }
-
+    for (const auto& cap : caps) {
       char ahex[256];
-      shared_cap cap = mCaps[it->second];
       snprintf(ahex, sizeof(ahex), "%016lx", (unsigned long)(*cap)()->id());
       std::string match = "";
       match += "# i:";
@@ -597,18 +968,32 @@ FuseServer::Caps::Print(const std::string& option,
 
       if (filter.size() &&
           (regexec(&regex, match.c_str(), 0, NULL, 0) == REG_NOMATCH)) {
-        it++;
         continue;
       }
 
       out += match.c_str();
-      ++it;
+    }
+  }
+
+  std::map<uint64_t, std::vector<shared_cap>> inode_caps;
+
+  if ((option == "i") || (option == "p")) {
+    for (const auto& ishard : mInodeShards) {
+      std::shared_lock<std::shared_mutex> lock(ishard.mMutex);
+
+      for (const auto& kv : ishard.mInodes) {
+        auto& caps = inode_caps[kv.first];
+
+        for (const auto& elem : kv.second) {
+          caps.push_back(elem.second);
+        }
+      }
     }
   }
 
   if (option == "i") {
     // print by inode
-    for (auto it = mInodeCaps.begin(); it != mInodeCaps.end(); ++it) {
+    for (auto it = inode_caps.begin(); it != inode_caps.end(); ++it) {
       char ahex[256];
       snprintf(ahex, sizeof(ahex), "%016lx", (unsigned long) it->first);
 
@@ -620,33 +1005,27 @@ FuseServer::Caps::Print(const std::string& option,
       out += ahex;
       out += "\n";
 
-      for (auto sit = it->second.begin(); sit != it->second.end(); ++sit) {
+      for (const auto& cap : it->second) {
         out += "___ a:";
-        out += *sit;
-
-        if (!mCaps.count(*sit)) {
-          out += " c:<unfound> u:<unfound> m:<unfound> v:<unfound>\n";
-        } else {
-          shared_cap cap = mCaps[*sit];
-          out += " c:";
-          out += (*cap)()->clientid();
-          out += " u:";
-          out += (*cap)()->clientuuid();
-          out += " m:";
-          snprintf(ahex, sizeof(ahex), "%016lx", (unsigned long)(*cap)()->mode());
-          out += ahex;
-          out += " v:";
-          out += eos::common::StringConversion::GetSizeString(astring,
-                 (unsigned long long)(*cap)()->vtime() - now);
-          out += "\n";
-        }
+        out += (*cap)()->authid();
+        out += " c:";
+        out += (*cap)()->clientid();
+        out += " u:";
+        out += (*cap)()->clientuuid();
+        out += " m:";
+        snprintf(ahex, sizeof(ahex), "%016lx", (unsigned long)(*cap)()->mode());
+        out += ahex;
+        out += " v:";
+        out += eos::common::StringConversion::GetSizeString(astring,
+               (unsigned long long)(*cap)()->vtime() - now);
+        out += "\n";
       }
     }
   }
 
   if (option == "p") {
     // print by inode
-    for (auto it = mInodeCaps.begin(); it != mInodeCaps.end(); ++it) {
+    for (auto it = inode_caps.begin(); it != inode_caps.end(); ++it) {
       std::string spath;
 
       try {
@@ -676,27 +1055,21 @@ FuseServer::Caps::Print(const std::string& option,
       out += apath;
       out += "\n";
 
-      for (auto sit = it->second.begin(); sit != it->second.end(); ++sit) {
+      for (const auto& cap : it->second) {
         out += "___ a:";
-        out += *sit;
-
-        if (!mCaps.count(*sit)) {
-          out += " c:<unfound> u:<unfound> m:<unfound> v:<unfound>\n";
-        } else {
-          shared_cap cap = mCaps[*sit];
-          out += " c:";
-          out += (*cap)()->clientid();
-          out += " u:";
-          out += (*cap)()->clientuuid();
-          out += " m:";
-          char ahex[20];
-          snprintf(ahex, sizeof(ahex), "%016lx", (unsigned long)(*cap)()->mode());
-          out += ahex;
-          out += " v:";
-          out += eos::common::StringConversion::GetSizeString(astring,
-                 (unsigned long long)(*cap)()->vtime() - now);
-          out += "\n";
-        }
+        out += (*cap)()->authid();
+        out += " c:";
+        out += (*cap)()->clientid();
+        out += " u:";
+        out += (*cap)()->clientuuid();
+        out += " m:";
+        char ahex[20];
+        snprintf(ahex, sizeof(ahex), "%016lx", (unsigned long)(*cap)()->mode());
+        out += ahex;
+        out += " v:";
+        out += eos::common::StringConversion::GetSizeString(astring,
+               (unsigned long long)(*cap)()->vtime() - now);
+        out += "\n";
       }
     }
   }
@@ -714,61 +1087,35 @@ FuseServer::Caps::Print(const std::string& option,
 int
 FuseServer::Caps::Delete(uint64_t md_ino)
 {
-  // Hash functor used for storing client_set_t::iterator objects in an
-  // unordered set
-  struct iter_client_set_hash {
-    size_t operator()(client_set_t::iterator it) const
-    {
-      return std::hash<std::string>()(it->first);
-    }
-  };
-  std::unordered_set<client_set_t::iterator, iter_client_set_hash>
-  to_del_client_caps;
-  std::lock_guard lg(mtx);
-  const auto it_inode_caps = mInodeCaps.find(md_ino);
-
-  if (it_inode_caps == mInodeCaps.end()) {
-    return ENONET;
-  }
+  std::vector<authid_t> auth_ids;
+  {
+    const InodeShard& ishard = GetInodeShard(md_ino);
+    std::shared_lock<std::shared_mutex> lock(ishard.mMutex);
+    const auto it_inode_caps = ishard.mInodes.find(md_ino);
 
-  const authid_set_t& set_authid = it_inode_caps->second;
+    if (it_inode_caps == ishard.mInodes.end()) {
+      return ENONET;
+    }
 
-  for (auto it_client_caps = mClientCaps.begin();
-       it_client_caps != mClientCaps.end(); ++it_client_caps) {
-    for (const auto& authid : set_authid) {
-      // erase authid from the client set
-      it_client_caps->second.erase(authid);
+    auth_ids.reserve(it_inode_caps->second.size());
 
-      if (it_client_caps->second.empty()) {
-        to_del_client_caps.insert(it_client_caps);
-      }
+    for (const auto& elem : it_inode_caps->second) {
+      auth_ids.push_back(elem.first);
     }
   }
 
-  for (auto& it_elem : to_del_client_caps) {
-    mClientCaps.erase(it_elem);
-  }
-
-  for (const auto& authid : set_authid) {
-    const auto it_caps = mCaps.find(authid);
-
-    if (it_caps != mCaps.end()) {
-      const std::string client_id = (*it_caps->second)()->clientid();
-      auto it_cli_inocaps = mClientInoCaps.find(client_id);
-
-      if (it_cli_inocaps != mClientInoCaps.end()) {
-        it_cli_inocaps->second.erase(md_ino);
-
-        if (it_cli_inocaps->second.size() == 0) {
-          mClientInoCaps.erase(it_cli_inocaps);
-        }
-      }
+  // removing the caps also drops them from the inode and client views
+  for (const auto& authid : auth_ids) {
+    CapShard& shard = GetCapShard(authid);
+    std::unique_lock<std::shared_mutex> lock(shard.mMutex);
+    const auto it_caps = shard.mCaps.find(authid);
 
-      mCaps.erase(it_caps);
+    if ((it_caps != shard.mCaps.end()) &&
+        ((*it_caps->second)()->id() == md_ino)) {
+      RemoveLocked(shard, it_caps);
     }
   }
 
-  mInodeCaps.erase(it_inode_caps);
   return 0;
 }
 
@@ -24,9 +24,15 @@
 #pragma once
 
 
-#include <thread>
+#include <array>
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "mgm/Namespace.hh"
 #include "mgm/fusex.pb.h"
@@ -39,7 +45,10 @@
 EOSFUSESERVERNAMESPACE_BEGIN
 
 //----------------------------------------------------------------------------
-//! Class Caps
+//! Class Caps - caps handed out to the FUSE clients. The authid, inode,
+//! client id and client uuid indexes are split in shards each with its own
+//! lock so that grants, broadcasts and expiry of unrelated caps do not
+//! serialize. Expiry uses a timer wheel per authid shard.
 //----------------------------------------------------------------------------
 class Caps
 {
@@ -81,10 +90,6 @@ public:
 
   typedef std::shared_ptr<capx> shared_cap;
 
-  Caps() = default;
-
-  virtual ~Caps() = default;
-
   typedef std::string authid_t;
   typedef std::string clientid_t;
   typedef std::string client_uuid_t;
@@ -98,150 +103,85 @@ public:
   notify_set_t; // inode=>set(authid_t)
   typedef std::unordered_map<clientid_t, authid_set_t> client_set_t;
   typedef std::unordered_map<clientid_t, ino_map_t> client_ino_map_t;
+  typedef std::unordered_map<authid_t, shared_cap> cap_map_t;
+
+  //! Number of shards of each of the cap indexes
+  static constexpr size_t kShards = 64;
+  //! Number of one second slots of the per-shard expiry timer wheel
+  static constexpr size_t kWheelSlots = 512;
+  //! Seconds after the validity time of a cap before it is expired
+  static constexpr time_t kExpiryGrace = 10;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  Caps();
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  virtual ~Caps() = default;
 
-
-  ssize_t ncaps()
+  //----------------------------------------------------------------------------
+  //! Number of pending expiry timers i.e. one per stored cap version
+  //----------------------------------------------------------------------------
+  ssize_t ncaps() const
   {
-    std::lock_guard lg(mtx);
-    return mTimeOrderedCap.size();
+    return mNumTimers.load(std::memory_order_relaxed);
   }
 
-  void pop()
+  //----------------------------------------------------------------------------
+  //! Number of caps
+  //----------------------------------------------------------------------------
+  size_t Size() const
   {
-    std::lock_guard lg(mtx);
-
-    if (!mTimeOrderedCap.empty()) {
-      mTimeOrderedCap.erase(mTimeOrderedCap.begin());
-    }
+    return mNumCaps.load(std::memory_order_relaxed);
   }
 
-  bool expire()
-  {
-    std::lock_guard lg(mtx);
-    authid_t id;
-    time_t idtime = 0;
-
-    if (!mTimeOrderedCap.empty()) {
-      id = mTimeOrderedCap.begin()->second;
-      idtime = mTimeOrderedCap.begin()->first;
-    } else {
-      return false;
-    }
-
-    // TODO: C++17 - move initialization inside if
-    auto it = mCaps.find(id);
-
-    if (it != mCaps.end()) {
-      shared_cap cap = it->second;
-      int64_t now = (int64_t) time(NULL);
-
-      if (((*cap)()->vtime() + 10) <= (uint64_t)now) {
-        return Remove(cap);
-      } else {
-        if ((idtime + 10) <= now) {
-          return true;
-        } else {
-          return false;
-        }
-      }
-    }
-
-    return true;
-  }
+  //----------------------------------------------------------------------------
+  //! Expire the caps whose validity ended more than kExpiryGrace seconds ago
+  //!
+  //! @param now current time, 0 means time(NULL)
+  //!
+  //! @return number of caps removed
+  //----------------------------------------------------------------------------
+  size_t ExpireCaps(time_t now = 0);
 
   void Store(const eos::fusex::cap& cap,
              eos::common::VirtualIdentity* vid);
 
-
   bool Imply(uint64_t md_ino,
              authid_t authid,
              authid_t implied_authid);
 
-  void dropCaps(const std::string& uuid)
-  {
-    eos_static_info("drop client caps: %s", uuid.c_str());
-    std::vector<shared_cap> deleteme;
-    {
-      std::lock_guard lg(mtx);
-
-      for (auto it = mCaps.begin(); it != mCaps.end(); ++it) {
-        if ((*it->second)()->clientuuid() == uuid) {
-          deleteme.push_back(it->second);
-        }
-      }
-    }
-    {
-      for (auto it = deleteme.begin(); it != deleteme.end(); ++it) {
-        std::lock_guard lg(mtx);
-        shared_cap cap = *it;
-        Remove(*it);
-      }
-    }
-    // cleanup by client ids
-    {
-      std::lock_guard lg(mtx);
-      auto uuid_iter = mClientIds.find(uuid);
-
-      if (uuid_iter != mClientIds.end()) {
-        for (auto it = uuid_iter->second.begin(); it != uuid_iter->second.end(); ++it) {
-          mClientCaps.erase(*it);
-          mClientInoCaps.erase(*it);
-        }
+  //----------------------------------------------------------------------------
+  //! Drop all the caps of a client mount
+  //----------------------------------------------------------------------------
+  void dropCaps(const std::string& uuid);
 
-        mClientIds.erase(uuid_iter);
-      }
-    }
-  }
+  //----------------------------------------------------------------------------
+  //! Remove the cap stored under the authid of the given cap
+  //!
+  //! @return true if a cap was removed, otherwise false
+  //----------------------------------------------------------------------------
+  bool Remove(shared_cap cap);
 
   template <typename... Args>
   bool RemoveTS(Args&& ... args)
   {
-    std::lock_guard lg(mtx);
     return Remove(std::forward<Args>(args)...);
   }
 
-  bool Remove(shared_cap cap)
-  {
-    // you have to have a write lock for the caps
-    bool rc = mCaps.erase((*cap)()->authid());
-    mInodeCaps[(*cap)()->id()].erase((*cap)()->authid());
-
-    if (!mInodeCaps[(*cap)()->id()].size()) {
-      mInodeCaps.erase((*cap)()->id());
-    }
-
-    mClientInoCaps[(*cap)()->clientid()][(*cap)()->id()].erase((*cap)()->authid());
-
-    if (!mClientInoCaps[(*cap)()->clientid()][(*cap)()->id()].size()) {
-      mClientInoCaps[(*cap)()->clientid()].erase((*cap)()->id());
-
-      if (!mClientInoCaps[(*cap)()->clientid()].size()) {
-        mClientInoCaps.erase((*cap)()->clientid());
-      }
-    }
-
-    mClientCaps[(*cap)()->clientid()].erase((*cap)()->authid());
-
-    if (mClientCaps[(*cap)()->clientid()].size() == 0) {
-      mClientCaps.erase((*cap)()->clientid());
-    }
-
-    return rc;
-  }
-
   int Delete(uint64_t id);
 
-  shared_cap Get(const authid_t& id, bool make_default = true);
+  shared_cap Get(const authid_t& id, bool make_default = true) const;
 
   template <typename... Args>
   auto GetTS(Args&& ... args)
   {
-    std::lock_guard lg(mtx);
     return Get(std::forward<Args>(args)...);
   }
 
-  const capx* GetRaw(const authid_t& id);
-
   int BroadcastCap(shared_cap cap);
 
 
@@ -278,117 +218,137 @@ public:
   std::string Print(const std::string& option,
                     const std::string& filter);
 
-  const auto& GetCaps() const
-  {
-    return mCaps;
-  }
+  //----------------------------------------------------------------------------
+  //! Snapshot of the authid=>cap map, expensive and only meant for tests
+  //----------------------------------------------------------------------------
+  cap_map_t GetCaps() const;
 
-  auto GetAllCaps()
-  {
-    std::vector<shared_cap> results;
-    std::lock_guard lg(mtx);
+  std::vector<shared_cap> GetAllCaps() const;
 
-    for (const auto& kv : mCaps) {
-      results.push_back(kv.second);
-    }
+  bool HasCap(const authid_t& authid) const;
 
-    return results;
-  }
+  bool HasInodeId(const std::string& client_id, uint64_t id) const;
 
-  bool HasCap(authid_t authid)
-  {
-    return (this->mCaps.count(authid) ? true : false);
-  }
+  authid_set_t GetInodeCapAuthIds(const std::string& client_id,
+                                  uint64_t id) const;
 
-  bool HasInodeId(const std::string& client_id,
-                  uint64_t id)
-  {
-    std::lock_guard lg(mtx);
+  //----------------------------------------------------------------------------
+  //! Snapshots of the clientid=>authids and clientid=>inode=>authids views,
+  //! expensive and only meant for tests
+  //----------------------------------------------------------------------------
+  client_set_t ClientCaps() const;
+  client_ino_map_t ClientInoCaps() const;
 
-    if (auto kv = mClientInoCaps.find(client_id);
-        kv != mClientInoCaps.end()) {
-      return kv->second.count(id) > 0;
-    }
+  std::string Dump() const;
 
-    return false;
-  }
+  // Given a pid, return a vector of shared caps matching this
+  // if a reference cap and mdptr are given, these ids are excluded
+  std::vector<shared_cap> GetBroadcastCapsTS(uint64_t pid,
+      shared_cap refcap = nullptr,
+      const eos::fusex::md* mdptr = nullptr,
+      bool suppress = false,
+      std::string suppress_stat_tag = "");
 
-  authid_set_t GetInodeCapAuthIds(const std::string& client_id,
-                                  uint64_t id)
-  {
-    authid_set_t results;
-    std::lock_guard lg(mtx);
-
-    if (auto kv = mClientInoCaps.find(client_id);
-        kv != mClientInoCaps.end()) {
-      if (auto auth_ids = kv->second.find(id);
-          auth_ids != kv->second.end()) {
-        std::copy(auth_ids->second.begin(),
-                  auth_ids->second.end(),
-                  std::inserter(results, results.begin()));
-      }
-    }
+private:
+  //! Expiry timer, due once the time reaches mTick
+  struct TimerEntry {
+    time_t mTick;
+    authid_t mAuthId;
+  };
 
-    return results;
-  }
+  //! authid=>cap shard owning the expiry timers of its caps. All updates of a
+  //! cap go through its shard lock which is taken before the ones of the
+  //! inode and client shards.
+  struct alignas(64) CapShard {
+    mutable std::shared_mutex mMutex;
+    cap_map_t mCaps;
+    std::vector<std::vector<TimerEntry>> mWheel;
+    //! Next tick to be processed by the expiry
+    time_t mCursor {0};
+  };
+
+  //! inode=>(authid=>cap) shard used by the broadcasts
+  struct alignas(64) InodeShard {
+    mutable std::shared_mutex mMutex;
+    std::unordered_map<uint64_t, cap_map_t> mInodes;
+  };
+
+  //! Caps of a client id
+  struct ClientEntry {
+    authid_set_t mAuthIds;
+    ino_map_t mInodes;
+  };
 
-  notify_set_t& InodeCaps()
+  //! clientid=>caps shard
+  struct alignas(64) ClientShard {
+    mutable std::shared_mutex mMutex;
+    std::unordered_map<clientid_t, ClientEntry> mClients;
+  };
+
+  //! uuid=>set of clientid shard
+  struct alignas(64) UuidShard {
+    std::mutex mMutex;
+    client_ids_t mClientIds;
+  };
+
+  template <typename T>
+  static size_t ShardIndex(const T& key)
   {
-    return mInodeCaps;
+    return (std::hash<T>()(key) * 0x9E3779B97F4A7C15ull) >> 58;
   }
 
-  client_set_t& ClientCaps()
+  CapShard& GetCapShard(const authid_t& authid) const
   {
-    return mClientCaps;
+    return mCapShards[ShardIndex(authid)];
   }
 
-  client_ino_map_t& ClientInoCaps()
+  InodeShard& GetInodeShard(uint64_t ino) const
   {
-    return mClientInoCaps;
+    return mInodeShards[ShardIndex(ino)];
   }
 
-  client_ids_t& ClientIds()
+  ClientShard& GetClientShard(const clientid_t& clientid) const
   {
-    return mClientIds;
+    return mClientShards[ShardIndex(clientid)];
   }
 
-  std::string Dump()
+  UuidShard& GetUuidShard(const client_uuid_t& uuid) const
   {
-    std::string s;
-    std::lock_guard lg(mtx);
-    s = std::to_string(mTimeOrderedCap.size()) + " c: " + std::to_string(
-          mCaps.size()) + " cc: "
-        + std::to_string(mClientCaps.size()) + " cic: " + std::to_string(
-          mClientInoCaps.size()) + " ic: "
-        + std::to_string(mInodeCaps.size());
-    return s;
+    return mUuidShards[ShardIndex(uuid)];
   }
 
-  // Given a pid, return a vector of shared caps matching this
-  // if a reference cap and mdptr are given, these ids are excluded
-  std::vector<shared_cap> GetBroadcastCapsTS(uint64_t pid,
-      shared_cap refcap = nullptr,
-      const eos::fusex::md* mdptr = nullptr,
-      bool suppress = false,
-      std::string suppress_stat_tag = "");
-
-
-
-protected:
-
-  std::mutex mtx;
-  // a time ordered multimap pointing to caps
-  std::multimap< time_t, authid_t > mTimeOrderedCap;
-  // authid=>cap lookup map
-  std::unordered_map<authid_t, shared_cap> mCaps;
-  // clientid=>list of authid
-  client_set_t mClientCaps;
-  // clientid=>list of inodes
-  client_ino_map_t mClientInoCaps;
-  // inode=>authid_t
-  notify_set_t mInodeCaps;
-  // uuid=>set of clientid
-  client_ids_t mClientIds;
+  //----------------------------------------------------------------------------
+  //! Store a cap in all the indexes, the cap shard lock must be held
+  //!
+  //! @param shard cap shard of the authid
+  //! @param cap new cap replacing the one with the same authid
+  //----------------------------------------------------------------------------
+  void InsertLocked(CapShard& shard, const shared_cap& cap);
+
+  //----------------------------------------------------------------------------
+  //! Remove a cap from all the indexes, the cap shard lock must be held
+  //----------------------------------------------------------------------------
+  void RemoveLocked(CapShard& shard, cap_map_t::iterator it);
+
+  //----------------------------------------------------------------------------
+  //! Expire the due timers of a shard, the cap shard lock must be held
+  //!
+  //! @return number of caps removed
+  //----------------------------------------------------------------------------
+  size_t ExpireLocked(CapShard& shard, time_t now);
+
+  //----------------------------------------------------------------------------
+  //! Snapshot of the caps of an inode
+  //----------------------------------------------------------------------------
+  std::vector<shared_cap> GetInodeCaps(uint64_t ino) const;
+
+  static_assert(kShards == 64, "shard index uses the top 6 bits of the hash");
+  mutable std::array<CapShard, kShards> mCapShards;
+  mutable std::array<InodeShard, kShards> mInodeShards;
+  mutable std::array<ClientShard, kShards> mClientShards;
+  mutable std::array<UuidShard, kShards> mUuidShards;
+  std::atomic<size_t> mNumCaps {0};
+  std::atomic<ssize_t> mNumTimers {0};
 };
 
 EOSFUSESERVERNAMESPACE_END
@@ -156,13 +156,7 @@ Server::MonitorCaps() noexcept
     EXEC_TIMING_BEGIN("Eosxd::int::MonitorCaps");
 
     // expire caps
-    do {
-      if (Cap().expire()) {
-        Cap().pop();
-      } else {
-        break;
-      }
-    } while (1);
+    Cap().ExpireCaps();
 
     time_t now = time(NULL);
 
@@ -193,7 +187,7 @@ Server::MonitorCaps() noexcept
       std::map<std::string, quotainfo_t> qmap;
       {
         if (EOS_LOGS_DEBUG) {
-          eos_static_debug("looping over caps n=%d", Cap().GetCaps().size());
+          eos_static_debug("looping over caps n=%zu", Cap().Size());
         }
 
         for (auto& it : Cap().GetAllCaps()) {
@@ -21,6 +21,7 @@
  ************************************************************************/
 
 #include "mgm/acl/Acl.hh"
+#include "mgm/acl/AclProgram.hh"
 #include "mgm/egroup/Egroup.hh"
 #include "mgm/ofs/XrdMgmOfs.hh"
 #include "common/StringConversion.hh"
@@ -197,264 +198,243 @@ Acl::Set(std::string sysacl, std::string useracl, std::string tokenacl,
     return;
   }
 
-  int errc = 0;
-  std::vector<std::string> rules;
-  std::string delimiter = ",";
-  eos::common::StringConversion::Tokenize(sysacl, rules, delimiter);
-  int num_sysacl_rules =
-    rules.size();     /* number of entries in sysacl, used to limit "+" (reallow) */
+  std::shared_ptr<const AclProgram> program =
+    AclProgram::Get(sysacl, useracl, allowUserAcl);
 
-  if (allowUserAcl) {
-    eos::common::StringConversion::Tokenize(useracl, rules,
-                                            delimiter);  /* append to rules */
+  if (EOS_LOGS_DEBUG) {
+    eos_static_debug("sysacl '%s', useracl '%s', total %d entries",
+                     sysacl.c_str(), useracl.c_str(), program->mRules.size());
+  }
+
+  Evaluate(*program, vid);
+
+  if (tokenacl.length()) {
+    // for tokens we adverties always to have an ACL
+    mHasAcl = true;
   }
 
   if (EOS_LOGS_DEBUG) {
-    eos_static_debug("sysacl '%s' (%d entries), useracl '%s', total %d entries",
-                     sysacl.c_str(), num_sysacl_rules, useracl.c_str(), rules.size());
+    eos_static_debug(
+      "mCanRead %d mCanNotRead %d mCanWrite %d mCanNotWrite %d mCanWriteOnce %d mCanUpdate %d mCanNotUpdate %d "
+      "mCanBrowse %d mCanNotBrowse %d mCanChmod %d mCanChown %d mCanNotDelete %d mCanNotChmod %d "
+      "mCanDelete %d mCanSetQuota %d mHasAcl %d mHasEgroup %d mIsMutable %d mCanArchive %d mCanPrepare %d mCanIssueToken %d",
+      mCanRead, mCanNotRead, mCanWrite, mCanNotWrite, mCanWriteOnce, mCanUpdate,
+      mCanNotUpdate,
+      mCanBrowse, mCanNotBrowse, mCanChmod, mCanChown, mCanNotDelete, mCanNotChmod,
+      mCanDelete, mCanSetQuota, mHasAcl, mHasEgroup, mIsMutable, mCanArchive,
+      mCanPrepare, mCanIssueToken);
   }
+}
 
-  std::vector<std::string>::const_iterator it;
-  XrdOucString sizestring1;
-  XrdOucString sizestring2;
+//------------------------------------------------------------------------------
+// Evaluate a compiled ACL program for the given identity
+//------------------------------------------------------------------------------
+void
+Acl::Evaluate(const AclProgram& program,
+              const eos::common::VirtualIdentity& vid)
+{
   char denials[256], reallows[256];
   memset(denials, 0, sizeof(denials));        /* start with no denials */
   memset(reallows, 0, sizeof(reallows));      /* nor reallows */
-  std::set<gid_t> gids;
+  int errc = 0;
+  std::string username;
 
-  if (eos::common::Mapping::gSecondaryGroups) {
-    gids = vid.allowed_gids;
-  } else {
-    gids.insert(vid.gid);
+  if (program.mHasUserNames || !program.mEgroups.empty()) {
+    username = eos::common::Mapping::UidToUserName(vid.uid, errc);
+
+    if (errc) {
+      username = "_INVAL_";
+    }
   }
 
-  for (const auto& chk_gid : gids) {
+  // E-group membership is looked up once per e-group and evaluation
+  std::vector<int8_t> egroup_match(program.mEgroups.size(), -1);
+  auto eval_gid = [&](gid_t chk_gid) {
     // Only check non-system groups
     if (chk_gid == 0) {
-      continue;
+      return;
     }
 
-    std::string userid = eos::common::StringConversion::GetSizeString(sizestring1,
-                         (unsigned long long) vid.uid);
-    std::string groupid = eos::common::StringConversion::GetSizeString(sizestring2,
-                          (unsigned long long) chk_gid);
-    std::string usertag = "u:";
-    usertag += userid;
-    usertag += ":";
-    std::string grouptag = "g:";
-    grouptag += groupid;
-    grouptag += ":";
-    std::string username = eos::common::Mapping::UidToUserName(vid.uid, errc);
+    std::string groupname;
 
-    if (errc) {
-      username = "_INVAL_";
+    if (program.mHasGroupNames) {
+      groupname = eos::common::Mapping::GidToGroupName(chk_gid, errc);
+
+      if (errc) {
+        groupname = "_INVAL_";
+      }
     }
 
-    std::string groupname = eos::common::Mapping::GidToGroupName(chk_gid, errc);
+    for (const auto& rule : program.mRules) {
+      bool match = false;
 
-    if (errc) {
-      groupname = "_INVAL_";
-    }
+      switch (rule.mSubject) {
+      case AclProgram::Subject::kUid:
+        match = (rule.mId == vid.uid);
+        break;
 
-    if (EOS_LOGS_DEBUG) {
-      eos_static_debug("username '%s' groupname '%s'", username.c_str(),
-                       groupname.c_str());
-    }
+      case AclProgram::Subject::kUserName:
+        match = (rule.mName == username);
+        break;
 
-    std::string usr_name_tag = "u:";
-    usr_name_tag += username;
-    usr_name_tag += ":";
-    std::string grp_name_tag = "g:";
-    grp_name_tag += groupname;
-    grp_name_tag += ":";
-    std::string ztag = "z:";
-    std::string keytag = "k:";
-    keytag += vid.key;
-    keytag += ":";;
-
-    if (EOS_LOGS_DEBUG) eos_static_debug("%s %s %s %s %s", usertag.c_str(),
-                                           grouptag.c_str(),
-                                           usr_name_tag.c_str(), grp_name_tag.c_str(), keytag.c_str());
-
-    // Rule interpretation logic
-    int sysacl_rules_remaining = num_sysacl_rules;
-
-    for (it = rules.begin(); it != rules.end(); it++) {
-      bool egroupmatch = false;
-      /* when negative, we're in user.acl */
-      sysacl_rules_remaining -= 1;
-
-      // Check for e-group membership
-      if (!it->compare(0, strlen("egroup:"), "egroup:")) {
-        std::vector<std::string> entry;
-        std::string delimiter = ":";
-        eos::common::StringConversion::Tokenize(*it, entry, delimiter);
-
-        if (entry.size() < 3) {
-          continue;
-        }
+      case AclProgram::Subject::kUidOrUserName:
+        match = (rule.mId == vid.uid) || (rule.mName == username);
+        break;
 
-        egroupmatch = gOFS->EgroupRefresh->Member(username, entry[1]);
-        mHasEgroup = egroupmatch;
-      }
+      case AclProgram::Subject::kGid:
+        match = (rule.mId == chk_gid);
+        break;
 
-      // Match 'our' rule
-      if ((!it->compare(0, usertag.length(), usertag)) ||
-          (!it->compare(0, grouptag.length(), grouptag)) ||
-          (!it->compare(0, ztag.length(), ztag)) ||
-          (egroupmatch) ||
-          (!it->compare(0, keytag.length(), keytag)) ||
-          (!it->compare(0, usr_name_tag.length(), usr_name_tag)) ||
-          (!it->compare(0, grp_name_tag.length(), grp_name_tag))) {
-        std::vector<std::string> entry;
-        std::string delimiter = ":";
-        eos::common::StringConversion::Tokenize(*it, entry, delimiter);
-
-        if (entry.size() < 3) {
-          // z tag entries have only two fields
-          if (it->compare(0, ztag.length(), ztag) || (entry.size() < 2)) {
-            continue;
-          }
+      case AclProgram::Subject::kGroupName:
+        match = (rule.mName == groupname);
+        break;
 
-          // add an empty entry field
-          entry.resize(3);
-          entry[2] = entry[1];
-        }
+      case AclProgram::Subject::kGidOrGroupName:
+        match = (rule.mId == chk_gid) || (rule.mName == groupname);
+        break;
 
-        if (EOS_LOGS_DEBUG) {
-          eos_static_debug("parsing permissions '%s'", entry[2].c_str());
-        }
+      case AclProgram::Subject::kKey:
+        match = (rule.mName == vid.key);
+        break;
 
-        bool deny = false, reallow = false;
+      case AclProgram::Subject::kEgroup:
+        if (egroup_match[rule.mId] < 0) {
+          egroup_match[rule.mId] = gOFS->EgroupRefresh->Member(username,
+                                   rule.mName);
+        }
 
-        for (char* s = (char*) entry[2].c_str(); s[0] != 0; s++) {
-          int c = s[0];            /* need a copy in case of an "s++" later */
+        match = egroup_match[rule.mId];
+        mHasEgroup = match;
+        break;
 
-          if (EOS_LOGS_DEBUG) {
-            eos_static_debug("c=%c deny=%d reallow=%d", c, deny, reallow);
-          }
+      case AclProgram::Subject::kAny:
+        match = true;
+        break;
+      }
 
-          if (reallow && !(c == 'u' || c == 'd')) {
-            eos_static_info("'+' Acl flag ignored for '%c'", c);
-          }
+      if (!match) {
+        continue;
+      }
 
-          switch (c) {
-          case '!':
-            deny = true;
-            continue;
+      const AclProgram::Flag* flag = &program.mFlags[rule.mFirstFlag];
 
-          case '+':
-            reallow = true;
-            continue;
+      for (uint32_t i = 0; i < rule.mNumFlags; ++i, ++flag) {
+        unsigned char c = flag->mChar;
+        bool deny = flag->mDeny;
+        bool reallow = flag->mReallow;
 
-          case 'a': // 'a' defines archiving permission
-            mCanArchive = !deny;
-            break;
+        switch (c) {
+        case 'a': // 'a' defines archiving permission
+          mCanArchive = !deny;
+          break;
 
-          case 'A': // 'A' defines sys ACL modification permission
-            mCanSysAcl = !deny;
-            break;
+        case 'A': // 'A' defines sys ACL modification permission
+          mCanSysAcl = !deny;
+          break;
 
-          case 'r': // 'r' defines read permission
-            mCanRead = !deny;
-            break;
+        case 'r': // 'r' defines read permission
+          mCanRead = !deny;
+          break;
 
-          case 'x': // 'x' defines browsing permission
-            mCanBrowse = !deny;
-            break;
+        case 'x': // 'x' defines browsing permission
+          mCanBrowse = !deny;
+          break;
 
-          case 'X': // 'X' defines sys attribute modification permission
-            mCanXAttr = !deny;
-            break;
+        case 'X': // 'X' defines sys attribute modification permission
+          mCanXAttr = !deny;
+          break;
 
-          case 'p': // 'p' defines workflow permission
-            mCanPrepare = !deny;
-            break;
+        case 'p': // 'p' defines workflow permission
+          mCanPrepare = !deny;
+          break;
 
-	  case 't': // 't' defines token issuing
-	    mCanIssueToken = !deny;
-	    break;
+        case 't': // 't' defines token issuing
+          mCanIssueToken = !deny;
+          break;
 
-          case 'm': // 'm' defines mode change permission
-            if (deny) {
-              mCanNotChmod = true;
-            } else {
-              mCanChmod = true;
-            }
+        case 'm': // 'm' defines mode change permission
+          if (deny) {
+            mCanNotChmod = true;
+          } else {
+            mCanChmod = true;
+          }
 
-            break;
-
-          case 'c': // 'c' defines owner change permission (for directories)
-            /* pass here; but chown imposes further restrictions, like limited to sys.acl */
-            mCanChown = true;
-            break;
-
-          case 'd': // '!d' forbids deletion
-            if (deny && !mCanDelete) {
-              mCanNotDelete = true;
-            } else if (reallow) {
-              if (sysacl_rules_remaining < 0) {
-                eos_static_info("'+d' ignored in user acl '%s'", entry[2].c_str());
-                reallow = 0;        /* ignore the reallow */
-                break;
-              }
-
-              mCanDelete = true;
-              mCanNotDelete = false;
-              mCanWriteOnce = false;
-              denials['d'] = 0;               /* drop denial, 'd' and 'u' are "odd" */
+          break;
+
+        case 'c': // 'c' defines owner change permission (for directories)
+          /* pass here; but chown imposes further restrictions, like limited to sys.acl */
+          mCanChown = true;
+          break;
+
+        case 'd': // '!d' forbids deletion
+          if (deny && !mCanDelete) {
+            mCanNotDelete = true;
+          } else if (reallow) {
+            if (!rule.mIsSysAcl) {
+              eos_static_info("'+d' ignored in user acl");
+              reallow = false;        /* ignore the reallow */
+              break;
             }
 
-            break;
+            mCanDelete = true;
+            mCanNotDelete = false;
+            mCanWriteOnce = false;
+            denials['d'] = 0;               /* drop denial, 'd' and 'u' are "odd" */
+          }
 
-          case 'u':// '!u' denies update, re-adding '+u' add update. 
-            mCanUpdate = !deny;
+          break;
 
-            if (mCanUpdate && reallow) {
-              denials['u'] = 0;  /* drop denial, 'd' and 'u' are "odd" */
-            }
+        case 'u':// '!u' denies update, re-adding '+u' add update.
+          mCanUpdate = !deny;
 
-            break;
-
-          case 'w': // 'wo' defines write once permissions, 'w' defines write permissions if 'wo' is not granted
-            if ((s + 1)[0] == 'o') {  /* this is a 'wo' */
-              s++;
-              c = 'W';        /* for the denial entry */
-              mCanWriteOnce = !deny;
-            } else {
-              if (!mCanWriteOnce) {
-                mCanWrite = !deny;
-                mCanUpdate = !deny; // by default 'w' adds update rights
-              }
-            }
+          if (mCanUpdate && reallow) {
+            denials['u'] = 0;  /* drop denial, 'd' and 'u' are "odd" */
+          }
 
-            break;
+          break;
 
-          case 'q':
-            if (sysacl_rules_remaining >=
-                0) { // this is only valid if specified as a sysacl
-              mCanSetQuota = !deny;
+        case 'w': // 'wo' defines write once permissions, 'w' defines write permissions if 'wo' is not granted
+          if (flag->mWriteOnce) {
+            c = 'W';        /* for the denial entry */
+            mCanWriteOnce = !deny;
+          } else {
+            if (!mCanWriteOnce) {
+              mCanWrite = !deny;
+              mCanUpdate = !deny; // by default 'w' adds update rights
             }
+          }
 
-            break;
+          break;
 
-          case 'i': // 'i' makes directories immutable
-            mIsMutable = deny;
-            break;
+        case 'q':
+          if (rule.mIsSysAcl) { // this is only valid if specified as a sysacl
+            mCanSetQuota = !deny;
           }
 
-          mHasAcl = true;
+          break;
 
-          if (reallow) {
-            reallows[c] = 1;    /* remember reallows */
-          } else if (deny) {
-            denials[c] = 1;     /* remember denials */
-          }
+        case 'i': // 'i' makes directories immutable
+          mIsMutable = deny;
+          break;
+        }
 
-          deny = reallow = false;           /* reset for next permission char */
+        mHasAcl = true;
+
+        if (reallow) {
+          reallows[c] = 1;    /* remember reallows */
+        } else if (deny) {
+          denials[c] = 1;     /* remember denials */
         }
       }
     }
+  };
+
+  if (eos::common::Mapping::gSecondaryGroups) {
+    for (const auto& chk_gid : vid.allowed_gids) {
+      eval_gid(chk_gid);
+    }
+  } else {
+    eval_gid(vid.gid);
   }
 
   /* Now that all ACLs have been parsed, handle re-allows and denials */
@@ -547,23 +527,6 @@ Acl::Set(std::string sysacl, std::string useracl, std::string tokenacl,
       break;
     }
   }
-
-  if (tokenacl.length()) {
-    // for tokens we adverties always to have an ACL
-    mHasAcl = true;
-  }
-
-  if (EOS_LOGS_DEBUG) {
-    eos_static_debug(
-      "mCanRead %d mCanNotRead %d mCanWrite %d mCanNotWrite %d mCanWriteOnce %d mCanUpdate %d mCanNotUpdate %d "
-      "mCanBrowse %d mCanNotBrowse %d mCanChmod %d mCanChown %d mCanNotDelete %d mCanNotChmod %d "
-      "mCanDelete %d mCanSetQuota %d mHasAcl %d mHasEgroup %d mIsMutable %d mCanArchive %d mCanPrepare %d mCanIssueToken %d",
-      mCanRead, mCanNotRead, mCanWrite, mCanNotWrite, mCanWriteOnce, mCanUpdate,
-      mCanNotUpdate,
-      mCanBrowse, mCanNotBrowse, mCanChmod, mCanChown, mCanNotDelete, mCanNotChmod,
-      mCanDelete, mCanSetQuota, mHasAcl, mHasEgroup, mIsMutable, mCanArchive,
-      mCanPrepare, mCanIssueToken);
-  }
 }
 
 //------------------------------------------------------------------------------
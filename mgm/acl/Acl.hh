@@ -32,6 +32,8 @@ class XrdOucErrInfo;
 
 EOSMGMNAMESPACE_BEGIN
 
+class AclProgram;
+
 //------------------------------------------------------------------------------
 //! Class implementing access control list interpretation.
 //! ACL rules used in the constructor or in the Set function are strings with
@@ -380,6 +382,16 @@ private:
   bool mEvalDirUserAcl;
   std::string mFileUserAcl;
   bool mEvalFileUserAcl;
+
+  //----------------------------------------------------------------------------
+  //! Evaluate a compiled ACL program for the given identity and set the
+  //! canXX and hasXX booleans accordingly
+  //!
+  //! @param program compiled sys/user acl rules
+  //! @param vid virtual id to match ACL
+  //----------------------------------------------------------------------------
+  void Evaluate(const AclProgram& program,
+                const eos::common::VirtualIdentity& vid);
 };
 
 EOSMGMNAMESPACE_END
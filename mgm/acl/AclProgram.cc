@@ -0,0 +1,312 @@
+//------------------------------------------------------------------------------
+//! @file AclProgram.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/acl/AclProgram.hh"
+#include "common/Logging.hh"
+#include "common/Mapping.hh"
+#include "common/ShardedCache.hh"
+#include "common/StringConversion.hh"
+#include <algorithm>
+#include <cstring>
+
+EOSMGMNAMESPACE_BEGIN
+
+namespace
+{
+using ProgramCache = ShardedCache<uint64_t, AclProgram, IdentityHash<uint64_t>>;
+
+//------------------------------------------------------------------------------
+// Cache of compiled programs, those not used for 5 minutes are dropped. Since
+// the user and group names are resolved when compiling, all the programs are
+// also dropped every 2 cycles so that renames are picked up even for the
+// programs that are always in use.
+//------------------------------------------------------------------------------
+ProgramCache&
+GetProgramCache()
+{
+  static ProgramCache& sCache = []() -> ProgramCache& {
+    static ProgramCache cache(6);
+    cache.set_force_expiry(true, 2);
+    cache.reset_cleanup_thread(300 * 1000, "AclProgramGC");
+    return cache;
+  }();
+  return sCache;
+}
+
+//------------------------------------------------------------------------------
+// Hash of the ACL strings used as cache key
+//------------------------------------------------------------------------------
+uint64_t
+HashAcl(const std::string& sysacl, const std::string& useracl,
+        bool allow_user_acl)
+{
+  uint64_t hash = std::hash<std::string>()(sysacl);
+
+  if (allow_user_acl) {
+    hash ^= std::hash<std::string>()(useracl) + 0x9e3779b97f4a7c15ull +
+            (hash << 6) + (hash >> 2);
+  }
+
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+// Parse an id in the canonical decimal form used by the ACL tags
+//------------------------------------------------------------------------------
+bool
+ParseId(const std::string& str, uint32_t& id)
+{
+  if (str.empty() || (str.length() > 10) ||
+      ((str[0] == '0') && (str.length() > 1)) ||
+      !std::all_of(str.begin(), str.end(), ::isdigit)) {
+    return false;
+  }
+
+  const unsigned long long val = std::stoull(str);
+
+  if (val > UINT32_MAX) {
+    return false;
+  }
+
+  id = (uint32_t) val;
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+// Get the compiled program from the cache
+//------------------------------------------------------------------------------
+std::shared_ptr<const AclProgram>
+AclProgram::Get(const std::string& sysacl, const std::string& useracl,
+                bool allow_user_acl)
+{
+  // An empty user acl does not add any rule
+  allow_user_acl = allow_user_acl && !useracl.empty();
+  const uint64_t key = HashAcl(sysacl, useracl, allow_user_acl);
+  ProgramCache& cache = GetProgramCache();
+  std::shared_ptr<AclProgram> program = cache.retrieve(key);
+
+  if (program && program->Matches(sysacl, useracl, allow_user_acl)) {
+    return program;
+  }
+
+  cache.store(key, std::make_unique<AclProgram>(sysacl, useracl,
+              allow_user_acl), program);
+  return program;
+}
+
+//------------------------------------------------------------------------------
+// Drop all the cached programs
+//------------------------------------------------------------------------------
+void
+AclProgram::ClearCache()
+{
+  GetProgramCache().clear();
+}
+
+//------------------------------------------------------------------------------
+// Get number of cached programs
+//------------------------------------------------------------------------------
+size_t
+AclProgram::GetCacheSize()
+{
+  return GetProgramCache().num_entries();
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+AclProgram::AclProgram(const std::string& sysacl, const std::string& useracl,
+                       bool allow_user_acl):
+  mSysAcl(sysacl), mAllowUserAcl(allow_user_acl)
+{
+  std::vector<std::string> rules;
+  eos::common::StringConversion::Tokenize(sysacl, rules, ",");
+
+  for (const auto& rule : rules) {
+    CompileRule(rule, true);
+  }
+
+  if (allow_user_acl) {
+    mUserAcl = useracl;
+    rules.clear();
+    eos::common::StringConversion::Tokenize(useracl, rules, ",");
+
+    for (const auto& rule : rules) {
+      CompileRule(rule, false);
+    }
+  }
+
+  eos_static_debug("msg=\"compiled acl\" sysacl=\"%s\" useracl=\"%s\" "
+                   "rules=%zu flags=%zu egroups=%zu", sysacl.c_str(),
+                   mUserAcl.c_str(), mRules.size(), mFlags.size(),
+                   mEgroups.size());
+}
+
+//------------------------------------------------------------------------------
+// Compile a single rule
+//------------------------------------------------------------------------------
+void
+AclProgram::CompileRule(const std::string& rule, bool is_sys_acl)
+{
+  std::vector<std::string> entry;
+  eos::common::StringConversion::Tokenize(rule, entry, ":");
+  Rule compiled;
+  compiled.mIsSysAcl = is_sys_acl;
+  compiled.mId = 0;
+  std::string perms;
+
+  if (!rule.compare(0, strlen("egroup:"), "egroup:")) {
+    if (entry.size() < 3) {
+      return;
+    }
+
+    auto it = std::find(mEgroups.begin(), mEgroups.end(), entry[1]);
+
+    if (it == mEgroups.end()) {
+      it = mEgroups.insert(mEgroups.end(), entry[1]);
+    }
+
+    compiled.mSubject = Subject::kEgroup;
+    compiled.mId = it - mEgroups.begin();
+    compiled.mName = entry[1];
+    perms = entry[2];
+  } else if (!rule.compare(0, strlen("z:"), "z:")) {
+    // z tag entries have only two fields
+    if (entry.size() < 2) {
+      return;
+    }
+
+    compiled.mSubject = Subject::kAny;
+    perms = (entry.size() < 3) ? entry[1] : entry[2];
+  } else if ((rule.length() > 2) && (rule[1] == ':') &&
+             ((rule[0] == 'u') || (rule[0] == 'g') || (rule[0] == 'k'))) {
+    // The tags matched are "<type>:<id>:" hence the id ends with a ':'
+    const size_t pos = rule.find(':', 2);
+
+    if ((pos == std::string::npos) || (entry.size() < 3)) {
+      return;
+    }
+
+    const std::string id = rule.substr(2, pos - 2);
+    perms = entry[2];
+
+    if (rule[0] == 'k') {
+      compiled.mSubject = Subject::kKey;
+      compiled.mName = id;
+    } else if (ParseId(id, compiled.mId)) {
+      // A numeric subject also matches a user/group having it as name, like
+      // the "u:<username>:" tag of the interpreter. The name is compared at
+      // evaluation time only if such a user/group exists.
+      int errc = 0;
+      int rev_errc = 0;
+      bool is_name = false;
+
+      if (rule[0] == 'u') {
+        const uid_t uid = eos::common::Mapping::UserNameToUid(id, errc);
+        is_name = !errc && (uid != compiled.mId) &&
+                  (eos::common::Mapping::UidToUserName(uid, rev_errc) == id) &&
+                  !rev_errc;
+        compiled.mSubject = is_name ? Subject::kUidOrUserName : Subject::kUid;
+        mHasUserNames |= is_name;
+      } else {
+        const gid_t gid = eos::common::Mapping::GroupNameToGid(id, errc);
+        is_name = !errc && (gid != compiled.mId) &&
+                  (eos::common::Mapping::GidToGroupName(gid, rev_errc) == id) &&
+                  !rev_errc;
+        compiled.mSubject = is_name ? Subject::kGidOrGroupName : Subject::kGid;
+        mHasGroupNames |= is_name;
+      }
+
+      if (is_name) {
+        compiled.mName = id;
+      }
+    } else {
+      // Resolve the name and make sure the id maps back to the same name
+      int errc = 0;
+      int rev_errc = 0;
+      bool resolved = false;
+
+      if (rule[0] == 'u') {
+        const uid_t uid = eos::common::Mapping::UserNameToUid(id, errc);
+        resolved = !errc &&
+                   (eos::common::Mapping::UidToUserName(uid, rev_errc) == id) &&
+                   !rev_errc;
+        compiled.mId = uid;
+        compiled.mSubject = resolved ? Subject::kUid : Subject::kUserName;
+        mHasUserNames |= !resolved;
+      } else {
+        const gid_t gid = eos::common::Mapping::GroupNameToGid(id, errc);
+        resolved = !errc &&
+                   (eos::common::Mapping::GidToGroupName(gid, rev_errc) == id) &&
+                   !rev_errc;
+        compiled.mId = gid;
+        compiled.mSubject = resolved ? Subject::kGid : Subject::kGroupName;
+        mHasGroupNames |= !resolved;
+      }
+
+      if (!resolved) {
+        compiled.mName = id;
+      }
+    }
+  } else {
+    return;
+  }
+
+  compiled.mFirstFlag = mFlags.size();
+  bool deny = false;
+  bool reallow = false;
+
+  for (size_t i = 0; i < perms.length(); ++i) {
+    char c = perms[i];
+
+    if (c == '!') {
+      deny = true;
+      continue;
+    }
+
+    if (c == '+') {
+      reallow = true;
+      continue;
+    }
+
+    if (reallow && !(c == 'u' || c == 'd')) {
+      eos_static_info("'+' Acl flag ignored for '%c'", c);
+    }
+
+    // 'wo' defines write once permissions
+    const bool write_once = (c == 'w') && (i + 1 < perms.length()) &&
+                            (perms[i + 1] == 'o');
+
+    if (write_once) {
+      ++i;
+    }
+
+    mFlags.push_back(Flag{c, deny, reallow, write_once});
+    deny = reallow = false;
+  }
+
+  compiled.mNumFlags = mFlags.size() - compiled.mFirstFlag;
+  mRules.push_back(std::move(compiled));
+}
+
+EOSMGMNAMESPACE_END
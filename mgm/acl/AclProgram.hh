@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+//! @file AclProgram.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "mgm/Namespace.hh"
+#include <sys/types.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class AclProgram - sys/user ACL strings compiled once into a list of rules
+//! with numeric subjects and pre-parsed permission flags. The programs are
+//! cached by the hash of the ACL strings so that evaluating the ACL of a
+//! directory for a given identity (see Acl::Set) does not need to tokenize
+//! the rules or to convert ids to names for every access check.
+//!
+//! User and group names are resolved to numeric ids when compiling. Names
+//! which do not map back to the same name (unknown users, "_INVAL_" etc.)
+//! are kept and compared with the name of the client identity instead.
+//! Numeric subjects are taken as ids and, if a user or group has the same
+//! numeric name, also compared with the name of the client identity.
+//------------------------------------------------------------------------------
+class AclProgram
+{
+public:
+  //! Subject of a rule
+  enum class Subject : uint8_t {
+    kUid,       ///< u:<uid> or u:<username> resolved to the uid
+    kUserName,  ///< u:<username> which could not be resolved
+    kUidOrUserName, ///< u:<uid> where <uid> is also the name of a user
+    kGid,       ///< g:<gid> or g:<groupname> resolved to the gid
+    kGroupName, ///< g:<groupname> which could not be resolved
+    kGidOrGroupName, ///< g:<gid> where <gid> is also the name of a group
+    kKey,       ///< k:<key>
+    kEgroup,    ///< egroup:<name>
+    kAny        ///< z:
+  };
+
+  //! Permission flag of a rule
+  struct Flag {
+    char mChar;
+    bool mDeny;
+    bool mReallow;
+    bool mWriteOnce; ///< 'wo' stored as 'w'
+  };
+
+  //! Compiled rule, the flags are [mFirstFlag, mFirstFlag + mNumFlags)
+  struct Rule {
+    Subject mSubject;
+    bool mIsSysAcl; ///< rule is part of the sys.acl
+    uint32_t mId; ///< uid/gid for kUid/kGid(Or*Name), egroup index for kEgroup
+    uint32_t mFirstFlag;
+    uint32_t mNumFlags;
+    std::string mName; ///< name for k*Name/kKey/kEgroup
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get the compiled program for the given ACLs from the cache, compiling
+  //! it if needed
+  //!
+  //! @param sysacl system acl definition string
+  //! @param useracl user acl definition string
+  //! @param allow_user_acl if true the user acl rules are appended
+  //!
+  //! @return compiled program
+  //----------------------------------------------------------------------------
+  static std::shared_ptr<const AclProgram>
+  Get(const std::string& sysacl, const std::string& useracl,
+      bool allow_user_acl);
+
+  //----------------------------------------------------------------------------
+  //! Drop all the cached programs
+  //----------------------------------------------------------------------------
+  static void ClearCache();
+
+  //----------------------------------------------------------------------------
+  //! Get number of cached programs
+  //----------------------------------------------------------------------------
+  static size_t GetCacheSize();
+
+  //----------------------------------------------------------------------------
+  //! Constructor - compile the given ACLs
+  //!
+  //! @param sysacl system acl definition string
+  //! @param useracl user acl definition string
+  //! @param allow_user_acl if true the user acl rules are appended
+  //----------------------------------------------------------------------------
+  AclProgram(const std::string& sysacl, const std::string& useracl,
+             bool allow_user_acl);
+
+  //----------------------------------------------------------------------------
+  //! Check if the program was compiled from the given ACLs
+  //----------------------------------------------------------------------------
+  bool Matches(const std::string& sysacl, const std::string& useracl,
+               bool allow_user_acl) const
+  {
+    return (mAllowUserAcl == allow_user_acl) && (mSysAcl == sysacl) &&
+           (!allow_user_acl || (mUserAcl == useracl));
+  }
+
+  std::vector<Rule> mRules; ///< rules in evaluation order
+  std::vector<Flag> mFlags; ///< permission flags of all the rules
+  std::vector<std::string> mEgroups; ///< distinct egroups referenced
+  bool mHasUserNames {false}; ///< some rule needs the client user name
+  bool mHasGroupNames {false}; ///< some rule needs the client group names
+
+private:
+  std::string mSysAcl;
+  std::string mUserAcl;
+  bool mAllowUserAcl;
+
+  //----------------------------------------------------------------------------
+  //! Compile a single rule and append it to the program
+  //!
+  //! @param rule rule string
+  //! @param is_sys_acl true if the rule comes from the sys.acl
+  //----------------------------------------------------------------------------
+  void CompileRule(const std::string& rule, bool is_sys_acl);
+};
+
+EOSMGMNAMESPACE_END
@@ -111,6 +111,13 @@ bool BulkRequestBusiness::exists(const std::string& bulkRequestId,
   return mDaoFactory->getBulkRequestDAO()->exists(bulkRequestId, type);
 }
 
+std::unique_ptr<File> BulkRequestBusiness::getStageBulkRequestFile(
+  const std::string& bulkRequestId, const std::string& path)
+{
+  return mDaoFactory->getBulkRequestDAO()->getFile(bulkRequestId,
+         BulkRequest::PREPARE_STAGE, path);
+}
+
 void BulkRequestBusiness::deleteBulkRequest(const BulkRequest* req)
 {
   return mDaoFactory->getBulkRequestDAO()->deleteBulkRequest(req);
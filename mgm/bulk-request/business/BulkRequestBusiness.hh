@@ -80,6 +80,16 @@ public:
    */
   bool exists(const std::string& bulkRequestId, const BulkRequest::Type& type);
 
+  /**
+   * Returns a file of a persisted stage bulk-request without fetching the
+   * whole bulk-request
+   * @param bulkRequestId the id of the stage bulk-request
+   * @param path the path of the file
+   * @return the file with its eventual error, nullptr if it does not belong to the bulk-request
+   */
+  std::unique_ptr<File> getStageBulkRequestFile(const std::string& bulkRequestId,
+      const std::string& path);
+
   /**
    * Deletes the bulk-request passed in parameter
    * @param req the bulk-request to delete
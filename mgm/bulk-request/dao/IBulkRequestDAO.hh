@@ -86,6 +86,19 @@ public:
    */
   virtual void deleteBulkRequest(const BulkRequest* bulkRequest) = 0;
 
+  /**
+   * Looks up a single file of a persisted bulk-request without fetching
+   * the whole bulk-request
+   * @param bulkRequestId the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param path the path of the file to look up
+   * @returns the file with its eventual error if it belongs to the bulk-request,
+   * nullptr otherwise
+   */
+  virtual std::unique_ptr<File> getFile(const std::string& bulkRequestId,
+                                        const BulkRequest::Type& type,
+                                        const std::string& path) = 0;
+
   virtual ~IBulkRequestDAO() {}
 };
 
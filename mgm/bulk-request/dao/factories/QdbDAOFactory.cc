@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+//! @file QdbDAOFactory.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "QdbDAOFactory.hh"
+#include "mgm/bulk-request/dao/qdb/QdbBulkRequestDAO.hh"
+
+EOSBULKNAMESPACE_BEGIN
+
+QdbDAOFactory::QdbDAOFactory(XrdMgmOfs* fileSystem,
+                             const ProcDirectoryBulkRequestLocations& bulkReqProcDirLocations,
+                             QdbBulkRequestStore& store): mFileSystem(fileSystem),
+  mBulkReqLocations(bulkReqProcDirLocations), mStore(store)
+{
+}
+
+std::unique_ptr<IBulkRequestDAO> QdbDAOFactory::getBulkRequestDAO() const
+{
+  std::unique_ptr<IBulkRequestDAO> ret(new QdbBulkRequestDAO(
+                                         mFileSystem, mBulkReqLocations, mStore));
+  return ret;
+}
+
+EOSBULKNAMESPACE_END
@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+//! @file QdbDAOFactory.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef EOS_QDBDAOFACTORY_HH
+#define EOS_QDBDAOFACTORY_HH
+#include "mgm/Namespace.hh"
+#include "mgm/bulk-request/dao/factories/AbstractDAOFactory.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
+#include "mgm/bulk-request/dao/proc/ProcDirectoryBulkRequestLocations.hh"
+#include "mgm/bulk-request/dao/qdb/QdbBulkRequestStore.hh"
+
+EOSBULKNAMESPACE_BEGIN
+
+/**
+ * Factory of Data Access Object that will rely on
+ * the dedicated QuarkDB bulk-request store
+ */
+class QdbDAOFactory : public AbstractDAOFactory
+{
+public:
+  /**
+   * Factory of QdbBulkRequestDAO objects
+   * @param fileSystem that will allow to resolve the files of the bulk-requests
+   * @param bulkReqProcDirLocations the /proc/ sub-paths of the bulk-requests to migrate to the store
+   * @param store the QuarkDB store where the bulk-requests are persisted
+   */
+  QdbDAOFactory(XrdMgmOfs* fileSystem,
+                const ProcDirectoryBulkRequestLocations& bulkReqProcDirLocations,
+                QdbBulkRequestStore& store);
+  /**
+   * Returns the QuarkDB bulk request DAO object to allow the persistence/access of the
+   * bulk-requests metadata via the dedicated store
+   * @return the BulkRequestDAO object
+   */
+  std::unique_ptr<IBulkRequestDAO> getBulkRequestDAO() const;
+private:
+  XrdMgmOfs* mFileSystem;
+  const ProcDirectoryBulkRequestLocations& mBulkReqLocations;
+  QdbBulkRequestStore& mStore;
+};
+
+EOSBULKNAMESPACE_END
+
+#endif // EOS_QDBDAOFACTORY_HH
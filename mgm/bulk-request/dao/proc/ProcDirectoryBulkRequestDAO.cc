@@ -129,40 +129,46 @@ void ProcDirectoryBulkRequestDAO::generateXattrsMapFromBulkRequest(
   }
 
   for (auto& fileWithMDFuture : filesWithMDFutures) {
-    const std::string currentFilePath = fileWithMDFuture.first.getPath();
-    std::shared_ptr<IFileMD> file;
-    std::string fid;
-
-    try {
-      eos::common::RWMutexReadLock nsLock(mFileSystem->eosViewRWMutex);
-      file = mFileSystem->eosView->getFile(currentFilePath);
-      fid = std::to_string(file->getId());
-    } catch (const eos::MDException& ex) {
-      //The file does not exist, we will store the path with URL encoding
-      std::string encodedFilePath =
-        eos::common::StringConversion::curl_default_escaped(currentFilePath);
-      // curl encoding does not convert dots '.', so we need to do this explicitly
-      eos::common::StringConversion::ReplaceStringInPlace(encodedFilePath, ".",
-          "%2E");
-      fid = encodedFilePath;
-    } catch (const std::exception& ex) {
-      std::ostringstream errMsg;
-      errMsg << "In ProcDirectoryBulkRequestDAO::generateXattrsMapFromBulkRequest(), got a standard exception trying to get informations about the file "
-             << currentFilePath << " ExceptionWhat=\"" << ex.what() << "\"";
-      throw PersistencyException(errMsg.str());
-    }
-
+    const std::string fileXattrKey = generateFileXattrKey(
+                                       fileWithMDFuture.first.getPath());
     //If a potential error has been set for this file, adding it in the value corresponding
     //to this file's extended attribute
-    xattrs[FILE_ID_XATTR_KEY_PREFIX + fid] = "";
+    xattrs[fileXattrKey] = "";
     auto error = fileWithMDFuture.first.getError();
 
     if (error) {
-      xattrs[FILE_ID_XATTR_KEY_PREFIX + fid] = *error;
+      xattrs[fileXattrKey] = *error;
     }
   }
 }
 
+std::string ProcDirectoryBulkRequestDAO::generateFileXattrKey(
+  const std::string& path)
+{
+  std::string fid;
+
+  try {
+    eos::common::RWMutexReadLock nsLock(mFileSystem->eosViewRWMutex);
+    std::shared_ptr<IFileMD> file = mFileSystem->eosView->getFile(path);
+    fid = std::to_string(file->getId());
+  } catch (const eos::MDException& ex) {
+    //The file does not exist, we will store the path with URL encoding
+    std::string encodedFilePath =
+      eos::common::StringConversion::curl_default_escaped(path);
+    // curl encoding does not convert dots '.', so we need to do this explicitly
+    eos::common::StringConversion::ReplaceStringInPlace(encodedFilePath, ".",
+        "%2E");
+    fid = encodedFilePath;
+  } catch (const std::exception& ex) {
+    std::ostringstream errMsg;
+    errMsg << "In ProcDirectoryBulkRequestDAO::generateFileXattrKey(), got a standard exception trying to get informations about the file "
+           << path << " ExceptionWhat=\"" << ex.what() << "\"";
+    throw PersistencyException(errMsg.str());
+  }
+
+  return FILE_ID_XATTR_KEY_PREFIX + fid;
+}
+
 void ProcDirectoryBulkRequestDAO::persistBulkRequestDirectory(
   const std::string& directoryBulkReqPath,
   const eos::IContainerMD::XAttrMap& xattrs)
@@ -599,4 +605,35 @@ void ProcDirectoryBulkRequestDAO::deleteBulkRequest(const BulkRequest*
   deleteDirectory(bulkRequestPath);
 }
 
+std::unique_ptr<File> ProcDirectoryBulkRequestDAO::getFile(
+  const std::string& bulkRequestId, const BulkRequest::Type& type,
+  const std::string& path)
+{
+  std::string bulkRequestPath = generateBulkRequestProcPath(bulkRequestId, type);
+  const std::string fileXattrKey = generateFileXattrKey(path);
+  std::string error;
+
+  try {
+    eos::common::RWMutexReadLock nsLock(mFileSystem->eosViewRWMutex);
+    auto bulkReqDirMd = mFileSystem->eosView->getContainer(bulkRequestPath);
+
+    if (!bulkReqDirMd->hasAttribute(fileXattrKey)) {
+      return nullptr;
+    }
+
+    error = bulkReqDirMd->getAttribute(fileXattrKey);
+  } catch (const eos::MDException& ex) {
+    // The bulk-request does not exist
+    return nullptr;
+  }
+
+  std::unique_ptr<File> file = std::make_unique<File>(path);
+
+  if (!error.empty()) {
+    file->setError(error);
+  }
+
+  return file;
+}
+
 EOSBULKNAMESPACE_END
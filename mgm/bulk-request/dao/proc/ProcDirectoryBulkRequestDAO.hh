@@ -100,9 +100,21 @@ public:
    */
   void deleteBulkRequest(const BulkRequest* bulkRequest) override;
 
+  /**
+   * Looks up the extended attribute of the file on the bulk-request directory
+   * @param bulkRequestId the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param path the path of the file to look up
+   * @returns the file with its eventual error if it belongs to the bulk-request,
+   * nullptr otherwise
+   */
+  std::unique_ptr<File> getFile(const std::string& bulkRequestId,
+                                const BulkRequest::Type& type,
+                                const std::string& path) override;
+
   virtual ~ProcDirectoryBulkRequestDAO() {}
 
-private:
+protected:
   //Interface to the EOS filesystem to allow the creation of files and directories
   XrdMgmOfs* mFileSystem;
   const ProcDirectoryBulkRequestLocations& mProcDirectoryBulkRequestLocations;
@@ -250,6 +262,14 @@ private:
    */
   void persistBulkRequestDirectory(const std::string& directoryBulkReqPath,
                                    const eos::IContainerMD::XAttrMap& xattrs);
+
+  /**
+   * Generate the extended attribute key under which the file is persisted:
+   * the fid of the file if it exists, its URL encoded path otherwise
+   * @param path the path of the file
+   * @return the extended attribute key of the file
+   */
+  std::string generateFileXattrKey(const std::string& path);
 };
 
 EOSBULKNAMESPACE_END
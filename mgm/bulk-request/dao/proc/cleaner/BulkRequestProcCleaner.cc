@@ -27,6 +27,7 @@
 #include <common/IntervalStopwatch.hh>
 #include "mgm/bulk-request/dao/factories/AbstractDAOFactory.hh"
 #include "mgm/bulk-request/dao/factories/ProcDirectoryDAOFactory.hh"
+#include "mgm/bulk-request/dao/factories/QdbDAOFactory.hh"
 #include "mgm/bulk-request/dao/IBulkRequestDAO.hh"
 #include "mgm/bulk-request/exception/PersistencyException.hh"
 
@@ -34,8 +35,9 @@ EOSBULKNAMESPACE_BEGIN
 
 BulkRequestProcCleaner::BulkRequestProcCleaner(const
     bulk::ProcDirectoryBulkRequestLocations& bulkReqDirectory,
-    std::unique_ptr<BulkRequestProcCleanerConfig> config): mBulkRequestLocation(
-        bulkReqDirectory), mConfig(std::move(config))
+    std::unique_ptr<BulkRequestProcCleanerConfig> config,
+    QdbBulkRequestStore* store): mBulkRequestLocation(
+        bulkReqDirectory), mConfig(std::move(config)), mStore(store)
 {
 }
 
@@ -73,8 +75,14 @@ BulkRequestProcCleaner::backgroundThread(ThreadAssistant& assistant)
     // Only a master needs to run the cleaner
     if (gOFS->mMaster->IsMaster()) {
       //Initialize the bulk-request DAO
-      std::unique_ptr<AbstractDAOFactory> daoFactory(new ProcDirectoryDAOFactory(gOFS,
-          mBulkRequestLocation));
+      std::unique_ptr<AbstractDAOFactory> daoFactory;
+
+      if (mStore) {
+        daoFactory.reset(new QdbDAOFactory(gOFS, mBulkRequestLocation, *mStore));
+      } else {
+        daoFactory.reset(new ProcDirectoryDAOFactory(gOFS, mBulkRequestLocation));
+      }
+
       std::unique_ptr<IBulkRequestDAO> bulkReqDao = daoFactory->getBulkRequestDAO();
 
       try {
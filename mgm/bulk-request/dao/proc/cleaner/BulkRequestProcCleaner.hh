@@ -35,11 +35,21 @@
 
 EOSBULKNAMESPACE_BEGIN
 
+class QdbBulkRequestStore;
+
 class BulkRequestProcCleaner
 {
 public:
+  /**
+   * Constructor
+   * @param bulkReqDirectory the location of the bulk-request proc directory
+   * @param config the configuration of the cleaner
+   * @param store the QuarkDB store of the bulk-requests if enabled, in which case
+   * both the store and the proc directory are cleaned
+   */
   BulkRequestProcCleaner(const bulk::ProcDirectoryBulkRequestLocations&
-                         bulkReqDirectory, std::unique_ptr<BulkRequestProcCleanerConfig> config);
+                         bulkReqDirectory, std::unique_ptr<BulkRequestProcCleanerConfig> config,
+                         QdbBulkRequestStore* store = nullptr);
   /**
    * Start the cleaner thread
    */
@@ -68,6 +78,7 @@ private:
   mBulkRequestLocation;  ///< The location of the bulk-request proc directory
   const std::unique_ptr<BulkRequestProcCleanerConfig>
   mConfig; ///< Configuration of the cleaner (e.g interval of execution)
+  QdbBulkRequestStore* mStore; ///< The QuarkDB store of the bulk-requests, nullptr if not enabled
 };
 
 EOSBULKNAMESPACE_END
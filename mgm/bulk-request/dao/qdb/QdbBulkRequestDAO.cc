@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+//! @file QdbBulkRequestDAO.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "QdbBulkRequestDAO.hh"
+#include "mgm/bulk-request/exception/PersistencyException.hh"
+#include <ctime>
+#include <sstream>
+
+EOSBULKNAMESPACE_BEGIN
+
+QdbBulkRequestDAO::QdbBulkRequestDAO(XrdMgmOfs* fileSystem,
+                                     const ProcDirectoryBulkRequestLocations& procDirectoryBulkRequestLocations,
+                                     QdbBulkRequestStore& store):
+  ProcDirectoryBulkRequestDAO(fileSystem, procDirectoryBulkRequestLocations),
+  mStore(store)
+{
+}
+
+void QdbBulkRequestDAO::saveBulkRequest(const StageBulkRequest* bulkRequest)
+{
+  if (bulkRequest->getFiles()->size() == 0) {
+    std::ostringstream oss;
+    oss << "In QdbBulkRequestDAO::saveBulkRequest(), unable to persist the bulk-request id="
+        << bulkRequest->getId() << " because it does not contain any files";
+    throw PersistencyException(oss.str());
+  }
+
+  eos_debug("msg=\"Persistence of the bulk request %s : creating the entries from the bulk-request paths\"",
+            bulkRequest->getId().c_str());
+  eos::IContainerMD::XAttrMap xattrs;
+  generateXattrsMapFromBulkRequest(bulkRequest, xattrs);
+  eos_debug("msg=\"Persistence of the bulk request %s : persisting %zu entries in QuarkDB\"",
+            bulkRequest->getId().c_str(), xattrs.size());
+  mStore.saveBulkRequest(bulkRequest->getId(), bulkRequest->getType(), xattrs);
+}
+
+void QdbBulkRequestDAO::saveBulkRequest(const CancellationBulkRequest*
+                                        bulkRequest)
+{
+  const std::string& id = bulkRequest->getId();
+
+  if (bulkRequest->getFiles()->size() == 0) {
+    std::ostringstream oss;
+    oss << "In QdbBulkRequestDAO::saveBulkRequest(), unable to cancel the bulk-request id="
+        << id << " because it does not contain any files";
+    throw PersistencyException(oss.str());
+  }
+
+  eos::IContainerMD::XAttrMap xattrs;
+
+  if (!mStore.exists(id, bulkRequest->getType()) &&
+      !migrateFromProcDirectory(id, bulkRequest->getType(), xattrs)) {
+    std::ostringstream oss;
+    oss << "In QdbBulkRequestDAO::saveBulkRequest(), unable to cancel the bulk-request id="
+        << id << " because it does not exist";
+    throw PersistencyException(oss.str());
+  }
+
+  mStore.updateLastAccessTime(id, bulkRequest->getType(), std::time(nullptr));
+}
+
+std::unique_ptr<BulkRequest> QdbBulkRequestDAO::getBulkRequest(
+  const std::string& id, const BulkRequest::Type& type)
+{
+  std::unique_ptr<BulkRequest> bulkRequest = nullptr;
+
+  try {
+    eos::IContainerMD::XAttrMap xattrs;
+
+    if (!mStore.getBulkRequest(id, type, xattrs) &&
+        !migrateFromProcDirectory(id, type, xattrs)) {
+      return nullptr;
+    }
+
+    mStore.updateLastAccessTime(id, type, std::time(nullptr));
+
+    switch (type) {
+    case BulkRequest::PREPARE_STAGE: {
+      bulkRequest = initializeStageBulkRequestFromXattrs(id, xattrs);
+      break;
+    }
+
+    default:
+      std::stringstream ss;
+      ss << "The bulk-request has a type (" << BulkRequest::bulkRequestTypeToString(
+           type) << ") that cannot be persisted";
+      throw PersistencyException(ss.str());
+    }
+  } catch (const PersistencyException& ex) {
+    std::ostringstream oss;
+    oss << "In QdbBulkRequestDAO::getBulkRequest(): unable to get the bulk request from the persistency layer "
+        << "ErrorMsg=\"" << ex.what() << "\"";
+    throw PersistencyException(oss.str());
+  }
+
+  return bulkRequest;
+}
+
+bool QdbBulkRequestDAO::migrateFromProcDirectory(const std::string& id,
+    const BulkRequest::Type& type, eos::IContainerMD::XAttrMap& xattrs)
+{
+  std::string bulkRequestProcPath = generateBulkRequestProcPath(id, type);
+
+  if (!existsAndIsDirectory(bulkRequestProcPath)) {
+    return false;
+  }
+
+  fetchExtendedAttributes(bulkRequestProcPath, xattrs);
+  mStore.saveBulkRequest(id, type, xattrs);
+  deleteDirectory(bulkRequestProcPath);
+  eos_info("msg=\"Migrated a bulk request from the /proc/ persistency to QuarkDB\" "
+           "path=\"%s\" nbEntries=%zu", bulkRequestProcPath.c_str(), xattrs.size());
+  return true;
+}
+
+uint64_t QdbBulkRequestDAO::deleteBulkRequestNotQueriedFor(
+  const BulkRequest::Type& type, const std::chrono::seconds& seconds)
+{
+  uint64_t nbDeletedBulkRequests = 0;
+  const std::time_t lastAccessTimeLimit = std::time(nullptr) - seconds.count();
+
+  for (const auto& id : mStore.getBulkRequestsNotAccessedSince(type,
+       lastAccessTimeLimit)) {
+    mStore.deleteBulkRequest(id, type);
+    nbDeletedBulkRequests++;
+    eos_info("msg=\"Deleted a bulk request from the QuarkDB persistency\" id=%s",
+             id.c_str());
+  }
+
+  // The bulk-requests persisted in the /proc/ directory that were never migrated
+  nbDeletedBulkRequests +=
+    ProcDirectoryBulkRequestDAO::deleteBulkRequestNotQueriedFor(type, seconds);
+  return nbDeletedBulkRequests;
+}
+
+bool QdbBulkRequestDAO::exists(const std::string& bulkRequestId,
+                               const BulkRequest::Type& type)
+{
+  return mStore.exists(bulkRequestId, type) ||
+         ProcDirectoryBulkRequestDAO::exists(bulkRequestId, type);
+}
+
+void QdbBulkRequestDAO::deleteBulkRequest(const BulkRequest* bulkRequest)
+{
+  mStore.deleteBulkRequest(bulkRequest->getId(), bulkRequest->getType());
+  ProcDirectoryBulkRequestDAO::deleteBulkRequest(bulkRequest);
+}
+
+std::unique_ptr<File> QdbBulkRequestDAO::getFile(const std::string&
+    bulkRequestId, const BulkRequest::Type& type, const std::string& path)
+{
+  std::string error;
+
+  if (!mStore.getEntry(bulkRequestId, type, generateFileXattrKey(path), error)) {
+    if (!mStore.exists(bulkRequestId, type)) {
+      // The bulk-request may not have been migrated yet
+      return ProcDirectoryBulkRequestDAO::getFile(bulkRequestId, type, path);
+    }
+
+    return nullptr;
+  }
+
+  std::unique_ptr<File> file = std::make_unique<File>(path);
+
+  if (!error.empty()) {
+    file->setError(error);
+  }
+
+  return file;
+}
+
+EOSBULKNAMESPACE_END
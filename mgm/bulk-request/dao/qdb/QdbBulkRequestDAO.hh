@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+//! @file QdbBulkRequestDAO.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef EOS_QDBBULKREQUESTDAO_HH
+#define EOS_QDBBULKREQUESTDAO_HH
+
+#include "mgm/Namespace.hh"
+#include "mgm/bulk-request/dao/proc/ProcDirectoryBulkRequestDAO.hh"
+#include "mgm/bulk-request/dao/qdb/QdbBulkRequestStore.hh"
+
+EOSBULKNAMESPACE_BEGIN
+
+/**
+ * This class is the bulk request persistency layer using the dedicated
+ * QuarkDB bulk-request store
+ *
+ * The files of a bulk-request are kept under the same keys as the extended
+ * attributes of the /proc/ directory persistency (fid.<fid> or fid.<encoded path>),
+ * hence the conversion from/to the bulk-requests is shared with the ProcDirectoryBulkRequestDAO.
+ *
+ * The bulk-requests that were persisted in the /proc/ directory before the QuarkDB
+ * store got enabled are migrated to the store the first time they are accessed.
+ * The ones that are never accessed again are removed by the cleaner.
+ */
+class QdbBulkRequestDAO : public ProcDirectoryBulkRequestDAO
+{
+public:
+  /**
+   * Constructor
+   * @param fileSystem the filesystem used to resolve the paths and fids of the files
+   * @param procDirectoryBulkRequestLocations the /proc/ locations of the bulk-requests to migrate
+   * @param store the QuarkDB store where the bulk-requests are persisted
+   */
+  QdbBulkRequestDAO(XrdMgmOfs* fileSystem,
+                    const ProcDirectoryBulkRequestLocations& procDirectoryBulkRequestLocations,
+                    QdbBulkRequestStore& store);
+
+  /**
+   * Updates the last access time of the stage bulk-request the files to
+   * cancel belong to
+   * @param bulkRequest the cancellation bulk-request
+   */
+  void saveBulkRequest(const CancellationBulkRequest* bulkRequest) override;
+
+  /**
+   * Save the bulk request in the store, one hash field per file
+   * @param bulkRequest the BulkRequest to save
+   */
+  void saveBulkRequest(const StageBulkRequest* bulkRequest) override;
+
+  /**
+   * Get the bulk-request from the store, migrating it from the /proc/ directory if needed
+   * @param id the id of the bulk-request
+   * @param type the type of bulk-request
+   * @return the bulk-request associated to the id and the type, nullptr if it does not exist
+   */
+  std::unique_ptr<BulkRequest> getBulkRequest(const std::string& id,
+      const BulkRequest::Type& type) override;
+
+  /**
+   * Delete all the bulk-request of a certain type that were not accessed for a certain
+   * amount of seconds, from the store and from the /proc/ directory
+   * @param type the bulk-request type to look for
+   * @param seconds the number of seconds after which the bulk-requests can be deleted if they were not queried
+   * @returns the number of deleted bulk-request
+   */
+  uint64_t deleteBulkRequestNotQueriedFor(const BulkRequest::Type& type,
+                                          const std::chrono::seconds& seconds) override;
+
+  /**
+   * Returns true if the bulk-request corresponding to the id and the type
+   * passed in parameters exists, false otherwise
+   * @param bulkRequestId the id of the bulk-request to check
+   * @param type the type of the bulk-request to test
+   * @returns true if the bulk-request exists, false otherwise
+   */
+  bool exists(const std::string& bulkRequestId,
+              const BulkRequest::Type& type) override;
+
+  /**
+   * Deletes the bulk-request passed in parameters from the persistency
+   * @param bulkRequest the bulk-request to delete
+   */
+  void deleteBulkRequest(const BulkRequest* bulkRequest) override;
+
+  /**
+   * Looks up the file in the store with a single hash field lookup
+   * @param bulkRequestId the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param path the path of the file to look up
+   * @returns the file with its eventual error if it belongs to the bulk-request,
+   * nullptr otherwise
+   */
+  std::unique_ptr<File> getFile(const std::string& bulkRequestId,
+                                const BulkRequest::Type& type,
+                                const std::string& path) override;
+
+  virtual ~QdbBulkRequestDAO() {}
+
+private:
+  QdbBulkRequestStore& mStore;
+
+  /**
+   * Moves the bulk-request from the /proc/ directory to the store
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param xattrs will be filled with the entries of the migrated bulk-request
+   * @returns true if the bulk-request was found in the /proc/ directory and migrated, false otherwise
+   */
+  bool migrateFromProcDirectory(const std::string& id,
+                                const BulkRequest::Type& type,
+                                eos::IContainerMD::XAttrMap& xattrs);
+};
+
+EOSBULKNAMESPACE_END
+
+#endif // EOS_QDBBULKREQUESTDAO_HH
@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+//! @file QdbBulkRequestStore.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/bulk-request/dao/qdb/QdbBulkRequestStore.hh"
+#include "mgm/bulk-request/exception/PersistencyException.hh"
+#include "common/Logging.hh"
+#include <qclient/QClient.hh>
+#include <qclient/ResponseParsing.hh>
+#include <qclient/structures/QHash.hh>
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <sstream>
+
+EOSBULKNAMESPACE_BEGIN
+
+namespace
+{
+/**
+ * Throws a PersistencyException if the reply is missing or is an error
+ * @param reply the reply to check
+ * @param context the operation that was executed, for the error message
+ */
+void checkReply(const qclient::redisReplyPtr& reply, const std::string& context)
+{
+  if (!reply || (reply->type == REDIS_REPLY_ERROR)) {
+    std::ostringstream oss;
+    oss << "In QdbBulkRequestStore::" << context << "(), unexpected reply from QDB: "
+        << qclient::describeRedisReply(reply);
+    throw PersistencyException(oss.str());
+  }
+}
+}
+
+QdbBulkRequestStore::QdbBulkRequestStore(const QdbContactDetails&
+    qdbContactDetails):
+  mQcl(std::make_unique<qclient::QClient>(qdbContactDetails.members,
+       qdbContactDetails.constructOptions()))
+{
+}
+
+QdbBulkRequestStore::~QdbBulkRequestStore() = default;
+
+std::string QdbBulkRequestStore::getTypeString(const BulkRequest::Type& type)
+{
+  //The cancellation is done on PREPARE_STAGE bulk-request, it will update the PREPARE_STAGE bulk-request files
+  return BulkRequest::bulkRequestTypeToString((type ==
+         BulkRequest::PREPARE_CANCEL) ? BulkRequest::PREPARE_STAGE : type);
+}
+
+std::string QdbBulkRequestStore::getBulkRequestKey(const std::string& id,
+    const BulkRequest::Type& type)
+{
+  return "eos-bulk-request:" + getTypeString(type) + ":" + id;
+}
+
+std::string QdbBulkRequestStore::getIndexKey(const BulkRequest::Type& type)
+{
+  return "eos-bulk-request-index:" + getTypeString(type);
+}
+
+void QdbBulkRequestStore::saveBulkRequest(const std::string& id,
+    const BulkRequest::Type& type, const Entries& entries)
+{
+  const std::string key = getBulkRequestKey(id, type);
+  std::vector<std::future<qclient::redisReplyPtr>> replies;
+  replies.push_back(mQcl->exec("DEL", key));
+  // The files are sent in batches of pipelined HMSET commands, the replies
+  // are only waited for once everything has been sent
+  std::vector<std::string> request {"HMSET", key};
+  request.reserve(2 + 2 * std::min(entries.size(), BATCH_SIZE));
+
+  for (const auto& entry : entries) {
+    request.push_back(entry.first);
+    request.push_back(entry.second);
+
+    if (request.size() >= 2 + 2 * BATCH_SIZE) {
+      replies.push_back(mQcl->execute(request));
+      request.resize(2);
+    }
+  }
+
+  if (request.size() > 2) {
+    replies.push_back(mQcl->execute(request));
+  }
+
+  auto lastAccessTime = entries.find(LAST_ACCESS_TIME_FIELD);
+  replies.push_back(mQcl->exec("HSET", getIndexKey(type), id,
+                               (lastAccessTime != entries.end()) ?
+                               lastAccessTime->second :
+                               std::to_string(std::time(nullptr))));
+
+  try {
+    for (auto& reply : replies) {
+      checkReply(reply.get(), "saveBulkRequest");
+    }
+  } catch (const PersistencyException&) {
+    try {
+      deleteBulkRequest(id, type);
+    } catch (const PersistencyException& cleanEx) {
+      eos_static_debug("msg=\"unable to clean the bulk-request after a failed "
+                       "save\" id=%s errMsg=\"%s\"", id.c_str(), cleanEx.what());
+    }
+
+    throw;
+  }
+}
+
+bool QdbBulkRequestStore::getBulkRequest(const std::string& id,
+    const BulkRequest::Type& type, Entries& entries)
+{
+  try {
+    qclient::QHash qhash(*mQcl, getBulkRequestKey(id, type));
+
+    for (auto it = qhash.getIterator(BATCH_SIZE, "0"); it.valid(); it.next()) {
+      entries[it.getKey()] = it.getValue();
+    }
+  } catch (const std::exception& ex) {
+    std::ostringstream oss;
+    oss << "In QdbBulkRequestStore::getBulkRequest(), unable to fetch the bulk-request id="
+        << id << " ExceptionWhat=\"" << ex.what() << "\"";
+    throw PersistencyException(oss.str());
+  }
+
+  return !entries.empty();
+}
+
+bool QdbBulkRequestStore::getEntry(const std::string& id,
+                                   const BulkRequest::Type& type,
+                                   const std::string& field, std::string& value)
+{
+  qclient::redisReplyPtr reply = mQcl->exec("HGET", getBulkRequestKey(id, type),
+                                 field).get();
+  checkReply(reply, "getEntry");
+
+  if (reply->type != REDIS_REPLY_STRING) {
+    return false;
+  }
+
+  value.assign(reply->str, reply->len);
+  return true;
+}
+
+void QdbBulkRequestStore::updateLastAccessTime(const std::string& id,
+    const BulkRequest::Type& type, const std::time_t lastAccessTime)
+{
+  const std::string lastAccessTimeStr = std::to_string(lastAccessTime);
+  auto bulkRequestReply = mQcl->exec("HSET", getBulkRequestKey(id, type),
+                                     LAST_ACCESS_TIME_FIELD, lastAccessTimeStr);
+  auto indexReply = mQcl->exec("HSET", getIndexKey(type), id, lastAccessTimeStr);
+  checkReply(bulkRequestReply.get(), "updateLastAccessTime");
+  checkReply(indexReply.get(), "updateLastAccessTime");
+}
+
+bool QdbBulkRequestStore::exists(const std::string& id,
+                                 const BulkRequest::Type& type)
+{
+  qclient::redisReplyPtr reply = mQcl->exec("EXISTS", getBulkRequestKey(id,
+                                 type)).get();
+  checkReply(reply, "exists");
+  return (reply->type == REDIS_REPLY_INTEGER) && (reply->integer != 0);
+}
+
+void QdbBulkRequestStore::deleteBulkRequest(const std::string& id,
+    const BulkRequest::Type& type)
+{
+  auto bulkRequestReply = mQcl->exec("DEL", getBulkRequestKey(id, type));
+  auto indexReply = mQcl->exec("HDEL", getIndexKey(type), id);
+  checkReply(bulkRequestReply.get(), "deleteBulkRequest");
+  checkReply(indexReply.get(), "deleteBulkRequest");
+}
+
+std::vector<std::string>
+QdbBulkRequestStore::getBulkRequestsNotAccessedSince(
+  const BulkRequest::Type& type, const std::time_t time)
+{
+  std::vector<std::string> ids;
+
+  try {
+    qclient::QHash qhash(*mQcl, getIndexKey(type));
+
+    for (auto it = qhash.getIterator(BATCH_SIZE, "0"); it.valid(); it.next()) {
+      if (::strtoll(it.getValue().c_str(), nullptr, 10) < time) {
+        ids.push_back(it.getKey());
+      }
+    }
+  } catch (const std::exception& ex) {
+    std::ostringstream oss;
+    oss << "In QdbBulkRequestStore::getBulkRequestsNotAccessedSince(), unable to list the bulk-requests"
+        << " ExceptionWhat=\"" << ex.what() << "\"";
+    throw PersistencyException(oss.str());
+  }
+
+  return ids;
+}
+
+EOSBULKNAMESPACE_END
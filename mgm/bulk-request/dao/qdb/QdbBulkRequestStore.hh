@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+//! @file QdbBulkRequestStore.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef EOS_QDBBULKREQUESTSTORE_HH
+#define EOS_QDBBULKREQUESTSTORE_HH
+
+#include "mgm/Namespace.hh"
+#include "mgm/bulk-request/BulkRequest.hh"
+#include "namespace/ns_quarkdb/QdbContactDetails.hh"
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace qclient
+{
+class QClient;
+}
+
+EOSBULKNAMESPACE_BEGIN
+
+/**
+ * Dedicated QuarkDB store for the bulk-requests
+ *
+ * Each bulk-request is persisted in its own hash "eos-bulk-request:<type>:<id>"
+ * holding one field per file (the fid of the file or its encoded path, the value
+ * being the eventual error of the file) and the bulk-request metadata
+ * (issuer, creation and last access times). The files are inserted in batches
+ * of pipelined HMSET commands and a single file can be looked up with one HGET.
+ *
+ * The hash "eos-bulk-request-index:<type>" maps the id of every bulk-request to its
+ * last access time so that the cleaner does not need to open every bulk-request.
+ *
+ * The cancellation bulk-requests update the stage bulk-request they refer to,
+ * both types therefore share the same keys.
+ */
+class QdbBulkRequestStore
+{
+public:
+  //! The entries of a bulk-request hash
+  using Entries = std::map<std::string, std::string>;
+
+  //! Field of the bulk-request hash holding its last access time
+  inline static const std::string LAST_ACCESS_TIME_FIELD = "last_accessed_time";
+
+  /**
+   * Constructor
+   * @param qdbContactDetails the QuarkDB cluster where the bulk-requests are stored
+   */
+  QdbBulkRequestStore(const QdbContactDetails& qdbContactDetails);
+
+  ~QdbBulkRequestStore();
+
+  /**
+   * Persists the entries of a bulk-request, replacing any previous content
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param entries the files and metadata of the bulk-request
+   * @throws PersistencyException if the bulk-request could not be persisted
+   */
+  void saveBulkRequest(const std::string& id, const BulkRequest::Type& type,
+                       const Entries& entries);
+
+  /**
+   * Fetches all the entries of a bulk-request
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param entries the map that will be filled with the entries of the bulk-request
+   * @returns true if the bulk-request exists, false otherwise
+   * @throws PersistencyException if the bulk-request could not be fetched
+   */
+  bool getBulkRequest(const std::string& id, const BulkRequest::Type& type,
+                      Entries& entries);
+
+  /**
+   * Fetches a single entry of a bulk-request
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param field the field to fetch
+   * @param value will be set to the value of the field
+   * @returns true if the field exists, false otherwise
+   * @throws PersistencyException if the field could not be fetched
+   */
+  bool getEntry(const std::string& id, const BulkRequest::Type& type,
+                const std::string& field, std::string& value);
+
+  /**
+   * Sets the last access time of a bulk-request
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @param lastAccessTime the last access time to set
+   * @throws PersistencyException if the last access time could not be set
+   */
+  void updateLastAccessTime(const std::string& id, const BulkRequest::Type& type,
+                            const std::time_t lastAccessTime);
+
+  /**
+   * Returns true if the bulk-request exists, false otherwise
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @throws PersistencyException if the check could not be done
+   */
+  bool exists(const std::string& id, const BulkRequest::Type& type);
+
+  /**
+   * Deletes a bulk-request
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   * @throws PersistencyException if the bulk-request could not be deleted
+   */
+  void deleteBulkRequest(const std::string& id, const BulkRequest::Type& type);
+
+  /**
+   * Returns the ids of the bulk-requests of a certain type that were not
+   * accessed since the time given in parameter
+   * @param type the type of the bulk-requests to look for
+   * @param time the time before which the bulk-requests were last accessed
+   * @throws PersistencyException if the index could not be listed
+   */
+  std::vector<std::string> getBulkRequestsNotAccessedSince(
+    const BulkRequest::Type& type, const std::time_t time);
+
+private:
+  //! Number of fields sent per HMSET command or fetched per HSCAN
+  static constexpr size_t BATCH_SIZE = 10000;
+
+  std::unique_ptr<qclient::QClient> mQcl;
+
+  /**
+   * Returns the string representation of the type under which the
+   * bulk-request is stored
+   * @param type the type of the bulk-request
+   */
+  static std::string getTypeString(const BulkRequest::Type& type);
+
+  /**
+   * Returns the key of the hash holding the bulk-request
+   * @param id the id of the bulk-request
+   * @param type the type of the bulk-request
+   */
+  static std::string getBulkRequestKey(const std::string& id,
+                                       const BulkRequest::Type& type);
+
+  /**
+   * Returns the key of the hash indexing the bulk-requests of a type
+   * @param type the type of the bulk-requests
+   */
+  static std::string getIndexKey(const BulkRequest::Type& type);
+};
+
+EOSBULKNAMESPACE_END
+
+#endif // EOS_QDBBULKREQUESTSTORE_HH
@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------
+//! @file CachePrefetchPolicy.cc
+//------------------------------------------------------------------------------
+
+#include "mgm/cache/CachePrefetchPolicy.hh"
+#include <algorithm>
+#include <cmath>
+
+EOSMGMNAMESPACE_BEGIN
+
+namespace
+{
+//! Decayed long-term reads below which an entry is forgotten
+constexpr double kForgetThreshold = 0.05;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+CachePrefetchPolicy::CachePrefetchPolicy():
+  CachePrefetchPolicy(Options())
+{}
+
+CachePrefetchPolicy::CachePrefetchPolicy(const Options& opts)
+{
+  SetOptions(opts);
+}
+
+//------------------------------------------------------------------------------
+// Update the options
+//------------------------------------------------------------------------------
+void
+CachePrefetchPolicy::SetOptions(const Options& opts)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mOptions = opts;
+
+  // Match directories only, "/eos/a" must not cover "/eos/ab/file"
+  for (auto& dir : mOptions.mPaths) {
+    if (dir.empty() || (dir.back() != '/')) {
+      dir += '/';
+    }
+  }
+
+  if (mOptions.mShortHalfLife.count() <= 0) {
+    mOptions.mShortHalfLife = std::chrono::seconds(1);
+  }
+
+  if (mOptions.mLongHalfLife < mOptions.mShortHalfLife) {
+    mOptions.mLongHalfLife = mOptions.mShortHalfLife;
+  }
+
+  // Policy directories are candidates even if they were never read
+  for (const auto& dir : mOptions.mPaths) {
+    (void) mEntries[dir];
+  }
+}
+
+//------------------------------------------------------------------------------
+// Decay the counters of the entry up to now
+//------------------------------------------------------------------------------
+void
+CachePrefetchPolicy::DecayLocked(Entry& entry, time_t now) const
+{
+  if (now <= entry.mLastTs) {
+    return;
+  }
+
+  const double dt = now - entry.mLastTs;
+  entry.mShort *= std::exp2(-dt / mOptions.mShortHalfLife.count());
+  entry.mLong *= std::exp2(-dt / mOptions.mLongHalfLife.count());
+  entry.mLastTs = now;
+}
+
+//------------------------------------------------------------------------------
+// Record a read access
+//------------------------------------------------------------------------------
+void
+CachePrefetchPolicy::RecordAccess(const std::string& path, time_t ts)
+{
+  const size_t pos = path.rfind('/');
+
+  if ((pos == std::string::npos) || (pos + 1 == path.length())) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  AddAccessLocked(path, ts);
+  AddAccessLocked(path.substr(0, pos + 1), ts);
+
+  if (mEntries.size() > mOptions.mMaxTracked + mOptions.mMaxTracked / 8) {
+    PruneLocked(ts);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Account one access to the given entry
+//------------------------------------------------------------------------------
+void
+CachePrefetchPolicy::AddAccessLocked(const std::string& path, time_t ts)
+{
+  auto& entry = mEntries[path];
+  DecayLocked(entry, ts);
+  entry.mShort += 1;
+  entry.mLong += 1;
+}
+
+//------------------------------------------------------------------------------
+// Check if path is below one of the policy directories
+//------------------------------------------------------------------------------
+bool
+CachePrefetchPolicy::MatchesPathPolicy(const std::string& path) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return MatchesPathPolicyLocked(path);
+}
+
+bool
+CachePrefetchPolicy::MatchesPathPolicyLocked(const std::string& path) const
+{
+  for (const auto& dir : mOptions.mPaths) {
+    if (path.compare(0, dir.length(), dir) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Check if the (decayed) entry is trending
+//------------------------------------------------------------------------------
+bool
+CachePrefetchPolicy::IsTrendingLocked(const Entry& entry) const
+{
+  if (entry.mShort < mOptions.mMinReads) {
+    return false;
+  }
+
+  const double short_rate = entry.mShort / mOptions.mShortHalfLife.count();
+  const double long_rate = entry.mLong / mOptions.mLongHalfLife.count();
+  return (short_rate >= mOptions.mTrendFactor * long_rate);
+}
+
+//------------------------------------------------------------------------------
+// Forget cold entries and enforce the maximum number of tracked paths
+//------------------------------------------------------------------------------
+void
+CachePrefetchPolicy::PruneLocked(time_t now)
+{
+  const time_t cooldown = mOptions.mCooldown.count();
+
+  for (auto it = mEntries.begin(); it != mEntries.end();) {
+    DecayLocked(it->second, now);
+
+    if ((it->second.mLong < kForgetThreshold) &&
+        (!it->second.mWarmedTs || (now - it->second.mWarmedTs >= cooldown)) &&
+        !MatchesPathPolicyLocked(it->first)) {
+      it = mEntries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (mEntries.size() <= mOptions.mMaxTracked) {
+    return;
+  }
+
+  // Still too many, drop the least read ones
+  std::vector<std::pair<double, std::string>> order;
+  order.reserve(mEntries.size());
+
+  for (const auto& elem : mEntries) {
+    order.emplace_back(elem.second.mLong, elem.first);
+  }
+
+  const size_t keep = mOptions.mMaxTracked - mOptions.mMaxTracked / 8;
+  const size_t drop = order.size() - keep;
+  std::nth_element(order.begin(), order.begin() + drop, order.end());
+
+  for (size_t i = 0; i < drop; ++i) {
+    mEntries.erase(order[i].second);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the current candidates ordered by decreasing score
+//------------------------------------------------------------------------------
+std::vector<CachePrefetchPolicy::Candidate>
+CachePrefetchPolicy::GetCandidates(time_t now, size_t max)
+{
+  std::vector<Candidate> candidates;
+  std::lock_guard<std::mutex> lock(mMutex);
+  PruneLocked(now);
+  const time_t cooldown = mOptions.mCooldown.count();
+
+  for (auto& elem : mEntries) {
+    const Entry& entry = elem.second;
+
+    if (entry.mWarmedTs && (now - entry.mWarmedTs < cooldown)) {
+      continue;
+    }
+
+    // Files below policy directories are covered by the directory itself
+    const bool directory = (elem.first.back() == '/');
+    const bool policy = MatchesPathPolicyLocked(elem.first);
+
+    if ((directory && policy) || IsTrendingLocked(entry)) {
+      candidates.push_back(Candidate{elem.first, entry.mShort, policy,
+                                     directory});
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+  [](const Candidate & lhs, const Candidate & rhs) {
+    if (lhs.mScore != rhs.mScore) {
+      return lhs.mScore > rhs.mScore;
+    }
+
+    if (lhs.mPolicy != rhs.mPolicy) {
+      return lhs.mPolicy;
+    }
+
+    return lhs.mPath < rhs.mPath;
+  });
+
+  if (candidates.size() > max) {
+    candidates.resize(max);
+  }
+
+  return candidates;
+}
+
+//------------------------------------------------------------------------------
+// Select files fitting in the given byte budget
+//------------------------------------------------------------------------------
+std::vector<CachePrefetchPolicy::Candidate>
+CachePrefetchPolicy::Plan(time_t now, size_t max, uint64_t budget,
+                          const ExpandFunc& expand, const SizeFunc& size_of,
+                          uint64_t& planned)
+{
+  std::vector<Candidate> selected;
+  std::vector<std::string> done_dirs;
+  size_t num_deferred = 0; // Files not fitting the remaining budget
+  planned = 0;
+  // Returns false once the budget is exhausted
+  auto consider = [&](Candidate && file, bool expanded) {
+    if (planned >= budget) {
+      return false;
+    }
+
+    // Files of a directory might have been warmed in a previous cycle
+    if (expanded) {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto it = mEntries.find(file.mPath);
+
+      if ((it != mEntries.end()) && it->second.mWarmedTs &&
+          (now - it->second.mWarmedTs < mOptions.mCooldown.count())) {
+        return true;
+      }
+    }
+
+    const int64_t size = size_of(file);
+
+    // Smaller files further down might still fit the budget
+    if ((size >= 0) && ((uint64_t) size <= budget - planned)) {
+      planned += size;
+      selected.push_back(std::move(file));
+    } else if (size >= 0) {
+      ++num_deferred;
+    }
+
+    return true;
+  };
+
+  // The callbacks may be slow (namespace lookups), evaluate the candidates
+  // without holding the lock
+  for (auto& candidate : GetCandidates(now, max)) {
+    if (!candidate.mDirectory) {
+      if (!consider(std::move(candidate), false)) {
+        break;
+      }
+
+      continue;
+    }
+
+    const size_t deferred_before = num_deferred;
+    bool exhausted = false;
+
+    for (auto& path : expand(candidate)) {
+      if (!consider(Candidate{std::move(path), candidate.mScore,
+                              candidate.mPolicy, false}, true)) {
+        exhausted = true;
+        break;
+      }
+    }
+
+    if (exhausted) {
+      break;
+    }
+
+    // Revisit the directory in the next cycle unless all its files fit
+    if (num_deferred == deferred_before) {
+      done_dirs.push_back(std::move(candidate.mPath));
+    }
+  }
+
+  for (const auto& candidate : selected) {
+    MarkWarmed(candidate.mPath, now);
+  }
+
+  for (const auto& dir : done_dirs) {
+    MarkWarmed(dir, now);
+  }
+
+  return selected;
+}
+
+//------------------------------------------------------------------------------
+// Mark path as warmed
+//------------------------------------------------------------------------------
+void
+CachePrefetchPolicy::MarkWarmed(const std::string& path, time_t now)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto& entry = mEntries[path];
+
+  if (!entry.mLastTs) {
+    entry.mLastTs = now;
+  }
+
+  entry.mWarmedTs = now;
+}
+
+//------------------------------------------------------------------------------
+// Get number of tracked paths
+//------------------------------------------------------------------------------
+size_t
+CachePrefetchPolicy::GetNumTracked() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mEntries.size();
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+//! @file CachePrefetchPolicy.hh
+//! @brief Popularity tracking and candidate selection for cache prefetching
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "mgm/Namespace.hh"
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Tracks the read popularity of files and of their parent directories with
+//! two exponentially decayed counters: a short-term one (minutes) and a
+//! long-term one (about a day). An entry is trending when it had enough
+//! recent reads and its short-term read rate is well above its long-term
+//! rate, i.e. it just became hot.
+//!
+//! Since the first read of a file already populates the cache, the useful
+//! signal is mostly the directory one: a trending directory (e.g. a dataset
+//! picked up by a wave of jobs) gets all its files warmed before the jobs
+//! reach them. Trending files are still proposed, which re-warms them after
+//! an eviction or a remapping of the cache space. The configured policy
+//! directories are always candidates regardless of their read history.
+//!
+//! Selected entries are not proposed again for a cooldown period, so a warmed
+//! file that got evicted is only re-warmed once it trends again.
+//!
+//! Does not depend on the namespace or the FsView so that it can be driven
+//! by recorded access logs in simulations.
+//------------------------------------------------------------------------------
+class CachePrefetchPolicy
+{
+public:
+  struct Options {
+    //! Half-life of the short-term read counter
+    std::chrono::seconds mShortHalfLife {600};
+    //! Half-life of the long-term read counter
+    std::chrono::seconds mLongHalfLife {86400};
+    //! Minimum decayed short-term reads for a path to be trending, about
+    //! three reads within a few minutes
+    double mMinReads {2.5};
+    //! Minimum ratio between the short-term and the long-term read rate
+    double mTrendFactor {4};
+    //! Time during which a selected path is not proposed again
+    std::chrono::seconds mCooldown {3600};
+    //! Maximum number of tracked paths
+    size_t mMaxTracked {100000};
+    //! Directories whose files are always prefetch candidates
+    std::vector<std::string> mPaths;
+  };
+
+  struct Candidate {
+    std::string mPath; ///< File path or directory path ending with '/'
+    double mScore {0}; ///< Decayed short-term reads
+    bool mPolicy {false}; ///< Selected because of a policy directory
+    bool mDirectory {false};
+  };
+
+  //! Returns the number of bytes a file candidate would cost or -1 to skip it
+  using SizeFunc = std::function<int64_t(const Candidate&)>;
+  //! Returns the file paths of a directory candidate
+  using ExpandFunc = std::function<std::vector<std::string>(const Candidate&)>;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  CachePrefetchPolicy();
+  explicit CachePrefetchPolicy(const Options& opts);
+
+  //----------------------------------------------------------------------------
+  //! Update the options, the tracked history is kept
+  //----------------------------------------------------------------------------
+  void SetOptions(const Options& opts);
+
+  //----------------------------------------------------------------------------
+  //! Record a read access of a file, also accounted to its parent directory
+  //!
+  //! @param path file path
+  //! @param ts time of the access
+  //----------------------------------------------------------------------------
+  void RecordAccess(const std::string& path, time_t ts);
+
+  //----------------------------------------------------------------------------
+  //! Check if path is one of the policy directories or below it
+  //----------------------------------------------------------------------------
+  bool MatchesPathPolicy(const std::string& path) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the current candidates ordered by decreasing score, policy
+  //! candidates with the same score go first
+  //!
+  //! @param now current time
+  //! @param max maximum number of candidates
+  //----------------------------------------------------------------------------
+  std::vector<Candidate> GetCandidates(time_t now, size_t max);
+
+  //----------------------------------------------------------------------------
+  //! Select files fitting in the given byte budget. Directory candidates are
+  //! expanded into their files, files for which size_of returns -1 are
+  //! skipped. The selected files are marked as warmed, and so are the
+  //! directories whose files were all considered within the budget.
+  //!
+  //! @param now current time
+  //! @param max maximum number of candidates to evaluate
+  //! @param budget byte budget
+  //! @param expand callback listing the files of a directory candidate
+  //! @param size_of callback returning the cost of a file candidate
+  //! @param planned sum of the sizes of the selected files
+  //!
+  //! @return selected file candidates
+  //----------------------------------------------------------------------------
+  std::vector<Candidate> Plan(time_t now, size_t max, uint64_t budget,
+                              const ExpandFunc& expand,
+                              const SizeFunc& size_of, uint64_t& planned);
+
+  //----------------------------------------------------------------------------
+  //! Mark path as warmed, it is not proposed again during the cooldown
+  //----------------------------------------------------------------------------
+  void MarkWarmed(const std::string& path, time_t now);
+
+  //----------------------------------------------------------------------------
+  //! Get number of tracked paths
+  //----------------------------------------------------------------------------
+  size_t GetNumTracked() const;
+
+private:
+  struct Entry {
+    double mShort {0};
+    double mLong {0};
+    time_t mLastTs {0};
+    time_t mWarmedTs {0};
+  };
+
+  void DecayLocked(Entry& entry, time_t now) const;
+  void AddAccessLocked(const std::string& path, time_t ts);
+  bool MatchesPathPolicyLocked(const std::string& path) const;
+  bool IsTrendingLocked(const Entry& entry) const;
+  void PruneLocked(time_t now);
+
+  mutable std::mutex mMutex;
+  Options mOptions;
+  std::unordered_map<std::string, Entry> mEntries;
+};
+
+EOSMGMNAMESPACE_END
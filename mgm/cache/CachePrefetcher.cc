@@ -0,0 +1,573 @@
+//------------------------------------------------------------------------------
+//! @file CachePrefetcher.cc
+//------------------------------------------------------------------------------
+
+#include "mgm/cache/CachePrefetcher.hh"
+#include "mgm/cache/ReadThroughCache.hh"
+#include "common/Constants.hh"
+#include "common/FileId.hh"
+#include "common/LayoutId.hh"
+#include "common/Logging.hh"
+#include "common/ParseUtils.hh"
+#include "common/Path.hh"
+#include "common/RWMutex.hh"
+#include "common/SecEntity.hh"
+#include "common/StringConversion.hh"
+#include "common/StringTokenizer.hh"
+#include "common/SymKeys.hh"
+#include "mgm/fsview/FsView.hh"
+#include "mgm/imaster/IMaster.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
+#include "namespace/MDException.hh"
+#include "namespace/Prefetcher.hh"
+#include "namespace/interface/ContainerIterators.hh"
+#include "namespace/interface/IView.hh"
+#include <sstream>
+
+EOSMGMNAMESPACE_BEGIN
+
+namespace
+{
+//! Interval between two prefetch cycles
+constexpr uint64_t kCycleInterval = 60;
+//! Maximum number of candidates evaluated per cycle
+constexpr size_t kMaxCandidates = 1000;
+//! Maximum number of files taken from one directory candidate
+constexpr size_t kMaxFilesPerDir = 1000;
+//! Maximum number of prefetched files tracked for the hit statistics
+constexpr size_t kMaxTrackedPrefetched = 100000;
+//! Time after which a warm-up not reported as done is sent again
+constexpr time_t kPendingTimeout = 3600;
+//! Application tag of the prefetch reads
+constexpr auto kAppTag = "eos/cacheprefetch";
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+CachePrefetcher::CachePrefetcher() = default;
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+CachePrefetcher::~CachePrefetcher()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+// Start the prefetch thread
+//------------------------------------------------------------------------------
+void
+CachePrefetcher::Start()
+{
+  mThread.reset(&CachePrefetcher::Run, this);
+}
+
+//------------------------------------------------------------------------------
+// Stop the prefetch thread
+//------------------------------------------------------------------------------
+void
+CachePrefetcher::Stop()
+{
+  mThread.join();
+}
+
+//------------------------------------------------------------------------------
+// Record a read of the given file
+//------------------------------------------------------------------------------
+void
+CachePrefetcher::RecordAccess(const std::string& path, time_t ts)
+{
+  if (!mEnabled) {
+    return;
+  }
+
+  mPolicy.RecordAccess(path, ts);
+}
+
+//------------------------------------------------------------------------------
+// Record a read redirected to the cache
+//------------------------------------------------------------------------------
+void
+CachePrefetcher::RecordCacheOpen(eos::IFileMD::id_t fid,
+                                 eos::common::FileSystem::fsid_t cache_fsid)
+{
+  if (!mEnabled || !cache_fsid) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto it = mPrefetched.find(fid);
+
+  if (it == mPrefetched.end()) {
+    return;
+  }
+
+  ++mHits;
+
+  if (!it->second) {
+    it->second = true;
+    ++mUseful;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Prefetch thread loop
+//------------------------------------------------------------------------------
+void
+CachePrefetcher::Run(ThreadAssistant& assistant) noexcept
+{
+  ThreadAssistant::setSelfThreadName("CachePrefetch");
+  eos_static_info("%s", "msg=\"starting cache prefetcher thread\"");
+
+  while (!assistant.terminationRequested()) {
+    assistant.wait_for(std::chrono::seconds(kCycleInterval));
+
+    if (assistant.terminationRequested()) {
+      break;
+    }
+
+    auto configs = UpdateConfig(kCycleInterval);
+    mEnabled = !configs.empty();
+
+    if (configs.empty() || !gOFS->mMaster->IsMaster()) {
+      continue;
+    }
+
+    RunCycle(time(NULL), configs);
+    ++mCycles;
+  }
+
+  eos_static_info("%s", "msg=\"stopped cache prefetcher thread\"");
+}
+
+//------------------------------------------------------------------------------
+// Collect the backend spaces with prefetching enabled
+//------------------------------------------------------------------------------
+std::map<std::string, CachePrefetcher::SpaceConfig>
+CachePrefetcher::UpdateConfig(uint64_t interval)
+{
+  std::map<std::string, SpaceConfig> configs;
+  CachePrefetchPolicy::Options opts;
+  eos::common::RWMutexReadLock fs_rd_lock(FsView::gFsView.ViewMutex);
+
+  for (const auto& elem : FsView::gFsView.mSpaceView) {
+    FsSpace* space = elem.second;
+
+    if (!space || (space->GetConfigMember(
+                     eos::common::SPACE_CACHE_PREFETCH_NAME) != "on")) {
+      continue;
+    }
+
+    SpaceConfig cfg;
+    int64_t bandwidth = 0;
+
+    if (!eos::common::ParseInt64(space->GetConfigMember(
+                                   eos::common::SPACE_CACHE_PREFETCH_BANDWIDTH_NAME), bandwidth) ||
+        (bandwidth < 0)) {
+      eos::common::ParseInt64(eos::common::SPACE_CACHE_PREFETCH_BANDWIDTH_DEFAULT,
+                              bandwidth);
+    }
+
+    cfg.mBudget = (uint64_t) bandwidth * 1024 * 1024 * interval;
+    cfg.mLowWatermark = space->GetConfigMember(
+                          eos::common::SPACE_CACHE_LOW_WATERMARK_NAME);
+    cfg.mHighWatermark = space->GetConfigMember(
+                           eos::common::SPACE_CACHE_HIGH_WATERMARK_NAME);
+
+    if (cfg.mLowWatermark.empty()) {
+      cfg.mLowWatermark = eos::common::SPACE_CACHE_LOW_WATERMARK_DEFAULT;
+    }
+
+    if (cfg.mHighWatermark.empty()) {
+      cfg.mHighWatermark = eos::common::SPACE_CACHE_HIGH_WATERMARK_DEFAULT;
+    }
+
+    std::vector<std::string> paths = eos::common::StringTokenizer::split
+                                     <std::vector<std::string>>(space->GetConfigMember(
+                                           eos::common::SPACE_CACHE_PREFETCH_PATHS_NAME), ',');
+
+    for (auto& path : paths) {
+      if (!path.empty() && (path != "remove")) {
+        opts.mPaths.push_back(std::move(path));
+      }
+    }
+
+    configs.emplace(elem.first, std::move(cfg));
+  }
+
+  mPolicy.SetOptions(opts);
+  return configs;
+}
+
+//------------------------------------------------------------------------------
+// Run one prefetch cycle
+//------------------------------------------------------------------------------
+void
+CachePrefetcher::RunCycle(time_t now, std::map<std::string, SpaceConfig>&
+                          configs)
+{
+  uint64_t budget = 0;
+
+  for (auto& elem : configs) {
+    elem.second.mPlanned = 0;
+    budget += elem.second.mBudget;
+  }
+
+  std::map<std::string, Request> requests;
+  auto expand = [&](const CachePrefetchPolicy::Candidate & candidate) {
+    return ListFiles(candidate.mPath);
+  };
+  auto size_of = [&](const CachePrefetchPolicy::Candidate & candidate) {
+    Request req;
+
+    if (!Evaluate(candidate.mPath, now, configs, req)) {
+      return (int64_t) - 1;
+    }
+
+    configs[req.mSpace].mPlanned += req.mSize;
+    const int64_t size = req.mSize;
+    requests[candidate.mPath] = std::move(req);
+    return size;
+  };
+  uint64_t planned = 0;
+  const auto selected = mPolicy.Plan(now, kMaxCandidates, budget, expand,
+                                     size_of, planned);
+
+  for (const auto& candidate : selected) {
+    auto it = requests.find(candidate.mPath);
+
+    if ((it == requests.end()) || !SendPrefetch(it->second, configs)) {
+      continue;
+    }
+
+    ++mRequested;
+    mRequestedBytes += it->second.mSize;
+  }
+
+  if (!selected.empty()) {
+    eos_static_info("msg=\"cache prefetch cycle\" files=%lu bytes=%llu",
+                    selected.size(), planned);
+  }
+}
+
+//------------------------------------------------------------------------------
+// List the files of a directory
+//------------------------------------------------------------------------------
+std::vector<std::string>
+CachePrefetcher::ListFiles(const std::string& dir) const
+{
+  std::vector<std::string> files;
+  eos::Prefetcher::prefetchContainerMDWithChildrenAndWait(gOFS->eosView, dir);
+  eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+
+  try {
+    auto cmd = gOFS->eosView->getContainer(dir);
+
+    for (auto it = eos::FileMapIterator(cmd); it.valid(); it.next()) {
+      if (files.size() >= kMaxFilesPerDir) {
+        break;
+      }
+
+      files.push_back(dir + it.key());
+    }
+  } catch (const eos::MDException& e) {
+    eos_static_debug("msg=\"prefetch directory not found\" path=\"%s\"",
+                     dir.c_str());
+  }
+
+  return files;
+}
+
+//------------------------------------------------------------------------------
+// Resolve the file, its backend and cache filesystem
+//------------------------------------------------------------------------------
+bool
+CachePrefetcher::Evaluate(const std::string& path, time_t now,
+                          std::map<std::string, SpaceConfig>& configs,
+                          Request& req)
+{
+  eos::IFileMD::LocationVector locations;
+  std::shared_ptr<eos::IFileMD> fmd;
+  eos::Prefetcher::prefetchFileMDAndWait(gOFS->eosView, path);
+  {
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+
+    try {
+      fmd = gOFS->eosView->getFile(path);
+    } catch (const eos::MDException& e) {
+      return false;
+    }
+
+    req.mFid = fmd->getId();
+    req.mCid = fmd->getContainerId();
+    req.mSize = fmd->getSize();
+    req.mLid = fmd->getLayoutId();
+    req.mPrevCacheFsId = fmd->getCacheLocation();
+    eos::IFileMD::ctime_t mtime;
+    fmd->getMTime(mtime);
+    req.mMTime = mtime.tv_sec;
+    locations = fmd->getLocations();
+  }
+  req.mPath = path;
+
+  // Striped layouts are not served through the cache
+  if (!req.mSize || locations.empty() ||
+      eos::common::LayoutId::IsRain(req.mLid)) {
+    return false;
+  }
+
+  eos::IContainerMD::XAttrMap attrmap;
+  XrdOucErrInfo err;
+  eos::common::VirtualIdentity root_vid = eos::common::VirtualIdentity::Root();
+  eos::common::Path cpath(path.c_str());
+
+  if (gOFS->_attr_ls(cpath.GetParentPath(), err, root_vid, nullptr, attrmap,
+                     true)) {
+    return false;
+  }
+
+  eos::common::RWMutexReadLock fs_rd_lock(FsView::gFsView.ViewMutex);
+
+  for (const auto fsid : locations) {
+    auto* fs = FsView::gFsView.mIdView.lookupByID(fsid);
+
+    if (fs && (fs->GetActiveStatus() == eos::common::ActiveStatus::kOnline) &&
+        (fs->GetConfigStatus() >= eos::common::ConfigStatus::kRO)) {
+      req.mSpace = fs->GetSpace();
+      req.mBackendFsId = fsid;
+      req.mBackendHost = fs->GetString("host");
+      req.mBackendPort = atoi(fs->GetString("port").c_str());
+      break;
+    }
+  }
+
+  auto it_cfg = configs.find(req.mSpace);
+
+  if (!req.mBackendFsId || (it_cfg == configs.end())) {
+    return false;
+  }
+
+  req.mCacheFsId = ReadThroughCache::SelectCacheFs(req.mSpace, fmd, &attrmap);
+  auto* cache_fs = req.mCacheFsId ?
+                   FsView::gFsView.mIdView.lookupByID(req.mCacheFsId) : nullptr;
+
+  if (!cache_fs) {
+    return false;
+  }
+
+  // Already warmed at its current cache location
+  if (req.mPrevCacheFsId == req.mCacheFsId) {
+    mPolicy.MarkWarmed(path, now);
+    return false;
+  }
+
+  // Warm-up still running on the cache FST
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mPending.find(req.mFid);
+
+    if ((it != mPending.end()) && (it->second.mCacheFsId == req.mCacheFsId) &&
+        (it->second.mSent + kPendingTimeout > now)) {
+      return false;
+    }
+  }
+
+  // Speculative data must not push the cache filesystem into eviction
+  const long long capacity = cache_fs->GetLongLong("stat.statfs.capacity");
+  const long long used = cache_fs->GetLongLong("stat.statfs.usedbytes");
+  const long long high = atoll(it_cfg->second.mHighWatermark.c_str());
+
+  if ((capacity <= 0) || ((used + (long long) req.mSize) * 100 >=
+                          high * capacity)) {
+    ++mSkippedFull;
+    return false;
+  }
+
+  if (it_cfg->second.mPlanned + req.mSize > it_cfg->second.mBudget) {
+    return false;
+  }
+
+  req.mCacheHost = cache_fs->GetString("host");
+  req.mCachePort = atoi(cache_fs->GetString("port").c_str());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Send the prefetch request to the cache FST
+//------------------------------------------------------------------------------
+bool
+CachePrefetcher::SendPrefetch(const Request& req,
+                              const std::map<std::string, SpaceConfig>& configs)
+{
+  using eos::common::FileId;
+  using eos::common::LayoutId;
+  using eos::common::StringConversion;
+  {
+    // Warm-ups in flight are never dropped since their completion report
+    // would be rejected, only the expired ones make room for new requests
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mPending.size() >= kMaxTrackedPrefetched) {
+      const time_t now = time(nullptr);
+
+      if (mLastPendingPurge != now) {
+        mLastPendingPurge = now;
+
+        for (auto it = mPending.begin(); it != mPending.end();) {
+          if (it->second.mSent + kPendingTimeout <= now) {
+            it = mPending.erase(it);
+          } else {
+            ++it;
+          }
+        }
+      }
+
+      if (mPending.size() >= kMaxTrackedPrefetched) {
+        eos_static_debug("msg=\"cache prefetch: too many warm-ups in flight\" "
+                         "fxid=%08llx pending=%zu", req.mFid, mPending.size());
+        return false;
+      }
+    }
+  }
+
+  const auto& cfg = configs.at(req.mSpace);
+  std::ostringstream oss;
+  // Read capability for the backend replica, the cache fields are used by
+  // the cache FST to locate the journal and the backend
+  oss << "mgm.access=read"
+      << "&mgm.lid=" << LayoutId::SetLayoutType(req.mLid, LayoutId::kPlain)
+      << "&mgm.cid=" << req.mCid
+      << "&mgm.ruid=1&mgm.rgid=1&mgm.uid=1&mgm.gid=1"
+      << "&mgm.path=" << StringConversion::SealXrdPath(req.mPath)
+      << "&mgm.manager=" << gOFS->ManagerId.c_str()
+      << "&mgm.fid=" << FileId::Fid2Hex(req.mFid)
+      << "&mgm.sec=" << eos::common::SecEntity::ToKey(0, kAppTag)
+      << "&mgm.fsid=" << req.mBackendFsId
+      << "&mgm.cache.fsid=" << req.mCacheFsId
+      << "&mgm.cache.backend.host=" << req.mBackendHost
+      << "&mgm.cache.backend.port=" << req.mBackendPort
+      << "&mgm.cache.backend.fsid=" << req.mBackendFsId
+      << "&mgm.size=" << req.mSize
+      << "&mgm.cache.mtime=" << req.mMTime
+      << "&mgm.cache.low_watermark=" << cfg.mLowWatermark
+      << "&mgm.cache.high_watermark=" << cfg.mHighWatermark;
+  XrdOucEnv incapenv(oss.str().c_str());
+  XrdOucEnv* outcapenv = nullptr;
+  eos::common::SymKey* symkey = eos::common::gSymKeyStore.GetCurrentKey();
+  int caprc = eos::common::SymKey::CreateCapability(&incapenv, outcapenv,
+              symkey, gOFS->mCapabilityValidity);
+
+  if (caprc) {
+    eos_static_err("msg=\"cache prefetch: capability failed\" errno=%d", caprc);
+    ++mFailed;
+    return false;
+  }
+
+  int caplen = 0;
+  std::string qreq = "/?fst.pcmd=cacheprefetch";
+  qreq += outcapenv->Env(caplen);
+  delete outcapenv;
+  std::string qresp;
+
+  if (gOFS->SendQuery(req.mCacheHost, req.mCachePort, qreq, qresp)) {
+    eos_static_info("msg=\"cache prefetch request failed\" fxid=%08llx "
+                    "cache_fsid=%u", req.mFid, req.mCacheFsId);
+    ++mFailed;
+    return false;
+  }
+
+  // The cache location is recorded only once the FST reports the warm-up as
+  // done, see WarmupDone
+  std::lock_guard<std::mutex> lock(mMutex);
+  mPending[req.mFid] = PendingWarmup{req.mCacheFsId, time(nullptr)};
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Handle the completion of a warm-up reported by the cache FST
+//------------------------------------------------------------------------------
+int
+CachePrefetcher::WarmupDone(eos::IFileMD::id_t fid,
+                            eos::common::FileSystem::fsid_t cache_fsid)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mPending.find(fid);
+
+    if ((it == mPending.end()) || (it->second.mCacheFsId != cache_fsid)) {
+      return ENOENT;
+    }
+
+    mPending.erase(it);
+  }
+
+  // Record the cache location, reads are redirected to it anyway and the
+  // now stale journal on the previous cache filesystem is dropped
+  eos::common::FileSystem::fsid_t prev_cache_fsid = 0;
+
+  try {
+    eos::common::RWMutexWriteLock ns_wr_lock(gOFS->eosViewRWMutex);
+    auto fmd = gOFS->eosFileService->getFileMD(fid);
+    prev_cache_fsid = fmd->getCacheLocation();
+
+    if (prev_cache_fsid != cache_fsid) {
+      fmd->setCacheLocation(cache_fsid);
+      gOFS->eosView->updateFileStore(fmd.get());
+    }
+  } catch (const eos::MDException& e) {
+    eos_static_warning("msg=\"failed to persist cache_location\" "
+                       "fxid=%08llx errno=%d", fid, e.getErrno());
+    return e.getErrno();
+  }
+
+  if (prev_cache_fsid && (prev_cache_fsid != cache_fsid)) {
+    (void) ReadThroughCache::NotifyJournalTruncate(prev_cache_fsid, fid);
+  }
+
+  ++mWarmed;
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (mPrefetched.size() >= kMaxTrackedPrefetched) {
+    mPrefetched.clear();
+  }
+
+  mPrefetched[fid] = false;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Get the prefetch statistics
+//------------------------------------------------------------------------------
+std::string
+CachePrefetcher::GetStats(bool monitoring) const
+{
+  std::ostringstream oss;
+  const std::string prefix = "uid=all gid=all ns.cache.prefetch.";
+
+  if (monitoring) {
+    oss << prefix << "enabled=" << (mEnabled ? "true" : "false") << std::endl
+        << prefix << "cycles=" << mCycles << std::endl
+        << prefix << "tracked=" << mPolicy.GetNumTracked() << std::endl
+        << prefix << "requested=" << mRequested << std::endl
+        << prefix << "requested.bytes=" << mRequestedBytes << std::endl
+        << prefix << "failed=" << mFailed << std::endl
+        << prefix << "warmed=" << mWarmed << std::endl
+        << prefix << "skipped_full=" << mSkippedFull << std::endl
+        << prefix << "hits=" << mHits << std::endl
+        << prefix << "useful=" << mUseful << std::endl;
+  } else {
+    oss << "ALL      cache prefetch                   "
+        << "enabled=" << (mEnabled ? "true" : "false")
+        << " cycles=" << mCycles << " tracked=" << mPolicy.GetNumTracked()
+        << " requested=" << mRequested << " requested_bytes=" << mRequestedBytes
+        << " failed=" << mFailed << " warmed=" << mWarmed
+        << " skipped_full=" << mSkippedFull
+        << " hits=" << mHits << " useful=" << mUseful << std::endl;
+  }
+
+  return oss.str();
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+//! @file CachePrefetcher.hh
+//! @brief Background prefetching of popular files into the cache spaces
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "common/AssistedThread.hh"
+#include "common/FileSystem.hh"
+#include "mgm/Namespace.hh"
+#include "mgm/cache/CachePrefetchPolicy.hh"
+#include "namespace/interface/IFileMD.hh"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Warms the read-through cache ahead of the reads. The read reports of the
+//! FSTs feed a CachePrefetchPolicy, every cycle the trending files and
+//! directories plus the configured policy directories are expanded into
+//! files which are sent to the cache FST selected for them. The cache FST
+//! then fetches the missing ranges from the backend in the background.
+//!
+//! Prefetching is enabled per backend space with "space config <space>
+//! space.cache.prefetch=on". The byte budget of a cycle is given by
+//! space.cache.prefetch.bandwidth (MB/s) and files are not prefetched into a
+//! cache filesystem above its high watermark, so speculative data never
+//! causes evictions.
+//------------------------------------------------------------------------------
+class CachePrefetcher
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  CachePrefetcher();
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~CachePrefetcher();
+
+  //----------------------------------------------------------------------------
+  //! Start/stop the prefetch thread
+  //----------------------------------------------------------------------------
+  void Start();
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  //! Record a read of the given file, cheap when prefetching is disabled
+  //!
+  //! @param path file path
+  //! @param ts time of the read
+  //----------------------------------------------------------------------------
+  void RecordAccess(const std::string& path, time_t ts);
+
+  //----------------------------------------------------------------------------
+  //! Record a read redirected to the cache, accounts hits on prefetched files
+  //!
+  //! @param fid file id
+  //! @param cache_fsid cache filesystem serving the read
+  //----------------------------------------------------------------------------
+  void RecordCacheOpen(eos::IFileMD::id_t fid,
+                       eos::common::FileSystem::fsid_t cache_fsid);
+
+  //----------------------------------------------------------------------------
+  //! Handle the completion of a warm-up reported by the cache FST. Only then
+  //! the cache location is recorded and the journal on the previous cache
+  //! filesystem truncated.
+  //!
+  //! @param fid file id
+  //! @param cache_fsid cache filesystem holding the warmed journal
+  //!
+  //! @return 0 if successful, ENOENT if no such warm-up is pending,
+  //!         otherwise an errno value
+  //----------------------------------------------------------------------------
+  int WarmupDone(eos::IFileMD::id_t fid,
+                 eos::common::FileSystem::fsid_t cache_fsid);
+
+  //----------------------------------------------------------------------------
+  //! Get the prefetch statistics
+  //!
+  //! @param monitoring if true print in monitoring format
+  //----------------------------------------------------------------------------
+  std::string GetStats(bool monitoring) const;
+
+private:
+  //! Prefetch settings of a backend space
+  struct SpaceConfig {
+    uint64_t mBudget {0}; ///< Bytes per cycle
+    uint64_t mPlanned {0}; ///< Bytes planned in the current cycle
+    std::string mLowWatermark;
+    std::string mHighWatermark;
+  };
+
+  //! A warm-up sent to a cache FST
+  struct PendingWarmup {
+    eos::common::FileSystem::fsid_t mCacheFsId {0};
+    time_t mSent {0};
+  };
+
+  //! A file selected for prefetching
+  struct Request {
+    eos::IFileMD::id_t mFid {0};
+    eos::IFileMD::id_t mCid {0};
+    std::string mPath;
+    uint64_t mSize {0};
+    time_t mMTime {0};
+    unsigned long mLid {0};
+    std::string mSpace;
+    eos::common::FileSystem::fsid_t mBackendFsId {0};
+    std::string mBackendHost;
+    int mBackendPort {0};
+    eos::common::FileSystem::fsid_t mCacheFsId {0};
+    std::string mCacheHost;
+    int mCachePort {0};
+    eos::common::FileSystem::fsid_t mPrevCacheFsId {0};
+  };
+
+  //----------------------------------------------------------------------------
+  //! Prefetch thread loop
+  //----------------------------------------------------------------------------
+  void Run(ThreadAssistant& assistant) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Collect the backend spaces with prefetching enabled and update the
+  //! policy options
+  //!
+  //! @param interval cycle interval in seconds
+  //!
+  //! @return map of backend space to its settings
+  //----------------------------------------------------------------------------
+  std::map<std::string, SpaceConfig> UpdateConfig(uint64_t interval);
+
+  //----------------------------------------------------------------------------
+  //! Run one prefetch cycle
+  //----------------------------------------------------------------------------
+  void RunCycle(time_t now, std::map<std::string, SpaceConfig>& configs);
+
+  //----------------------------------------------------------------------------
+  //! List the files of a directory, bounded
+  //----------------------------------------------------------------------------
+  std::vector<std::string> ListFiles(const std::string& dir) const;
+
+  //----------------------------------------------------------------------------
+  //! Resolve the file, its backend and cache filesystem
+  //!
+  //! @return true if the file should be prefetched
+  //----------------------------------------------------------------------------
+  bool Evaluate(const std::string& path, time_t now,
+                std::map<std::string, SpaceConfig>& configs, Request& req);
+
+  //----------------------------------------------------------------------------
+  //! Send the prefetch request to the cache FST and track it until the
+  //! warm-up is reported as done
+  //----------------------------------------------------------------------------
+  bool SendPrefetch(const Request& req,
+                    const std::map<std::string, SpaceConfig>& configs);
+
+  AssistedThread mThread;
+  CachePrefetchPolicy mPolicy;
+  std::atomic<bool> mEnabled {false};
+  std::atomic<uint64_t> mCycles {0};
+  std::atomic<uint64_t> mRequested {0};
+  std::atomic<uint64_t> mRequestedBytes {0};
+  std::atomic<uint64_t> mFailed {0};
+  std::atomic<uint64_t> mWarmed {0};
+  std::atomic<uint64_t> mSkippedFull {0};
+  std::atomic<uint64_t> mHits {0};
+  std::atomic<uint64_t> mUseful {0};
+  //! Prefetched files and whether they were read since, bounded
+  mutable std::mutex mMutex;
+  std::unordered_map<eos::IFileMD::id_t, bool> mPrefetched;
+  //! Warm-ups sent to a cache FST and not yet done, bounded - no new ones
+  //! are sent while it is full of warm-ups which did not expire
+  std::unordered_map<eos::IFileMD::id_t, PendingWarmup> mPending;
+  time_t mLastPendingPurge {0}; ///< Last scan for expired warm-ups
+};
+
+EOSMGMNAMESPACE_END
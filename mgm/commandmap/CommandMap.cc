@@ -35,10 +35,12 @@ struct fsctlMapInit {
   {
     fsctlCommandMap["access"] = FsctlCommand::access;
     fsctlCommandMap["adjustreplica"] = FsctlCommand::adjustreplica;
+    fsctlCommandMap["cachewarmed"] = FsctlCommand::cachewarmed;
     fsctlCommandMap["checksum"] = FsctlCommand::checksum;
     fsctlCommandMap["chmod"] = FsctlCommand::chmod;
     fsctlCommandMap["chown"] = FsctlCommand::chown;
     fsctlCommandMap["commit"] = FsctlCommand::commit;
+    fsctlCommandMap["commitbatch"] = FsctlCommand::commitbatch;
     fsctlCommandMap["drop"] = FsctlCommand::drop;
     fsctlCommandMap["event"] = FsctlCommand::event;
     fsctlCommandMap["getfmd"] = FsctlCommand::getfmd;
@@ -34,10 +34,12 @@ enum class FsctlCommand {
   INVALID = 0,
   access,
   adjustreplica,
+  cachewarmed,
   checksum,
   chmod,
   chown,
   commit,
+  commitbatch,
   drop,
   event,
   getfmd,
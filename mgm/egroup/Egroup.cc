@@ -25,7 +25,13 @@
 #include "common/Logging.hh"
 #include "common/StringUtils.hh"
 #include <ldap.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <thread>
 
 //------------------------------------------------------------------------------
 // Delete the LDAP object
@@ -37,24 +43,78 @@ static void ldap_uninitialize(LDAP* ld)
   }
 }
 
+//------------------------------------------------------------------------------
+// Create an LDAP context connected to the CERN LDAP server, nullptr on failure
+//------------------------------------------------------------------------------
+static LDAP* ldap_connect()
+{
+  LDAP* ld = nullptr;
+  static std::mutex s_ldap_mutex;
+  std::unique_lock<std::mutex> lock(s_ldap_mutex);
+  // Initialize the LDAP context in a thread safe manner
+  ldap_initialize(&ld, "ldap://xldap");
+
+  if (ld == nullptr) {
+    eos_static_crit("%s", "msg=\"could not initialize ldap context\"");
+    return nullptr;
+  }
+
+  int version = LDAP_VERSION3;
+
+  if (ldap_set_option(ld, LDAP_OPT_PROTOCOL_VERSION, &version) !=
+      LDAP_OPT_SUCCESS) {
+    eos_static_crit("%s", "msg=\"failure when calling ldap_set_option "
+                    "(protocol version)\"");
+    ldap_uninitialize(ld);
+    return nullptr;
+  }
+
+  // we also need to set a connection timeout
+  struct timeval   tcp_timeout;
+  tcp_timeout.tv_sec = 10;
+  tcp_timeout.tv_usec = 0;
+
+  if (ldap_set_option(ld, LDAP_OPT_NETWORK_TIMEOUT,
+                      &tcp_timeout) != LDAP_OPT_SUCCESS) {
+    eos_static_crit("%s",
+                    "msg=\"failure when calling ldap_set_option (network timeout)\"");
+    ldap_uninitialize(ld);
+    return nullptr;
+  }
+
+  return ld;
+}
+
 EOSMGMNAMESPACE_BEGIN
 
 //------------------------------------------------------------------------------
-// Constructor - launch asynchronous refresh thread
+// Constructor - launch asynchronous refresh threads
 //------------------------------------------------------------------------------
-Egroup::Egroup(common::SteadyClock* clock_) : clock(clock_)
+Egroup::Egroup(common::SteadyClock* clock_, size_t num_threads) :
+  clock(clock_), mLastSnapshot(common::SteadyClock::now(clock_))
 {
-  mPendingQueue.setBlockingMode(true);
-  mThread.reset(&Egroup::Refresh, this);
+  for (size_t i = 0; i < std::max(num_threads, (size_t) 1); ++i) {
+    mThreads.emplace_back(new AssistedThread());
+    mThreads.back()->reset(&Egroup::Refresh, this);
+  }
 }
 
 //------------------------------------------------------------------------------
-// Destructor - join asynchronous refresh thread
+// Destructor - join asynchronous refresh threads and save the snapshot
 //------------------------------------------------------------------------------
 Egroup::~Egroup()
 {
-  mPendingQueue.setBlockingMode(false);
-  mThread.join();
+  {
+    std::unique_lock<std::mutex> lock(mMutexPending);
+    mShutdown = true;
+  }
+  mCvPending.notify_all();
+
+  for (auto& thread : mThreads) {
+    thread->join();
+  }
+
+  SaveSnapshot();
 }
 
 //----------------------------------------------------------------------------
@@ -62,150 +122,163 @@ Egroup::~Egroup()
 //----------------------------------------------------------------------------
 size_t Egroup::getPendingQueueSize() const
 {
-  return mPendingQueue.size();
+  std::unique_lock<std::mutex> lock(mMutexPending);
+  return mPendingSet.size();
 }
 
 //------------------------------------------------------------------------------
-// Main LDAP lookup function - bypasses the cache, hits the LDAP server.
+// Main LDAP lookup function - bypasses the cache, hits the LDAP server and
+// returns all the egroups the user is member of.
 //------------------------------------------------------------------------------
-Egroup::Status Egroup::isMemberUncached(const std::string& username,
-                                        const std::string& egroupname)
+Egroup::Status Egroup::fetchUserUncached(const std::string& username,
+    EgroupSet& egroups)
 {
+  ++mLdapQueryCount;
   // Serving real, or simulated data?
-  if (!injections.empty()) {
-    auto it = injections.find(egroupname);
+  {
+    std::unique_lock<std::mutex> lock(mMutexInjections);
 
-    if (it == injections.end()) {
-      return Status::kNotMember;
-    }
+    if (!injections.empty()) {
+      Status status = Status::kNotMember;
 
-    auto it2 = it->second.find(username);
+      for (const auto& egroup : injections) {
+        auto it = egroup.second.find(username);
 
-    if (it2 == it->second.end()) {
-      return Status::kNotMember;
-    }
+        if (it == egroup.second.end()) {
+          continue;
+        }
 
-    return it2->second;
-  }
+        if (it->second == Status::kError) {
+          status = Status::kError;
+        } else if (it->second == Status::kMember) {
+          egroups.insert(egroup.first);
+        }
+      }
 
-  // Run the LDAP query
-  LDAP* ld = nullptr;
-  {
-    static std::mutex s_ldap_mutex;
-    std::unique_lock<std::mutex> lock(s_ldap_mutex);
-    // Initialize the LDAP context in a thread safe manner
-    ldap_initialize(&ld, "ldap://xldap");
+      std::chrono::milliseconds latency = mInjectedLatency;
+      lock.unlock();
 
-    if (ld == nullptr) {
-      eos_static_crit("%s", "msg=\"could not initialize ldap context\"");
-      return Status::kError;
-    }
+      if (latency.count()) {
+        std::this_thread::sleep_for(latency);
+      }
 
-    int version = LDAP_VERSION3;
+      if ((status != Status::kError) && !egroups.empty()) {
+        status = Status::kMember;
+      }
 
-    if (ldap_set_option(ld, LDAP_OPT_PROTOCOL_VERSION, &version) !=
-        LDAP_OPT_SUCCESS) {
-      eos_static_crit("%s", "msg=\"failure when calling ldap_set_option "
-                      "(protocol version)\"");
-      ldap_uninitialize(ld);
-      return Status::kError;
+      return status;
     }
+  }
+  // Run the LDAP query
+  LDAP* ld = ldap_connect();
 
-    // we also need to set a connection timeout
-    struct timeval   tcp_timeout;
-    tcp_timeout.tv_sec = 10;
-    tcp_timeout.tv_usec = 0;
-
-    if (ldap_set_option(ld, LDAP_OPT_NETWORK_TIMEOUT,
-                        &tcp_timeout) != LDAP_OPT_SUCCESS) {
-      eos_static_crit("%s",
-                      "msg=\"failure when calling ldap_set_option (network timeout)\"");
-      ldap_uninitialize(ld);
-      return Status::kError;
-    }
+  if (ld == nullptr) {
+    return Status::kError;
   }
+
   std::unique_ptr<LDAP, decltype(ldap_uninitialize)*>
   ldOwnership(ld, ldap_uninitialize);
   //----------------------------------------------------------------------------
   // These hardcoded values are CERN specific... we should pass them through
   // the configuration, or something.
+  //
+  // All the egroups having the user as (recursive) member are returned by a
+  // single search, in pages since a user can belong to many egroups.
   //----------------------------------------------------------------------------
-  std::string sbase = "CN=";
-  sbase += username;
-  sbase += ",OU=Users,Ou=Organic Units,DC=cern,DC=ch";
-  // the LDAP attribute (recursive search)
+  std::string sbase = "OU=e-groups,OU=Workgroups,DC=cern,DC=ch";
+  // the LDAP attribute
   std::string attr = "cn";
-  // the LDAP filter
+  // the LDAP filter (recursive search)
   std::string filter;
-  filter = "(memberOf:1.2.840.113556.1.4.1941:=CN=";
-  filter += egroupname;
-  filter += ",OU=e-groups,OU=Workgroups,DC=cern,DC=ch)";
+  filter = "(member:1.2.840.113556.1.4.1941:=CN=";
+  filter += username;
+  filter += ",OU=Users,OU=Organic Units,DC=cern,DC=ch)";
   char* attrs[2];
   attrs[0] = (char*) attr.c_str();
   attrs[1] = NULL;
-  LDAPMessage* res = nullptr;
   struct timeval timeout;
   timeout.tv_sec = 10;
   timeout.tv_usec = 0;
-  std::string match = username;
-  eos_static_debug("base=%s attr=%s filter=%s match=%s\n", sbase.c_str(),
-                   attr.c_str(), filter.c_str(), match.c_str());
-  int rc = ldap_search_ext_s(ld, sbase.c_str(), LDAP_SCOPE_SUBTREE,
-                             filter.c_str(),
-                             attrs, 0, NULL, NULL,
-                             &timeout, LDAP_NO_LIMIT, &res);
-  std::unique_ptr<LDAPMessage, decltype(ldap_msgfree)*> resOwnership(res,
-      ldap_msgfree);
-
-  if (res == nullptr || rc != LDAP_SUCCESS) {
-    eos_static_warning("Having trouble connecting to ldap server, user=%s, "
-                       "e-group=%s ldap_rc=%i ldap_err_msg=\"%s\"",
-                       username.c_str(), egroupname.c_str(), rc,
-                       ldap_err2string(rc));
-
-    if (rc == LDAP_NO_SUCH_OBJECT) {
-      // no such object, return not member to make it cacheable
-      return Status::kNotMember;
-    } else {
+  struct berval cookie {
+    0, nullptr
+  };
+  eos_static_debug("base=%s attr=%s filter=%s\n", sbase.c_str(), attr.c_str(),
+                   filter.c_str());
+
+  do {
+    LDAPControl* page_control = nullptr;
+
+    if (ldap_create_page_control(ld, 1000, &cookie, 0, &page_control) !=
+        LDAP_SUCCESS) {
+      eos_static_crit("%s", "msg=\"failure when creating the ldap page control\"");
+      ber_memfree(cookie.bv_val);
       return Status::kError;
     }
-  }
-
-  if (ldap_count_entries(ld, res) == 0) {
-    return Status::kNotMember;
-  }
 
-  //----------------------------------------------------------------------------
-  // We have a response from the server, check if we're member of given egroup
-  //----------------------------------------------------------------------------
-  bool isMember = false;
+    LDAPControl* server_controls[2] = {page_control, nullptr};
+    LDAPMessage* res = nullptr;
+    int rc = ldap_search_ext_s(ld, sbase.c_str(), LDAP_SCOPE_SUBTREE,
+                               filter.c_str(), attrs, 0, server_controls, NULL,
+                               &timeout, LDAP_NO_LIMIT, &res);
+    ldap_control_free(page_control);
+    ber_memfree(cookie.bv_val);
+    cookie = {0, nullptr};
+    std::unique_ptr<LDAPMessage, decltype(ldap_msgfree)*> resOwnership(res,
+        ldap_msgfree);
+
+    if (res == nullptr || rc != LDAP_SUCCESS) {
+      if (rc == LDAP_NO_SUCH_OBJECT) {
+        // no such object, return not member to make it cacheable
+        return Status::kNotMember;
+      }
 
-  for (LDAPMessage* e = ldap_first_entry(ld, res); e != nullptr;
-       e = ldap_next_entry(ld, e)) {
-    struct berval** v = ldap_get_values_len(ld, e, attr.c_str());
+      eos_static_warning("Having trouble connecting to ldap server, user=%s "
+                         "ldap_rc=%i ldap_err_msg=\"%s\"", username.c_str(), rc,
+                         ldap_err2string(rc));
+      return Status::kError;
+    }
 
-    if (v != nullptr) {
-      int n = ldap_count_values_len(v);
-      int j;
+    for (LDAPMessage* e = ldap_first_entry(ld, res); e != nullptr;
+         e = ldap_next_entry(ld, e)) {
+      struct berval** v = ldap_get_values_len(ld, e, attr.c_str());
 
-      for (j = 0; j < n; j++) {
-        std::string result = v[ j ]->bv_val;
-        eos_static_info("result=%d %s", n, result.c_str());
+      if (v != nullptr) {
+        int n = ldap_count_values_len(v);
 
-        if ((result.find(match)) != std::string::npos) {
-          isMember = true;
+        for (int j = 0; j < n; j++) {
+          egroups.emplace(v[j]->bv_val, v[j]->bv_len);
         }
+
+        ldap_value_free_len(v);
       }
+    }
+
+    // Retrieve the cookie of the next page, if any
+    LDAPControl** returned_controls = nullptr;
+    int err = LDAP_SUCCESS;
 
-      ldap_value_free_len(v);
+    if (ldap_parse_result(ld, res, &err, NULL, NULL, NULL, &returned_controls,
+                          0) != LDAP_SUCCESS) {
+      eos_static_warning("msg=\"failed to parse ldap result\" user=%s",
+                         username.c_str());
+      return Status::kError;
     }
-  }
 
-  if (isMember) {
-    return Status::kMember;
-  }
+    LDAPControl* response_control =
+      ldap_control_find(LDAP_CONTROL_PAGEDRESULTS, returned_controls, NULL);
+
+    if (response_control != nullptr) {
+      ber_int_t count = 0;
+      ldap_parse_pageresponse_control(ld, response_control, &count, &cookie);
+    }
 
-  return Status::kNotMember;
+    ldap_controls_free(returned_controls);
+  } while (cookie.bv_val != nullptr && cookie.bv_len > 0);
+
+  ber_memfree(cookie.bv_val);
+  eos_static_info("msg=\"ldap lookup\" user=%s egroups=%zu", username.c_str(),
+                  egroups.size());
+  return egroups.empty() ? Status::kNotMember : Status::kMember;
 }
 
 //------------------------------------------------------------------------------
@@ -242,14 +315,91 @@ bool Egroup::fetchCached(const std::string& username,
   return true;
 }
 
+//------------------------------------------------------------------------------
+// Store the memberships of a user and update all its cached pairs
+//------------------------------------------------------------------------------
+void Egroup::storeUserIntoCache(const std::string& username,
+                                const UserEntry& entry)
+{
+  eos::common::RWMutexWriteLock wr_lock(mMutex);
+  mUsers[username] = entry;
+
+  for (auto& egroup : cache) {
+    auto it = egroup.second.find(username);
+
+    if (it != egroup.second.end()) {
+      it->second = CachedEntry(entry.egroups.count(egroup.first),
+                               entry.timestamp);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Fetch the cached memberships of a user. Returns false if there's no such
+// cached value.
+//------------------------------------------------------------------------------
+bool Egroup::fetchCachedUser(const std::string& username, UserEntry& out)
+{
+  eos::common::RWMutexReadLock rd_lock(mMutex);
+  auto it = mUsers.find(username);
+
+  if (it == mUsers.end()) {
+    return false;
+  }
+
+  out = it->second;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Look up the memberships of a user and store them into the cache
+//------------------------------------------------------------------------------
+bool Egroup::fetchUser(const std::string& username, UserEntry& out)
+{
+  std::promise<std::pair<bool, UserEntry>> promise;
+  {
+    std::unique_lock<std::mutex> lock(mMutexFetches);
+    auto it = mFetches.find(username);
+
+    if (it != mFetches.end()) {
+      // Somebody is already looking up this user, wait for the result
+      std::shared_future<std::pair<bool, UserEntry>> future = it->second;
+      lock.unlock();
+      out = future.get().second;
+      return future.get().first;
+    }
+
+    mFetches[username] = promise.get_future().share();
+  }
+  UserEntry entry;
+  bool ok = (fetchUserUncached(username, entry.egroups) != Status::kError);
+  entry.timestamp = common::SteadyClock::now(clock);
+
+  if (ok) {
+    storeUserIntoCache(username, entry);
+  } else if (!fetchCachedUser(username, entry)) {
+    // Negative entry expiring after kErrorCacheDuration, so that a failing
+    // LDAP server is not hit on every access and is retried asynchronously
+    entry.egroups.clear();
+    entry.timestamp -= kCacheDuration - kErrorCacheDuration;
+    storeUserIntoCache(username, entry);
+  }
+
+  out = entry;
+  promise.set_value(std::make_pair(ok, entry));
+  std::unique_lock<std::mutex> lock(mMutexFetches);
+  mFetches.erase(username);
+  return ok;
+}
+
 //------------------------------------------------------------------------------
 // Check if cache entry is stale
 //------------------------------------------------------------------------------
-bool Egroup::isStale(const CachedEntry& entry) const
+bool Egroup::isStale(std::chrono::steady_clock::time_point timestamp) const
 {
   std::chrono::steady_clock::time_point now = common::SteadyClock::now(clock);
 
-  if (entry.timestamp + kCacheDuration < now) {
+  if (timestamp + kCacheDuration < now) {
     return true;
   }
 
@@ -261,14 +411,24 @@ bool Egroup::isStale(const CachedEntry& entry) const
 // this class tries to contact the LDAP server, it will serve injected data
 // instead.
 //
-// Simulates response of "isMemberUncached" function.
+// Simulates response of "fetchUserUncached" function.
 //------------------------------------------------------------------------------
 void Egroup::inject(const std::string& username, const std::string& egroupname,
                     Status status)
 {
+  std::unique_lock<std::mutex> lock(mMutexInjections);
   injections[egroupname][username] = status;
 }
 
+//------------------------------------------------------------------------------
+// Delay every lookup served from the injected data
+//------------------------------------------------------------------------------
+void Egroup::injectLatency(std::chrono::milliseconds latency)
+{
+  std::unique_lock<std::mutex> lock(mMutexInjections);
+  mInjectedLatency = latency;
+}
+
 //------------------------------------------------------------------------------
 // Major query method - uses cache
 //------------------------------------------------------------------------------
@@ -279,79 +439,112 @@ Egroup::CachedEntry Egroup::query(const std::string& username,
 
   if (fetchCached(username, egroupname, entry)) {
     // Cache hit - do we need to schedule an asynchronous refresh?
-    if (isStale(entry)) {
+    if (isStale(entry.timestamp)) {
       scheduleRefresh(username, egroupname);
     }
 
     return entry;
   }
 
-  // Cache miss, need to talk to LDAP server
-  Status status = isMemberUncached(username, egroupname);
-  bool isMember = (status == Status::kMember);
-  std::chrono::steady_clock::time_point now = common::SteadyClock::now(clock);
+  // Cache miss, resolve from the memberships of the user which need to be
+  // fetched from the LDAP server if this user was never seen before
+  UserEntry user;
+
+  if (!fetchCachedUser(username, user)) {
+    (void) fetchUser(username, user);
+  } else if (isStale(user.timestamp)) {
+    scheduleRefresh(username, egroupname);
+  }
+
+  bool isMember = user.egroups.count(egroupname);
   uint64_t expiration = common::SteadyClock::SecondsSinceEpoch(
-                          now + kCacheDuration).count();
+                          user.timestamp + kCacheDuration).count();
   eos_static_info("member=%s user=\"%s\" e-group=\"%s\" expiration=%lu",
                   common::boolToString(isMember).c_str(), username.c_str(),
                   egroupname.c_str(), expiration);
   //----------------------------------------------------------------------------
   // Store into the cache
   //----------------------------------------------------------------------------
-  storeIntoCache(username, egroupname, isMember, now);
-  return CachedEntry(isMember, now);
+  storeIntoCache(username, egroupname, isMember, user.timestamp);
+  return CachedEntry(isMember, user.timestamp);
 }
 
 //------------------------------------------------------------------------------
 // Asynchronous refresh loop.
 //
-// The looping thread takes Egroup requests and run's LDAP queries pushing
-// results into the Egroup membership map and updates the lifetime of the
-// resolved entry.
+// The looping threads take user requests and run LDAP queries pushing
+// results into the Egroup membership map and update the lifetime of all the
+// resolved entries of the user.
 //------------------------------------------------------------------------------
 void Egroup::Refresh(ThreadAssistant& assistant) noexcept
 {
   ThreadAssistant::setSelfThreadName("EgroupRefresh");
   eos_static_info("%s", "msg=\"async egroup fetch thread started\"");
-  std::string key;
-  auto iterator = mPendingQueue.begin();
+  std::string username;
+  UserEntry entry;
 
   while (!assistant.terminationRequested()) {
-    std::pair<std::string, std::string>* resolve = iterator.getItemBlockOrNull();
+    {
+      std::unique_lock<std::mutex> lock(mMutexPending);
+      mCvPending.wait(lock, [&] {
+        return mShutdown || !mPendingQueue.empty();
+      });
+
+      if (mShutdown) {
+        break;
+      }
 
-    if (!resolve) {
-      break;
+      username = std::move(mPendingQueue.front());
+      mPendingQueue.pop_front();
     }
+    eos_static_info("msg=\"async-lookup\" user=\"%s\"", username.c_str());
 
-    if (!resolve->first.empty()) {
-      refresh(resolve->first, resolve->second);
+    if (!fetchUser(username, entry)) {
+      eos_static_err("Could not do asynchronous refresh for egroup membership "
+                     "for username=%s", username.c_str());
     }
 
-    iterator.next();
     {
-      // Remove <user>:<egroup> key from the pending set
-      key = resolve->first + ":" + resolve->second;
+      // Remove <user> key from the pending set
       std::unique_lock<std::mutex> lock(mMutexPending);
-      (void)mPendingSet.erase(key);
+      (void)mPendingSet.erase(username);
+    }
+    // Persist the refreshed memberships from time to time
+    std::unique_lock<std::mutex> lock(mMutexSnapshot, std::try_to_lock);
+
+    if (lock.owns_lock() && !mSnapshotPath.empty() &&
+        (mLastSnapshot + kSnapshotInterval < common::SteadyClock::now(clock))) {
+      lock.unlock();
+      SaveSnapshot();
     }
-    mPendingQueue.pop_front();
   }
 }
 
 //------------------------------------------------------------------------------
-// Pushes an egroup/user resolution request into the asynchronous queue
+// Pushes a user resolution request into the asynchronous queue, all the
+// egroups of the user are refreshed along
 //------------------------------------------------------------------------------
 void Egroup::scheduleRefresh(const std::string& username,
                              const std::string& egroupname)
 {
-  const std::string key = username + ":" + egroupname;
   std::unique_lock<std::mutex> lock(mMutexPending);
 
-  if (mPendingSet.find(key) == mPendingSet.end()) {
-    mPendingSet.insert(key);
-    lock.unlock();
-    mPendingQueue.emplace_back(std::make_pair(username, egroupname));
+  if (mPendingSet.find(username) != mPendingSet.end()) {
+    return;
   }
+
+  if (mPendingQueue.size() >= kMaxPendingRefreshes) {
+    // Still served from the cache, the refresh is requested again on the
+    // next access
+    eos_static_warning("msg=\"egroup refresh queue full\" user=\"%s\" "
+                       "e-group=\"%s\"", username.c_str(), egroupname.c_str());
+    return;
+  }
+
+  mPendingSet.insert(username);
+  mPendingQueue.push_back(username);
+  lock.unlock();
+  mCvPending.notify_one();
 }
 
 //------------------------------------------------------------------------------
@@ -360,25 +553,144 @@ void Egroup::scheduleRefresh(const std::string& username,
 Egroup::CachedEntry Egroup::refresh(const std::string& username,
                                     const std::string& egroupname)
 {
-  eos_static_info("msg=\"async-lookup\" user=\"%s\" e-group=\"%s\"",
+  eos_static_info("msg=\"sync-lookup\" user=\"%s\" e-group=\"%s\"",
                   username.c_str(), egroupname.c_str());
-  Status status = isMemberUncached(username, egroupname);
+  UserEntry user;
 
-  if (status == Status::kError) {
-    eos_static_err("Could not do asynchronous refresh for egroup membership for username=%s, e-group=%s",
+  if (!fetchUser(username, user)) {
+    eos_static_err("Could not do synchronous refresh for egroup membership for username=%s, e-group=%s",
                    username.c_str(), egroupname.c_str());
     return CachedEntry(false, {});
   }
 
-  bool isMember = (status == Status::kMember);
-  std::chrono::steady_clock::time_point now = common::SteadyClock::now(clock);
+  bool isMember = user.egroups.count(egroupname);
   uint64_t expiration = common::SteadyClock::SecondsSinceEpoch(
-                          now + kCacheDuration).count();
+                          user.timestamp + kCacheDuration).count();
   eos_static_info("member=%s user=\"%s\" e-group=\"%s\" expiration=%lu",
                   common::boolToString(isMember).c_str(), username.c_str(),
                   egroupname.c_str(), expiration);
-  storeIntoCache(username, egroupname, isMember, now);
-  return CachedEntry(isMember, now);
+  storeIntoCache(username, egroupname, isMember, user.timestamp);
+  return CachedEntry(isMember, user.timestamp);
+}
+
+//------------------------------------------------------------------------------
+// Set the snapshot file and load the entries it holds
+//------------------------------------------------------------------------------
+size_t Egroup::SetSnapshotPath(const std::string& path)
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutexSnapshot);
+    mSnapshotPath = path;
+  }
+  return LoadSnapshot();
+}
+
+//------------------------------------------------------------------------------
+// Save the user memberships into the snapshot file. Each line holds
+// "<username> <unix timestamp of the lookup> <egroup> ... <egroup>".
+//------------------------------------------------------------------------------
+bool Egroup::SaveSnapshot()
+{
+  std::unique_lock<std::mutex> lock(mMutexSnapshot);
+
+  if (mSnapshotPath.empty()) {
+    return false;
+  }
+
+  const std::string tmp_path = mSnapshotPath + ".tmp";
+  std::ofstream file(tmp_path, std::ios::trunc);
+
+  if (!file.is_open()) {
+    eos_static_err("msg=\"failed to open egroup snapshot\" path=\"%s\"",
+                   tmp_path.c_str());
+    return false;
+  }
+
+  std::chrono::steady_clock::time_point now = common::SteadyClock::now(clock);
+  std::chrono::system_clock::time_point wall_now =
+    std::chrono::system_clock::now();
+  size_t num_users = 0;
+  {
+    eos::common::RWMutexReadLock rd_lock(mMutex);
+
+    for (const auto& user : mUsers) {
+      std::chrono::system_clock::time_point wall_ts = wall_now -
+          std::chrono::duration_cast<std::chrono::system_clock::duration>
+          (now - user.second.timestamp);
+      file << user.first << " " << std::chrono::system_clock::to_time_t(wall_ts);
+
+      for (const auto& egroup : user.second.egroups) {
+        file << " " << egroup;
+      }
+
+      file << "\n";
+      ++num_users;
+    }
+  }
+  file.close();
+
+  if (!file || ::rename(tmp_path.c_str(), mSnapshotPath.c_str())) {
+    eos_static_err("msg=\"failed to write egroup snapshot\" path=\"%s\"",
+                   mSnapshotPath.c_str());
+    (void) ::unlink(tmp_path.c_str());
+    return false;
+  }
+
+  mLastSnapshot = now;
+  eos_static_info("msg=\"saved egroup snapshot\" path=\"%s\" users=%zu",
+                  mSnapshotPath.c_str(), num_users);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Load the user memberships from the snapshot file. Entries for users which
+// are already cached are skipped.
+//------------------------------------------------------------------------------
+size_t Egroup::LoadSnapshot()
+{
+  std::unique_lock<std::mutex> lock(mMutexSnapshot);
+  std::ifstream file(mSnapshotPath);
+
+  if (!file.is_open()) {
+    return 0;
+  }
+
+  std::chrono::steady_clock::time_point now = common::SteadyClock::now(clock);
+  std::time_t wall_now = std::chrono::system_clock::to_time_t(
+                           std::chrono::system_clock::now());
+  size_t num_users = 0;
+  std::string line;
+  eos::common::RWMutexWriteLock wr_lock(mMutex);
+
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    std::string username;
+    std::time_t ts = 0;
+
+    if (!(iss >> username >> ts)) {
+      continue;
+    }
+
+    std::chrono::seconds age(std::max(wall_now - ts, (std::time_t) 0));
+
+    if ((age > kSnapshotMaxAge) || mUsers.count(username)) {
+      continue;
+    }
+
+    UserEntry& entry = mUsers[username];
+    entry.timestamp = now - age;
+    std::string egroup;
+
+    while (iss >> egroup) {
+      entry.egroups.insert(egroup);
+    }
+
+    ++num_users;
+  }
+
+  eos_static_info("msg=\"loaded egroup snapshot\" path=\"%s\" users=%zu",
+                  mSnapshotPath.c_str(), num_users);
+  return num_users;
 }
 
 //------------------------------------------------------------------------------
@@ -436,6 +748,7 @@ void Egroup::Reset()
 {
   eos::common::RWMutexWriteLock wr_lock(mMutex);
   cache.clear();
+  mUsers.clear();
 }
 
 EOSMGMNAMESPACE_END
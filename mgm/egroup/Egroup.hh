@@ -28,13 +28,21 @@
 #include "common/AssistedThread.hh"
 #include "common/SteadyClock.hh"
 #include "common/RWMutex.hh"
-#include <qclient/queueing/WaitableQueue.hh>
 #include <XrdSys/XrdSysPthread.hh>
 #include <sys/types.h>
+#include <strings.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <map>
 #include <chrono>
 #include <unordered_set>
+#include <vector>
 
 /*----------------------------------------------------------------------------*/
 /**
@@ -59,12 +67,21 @@ EOSMGMNAMESPACE_BEGIN
 //! Provides functionality for checking egroup membership by username / egroup
 //! name.
 //!
-//! The Egroup object maintains a thread which is serving async Egroup
-//! membership update requests.
+//! The Egroup object maintains a pool of threads which are serving async
+//! Egroup membership update requests.
 //!
 //! The problem here is that the calling function in the MGM has a read lock
 //! during the Egroup::Member call and the refreshing of Egroup permissions
 //! should be done if possible asynchronously to avoid mutex starvation.
+//!
+//! Memberships are resolved per user: a single LDAP query returns all the
+//! egroups a user belongs to, so that an ACL listing several egroups costs
+//! at most one round-trip on a cold cache, and concurrent misses for the same
+//! user wait for the same query. Egroups missing from the list are cached as
+//! negative entries, failed lookups are cached as negative entries for a
+//! short time only. The per-user memberships can be persisted in a local
+//! snapshot file which is served (and refreshed asynchronously) after a
+//! restart.
 //------------------------------------------------------------------------------
 class Egroup
 {
@@ -88,13 +105,32 @@ public:
     CachedEntry() : isMember(false) {}
   };
 
+  //! Egroup names are compared ignoring the case, like LDAP does
+  struct CaseInsensitiveLess {
+    bool operator()(const std::string& lhs, const std::string& rhs) const
+    {
+      return strcasecmp(lhs.c_str(), rhs.c_str()) < 0;
+    }
+  };
+
+  using EgroupSet = std::set<std::string, CaseInsensitiveLess>;
+
+  //! Egroups a user is member of, as returned by a single LDAP query
+  struct UserEntry {
+    EgroupSet egroups;
+    std::chrono::steady_clock::time_point timestamp;
+  };
+
   //----------------------------------------------------------------------------
   //! Constructor
+  //!
+  //! @param clock clock used for the cache lifetime, nullptr for the real one
+  //! @param num_threads number of threads serving the asynchronous refreshes
   //----------------------------------------------------------------------------
-  Egroup(eos::common::SteadyClock* clock = nullptr);
+  Egroup(eos::common::SteadyClock* clock = nullptr, size_t num_threads = 4);
 
   //----------------------------------------------------------------------------
-  //! Destructor - join asynchronous refresh thread
+  //! Destructor - join asynchronous refresh threads and save the snapshot
   //----------------------------------------------------------------------------
   virtual ~Egroup();
 
@@ -145,11 +181,27 @@ public:
   // this class tries to contact the LDAP server, it will serve injected data
   // instead.
   //
-  // Simulates response of "isMemberUncached" function.
+  // Simulates response of "fetchUserUncached" function, a kError status for
+  // any egroup of a user makes the lookup of that user fail.
   //----------------------------------------------------------------------------
   void inject(const std::string& username, const std::string& egroupname,
               Status status);
 
+  //----------------------------------------------------------------------------
+  // Delay every lookup served from the injected data by the given latency to
+  // simulate the round-trip to the LDAP server
+  //----------------------------------------------------------------------------
+  void injectLatency(std::chrono::milliseconds latency);
+
+  //----------------------------------------------------------------------------
+  // Return number of lookups sent to the LDAP server (or served from the
+  // injected data) so far
+  //----------------------------------------------------------------------------
+  uint64_t getLdapQueryCount() const
+  {
+    return mLdapQueryCount;
+  }
+
   //----------------------------------------------------------------------------
   // Return number of asynchronous refresh requests currently pending
   //----------------------------------------------------------------------------
@@ -157,15 +209,47 @@ public:
 
   //----------------------------------------------------------------------------
   //! Synchronous refresh function doing an LDAP query for a given Egroup/user.
-  //! If the pair exists in the cache, it is ignored and replaced.
+  //! If the pair exists in the cache, it is ignored and replaced. All the
+  //! cached pairs of the user are refreshed along.
   //----------------------------------------------------------------------------
   CachedEntry refresh(const std::string& username,
                       const std::string& egroupname);
 
+  //----------------------------------------------------------------------------
+  //! Set the local file where the user memberships are persisted and load
+  //! the entries it holds. Loaded entries are served until they are refreshed.
+  //!
+  //! @param path snapshot file path
+  //!
+  //! @return number of users loaded from the snapshot
+  //----------------------------------------------------------------------------
+  size_t SetSnapshotPath(const std::string& path);
+
+  //----------------------------------------------------------------------------
+  //! Save the user memberships into the snapshot file, if any is configured
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool SaveSnapshot();
+
 private:
   const std::chrono::seconds kCacheDuration {
     1800
   };
+  //! Lifetime of the negative entries stored when a lookup fails
+  const std::chrono::seconds kErrorCacheDuration {
+    60
+  };
+  //! Minimum interval between two snapshots saved by the refresh threads
+  const std::chrono::seconds kSnapshotInterval {
+    300
+  };
+  //! Snapshot entries older than this are not loaded
+  const std::chrono::seconds kSnapshotMaxAge {
+    86400
+  };
+  //! Maximum number of users waiting for an asynchronous refresh
+  static constexpr size_t kMaxPendingRefreshes = 100000;
   eos::common::SteadyClock* clock = nullptr;
 
   //----------------------------------------------------------------------------
@@ -175,40 +259,93 @@ private:
                       const std::string& egroupname, bool isMember,
                       std::chrono::steady_clock::time_point timestamp);
 
-  /// async refresh thread
-  AssistedThread mThread;
+  //----------------------------------------------------------------------------
+  //! Store the memberships of a user and update all its cached pairs
+  //----------------------------------------------------------------------------
+  void storeUserIntoCache(const std::string& username, const UserEntry& entry);
+
+  //----------------------------------------------------------------------------
+  //! Fetch the cached memberships of a user. Return false if the user does
+  //! not exist in cache.
+  //----------------------------------------------------------------------------
+  bool fetchCachedUser(const std::string& username, UserEntry& out);
+
+  //----------------------------------------------------------------------------
+  //! Look up the memberships of a user and store them into the cache.
+  //! Concurrent calls for the same user share a single lookup.
+  //!
+  //! @param username user name
+  //! @param out filled with the memberships of the user, or with the ones
+  //!        still served from the cache if the lookup failed
+  //!
+  //! @return true if the lookup succeeded, otherwise false
+  //----------------------------------------------------------------------------
+  bool fetchUser(const std::string& username, UserEntry& out);
+
+  /// async refresh threads
+  std::vector<std::unique_ptr<AssistedThread>> mThreads;
 
   //----------------------------------------------------------------------------
   //! Check if cache entry is stale
   //----------------------------------------------------------------------------
-  bool isStale(const CachedEntry& entry) const;
+  bool isStale(std::chrono::steady_clock::time_point timestamp) const;
 
   //----------------------------------------------------------------------------
-  //! Asynchronous thread loop doing egroup/username fetching
+  //! Asynchronous thread loop doing username fetching
   //----------------------------------------------------------------------------
   void Refresh(ThreadAssistant& assistant) noexcept;
 
+  //----------------------------------------------------------------------------
+  //! Load the user memberships from the snapshot file
+  //----------------------------------------------------------------------------
+  size_t LoadSnapshot();
+
   /// mutex protecting static Egroup objects
   eos::common::RWMutex mMutex;
 
   /// map indicating egroup memebership for egroup/username pairs
   std::map<std::string, std::map<std::string, CachedEntry>> cache;
+  /// map of username to the egroups the user is member of
+  std::map<std::string, UserEntry> mUsers;
 
-  /// thred-safe queue keeping track of pending refresh requests
-  qclient::WaitableQueue<std::pair<std::string, std::string>, 500> mPendingQueue;
-  //! Set of pending requests in the form <username>:<egroup>
+  //! Users waiting for an asynchronous refresh
+  std::deque<std::string> mPendingQueue;
+  //! Set of users pending or being refreshed
   std::unordered_set<std::string> mPendingSet;
-  //! Mutex protecting the pending set
+  //! Mutex protecting the pending queue and set
   mutable std::mutex mMutexPending;
+  //! Condition variable signalling pending refresh requests
+  std::condition_variable mCvPending;
+  //! Flag set when the refresh threads need to exit
+  bool mShutdown = false;
+
+  //! Lookups in flight, keyed by username
+  std::map<std::string, std::shared_future<std::pair<bool, UserEntry>>>
+  mFetches;
+  //! Mutex protecting the lookups in flight
+  std::mutex mMutexFetches;
+
+  //! Local snapshot file of the user memberships
+  std::string mSnapshotPath;
+  //! Time of the last saved snapshot
+  std::chrono::steady_clock::time_point mLastSnapshot;
+  //! Mutex serializing the snapshot saves
+  std::mutex mMutexSnapshot;
 
   /// injections to simulate LDAP server responses - different than the cache
   std::map<std::string, std::map<std::string, Status>> injections;
+  //! Simulated LDAP round-trip latency
+  std::chrono::milliseconds mInjectedLatency {0};
+  //! Mutex protecting the injections
+  mutable std::mutex mMutexInjections;
+  //! Number of lookups sent to the LDAP server
+  std::atomic<uint64_t> mLdapQueryCount {0};
 
   //----------------------------------------------------------------------------
-  //! Main LDAP lookup function - bypasses the cache, hits the LDAP server.
+  //! Main LDAP lookup function - bypasses the cache, hits the LDAP server
+  //! and returns all the egroups the user is member of.
   //----------------------------------------------------------------------------
-  Status isMemberUncached(const std::string& username,
-                          const std::string& egroupname);
+  Status fetchUserUncached(const std::string& username, EgroupSet& egroups);
 };
 
 EOSMGMNAMESPACE_END
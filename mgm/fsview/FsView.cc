@@ -1030,6 +1030,17 @@ FsSpace::FsSpace(const char* name)
                       eos::common::SPACE_CACHE_HIGH_WATERMARK_DEFAULT);
     }
 
+    // Disable cache prefetching by default
+    if (GetConfigMember(eos::common::SPACE_CACHE_PREFETCH_NAME).empty()) {
+      SetConfigMember(eos::common::SPACE_CACHE_PREFETCH_NAME, "off");
+    }
+
+    if (GetConfigMember(
+          eos::common::SPACE_CACHE_PREFETCH_BANDWIDTH_NAME).empty()) {
+      SetConfigMember(eos::common::SPACE_CACHE_PREFETCH_BANDWIDTH_NAME,
+                      eos::common::SPACE_CACHE_PREFETCH_BANDWIDTH_DEFAULT);
+    }
+
     // Set one week lru interval by default
     if (GetConfigMember("lru.interval") == "604800") {
       SetConfigMember("lru.interval", "604800");
@@ -1050,6 +1061,11 @@ FsSpace::FsSpace(const char* name)
       SetConfigMember("wfe.ntx", "1");
     }
 
+    // Queue the wfe jobs in the proc directory by default
+    if (GetConfigMember("wfe.queue").empty()) {
+      SetConfigMember("wfe.queue", "proc");
+    }
+
     // Disable the 'file archived' garbage collector by default
     if (GetConfigMember("filearchivedgc").empty()) {
       SetConfigMember("filearchivedgc", "off");
@@ -1568,6 +1584,8 @@ FsView::GetFileSystemFormat(std::string option)
     format += "key=scaninterval:format=os|";
     format += "key=scan_rain_interval:format=os|";
     format += "key=scanreruninterval:format=os|";
+    format += "key=stat.scan.ratemb:format=of|";
+    format += "key=stat.scan.eta:format=ol|";
     format += "key=local.balancer.running:format=ol:tag=local.balancer.running|";
     format += "key=stat.disk.iops:format=ol|";
     format += "key=stat.disk.bw:format=of|";
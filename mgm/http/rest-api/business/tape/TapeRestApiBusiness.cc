@@ -29,6 +29,7 @@
 #include "mgm/bulk-request/prepare/manager/BulkRequestPrepareManager.hh"
 #include "mgm/bulk-request/business/BulkRequestBusiness.hh"
 #include "mgm/bulk-request/dao/factories/ProcDirectoryDAOFactory.hh"
+#include "mgm/bulk-request/dao/factories/QdbDAOFactory.hh"
 #include "mgm/http/rest-api/exception/Exceptions.hh"
 #include "mgm/bulk-request/exception/PersistencyException.hh"
 #include "mgm/stat/Stat.hh"
@@ -65,35 +66,31 @@ void TapeRestApiBusiness::cancelStageBulkRequest(const std::string& requestId,
                      vid->gid, 1);
   std::shared_ptr<bulk::BulkRequestBusiness> bulkRequestBusiness =
     createBulkRequestBusiness();
-  auto bulkRequest = bulkRequestBusiness->getStageBulkRequest(requestId);
 
-  if (bulkRequest == nullptr) {
+  if (!bulkRequestBusiness->exists(requestId, bulk::BulkRequest::PREPARE_STAGE)) {
     std::stringstream ss;
     ss << "Unable to find the STAGE bulk-request ID = " << requestId;
     throw ObjectNotFoundException(ss.str());
   }
 
   //Create the prepare arguments, we will only cancel the files that were given by the user
+  //Each file is looked up individually so that the whole bulk-request does not need to be fetched
   const FilesContainer& filesFromClient = model->getFiles();
-  auto filesFromBulkRequestContainer = bulkRequest->getFilesMap();
   bulk::PrepareArgumentsWrapper pargsWrapper(requestId, Prep_CANCEL);
 
   for (const auto& fileFromClient : filesFromClient.getPaths()) {
-    const auto& fileFromBulkRequestKeyVal = filesFromBulkRequestContainer->find(
-        fileFromClient);
-
-    if (fileFromBulkRequestKeyVal != filesFromBulkRequestContainer->end()) {
-      auto& fileFromBulkRequest = fileFromBulkRequestKeyVal->second;
-      auto& error = fileFromBulkRequest->getError();
+    auto fileFromBulkRequest = bulkRequestBusiness->getStageBulkRequestFile(
+                                 requestId, fileFromClient);
 
-      if (!error) {
+    if (fileFromBulkRequest != nullptr) {
+      if (!fileFromBulkRequest->getError()) {
         //We only cancel the files that do not have any error
         pargsWrapper.addFile(fileFromClient, "");
       }
     } else {
       std::stringstream ss;
       ss << "The file " << fileFromClient << " does not belong to the STAGE request "
-         << bulkRequest->getId() << ". No modification has been made to this request.";
+         << requestId << ". No modification has been made to this request.";
       throw FileDoesNotBelongToBulkRequestException(ss.str());
     }
   }
@@ -321,9 +318,17 @@ TapeRestApiBusiness::createPrepareManager()
 std::shared_ptr<bulk::BulkRequestBusiness>
 TapeRestApiBusiness::createBulkRequestBusiness()
 {
-  std::unique_ptr<bulk::AbstractDAOFactory> daoFactory(new
-      bulk::ProcDirectoryDAOFactory(gOFS,
-                                    *gOFS->mProcDirectoryBulkRequestTapeRestApiLocations));
+  std::unique_ptr<bulk::AbstractDAOFactory> daoFactory;
+
+  if (gOFS->mBulkRequestStore) {
+    daoFactory.reset(new bulk::QdbDAOFactory(gOFS,
+                     *gOFS->mProcDirectoryBulkRequestTapeRestApiLocations,
+                     *gOFS->mBulkRequestStore));
+  } else {
+    daoFactory.reset(new bulk::ProcDirectoryDAOFactory(gOFS,
+                     *gOFS->mProcDirectoryBulkRequestTapeRestApiLocations));
+  }
+
   return std::make_shared<bulk::BulkRequestBusiness>(std::move(daoFactory));
 }
 
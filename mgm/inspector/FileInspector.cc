@@ -37,6 +37,7 @@
 #include "mgm/misc/Constants.hh"
 #include "namespace/interface/IView.hh"
 #include "namespace/ns_quarkdb/inspector/FileScanner.hh"
+#include "namespace/ns_quarkdb/inspector/ParallelFileScanner.hh"
 #include "namespace/ns_quarkdb/FileMD.hh"
 #include "namespace/utils/Stat.hh"
 #include "namespace/Resolver.hh"
@@ -66,6 +67,7 @@ FileInspector::FileInspector(std::string_view space_name,
 //------------------------------------------------------------------------------
 FileInspector::~FileInspector()
 {
+  // The background thread unregisters from the scan bus when exiting
   mThread.join();
 }
 
@@ -78,6 +80,7 @@ FileInspector::Options FileInspector::getOptions(const LockFsView lockfsview)
   // Default options
   opts.enabled = false;
   opts.interval = std::chrono::minutes(4 * 60);
+  opts.scanPartitions = 0;
   eos::common::RWMutexReadLock lock;
 
   if (lockfsview == LockFsView::On) {
@@ -102,6 +105,15 @@ FileInspector::Options FileInspector::getOptions(const LockFsView lockfsview)
       }
     }
 
+    std::string partitions =
+      FsView::gFsView.mSpaceView[mSpaceName]->GetConfigMember("inspector.scan.partitions");
+    int64_t nparts = 0;
+
+    if (!partitions.empty() && common::ParseInt64(partitions, nparts) &&
+        (nparts > 0)) {
+      opts.scanPartitions = nparts;
+    }
+
     std::string tbprice =
       FsView::gFsView.mSpaceView[mSpaceName]->GetConfigMember("inspector.price.disk.tbyear");
     double price = 0;
@@ -188,6 +200,19 @@ FileInspector::backgroundThread(ThreadAssistant& assistant) noexcept
     common::IntervalStopwatch stopwatch(std::chrono::seconds(
                                           opts.interval.count()));
 
+    if (opts.enabled && gOFS->mMaster->IsMaster() &&
+        gOFS->mNsScanBus && gOFS->mNsScanBus->IsEnabled()) {
+      // Files are delivered by the namespace scan bus, just check
+      // periodically that this is still the case
+      gOFS->mNsScanBus->Register(this);
+      assistant.wait_for(std::chrono::seconds(60));
+      continue;
+    }
+
+    if (gOFS->mNsScanBus) {
+      gOFS->mNsScanBus->Unregister(this);
+    }
+
     if (opts.enabled && gOFS->mMaster->IsMaster()) {
       eos_static_info("%s", "msg=\"scan started\"");
       mCurrentStats.TimeScan = time(NULL);
@@ -197,6 +222,10 @@ FileInspector::backgroundThread(ThreadAssistant& assistant) noexcept
 
     assistant.wait_for(stopwatch.timeRemainingInCycle());
   }
+
+  if (gOFS->mNsScanBus) {
+    gOFS->mNsScanBus->Unregister(this);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -206,12 +235,6 @@ void FileInspector::performCycleQDB(ThreadAssistant& assistant) noexcept
 {
   eos_static_info("%s", "msg=\"start FileInspector scan on QDB\"");
 
-  // Initialize qclient..
-  if (!mQcl) {
-    mQcl.reset(new qclient::QClient(gOFS->mQdbContactDetails.members,
-                                    gOFS->mQdbContactDetails.constructOptions()));
-  }
-
   // Start scanning files
   unsigned long long nfiles_processed;
   nfiles = ndirs = nfiles_processed = 0;
@@ -223,73 +246,189 @@ void FileInspector::performCycleQDB(ThreadAssistant& assistant) noexcept
   }
   Options opts = getOptions(LockFsView::On);
   uint64_t interval = opts.interval.count();
-  FileScanner scanner(*(mQcl.get()));
   time_t c_time = s_time;
 
-  while (scanner.valid()) {
-    scanner.next();
-    std::string err;
-    eos::ns::FileMdProto item;
-
-    if (scanner.getItem(item)) {
-      std::shared_ptr<eos::QuarkFileMD> fmd = std::make_shared<eos::QuarkFileMD>();
-      fmd->initialize(std::move(item));
-      Process(fmd);
-      nfiles_processed++;
-      scanned_percent.store(100.0 * nfiles_processed / nfiles,
-                            std::memory_order_seq_cst);
-      time_t target_time = (1.0 * nfiles_processed / nfiles) * interval;
-      time_t is_time = time(NULL) - s_time;
-
-      if (target_time > is_time) {
-        uint64_t p_time = target_time - is_time;
-
-        if (p_time > 5) {
-          p_time = 5;
+  // Process the files delivered by the scanner, returns false if termination
+  // was requested
+  auto scan = [&](auto & scanner) {
+    while (scanner.valid()) {
+      std::string err;
+      eos::ns::FileMdProto item;
+
+      if (scanner.getItem(item)) {
+        scanner.next();
+        std::shared_ptr<eos::QuarkFileMD> fmd = std::make_shared<eos::QuarkFileMD>();
+        fmd->initialize(std::move(item));
+        Process(fmd);
+        nfiles_processed++;
+        scanned_percent.store(100.0 * nfiles_processed / nfiles,
+                              std::memory_order_seq_cst);
+        time_t target_time = (1.0 * nfiles_processed / nfiles) * interval;
+        time_t is_time = time(NULL) - s_time;
+
+        if (target_time > is_time) {
+          uint64_t p_time = target_time - is_time;
+
+          if (p_time > 5) {
+            p_time = 5;
+          }
+
+          eos_static_debug("is:%lu target:%lu is_t:%lu target_t:%lu interval:%lu "
+                           "- pausing for %lu seconds\n",
+                           nfiles_processed, nfiles.load(), is_time, target_time, interval, p_time);
+          // pause for the diff ...
+          std::this_thread::sleep_for(std::chrono::seconds(p_time));
         }
 
-        eos_static_debug("is:%lu target:%lu is_t:%lu target_t:%lu interval:%lu "
-                         "- pausing for %lu seconds\n",
-                         nfiles_processed, nfiles.load(), is_time, target_time, interval, p_time);
-        // pause for the diff ...
-        std::this_thread::sleep_for(std::chrono::seconds(p_time));
-      }
+        if (assistant.terminationRequested()) {
+          return false;
+        }
 
-      if (assistant.terminationRequested()) {
-        return;
-      }
+        if ((time(NULL) - c_time) > 60) {
+          c_time = time(NULL);
+          Options opts = getOptions(LockFsView::On);
+          interval = opts.interval.count();
 
-      if ((time(NULL) - c_time) > 60) {
-        c_time = time(NULL);
-        Options opts = getOptions(LockFsView::On);
-        interval = opts.interval.count();
+          if (!opts.enabled) {
+            // interrupt the scan
+            break;
+          }
 
-        if (!opts.enabled) {
-          // interrupt the scan
-          break;
+          if (!gOFS->mMaster->IsMaster()) {
+            // interrupt the scan
+            break;
+          }
         }
+      }
 
-        if (!gOFS->mMaster->IsMaster()) {
-          // interrupt the scan
-          break;
-        }
+      if (scanner.hasError(err)) {
+        eos_static_err("msg=\"QDB scanner error, interrupting scan\" error=\"%s\"",
+                       err.c_str());
+        break;
       }
     }
 
-    if (scanner.hasError(err)) {
-      eos_static_err("msg=\"QDB scanner error, interrupting scan\" error=\"%s\"",
-                     err.c_str());
-      break;
+    return true;
+  };
+
+  if (opts.scanPartitions > 1) {
+    // Fetch over several connections, only worth it when a single cursor is
+    // bound by the round-trip latency to QuarkDB
+    ParallelFileScanner::Options scan_opts;
+    scan_opts.partitions = opts.scanPartitions;
+    ParallelFileScanner scanner(gOFS->mQdbContactDetails, scan_opts);
+
+    if (!scan(scanner)) {
+      return;
+    }
+  } else {
+    // Initialize qclient..
+    if (!mQcl) {
+      mQcl.reset(new qclient::QClient(gOFS->mQdbContactDetails.members,
+                                      gOFS->mQdbContactDetails.constructOptions()));
+    }
+
+    FileScanner scanner(*(mQcl.get()));
+
+    if (!scan(scanner)) {
+      return;
     }
   }
 
   scanned_percent.store(100.0, std::memory_order_seq_cst);
+  publishStats();
+}
+
+//------------------------------------------------------------------------------
+// Make the current stats the last complete ones and persist them
+//------------------------------------------------------------------------------
+void
+FileInspector::publishStats()
+{
   std::lock_guard<std::mutex> lock(mutexScanStats);
   mLastStats = std::move(mCurrentStats);
   mQdbHelper.Store(mLastStats);
   mCurrentStats = FileInspectorStats{}; // reset current stats
 }
 
+//------------------------------------------------------------------------------
+// Rate budget for the scan bus spreading a cycle over the inspector interval
+//------------------------------------------------------------------------------
+uint64_t
+FileInspector::GetRateBudget()
+{
+  Options opts = getOptions(LockFsView::On);
+  uint64_t num_files = 0;
+  {
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+    num_files = gOFS->eosFileService->getNumFiles();
+  }
+
+  if (opts.interval.count() <= 0) {
+    return 0;
+  }
+
+  return std::max<uint64_t>(1, num_files / opts.interval.count());
+}
+
+//------------------------------------------------------------------------------
+// Scan bus cycle started
+//------------------------------------------------------------------------------
+void
+FileInspector::CycleStart(uint64_t cycle, bool resumed)
+{
+  {
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+    nfiles = (unsigned long long) gOFS->eosFileService->getNumFiles();
+    ndirs = (unsigned long long) gOFS->eosDirectoryService->getNumContainers();
+  }
+  mBusProcessed = 0;
+  // Stats of a resumed cycle miss the files scanned before the restart
+  mBusFullCycle = !resumed;
+  scanned_percent.store(0, std::memory_order_seq_cst);
+  std::lock_guard<std::mutex> lock(mutexScanStats);
+  mCurrentStats = FileInspectorStats{};
+  mCurrentStats.TimeScan = time(NULL);
+  eos_static_info("msg=\"scan bus cycle started\" space=%s cycle=%llu "
+                  "resumed=%d", mSpaceName.c_str(), cycle, resumed);
+}
+
+//------------------------------------------------------------------------------
+// Process a file delivered by the scan bus
+//------------------------------------------------------------------------------
+void
+FileInspector::ProcessFile(eos::ns::FileMdProto&& proto)
+{
+  std::shared_ptr<eos::QuarkFileMD> fmd = std::make_shared<eos::QuarkFileMD>();
+  fmd->initialize(std::move(proto));
+  Process(fmd);
+  const uint64_t processed = ++mBusProcessed;
+
+  if (nfiles) {
+    scanned_percent.store(std::min(100.0, 100.0 * processed / nfiles),
+                          std::memory_order_seq_cst);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Scan bus cycle ended
+//------------------------------------------------------------------------------
+void
+FileInspector::CycleEnd(uint64_t cycle, bool complete)
+{
+  eos_static_info("msg=\"scan bus cycle finished\" space=%s cycle=%llu "
+                  "complete=%d files=%llu", mSpaceName.c_str(), cycle,
+                  complete, mBusProcessed.load());
+  scanned_percent.store(100.0, std::memory_order_seq_cst);
+
+  if (complete && mBusFullCycle) {
+    publishStats();
+  } else {
+    std::lock_guard<std::mutex> lock(mutexScanStats);
+    mCurrentStats = FileInspectorStats{};
+  }
+}
+
 //------------------------------------------------------------------------------
 // Process a given fmd object
 //------------------------------------------------------------------------------
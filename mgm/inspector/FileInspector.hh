@@ -27,6 +27,7 @@
 #include "common/VirtualIdentity.hh"
 #include "common/AssistedThread.hh"
 #include "mgm/inspector/FileInspectorStats.hh"
+#include "mgm/nsscan/NsScanBus.hh"
 #include "namespace/ns_quarkdb/QdbContactDetails.hh"
 #include "namespace/ns_quarkdb/qclient/include/qclient/QClient.hh"
 #include "namespace/ns_quarkdb/qclient/include/qclient/structures/QHash.hh"
@@ -40,16 +41,19 @@
 EOSMGMNAMESPACE_BEGIN
 
 //------------------------------------------------------------------------------
-//! Class tracking the sanity of created files
+//! Class tracking the sanity of created files. When the namespace scan bus is
+//! enabled the files are delivered by the bus instead of a private scan.
 //------------------------------------------------------------------------------
 
-class FileInspector
+class FileInspector: public NsScanConsumer
 {
 public:
   struct Options {
     bool enabled; //< Is FileInspector even enabled?
     std::chrono::seconds
     interval; //< Run FileInspector cleanup every this many seconds
+    //! Partitions of the parallel QDB scan, 0 or 1 use a single cursor
+    size_t scanPartitions;
   };
 
   enum LockFsView : bool {
@@ -100,10 +104,36 @@ public:
 
   const std::string currencies[6] = { "EOS", "CHF", "EUR", "USD", "AUD", "YEN" };
 
+  //----------------------------------------------------------------------------
+  //! NsScanConsumer interface
+  //----------------------------------------------------------------------------
+  std::string GetScanConsumerName() const override
+  {
+    return "inspector-" + mSpaceName;
+  }
+
+  bool WantsFiles() const override
+  {
+    return mEnabled.load();
+  }
+
+  uint64_t GetRateBudget() override;
+
+  void CycleStart(uint64_t cycle, bool resumed) override;
+
+  void ProcessFile(eos::ns::FileMdProto&& proto) override;
+
+  void CycleEnd(uint64_t cycle, bool complete) override;
+
 private:
   void backgroundThread(ThreadAssistant& assistant) noexcept;
   void Process(std::shared_ptr<eos::IFileMD> fmd);
 
+  //----------------------------------------------------------------------------
+  //! Make the current stats the last complete ones and persist them
+  //----------------------------------------------------------------------------
+  void publishStats();
+
   AssistedThread mThread; ///< thread id of the creation background tracker
   std::atomic<bool> mEnabled;
   XrdOucErrInfo mError;
@@ -121,6 +151,8 @@ private:
   std::atomic<double> scanned_percent;
   std::atomic<uint64_t> nfiles;
   std::atomic<uint64_t> ndirs;
+  std::atomic<uint64_t> mBusProcessed {0}; ///< Files delivered by the bus
+  bool mBusFullCycle {false}; ///< Bus cycle was seen from the beginning
 
   std::mutex mutexScanStats;
   std::string mSpaceName; ///< Corresponding space name
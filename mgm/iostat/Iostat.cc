@@ -36,6 +36,7 @@
 #include "common/StringUtils.hh"
 #include "mgm/iostat/Iostat.hh"
 #include "mgm/ofs/XrdMgmOfs.hh"
+#include "mgm/cache/CachePrefetcher.hh"
 #include "mgm/imaster/IMaster.hh"
 #include "mq/MessagingRealm.hh"
 #include "namespace/interface/IView.hh"
@@ -1014,6 +1015,12 @@ Iostat::Receive(ThreadAssistant& assistant) noexcept
           AddToPopularity(report->path, report->rb, report->ots, report->cts);
         }
 
+        // Reads done by the prefetcher itself must not feed the popularity
+        if (report->rb && gOFS->mCachePrefetcher &&
+            (report->sec_app != "eos/cacheprefetch")) {
+          gOFS->mCachePrefetcher->RecordAccess(report->path, report->ots);
+        }
+
         std::string sdomain = report->sec_domain;
         {
           std::unique_lock<std::mutex> scope_lock(mDataMutex);
@@ -337,6 +337,19 @@ void LRU::backgroundThread(ThreadAssistant& assistant) noexcept
 
   while (!assistant.terminationRequested()) {
     const auto [enabled, interval] = getOptions();
+
+    if (enabled && gOFS->mNsScanBus && gOFS->mNsScanBus->IsEnabled()) {
+      // Directories are delivered by the namespace scan bus which also
+      // takes care of the master/slave transitions
+      gOFS->mNsScanBus->Register(this);
+      assistant.wait_for(minimumWaitTime);
+      continue;
+    }
+
+    if (gOFS->mNsScanBus) {
+      gOFS->mNsScanBus->Unregister(this);
+    }
+
     auto stopWatchInterval = interval;
     if (stopWatchInterval < minimumWaitTime) {
       eos_static_warning("msg=\"LRU scan interval is set to %lds which is less than minimum allowed %lds, setting to minimum!\"",
@@ -366,9 +379,59 @@ void LRU::backgroundThread(ThreadAssistant& assistant) noexcept
     }
   }
 
+  if (gOFS->mNsScanBus) {
+    gOFS->mNsScanBus->Unregister(this);
+  }
+
   eos_static_notice("%s", "msg=\"stopped LRU thread\"");
 }
 
+//------------------------------------------------------------------------------
+// Filter directories delivered by the namespace scan bus
+//------------------------------------------------------------------------------
+bool
+LRU::FilterContainer(const eos::ns::ContainerMdProto& proto) const
+{
+  for (const auto& elem : proto.xattrs()) {
+    if ((elem.first.compare(0, 8, "sys.lru.") == 0) ||
+        (elem.first == "sys.attr.link")) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Process a directory delivered by the namespace scan bus
+//------------------------------------------------------------------------------
+void
+LRU::ProcessContainer(eos::ns::ContainerMdProto&& proto)
+{
+  std::string path;
+
+  try {
+    eos::Prefetcher::prefetchContainerMDWithParentsAndWait(gOFS->eosView,
+        proto.id());
+    auto cmd = gOFS->eosDirectoryService->getContainerMD(proto.id());
+    path = gOFS->eosView->getUri(cmd.get());
+  } catch (const eos::MDException& e) {
+    // Directory removed in the meantime
+    return;
+  }
+
+  // Resolve the attributes including the linked ones
+  eos::IContainerMD::XAttrMap attrs;
+  XrdOucErrInfo err;
+
+  if (gOFS->_attr_ls(path.c_str(), err, mRootVid, nullptr, attrs, true)) {
+    return;
+  }
+
+  eos_static_debug("lru-dir-bus=\"%s\" attrs=%d", path.c_str(), attrs.size());
+  processDirectory(path, attrs);
+}
+
 //------------------------------------------------------------------------------
 // Process the given directory, apply all policies
 //------------------------------------------------------------------------------
@@ -26,6 +26,7 @@
 #include "common/Mapping.hh"
 #include "common/RegexWrapper.hh"
 #include "mgm/Namespace.hh"
+#include "mgm/nsscan/NsScanBus.hh"
 #include "namespace/interface/IContainerMD.hh"
 #include <XrdOuc/XrdOucErrInfo.hh>
 #include <memory>
@@ -39,9 +40,11 @@ class QClient;
 EOSMGMNAMESPACE_BEGIN
 
 //------------------------------------------------------------------------------
-// @brief  This class implements an LRU engine
+// @brief  This class implements an LRU engine. When the namespace scan bus
+// is enabled the directories are delivered by the bus instead of a private
+// namespace walk.
 //------------------------------------------------------------------------------
-class LRU
+class LRU: public NsScanConsumer
 {
 public:
   static const char* gLRUPolicyPrefix;
@@ -255,6 +258,27 @@ public:
   //! Entry in an lru queue having path name, mtime, size
   typedef struct lru_entry lru_entry_t;
 
+  //----------------------------------------------------------------------------
+  //! NsScanConsumer interface
+  //----------------------------------------------------------------------------
+  std::string GetScanConsumerName() const override
+  {
+    return "lru";
+  }
+
+  bool WantsContainers() const override
+  {
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Only directories carrying an LRU policy or an attribute link which might
+  //! provide one are delivered
+  //----------------------------------------------------------------------------
+  bool FilterContainer(const eos::ns::ContainerMdProto& proto) const override;
+
+  void ProcessContainer(eos::ns::ContainerMdProto&& proto) override;
+
 private:
   //----------------------------------------------------------------------------
   // LRU method doing the actual policy scrubbing
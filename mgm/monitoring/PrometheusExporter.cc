@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <ctime>
 #include <functional>
 #include <limits>
 #include <map>
@@ -1244,12 +1245,121 @@ private:
   std::string mCluster;
 };
 
+// Distribution of the files per quota node maintained by the namespace
+// statistics. Queries only read the sketches, the cost does not depend on the
+// namespace size.
+class NamespaceStatsCollector : public prometheus::Collectable {
+public:
+  NamespaceStatsCollector(
+      std::string cluster,
+      std::function<std::map<std::string, eos::NamespaceSketch>()> ns_sketches)
+      : mCluster(std::move(cluster))
+      , mNsSketches(std::move(ns_sketches))
+  {
+  }
+
+  std::vector<prometheus::MetricFamily>
+  Collect() const override
+  {
+    if (!mNsSketches) {
+      return {};
+    }
+
+    const auto sketches = mNsSketches();
+
+    if (sketches.empty()) {
+      return {};
+    }
+
+    static const std::vector<uint64_t> size_bounds{
+        0,           4ull << 10,  64ull << 10, 1ull << 20,  16ull << 20, 256ull << 20,
+        1ull << 30,  4ull << 30,  16ull << 30, 64ull << 30, 1ull << 40};
+    static const std::vector<uint64_t> age_bounds{
+        3600,           86400,           7 * 86400,       30 * 86400,
+        90 * 86400,     180 * 86400,     365 * 86400,     2 * 365 * 86400,
+        5 * 365 * 86400};
+    const time_t now = time(nullptr);
+    auto files = MakeGaugeFamily("eos_ns_stats_files",
+                                 "Estimated number of files per quota node.");
+    auto bytes = MakeGaugeFamily("eos_ns_stats_bytes",
+                                 "Estimated logical size of the files per quota node.");
+    auto uids = MakeGaugeFamily("eos_ns_stats_uids",
+                                "Estimated number of distinct file owners per quota node.");
+    auto stripes = MakeGaugeFamily("eos_ns_stats_stripes_files",
+                                   "Estimated number of files per quota node and "
+                                   "number of stripes of the layout.");
+    auto sizes = MakeHistogramFamily("eos_ns_stats_file_size_bytes",
+                                     "Estimated distribution of the file sizes per "
+                                     "quota node.");
+    auto ages = MakeHistogramFamily("eos_ns_stats_file_age_seconds",
+                                    "Estimated distribution of the file ages per "
+                                    "quota node, from the change time.");
+
+    for (const auto& [path, sketch] : sketches) {
+      const std::map<std::string, std::string> labels{{"cluster", mCluster},
+                                                      {"quota_node", path}};
+      AddGauge(files, labels, static_cast<double>(sketch.getFiles()));
+      AddGauge(bytes, labels, static_cast<double>(sketch.getBytes()));
+      AddGauge(uids, labels, static_cast<double>(sketch.getUids()));
+      const auto stripe_hist = sketch.getStripeHistogram();
+
+      for (size_t i = 0; i < stripe_hist.size(); ++i) {
+        if (stripe_hist[i]) {
+          auto stripe_labels = labels;
+          stripe_labels.emplace("stripes", std::to_string(i));
+          AddGauge(stripes, stripe_labels, static_cast<double>(stripe_hist[i]));
+        }
+      }
+
+      sizes.metric.push_back(MakeSketchHistogram(
+          labels, size_bounds, sketch.getSizeCumulative(size_bounds), sketch.getFiles(),
+          static_cast<double>(sketch.getBytes())));
+      ages.metric.push_back(MakeSketchHistogram(
+          labels, age_bounds, sketch.getAgeCumulative(age_bounds, now), sketch.getFiles(),
+          sketch.getAgeSum(now)));
+    }
+
+    return {std::move(files), std::move(bytes),   std::move(uids),
+            std::move(stripes), std::move(sizes), std::move(ages)};
+  }
+
+private:
+  static prometheus::ClientMetric
+  MakeSketchHistogram(const std::map<std::string, std::string>& labels,
+                      const std::vector<uint64_t>& bounds,
+                      const std::vector<uint64_t>& cumulative, uint64_t count,
+                      double sum)
+  {
+    prometheus::ClientMetric metric;
+    metric.histogram.sample_count = count;
+    metric.histogram.sample_sum = sum;
+    metric.histogram.bucket.reserve(bounds.size() + 1);
+
+    for (size_t i = 0; i < bounds.size() && i < cumulative.size(); ++i) {
+      metric.histogram.bucket.push_back(
+          {std::min(cumulative[i], count), static_cast<double>(bounds[i])});
+    }
+
+    metric.histogram.bucket.push_back({count, std::numeric_limits<double>::infinity()});
+
+    for (const auto& [name, label_value] : labels) {
+      metric.label.push_back({name, label_value});
+    }
+
+    return metric;
+  }
+
+  std::string mCluster;
+  std::function<std::map<std::string, eos::NamespaceSketch>()> mNsSketches;
+};
+
 } // namespace
 
 PrometheusExporter::PrometheusExporter(
     std::string bind_address, TrafficShapingEngine& engine, std::string cluster,
     const std::chrono::milliseconds cache_ttl, std::function<bool()> should_collect,
-    std::function<std::vector<MgmStatusSnapshot>()> mgm_status_snapshot)
+    std::function<std::vector<MgmStatusSnapshot>()> mgm_status_snapshot,
+    std::function<std::map<std::string, eos::NamespaceSketch>()> ns_sketches)
     : mExposer(std::make_unique<prometheus::Exposer>(std::move(bind_address),
                                                      kPrometheusExporterThreads))
 {
@@ -1264,6 +1374,11 @@ PrometheusExporter::PrometheusExporter(
       std::make_shared<CachedCollectable>(std::make_shared<FstStatusCollector>(cluster),
                                           fst_status_cache_ttl),
       should_collect);
+  auto ns_stats_collector = std::make_shared<MasterOnlyCollectable>(
+      std::make_shared<CachedCollectable>(
+          std::make_shared<NamespaceStatsCollector>(cluster, std::move(ns_sketches)),
+          cache_ttl),
+      should_collect);
   auto traffic_shaping_collector = std::make_shared<MasterOnlyCollectable>(
       std::make_shared<CachedCollectable>(
           std::make_shared<TrafficShapingCollector>(engine, std::move(cluster)),
@@ -1275,6 +1390,7 @@ PrometheusExporter::PrometheusExporter(
   mCollectors.emplace_back(std::move(mgm_status_collector));
   mCollectors.emplace_back(std::move(monitoring_collector));
   mCollectors.emplace_back(std::move(fst_status_collector));
+  mCollectors.emplace_back(std::move(ns_stats_collector));
   mCollectors.emplace_back(std::move(traffic_shaping_collector));
 
   for (const auto& collector : mCollectors) {
@@ -3,9 +3,11 @@
 #include "mgm/monitoring/MgmStatusCollector.hh"
 
 #include "mgm/shaping/TrafficShaping.hh"
+#include "namespace/ns_quarkdb/accounting/NamespaceSketch.hh"
 
 #include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -24,7 +26,9 @@ public:
                      traffic_shaping::TrafficShapingEngine& engine, std::string cluster,
                      std::chrono::milliseconds cache_ttl,
                      std::function<bool()> should_collect,
-                     std::function<std::vector<MgmStatusSnapshot>()> mgm_status_snapshot);
+                     std::function<std::vector<MgmStatusSnapshot>()> mgm_status_snapshot,
+                     std::function<std::map<std::string, eos::NamespaceSketch>()>
+                         ns_sketches);
   ~PrometheusExporter();
 
   PrometheusExporter(const PrometheusExporter&) = delete;
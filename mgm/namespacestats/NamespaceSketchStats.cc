@@ -0,0 +1,366 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Online file size/age/layout distribution per quota node
+//------------------------------------------------------------------------------
+
+#include "mgm/namespacestats/NamespaceSketchStats.hh"
+#include "common/Logging.hh"
+#include "common/ParseUtils.hh"
+#include "common/RWMutex.hh"
+#include "mgm/fsview/FsView.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
+#include "namespace/MDException.hh"
+#include "namespace/interface/IContainerMDSvc.hh"
+#include "namespace/interface/IView.hh"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+EOSMGMNAMESPACE_BEGIN
+
+namespace
+{
+//! Interval between two configuration checks
+constexpr auto kConfigInterval = std::chrono::seconds(30);
+//! Maximum accepted sample rate
+constexpr int64_t kMaxSampleRate = 1000000;
+}
+
+//------------------------------------------------------------------------------
+// Get the options from the default space configuration
+//------------------------------------------------------------------------------
+NamespaceSketchStats::Options
+NamespaceSketchStats::GetOptions()
+{
+  Options opts;
+  eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+  auto it = FsView::gFsView.mSpaceView.find("default");
+
+  if (it != FsView::gFsView.mSpaceView.end()) {
+    opts.enabled = (it->second->GetConfigMember("nsstats") == "on");
+    int64_t rate = 0;
+
+    if (common::ParseInt64(it->second->GetConfigMember("nsstats.sample"), rate) &&
+        (rate > 0)) {
+      opts.sampleRate = std::min(rate, kMaxSampleRate);
+    }
+  }
+
+  return opts;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+NamespaceSketchStats::NamespaceSketchStats():
+  mAccounting(std::make_shared<eos::NamespaceSketchAccounting>())
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+NamespaceSketchStats::~NamespaceSketchStats()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+// Start the configuration thread
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::Start()
+{
+  mThread.reset(&NamespaceSketchStats::Run, this);
+}
+
+//------------------------------------------------------------------------------
+// Stop the configuration thread
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::Stop()
+{
+  mThread.join();
+
+  if (mEnabled) {
+    Detach();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Configuration thread loop
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::Run(ThreadAssistant& assistant) noexcept
+{
+  ThreadAssistant::setSelfThreadName("NsSketchStats");
+  eos_static_info("%s", "msg=\"starting namespace statistics thread\"");
+
+  while (!assistant.terminationRequested()) {
+    if (gOFS->mNamespaceState == NamespaceState::kBooted) {
+      Options opts = GetOptions();
+
+      if (opts.enabled) {
+        Attach(opts.sampleRate);
+      } else if (mEnabled) {
+        Detach();
+      }
+    }
+
+    assistant.wait_for(kConfigInterval);
+  }
+
+  eos_static_info("%s", "msg=\"stopped namespace statistics thread\"");
+}
+
+//------------------------------------------------------------------------------
+// Attach the accounting to the quota updates
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::Attach(uint64_t sample_rate)
+{
+  if (mAccounting->getSampleRate() != sample_rate) {
+    eos_static_info("msg=\"namespace statistics sample rate changed\" "
+                    "rate=%llu", sample_rate);
+    mAccounting->setSampleRate(sample_rate);
+  }
+
+  if (!mEnabled) {
+    eos_static_info("msg=\"enable namespace statistics\" rate=%llu",
+                    sample_rate);
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+    gOFS->eosView->getQuotaStats()->setFileListener(mAccounting);
+    mEnabled = true;
+  }
+
+  // Bootstrap and refresh from the scan bus whenever it runs
+  if (gOFS->mNsScanBus) {
+    gOFS->mNsScanBus->Register(this);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Detach the accounting from the quota updates
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::Detach()
+{
+  eos_static_info("%s", "msg=\"disable namespace statistics\"");
+
+  if (gOFS->mNsScanBus) {
+    gOFS->mNsScanBus->Unregister(this);
+  }
+
+  if (gOFS->eosView) {
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+    gOFS->eosView->getQuotaStats()->setFileListener(nullptr);
+  }
+
+  mAccounting->reset();
+  mEnabled = false;
+}
+
+//------------------------------------------------------------------------------
+// Filter the files delivered by the scan bus
+//------------------------------------------------------------------------------
+bool
+NamespaceSketchStats::FilterFile(const eos::ns::FileMdProto& proto) const
+{
+  return proto.cont_id() &&
+         eos::NamespaceSketchAccounting::isSampled(proto.id(),
+             mAccounting->getSampleRate());
+}
+
+//------------------------------------------------------------------------------
+// Account a file delivered by the scan bus
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::ProcessFile(eos::ns::FileMdProto&& proto)
+{
+  if (!mRebuilding) {
+    return;
+  }
+
+  const eos::IContainerMD::id_t node_id = GetQuotaNodeId(proto.cont_id());
+
+  if (node_id == 0) {
+    return;
+  }
+
+  eos::IFileMD::ctime_t ctime {0, 0};
+
+  if (proto.ctime().size() == sizeof(ctime)) {
+    (void) memcpy(&ctime, proto.ctime().data(), sizeof(ctime));
+  }
+
+  mAccounting->rebuildFile(node_id, proto.id(), proto.size(), ctime.tv_sec,
+                           eos::NamespaceSketchAccounting::getStripes(proto.layout_id()),
+                           proto.uid());
+}
+
+//------------------------------------------------------------------------------
+// A scan bus cycle starts
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::CycleStart(uint64_t cycle, bool resumed)
+{
+  mNodeCache.clear();
+  // A resumed cycle does not deliver the whole namespace, keep the current
+  // sketches and wait for the next one
+  mRebuilding = !resumed;
+
+  if (mRebuilding) {
+    mAccounting->beginRebuild();
+  }
+}
+
+//------------------------------------------------------------------------------
+// A scan bus cycle ended
+//------------------------------------------------------------------------------
+void
+NamespaceSketchStats::CycleEnd(uint64_t cycle, bool complete)
+{
+  if (mRebuilding) {
+    mAccounting->endRebuild(complete);
+    eos_static_info("msg=\"namespace statistics rebuild done\" cycle=%llu "
+                    "complete=%d", cycle, complete);
+  }
+
+  mRebuilding = false;
+  mNodeCache.clear();
+}
+
+//------------------------------------------------------------------------------
+// Get the id of the quota node accounting the files of the given container
+//------------------------------------------------------------------------------
+eos::IContainerMD::id_t
+NamespaceSketchStats::GetQuotaNodeId(eos::IContainerMD::id_t cid)
+{
+  auto it = mNodeCache.find(cid);
+
+  if (it != mNodeCache.end()) {
+    return it->second;
+  }
+
+  eos::IContainerMD::id_t node_id = 0;
+
+  try {
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+    auto cmd = gOFS->eosDirectoryService->getContainerMD(cid);
+    eos::IQuotaNode* node = gOFS->eosView->getQuotaNode(cmd.get());
+
+    if (node) {
+      node_id = node->getId();
+    }
+  } catch (const eos::MDException& e) {
+    node_id = 0;
+  }
+
+  if (mNodeCache.size() >= sMaxCachedContainers) {
+    mNodeCache.clear();
+  }
+
+  mNodeCache.emplace(cid, node_id);
+  return node_id;
+}
+
+//------------------------------------------------------------------------------
+// Get a copy of the sketches indexed by the quota node path
+//------------------------------------------------------------------------------
+std::map<std::string, eos::NamespaceSketch>
+NamespaceSketchStats::GetSketches() const
+{
+  std::map<std::string, eos::NamespaceSketch> result;
+
+  if (!mEnabled) {
+    return result;
+  }
+
+  auto sketches = mAccounting->getSketches();
+  eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+
+  for (auto& elem : sketches) {
+    try {
+      auto cmd = gOFS->eosDirectoryService->getContainerMD(elem.first);
+      result.emplace(gOFS->eosView->getUri(cmd.get()), std::move(elem.second));
+    } catch (const eos::MDException& e) {
+      // Quota node removed in the meantime
+    }
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Get the summary of the distribution per quota node
+//------------------------------------------------------------------------------
+std::string
+NamespaceSketchStats::GetStats(bool monitoring) const
+{
+  std::ostringstream oss;
+  const std::string prefix = "uid=all gid=all ns.stats.";
+  const time_t now = time(nullptr);
+  const auto sketches = GetSketches();
+
+  if (monitoring) {
+    oss << prefix << "enabled=" << (mEnabled ? "true" : "false") << std::endl
+        << prefix << "sample=" << mAccounting->getSampleRate() << std::endl
+        << prefix << "updates=" << mAccounting->getNumUpdates() << std::endl
+        << prefix << "sampled=" << mAccounting->getNumSampled() << std::endl
+        << prefix << "rebuilds=" << mAccounting->getNumRebuilds() << std::endl
+        << prefix << "last_rebuild=" << mAccounting->getLastRebuildTs()
+        << std::endl;
+  } else {
+    oss << "ALL      ns stats                         "
+        << "enabled=" << (mEnabled ? "true" : "false")
+        << " sample=" << mAccounting->getSampleRate()
+        << " updates=" << mAccounting->getNumUpdates()
+        << " sampled=" << mAccounting->getNumSampled()
+        << " rebuilds=" << mAccounting->getNumRebuilds()
+        << " last_rebuild=" << mAccounting->getLastRebuildTs() << std::endl;
+  }
+
+  for (const auto& elem : sketches) {
+    const auto& sketch = elem.second;
+
+    if (monitoring) {
+      oss << prefix << "node=" << elem.first;
+    } else {
+      oss << "ALL      ns stats " << std::left << std::setw(23) << elem.first
+          << std::right;
+    }
+
+    oss << " files=" << sketch.getFiles()
+        << " bytes=" << sketch.getBytes()
+        << " uids=" << sketch.getUids()
+        << " size.p50=" << sketch.getSizePercentile(50)
+        << " size.p90=" << sketch.getSizePercentile(90)
+        << " size.p99=" << sketch.getSizePercentile(99)
+        << " age.p50=" << sketch.getAgePercentile(50, now)
+        << " age.p90=" << sketch.getAgePercentile(90, now)
+        << " stripes.mean=" << std::fixed << std::setprecision(2)
+        << sketch.getMeanStripes() << std::endl;
+  }
+
+  return oss.str();
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,151 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Online file size/age/layout distribution per quota node
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "mgm/Namespace.hh"
+#include "mgm/nsscan/NsScanBus.hh"
+#include "common/AssistedThread.hh"
+#include "namespace/ns_quarkdb/accounting/NamespaceSketch.hh"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class NamespaceSketchStats - keeps sampled statistical sketches of the
+//! files of every quota node (size, age and stripe histograms, number of
+//! distinct owners) up to date from the quota updates, so that distribution
+//! queries do not need a namespace scan.
+//!
+//! The sketches are rebuilt from every complete cycle of the namespace scan
+//! bus, which both bootstraps them and corrects the drift of the owner
+//! estimate. Without the scan bus only the files changed since the service
+//! was enabled are accounted.
+//!
+//! Configuration, in the default space: nsstats=on|off,
+//! nsstats.sample=<n> to account one file out of n.
+//------------------------------------------------------------------------------
+class NamespaceSketchStats: public NsScanConsumer
+{
+public:
+  //! Maximum number of container to quota node mappings cached by a scan
+  static constexpr size_t sMaxCachedContainers = 1000000;
+
+  //----------------------------------------------------------------------------
+  //! Simple struct describing the service options
+  //----------------------------------------------------------------------------
+  struct Options {
+    bool enabled = false;
+    uint64_t sampleRate = 100;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get the options from the default space configuration
+  //----------------------------------------------------------------------------
+  static Options GetOptions();
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  NamespaceSketchStats();
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~NamespaceSketchStats();
+
+  //----------------------------------------------------------------------------
+  //! Start/stop the configuration thread
+  //----------------------------------------------------------------------------
+  void Start();
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  //! Get a copy of the sketches indexed by the quota node path
+  //----------------------------------------------------------------------------
+  std::map<std::string, eos::NamespaceSketch> GetSketches() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the summary of the distribution per quota node
+  //!
+  //! @param monitoring if true use the key=value monitoring format
+  //----------------------------------------------------------------------------
+  std::string GetStats(bool monitoring) const;
+
+  //----------------------------------------------------------------------------
+  //! Check if the service is enabled
+  //----------------------------------------------------------------------------
+  inline bool IsEnabled() const
+  {
+    return mEnabled.load();
+  }
+
+  //----------------------------------------------------------------------------
+  //! NsScanConsumer interface
+  //----------------------------------------------------------------------------
+  std::string GetScanConsumerName() const override
+  {
+    return "nsstats";
+  }
+
+  bool WantsFiles() const override
+  {
+    return true;
+  }
+
+  bool FilterFile(const eos::ns::FileMdProto& proto) const override;
+  void ProcessFile(eos::ns::FileMdProto&& proto) override;
+  void CycleStart(uint64_t cycle, bool resumed) override;
+  void CycleEnd(uint64_t cycle, bool complete) override;
+
+private:
+  //----------------------------------------------------------------------------
+  //! Configuration thread loop
+  //----------------------------------------------------------------------------
+  void Run(ThreadAssistant& assistant) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Attach/detach the accounting to/from the quota updates
+  //----------------------------------------------------------------------------
+  void Attach(uint64_t sample_rate);
+  void Detach();
+
+  //----------------------------------------------------------------------------
+  //! Get the id of the quota node accounting the files of the given
+  //! container, 0 if there is none
+  //----------------------------------------------------------------------------
+  eos::IContainerMD::id_t GetQuotaNodeId(eos::IContainerMD::id_t cid);
+
+  AssistedThread mThread;
+  std::atomic<bool> mEnabled {false};
+  std::shared_ptr<eos::NamespaceSketchAccounting> mAccounting;
+  //! Scan bus state, only accessed by the consumer thread
+  bool mRebuilding {false};
+  std::unordered_map<eos::IContainerMD::id_t, eos::IContainerMD::id_t>
+  mNodeCache;
+};
+
+EOSMGMNAMESPACE_END
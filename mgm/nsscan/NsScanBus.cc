@@ -0,0 +1,1180 @@
+//------------------------------------------------------------------------------
+// File: NsScanBus.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/nsscan/NsScanBus.hh"
+#include "common/IntervalStopwatch.hh"
+#include "common/Logging.hh"
+#include "common/ParseUtils.hh"
+#include "common/RWMutex.hh"
+#include "mgm/fsview/FsView.hh"
+#include "mgm/imaster/IMaster.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
+#include "namespace/ns_quarkdb/inspector/ContainerScanner.hh"
+#include "namespace/ns_quarkdb/inspector/FileScanner.hh"
+#include <qclient/QClient.hh>
+#include <qclient/structures/QHash.hh>
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+
+EOSMGMNAMESPACE_BEGIN
+
+const std::string QdbNsScanSource::sCheckpointKey = "eos-ns-scan-bus";
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Get phase name used for reporting
+//------------------------------------------------------------------------------
+const char*
+PhaseName(int phase)
+{
+  switch (phase) {
+  case 0:
+    return "files";
+
+  case 1:
+    return "containers";
+
+  default:
+    return "idle";
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+// QdbNsScanSource constructor
+//------------------------------------------------------------------------------
+QdbNsScanSource::QdbNsScanSource(const eos::QdbContactDetails& qdb_details):
+  mQdbContactDetails(qdb_details)
+{}
+
+//------------------------------------------------------------------------------
+// QdbNsScanSource destructor
+//------------------------------------------------------------------------------
+QdbNsScanSource::~QdbNsScanSource() = default;
+
+//------------------------------------------------------------------------------
+// Get QuarkDB client, created on first use
+//------------------------------------------------------------------------------
+qclient::QClient&
+QdbNsScanSource::GetQClient()
+{
+  if (!mQcl) {
+    mQcl = std::make_unique<qclient::QClient>
+           (mQdbContactDetails.members, mQdbContactDetails.constructOptions());
+  }
+
+  return *mQcl;
+}
+
+//------------------------------------------------------------------------------
+// Stream all the file entries
+//------------------------------------------------------------------------------
+bool
+QdbNsScanSource::ScanFiles(const FileCallback& cb, std::string& err)
+{
+  FileScanner scanner(GetQClient());
+
+  while (scanner.valid()) {
+    eos::ns::FileMdProto proto;
+
+    if (!scanner.getItem(proto)) {
+      break;
+    }
+
+    if (!cb(std::move(proto))) {
+      return true;
+    }
+
+    scanner.next();
+  }
+
+  return !scanner.hasError(err);
+}
+
+//------------------------------------------------------------------------------
+// Stream all the container entries
+//------------------------------------------------------------------------------
+bool
+QdbNsScanSource::ScanContainers(const ContainerCallback& cb, std::string& err)
+{
+  ContainerScanner scanner(GetQClient());
+
+  while (scanner.valid()) {
+    eos::ns::ContainerMdProto proto;
+
+    if (!scanner.getItem(proto)) {
+      break;
+    }
+
+    if (!cb(std::move(proto))) {
+      return true;
+    }
+
+    scanner.next();
+  }
+
+  return !scanner.hasError(err);
+}
+
+//------------------------------------------------------------------------------
+// Load checkpoint fields from QuarkDB
+//------------------------------------------------------------------------------
+std::map<std::string, std::string>
+QdbNsScanSource::LoadCheckpoint()
+{
+  std::map<std::string, std::string> fields;
+
+  try {
+    qclient::QHash qhash(GetQClient(), sCheckpointKey);
+    std::vector<std::string> members = qhash.hgetall();
+
+    for (size_t i = 0; i + 1 < members.size(); i += 2) {
+      fields[members[i]] = members[i + 1];
+    }
+  } catch (const std::exception& e) {
+    eos_static_err("msg=\"failed to load ns scan checkpoint\" what=\"%s\"",
+                   e.what());
+  }
+
+  return fields;
+}
+
+//------------------------------------------------------------------------------
+// Store checkpoint fields in QuarkDB
+//------------------------------------------------------------------------------
+void
+QdbNsScanSource::StoreCheckpoint(const std::map<std::string, std::string>&
+                                 fields)
+{
+  try {
+    qclient::QHash qhash(GetQClient(), sCheckpointKey);
+    std::vector<std::string> args;
+
+    for (const auto& elem : fields) {
+      args.push_back(elem.first);
+      args.push_back(elem.second);
+    }
+
+    qhash.hmset(args);
+  } catch (const std::exception& e) {
+    eos_static_err("msg=\"failed to store ns scan checkpoint\" what=\"%s\"",
+                   e.what());
+  }
+}
+
+//------------------------------------------------------------------------------
+// Create an independent source over the same namespace
+//------------------------------------------------------------------------------
+std::unique_ptr<NsScanSource>
+QdbNsScanSource::Clone() const
+{
+  return std::make_unique<QdbNsScanSource>(mQdbContactDetails);
+}
+
+//------------------------------------------------------------------------------
+// Key comparison
+//------------------------------------------------------------------------------
+bool
+NsScanBus::Key::operator<(const Key& other) const
+{
+  // The locality hint is the big-endian parent id followed by the name, so
+  // comparing the parent numerically and the name bytewise gives its order
+  return std::tie(mPhase, mParent, mName, mId) <
+         std::tie(other.mPhase, other.mParent, other.mName, other.mId);
+}
+
+bool
+NsScanBus::Key::operator==(const Key& other) const
+{
+  return std::tie(mPhase, mParent, mName, mId) ==
+         std::tie(other.mPhase, other.mParent, other.mName, other.mId);
+}
+
+//------------------------------------------------------------------------------
+// Key preceding all the entries of the given phase
+//------------------------------------------------------------------------------
+NsScanBus::Key
+NsScanBus::Key::PhaseStart(Phase phase)
+{
+  Key key;
+  key.mPhase = phase;
+  return key;
+}
+
+//------------------------------------------------------------------------------
+// Build key of a file/container entry
+//------------------------------------------------------------------------------
+NsScanBus::Key
+NsScanBus::Key::FromProto(const eos::ns::FileMdProto& proto)
+{
+  Key key;
+  key.mPhase = Phase::Files;
+  key.mParent = proto.cont_id();
+  key.mName = proto.name();
+  key.mId = proto.id();
+  return key;
+}
+
+NsScanBus::Key
+NsScanBus::Key::FromProto(const eos::ns::ContainerMdProto& proto)
+{
+  Key key;
+  key.mPhase = Phase::Containers;
+  key.mParent = proto.parent_id();
+  key.mName = proto.name();
+  key.mId = proto.id();
+  return key;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+NsScanBus::NsScanBus(const eos::QdbContactDetails& qdb_details):
+  NsScanBus(std::make_unique<QdbNsScanSource>(qdb_details), []() {
+  return gOFS->mMaster->IsMaster();
+})
+{}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+NsScanBus::NsScanBus(std::unique_ptr<NsScanSource> source,
+                     std::function<bool()> is_master,
+                     size_t max_queue_size):
+  mSource(std::move(source)), mIsMaster(std::move(is_master)),
+  mMaxQueueSize(max_queue_size)
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+NsScanBus::~NsScanBus()
+{
+  Stop();
+  std::vector<std::shared_ptr<ConsumerState>> consumers;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    consumers.swap(mConsumers);
+  }
+
+  for (auto& state : consumers) {
+    {
+      std::unique_lock<std::mutex> lock(state->mMutex);
+      state->mRemoved = true;
+    }
+    state->mCondPush.notify_all();
+    state->mCondPop.notify_all();
+    state->mThread.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Start the scan thread
+//------------------------------------------------------------------------------
+void
+NsScanBus::Start()
+{
+  mThread.reset(&NsScanBus::ScanThread, this);
+}
+
+//------------------------------------------------------------------------------
+// Stop the scan thread
+//------------------------------------------------------------------------------
+void
+NsScanBus::Stop()
+{
+  mThread.join();
+}
+
+//------------------------------------------------------------------------------
+// Get the bus options from the default space configuration
+//------------------------------------------------------------------------------
+NsScanBus::Options
+NsScanBus::GetOptions()
+{
+  Options opts;
+  opts.enabled = false;
+  opts.interval = std::chrono::hours(4);
+  eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+  auto it = FsView::gFsView.mSpaceView.find("default");
+
+  if (it != FsView::gFsView.mSpaceView.end()) {
+    opts.enabled = (it->second->GetConfigMember("nsscan") == "on");
+    std::string interval = it->second->GetConfigMember("nsscan.interval");
+    int64_t intv = 0;
+
+    if (!interval.empty() && common::ParseInt64(interval, intv) && (intv > 0)) {
+      opts.interval = std::chrono::seconds(intv);
+    }
+  }
+
+  return opts;
+}
+
+//------------------------------------------------------------------------------
+// Register a consumer
+//------------------------------------------------------------------------------
+void
+NsScanBus::Register(NsScanConsumer* consumer)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (const auto& state : mConsumers) {
+    if (state->mConsumer == consumer) {
+      return;
+    }
+  }
+
+  auto state = std::make_shared<ConsumerState>();
+  state->mConsumer = consumer;
+  state->mName = consumer->GetScanConsumerName();
+  state->mThread.reset(&NsScanBus::ConsumerThread, this, state);
+  state->mThread.setName("NsScanConsumer");
+  mConsumers.push_back(state);
+  ++mGeneration;
+  eos_static_info("msg=\"registered ns scan consumer\" name=\"%s\"",
+                  state->mName.c_str());
+}
+
+//------------------------------------------------------------------------------
+// Unregister a consumer
+//------------------------------------------------------------------------------
+void
+NsScanBus::Unregister(NsScanConsumer* consumer)
+{
+  std::shared_ptr<ConsumerState> state;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto it = std::find_if(mConsumers.begin(), mConsumers.end(),
+    [consumer](const std::shared_ptr<ConsumerState>& elem) {
+      return (elem->mConsumer == consumer);
+    });
+
+    if (it == mConsumers.end()) {
+      return;
+    }
+
+    state = *it;
+    mConsumers.erase(it);
+    ++mGeneration;
+  }
+  {
+    std::unique_lock<std::mutex> lock(state->mMutex);
+    state->mRemoved = true;
+    state->mQueue.clear();
+  }
+  state->mCondPush.notify_all();
+  state->mCondPop.notify_all();
+  state->mThread.join();
+  eos_static_info("msg=\"unregistered ns scan consumer\" name=\"%s\"",
+                  state->mName.c_str());
+}
+
+//------------------------------------------------------------------------------
+// Check if the given consumer is registered
+//------------------------------------------------------------------------------
+bool
+NsScanBus::IsRegistered(NsScanConsumer* consumer) const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (const auto& state : mConsumers) {
+    if (state->mConsumer == consumer) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Check if the current cycle should be interrupted
+//------------------------------------------------------------------------------
+bool
+NsScanBus::ShouldInterrupt(ThreadAssistant& assistant) const
+{
+  return (assistant.terminationRequested() || !mEnabled || !mIsMaster());
+}
+
+//------------------------------------------------------------------------------
+// Scan thread loop
+//------------------------------------------------------------------------------
+void
+NsScanBus::ScanThread(ThreadAssistant& assistant) noexcept
+{
+  ThreadAssistant::setSelfThreadName("NsScanBus");
+  gOFS->WaitUntilNamespaceIsBooted(assistant);
+  eos_static_notice("%s", "msg=\"starting ns scan bus thread\"");
+
+  while (!assistant.terminationRequested()) {
+    Options opts = GetOptions();
+    mEnabled = opts.enabled;
+    common::IntervalStopwatch stopwatch(opts.interval);
+
+    if (!opts.enabled || !mIsMaster()) {
+      // Re-read the checkpoint once we become master again since the
+      // previous master might have progressed in the meantime
+      mCheckpointLoaded = false;
+      assistant.wait_for(std::chrono::seconds(10));
+      continue;
+    }
+
+    (void) RunCycle(assistant);
+
+    while (!assistant.terminationRequested() &&
+           (stopwatch.timeRemainingInCycle() > std::chrono::milliseconds(0))) {
+      assistant.wait_for(std::min<std::chrono::milliseconds>
+                         (std::chrono::seconds(10),
+                          stopwatch.timeRemainingInCycle()));
+
+      if (mEnabled != GetOptions().enabled) {
+        break;
+      }
+    }
+  }
+
+  eos_static_notice("%s", "msg=\"stopped ns scan bus thread\"");
+}
+
+//------------------------------------------------------------------------------
+// Run one scan cycle
+//------------------------------------------------------------------------------
+bool
+NsScanBus::RunCycle(ThreadAssistant& assistant)
+{
+  if (!mCheckpointLoaded) {
+    mNext = LoadCheckpoint();
+    mCheckpointLoaded = true;
+
+    if (mNext.mKey.mPhase == Phase::Done) {
+      mNext.mCycle++;
+      mNext.mKey = Key::PhaseStart(Phase::Files);
+    } else {
+      eos_static_notice("msg=\"resuming ns scan cycle\" cycle=%llu "
+                        "phase=%s parent=%llu id=%llu", mNext.mCycle,
+                        PhaseName((int)mNext.mKey.mPhase),
+                        mNext.mKey.mParent, mNext.mKey.mId);
+    }
+  }
+
+  const bool complete = PerformCycle(assistant, mNext);
+
+  if (complete) {
+    mNext.mCycle++;
+    mNext.mKey = Key::PhaseStart(Phase::Files);
+  } else {
+    // The checkpoint reflects the last safe position of the interrupted
+    // cycle, pick it up from there
+    mCheckpointLoaded = false;
+  }
+
+  return complete;
+}
+
+//------------------------------------------------------------------------------
+// Perform one scan cycle starting from the given checkpoint
+//------------------------------------------------------------------------------
+bool
+NsScanBus::PerformCycle(ThreadAssistant& assistant, const Checkpoint& start)
+{
+  using namespace std::chrono;
+  const bool resumed = !(start.mKey == Key::PhaseStart(Phase::Files));
+  const auto start_ts = steady_clock::now();
+  std::vector<std::shared_ptr<ConsumerState>> snapshot;
+  uint64_t generation = 0;
+  RefreshSnapshot(snapshot, generation);
+  mCycle = start.mCycle;
+  mCycleScanned = 0;
+  mResumedId = (resumed ? start.mKey.mId : 0);
+  mCycleStartTs = time(NULL);
+  eos_static_info("msg=\"ns scan cycle started\" cycle=%llu resumed=%d "
+                  "num_consumers=%llu", start.mCycle, resumed, snapshot.size());
+
+  for (auto& state : snapshot) {
+    {
+      std::unique_lock<std::mutex> lock(state->mMutex);
+
+      if (state->mCatchUp) {
+        // Still busy with a previous cycle, it joins the next one
+        eos_static_info("msg=\"ns scan consumer skips cycle\" name=\"%s\" "
+                        "cycle=%llu", state->mName.c_str(), start.mCycle);
+        continue;
+      }
+
+      state->mActive = true;
+      state->mCycle = start.mCycle;
+    }
+    state->mRateBudget = state->mConsumer->GetRateBudget();
+    state->mDelivered = 0;
+    Entry entry;
+    entry.mType = Entry::Type::CycleStart;
+    entry.mKey = start.mKey;
+    entry.mCycle = start.mCycle;
+    entry.mFlag = resumed;
+    entry.mTs = steady_clock::now();
+    (void) Enqueue(*state, std::move(entry));
+  }
+
+  bool complete = true;
+  auto last_checkpoint = steady_clock::now();
+  uint64_t pos = 0;
+  Key scan_key = start.mKey;
+  std::string err;
+
+  // Helper to fan out one entry to all active consumers
+  auto dispatch = [&](auto && proto, Entry::Type type) {
+    for (auto& state : snapshot) {
+      bool wanted = false;
+
+      if constexpr(std::is_same_v<std::decay_t<decltype(proto)>,
+                   eos::ns::FileMdProto>) {
+        wanted = state->mConsumer->WantsFiles() &&
+                 state->mConsumer->FilterFile(proto);
+      } else {
+        wanted = state->mConsumer->WantsContainers() &&
+                 state->mConsumer->FilterContainer(proto);
+      }
+
+      if (wanted) {
+        Entry entry;
+        entry.mType = type;
+        entry.mKey = scan_key;
+        entry.mCycle = start.mCycle;
+        entry.mTs = steady_clock::now();
+        entry.mProto = proto;
+        (void) Enqueue(*state, std::move(entry));
+      }
+    }
+  };
+
+  // Helper for the periodic housekeeping during a phase
+  auto housekeeping = [&]() {
+    if (generation != mGeneration) {
+      RefreshSnapshot(snapshot, generation);
+    }
+
+    if (ShouldInterrupt(assistant)) {
+      return false;
+    }
+
+    if (steady_clock::now() - last_checkpoint > sCheckpointInterval) {
+      StoreCheckpoint({start.mCycle, GetSafeKey(snapshot, start.mCycle,
+                                                scan_key)});
+      last_checkpoint = steady_clock::now();
+    }
+
+    return true;
+  };
+
+  // Process one entry, the ones before the start key were already delivered
+  auto process = [&](auto && proto, Entry::Type type) {
+    Key key = Key::FromProto(proto);
+
+    if (key < start.mKey) {
+      return true;
+    }
+
+    scan_key = std::move(key);
+    mPhasePos = ++pos;
+    ++mCycleScanned;
+    ++mTotalScanned;
+    dispatch(proto, type);
+
+    if (((pos & 1023) == 0) && !housekeeping()) {
+      complete = false;
+      return false;
+    }
+
+    return true;
+  };
+
+  // Stream all the file entries
+  if (start.mKey.mPhase == Phase::Files) {
+    mPhase = (int)Phase::Files;
+    mPhasePos = 0;
+
+    if (!mSource->ScanFiles([&](eos::ns::FileMdProto && proto) {
+    return process(proto, Entry::Type::File);
+    }, err)) {
+      eos_static_err("msg=\"ns scan bus file scanner error\" error=\"%s\"",
+                     err.c_str());
+      complete = false;
+    }
+  }
+
+  // Stream all the container entries
+  if (complete && (start.mKey.mPhase <= Phase::Containers)) {
+    mPhase = (int)Phase::Containers;
+    mPhasePos = 0;
+    pos = 0;
+    scan_key = Key::PhaseStart(Phase::Containers);
+
+    if (!mSource->ScanContainers([&](eos::ns::ContainerMdProto && proto) {
+    return process(proto, Entry::Type::Container);
+    }, err)) {
+      eos_static_err("msg=\"ns scan bus container scanner error\" "
+                     "error=\"%s\"", err.c_str());
+      complete = false;
+    }
+  }
+
+  if (complete) {
+    scan_key = Key::PhaseStart(Phase::Done);
+  }
+
+  // Notify the end of the cycle to the consumers which got it all from the
+  // shared scan, the others do it at the end of their own scan
+  for (auto& state : snapshot) {
+    Entry entry;
+    entry.mType = Entry::Type::CycleEnd;
+    entry.mKey = scan_key;
+    entry.mCycle = start.mCycle;
+    entry.mFlag = complete;
+    entry.mTs = steady_clock::now();
+    (void) Enqueue(*state, std::move(entry));
+  }
+
+  // Mark the cycle done only once the queued entries were processed so that
+  // a restart in the meantime replays them. The consumers still catching up
+  // are not waited for, they would hold back the next cycle of the others.
+  if (complete) {
+    WaitDrained(snapshot, assistant);
+  }
+
+  // The cycle is done only if the drain was not interrupted either
+  complete = complete && !ShouldInterrupt(assistant);
+
+  if (complete) {
+    StoreCheckpoint({start.mCycle, Key::PhaseStart(Phase::Done)});
+  } else {
+    StoreCheckpoint({start.mCycle, GetSafeKey(snapshot, start.mCycle,
+                                              scan_key)});
+  }
+
+  for (auto& state : snapshot) {
+    std::unique_lock<std::mutex> lock(state->mMutex);
+    state->mActive = false;
+  }
+
+  const uint64_t duration_ms =
+    duration_cast<milliseconds>(steady_clock::now() - start_ts).count();
+  mPhase = (int)Phase::Done;
+  mLastCycleScanned = mCycleScanned.load();
+  mLastCycleDurationMs = duration_ms;
+  mLastCycleComplete = complete;
+  eos_static_info("msg=\"ns scan cycle finished\" cycle=%llu complete=%d "
+                  "scanned=%llu duration_ms=%llu", start.mCycle, complete,
+                  mLastCycleScanned.load(), duration_ms);
+  return complete;
+}
+
+//------------------------------------------------------------------------------
+// Consumer thread loop delivering the queued entries
+//------------------------------------------------------------------------------
+void
+NsScanBus::ConsumerThread(std::shared_ptr<ConsumerState> state,
+                          ThreadAssistant& assistant) noexcept
+{
+  state->mWindowStart = std::chrono::steady_clock::now();
+
+  while (true) {
+    Entry entry;
+    bool catch_up = false;
+    {
+      std::unique_lock<std::mutex> lock(state->mMutex);
+
+      while (state->mQueue.empty() && !state->mCatchUp && !state->mRemoved &&
+             !assistant.terminationRequested()) {
+        state->mCondPush.wait_for(lock, std::chrono::seconds(1));
+      }
+
+      if (state->mRemoved || assistant.terminationRequested()) {
+        break;
+      }
+
+      if (state->mQueue.empty()) {
+        // Everything queued before falling behind was processed
+        catch_up = true;
+      } else {
+        entry = std::move(state->mQueue.front());
+        state->mQueue.pop_front();
+        state->mBusy = true;
+        state->mInFlightKey = entry.mKey;
+      }
+    }
+
+    if (catch_up) {
+      CatchUp(*state, assistant);
+      continue;
+    }
+
+    state->mCondPop.notify_all();
+
+    if ((entry.mType == Entry::Type::File) ||
+        (entry.mType == Entry::Type::Container)) {
+      Throttle(*state, assistant);
+    }
+
+    Deliver(*state, entry);
+    {
+      std::unique_lock<std::mutex> lock(state->mMutex);
+      state->mBusy = false;
+    }
+    state->mCondPop.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Finish the current cycle of a consumer which fell behind with its own scan
+//------------------------------------------------------------------------------
+void
+NsScanBus::CatchUp(ConsumerState& state, ThreadAssistant& assistant)
+{
+  Key from;
+  uint64_t cycle = 0;
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    from = state.mResumeKey;
+    cycle = state.mCycle;
+  }
+  eos_static_info("msg=\"ns scan consumer continues with its own scan\" "
+                  "name=\"%s\" cycle=%llu phase=%s id=%llu",
+                  state.mName.c_str(), cycle, PhaseName((int)from.mPhase),
+                  from.mId);
+  std::unique_ptr<NsScanSource> source = mSource->Clone();
+  bool complete = true;
+  uint64_t count = 0;
+  std::string err;
+
+  auto process = [&](auto && proto, Entry::Type type) {
+    Key key = Key::FromProto(proto);
+
+    if (key < from) {
+      return true;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(state.mMutex);
+
+      if (state.mRemoved) {
+        complete = false;
+        return false;
+      }
+
+      state.mResumeKey = key;
+    }
+
+    if (((++count & 1023) == 0) && ShouldInterrupt(assistant)) {
+      complete = false;
+      return false;
+    }
+
+    bool wanted = false;
+
+    if constexpr(std::is_same_v<std::decay_t<decltype(proto)>,
+                 eos::ns::FileMdProto>) {
+      wanted = state.mConsumer->WantsFiles() &&
+               state.mConsumer->FilterFile(proto);
+    } else {
+      wanted = state.mConsumer->WantsContainers() &&
+               state.mConsumer->FilterContainer(proto);
+    }
+
+    if (wanted) {
+      Throttle(state, assistant);
+      Entry entry;
+      entry.mType = type;
+      entry.mKey = std::move(key);
+      entry.mCycle = cycle;
+      entry.mProto = std::move(proto);
+      Deliver(state, entry);
+    }
+
+    return true;
+  };
+
+  if (from.mPhase == Phase::Files) {
+    if (!source->ScanFiles([&](eos::ns::FileMdProto && proto) {
+    return process(proto, Entry::Type::File);
+    }, err)) {
+      eos_static_err("msg=\"ns scan consumer file scanner error\" "
+                     "name=\"%s\" error=\"%s\"", state.mName.c_str(),
+                     err.c_str());
+      complete = false;
+    }
+
+    from = Key::PhaseStart(Phase::Containers);
+  }
+
+  if (complete && (from.mPhase == Phase::Containers)) {
+    if (!source->ScanContainers([&](eos::ns::ContainerMdProto && proto) {
+    return process(proto, Entry::Type::Container);
+    }, err)) {
+      eos_static_err("msg=\"ns scan consumer container scanner error\" "
+                     "name=\"%s\" error=\"%s\"", state.mName.c_str(),
+                     err.c_str());
+      complete = false;
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+
+    if (state.mRemoved) {
+      return;
+    }
+  }
+
+  Entry entry;
+  entry.mType = Entry::Type::CycleEnd;
+  entry.mCycle = cycle;
+  entry.mFlag = complete;
+  ++state.mCatchUps;
+  Deliver(state, entry);
+  std::unique_lock<std::mutex> lock(state.mMutex);
+  state.mCatchUp = false;
+}
+
+//------------------------------------------------------------------------------
+// Wait as needed to keep the consumer within its rate budget
+//------------------------------------------------------------------------------
+void
+NsScanBus::Throttle(ConsumerState& state, ThreadAssistant& assistant)
+{
+  using namespace std::chrono;
+  const uint64_t budget = state.mRateBudget;
+
+  if (!budget) {
+    return;
+  }
+
+  auto now = steady_clock::now();
+
+  if (now - state.mWindowStart > seconds(10)) {
+    state.mWindowStart = now;
+    state.mWindowCount = 0;
+  }
+
+  ++state.mWindowCount;
+  const int64_t elapsed_us =
+    duration_cast<microseconds>(now - state.mWindowStart).count();
+  const int64_t expected_us = state.mWindowCount * 1000000 / budget;
+
+  if (expected_us > elapsed_us) {
+    auto delay = std::min<microseconds>(microseconds(expected_us - elapsed_us),
+                                        seconds(1));
+    assistant.wait_for(delay);
+    state.mThrottledUs += delay.count();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Invoke the consumer callback corresponding to the entry
+//------------------------------------------------------------------------------
+void
+NsScanBus::Deliver(ConsumerState& state, Entry& entry)
+{
+  try {
+    switch (entry.mType) {
+    case Entry::Type::CycleStart:
+      state.mWindowStart = std::chrono::steady_clock::now();
+      state.mWindowCount = 0;
+      state.mConsumer->CycleStart(entry.mCycle, entry.mFlag);
+      break;
+
+    case Entry::Type::File:
+      state.mConsumer->ProcessFile
+      (std::move(std::get<eos::ns::FileMdProto>(entry.mProto)));
+      ++state.mDelivered;
+      ++state.mTotalDelivered;
+      break;
+
+    case Entry::Type::Container:
+      state.mConsumer->ProcessContainer
+      (std::move(std::get<eos::ns::ContainerMdProto>(entry.mProto)));
+      ++state.mDelivered;
+      ++state.mTotalDelivered;
+      break;
+
+    case Entry::Type::CycleEnd:
+      state.mConsumer->CycleEnd(entry.mCycle, entry.mFlag);
+      break;
+    }
+  } catch (const std::exception& e) {
+    eos_static_err("msg=\"ns scan consumer exception\" name=\"%s\" "
+                   "what=\"%s\"", state.mName.c_str(), e.what());
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get a snapshot of the registered consumers
+//------------------------------------------------------------------------------
+void
+NsScanBus::RefreshSnapshot(std::vector<std::shared_ptr<ConsumerState>>&
+                           snapshot, uint64_t& generation) const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  generation = mGeneration;
+  // Consumers registered in the middle of a cycle stay inactive until the
+  // next one starts
+  snapshot = mConsumers;
+}
+
+//------------------------------------------------------------------------------
+// Queue an entry for a consumer
+//------------------------------------------------------------------------------
+bool
+NsScanBus::Enqueue(ConsumerState& state, Entry&& entry)
+{
+  bool queued = false;
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+
+    if (state.mRemoved || !state.mActive) {
+      return false;
+    }
+
+    if ((state.mQueue.size() >= mMaxQueueSize) &&
+        ((entry.mType == Entry::Type::File) ||
+         (entry.mType == Entry::Type::Container))) {
+      // Leave the shared scan, the consumer continues from this entry on
+      // its own once the queue is drained
+      state.mActive = false;
+      state.mCatchUp = true;
+      state.mResumeKey = entry.mKey;
+      eos_static_info("msg=\"ns scan consumer fell behind\" name=\"%s\" "
+                      "cycle=%llu", state.mName.c_str(), entry.mCycle);
+    } else {
+      state.mQueue.push_back(std::move(entry));
+      queued = true;
+    }
+  }
+  state.mCondPush.notify_one();
+  return queued;
+}
+
+//------------------------------------------------------------------------------
+// Block until the queues of the consumers in the shared scan are drained
+//------------------------------------------------------------------------------
+void
+NsScanBus::WaitDrained(const std::vector<std::shared_ptr<ConsumerState>>&
+                       snapshot, ThreadAssistant& assistant)
+{
+  for (const auto& state : snapshot) {
+    std::unique_lock<std::mutex> lock(state->mMutex);
+
+    while (!state->mRemoved && state->mActive &&
+           (!state->mQueue.empty() || state->mBusy)) {
+      state->mCondPop.wait_for(lock, std::chrono::seconds(1));
+
+      if (ShouldInterrupt(assistant)) {
+        return;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Compute the key of the first entry not yet processed by all the consumers
+//------------------------------------------------------------------------------
+NsScanBus::Key
+NsScanBus::GetSafeKey(const std::vector<std::shared_ptr<ConsumerState>>&
+                      snapshot, uint64_t cycle, const Key& scan_key) const
+{
+  Key safe = scan_key;
+
+  for (const auto& state : snapshot) {
+    std::unique_lock<std::mutex> lock(state->mMutex);
+
+    if (state->mRemoved || (state->mCycle != cycle) ||
+        (!state->mActive && !state->mCatchUp)) {
+      continue;
+    }
+
+    // The entry in flight is not yet done, it needs to be replayed
+    if (state->mBusy && (state->mInFlightKey < safe)) {
+      safe = state->mInFlightKey;
+    }
+
+    for (const auto& entry : state->mQueue) {
+      // Skip the cycle notifications, their key is not an entry position
+      if ((entry.mType == Entry::Type::File) ||
+          (entry.mType == Entry::Type::Container)) {
+        if (entry.mKey < safe) {
+          safe = entry.mKey;
+        }
+
+        break;
+      }
+    }
+
+    if (state->mCatchUp && (state->mResumeKey < safe)) {
+      safe = state->mResumeKey;
+    }
+  }
+
+  return safe;
+}
+
+//------------------------------------------------------------------------------
+// Load checkpoint using the scan source
+//------------------------------------------------------------------------------
+NsScanBus::Checkpoint
+NsScanBus::LoadCheckpoint()
+{
+  Checkpoint cp;
+  std::map<std::string, std::string> fields = mSource->LoadCheckpoint();
+  int64_t val = 0;
+
+  for (const auto& elem : fields) {
+    if (elem.first == "name") {
+      cp.mKey.mName = elem.second;
+      continue;
+    }
+
+    if (!common::ParseInt64(elem.second, val) || (val < 0)) {
+      continue;
+    }
+
+    if (elem.first == "cycle") {
+      cp.mCycle = val;
+    } else if (elem.first == "phase") {
+      cp.mKey.mPhase = (val <= (int)Phase::Done) ? (Phase)val : Phase::Done;
+    } else if (elem.first == "parent") {
+      cp.mKey.mParent = val;
+    } else if (elem.first == "id") {
+      cp.mKey.mId = val;
+    }
+  }
+
+  // Checkpoints without a key hold an ordinal offset which is not reliable,
+  // restart the phase in this case
+  if (!fields.count("id")) {
+    cp.mKey = Key::PhaseStart(cp.mKey.mPhase);
+  }
+
+  return cp;
+}
+
+//------------------------------------------------------------------------------
+// Store checkpoint using the scan source
+//------------------------------------------------------------------------------
+void
+NsScanBus::StoreCheckpoint(const Checkpoint& cp)
+{
+  mSource->StoreCheckpoint({
+    {"cycle", std::to_string(cp.mCycle)},
+    {"phase", std::to_string((int)cp.mKey.mPhase)},
+    {"parent", std::to_string(cp.mKey.mParent)},
+    {"name", cp.mKey.mName},
+    {"id", std::to_string(cp.mKey.mId)},
+    {"timestamp", std::to_string(time(NULL))}
+  });
+}
+
+//------------------------------------------------------------------------------
+// Get scan throughput and per-consumer lag statistics
+//------------------------------------------------------------------------------
+std::string
+NsScanBus::GetStats(bool monitoring) const
+{
+  using namespace std::chrono;
+  std::ostringstream oss;
+  const int phase = mPhase;
+  const time_t elapsed = time(NULL) - mCycleStartTs;
+  const uint64_t rate = ((phase != (int)Phase::Done) && (elapsed > 0)) ?
+                        mCycleScanned / elapsed :
+                        (mLastCycleDurationMs ?
+                         mLastCycleScanned * 1000 / mLastCycleDurationMs : 0);
+  const std::string prefix = "uid=all gid=all ns.scanbus.";
+
+  if (monitoring) {
+    oss << prefix << "enabled=" << (mEnabled ? "true" : "false") << std::endl
+        << prefix << "cycle=" << mCycle << std::endl
+        << prefix << "phase=" << PhaseName(phase) << std::endl
+        << prefix << "position=" << mPhasePos << std::endl
+        << prefix << "resumed_id=" << mResumedId << std::endl
+        << prefix << "scanned=" << mCycleScanned << std::endl
+        << prefix << "scanned.total=" << mTotalScanned << std::endl
+        << prefix << "rate=" << rate << std::endl
+        << prefix << "last_cycle.scanned=" << mLastCycleScanned << std::endl
+        << prefix << "last_cycle.duration_ms=" << mLastCycleDurationMs
+        << std::endl
+        << prefix << "last_cycle.complete="
+        << (mLastCycleComplete ? "true" : "false") << std::endl;
+  } else {
+    oss << "ALL      ns scan bus                      "
+        << "enabled=" << (mEnabled ? "true" : "false")
+        << " cycle=" << mCycle << " phase=" << PhaseName(phase)
+        << " position=" << mPhasePos << " scanned=" << mCycleScanned
+        << " rate=" << rate << "Hz"
+        << " last_cycle_sec=" << mLastCycleDurationMs / 1000
+        << " last_cycle_complete=" << (mLastCycleComplete ? "true" : "false")
+        << std::endl;
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (const auto& state : mConsumers) {
+    uint64_t pending = 0;
+    uint64_t lag_sec = 0;
+    bool catch_up = false;
+    {
+      std::unique_lock<std::mutex> state_lock(state->mMutex);
+      pending = state->mQueue.size();
+      catch_up = state->mCatchUp;
+
+      if (!state->mQueue.empty()) {
+        lag_sec = duration_cast<seconds>(steady_clock::now() -
+                                         state->mQueue.front().mTs).count();
+      }
+    }
+
+    if (monitoring) {
+      const std::string cprefix = prefix + "consumer." + state->mName + ".";
+      oss << cprefix << "pending=" << pending << std::endl
+          << cprefix << "lag_sec=" << lag_sec << std::endl
+          << cprefix << "delivered=" << state->mDelivered << std::endl
+          << cprefix << "delivered.total=" << state->mTotalDelivered << std::endl
+          << cprefix << "rate_budget=" << state->mRateBudget << std::endl
+          << cprefix << "throttled_ms=" << state->mThrottledUs / 1000
+          << std::endl
+          << cprefix << "catch_up=" << (catch_up ? "true" : "false")
+          << std::endl
+          << cprefix << "catch_up.cycles=" << state->mCatchUps << std::endl;
+    } else {
+      oss << "ALL      ns scan consumer                 "
+          << "name=" << state->mName << " pending=" << pending
+          << " lag_sec=" << lag_sec << " delivered=" << state->mDelivered
+          << " rate_budget=" << state->mRateBudget
+          << " throttled_ms=" << state->mThrottledUs / 1000
+          << " catch_up=" << (catch_up ? "true" : "false") << std::endl;
+    }
+  }
+
+  return oss.str();
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,516 @@
+//------------------------------------------------------------------------------
+// File: NsScanBus.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "mgm/Namespace.hh"
+#include "common/AssistedThread.hh"
+#include "namespace/ns_quarkdb/QdbContactDetails.hh"
+#include "proto/ContainerMd.pb.h"
+#include "proto/FileMd.pb.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace qclient
+{
+class QClient;
+}
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Interface implemented by the services consuming the namespace scan bus.
+//! All the Process/Cycle callbacks of a consumer are invoked, in scan order,
+//! from a single thread owned by the bus. Filters are evaluated by the scan
+//! thread, or by the consumer thread while it catches up after falling
+//! behind, and must therefore be cheap and thread-safe.
+//------------------------------------------------------------------------------
+class NsScanConsumer
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  virtual ~NsScanConsumer() = default;
+
+  //----------------------------------------------------------------------------
+  //! Get consumer name used for reporting
+  //----------------------------------------------------------------------------
+  virtual std::string GetScanConsumerName() const = 0;
+
+  //----------------------------------------------------------------------------
+  //! Check if the consumer is interested in file/container entries
+  //----------------------------------------------------------------------------
+  virtual bool WantsFiles() const
+  {
+    return false;
+  }
+
+  virtual bool WantsContainers() const
+  {
+    return false;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Filter applied by the scan thread before queueing an entry
+  //!
+  //! @return true if entry should be delivered to the consumer
+  //----------------------------------------------------------------------------
+  virtual bool FilterFile(const eos::ns::FileMdProto& proto) const
+  {
+    return true;
+  }
+
+  virtual bool FilterContainer(const eos::ns::ContainerMdProto& proto) const
+  {
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Process a file/container entry
+  //----------------------------------------------------------------------------
+  virtual void ProcessFile(eos::ns::FileMdProto&& proto) {}
+
+  virtual void ProcessContainer(eos::ns::ContainerMdProto&& proto) {}
+
+  //----------------------------------------------------------------------------
+  //! Get maximum number of entries per second the consumer wants to process,
+  //! 0 means unlimited. Queried at the start of every cycle.
+  //----------------------------------------------------------------------------
+  virtual uint64_t GetRateBudget()
+  {
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Notification that a scan cycle starts
+  //!
+  //! @param cycle cycle number
+  //! @param resumed if true the cycle is resumed from a checkpoint and the
+  //!        entries before it are not delivered again
+  //----------------------------------------------------------------------------
+  virtual void CycleStart(uint64_t cycle, bool resumed) {}
+
+  //----------------------------------------------------------------------------
+  //! Notification that a scan cycle ended
+  //!
+  //! @param cycle cycle number
+  //! @param complete if true the whole namespace was delivered, false if the
+  //!        cycle was interrupted e.g. due to a master/slave transition
+  //----------------------------------------------------------------------------
+  virtual void CycleEnd(uint64_t cycle, bool complete) {}
+};
+
+//------------------------------------------------------------------------------
+//! Interface of the namespace metadata streamed by the scan bus
+//------------------------------------------------------------------------------
+class NsScanSource
+{
+public:
+  //! Callbacks invoked for every entry, returning false stops the scan
+  using FileCallback = std::function<bool(eos::ns::FileMdProto&&)>;
+  using ContainerCallback = std::function<bool(eos::ns::ContainerMdProto&&)>;
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  virtual ~NsScanSource() = default;
+
+  //----------------------------------------------------------------------------
+  //! Stream all the file/container entries in locality hint order i.e.
+  //! ordered by parent container id, name and id
+  //!
+  //! @param cb callback invoked for every entry
+  //! @param err error message if any
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  virtual bool ScanFiles(const FileCallback& cb, std::string& err) = 0;
+  virtual bool ScanContainers(const ContainerCallback& cb,
+                              std::string& err) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Load/store the scan checkpoint fields
+  //----------------------------------------------------------------------------
+  virtual std::map<std::string, std::string> LoadCheckpoint() = 0;
+  virtual void StoreCheckpoint(const std::map<std::string, std::string>&
+                               fields) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Create an independent source over the same namespace, used by the
+  //! consumers which fell behind to continue with their own scan
+  //----------------------------------------------------------------------------
+  virtual std::unique_ptr<NsScanSource> Clone() const = 0;
+};
+
+//------------------------------------------------------------------------------
+//! Scan source reading the namespace metadata stored in QuarkDB
+//------------------------------------------------------------------------------
+class QdbNsScanSource: public NsScanSource
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param qdb_details QuarkDB contact details
+  //----------------------------------------------------------------------------
+  QdbNsScanSource(const eos::QdbContactDetails& qdb_details);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~QdbNsScanSource() override;
+
+  bool ScanFiles(const FileCallback& cb, std::string& err) override;
+  bool ScanContainers(const ContainerCallback& cb, std::string& err) override;
+  std::map<std::string, std::string> LoadCheckpoint() override;
+  void StoreCheckpoint(const std::map<std::string, std::string>& fields)
+  override;
+  std::unique_ptr<NsScanSource> Clone() const override;
+
+private:
+  //----------------------------------------------------------------------------
+  //! Get QuarkDB client, created on first use
+  //----------------------------------------------------------------------------
+  qclient::QClient& GetQClient();
+
+  eos::QdbContactDetails mQdbContactDetails;
+  std::unique_ptr<qclient::QClient> mQcl;
+  static const std::string sCheckpointKey; ///< QuarkDB checkpoint hash
+};
+
+//------------------------------------------------------------------------------
+//! Class NsScanBus - single namespace scan service running on the master MGM.
+//!
+//! Every cycle streams the file and container metadata once and fans the
+//! entries out to the registered consumers. Each consumer has its own bounded
+//! queue, filter and rate budget. The scan never waits for a consumer: one
+//! whose queue is full falls behind, stops receiving entries from the shared
+//! scan and, once its queue is drained, finishes the cycle with its own scan
+//! starting from the first entry it missed. A slow consumer therefore does
+//! not delay the others.
+//!
+//! The scan position is checkpointed as the key, in scan order, of the first
+//! entry not yet processed by every consumer taking part in the cycle, so
+//! that a cycle interrupted by an MGM restart is resumed rather than
+//! restarted. Being a key, the position stays valid when entries are created
+//! or deleted in the meantime. Consumers still catching up when the shared
+//! scan of a cycle finishes are not covered by the checkpoint any more.
+//!
+//! Configuration, in the default space: nsscan=on|off, nsscan.interval=<sec>
+//------------------------------------------------------------------------------
+class NsScanBus
+{
+public:
+  //! Default maximum number of entries queued per consumer
+  static constexpr size_t sMaxQueueSize = 10000;
+  //! Interval between two checkpoints of the scan position
+  static constexpr std::chrono::seconds sCheckpointInterval {30};
+
+  //----------------------------------------------------------------------------
+  //! Simple struct describing the bus options
+  //----------------------------------------------------------------------------
+  struct Options {
+    bool enabled;                  //< Is the scan bus enabled
+    std::chrono::seconds interval; //< Start a cycle every this many seconds
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param qdb_details QuarkDB contact details
+  //----------------------------------------------------------------------------
+  NsScanBus(const eos::QdbContactDetails& qdb_details);
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param source namespace scan source
+  //! @param is_master function telling if this MGM is the master
+  //! @param max_queue_size maximum number of entries queued per consumer
+  //----------------------------------------------------------------------------
+  NsScanBus(std::unique_ptr<NsScanSource> source,
+            std::function<bool()> is_master,
+            size_t max_queue_size = sMaxQueueSize);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~NsScanBus();
+
+  //----------------------------------------------------------------------------
+  //! Start/stop the scan thread
+  //----------------------------------------------------------------------------
+  void Start();
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  //! Get the bus options from the default space configuration
+  //----------------------------------------------------------------------------
+  static Options GetOptions();
+
+  //----------------------------------------------------------------------------
+  //! Check if the bus is enabled i.e. consumers should not run their own scan
+  //----------------------------------------------------------------------------
+  inline bool IsEnabled() const
+  {
+    return mEnabled.load();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Enable/disable the bus, normally done by the scan thread following the
+  //! default space configuration
+  //----------------------------------------------------------------------------
+  inline void SetEnabled(bool enabled)
+  {
+    mEnabled = enabled;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Run one scan cycle, resuming the cycle stored in the checkpoint if it
+  //! was interrupted
+  //!
+  //! @return true if the whole namespace was scanned, otherwise false
+  //----------------------------------------------------------------------------
+  bool RunCycle(ThreadAssistant& assistant);
+
+  //----------------------------------------------------------------------------
+  //! Register a consumer. The consumer gets entries starting with the next
+  //! cycle. Registering an already registered consumer is a no-op.
+  //----------------------------------------------------------------------------
+  void Register(NsScanConsumer* consumer);
+
+  //----------------------------------------------------------------------------
+  //! Unregister a consumer. Once this returns no more callbacks are invoked
+  //! on the consumer. Pending entries are discarded.
+  //----------------------------------------------------------------------------
+  void Unregister(NsScanConsumer* consumer);
+
+  //----------------------------------------------------------------------------
+  //! Check if the given consumer is registered
+  //----------------------------------------------------------------------------
+  bool IsRegistered(NsScanConsumer* consumer) const;
+
+  //----------------------------------------------------------------------------
+  //! Get scan throughput and per-consumer lag statistics
+  //!
+  //! @param monitoring if true use the key=value monitoring format
+  //----------------------------------------------------------------------------
+  std::string GetStats(bool monitoring) const;
+
+private:
+  //! Scan phases, files are streamed before containers
+  enum class Phase : int {
+    Files = 0,
+    Containers = 1,
+    Done = 2
+  };
+
+  //----------------------------------------------------------------------------
+  //! Position of an entry in the scan order. Within a phase the entries are
+  //! ordered like the QuarkDB locality hint i.e. by parent container id and
+  //! name, the id only breaks ties.
+  //----------------------------------------------------------------------------
+  struct Key {
+    Phase mPhase {Phase::Files};
+    uint64_t mParent {0};
+    std::string mName;
+    uint64_t mId {0};
+
+    bool operator<(const Key& other) const;
+    bool operator==(const Key& other) const;
+
+    //! Key preceding all the entries of the given phase
+    static Key PhaseStart(Phase phase);
+    static Key FromProto(const eos::ns::FileMdProto& proto);
+    static Key FromProto(const eos::ns::ContainerMdProto& proto);
+  };
+
+  //----------------------------------------------------------------------------
+  //! Entry queued for a consumer
+  //----------------------------------------------------------------------------
+  struct Entry {
+    enum class Type {
+      CycleStart, File, Container, CycleEnd
+    };
+
+    Type mType;
+    Key mKey; ///< Position in the scan
+    uint64_t mCycle {0};
+    bool mFlag {false}; ///< Resumed for CycleStart, complete for CycleEnd
+    std::chrono::steady_clock::time_point mTs;
+    std::variant<std::monostate, eos::ns::FileMdProto,
+        eos::ns::ContainerMdProto> mProto;
+  };
+
+  //----------------------------------------------------------------------------
+  //! State kept for every registered consumer
+  //----------------------------------------------------------------------------
+  struct ConsumerState {
+    NsScanConsumer* mConsumer {nullptr};
+    std::string mName;
+    mutable std::mutex mMutex;
+    std::condition_variable mCondPush; ///< Signalled when an entry is queued
+    std::condition_variable mCondPop; ///< Signalled when an entry is consumed
+    std::deque<Entry> mQueue;
+    bool mBusy {false}; ///< Entry popped but not yet processed
+    Key mInFlightKey; ///< Key of the entry being processed
+    bool mRemoved {false}; ///< Consumer unregistered
+    //! Consumer gets entries from the shared scan of the current cycle
+    bool mActive {false};
+    //! Consumer fell behind and finishes the cycle with its own scan
+    bool mCatchUp {false};
+    //! Key of the first entry not yet processed by the catch-up scan
+    Key mResumeKey;
+    uint64_t mCycle {0}; ///< Cycle delivered to the consumer
+    std::atomic<uint64_t> mRateBudget {0};
+    std::atomic<uint64_t> mDelivered {0}; ///< Entries in the current cycle
+    std::atomic<uint64_t> mTotalDelivered {0};
+    std::atomic<uint64_t> mThrottledUs {0}; ///< Time spent pacing
+    std::atomic<uint64_t> mCatchUps {0}; ///< Cycles finished by catch-up
+    //! Pacing window, used only by the consumer thread
+    std::chrono::steady_clock::time_point mWindowStart;
+    uint64_t mWindowCount {0};
+    AssistedThread mThread;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Scan checkpoint, a key in the Done phase marks a finished cycle
+  //----------------------------------------------------------------------------
+  struct Checkpoint {
+    uint64_t mCycle {0};
+    Key mKey {Key::PhaseStart(Phase::Done)};
+  };
+
+  //----------------------------------------------------------------------------
+  //! Scan thread loop
+  //----------------------------------------------------------------------------
+  void ScanThread(ThreadAssistant& assistant) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Perform one scan cycle starting from the given checkpoint
+  //!
+  //! @return true if the whole namespace was scanned, otherwise false
+  //----------------------------------------------------------------------------
+  bool PerformCycle(ThreadAssistant& assistant, const Checkpoint& start);
+
+  //----------------------------------------------------------------------------
+  //! Consumer thread loop delivering the queued entries
+  //----------------------------------------------------------------------------
+  void ConsumerThread(std::shared_ptr<ConsumerState> state,
+                      ThreadAssistant& assistant) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Finish the current cycle of a consumer which fell behind with its own
+  //! scan starting from its resume key. Called by the consumer thread.
+  //----------------------------------------------------------------------------
+  void CatchUp(ConsumerState& state, ThreadAssistant& assistant);
+
+  //----------------------------------------------------------------------------
+  //! Wait as needed to keep the consumer within its rate budget
+  //----------------------------------------------------------------------------
+  void Throttle(ConsumerState& state, ThreadAssistant& assistant);
+
+  //----------------------------------------------------------------------------
+  //! Invoke the consumer callback corresponding to the entry
+  //----------------------------------------------------------------------------
+  void Deliver(ConsumerState& state, Entry& entry);
+
+  //----------------------------------------------------------------------------
+  //! Get a snapshot of the registered consumers if it changed since the
+  //! last call
+  //!
+  //! @param snapshot current snapshot updated in place
+  //! @param generation generation of the snapshot updated in place
+  //----------------------------------------------------------------------------
+  void RefreshSnapshot(std::vector<std::shared_ptr<ConsumerState>>& snapshot,
+                       uint64_t& generation) const;
+
+  //----------------------------------------------------------------------------
+  //! Queue an entry for a consumer, never blocks. If the queue is full the
+  //! consumer falls behind and continues the cycle with its own scan.
+  //!
+  //! @return true if the entry was queued, otherwise false
+  //----------------------------------------------------------------------------
+  bool Enqueue(ConsumerState& state, Entry&& entry);
+
+  //----------------------------------------------------------------------------
+  //! Block until the queues of the consumers taking part in the shared scan
+  //! are drained
+  //----------------------------------------------------------------------------
+  void WaitDrained(const std::vector<std::shared_ptr<ConsumerState>>& snapshot,
+                   ThreadAssistant& assistant);
+
+  //----------------------------------------------------------------------------
+  //! Compute the key of the first entry of the given cycle not yet processed
+  //! by all the consumers
+  //!
+  //! @param snapshot consumers snapshot
+  //! @param cycle current cycle
+  //! @param scan_key key of the last entry dispatched by the scan
+  //----------------------------------------------------------------------------
+  Key GetSafeKey(const std::vector<std::shared_ptr<ConsumerState>>& snapshot,
+                 uint64_t cycle, const Key& scan_key) const;
+
+  //----------------------------------------------------------------------------
+  //! Load/store checkpoint using the scan source
+  //----------------------------------------------------------------------------
+  Checkpoint LoadCheckpoint();
+  void StoreCheckpoint(const Checkpoint& cp);
+
+  //----------------------------------------------------------------------------
+  //! Check if the current cycle should be interrupted
+  //----------------------------------------------------------------------------
+  bool ShouldInterrupt(ThreadAssistant& assistant) const;
+
+  std::unique_ptr<NsScanSource> mSource;
+  std::function<bool()> mIsMaster;
+  const size_t mMaxQueueSize;
+  AssistedThread mThread; ///< Scan thread
+  std::atomic<bool> mEnabled {false};
+  bool mCheckpointLoaded {false}; ///< Used only by the scan thread
+  Checkpoint mNext; ///< Next cycle to run, used only by the scan thread
+  mutable std::mutex mMutex; ///< Mutex protecting the consumers
+  std::vector<std::shared_ptr<ConsumerState>> mConsumers;
+  std::atomic<uint64_t> mGeneration {0}; ///< Bumped on every (un)register
+  //! Scan statistics
+  std::atomic<uint64_t> mCycle {0};
+  std::atomic<int> mPhase {(int)Phase::Done};
+  std::atomic<uint64_t> mPhasePos {0};
+  std::atomic<uint64_t> mCycleScanned {0};
+  std::atomic<uint64_t> mResumedId {0};
+  std::atomic<time_t> mCycleStartTs {0};
+  std::atomic<uint64_t> mLastCycleScanned {0};
+  std::atomic<uint64_t> mLastCycleDurationMs {0};
+  std::atomic<bool> mLastCycleComplete {false};
+  std::atomic<uint64_t> mTotalScanned {0};
+};
+
+EOSMGMNAMESPACE_END
@@ -37,6 +37,7 @@
 #include "common/StackTrace.hh"
 #include "common/Strerror_r_wrapper.hh"
 #include "common/SymKeys.hh"
+#include "common/Tracing.hh"
 #include "common/http/OwnCloud.hh"
 #include "common/plugin_manager/DynamicLibrary.hh"
 #include "common/plugin_manager/Plugin.hh"
@@ -56,6 +57,7 @@
 #include "mgm/bulk-request/dao/factories/ProcDirectoryDAOFactory.hh"
 #include "mgm/bulk-request/dao/proc/ProcDirectoryBulkRequestLocations.hh"
 #include "mgm/bulk-request/dao/proc/cleaner/BulkRequestProcCleaner.hh"
+#include "mgm/bulk-request/dao/qdb/QdbBulkRequestStore.hh"
 #include "mgm/bulk-request/interface/RealMgmFileSystemInterface.hh"
 #include "mgm/bulk-request/prepare/manager/BulkRequestPrepareManager.hh"
 #include "mgm/bulk-request/prepare/manager/PrepareManager.hh"
@@ -76,6 +78,9 @@
 #include "mgm/imaster/IMaster.hh"
 #include "mgm/iostat/Iostat.hh"
 #include "mgm/lru/LRU.hh"
+#include "mgm/nsscan/NsScanBus.hh"
+#include "mgm/cache/CachePrefetcher.hh"
+#include "mgm/namespacestats/NamespaceSketchStats.hh"
 #include "mgm/macros/Macros.hh"
 #include "mgm/misc/Constants.hh"
 #include "mgm/monitoring/Monitoring.hh"
@@ -615,6 +620,10 @@ XrdMgmOfs::ApplyMonitoringConfig(std::string* err)
           const bool is_master = mMaster->IsMaster();
           return monitoring::BuildMgmStatusSnapshots(mgm_id, is_master, master_id,
                                                      ManagerPort, mgm_candidate_hosts);
+        },
+        [this]() {
+          return mNsSketchStats ? mNsSketchStats->GetSketches()
+                                : std::map<std::string, eos::NamespaceSketch>();
         });
     mPrometheusExporterBindAddress = bind_address;
     mPrometheusExporterCacheTtlSeconds = cache_ttl_seconds;
@@ -788,6 +797,25 @@ XrdMgmOfs::OrderlyShutdown()
     WFEPtr.reset();
   }
 
+  eos_warning("%s", "msg=\"stopping the request tracing dumper\"");
+  eos::common::Tracer::Instance().StopDumper();
+  eos::common::Tracer::SetSampleRate(0);
+
+  if (mNsSketchStats) {
+    eos_warning("%s", "msg=\"stopping the namespace statistics\"");
+    mNsSketchStats->Stop();
+  }
+
+  if (mNsScanBus) {
+    eos_warning("%s", "msg=\"stopping the namespace scan bus\"");
+    mNsScanBus->Stop();
+  }
+
+  if (mCachePrefetcher) {
+    eos_warning("%s", "msg=\"stopping the cache prefetcher\"");
+    mCachePrefetcher->Stop();
+  }
+
   eos_warning("%s", "msg=\"stopping and deleting the LRU engine\"");
   mLRUEngine.reset();
 
@@ -811,6 +839,13 @@ XrdMgmOfs::OrderlyShutdown()
     WNCd.reset();
   }
 
+  if (mNsCacheWarmer) {
+    eos_warning("%s", "msg=\"stopping cache warmer and saving hot containers\"");
+    mNsCacheWarmer->Stop();
+    mNsCacheWarmer->SaveHotSet();
+    mNsCacheWarmer.reset();
+  }
+
   eos_warning("%s", "msg=\"cleanup quota information\"");
   (void) Quota::CleanUp();
   eos_warning("%s", "msg=\"graceful shutdown of the FsView\"");
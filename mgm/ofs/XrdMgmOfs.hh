@@ -121,6 +121,7 @@
 #include "mgm/misc/IdTrackerWithValidity.hh"
 #include "mgm/namespacestats/NamespaceStats.hh"
 #include "mgm/proc/ProcCommand.hh"
+#include "mgm/qdbmaster/BootTimeline.hh"
 #include "mgm/proc/admin/NsCmd.hh"
 #include "mgm/proc/admin/SpaceCmd.hh"
 #include "mgm/shaping/TrafficShaping.hh"
@@ -181,6 +182,9 @@ class Iostat;
 class Stat;
 class WFE;
 class LRU;
+class NsScanBus;
+class CachePrefetcher;
+class NamespaceSketchStats;
 class Fsck;
 class FsckEntry;
 class IMaster;
@@ -202,6 +206,7 @@ namespace eos::mgm::bulk
 {
 class ProcDirectoryBulkRequestLocations;
 class BulkRequestProcCleaner;
+class QdbBulkRequestStore;
 }
 
 namespace eos::mgm::rest
@@ -1817,6 +1822,7 @@ public:
   std::atomic<time_t> mFileInitTime; ///< Time for the file initialization
   std::atomic<time_t> mTotalInitTime; ///< Time for entire initialization
   std::atomic<time_t> mStartTime; ///< Timestamp when daemon started
+  BootTimeline mBootTimeline; ///< Per phase timeline of the namespace boot
   bool Shutdown; ///< true if the shutdown function was called => avoid to join some threads
   //! Const strings to print the namespace boot state as in eNamespace
 
@@ -2065,6 +2071,8 @@ public:
   std::unique_ptr<Fsck> mFsckEngine; ///< Fsck functionality
   //! Master/Slave configuration/failover class
   std::unique_ptr<IMaster> mMaster;
+  //! Cache warm-up from, and periodic save of, the hot containers
+  std::unique_ptr<NsCacheWarmer> mNsCacheWarmer;
 
   //! Map storing the last time of a filesystem dump, this information is used
   //! to track filesystems which have not been checked decentral by an FST.
@@ -2098,6 +2106,15 @@ public:
   uint32_t mPrometheusExporterCacheTtlSeconds = 0;
   mutable std::mutex mPrometheusExporterMutex;
 
+  //! Namespace scan bus shared by the LRU, file inspector and tape GC
+  std::unique_ptr<NsScanBus> mNsScanBus;
+
+  //! Prefetching of popular files into the read-through cache spaces
+  std::unique_ptr<CachePrefetcher> mCachePrefetcher;
+
+  //! Online file distribution statistics per quota node
+  std::unique_ptr<NamespaceSketchStats> mNsSketchStats;
+
   //! LRU object running the LRU policy engine
   std::unique_ptr<LRU> mLRUEngine;
 
@@ -2147,6 +2164,9 @@ public:
   //! The class holding the paths where the bulk-requests coming from the HTTP tape REST API will be persisted
   std::unique_ptr<eos::mgm::bulk::ProcDirectoryBulkRequestLocations>
   mProcDirectoryBulkRequestTapeRestApiLocations;
+  //! QuarkDB store of the bulk-requests coming from the HTTP tape REST API,
+  //! nullptr if they are persisted in the proc directory
+  std::unique_ptr<eos::mgm::bulk::QdbBulkRequestStore> mBulkRequestStore;
 
   //! BulkRequestProcCleaner
   std::unique_ptr<bulk::BulkRequestProcCleaner> mBulkReqProcCleaner;
@@ -2303,6 +2323,16 @@ private:
                     eos::common::VirtualIdentity& vid,
                     const XrdSecEntity* client);
 
+  //----------------------------------------------------------------------------
+  //! Warm-up of a file in the read-through cache done (from the cache FST)
+  //----------------------------------------------------------------------------
+  int CacheWarmed(const char* path,
+                  const char* ininfo,
+                  XrdOucEnv& env,
+                  XrdOucErrInfo& error,
+                  eos::common::VirtualIdentity& vid,
+                  const XrdSecEntity* client);
+
   //----------------------------------------------------------------------------
   //! Get checksum of file
   //----------------------------------------------------------------------------
@@ -2343,6 +2373,18 @@ private:
              eos::common::VirtualIdentity& vid,
              const XrdSecEntity* client);
 
+  //----------------------------------------------------------------------------
+  //! Commit a batch of replicas sent by an FST in one request. All the items
+  //! are applied under a single namespace write lock and the response holds
+  //! the result code of each item.
+  //----------------------------------------------------------------------------
+  int CommitBatch(const char* path,
+                  const char* ininfo,
+                  XrdOucEnv& env,
+                  XrdOucErrInfo& error,
+                  eos::common::VirtualIdentity& vid,
+                  const XrdSecEntity* client);
+
   //----------------------------------------------------------------------------
   //! Drop a replica
   //----------------------------------------------------------------------------
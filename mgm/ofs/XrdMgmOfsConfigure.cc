@@ -29,6 +29,7 @@
 #include "common/InstanceName.hh"
 #include "common/JeMallocHandler.hh"
 #include "common/Logging.hh"
+#include "common/ParseUtils.hh"
 #include "common/PasswordHandler.hh"
 #include "common/Path.hh"
 #include "common/RWMutex.hh"
@@ -36,6 +37,7 @@
 #include "common/StacktraceHere.hh"
 #include "common/StringTokenizer.hh"
 #include "common/StringUtils.hh"
+#include "common/Tracing.hh"
 #include "common/Utils.hh"
 #include "common/plugin_manager/PluginManager.hh"
 #include "common/thread_id.hh"
@@ -46,6 +48,7 @@
 #include "mgm/adminsocket/AdminSocket.hh"
 #include "mgm/bulk-request/dao/proc/ProcDirectoryBulkRequestLocations.hh"
 #include "mgm/bulk-request/dao/proc/cleaner/BulkRequestProcCleaner.hh"
+#include "mgm/bulk-request/dao/qdb/QdbBulkRequestStore.hh"
 #include "mgm/bulk-request/dao/proc/cleaner/BulkRequestProcCleanerConfig.hh"
 #include "mgm/config/QuarkDBConfigEngine.hh"
 #include "mgm/convert/ConverterEngine.hh"
@@ -60,6 +63,9 @@
 #include "mgm/inspector/FileInspector.hh"
 #include "mgm/iostat/Iostat.hh"
 #include "mgm/lru/LRU.hh"
+#include "mgm/nsscan/NsScanBus.hh"
+#include "mgm/cache/CachePrefetcher.hh"
+#include "mgm/namespacestats/NamespaceSketchStats.hh"
 #include "mgm/monitoring/Monitoring.hh"
 #include "mgm/ofs/XrdMgmOfs.hh"
 #include "mgm/ofs/XrdMgmOfsTrace.hh"
@@ -311,6 +317,10 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
                        (int)SIGRTMIN, (int)SIGRTMAX);
   }
 
+  if (SIGRTMIN <= 43 && 43 <= SIGRTMAX) {
+    signal(43, eos::common::Tracer::DumpSignalHandler);
+  }
+
   // Create and own the output cache directory or clean it up if it exists -
   // this is used to store temporary results for commands like find, backup
   // or archive
@@ -433,6 +443,7 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
 
   std::string tapeRestApiSitename;
   std::map<std::string, std::string> tapeRestApiEndpointUrlMap;
+  bool tapeRestApiQdbBulkRequestStore = false;
   XrdHttpPort = ManagerPort;
 
   if (!ConfigFN || !*ConfigFN) {
@@ -1179,6 +1190,17 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
           }
         }
 
+        if (!strcmp("taperestapi.bulkrequeststore", var)) {
+          if ((!(val = Config.GetWord())) ||
+              (strcmp("qdb", val) && strcmp("proc", val))) {
+            Eroute.Emsg("Config", "argument for taperestapi.bulkrequeststore is "
+                        "invalid. Must be <qdb> or <proc>!");
+          } else {
+            tapeRestApiQdbBulkRequestStore = !strcmp("qdb", val);
+            Eroute.Say("=====> taperestapi.bulkrequeststore: ", val, "");
+          }
+        }
+
         const char* endpointsStr = "taperestapi.endpoints.";
         int endpointsStrLen = strlen(endpointsStr);
 
@@ -1815,6 +1837,11 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
   mProcDirectoryBulkRequestTapeRestApiLocations.reset(new
       bulk::ProcDirectoryBulkRequestLocations(restApiProcBulkRequestPath));
 
+  if (tapeRestApiQdbBulkRequestStore) {
+    // The bulk-requests still in the proc directory get migrated when accessed
+    mBulkRequestStore.reset(new bulk::QdbBulkRequestStore(mQdbContactDetails));
+  }
+
   if (mMaster->IsMaster()) {
     // Create /eos/ and /eos/<instance>/ directories
     std::shared_ptr<eos::IContainerMD> eosmd;
@@ -2121,7 +2148,8 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
    */
   mHttpTapeRestApiBulkReqProcCleaner.reset(new bulk::BulkRequestProcCleaner(
         *gOFS->mProcDirectoryBulkRequestTapeRestApiLocations,
-        bulk::BulkRequestProcCleanerConfig::getDefaultConfig()));
+        bulk::BulkRequestProcCleanerConfig::getDefaultConfig(),
+        mBulkRequestStore.get()));
   mHttpTapeRestApiBulkReqProcCleaner->Start();
   // Initialize the replication tracker
   mReplicationTracker.reset(ReplicationTracker::Create(
@@ -2249,6 +2277,41 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
     mConverterEngine->ApplyConfig();
   }
 
+  // start the namespace scan bus, consumers register once it is enabled
+  mNsScanBus.reset(new eos::mgm::NsScanBus(mQdbContactDetails));
+  mNsScanBus->Start();
+  // start the cache prefetcher, idle unless enabled for a space
+  mCachePrefetcher.reset(new eos::mgm::CachePrefetcher());
+  mCachePrefetcher->Start();
+  // start the namespace statistics, idle unless enabled
+  mNsSketchStats.reset(new eos::mgm::NamespaceSketchStats());
+  mNsSketchStats->Start();
+  // start the request tracing dumper, the sample rate follows the default
+  // space config and the traces are written upon signal 43 in the meta log
+  // dir unless EOS_MGM_TRACING_DIR is set
+  std::string tracing_dir = MgmMetaLogDir.c_str();
+
+  if (getenv("EOS_MGM_TRACING_DIR")) {
+    tracing_dir = getenv("EOS_MGM_TRACING_DIR");
+  }
+
+  eos::common::Tracer::Instance().StartDumper("mgm", tracing_dir, []() {
+    int64_t rate = -1;
+    eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+    auto it = FsView::gFsView.mSpaceView.find("default");
+
+    if (it != FsView::gFsView.mSpaceView.end()) {
+      if (it->second->GetConfigMember("tracing") != "on") {
+        rate = 0;
+      } else if (!eos::common::ParseInt64(
+                   it->second->GetConfigMember("tracing.sample"), rate) ||
+                 (rate <= 0)) {
+        rate = 1000;
+      }
+    }
+
+    return rate;
+  });
   // start the LRU daemon
   mLRUEngine->Start();
 
@@ -2276,6 +2339,9 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
   InitStats();
   // start the fuse server
   gOFS->zMQ->gFuseServer.start();
+  // Serve the egroup memberships known before the restart
+  (void) EgroupRefresh->SetSnapshotPath(SSTR(MgmMetaLogDir << "/egroup."
+                                       << ManagerId << ".snapshot"));
   const std::string iostat_file = SSTR(MgmMetaLogDir << "/iostat." << ManagerId
                                        << ".dump");
 
@@ -2376,6 +2442,8 @@ XrdMgmOfs::InitStats()
   MgmStats.Add("Chmod", 0, 0, 0);
   MgmStats.Add("Chown", 0, 0, 0);
   MgmStats.Add("Commit", 0, 0, 0);
+  MgmStats.Add("CommitBatch", 0, 0, 0);
+  MgmStats.Add("CommitBatchLock", 0, 0, 0);
   MgmStats.Add("CommitFailedFid", 0, 0, 0);
   MgmStats.Add("CommitFailedNamespace", 0, 0, 0);
   MgmStats.Add("CommitFailedParameters", 0, 0, 0);
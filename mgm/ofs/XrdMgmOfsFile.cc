@@ -32,6 +32,7 @@
 #include "common/Strerror_r_wrapper.hh"
 #include "common/BehaviourConfig.hh"
 #include "common/Utils.hh"
+#include "common/Tracing.hh"
 #include "mgm/misc/Constants.hh"
 #include "mgm/access/Access.hh"
 #include "mgm/convert/ConversionTag.hh"
@@ -54,6 +55,7 @@
 #include "mgm/xattr/XattrLock.hh"
 #include "mgm/convert/ConverterEngine.hh"
 #include "mgm/placement/FsScheduler.hh"
+#include "mgm/cache/CachePrefetcher.hh"
 #include "mgm/cache/ReadThroughCache.hh"
 #include "namespace/utils/Attributes.hh"
 #include "namespace/Prefetcher.hh"
@@ -605,6 +607,7 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
   eos::common::Timing tm("Open");
   COMMONTIMING("begin", &tm);
   EXEC_TIMING_BEGIN("Open");
+  eos::common::TraceRequest trace_request("mgm.open");
   XrdOucString spath = inpath;
   XrdOucString sinfo = ininfo;
   SetLogId(logId, tident);
@@ -614,6 +617,7 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
   Access_Operation acc_op = GetXrdAccessOperation(open_flags);
   {
     EXEC_TIMING_BEGIN("IdMap");
+    eos::common::TraceSpan idmap_span("mgm.open.idmap");
     std::string validation_path = spath.c_str();
 
     if (spath.beginswith("/zteos64:")) {
@@ -691,6 +695,7 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
   std::string ioPriority;
   XrdOucString pinfo = (ininfo ? ininfo : "");
   eos::common::StringConversion::MaskTag(pinfo, "cap.msg");
+  eos::common::StringConversion::MaskTag(pinfo, "cap.bin");
   eos::common::StringConversion::MaskTag(pinfo, "cap.sym");
   eos::common::StringConversion::MaskTag(pinfo, "authz");
 
@@ -1049,6 +1054,8 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
   gid_t d_gid = vid.gid;
   std::string creation_path = path;
   {
+    eos::common::TraceSpan lookup_span("mgm.open.lookup");
+
     // This is probably one of the hottest code paths in the MGM, we definitely
     // want prefetching here.
     if (!byfid) {
@@ -1215,6 +1222,7 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
           gOFS->MgmStats.Add("RedirectENOENT", vid.uid, vid.gid, 1, vid.app);
           XrdOucString predirectionhost = redirectionhost.c_str();
           eos::common::StringConversion::MaskTag(predirectionhost, "cap.msg");
+          eos::common::StringConversion::MaskTag(predirectionhost, "cap.bin");
           eos::common::StringConversion::MaskTag(predirectionhost, "cap.sym");
           eos::common::StringConversion::MaskTag(pinfo, "authz");
           eos_info("info=\"redirecting\" hostport=%s:%d", predirectionhost.c_str(),
@@ -1235,6 +1243,9 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
     // -------------------------------------------------------------------------
     // ACL and permission check
     // -------------------------------------------------------------------------
+    lookup_span.End();
+    eos::common::TraceSpan acl_span("mgm.open.acl");
+
     if (dotFxid and (not vid.sudoer) and (vid.uid != 0)) {
       /* restricted: this could allow access to a file hidden by the hierarchy */
       eos_debug(".fxid=%d uid %d sudoer %d", dotFxid, vid.uid, vid.sudoer);
@@ -2382,8 +2393,10 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
     }
 
     COMMONTIMING("Scheduler::FilePlacement", &tm);
+    eos::common::TraceSpan placement_span("mgm.open.placement");
     eos::common::RWMutexReadLock fs_rd_lock(FsView::gFsView.ViewMutex);
     retc = Quota::FilePlacement(&plctargs);
+    placement_span.End();
     COMMONTIMING("Scheduler::FilePlaced", &tm);
     Scheduler::ReshuffleFs(selectedfs);
   } else {
@@ -2453,6 +2466,7 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
 
     {
       COMMONTIMING("Scheduler::FileAccess", &tm);
+      eos::common::TraceSpan access_span("mgm.open.access");
       // TODO future: this doesn't really require a FsView readlock!
       eos::common::RWMutexReadLock fs_rd_lock(FsView::gFsView.ViewMutex);
       retc = Scheduler::FileAccess(&acsargs);
@@ -3368,6 +3382,11 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
         redirectionhost += "?";
         eos_info("msg=\"read-through cache redirect\" fxid=%08llx "
                  "cache_fsid=%u backend_fsid=%u", mFid, cache_fsid, fs_id);
+
+        if (gOFS->mCachePrefetcher) {
+          gOFS->mCachePrefetcher->RecordCacheOpen(mFid, cache_fsid);
+        }
+
         const auto previous_cache_fsid = fmd->getCacheLocation();
         const bool need_persist = (previous_cache_fsid != cache_fsid);
         fs_rd_lock.Release();
@@ -3574,6 +3593,7 @@ XrdMgmOfsFile::open(eos::common::VirtualIdentity* invid,
   rcode = SFS_REDIRECT;
   XrdOucString predirectionhost = redirectionhost.c_str();
   eos::common::StringConversion::MaskTag(predirectionhost, "cap.msg");
+  eos::common::StringConversion::MaskTag(predirectionhost, "cap.bin");
   eos::common::StringConversion::MaskTag(predirectionhost, "cap.sym");
 
   const char* op = isRW ? "write" : "read";
@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------
+// File: CacheWarmed.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/Logging.hh"
+#include "common/FileId.hh"
+#include "mgm/stat/Stat.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
+#include "mgm/cache/CachePrefetcher.hh"
+#include "mgm/macros/Macros.hh"
+#include <XrdOuc/XrdOucEnv.hh>
+
+//----------------------------------------------------------------------------
+// Warm-up of a file in the read-through cache done
+//----------------------------------------------------------------------------
+int
+XrdMgmOfs::CacheWarmed(const char* path,
+                       const char* ininfo,
+                       XrdOucEnv& env,
+                       XrdOucErrInfo& error,
+                       eos::common::VirtualIdentity& vid,
+                       const XrdSecEntity* client)
+{
+  static const char* epname = "CacheWarmed";
+  REQUIRE_SSS_OR_LOCAL_AUTH;
+  ACCESSMODE_W;
+  MAYSTALL;
+  const char* inpath = path;
+  MAYREDIRECT;
+  gOFS->MgmStats.Add("CacheWarmed", 0, 0, 1);
+  const char* afid = env.Get("mgm.fid");
+  const char* afsid = env.Get("mgm.cache.fsid");
+
+  if (!afid || !afsid) {
+    return Emsg(epname, error, EINVAL, "cache warmed - missing fid or "
+                "cache fsid [EINVAL]", "");
+  }
+
+  const auto fid = eos::common::FileId::Hex2Fid(afid);
+  const auto cache_fsid = (eos::common::FileSystem::fsid_t)
+                          strtoul(afsid, nullptr, 10);
+
+  if (!mCachePrefetcher) {
+    return Emsg(epname, error, ENOTSUP, "cache warmed - prefetching not "
+                "enabled", afid);
+  }
+
+  const int rc = mCachePrefetcher->WarmupDone(fid, cache_fsid);
+
+  if (rc) {
+    return Emsg(epname, error, rc, "cache warmed - record cache location",
+                afid);
+  }
+
+  const char* ok = "OK";
+  error.setErrInfo(strlen(ok) + 1, ok);
+  return SFS_DATA;
+}
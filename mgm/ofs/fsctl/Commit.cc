@@ -35,10 +35,13 @@
 #include "proto/Audit.pb.h"
 #include "namespace/utils/Checksum.hh"
 #include "mgm/misc/AuditHelpers.hh"
+#include "common/ErrnoToString.hh"
+#include "common/SymKeys.hh"
+#include "common/StringUtils.hh"
+#include "common/BufferManager.hh"
+#include "common/Tracing.hh"
 
 #include <XrdOuc/XrdOucEnv.hh>
-#include <openssl/sha.h>
-
 
 //----------------------------------------------------------------------------
 // Commit a replica
@@ -58,371 +61,42 @@ XrdMgmOfs::Commit(const char* path,
   const char* inpath = path;
   MAYREDIRECT;
   EXEC_TIMING_BEGIN("Commit");
-  // Checksum string
-  char binchecksum[SHA256_DIGEST_LENGTH];
-  // Process CGI parameters
-  CommitHelper::cgi_t cgi;
-  CommitHelper::grab_cgi(env, cgi);
+  eos::common::TraceRequest trace_request("mgm.commit");
+  CommitHelper::request_t req;
+  CommitHelper::init_request(env, error, req);
+  auto& cgi = req.cgi;
 
   // Initialize logging
   if (cgi.count("logid")) {
     tlLogId.SetLogId(cgi["logid"].c_str(), error.getErrUser());
   }
-
-  // OC parameters
-  CommitHelper::param_t params;
-  params["oc_n"] = 0;
-  params["oc_max"] = 0;
-  // Selected options
-  CommitHelper::option_t option;
-  CommitHelper::set_options(option, cgi);
-  // Check 'path' parameter
-  CommitHelper::path_t paths;
-  paths["atomic"] = std::string("");
-
-  if (cgi.count("path")) {
-    paths["commit"] = cgi["path"];
-  }
-
-  // Extract all OC upload relevant parameters
-  CommitHelper::init_oc(env, cgi, option, params);
-
-  if (CommitHelper::is_reconstruction(option)) {
-    // Remove checksum in case of a chunk reconstruction
-    // (they have to be ignored)
-    cgi["checksum"] = "";
-  }
-
-  if (cgi["checksum"].length()) {
-    // Compute binary checksum
-    CommitHelper::hex2bin_checksum(cgi["checksum"], binchecksum);
-  }
+  auto& option = req.option;
 
   // Check all commit required parameters are defined
   if (CommitHelper::check_commit_params(cgi)) {
-    // Convert the main CGI parameters into numbers
-    unsigned long long size = std::stoull(cgi["size"]);
-    unsigned long long fid = strtoull(cgi["fid"].c_str(), 0, 16);
-    unsigned long fsid = std::stoul(cgi["fsid"]);
-    unsigned long mtime = std::stoul(cgi["mtime"]);
-    unsigned long mtimens = std::stoul(cgi["mtimensec"]);
-    std::string emsg;
-    CommitHelper::log_info(vid, tlLogId, cgi, option, params);
-    int rc = CommitHelper::check_filesystem(vid, fsid, cgi, option,
-                                            params, emsg);
+    eos::common::TraceSpan prepare_span("mgm.commit.prepare");
+    int rc = CommitHelper::prepare_commit(req, error, vid);
 
     if (rc) {
-      return Emsg(epname, error, rc, emsg.c_str(), "");
+      return rc;
     }
 
-    // Create a checksum buffer object
-    eos::Buffer checksumbuffer;
-    checksumbuffer.putData(binchecksum, SHA256_DIGEST_LENGTH);
-    // Attempt file meta data retrieval
-    std::shared_ptr<eos::IFileMD> fmd;
-    eos::IContainerMD::id_t cid = 0;
-    std::string fmdname;
+    eos::Prefetcher::prefetchFileMDAndWait(gOFS->eosView, req.fid);
+    prepare_span.End();
     {
-      eos::Prefetcher::prefetchFileMDAndWait(gOFS->eosView, fid);
+      eos::common::TraceSpan apply_span("mgm.commit.apply");
       // Keep the lock order View => Namespace => Quota
       eos::common::RWMutexWriteLock ns_wr_lock(gOFS->eosViewRWMutex);
-      errno = 0;
-
-      try {
-        fmd = gOFS->eosFileService->getFileMD(fid);
-      } catch (eos::MDException& e) {
-        errno = e.getErrno();
-        eos_thread_debug("msg=\"exception\" ec=%d emsg=\"%s\"",
-                         e.getErrno(), e.getMessage().str().c_str());
-        emsg = "retc=";
-        emsg += e.getErrno();
-        emsg += " msg=";
-        emsg += e.getMessage().str().c_str();
-      }
-
-      if (!fmd) {
-        if (errno == ENOENT) {
-          return Emsg(epname, error, ENOENT,
-                      "commit filesize change - file is already removed [EIDRM]", "");
-        }
-
-        emsg.insert(0, "commit filesize change [EIO]");
-        return Emsg(epname, error, errno, emsg.c_str(), cgi["path"].c_str());
-      }
-
-      unsigned long lid = fmd->getLayoutId();
-
-      // Check if fsid and fid are ok
-      if (fmd->getId() != fid) {
-        eos_thread_notice("commit for fxid=%08llx != fmd_fxid=%08llx",
-                          fid, fmd->getId());
-        gOFS->MgmStats.Add("CommitFailedFid", 0, 0, 1);
-        return Emsg(epname, error, EINVAL,
-                    "commit filesize change - file id is wrong [EINVAL]",
-                    cgi["path"].c_str());
-      }
-
-      // Check if file is already unlinked from the visible namespace
-      if (!(cid = fmd->getContainerId())) {
-        eos_thread_debug("commit for fxid=%08llx but file is disconnected "
-                         "from any container", fmd->getId());
-        gOFS->MgmStats.Add("CommitFailedUnlinked", 0, 0, 1);
-        return Emsg(epname, error, EIDRM,
-                    "commit filesize change - file is already removed [EIDRM]", "");
-      }
-
-      // Check if we have this replica in the unlink list or not linked list, if yes, the commit has to be suppressed
-      if (option["fusex"] &&
-          (fmd->hasUnlinkedLocation((unsigned int) fsid) ||
-           (!fmd->hasLocation((unsigned int) fsid)))) {
-        eos_thread_err("suppressing possible recovery replica for fxid=%08llx "
-                       "on unlinked/not linked fsid=%llu - rejecting replica",
-                       fmd->getId(), fsid);
-        // This happens when a FUSEX recovery has been triggered.
-        // To avoid to reattach replicas, we clean them up here
-        return Emsg(epname, error, EBADE,
-                    "commit replica - file size is wrong [EBADE] "
-                    "- suppressing recovery replica", "");
-      }
-
-      // Check if commit comes from a replication procedure
-      // and if the size/checksum is ok
-      if (option["replication"]) {
-        CommitHelper::remove_scheduler(fid);
-
-        if (eos::common::LayoutId::GetLayoutType(lid) ==
-            eos::common::LayoutId::kReplica) {
-          // We check filesize and the checksum only for replica layouts
-          eos_thread_debug("fmd_size=%llu, size=%lli", fmd->getSize(), size);
-
-          // Validate size parameters
-          if (!CommitHelper::validate_size(vid, fmd, fsid, size, option)) {
-            return Emsg(epname, error, EBADE,
-                        "commit replica - file size is wrong [EBADE]", "");
-          }
-
-          // Validate checksum parameters
-          if (option["verifychecksum"] &&
-              !CommitHelper::validate_checksum(vid, fmd, checksumbuffer,
-                                               fsid, option)) {
-            return Emsg(epname, error, EBADR,
-                        "commit replica - file checksum is wrong [EBADR]", "");
-          }
-        }
-      }
-
-      if (option["verifysize"]) {
-        // Check if a file size change was detected
-        if (fmd->getSize() != size) {
-          eos_thread_err("commit for fxid=%08llx gave a file size change after "
-                         "verification on fsid=%llu", fmd->getId(), fsid);
-        }
-      }
-
-      if (option["verifychecksum"]) {
-        CommitHelper::log_verifychecksum(vid, fmd, checksumbuffer, fsid,
-                                         cgi, option);
-      }
-
-      if (!CommitHelper::handle_location(vid, cid, fmd, fsid, size,
-                                         cgi, option)) {
-        return Emsg(epname, error, EIDRM,
-                    "commit file, parent container removed [EIDRM]", "");
-      }
-
-      if (cgi["altxs"].length()) {
-        std::vector<std::string> tkns;
-        std::vector<std::string> name2xs;
-        eos::common::StringConversion::Tokenize(cgi["altxs"], tkns, ",");
-        fmd->clearAltXs();
-
-        for (const auto& tkn : tkns) {
-          name2xs.clear();
-          eos::common::StringConversion::Tokenize(tkn, name2xs, ":");
-
-          if (name2xs.size() != 2) {
-            // the entry is not valid
-            continue;
-          }
-
-          auto checksumType = eos::common::LayoutId::GetChecksumFromString(name2xs[0]);
-          auto xs = name2xs[1];
-          fmd->addAltXs(static_cast<eos::common::LayoutId::eChecksum>
-                        (checksumType), xs.c_str(), xs.size());
-        }
-      }
-
-      if (option["fusex"]) {
-        std::string fusexstate;
-
-        try {
-          fusexstate = fmd->getAttribute("sys.fusex.state");
-        } catch (...) {}
-
-        if (option["update"] || option["replication"]) {
-          fusexstate += "+";
-          fusexstate += std::to_string(fsid);
-        }
-
-        if (eos::common::LayoutId::GetChecksum(lid) != eos::common::LayoutId::kNone) {
-          if (option["commitsize"]) {
-            fusexstate += "s|";
-          }
-        } else {
-          if (option["commitsize"]) {
-            fusexstate += "s";
-          }
-        }
-
-        if (option["commitchecksum"]) {
-          fusexstate += "c|";
-        }
-
-        if (option["verifychecksum"]) {
-          fusexstate += "v|";
-        }
-
-        if (option["verifysize"]) {
-          fusexstate += "V|";
-        }
-
-        fmd->setAttribute("sys.fusex.state", fusexstate);
-      }
-
-      // Advance oc upload parameters if concerned
-      CommitHelper::handle_occhunk(vid, fmd, option, params);
-      // Set checksum if concerned
-      CommitHelper::handle_checksum(vid, fmd, option, checksumbuffer);
-      fmdname = fmd->getName();
-      paths["atomic"].Init(fmdname.c_str());
-      paths["atomic"].DecodeAtomicPath(option["versioning"]);
-      option["atomic"] = (paths["atomic"].GetName() != fmdname);
-
-      if (option["commitverify"]) {
-        // disable atomic and versioning functionality for commits originated by "verify --commitxyz"
-        option["atomic"] = false;
-        option["versioning"] = false;
-      }
-
-      eos::audit::Stat beforeStat;
-      if (option["update"]) {
-        // Capture before state (size and times)
-        eos::mgm::auditutil::buildStatFromFileMD(fmd, beforeStat, /*includeSize=*/true, /*includeChecksum=*/true, /*includeNs=*/true);
-      }
-
-      if (option["update"] && mtime) {
-        // Update the modification time only if the file contents changed and
-        // mtime != 0
-        // - FUSE clients will commit mtime=0 to indicate they call utimes anyway
-        // - OC clients set the mtime during a commit
-        if (!option["atomic"] || option["occhunk"]) {
-          eos::IFileMD::ctime_t mt;
-          mt.tv_sec = mtime;
-          mt.tv_nsec = mtimens;
-          fmd->setMTime(mt);
-        }
-      }
-
-      eos_thread_debug("commit: setting size to %llu", fmd->getSize());
-      eos::ContainerIdentifier p_ident;
-
-      if (!CommitHelper::commit_fmd(vid, cid, fmd, size, option, emsg, p_ident)) {
-        return Emsg(epname, error, errno, "commit filesize change", emsg.c_str());
-      }
-
-      eos::FileIdentifier f_ident = fmd->getIdentifier();
-      eos::ContainerIdentifier c_ident = eos::ContainerIdentifier(
-                                           fmd->getContainerId());
-      ns_wr_lock.Release();
-
-      if (option["update"]) {
-        // broadcast file md
-        gOFS->FuseXCastRefresh(f_ident,
-                               c_ident);
 
-        // Broadcast to the fusex network only if the change has been
-        // triggered outside the fusex client network e.g. xrdcp etc.
-        if (!option["fusex"]) {
-          gOFS->FuseXCastRefresh(c_ident, p_ident);
-        }
-
-        // Emit WRITE audit with before/after size and times
-        if (gOFS->mAudit) {
-          eos::audit::Stat afterStat;
-          eos::mgm::auditutil::buildStatFromFileMD(fmd, afterStat, /*includeSize=*/true, /*includeChecksum=*/true, /*includeNs=*/true);
-          if (gOFS->AllowAuditModification(cgi.count("path") ? cgi["path"] : path)) gOFS->mAudit->audit(eos::audit::WRITE, cgi.count("path") ? cgi["path"] : path,
-                                vid, tlLogId.logId, tlLogId.cident, "mgm",
-                                std::string(), &beforeStat, &afterStat);
-        }
+      if ((rc = CommitHelper::apply_commit_locked(req, error, vid))) {
+        return rc;
       }
     }
-    {
-      eos::common::VirtualIdentity rootvid = eos::common::VirtualIdentity::Root();
-      // Path of a previous version existing before an atomic/versioning upload
-      std::string delete_path = "";
-      eos_thread_info("commitsize=%d n1=%s n2=%s occhunk=%d ocdone=%d",
-                      option["commitsize"],
-                      fmdname.c_str(), paths["atomic"].GetName(),
-                      option["occhunk"], option["ocdone"]);
-
-      // -----------------------------------------------------------------------
-      // We are asked to commit the size and this commit changes the current
-      // atomic name to the final name and we are not an OC upload
-      // -----------------------------------------------------------------------
-      if ((option["commitsize"]) && (fmdname != paths["atomic"].GetName()) &&
-          (!option["occhunk"] || option["ocdone"])) {
-        eos_thread_info("commit: de-atomize file %s => %s",
-                        fmdname.c_str(), paths["atomic"].GetName());
-        unsigned long long vfid =
-          CommitHelper::get_version_fid(vid, fid, paths, option);
-
-        // Check for versioning request
-        if (option["versioning"]) {
-          eos_static_info("checked %s%s vfxid=%08llx",
-                          paths["versiondir"].GetParentPath(),
-                          paths["atomic"].GetPath(), vfid);
-
-          // We purged the versions before during open, so we just simulate
-          // a new one and do the final rename in a transaction
-          if (vfid) {
-            XrdOucString versionedname = "";
-
-            if (gOFS->Version(vfid, error, rootvid, 0xffff, &versionedname, true)) {
-              eos_static_crit("versioning failed %s/%s vfxid=%08lxx",
-                              paths["versiondir"].GetParentPath(),
-                              paths["atomic"].GetPath(), vfid);
-              const char* errmsg = "commit - versioning failed";
-              return Emsg(epname, error, EREMCHG, errmsg, paths["atomic"].GetName());
-            } else {
-              paths["version"].Init(versionedname.c_str());
-            }
-          }
-        }
 
-        CommitHelper::handle_versioning(vid, fid, paths,
-                                        option, delete_path);
-      }
-
-      gOFS->mReplicationTracker->Commit(fmd);
-
-      // -----------------------------------------------------------------------
-      // If there was a previous target file we have to delete the renamed
-      // atomic left-over
-      // -----------------------------------------------------------------------
-      if (delete_path.length()) {
-        delete_path.insert(0, paths["versiondir"].GetParentPath());
-        eos_thread_info("msg=\"delete path\" path=%s", delete_path.c_str());
+    eos::common::TraceSpan finalize_span("mgm.commit.finalize");
 
-        if (gOFS->_rem(delete_path.c_str(), error, rootvid, "")) {
-          eos_thread_err("msg=\"failed to remove atomic left-over\" path=%s",
-                         delete_path.c_str());
-        }
-      }
-
-      if (option["abort"]) {
-        return Emsg(epname, error, EREMCHG, "commit replica - overlapping "
-                    "atomic upload - discarding atomic upload [EREMCHG]", "");
-      }
+    if ((rc = CommitHelper::finalize_commit(req, error, vid, path))) {
+      return rc;
     }
   } else if (CommitHelper::check_altchecksums_commit_params(cgi)) {
     unsigned long long fid{};
@@ -525,3 +199,169 @@ XrdMgmOfs::Commit(const char* path,
   EXEC_TIMING_END("Commit");
   return SFS_DATA;
 }
+
+//----------------------------------------------------------------------------
+// Commit a batch of replicas
+//----------------------------------------------------------------------------
+int
+XrdMgmOfs::CommitBatch(const char* path,
+                       const char* ininfo,
+                       XrdOucEnv& env,
+                       XrdOucErrInfo& error,
+                       eos::common::VirtualIdentity& vid,
+                       const XrdSecEntity* client)
+{
+  static const char* epname = "CommitBatch";
+  REQUIRE_SSS_OR_LOCAL_AUTH;
+  ACCESSMODE_W;
+  MAYSTALL;
+  const char* inpath = path;
+  MAYREDIRECT;
+  EXEC_TIMING_BEGIN("CommitBatch");
+  eos::common::TraceRequest trace_request("mgm.commitbatch");
+  static constexpr unsigned long max_items = 1024ul;
+  unsigned long num_items = 0ul;
+  const char* ptr = env.Get("mgm.commit.n");
+
+  if (!ptr || !eos::common::StringToNumeric(std::string(ptr), num_items) ||
+      (num_items == 0) || (num_items > max_items)) {
+    gOFS->MgmStats.Add("CommitFailedParameters", 0, 0, 1);
+    return Emsg(epname, error, EINVAL, "commit batch - missing or invalid "
+                "number of items [EINVAL]", "");
+  }
+
+  // The response can exceed the 2KB limit of the error object for large
+  // batches. Reserve the buffer before applying anything so that a reply is
+  // guaranteed for every applied item - the FST retries the items missing
+  // from the reply as single commits.
+  // Response format: "n=<num_items> lock_us=<hold_time> <index>:<retc> ..."
+  const size_t max_resp_len = 64 + num_items * 24;
+  XrdOucBuffer* buff = nullptr;
+
+  if (max_resp_len > 2 * eos::common::KB) {
+    const uint32_t aligned_sz = eos::common::GetPowerCeil(max_resp_len,
+                                2 * eos::common::KB);
+    buff = mXrdBuffPool.Alloc(aligned_sz);
+
+    if (buff == nullptr) {
+      eos_thread_err("msg="requested buffer allocation size too big" "
+                     "req_sz=%llu max_sz=%i", max_resp_len,
+                     mXrdBuffPool.MaxSize());
+      return Emsg(epname, error, ENOMEM, "commit batch - allocate response "
+                  "buffer [ENOMEM]", "");
+    }
+  }
+
+  // Per item return code, 0 means success otherwise the errno the FST would
+  // get for the same error from a single commit i.e. derived from the tag in
+  // the error message, see ErrnoFromMsgTag
+  std::vector<int> retcs(num_items, EINVAL);
+  std::vector<CommitHelper::request_t> reqs(num_items);
+  std::vector<bool> valid(num_items, false);
+  eos::Prefetcher prefetcher(gOFS->eosView);
+
+  for (unsigned long i = 0; i < num_items; ++i) {
+    const std::string key = "mgm.commit." + std::to_string(i);
+    std::string item;
+
+    if (!(ptr = env.Get(key.c_str())) ||
+        !eos::common::SymKey::Base64Decode(ptr, item)) {
+      eos_thread_err("msg=\"failed to decode commit batch item\" index=%lu", i);
+      continue;
+    }
+
+    XrdOucEnv item_env(item.c_str());
+    XrdOucErrInfo item_error(error.getErrUser());
+    CommitHelper::init_request(item_env, item_error, reqs[i]);
+
+    // Only regular commits without OC chunking are accepted in a batch, the
+    // rest must use the single commit command
+    if (!CommitHelper::check_commit_params(reqs[i].cgi) ||
+        reqs[i].option["occhunk"]) {
+      eos_thread_err("msg=\"commit batch item not supported\" index=%lu", i);
+      gOFS->MgmStats.Add("CommitFailedParameters", 0, 0, 1);
+      continue;
+    }
+
+    try {
+      retcs[i] = CommitHelper::prepare_commit(reqs[i], item_error, vid);
+    } catch (const std::exception& e) {
+      eos_thread_err("msg=\"invalid commit batch item\" index=%lu", i);
+      continue;
+    }
+
+    if (retcs[i]) {
+      retcs[i] = eos::common::ErrnoFromMsgTag(item_error.getErrText(), ECOMM);
+    } else {
+      valid[i] = true;
+      prefetcher.stageFileMD(reqs[i].fid);
+    }
+  }
+
+  prefetcher.wait();
+  // Apply all the commits with a single namespace lock acquisition
+  uint64_t lock_hold_us = 0ull;
+  {
+    eos::common::TraceSpan apply_span("mgm.commitbatch.apply");
+    const auto lock_start = std::chrono::steady_clock::now();
+    // Keep the lock order View => Namespace => Quota
+    eos::common::RWMutexWriteLock ns_wr_lock(gOFS->eosViewRWMutex);
+
+    for (unsigned long i = 0; i < num_items; ++i) {
+      if (!valid[i]) {
+        continue;
+      }
+
+      XrdOucErrInfo item_error(error.getErrUser());
+      CommitHelper::set_logid(reqs[i], item_error);
+
+      if (CommitHelper::apply_commit_locked(reqs[i], item_error, vid)) {
+        valid[i] = false;
+        retcs[i] = eos::common::ErrnoFromMsgTag(item_error.getErrText(), ECOMM);
+      }
+    }
+
+    ns_wr_lock.Release();
+    lock_hold_us = std::chrono::duration_cast<std::chrono::microseconds>
+                   (std::chrono::steady_clock::now() - lock_start).count();
+  }
+  gOFS->MgmStats.AddExec("CommitBatchLock", lock_hold_us / 1000.0);
+
+  for (unsigned long i = 0; i < num_items; ++i) {
+    if (!valid[i]) {
+      continue;
+    }
+
+    XrdOucErrInfo item_error(error.getErrUser());
+    CommitHelper::set_logid(reqs[i], item_error);
+    retcs[i] = (CommitHelper::finalize_commit(reqs[i], item_error, vid, path) ?
+                eos::common::ErrnoFromMsgTag(item_error.getErrText(), ECOMM) : 0);
+
+    if (retcs[i] == 0) {
+      gOFS->MgmStats.Add("Commit", 0, 0, 1);
+    }
+  }
+
+  std::ostringstream oss;
+  oss << "n=" << num_items << " lock_us=" << lock_hold_us;
+
+  for (unsigned long i = 0; i < num_items; ++i) {
+    oss << " " << i << ":" << retcs[i];
+  }
+
+  const std::string response = oss.str();
+  gOFS->MgmStats.Add("CommitBatch", 0, 0, 1);
+  eos_thread_debug("msg=\"commit batch done\" items=%lu lock_hold_us=%llu",
+                   num_items, lock_hold_us);
+
+  if (buff) {
+    (void) strncpy(buff->Buffer(), response.c_str(), response.length() + 1);
+    buff->SetLen(response.length() + 1);
+    error.setErrInfo(buff->DataLen(), buff);
+  } else {
+    error.setErrInfo(response.length() + 1, response.c_str());
+  }
+
+  EXEC_TIMING_END("CommitBatch");
+  return SFS_DATA;
+}
@@ -31,6 +31,11 @@
 #include "namespace/interface/IQuota.hh"
 #include "namespace/interface/IView.hh"
 #include "namespace/Prefetcher.hh"
+#include "namespace/interface/IFileMDSvc.hh"
+#include "mgm/tracker/ReplicationTracker.hh"
+#include "mgm/misc/AuditHelpers.hh"
+#include "proto/Audit.pb.h"
+#include <openssl/sha.h>
 
 EOSMGMNAMESPACE_BEGIN
 
@@ -870,4 +875,421 @@ CommitHelper::handle_versioning(eos::common::VirtualIdentity& vid,
   // the fuse_batch guard will run broadcasts here
 }
 
+//------------------------------------------------------------------------------
+// Set the thread log id to the one provided by the commit request
+//------------------------------------------------------------------------------
+void
+CommitHelper::set_logid(CommitHelper::request_t& req, XrdOucErrInfo& error)
+{
+  if (req.cgi.count("logid")) {
+    tlLogId.SetLogId(req.cgi["logid"].c_str(), error.getErrUser());
+  }
+}
+
+//------------------------------------------------------------------------------
+// Initialize commit request from the given CGI information
+//------------------------------------------------------------------------------
+void
+CommitHelper::init_request(XrdOucEnv& env, XrdOucErrInfo& error,
+                           CommitHelper::request_t& req)
+{
+  // Checksum string
+  char binchecksum[SHA256_DIGEST_LENGTH] = {0};
+  // Process CGI parameters
+  CommitHelper::grab_cgi(env, req.cgi);
+  // Initialize logging
+  set_logid(req, error);
+  // OC parameters
+  req.params["oc_n"] = 0;
+  req.params["oc_max"] = 0;
+  // Selected options
+  CommitHelper::set_options(req.option, req.cgi);
+  // Check 'path' parameter
+  req.paths["atomic"] = std::string("");
+
+  if (req.cgi.count("path")) {
+    req.paths["commit"] = req.cgi["path"];
+  }
+
+  // Extract all OC upload relevant parameters
+  CommitHelper::init_oc(env, req.cgi, req.option, req.params);
+
+  if (CommitHelper::is_reconstruction(req.option)) {
+    // Remove checksum in case of a chunk reconstruction
+    // (they have to be ignored)
+    req.cgi["checksum"] = "";
+  }
+
+  if (req.cgi["checksum"].length()) {
+    // Compute binary checksum
+    CommitHelper::hex2bin_checksum(req.cgi["checksum"], binchecksum);
+  }
+
+  // Create a checksum buffer object
+  req.checksumbuffer.putData(binchecksum, SHA256_DIGEST_LENGTH);
+}
+
+//------------------------------------------------------------------------------
+// Convert the main parameters and check the target file system, this must be
+// called only for requests passing CommitHelper::check_commit_params
+//------------------------------------------------------------------------------
+int
+CommitHelper::prepare_commit(CommitHelper::request_t& req,
+                             XrdOucErrInfo& error,
+                             eos::common::VirtualIdentity& vid)
+{
+  static const char* epname = "Commit";
+  // Convert the main CGI parameters into numbers
+  req.size = std::stoull(req.cgi["size"]);
+  req.fid = strtoull(req.cgi["fid"].c_str(), 0, 16);
+  req.fsid = std::stoul(req.cgi["fsid"]);
+  req.mtime = std::stoul(req.cgi["mtime"]);
+  req.mtimens = std::stoul(req.cgi["mtimensec"]);
+  std::string emsg;
+  CommitHelper::log_info(vid, tlLogId, req.cgi, req.option, req.params);
+  int rc = CommitHelper::check_filesystem(vid, req.fsid, req.cgi, req.option,
+                                          req.params, emsg);
+
+  if (rc) {
+    return gOFS->Emsg(epname, error, rc, emsg.c_str(), "");
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Apply the commit to the namespace, the caller must hold the namespace
+// write lock
+//------------------------------------------------------------------------------
+int
+CommitHelper::apply_commit_locked(CommitHelper::request_t& req,
+                                  XrdOucErrInfo& error,
+                                  eos::common::VirtualIdentity& vid)
+{
+  static const char* epname = "Commit";
+  auto& cgi = req.cgi;
+  auto& option = req.option;
+  auto& fmd = req.fmd;
+  const unsigned long long fid = req.fid;
+  const unsigned long fsid = req.fsid;
+  const unsigned long long size = req.size;
+  eos::IContainerMD::id_t cid = 0;
+  std::string emsg;
+  errno = 0;
+
+  try {
+    fmd = gOFS->eosFileService->getFileMD(fid);
+  } catch (eos::MDException& e) {
+    errno = e.getErrno();
+    eos_thread_debug("msg=\"exception\" ec=%d emsg=\"%s\"",
+                     e.getErrno(), e.getMessage().str().c_str());
+    emsg = "retc=";
+    emsg += e.getErrno();
+    emsg += " msg=";
+    emsg += e.getMessage().str().c_str();
+  }
+
+  if (!fmd) {
+    if (errno == ENOENT) {
+      return gOFS->Emsg(epname, error, ENOENT,
+                        "commit filesize change - file is already removed [EIDRM]", "");
+    }
+
+    emsg.insert(0, "commit filesize change [EIO]");
+    return gOFS->Emsg(epname, error, errno, emsg.c_str(), cgi["path"].c_str());
+  }
+
+  unsigned long lid = fmd->getLayoutId();
+
+  // Check if fsid and fid are ok
+  if (fmd->getId() != fid) {
+    eos_thread_notice("commit for fxid=%08llx != fmd_fxid=%08llx",
+                      fid, fmd->getId());
+    gOFS->MgmStats.Add("CommitFailedFid", 0, 0, 1);
+    return gOFS->Emsg(epname, error, EINVAL,
+                      "commit filesize change - file id is wrong [EINVAL]",
+                      cgi["path"].c_str());
+  }
+
+  // Check if file is already unlinked from the visible namespace
+  if (!(cid = fmd->getContainerId())) {
+    eos_thread_debug("commit for fxid=%08llx but file is disconnected "
+                     "from any container", fmd->getId());
+    gOFS->MgmStats.Add("CommitFailedUnlinked", 0, 0, 1);
+    return gOFS->Emsg(epname, error, EIDRM,
+                      "commit filesize change - file is already removed [EIDRM]", "");
+  }
+
+  // Check if we have this replica in the unlink list or not linked list, if yes, the commit has to be suppressed
+  if (option["fusex"] &&
+      (fmd->hasUnlinkedLocation((unsigned int) fsid) ||
+       (!fmd->hasLocation((unsigned int) fsid)))) {
+    eos_thread_err("suppressing possible recovery replica for fxid=%08llx "
+                   "on unlinked/not linked fsid=%llu - rejecting replica",
+                   fmd->getId(), fsid);
+    // This happens when a FUSEX recovery has been triggered.
+    // To avoid to reattach replicas, we clean them up here
+    return gOFS->Emsg(epname, error, EBADE,
+                      "commit replica - file size is wrong [EBADE] "
+                      "- suppressing recovery replica", "");
+  }
+
+  // Check if commit comes from a replication procedure
+  // and if the size/checksum is ok
+  if (option["replication"]) {
+    CommitHelper::remove_scheduler(fid);
+
+    if (eos::common::LayoutId::GetLayoutType(lid) ==
+        eos::common::LayoutId::kReplica) {
+      // We check filesize and the checksum only for replica layouts
+      eos_thread_debug("fmd_size=%llu, size=%lli", fmd->getSize(), size);
+
+      // Validate size parameters
+      if (!CommitHelper::validate_size(vid, fmd, fsid, size, option)) {
+        return gOFS->Emsg(epname, error, EBADE,
+                          "commit replica - file size is wrong [EBADE]", "");
+      }
+
+      // Validate checksum parameters
+      if (option["verifychecksum"] &&
+          !CommitHelper::validate_checksum(vid, fmd, req.checksumbuffer,
+                                           fsid, option)) {
+        return gOFS->Emsg(epname, error, EBADR,
+                          "commit replica - file checksum is wrong [EBADR]", "");
+      }
+    }
+  }
+
+  if (option["verifysize"]) {
+    // Check if a file size change was detected
+    if (fmd->getSize() != size) {
+      eos_thread_err("commit for fxid=%08llx gave a file size change after "
+                     "verification on fsid=%llu", fmd->getId(), fsid);
+    }
+  }
+
+  if (option["verifychecksum"]) {
+    CommitHelper::log_verifychecksum(vid, fmd, req.checksumbuffer, fsid,
+                                     cgi, option);
+  }
+
+  if (!CommitHelper::handle_location(vid, cid, fmd, fsid, size,
+                                     cgi, option)) {
+    return gOFS->Emsg(epname, error, EIDRM,
+                      "commit file, parent container removed [EIDRM]", "");
+  }
+
+  if (cgi["altxs"].length()) {
+    std::vector<std::string> tkns;
+    std::vector<std::string> name2xs;
+    eos::common::StringConversion::Tokenize(cgi["altxs"], tkns, ",");
+    fmd->clearAltXs();
+
+    for (const auto& tkn : tkns) {
+      name2xs.clear();
+      eos::common::StringConversion::Tokenize(tkn, name2xs, ":");
+
+      if (name2xs.size() != 2) {
+        // the entry is not valid
+        continue;
+      }
+
+      auto checksumType = eos::common::LayoutId::GetChecksumFromString(name2xs[0]);
+      auto xs = name2xs[1];
+      fmd->addAltXs(static_cast<eos::common::LayoutId::eChecksum>
+                    (checksumType), xs.c_str(), xs.size());
+    }
+  }
+
+  if (option["fusex"]) {
+    std::string fusexstate;
+
+    try {
+      fusexstate = fmd->getAttribute("sys.fusex.state");
+    } catch (...) {}
+
+    if (option["update"] || option["replication"]) {
+      fusexstate += "+";
+      fusexstate += std::to_string(fsid);
+    }
+
+    if (eos::common::LayoutId::GetChecksum(lid) != eos::common::LayoutId::kNone) {
+      if (option["commitsize"]) {
+        fusexstate += "s|";
+      }
+    } else {
+      if (option["commitsize"]) {
+        fusexstate += "s";
+      }
+    }
+
+    if (option["commitchecksum"]) {
+      fusexstate += "c|";
+    }
+
+    if (option["verifychecksum"]) {
+      fusexstate += "v|";
+    }
+
+    if (option["verifysize"]) {
+      fusexstate += "V|";
+    }
+
+    fmd->setAttribute("sys.fusex.state", fusexstate);
+  }
+
+  // Advance oc upload parameters if concerned
+  CommitHelper::handle_occhunk(vid, fmd, option, req.params);
+  // Set checksum if concerned
+  CommitHelper::handle_checksum(vid, fmd, option, req.checksumbuffer);
+  req.fmdname = fmd->getName();
+  req.paths["atomic"].Init(req.fmdname.c_str());
+  req.paths["atomic"].DecodeAtomicPath(option["versioning"]);
+  option["atomic"] = (req.paths["atomic"].GetName() != req.fmdname);
+
+  if (option["commitverify"]) {
+    // disable atomic and versioning functionality for commits originated by "verify --commitxyz"
+    option["atomic"] = false;
+    option["versioning"] = false;
+  }
+
+  if (option["update"]) {
+    // Capture before state (size and times)
+    req.before_stat = std::make_shared<eos::audit::Stat>();
+    eos::mgm::auditutil::buildStatFromFileMD(fmd, *req.before_stat, /*includeSize=*/true, /*includeChecksum=*/true, /*includeNs=*/true);
+  }
+
+  if (option["update"] && req.mtime) {
+    // Update the modification time only if the file contents changed and
+    // mtime != 0
+    // - FUSE clients will commit mtime=0 to indicate they call utimes anyway
+    // - OC clients set the mtime during a commit
+    if (!option["atomic"] || option["occhunk"]) {
+      eos::IFileMD::ctime_t mt;
+      mt.tv_sec = req.mtime;
+      mt.tv_nsec = req.mtimens;
+      fmd->setMTime(mt);
+    }
+  }
+
+  eos_thread_debug("commit: setting size to %llu", fmd->getSize());
+
+  if (!CommitHelper::commit_fmd(vid, cid, fmd, size, option, emsg,
+                                req.p_ident)) {
+    return gOFS->Emsg(epname, error, errno, "commit filesize change",
+                      emsg.c_str());
+  }
+
+  req.f_ident = fmd->getIdentifier();
+  req.c_ident = eos::ContainerIdentifier(fmd->getContainerId());
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Finalize the commit once the namespace lock was released i.e. broadcasts,
+// auditing, versioning and clean up of atomic left-overs
+//------------------------------------------------------------------------------
+int
+CommitHelper::finalize_commit(CommitHelper::request_t& req,
+                              XrdOucErrInfo& error,
+                              eos::common::VirtualIdentity& vid,
+                              const char* path)
+{
+  static const char* epname = "Commit";
+  auto& cgi = req.cgi;
+  auto& option = req.option;
+  auto& paths = req.paths;
+  auto& fmd = req.fmd;
+
+  if (option["update"]) {
+    // broadcast file md
+    gOFS->FuseXCastRefresh(req.f_ident, req.c_ident);
+
+    // Broadcast to the fusex network only if the change has been
+    // triggered outside the fusex client network e.g. xrdcp etc.
+    if (!option["fusex"]) {
+      gOFS->FuseXCastRefresh(req.c_ident, req.p_ident);
+    }
+
+    // Emit WRITE audit with before/after size and times
+    if (gOFS->mAudit) {
+      eos::audit::Stat afterStat;
+      eos::mgm::auditutil::buildStatFromFileMD(fmd, afterStat, /*includeSize=*/true, /*includeChecksum=*/true, /*includeNs=*/true);
+      if (gOFS->AllowAuditModification(cgi.count("path") ? cgi["path"] : path)) gOFS->mAudit->audit(eos::audit::WRITE, cgi.count("path") ? cgi["path"] : path,
+                            vid, tlLogId.logId, tlLogId.cident, "mgm",
+                            std::string(), req.before_stat.get(), &afterStat);
+    }
+  }
+
+  eos::common::VirtualIdentity rootvid = eos::common::VirtualIdentity::Root();
+  // Path of a previous version existing before an atomic/versioning upload
+  std::string delete_path = "";
+  eos_thread_info("commitsize=%d n1=%s n2=%s occhunk=%d ocdone=%d",
+                  option["commitsize"],
+                  req.fmdname.c_str(), paths["atomic"].GetName(),
+                  option["occhunk"], option["ocdone"]);
+
+  // -----------------------------------------------------------------------
+  // We are asked to commit the size and this commit changes the current
+  // atomic name to the final name and we are not an OC upload
+  // -----------------------------------------------------------------------
+  if ((option["commitsize"]) && (req.fmdname != paths["atomic"].GetName()) &&
+      (!option["occhunk"] || option["ocdone"])) {
+    eos_thread_info("commit: de-atomize file %s => %s",
+                    req.fmdname.c_str(), paths["atomic"].GetName());
+    unsigned long long vfid =
+      CommitHelper::get_version_fid(vid, req.fid, paths, option);
+
+    // Check for versioning request
+    if (option["versioning"]) {
+      eos_static_info("checked %s%s vfxid=%08llx",
+                      paths["versiondir"].GetParentPath(),
+                      paths["atomic"].GetPath(), vfid);
+
+      // We purged the versions before during open, so we just simulate
+      // a new one and do the final rename in a transaction
+      if (vfid) {
+        XrdOucString versionedname = "";
+
+        if (gOFS->Version(vfid, error, rootvid, 0xffff, &versionedname, true)) {
+          eos_static_crit("versioning failed %s/%s vfxid=%08lxx",
+                          paths["versiondir"].GetParentPath(),
+                          paths["atomic"].GetPath(), vfid);
+          const char* errmsg = "commit - versioning failed";
+          return gOFS->Emsg(epname, error, EREMCHG, errmsg,
+                            paths["atomic"].GetName());
+        } else {
+          paths["version"].Init(versionedname.c_str());
+        }
+      }
+    }
+
+    CommitHelper::handle_versioning(vid, req.fid, paths,
+                                    option, delete_path);
+  }
+
+  gOFS->mReplicationTracker->Commit(fmd);
+
+  // -----------------------------------------------------------------------
+  // If there was a previous target file we have to delete the renamed
+  // atomic left-over
+  // -----------------------------------------------------------------------
+  if (delete_path.length()) {
+    delete_path.insert(0, paths["versiondir"].GetParentPath());
+    eos_thread_info("msg=\"delete path\" path=%s", delete_path.c_str());
+
+    if (gOFS->_rem(delete_path.c_str(), error, rootvid, "")) {
+      eos_thread_err("msg=\"failed to remove atomic left-over\" path=%s",
+                     delete_path.c_str());
+    }
+  }
+
+  if (option["abort"]) {
+    return gOFS->Emsg(epname, error, EREMCHG, "commit replica - overlapping "
+                      "atomic upload - discarding atomic upload [EREMCHG]", "");
+  }
+
+  return 0;
+}
+
 EOSMGMNAMESPACE_END
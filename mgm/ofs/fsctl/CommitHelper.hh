@@ -34,6 +34,13 @@
 
 #include <XrdOuc/XrdOucEnv.hh>
 
+class XrdOucErrInfo;
+
+namespace eos::audit
+{
+class Stat;
+}
+
 EOSMGMNAMESPACE_BEGIN
 
 class CommitHelper
@@ -46,6 +53,69 @@ public:
   typedef std::map<std::string, int> param_t;
   typedef std::map<std::string, eos::common::Path> path_t;
 
+  //----------------------------------------------------------------------------
+  //! State of a commit request carried between the different processing
+  //! phases so that several requests can be applied under the same namespace
+  //! lock e.g. batched commits
+  //----------------------------------------------------------------------------
+  struct request_t {
+    cgi_t cgi;
+    param_t params;
+    option_t option;
+    path_t paths;
+    eos::Buffer checksumbuffer;
+    unsigned long long size {0ull};
+    unsigned long long fid {0ull};
+    unsigned long fsid {0ul};
+    unsigned long mtime {0ul};
+    unsigned long mtimens {0ul};
+    std::shared_ptr<eos::IFileMD> fmd;
+    std::string fmdname;
+    std::shared_ptr<eos::audit::Stat> before_stat;
+    eos::FileIdentifier f_ident;
+    eos::ContainerIdentifier c_ident;
+    eos::ContainerIdentifier p_ident;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Set the thread log id to the one provided by the commit request
+  //----------------------------------------------------------------------------
+  static void set_logid(request_t& req, XrdOucErrInfo& error);
+
+  //----------------------------------------------------------------------------
+  //! Initialize commit request from the given CGI information
+  //----------------------------------------------------------------------------
+  static void init_request(XrdOucEnv& env, XrdOucErrInfo& error,
+                           request_t& req);
+
+  //----------------------------------------------------------------------------
+  //! Convert the main parameters and check the target file system. Must be
+  //! called only for requests accepted by check_commit_params.
+  //!
+  //! @return 0 if successful, otherwise error code set also in error object
+  //----------------------------------------------------------------------------
+  static int prepare_commit(request_t& req, XrdOucErrInfo& error,
+                            eos::common::VirtualIdentity& vid);
+
+  //----------------------------------------------------------------------------
+  //! Apply the commit to the namespace. The caller must hold the namespace
+  //! write lock and the file metadata should already be prefetched.
+  //!
+  //! @return 0 if successful, otherwise error code set also in error object
+  //----------------------------------------------------------------------------
+  static int apply_commit_locked(request_t& req, XrdOucErrInfo& error,
+                                 eos::common::VirtualIdentity& vid);
+
+  //----------------------------------------------------------------------------
+  //! Finalize the commit once the namespace lock was released i.e. fusex
+  //! broadcasts, auditing, versioning and clean up of atomic left-overs
+  //!
+  //! @return 0 if successful, otherwise error code set also in error object
+  //----------------------------------------------------------------------------
+  static int finalize_commit(request_t& req, XrdOucErrInfo& error,
+                             eos::common::VirtualIdentity& vid,
+                             const char* path);
+
   static void hex2bin_checksum(std::string& checksum, char* binchecksum);
   static int check_filesystem(eos::common::VirtualIdentity& vid,
                               unsigned long fsid,
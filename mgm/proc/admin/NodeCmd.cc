@@ -23,6 +23,7 @@
 
 #include "NodeCmd.hh"
 #include "common/Constants.hh"
+#include "common/ParseUtils.hh"
 #include "mgm/config/IConfigEngine.hh"
 #include "mgm/ofs/XrdMgmOfs.hh"
 #include "mgm/proc/ProcInterface.hh"
@@ -430,6 +431,63 @@ void NodeCmd::ConfigSubcmd(const eos::console::NodeProto_ConfigProto& config,
           reply.set_retc(EFAULT);
         }
       }
+    } else if (config.node_key() == "tracing") {
+      // the value can be 'off' or the sample rate
+      int64_t rate = 0;
+
+      if ((config.node_value() != "off") &&
+          (!eos::common::ParseInt64(config.node_value(), rate) || (rate < 0))) {
+        reply.set_std_err("error: tracing value can be either \"off\" or a "
+                          "positive sample rate");
+        reply.set_retc(EINVAL);
+      } else {
+        if (node->SetConfigMember(config.node_key(), config.node_value(), false)) {
+          reply.set_std_out("success: setting tracing to '" + config.node_value() + "'");
+        } else {
+          reply.set_std_err("error: failed to store tracing config");
+          reply.set_retc(EFAULT);
+        }
+      }
+    } else if (config.node_key() == "resync.nparallel") {
+      // number of threads used per file system by the boot resync
+      int64_t nparallel = 0;
+
+      if (!eos::common::ParseInt64(config.node_value(), nparallel) ||
+          (nparallel < 1) || (nparallel > 64)) {
+        reply.set_std_err("error: resync.nparallel value must be an integer "
+                          "between 1 and 64");
+        reply.set_retc(EINVAL);
+      } else {
+        if (node->SetConfigMember(config.node_key(), config.node_value(), false)) {
+          reply.set_std_out("success: setting resync.nparallel to '" +
+                            config.node_value() + "'");
+        } else {
+          reply.set_std_err("error: failed to store resync.nparallel config");
+          reply.set_retc(EFAULT);
+        }
+      }
+    } else if (config.node_key() == "resync.ioprio") {
+      // the value is <class>:<level> with class idle, be or rt
+      const std::string& val = config.node_value();
+      const size_t pos = val.find(':');
+      int64_t level = 0;
+
+      if ((pos == std::string::npos) ||
+          ((val.substr(0, pos) != "idle") && (val.substr(0, pos) != "be") &&
+           (val.substr(0, pos) != "rt")) ||
+          !eos::common::ParseInt64(val.substr(pos + 1), level) ||
+          (level < 0) || (level > 7)) {
+        reply.set_std_err("error: resync.ioprio value must be "
+                          "<idle|be|rt>:<level> with level between 0 and 7");
+        reply.set_retc(EINVAL);
+      } else {
+        if (node->SetConfigMember(config.node_key(), val, false)) {
+          reply.set_std_out("success: setting resync.ioprio to '" + val + "'");
+        } else {
+          reply.set_std_err("error: failed to store resync.ioprio config");
+          reply.set_retc(EFAULT);
+        }
+      }
     } else if (config.node_key() == eos::common::FST_CBOX_FORBID_RW_SYNC) {
       if ((config.node_value() != "true") && (config.node_value() != "false") &&
           (config.node_value() != "remove")) {
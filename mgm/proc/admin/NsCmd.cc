@@ -29,11 +29,15 @@
 #include "common/ParseUtils.hh"
 #include "common/StringConversion.hh"
 #include "common/StringUtils.hh"
+#include "common/Tracing.hh"
 #include "mgm/config/IConfigEngine.hh"
 #include "mgm/convert/ConverterEngine.hh"
 #include "mgm/fsck/Fsck.hh"
 #include "mgm/fsview/FsView.hh"
 #include "mgm/monitoring/MonitoringConfig.hh"
+#include "mgm/nsscan/NsScanBus.hh"
+#include "mgm/cache/CachePrefetcher.hh"
+#include "mgm/namespacestats/NamespaceSketchStats.hh"
 #include "mgm/ofs/XrdMgmOfs.hh"
 #include "mgm/ofs/XrdMgmOfsFile.hh"
 #include "mgm/quota/Quota.hh"
@@ -586,6 +590,7 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
         << "uid=all gid=all ns.boot.time=" << boot_time << std::endl
         << "uid=all gid=all ns.boot.file.time=" << fboot_time
         << std::endl
+        << gOFS->mBootTimeline.PrintOut(true)
         // Backwards compatibility for callers that still parse the legacy
         // is_master/master_id fields. Keep this for now, but remove it once
         // callers have switched to the structured ns.mgm.* fields.
@@ -677,6 +682,28 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
         << std::endl;
     FsView::gFsView.DumpBalancerPoolInfo(oss, "uid=all gid=all ");
 
+    if (gOFS->mNsScanBus) {
+      oss << gOFS->mNsScanBus->GetStats(true);
+    }
+
+    if (gOFS->mCachePrefetcher) {
+      oss << gOFS->mCachePrefetcher->GetStats(true);
+    }
+
+    if (gOFS->mRecycler) {
+      oss << gOFS->mRecycler->GetPurgeStats(true);
+    }
+
+    if (gOFS->mNsSketchStats) {
+      oss << gOFS->mNsSketchStats->GetStats(true);
+    }
+
+    if (eos::common::Tracer::GetSampleRate() ||
+        eos::common::Tracer::Instance().GetNumSpans()) {
+      oss << eos::common::Tracer::Instance().GetStats("uid=all gid=all ns.trace.",
+          true);
+    }
+
     // Only display the tape enabled state if it is set to true in order to
     // simplify the disk-only use of EOS
     if (gOFS->mTapeEnabled) {
@@ -746,6 +773,7 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
         << "] (" << fboot_time << "s)" << std::endl
         << "ALL      Directories                      " << d << std::endl
         << "ALL      Total boot time                  " << boot_time << " s" << std::endl
+        << gOFS->mBootTimeline.PrintOut(false)
         << "ALL      Contention                       write: " << std::fixed
         << std::setprecision(2) << writecontention << " % read:" << std::fixed
         << std::setprecision(2) << readcontention << " %" << std::endl
@@ -937,6 +965,27 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
                 ? std::to_string(eos::mgm::monitoring::kDefaultPrometheusPort)
                 : monitoring_port)
         << std::endl;
+    if (gOFS->mNsScanBus) {
+      oss << gOFS->mNsScanBus->GetStats(false);
+    }
+
+    if (gOFS->mCachePrefetcher) {
+      oss << gOFS->mCachePrefetcher->GetStats(false);
+    }
+
+    if (gOFS->mRecycler) {
+      oss << gOFS->mRecycler->GetPurgeStats(false);
+    }
+
+    if (gOFS->mNsSketchStats) {
+      oss << gOFS->mNsSketchStats->GetStats(false);
+    }
+
+    if (eos::common::Tracer::GetSampleRate() ||
+        eos::common::Tracer::Instance().GetNumSpans()) {
+      oss << eos::common::Tracer::Instance().GetStats("ALL      trace ", false);
+    }
+
     oss << line << std::endl
         << gOFS->mFidTracker.PrintStats() << std::endl
         << line << std::endl;
@@ -1270,6 +1319,7 @@ NsCmd::QuotaSizeSubcmd(const eos::console::NsProto_QuotaSizeProto& tree,
   // Recompute the quota node
   QuotaNodeCore qnc;
   bool update = false;
+  std::shared_ptr<eos::QuotaRecomputeSession> session;
 
   if (tree.used_bytes() || tree.used_inodes()) {
     QuotaNodeCore::UsageInfo usage;
@@ -1298,25 +1348,60 @@ NsCmd::QuotaSizeSubcmd(const eos::console::NsProto_QuotaSizeProto& tree,
       return;
     }
 
+    QuarkNamespaceGroup* ns_group =
+      static_cast<QuarkNamespaceGroup*>(gOFS->namespaceGroup.get());
     std::unique_ptr<qclient::QClient> qcl =
       std::make_unique<qclient::QClient>(gOFS->mQdbContactDetails.members,
                                          gOFS->mQdbContactDetails.constructOptions());
-    eos::QuotaRecomputer recomputer(qcl.get(),
-                                    static_cast<QuarkNamespaceGroup*>(gOFS->namespaceGroup.get())->getExecutor());
-    eos::MDStatus status = recomputer.recompute(cont_uri, cont_id, qnc);
+    eos::QuotaRecomputer recomputer(qcl.get(), ns_group->getExecutor());
+    bool resumed = false;
 
-    if (!status.ok()) {
-      reply.set_std_err(status.getError());
-      reply.set_retc(status.getErrno());
+    try {
+      // The session records all the updates of the quota node while the tree
+      // is being scanned, so the namespace lock is only needed at the end
+      eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+      auto cont = gOFS->eosDirectoryService->getContainerMD(cont_id);
+      eos::IQuotaNode* quotaNode = gOFS->eosView->getQuotaNode(cont.get());
+
+      if (quotaNode == nullptr) {
+        reply.set_std_err("error: quota node not registered");
+        reply.set_retc(EINVAL);
+        return;
+      }
+
+      session = eos::QuotaRecomputer::openSession(quotaNode, cont_uri, resumed);
+    } catch (const eos::MDException& e) {
+      reply.set_std_err(SSTR(e.what()));
+      reply.set_retc(e.getErrno());
+      return;
+    }
+
+    if (session == nullptr) {
+      reply.set_std_err("error: quota recomputation already running for this "
+                        "quota node");
+      reply.set_retc(EBUSY);
       return;
     }
 
-    // Remove all the entries, which should not be updated if any uid/gid
-    // specified.
-    if (tree.uid().size() || tree.gid().size()) {
-      qnc.filterByUid(strtoul(tree.uid().c_str(), 0, 10));
-      qnc.filterByGid(strtoul(tree.gid().c_str(), 0, 10));
-      update = true;
+    eos::QuotaRecomputer::ParallelOptions opts;
+    opts.nsMutex = &gOFS->eosViewRWMutex;
+    opts.flusher = ns_group->getMetadataFlusher();
+    auto progress = session->getProgress();
+    eos_info("msg=\"quota recomputation started\" cxid=%08llx path=\"%s\" "
+             "resumed=%d ranges=%llu done=%llu", cont_id, cont_uri.c_str(),
+             resumed, (unsigned long long) progress.first,
+             (unsigned long long) progress.second);
+    eos::MDStatus status = recomputer.recomputeParallel(*session, opts);
+
+    if (!status.ok()) {
+      // Keep the session, running the command again resumes it
+      session->release();
+      progress = session->getProgress();
+      reply.set_std_err(SSTR(status.getError() << " - " << progress.second
+                             << "/" << progress.first << " ranges done, run the"
+                             " command again to resume"));
+      reply.set_retc(status.getErrno());
+      return;
     }
   }
 
@@ -1328,6 +1413,11 @@ NsCmd::QuotaSizeSubcmd(const eos::console::NsProto_QuotaSizeProto& tree,
     if ((cont->getFlags() & eos::QUOTA_NODE_FLAG) == 0) {
       eos_err("msg=\"quota recomputation failed, directory is not (anymore) a "
               "quota node\" cxid=%08llx path=\"%s\"", cont_id, cont_uri.c_str());
+
+      if (session) {
+        eos::QuotaRecomputer::closeSession(nullptr, session);
+      }
+
       reply.set_std_err("error: directory is not a quota node (anymore)");
       reply.set_retc(EINVAL);
       return;
@@ -1335,6 +1425,29 @@ NsCmd::QuotaSizeSubcmd(const eos::console::NsProto_QuotaSizeProto& tree,
 
     eos::IQuotaNode* quotaNode = gOFS->eosView->getQuotaNode(cont.get());
 
+    if (session) {
+      // No quota update can happen until the new values are in place
+      size_t approximate = session->finalize(qnc);
+      eos::QuotaRecomputer::closeSession(quotaNode, session);
+
+      if (approximate) {
+        eos_warning("msg=\"quota recomputation raced with updates\" "
+                    "cxid=%08llx path=\"%s\" updates=%llu", cont_id,
+                    cont_uri.c_str(), (unsigned long long) approximate);
+        reply.set_std_err(SSTR("warning: " << approximate << " update(s) "
+                               "raced with the recomputation, the values are "
+                               "approximate"));
+      }
+
+      // Remove all the entries, which should not be updated if any uid/gid
+      // specified.
+      if (tree.uid().size() || tree.gid().size()) {
+        qnc.filterByUid(strtoul(tree.uid().c_str(), 0, 10));
+        qnc.filterByGid(strtoul(tree.gid().c_str(), 0, 10));
+        update = true;
+      }
+    }
+
     if (update) {
       quotaNode->updateCore(qnc);
       eos_info("msg=\"quota update successful\" cxid=%08llx path=\"%s\"",
@@ -1353,6 +1466,11 @@ NsCmd::QuotaSizeSubcmd(const eos::console::NsProto_QuotaSizeProto& tree,
   } catch (const eos::MDException& e) {
     eos_err("msg=\"quota recomputation failed, directory removed\" "
             "cxid=%08llx path=\"%s\"", cont_id, cont_uri.c_str());
+
+    if (session) {
+      eos::QuotaRecomputer::closeSession(nullptr, session);
+    }
+
     reply.set_std_err(SSTR(e.what()));
     reply.set_retc(e.getErrno());
     return;
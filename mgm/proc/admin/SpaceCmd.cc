@@ -23,6 +23,7 @@
 
 #include "SpaceCmd.hh"
 #include "common/Constants.hh"
+#include "common/ParseUtils.hh"
 #include "common/Path.hh"
 #include "common/StringTokenizer.hh"
 #include "common/StringUtils.hh"
@@ -805,6 +806,39 @@ void SpaceCmd::ConfigSubcmd(const eos::console::SpaceProto_ConfigProto& config,
           }
         }
 
+        std_out.str("success: configured " + key + " in space='" + space_name +
+                    "' as '" + value + "'\n");
+        ret_c = 0;
+      }
+    } else if ((key == eos::common::SPACE_CACHE_PREFETCH_NAME) ||
+               (key == eos::common::SPACE_CACHE_PREFETCH_BANDWIDTH_NAME) ||
+               (key == eos::common::SPACE_CACHE_PREFETCH_PATHS_NAME)) {
+      applied = true;
+      int64_t bandwidth = 0;
+
+      if ((key == eos::common::SPACE_CACHE_PREFETCH_NAME) &&
+          (value != "on") && (value != "off")) {
+        ret_c = EINVAL;
+        std_err.str("error: value has to be either on or off");
+      } else if ((key == eos::common::SPACE_CACHE_PREFETCH_BANDWIDTH_NAME) &&
+                 (!eos::common::ParseInt64(value, bandwidth) || (bandwidth < 0))) {
+        ret_c = EINVAL;
+        std_err.str("error: prefetch bandwidth must be a non-negative integer "
+                    "in MB/s");
+      } else if ((key == eos::common::SPACE_CACHE_PREFETCH_PATHS_NAME) &&
+                 ((value == "remove") || value.empty())) {
+        if (!space->DeleteConfigMember(key)) {
+          ret_c = ENOENT;
+          std_err.str("error: key has not been deleted");
+        } else {
+          std_out.str("success: removed prefetch paths from space='" +
+                      space_name + "'\n");
+          ret_c = 0;
+        }
+      } else if (!space->SetConfigMember(key, value)) {
+        std_err.str("error: cannot set space config value");
+        ret_c = EIO;
+      } else {
         std_out.str("success: configured " + key + " in space='" + space_name +
                     "' as '" + value + "'\n");
         ret_c = 0;
@@ -828,9 +862,17 @@ void SpaceCmd::ConfigSubcmd(const eos::console::SpaceProto_ConfigProto& config,
           (key == "balancer.update.interval") || (key == "drainer.tx.minrate") ||
           (key == "drainer.retries") || (key == "drainer.fs.ntx") || (key == "tracker") ||
           (key == "inspector") || (key == "inspector.interval") ||
+          (key == "inspector.scan.partitions") ||
           (key == "inspector.price.disk.tbyear") ||
           (key == "inspector.price.tape.tbyear") || (key == "inspector.price.currency") ||
-          (key == "lru") || (key == "lru.interval") || (key == "wfe") ||
+          (key == "lru") || (key == "lru.interval") || (key == "nsscan") ||
+          (key == "nsscan.interval") || (key == "nsstats") ||
+          (key == "nsstats.sample") || (key == "tracing") ||
+          (key == "tracing.sample") || (key == "recycle.purge.threads") ||
+          (key == "recycle.purge.batch") || (key == "recycle.purge.rate") ||
+          (key == "find.threads") || (key == "ns.hotset.size") ||
+          (key == "ns.hotset.interval") ||
+          (key == "wfe") || (key == "wfe.queue") ||
           (key == "wfe.interval") || (key == "wfe.ntx") || (key == "groupbalancer") ||
           (key == "groupbalancer.ntx") || (key == "groupbalancer.threshold") ||
           (key == "groupbalancer.min_threshold") ||
@@ -862,6 +904,9 @@ void SpaceCmd::ConfigSubcmd(const eos::console::SpaceProto_ConfigProto& config,
             (key == "tracker") ||
             (key == "inspector") ||
             (key == "lru") ||
+            (key == "nsscan") ||
+            (key == "nsstats") ||
+            (key == "tracing") ||
             (key == "groupbalancer") ||
             (key == "geobalancer") ||
             (key == "geo.access.policy.read.exact") ||
@@ -1005,6 +1050,21 @@ void SpaceCmd::ConfigSubcmd(const eos::console::SpaceProto_ConfigProto& config,
                             "success: LRU is disabled");
                 gOFS->mLRUEngine->RefreshOptions();
               }
+
+              if (key == "nsscan") {
+                std_out << ((value == "on") ? "success: ns scan bus is enabled" :
+                            "success: ns scan bus is disabled");
+              }
+
+              if (key == "nsstats") {
+                std_out << ((value == "on") ? "success: ns statistics are enabled" :
+                            "success: ns statistics are disabled");
+              }
+
+              if (key == "tracing") {
+                std_out << ((value == "on") ? "success: tracing is enabled" :
+                            "success: tracing is disabled");
+              }
             }
           }
         } else if (key == eos::mgm::rest::TAPE_REST_API_SWITCH_ON_OFF) {
@@ -1053,6 +1113,19 @@ void SpaceCmd::ConfigSubcmd(const eos::console::SpaceProto_ConfigProto& config,
               std_out << "success: wfe is " << status << "!";
             }
           }
+        } else if (key == "wfe.queue") {
+          applied = true;
+
+          if ((value != "proc") && (value != "qdb")) {
+            ret_c = EINVAL;
+            std_err.str("error: value has to be either proc or qdb");
+          } else if (!space->SetConfigMember(key, value)) {
+            ret_c = EIO;
+            std_err.str("error: cannot set space config value");
+          } else {
+            std_out << "success: wfe jobs are queued in "
+                    << ((value == "qdb") ? "QuarkDB" : "the proc directory") << "!";
+          }
         } else if (value == "remove") {
           applied = true;
 
@@ -24,6 +24,7 @@
 #include "common/Constants.hh"
 #include "common/FileId.hh"
 #include "common/LayoutId.hh"
+#include "common/ParseUtils.hh"
 #include "common/Path.hh"
 #include "common/RegexWrapper.hh"
 #include "common/Timing.hh"
@@ -39,6 +40,7 @@
 #include "namespace/ns_quarkdb/FileMD.hh"
 #include "namespace/ns_quarkdb/NamespaceGroup.hh"
 #include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
 #include "namespace/utils/BalanceCalculator.hh"
 #include "namespace/utils/Checksum.hh"
 #include "namespace/utils/Etag.hh"
@@ -841,6 +843,51 @@ NewfindCmd::PurgeVersions(S& ss, int64_t maxVersion,
 }
 
 
+//------------------------------------------------------------------------------
+// Number of threads exploring the namespace for one find, set by the
+// find.threads variable of the default space, 0 (sequential) by default
+//------------------------------------------------------------------------------
+static size_t GetFindThreads()
+{
+  size_t threads = 0;
+  eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+  auto it = FsView::gFsView.mSpaceView.find("default");
+
+  if (it != FsView::gFsView.mSpaceView.end()) {
+    int64_t value = 0;
+    std::string svalue = it->second->GetConfigMember("find.threads");
+
+    if (!svalue.empty() && common::ParseInt64(svalue, value) && (value >= 0)) {
+      threads = std::min<int64_t>(value, 64);
+    }
+  }
+
+  return threads;
+}
+
+//------------------------------------------------------------------------------
+// Directories found at a given depth below the find path, for --count --du
+//------------------------------------------------------------------------------
+struct DepthSummary {
+  uint64_t ndirectories = 0;
+  uint64_t nfiles = 0;
+  uint64_t treesize = 0;
+};
+
+//------------------------------------------------------------------------------
+// Print the per depth summary
+//------------------------------------------------------------------------------
+template<typename S>   // std::ofstream or std::stringstream
+static void printDepthSummary(S& ss,
+                              const std::map<size_t, DepthSummary>& summary)
+{
+  for (const auto& depth : summary) {
+    ss << "depth=" << depth.first << " nfiles=" << depth.second.nfiles
+       << " ndirectories=" << depth.second.ndirectories
+       << " treesize=" << depth.second.treesize << std::endl;
+  }
+}
+
 //------------------------------------------------------------------------------
 // Filter-out directories which we have no permission to access
 //------------------------------------------------------------------------------
@@ -960,9 +1007,10 @@ public:
   //----------------------------------------------------------------------------
   FindResultProvider(qclient::QClient* qc, const std::string& target,
                      const uint32_t depthlimit, const bool ignore_files,
-                     bool skip_version_dirs, const eos::common::VirtualIdentity& v)
+                     bool skip_version_dirs, const eos::common::VirtualIdentity& v,
+                     size_t threads)
     : qcl(qc), path(target), depthlimit(depthlimit), ignore_files(ignore_files),
-      mSkipVersionDirs(skip_version_dirs), mVid(v)
+      mSkipVersionDirs(skip_version_dirs), mThreads(threads), mVid(v)
   {
     restart();
   }
@@ -979,8 +1027,11 @@ public:
       options.depthLimit = depthlimit;
       options.expansionDecider.reset(new TraversalFilter(mVid, mSkipVersionDirs));
       options.ignoreFiles = ignore_files;
-      explorer.reset(new NamespaceExplorer(path, options, *qcl,
-                                           static_cast<QuarkNamespaceGroup*>(gOFS->namespaceGroup.get())->getExecutor()));
+      ParallelNamespaceExplorer::Options popts;
+      popts.threads = mThreads;
+      explorer.reset(new ParallelNamespaceExplorer(path, options, *qcl,
+                     static_cast<QuarkNamespaceGroup*>(gOFS->namespaceGroup.get())->getExecutor(),
+                     popts));
     }
   }
 
@@ -995,6 +1046,9 @@ public:
 
   ~FindResultProvider()
   {
+    // The exploration threads use mVid
+    explorer.reset();
+
     if (found) {
       found->clear();
     }
@@ -1103,7 +1157,8 @@ private:
   uint32_t depthlimit;
   bool ignore_files;
   bool mSkipVersionDirs;
-  std::unique_ptr<NamespaceExplorer> explorer;
+  size_t mThreads = 0;
+  std::unique_ptr<ParallelNamespaceExplorer> explorer;
   eos::common::VirtualIdentity mVid;
 };
 
@@ -1283,7 +1338,8 @@ NewfindCmd::ProcessRequest() noexcept
     try {
       findResultProvider.reset
       (new FindResultProvider(qcl.get(), real_path, depthlimit, onlydirs,
-                              findRequest.skipversiondirs(), mVid));
+                              findRequest.skipversiondirs(), mVid,
+                              GetFindThreads()));
     } catch (eos::MDException& e) {
       eos_static_info("msg=\"caught newfind exception\" orig_path=\"%s\" "
                       "rpath=\"%s\" errno=%d what=\"%s\"",
@@ -1320,6 +1376,9 @@ NewfindCmd::ProcessRequest() noexcept
   std::shared_ptr<eos::IFileMD> fMD;
 //  EXEC_TIMING_BEGIN("Newfind");
   std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  const bool depth_summary = findRequest.count() && findRequest.du();
+  const size_t base_depth = eos::common::Path(real_path.c_str()).GetSubPathSize();
+  std::map<size_t, DepthSummary> depth_summaries;
 
   while (findResultProvider->next(findResult)) {
     if (limit_result) {
@@ -1390,6 +1449,14 @@ NewfindCmd::ProcessRequest() noexcept
       dircounter++;
       filecounter += findResult.numFiles;
 
+      if (depth_summary) {
+        DepthSummary& summary = depth_summaries[eos::common::Path(
+                                  findResult.path.c_str()).GetSubPathSize() - base_depth];
+        summary.ndirectories++;
+        summary.nfiles += findResult.numFiles;
+        summary.treesize += cMD->getTreeSize();
+      }
+
       if (findRequest.count() || findRequest.treecount()) {
         continue;
       }
@@ -1518,6 +1585,7 @@ NewfindCmd::ProcessRequest() noexcept
   if (findRequest.count()) {
     mOfsOutStream << "nfiles=" << filecounter << " ndirectories=" << dircounter <<
                   std::endl;
+    printDepthSummary(mOfsOutStream, depth_summaries);
   }
 
   if (findRequest.balance()) {
@@ -1670,7 +1738,8 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
     try {
       findResultProvider.reset
       (new FindResultProvider(qcl.get(), real_path, depthlimit, onlydirs,
-                              findRequest.skipversiondirs(), mVid));
+                              findRequest.skipversiondirs(), mVid,
+                              GetFindThreads()));
     } catch (eos::MDException& e) {
       eos_static_info("msg=\"caught newfind exception\" orig_path=\"%s\" "
                       "rpath=\"%s\" errno=%d what=\"%s\"",
@@ -1711,6 +1780,12 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
   std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
   std::string output_str("");
   int counter = 0;
+  // Last entry handled and last entry delivered to the client
+  std::string last_path;
+  std::string written_path;
+  const bool depth_summary = findRequest.count() && findRequest.du();
+  const size_t base_depth = eos::common::Path(real_path.c_str()).GetSubPathSize();
+  std::map<size_t, DepthSummary> depth_summaries;
 
   while (findResultProvider->next(findResult)) {
     if (limit_result) {
@@ -1725,6 +1800,8 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
       }
     }
 
+    last_path = findResult.path;
+
     std::ostringstream output;
 
     if (findResult.isdir) {
@@ -1772,6 +1849,14 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
       dircounter++;
       filecounter += findResult.numFiles;
 
+      if (depth_summary) {
+        DepthSummary& summary = depth_summaries[eos::common::Path(
+                                  findResult.path.c_str()).GetSubPathSize() - base_depth];
+        summary.ndirectories++;
+        summary.nfiles += findResult.numFiles;
+        summary.treesize += cMD->getTreeSize();
+      }
+
       if (findRequest.count() || findRequest.treecount()) {
         continue;
       }
@@ -1891,7 +1976,17 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
       StreamReply.set_std_out(output_str);
       StreamReply.set_std_err("");
       StreamReply.set_retc(0);
-      writer->Write(StreamReply);
+
+      if (!writer->Write(StreamReply)) {
+        // The client is gone, no point in exploring any further
+        eos_static_info("msg=\"find client disconnected\" path=\"%s\" "
+                        "last_path=\"%s\"", findRequest.path().c_str(),
+                        written_path.c_str());
+        output_str.clear();
+        break;
+      }
+
+      written_path = last_path;
       counter = 0;
       output_str.clear();
     }
@@ -1923,9 +2018,11 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
   }
 
   if (findRequest.count()) {
-    StreamReply.set_std_out(
-      "nfiles=" + std::to_string(filecounter) + " ndirectories=" + std::to_string(
-        dircounter) + "\n");
+    std::ostringstream output;
+    output << "nfiles=" << filecounter << " ndirectories=" << dircounter
+           << std::endl;
+    printDepthSummary(output, depth_summaries);
+    StreamReply.set_std_out(output.str());
     StreamReply.set_std_err("");
     StreamReply.set_retc(0);
     writer->Write(StreamReply);
@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+//! @file BootTimeline.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/qdbmaster/BootTimeline.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
+#include "mgm/fsview/FsView.hh"
+#include "mgm/imaster/IMaster.hh"
+#include "common/Logging.hh"
+#include "common/ParseUtils.hh"
+#include "namespace/interface/IContainerMDSvc.hh"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+EOSMGMNAMESPACE_BEGIN
+
+constexpr uint64_t NsCacheWarmer::sDefaultHotSetSize;
+constexpr uint64_t NsCacheWarmer::sDefaultSaveIntervalSec;
+constexpr uint64_t NsCacheWarmer::sMaxInFlight;
+
+//------------------------------------------------------------------------------
+// Record a phase
+//------------------------------------------------------------------------------
+void
+BootTimeline::Record(const std::string& phase,
+                     std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end)
+{
+  using namespace std::chrono;
+  Phase entry;
+  entry.mName = phase;
+  entry.mStartMs = (start > mBase) ?
+                   duration_cast<milliseconds>(start - mBase).count() : 0;
+  entry.mDurationMs = duration_cast<milliseconds>(end - start).count();
+  std::lock_guard<std::mutex> lock(mMutex);
+  mPhases.erase(std::remove_if(mPhases.begin(), mPhases.end(),
+  [&phase](const Phase & elem) {
+    return elem.mName == phase;
+  }), mPhases.end());
+  auto pos = std::upper_bound(mPhases.begin(), mPhases.end(), entry,
+  [](const Phase & lhs, const Phase & rhs) {
+    return lhs.mStartMs < rhs.mStartMs;
+  });
+  mPhases.insert(pos, entry);
+}
+
+//------------------------------------------------------------------------------
+// Cache warm-up progress accounting
+//------------------------------------------------------------------------------
+void
+BootTimeline::WarmUpStarted(uint64_t total)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mWarmUpState = "running";
+  mWarmUpTotal = total;
+  mWarmUpLoaded = 0;
+  mWarmUpFailed = 0;
+}
+
+void
+BootTimeline::WarmUpProgress(uint64_t loaded, uint64_t failed)
+{
+  mWarmUpLoaded += loaded;
+  mWarmUpFailed += failed;
+}
+
+void
+BootTimeline::WarmUpDone()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mWarmUpState = "done";
+}
+
+//------------------------------------------------------------------------------
+// Print the timeline in ns stat format
+//------------------------------------------------------------------------------
+std::string
+BootTimeline::PrintOut(bool monitoring) const
+{
+  std::ostringstream oss;
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  for (const auto& phase : mPhases) {
+    if (monitoring) {
+      oss << "uid=all gid=all ns.boot.phase." << phase.mName << ".start_ms="
+          << phase.mStartMs << std::endl
+          << "uid=all gid=all ns.boot.phase." << phase.mName << ".duration_ms="
+          << phase.mDurationMs << std::endl;
+    } else {
+      std::string label = "Boot phase " + phase.mName;
+      label.resize(std::max<size_t>(label.length() + 1, 33), ' ');
+      oss << "ALL      " << label << phase.mDurationMs << " ms (started at +"
+          << std::fixed << std::setprecision(1) << phase.mStartMs / 1000.0
+          << " s)" << std::endl;
+    }
+  }
+
+  if (monitoring) {
+    oss << "uid=all gid=all ns.boot.warmup.status=" << mWarmUpState << std::endl
+        << "uid=all gid=all ns.boot.warmup.total=" << mWarmUpTotal << std::endl
+        << "uid=all gid=all ns.boot.warmup.loaded=" << mWarmUpLoaded << std::endl
+        << "uid=all gid=all ns.boot.warmup.failed=" << mWarmUpFailed << std::endl;
+  } else {
+    oss << "ALL      Cache warm-up                    " << mWarmUpState
+        << " loaded=" << mWarmUpLoaded << "/" << mWarmUpTotal
+        << " failed=" << mWarmUpFailed << std::endl;
+  }
+
+  return oss.str();
+}
+
+//------------------------------------------------------------------------------
+// Start the warm-up and periodic save thread
+//------------------------------------------------------------------------------
+void
+NsCacheWarmer::Start()
+{
+  mThread.reset(&NsCacheWarmer::Run, this);
+  mThread.setName("NsCacheWarmer");
+}
+
+//------------------------------------------------------------------------------
+// Stop the thread
+//------------------------------------------------------------------------------
+void
+NsCacheWarmer::Stop()
+{
+  mThread.join();
+}
+
+//------------------------------------------------------------------------------
+// Get a numeric hot set option of the default space
+//------------------------------------------------------------------------------
+uint64_t
+NsCacheWarmer::GetOption(const std::string& key, uint64_t default_val)
+{
+  eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+  auto it = FsView::gFsView.mSpaceView.find("default");
+
+  if (it == FsView::gFsView.mSpaceView.end()) {
+    return default_val;
+  }
+
+  int64_t value = 0;
+  std::string svalue = it->second->GetConfigMember(key);
+
+  if (!svalue.empty() && common::ParseInt64(svalue, value) && (value >= 0)) {
+    return value;
+  }
+
+  return default_val;
+}
+
+//------------------------------------------------------------------------------
+// Save the hot containers if we are the master
+//------------------------------------------------------------------------------
+uint64_t
+NsCacheWarmer::SaveHotSet()
+{
+  if (!gOFS->mMaster || !gOFS->mMaster->IsMaster() ||
+      (gOFS->mNamespaceState != NamespaceState::kBooted)) {
+    return 0;
+  }
+
+  const uint64_t max_num = GetOption("ns.hotset.size", sDefaultHotSetSize);
+
+  if (max_num == 0) {
+    return 0;
+  }
+
+  try {
+    uint64_t saved = gOFS->eosDirectoryService->saveHotSet(max_num);
+    eos_static_info("msg=\"saved hot containers\" count=%llu",
+                    (unsigned long long) saved);
+    return saved;
+  } catch (const eos::MDException& e) {
+    eos_static_err("msg=\"failed to save hot containers\" errc=%d reason=\"%s\"",
+                   e.getErrno(), e.getMessage().str().c_str());
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Fetch the saved hot containers into the cache
+//------------------------------------------------------------------------------
+void
+NsCacheWarmer::WarmUp(ThreadAssistant& assistant)
+{
+  BootTimeline::Timer timer(mTimeline, "warmup");
+  std::vector<IContainerMD::id_t> ids;
+
+  try {
+    ids = gOFS->eosDirectoryService->loadHotSet();
+  } catch (const std::exception& e) {
+    eos_static_err("msg=\"failed to load hot containers\" reason=\"%s\"",
+                   e.what());
+  }
+
+  // Loading more than the cache can hold would evict the hottest ones
+  const uint64_t cache_max =
+    gOFS->eosDirectoryService->getCacheStatistics().maxNum;
+
+  if (cache_max && (ids.size() > cache_max)) {
+    ids.resize(cache_max);
+  }
+
+  mTimeline.WarmUpStarted(ids.size());
+  eos_static_info("msg=\"cache warm-up started\" containers=%llu",
+                  (unsigned long long) ids.size());
+
+  for (size_t pos = 0; (pos < ids.size()) &&
+       !assistant.terminationRequested(); pos += sMaxInFlight) {
+    const size_t end = std::min<size_t>(ids.size(), pos + sMaxInFlight);
+    std::vector<folly::Future<IContainerMDPtr>> futs;
+    futs.reserve(end - pos);
+
+    for (size_t i = pos; i < end; ++i) {
+      futs.emplace_back(gOFS->eosDirectoryService->getContainerMDFut(ids[i]));
+    }
+
+    uint64_t failed = 0;
+
+    for (auto& fut : futs) {
+      try {
+        std::move(fut).get();
+      } catch (const eos::MDException& e) {
+        // Container deleted since the hot set was saved
+        ++failed;
+      }
+    }
+
+    mTimeline.WarmUpProgress(futs.size() - failed, failed);
+  }
+
+  mTimeline.WarmUpDone();
+  eos_static_info("%s", "msg=\"cache warm-up done\"");
+}
+
+//------------------------------------------------------------------------------
+// Thread loop warming up the cache and then saving periodically
+//------------------------------------------------------------------------------
+void
+NsCacheWarmer::Run(ThreadAssistant& assistant) noexcept
+{
+  WarmUp(assistant);
+
+  while (!assistant.terminationRequested()) {
+    uint64_t interval = GetOption("ns.hotset.interval", sDefaultSaveIntervalSec);
+    // An interval of 0 disables the periodic save, check again later
+    assistant.wait_for(std::chrono::seconds(interval ? interval :
+                                            sDefaultSaveIntervalSec));
+
+    if (assistant.terminationRequested() || (interval == 0)) {
+      continue;
+    }
+
+    SaveHotSet();
+  }
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,181 @@
+//------------------------------------------------------------------------------
+//! @file BootTimeline.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Per phase timeline of the namespace boot and master transition,
+//!        and cache warm-up from the persisted hot set
+//------------------------------------------------------------------------------
+#pragma once
+#include "mgm/Namespace.hh"
+#include "common/AssistedThread.hh"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class BootTimeline - records when every boot phase started and how long
+//! it took. Phases may run concurrently, so the timeline shows both the start
+//! offset and the duration of each of them.
+//------------------------------------------------------------------------------
+class BootTimeline
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Scoped timer recording a phase when going out of scope
+  //----------------------------------------------------------------------------
+  class Timer
+  {
+  public:
+    Timer(BootTimeline& timeline, const std::string& phase):
+      mTimeline(timeline), mPhase(phase),
+      mStart(std::chrono::steady_clock::now())
+    {}
+
+    ~Timer()
+    {
+      mTimeline.Record(mPhase, mStart, std::chrono::steady_clock::now());
+    }
+
+  private:
+    BootTimeline& mTimeline;
+    std::string mPhase;
+    std::chrono::steady_clock::time_point mStart;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor - offsets are relative to the construction time
+  //----------------------------------------------------------------------------
+  BootTimeline():
+    mBase(std::chrono::steady_clock::now())
+  {}
+
+  //----------------------------------------------------------------------------
+  //! Record a phase, replacing any previous one with the same name
+  //----------------------------------------------------------------------------
+  void Record(const std::string& phase,
+              std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point end);
+
+  //----------------------------------------------------------------------------
+  //! Cache warm-up progress accounting
+  //----------------------------------------------------------------------------
+  void WarmUpStarted(uint64_t total);
+  void WarmUpProgress(uint64_t loaded, uint64_t failed);
+  void WarmUpDone();
+
+  //----------------------------------------------------------------------------
+  //! Print the timeline in ns stat format
+  //!
+  //! @param monitoring if true print key=value pairs
+  //----------------------------------------------------------------------------
+  std::string PrintOut(bool monitoring) const;
+
+private:
+  struct Phase {
+    std::string mName;
+    uint64_t mStartMs; ///< Start offset from mBase
+    uint64_t mDurationMs;
+  };
+
+  std::chrono::steady_clock::time_point mBase;
+  mutable std::mutex mMutex;
+  std::vector<Phase> mPhases; ///< Phases in the order they started
+  //! Warm-up state: "none", "running" or "done"
+  std::string mWarmUpState {"none"};
+  std::atomic<uint64_t> mWarmUpTotal {0};
+  std::atomic<uint64_t> mWarmUpLoaded {0};
+  std::atomic<uint64_t> mWarmUpFailed {0};
+};
+
+//------------------------------------------------------------------------------
+//! Class NsCacheWarmer - loads into the metadata cache the hot containers
+//! saved by the previous master, in the background, and periodically saves
+//! the hot containers of the current master for the next one.
+//------------------------------------------------------------------------------
+class NsCacheWarmer
+{
+public:
+  //! Default number of hot containers to save, space ns.hotset.size
+  static constexpr uint64_t sDefaultHotSetSize = 100000;
+  //! Default interval between saves, space ns.hotset.interval
+  static constexpr uint64_t sDefaultSaveIntervalSec = 600;
+  //! Maximum number of containers fetched concurrently during warm-up
+  static constexpr uint64_t sMaxInFlight = 512;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  NsCacheWarmer(BootTimeline& timeline):
+    mTimeline(timeline)
+  {}
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~NsCacheWarmer()
+  {
+    Stop();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Start the warm-up and periodic save thread, the namespace must be booted
+  //----------------------------------------------------------------------------
+  void Start();
+
+  //----------------------------------------------------------------------------
+  //! Stop the thread, must be called before the namespace is finalized
+  //----------------------------------------------------------------------------
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  //! Save the hot containers if we are the master
+  //!
+  //! @return number of containers saved
+  //----------------------------------------------------------------------------
+  uint64_t SaveHotSet();
+
+private:
+  //----------------------------------------------------------------------------
+  //! Thread loop warming up the cache and then saving periodically
+  //----------------------------------------------------------------------------
+  void Run(ThreadAssistant& assistant) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Fetch the saved hot containers into the cache
+  //----------------------------------------------------------------------------
+  void WarmUp(ThreadAssistant& assistant);
+
+  //----------------------------------------------------------------------------
+  //! Get a numeric hot set option of the default space
+  //----------------------------------------------------------------------------
+  static uint64_t GetOption(const std::string& key, uint64_t default_val);
+
+  BootTimeline& mTimeline;
+  AssistedThread mThread;
+};
+
+EOSMGMNAMESPACE_END
@@ -46,6 +46,7 @@
 #include "common/IntervalStopwatch.hh"
 #include <qclient/QClient.hh>
 #include "common/ShellCmd.hh"
+#include <future>
 
 EOSMGMNAMESPACE_BEGIN
 
@@ -117,9 +118,14 @@ QdbMaster::BootNamespace()
   }
 
   FillNsCacheConfig(gOFS->mConfigEngine, namespaceConfig);
+  bool ns_group_ok;
+  {
+    BootTimeline::Timer timer(gOFS->mBootTimeline, "nsgroup");
+    ns_group_ok = gOFS->namespaceGroup->initialize(&gOFS->eosViewRWMutex,
+                  namespaceConfig, err, &gOFS->mNamespaceStats);
+  }
 
-  if (!gOFS->namespaceGroup->initialize(&gOFS->eosViewRWMutex, namespaceConfig,
-                                        err, &gOFS->mNamespaceStats)) {
+  if (!ns_group_ok) {
     eos_err("msg=\"could not initialize namespace group, err: %s\"", err.c_str());
     return false;
   }
@@ -144,19 +150,40 @@ QdbMaster::BootNamespace()
   }
 
   time_t tstart = time(nullptr);
+  // Loading the file system view and initializing the container and file
+  // services only depend on the backend, they run concurrently. The futures
+  // block in their destructor so every path out of here waits for them.
+  std::future<void> fsview_load;
+  std::future<void> files_init;
 
   try {
     gOFS->eosDirectoryService->configure(namespaceConfig);
     gOFS->eosFileService->configure(namespaceConfig);
-    gOFS->eosFsView->configure(namespaceConfig);
+    fsview_load = std::async(std::launch::async, [&namespaceConfig]() {
+      BootTimeline::Timer timer(gOFS->mBootTimeline, "fsview");
+      gOFS->eosFsView->configure(namespaceConfig);
+    });
     gOFS->eosView->configure(namespaceConfig);
     gOFS->eosFileService->setQuotaStats(gOFS->eosView->getQuotaStats());
     gOFS->eosDirectoryService->setQuotaStats(gOFS->eosView->getQuotaStats());
     gOFS->eosView->getQuotaStats()->registerSizeMapper(Quota::MapSizeCB);
-    gOFS->eosView->initialize1();
+    // Initialize the file view
+    gOFS->mFileInitTime = time(nullptr);
+    MasterLog(eos_log(LOG_NOTICE, "%s",
+                      "msg=\"eos file view initialize2 starting ...\""));
+    files_init = std::async(std::launch::async, []() {
+      BootTimeline::Timer timer(gOFS->mBootTimeline, "files");
+      eos::common::RWMutexWriteLock wr_view_lock(gOFS->eosViewRWMutex);
+      gOFS->eosView->initialize2();
+    });
+    {
+      BootTimeline::Timer timer(gOFS->mBootTimeline, "containers");
+      gOFS->eosView->initialize1();
+    }
     gOFS->mBootContainerId = gOFS->eosDirectoryService->getFirstFreeId();
     MasterLog(eos_log(LOG_NOTICE, "msg=\"container initialization done\" "
                       "duration=%ds", (time(nullptr) - tstart)));
+    fsview_load.get();
   } catch (eos::MDException& e) {
     MasterLog(eos_log(LOG_NOTICE, "msg=\"container initialization failed\" "
                       "duration=%ds errc=%d  reason=\"%s\"",
@@ -172,14 +199,8 @@ QdbMaster::BootNamespace()
     return false;
   }
 
-  // Initialize the file view
-  gOFS->mFileInitTime = time(nullptr);
-
   try {
-    MasterLog(eos_log(LOG_NOTICE, "%s",
-                      "msg=\"eos file view initialize2 starting ...\""));
-    eos::common::RWMutexWriteLock wr_view_lock(gOFS->eosViewRWMutex);
-    gOFS->eosView->initialize2();
+    files_init.get();
     MasterLog(eos_log(LOG_NOTICE, "msg=\"file view initialize2 done\" duration=%ds",
                       time(nullptr) - gOFS->mFileInitTime));
     gOFS->mBootFileId = gOFS->eosFileService->getFirstFreeId();
@@ -196,6 +217,9 @@ QdbMaster::BootNamespace()
   gOFS->mTotalInitTime = time(nullptr) - gOFS->mTotalInitTime;
   gOFS->mNamespaceState = NamespaceState::kBooted;
   MasterLog(eos_log(LOG_ALERT, "%s", "msg=\"QDB namespace booted\""));
+  // Requests are served while the cache is warmed up in the background
+  gOFS->mNsCacheWarmer.reset(new NsCacheWarmer(gOFS->mBootTimeline));
+  gOFS->mNsCacheWarmer->Start();
 
   // Get process status after boot
   if (!eos::common::LinuxStat::GetStat(gOFS->LinuxStatsStartup)) {
@@ -406,20 +430,36 @@ QdbMaster::SlaveToMaster()
   gOFS->mTracker.SetAcceptingRequests(false);
   gOFS->mTracker.SpinUntilNoRequestsInFlight(true,
       std::chrono::milliseconds(100));
-  // Force refresh the inode provider to get the latest inode values from QDB
-  gOFS->eosFileService->configure({{constants::sKeyInodeRefresh, "true"}});
-  gOFS->eosFileService->initialize();
-  gOFS->eosDirectoryService->initialize();
+  {
+    BootTimeline::Timer timer(gOFS->mBootTimeline, "master.refresh");
+    // Force refresh the inode provider to get the latest inode values from QDB
+    gOFS->eosFileService->configure({{constants::sKeyInodeRefresh, "true"}});
+    // The file and container services refresh independently
+    auto files_init = std::async(std::launch::async, []() {
+      gOFS->eosFileService->initialize();
+    });
+    gOFS->eosDirectoryService->initialize();
+    files_init.get();
+  }
   std::string std_out, std_err;
   // We are the master and we broadcast every configuration change
   gOFS->mMessagingRealm->EnableBroadcast();
+  bool config_ok;
+  {
+    BootTimeline::Timer timer(gOFS->mBootTimeline, "master.config");
+    config_ok = ApplyMasterConfig(std_out, std_err, true);
+  }
 
-  if (!ApplyMasterConfig(std_out, std_err, true)) {
+  if (!config_ok) {
     eos_err("%s", "msg=\"failed to apply master configuration\"");
     std::abort();
   }
 
-  Quota::LoadNodes();
+  {
+    BootTimeline::Timer timer(gOFS->mBootTimeline, "master.quota");
+    Quota::LoadNodes();
+  }
+
   EnableNsCaching();
   WFE::MoveFromRBackToQ();
   // Notify all the nodes about the new master identity
@@ -25,6 +25,7 @@
 #include "mgm/policy/Policy.hh"
 #include "mgm/ofs/XrdMgmOfs.hh"
 #include "common/StringUtils.hh"
+#include "common/Tracing.hh"
 #include "common/table_formatter/TableFormatterBase.hh"
 #include "namespace/interface/IView.hh"
 #include "namespace/ns_quarkdb/NamespaceGroup.hh"
@@ -1868,14 +1869,22 @@ Quota::LoadNodes()
   // Load all known nodes
   {
     std::string quota_path;
-    std::shared_ptr<eos::IContainerMD> container;
     eos::common::RWMutexReadLock rd_ns_lock(gOFS->eosViewRWMutex);
     auto set_ids = gOFS->eosView->getQuotaStats()->getAllIds();
+    // Resolve the paths of all the quota nodes concurrently
+    std::vector<std::pair<eos::IContainerMD::id_t, folly::Future<std::string>>>
+        uris;
 
     for (const auto elem : set_ids) {
+      uris.emplace_back(elem, gOFS->eosView->getUriFut(
+                          eos::ContainerIdentifier(elem)));
+    }
+
+    for (auto& uri : uris) {
+      const eos::IContainerMD::id_t elem = uri.first;
+
       try {
-        container = gOFS->eosDirectoryService->getContainerMD(elem);
-        quota_path = gOFS->eosView->getUri(container.get());
+        quota_path = std::move(uri.second).get();
 
         // Make sure directories are '/' terminated
         if (quota_path.back() != '/') {
@@ -2065,6 +2074,8 @@ Quota::FilePlacement(Scheduler::PlacementArguments* args)
     return ENOSPC;
   }
 
+  eos::common::TraceSpan quota_span("mgm.quota.check");
+
   // Check if quota enabled for current space
   if (FsView::gFsView.IsQuotaEnabled(*args->spacename)) {
     eos::common::RWMutexReadLock rd_quota_lock(pMapMutex);
@@ -2086,7 +2097,8 @@ Quota::FilePlacement(Scheduler::PlacementArguments* args)
   }
 
   eos_static_debug("%s", "nominal quota ok");
-
+  quota_span.End();
+  eos::common::TraceSpan scheduler_span("mgm.scheduler.placement");
   // Call the scheduler implementation
   return Scheduler::FilePlacement(args);
 }
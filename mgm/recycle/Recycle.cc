@@ -228,37 +228,45 @@ Recycle::RemoveEntries()
     current_slot = 0;
   }
 
+  // Subtrees are purged in parallel in rounds, the limits being checked
+  // before each round
+  const size_t round_size = std::max<size_t>(10,
+                            RecyclePurger::GetOptions().threads);
   auto it = mPendingDeletions.begin();
-  uint64_t count = 0;
 
   while (it != mPendingDeletions.end()) {
     // Keep ratio and watermarks already respected
-    if ((count % 10 == 0) && mPolicy.IsWithinLimits()) {
+    if (mPolicy.IsWithinLimits()) {
       break;
     }
 
-    ++count;
-    // Decide if the current directory should be handled at this moment -
-    // try to spread out the deletions throughout the day!
-    eos::IContainerMD::id_t cid = it->first;
+    std::vector<std::string> subtrees;
 
-    if (cid % total_slots != current_slot) {
-      eos_static_debug("msg=\"recycle skip directory removal\" cxid=%08llx"
-                       " current_slot=%i slots=%i", cid, current_slot,
-                       total_slots);
-      ++it;
-      continue;
-    }
+    while ((it != mPendingDeletions.end()) && (subtrees.size() < round_size)) {
+      // Decide if the current directory should be handled at this moment -
+      // try to spread out the deletions throughout the day!
+      eos::IContainerMD::id_t cid = it->first;
 
-    if (mPolicy.mDryRun) {
-      eos_static_info("msg=\"recycle skip removing entries in dry-run\" "
-                      "cxid=%08llx", cid);
-      ++it;
-    } else {
-      // Handle deletion
-      RemoveSubtree(it->second);
-      it = mPendingDeletions.erase(it);
+      if (cid % total_slots != current_slot) {
+        eos_static_debug("msg=\"recycle skip directory removal\" cxid=%08llx"
+                         " current_slot=%i slots=%i", cid, current_slot,
+                         total_slots);
+        ++it;
+        continue;
+      }
+
+      if (mPolicy.mDryRun) {
+        eos_static_info("msg=\"recycle skip removing entries in dry-run\" "
+                        "cxid=%08llx", cid);
+        ++it;
+      } else {
+        subtrees.push_back(it->second);
+        it = mPendingDeletions.erase(it);
+      }
     }
+
+    // Handle deletion
+    mPurger.Purge(subtrees);
   }
 }
 
@@ -268,71 +276,7 @@ Recycle::RemoveEntries()
 void
 Recycle::RemoveSubtree(std::string_view dpath)
 {
-  std::map<std::string, std::set<std::string> > found;
-  XrdOucString err_msg;
-  XrdOucErrInfo lerror;
-
-  if (gOFS->_find(dpath.data(), lerror, err_msg, mRootVid, found)) {
-    eos_static_err("msg=\"failed doing find in subtree\" path=%s stderr=\"%s\"",
-                   dpath.data(), err_msg.c_str());
-  } else {
-    // Delete files starting at the deepest level
-    for (auto dit = found.rbegin(); dit != found.rend(); ++dit) {
-      for (auto fit = dit->second.begin(); fit != dit->second.end(); ++fit) {
-        const std::string fname = HandlePotentialSymlink(dit->first, *fit);
-        eos_static_debug("orig_fname=\"%s\" new_fname=\"%s\"",
-                         fit->c_str(), fname.c_str());
-        std::string fpath = dit->first;
-        fpath += fname;
-
-        if (gOFS->_rem(fpath.c_str(), lerror, mRootVid, nullptr)) {
-          eos_static_err("msg=\"unable to remove file\" path=%s", fpath.c_str());
-        } else {
-          eos_static_info("msg=\"permanently deleted file from recycle bin\" "
-                          "path=%s", fpath.c_str());
-        }
-      }
-    }
-
-    // Delete directories starting at the deepest level
-    for (auto dit = found.rbegin(); dit != found.rend(); ++dit) {
-      eos_static_info("msg=\"handling directory\" path=%s", dit->first.c_str());
-      std::string ldpath = dit->first.c_str();
-
-      // Don't even try to delete the root directory or
-      // something outside the recycle bin
-      if ((ldpath == "/") || (ldpath.find(Recycle::gRecyclingPrefix) != 0)) {
-        continue;
-      }
-
-      if (!gOFS->_remdir(ldpath.c_str(), lerror, mRootVid, (const char*) 0)) {
-        eos_static_info("msg=\"permanently deleted directory from "
-                        "recycle bin\" path=%s", ldpath.c_str());
-      } else {
-        eos_static_err("msg=\"unable to remove directory\" path=%s",
-                       ldpath.c_str());
-      }
-    }
-
-    // Delete parent directories if empty and still within the recycle bin.
-    if (dpath.find(Recycle::gRecyclingPrefix) == 0) {
-      eos_static_info("msg=\"delete parent directory\" path=%s", dpath.data());
-      eos::common::Path cpath(std::string(dpath.data()));
-
-      for (auto level = cpath.GetSubPathSize() - 1; level > 4; --level) {
-        std::string sub_path = cpath.GetSubPath(level);
-
-        if (!gOFS->_remdir(sub_path.c_str(), lerror, mRootVid, (const char*) 0)) {
-          eos_static_info("msg=\"permanently deleted directory from "
-                          "recycle bin\" path=%s", sub_path.c_str());
-        } else {
-          // Failed removal means directory is not empty so there is
-          // no point in continuing.
-          break;
-        }
-      }
-    }
-  }
+  gOFS->mRecycler->mPurger.RemoveSubtree(dpath);
 }
 
 //------------------------------------------------------------------------------
@@ -24,6 +24,7 @@
 #pragma once
 #include "mgm/Namespace.hh"
 #include "mgm/recycle/RecyclePolicy.hh"
+#include "mgm/recycle/RecyclePurger.hh"
 #include "common/AssistedThread.hh"
 #include "common/SystemClock.hh"
 #include "proto/Recycle.pb.h"
@@ -51,6 +52,8 @@ EOSMGMNAMESPACE_BEGIN
 //------------------------------------------------------------------------------
 class Recycle
 {
+  friend class RecyclePurger;
+
 public:
   typedef std::vector<std::map<std::string, std::string>> RecycleListing;
   //! Prefix for all recycle bins
@@ -331,12 +334,24 @@ public:
     return mPolicy.mEnabled.load();
   }
 
+  //----------------------------------------------------------------------------
+  //! Get the recycle bin purge statistics
+  //!
+  //! @param monitoring if true use the monitoring key-value format
+  //----------------------------------------------------------------------------
+  inline std::string GetPurgeStats(bool monitoring) const
+  {
+    return mPurger.GetStats(monitoring);
+  }
+
 private:
 #ifdef IN_TEST_HARNESS
 public:
 #endif
   AssistedThread mThread; ///< Thread doing the recycling
   RecyclePolicy mPolicy;
+  //! Batched and parallel removal of the expired entries
+  RecyclePurger mPurger;
   //! Map holding the container identifier and the full path of the directories
   //! to be deleted.
   std::map<eos::IContainerMD::id_t, std::string> mPendingDeletions;
@@ -361,7 +376,8 @@ public:
                      const eos::common::VirtualIdentity& vid);
 
   //----------------------------------------------------------------------------
-  //! Remove all the entries in the given subtree
+  //! Remove all the entries in the given subtree, the files of each directory
+  //! are removed in batches
   //!
   //! @param fullpath full path to directory
   //----------------------------------------------------------------------------
@@ -392,7 +408,7 @@ public:
   void CollectEntries(ThreadAssistant& assistant);
 
   //----------------------------------------------------------------------------
-  //! Remove the pending deletions
+  //! Remove the pending deletions, several subtrees are purged in parallel
   //----------------------------------------------------------------------------
   void RemoveEntries();
 
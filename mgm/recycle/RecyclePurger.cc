@@ -0,0 +1,408 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Parallel and batched removal of recycle bin subtrees
+//------------------------------------------------------------------------------
+
+#include "mgm/recycle/RecyclePurger.hh"
+#include "mgm/recycle/Recycle.hh"
+#include "mgm/fsview/FsView.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
+#include "mgm/ofs/XrdMgmOfsFile.hh"
+#include "common/AssistedThread.hh"
+#include "common/Constants.hh"
+#include "common/Logging.hh"
+#include "common/ParseUtils.hh"
+#include "common/Path.hh"
+#include "common/RWMutex.hh"
+#include "common/StringUtils.hh"
+#include "namespace/Prefetcher.hh"
+#include <XrdOuc/XrdOucErrInfo.hh>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <thread>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Get the purge options from the default space configuration
+//------------------------------------------------------------------------------
+RecyclePurger::Options
+RecyclePurger::GetOptions()
+{
+  Options opts;
+  eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+  auto it = FsView::gFsView.mSpaceView.find("default");
+
+  if (it == FsView::gFsView.mSpaceView.end()) {
+    return opts;
+  }
+
+  int64_t value = 0;
+  std::string svalue = it->second->GetConfigMember("recycle.purge.threads");
+
+  if (!svalue.empty() && common::ParseInt64(svalue, value) && (value > 0)) {
+    opts.threads = std::min<int64_t>(value, 64);
+  }
+
+  svalue = it->second->GetConfigMember("recycle.purge.batch");
+
+  if (!svalue.empty() && common::ParseInt64(svalue, value) && (value > 0)) {
+    opts.batch = std::min<int64_t>(value, 100000);
+  }
+
+  svalue = it->second->GetConfigMember("recycle.purge.rate");
+
+  if (!svalue.empty() && common::ParseInt64(svalue, value) && (value >= 0)) {
+    opts.rate = value;
+  }
+
+  return opts;
+}
+
+//------------------------------------------------------------------------------
+// Apply the current options
+//------------------------------------------------------------------------------
+void
+RecyclePurger::RefreshOptions()
+{
+  Options opts = GetOptions();
+  mThreads = opts.threads;
+  mBatch = opts.batch;
+  mRate = opts.rate;
+}
+
+//------------------------------------------------------------------------------
+// Remove the given subtrees in parallel
+//------------------------------------------------------------------------------
+size_t
+RecyclePurger::Purge(const std::vector<std::string>& subtrees,
+                     ThreadAssistant* assistant)
+{
+  if (subtrees.empty()) {
+    return 0;
+  }
+
+  RefreshOptions();
+  const uint64_t start_files = mFiles + mSerialFiles;
+  const auto start = std::chrono::steady_clock::now();
+  std::atomic<size_t> next {0};
+  std::atomic<size_t> done {0};
+  auto worker = [&]() {
+    while (!assistant || !assistant->terminationRequested()) {
+      size_t idx = next++;
+
+      if (idx >= subtrees.size()) {
+        break;
+      }
+
+      DoRemoveSubtree(subtrees[idx]);
+      ++done;
+    }
+  };
+  size_t nthreads = std::min<size_t>(mThreads.load(), subtrees.size());
+  std::vector<std::thread> workers;
+
+  for (size_t i = 1; i < nthreads; ++i) {
+    workers.emplace_back(worker);
+  }
+
+  worker();
+
+  for (auto& thread : workers) {
+    thread.join();
+  }
+
+  mLastFiles = mFiles + mSerialFiles - start_files;
+  mLastDurationMs = std::chrono::duration_cast<std::chrono::milliseconds>
+                    (std::chrono::steady_clock::now() - start).count();
+  eos_static_notice("msg=\"recycle purge done\" subtrees=%llu files=%llu "
+                    "duration_ms=%llu threads=%llu", done.load(),
+                    mLastFiles.load(), mLastDurationMs.load(), nthreads);
+  return done;
+}
+
+//------------------------------------------------------------------------------
+// Remove all the entries in the given subtree
+//------------------------------------------------------------------------------
+void
+RecyclePurger::RemoveSubtree(std::string_view dpath)
+{
+  RefreshOptions();
+  DoRemoveSubtree(dpath);
+}
+
+//------------------------------------------------------------------------------
+// Remove the subtree with the current options
+//------------------------------------------------------------------------------
+void
+RecyclePurger::DoRemoveSubtree(std::string_view dpath)
+{
+  std::map<std::string, std::set<std::string> > found;
+  XrdOucString err_msg;
+  XrdOucErrInfo lerror;
+
+  if (gOFS->_find(dpath.data(), lerror, err_msg, Recycle::mRootVid, found)) {
+    eos_static_err("msg=\"failed doing find in subtree\" path=%s stderr=\"%s\"",
+                   dpath.data(), err_msg.c_str());
+    return;
+  }
+
+  eos::BatchFileRemover::Options opts;
+  opts.batchSize = mBatch;
+  opts.nsMutex = &gOFS->eosViewRWMutex;
+  // Drop the TAPE_FS_ID which otherwise would prevent the file metadata cleanup
+  opts.dropLocation = eos::common::TAPE_FS_ID;
+  eos::BatchFileRemover remover(gOFS->eosView, gOFS->eosFileService,
+                                gOFS->eosDirectoryService, opts, this);
+
+  // Delete files starting at the deepest level
+  for (auto dit = found.rbegin(); dit != found.rend(); ++dit) {
+    if (dit->second.empty()) {
+      continue;
+    }
+
+    eos::IContainerMD::XAttrMap attrmap;
+
+    if (gOFS->_attr_ls(dit->first.c_str(), lerror, Recycle::mRootVid, nullptr,
+                       attrmap, true)) {
+      eos_static_err("msg=\"unable to list directory attributes\" path=%s",
+                     dit->first.c_str());
+      continue;
+    }
+
+    // Workflows are triggered per file by the regular deletion path
+    bool has_workflow = std::any_of(attrmap.begin(), attrmap.end(),
+    [](const auto & elem) {
+      return eos::common::startsWith(elem.first, "sys.workflow.");
+    });
+
+    if (has_workflow) {
+      RemoveFilesSerially(dit->first, dit->second);
+      continue;
+    }
+
+    eos::IContainerMD::id_t cid = 0;
+    eos::Prefetcher::prefetchContainerMDAndWait(gOFS->eosView, dit->first);
+
+    try {
+      eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+      cid = gOFS->eosView->getContainer(dit->first)->getId();
+    } catch (const eos::MDException& e) {
+      eos_static_err("msg=\"unable to get directory\" path=%s",
+                     dit->first.c_str());
+      continue;
+    }
+
+    auto result = remover.removeFiles(cid);
+    mFiles += result.removed;
+    mBatches += result.batches;
+    mFailed += result.failed;
+    eos_static_info("msg=\"permanently deleted files from recycle bin\" "
+                    "path=%s files=%llu failed=%llu batches=%llu",
+                    dit->first.c_str(), result.removed, result.failed,
+                    result.batches);
+  }
+
+  // Delete directories starting at the deepest level
+  for (auto dit = found.rbegin(); dit != found.rend(); ++dit) {
+    eos_static_info("msg=\"handling directory\" path=%s", dit->first.c_str());
+    std::string ldpath = dit->first.c_str();
+
+    // Don't even try to delete the root directory or
+    // something outside the recycle bin
+    if ((ldpath == "/") || (ldpath.find(Recycle::gRecyclingPrefix) != 0)) {
+      continue;
+    }
+
+    if (!gOFS->_remdir(ldpath.c_str(), lerror, Recycle::mRootVid,
+                       (const char*) 0)) {
+      ++mDirs;
+      eos_static_info("msg=\"permanently deleted directory from "
+                      "recycle bin\" path=%s", ldpath.c_str());
+    } else {
+      eos_static_err("msg=\"unable to remove directory\" path=%s",
+                     ldpath.c_str());
+    }
+  }
+
+  // Delete parent directories if empty and still within the recycle bin.
+  if (dpath.find(Recycle::gRecyclingPrefix) == 0) {
+    eos_static_info("msg=\"delete parent directory\" path=%s", dpath.data());
+    eos::common::Path cpath(std::string(dpath.data()));
+
+    for (auto level = cpath.GetSubPathSize() - 1; level > 4; --level) {
+      std::string sub_path = cpath.GetSubPath(level);
+
+      if (!gOFS->_remdir(sub_path.c_str(), lerror, Recycle::mRootVid,
+                         (const char*) 0)) {
+        ++mDirs;
+        eos_static_info("msg=\"permanently deleted directory from "
+                        "recycle bin\" path=%s", sub_path.c_str());
+      } else {
+        // Failed removal means directory is not empty so there is
+        // no point in continuing.
+        break;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Remove the files of a directory one by one through the regular deletion path
+//------------------------------------------------------------------------------
+void
+RecyclePurger::RemoveFilesSerially(const std::string& dpath,
+                                   const std::set<std::string>& files)
+{
+  XrdOucErrInfo lerror;
+
+  for (const auto& file : files) {
+    const std::string fname = Recycle::HandlePotentialSymlink(dpath, file);
+    std::string fpath = dpath + fname;
+    throttle(1);
+
+    if (gOFS->_rem(fpath.c_str(), lerror, Recycle::mRootVid, nullptr)) {
+      ++mFailed;
+      eos_static_err("msg=\"unable to remove file\" path=%s", fpath.c_str());
+    } else {
+      ++mSerialFiles;
+      eos_static_info("msg=\"permanently deleted file from recycle bin\" "
+                      "path=%s", fpath.c_str());
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Block until the given number of files fits in the configured rate
+//------------------------------------------------------------------------------
+void
+RecyclePurger::throttle(size_t nfiles)
+{
+  const uint64_t rate = mRate.load();
+
+  if (rate == 0) {
+    return;
+  }
+
+  std::chrono::steady_clock::duration wait_for;
+  {
+    std::unique_lock<std::mutex> lock(mRateMutex);
+    auto now = std::chrono::steady_clock::now();
+
+    // Unused capacity is not accumulated
+    if (mNextSlot < now) {
+      mNextSlot = now;
+    }
+
+    wait_for = mNextSlot - now;
+    mNextSlot += std::chrono::nanoseconds(nfiles * 1000000000ull / rate);
+  }
+
+  if (wait_for.count() > 0) {
+    mThrottledMs += std::chrono::duration_cast<std::chrono::milliseconds>
+                    (wait_for).count();
+    std::this_thread::sleep_for(wait_for);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Handle clones and hard links, called with the namespace lock held
+//------------------------------------------------------------------------------
+bool
+RecyclePurger::handled(const eos::IContainerMDPtr& cont,
+                       const eos::IFileMDPtr& fmd)
+{
+  XrdOucErrInfo lerror;
+
+  // The copy-on-write clone takes over the file
+  if (XrdMgmOfsFile::create_cow(XrdMgmOfsFile::cowDelete, cont, fmd,
+                                Recycle::mRootVid, lerror) == 0) {
+    return true;
+  }
+
+  return (XrdMgmOfsFile::handleHardlinkDelete(cont, fmd, Recycle::mRootVid) != 0);
+}
+
+//------------------------------------------------------------------------------
+// Write the deletion report, called with the namespace lock held
+//------------------------------------------------------------------------------
+void
+RecyclePurger::unlinked(const eos::IContainerMDPtr& cont,
+                        const std::string& cont_uri,
+                        const eos::IFileMDPtr& fmd)
+{
+  const std::string path = cont_uri + fmd->getName();
+  gOFS->WriteRmRecord(fmd, path.c_str());
+}
+
+//------------------------------------------------------------------------------
+// Notify the fusex clients once per batch
+//------------------------------------------------------------------------------
+void
+RecyclePurger::batchDone(const eos::IContainerMDPtr& cont,
+                         const std::vector<std::string>& names)
+{
+  eos::ContainerIdentifier c_ident = cont->getIdentifier();
+  eos::ContainerIdentifier p_ident = cont->getParentIdentifier();
+
+  for (const auto& name : names) {
+    gOFS->FuseXCastDeletion(c_ident, name);
+  }
+
+  gOFS->FuseXCastRefresh(c_ident, p_ident);
+}
+
+//------------------------------------------------------------------------------
+// Get purge statistics
+//------------------------------------------------------------------------------
+std::string
+RecyclePurger::GetStats(bool monitoring) const
+{
+  std::ostringstream oss;
+  const uint64_t last_ms = mLastDurationMs.load();
+  const uint64_t last_files = mLastFiles.load();
+  const double rate = (last_ms ? (1000.0 * last_files / last_ms) : 0.0);
+
+  if (monitoring) {
+    const std::string prefix = "uid=all gid=all ns.recycle.purge.";
+    oss << prefix << "files=" << mFiles << std::endl
+        << prefix << "files.serial=" << mSerialFiles << std::endl
+        << prefix << "dirs=" << mDirs << std::endl
+        << prefix << "batches=" << mBatches << std::endl
+        << prefix << "failed=" << mFailed << std::endl
+        << prefix << "throttled_ms=" << mThrottledMs << std::endl
+        << prefix << "last.files=" << last_files << std::endl
+        << prefix << "last.duration_ms=" << last_ms << std::endl
+        << prefix << "last.rate=" << rate << std::endl;
+  } else {
+    oss << "ALL      recycle purge                    "
+        << "files=" << mFiles << " files_serial=" << mSerialFiles
+        << " dirs=" << mDirs << " batches=" << mBatches
+        << " failed=" << mFailed << " throttled_ms=" << mThrottledMs
+        << " last_files=" << last_files << " last_duration_ms=" << last_ms
+        << " last_rate=" << rate << "/s" << std::endl;
+  }
+
+  return oss.str();
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,141 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Parallel and batched removal of recycle bin subtrees
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "mgm/Namespace.hh"
+#include "namespace/ns_quarkdb/utils/BatchFileRemover.hh"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ThreadAssistant;
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Remove expired recycle bin subtrees. The files of each directory are
+//! removed in batches, each batch under a single namespace lock acquisition,
+//! and several subtrees are purged in parallel. The total file removal rate
+//! is bounded by a limit shared by all the workers.
+//!
+//! The settings are read from the default space configuration:
+//! recycle.purge.threads, recycle.purge.batch and recycle.purge.rate (files/s,
+//! 0 means unlimited).
+//------------------------------------------------------------------------------
+class RecyclePurger: public eos::BatchFileRemover::Hooks
+{
+public:
+  //! Purge settings
+  struct Options {
+    unsigned int threads = 4;
+    size_t batch = 1000;
+    uint64_t rate = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get the purge options from the default space configuration
+  //----------------------------------------------------------------------------
+  static Options GetOptions();
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  RecyclePurger() = default;
+
+  //----------------------------------------------------------------------------
+  //! Remove the given subtrees in parallel
+  //!
+  //! @param subtrees recycle bin directories to remove
+  //! @param assistant thread assistant of the caller, checked for termination
+  //!        between subtrees
+  //!
+  //! @return number of subtrees handled
+  //----------------------------------------------------------------------------
+  size_t Purge(const std::vector<std::string>& subtrees,
+               ThreadAssistant* assistant = nullptr);
+
+  //----------------------------------------------------------------------------
+  //! Remove all the entries in the given subtree
+  //!
+  //! @param dpath full path to directory
+  //----------------------------------------------------------------------------
+  void RemoveSubtree(std::string_view dpath);
+
+  //----------------------------------------------------------------------------
+  //! Get purge statistics
+  //!
+  //! @param monitoring if true use the monitoring key-value format
+  //----------------------------------------------------------------------------
+  std::string GetStats(bool monitoring) const;
+
+  //----------------------------------------------------------------------------
+  //! BatchFileRemover hooks
+  //----------------------------------------------------------------------------
+  void throttle(size_t nfiles) override;
+  bool handled(const eos::IContainerMDPtr& cont,
+               const eos::IFileMDPtr& fmd) override;
+  void unlinked(const eos::IContainerMDPtr& cont, const std::string& cont_uri,
+                const eos::IFileMDPtr& fmd) override;
+  void batchDone(const eos::IContainerMDPtr& cont,
+                 const std::vector<std::string>& names) override;
+
+private:
+  //----------------------------------------------------------------------------
+  //! Apply the current options
+  //----------------------------------------------------------------------------
+  void RefreshOptions();
+
+  //----------------------------------------------------------------------------
+  //! Remove the subtree with the current options
+  //----------------------------------------------------------------------------
+  void DoRemoveSubtree(std::string_view dpath);
+
+  //----------------------------------------------------------------------------
+  //! Remove the files of a directory one by one through the regular deletion
+  //! path, used for directories with workflows or clones attached
+  //----------------------------------------------------------------------------
+  void RemoveFilesSerially(const std::string& dpath,
+                           const std::set<std::string>& files);
+
+  std::atomic<unsigned int> mThreads {4};
+  std::atomic<size_t> mBatch {1000};
+  std::atomic<uint64_t> mRate {0};
+  //! Earliest time the next batch may start when rate limited
+  std::mutex mRateMutex;
+  std::chrono::steady_clock::time_point mNextSlot;
+  //! Statistics
+  std::atomic<uint64_t> mFiles {0};
+  std::atomic<uint64_t> mSerialFiles {0};
+  std::atomic<uint64_t> mDirs {0};
+  std::atomic<uint64_t> mBatches {0};
+  std::atomic<uint64_t> mFailed {0};
+  std::atomic<uint64_t> mThrottledMs {0};
+  std::atomic<uint64_t> mLastFiles {0};
+  std::atomic<uint64_t> mLastDurationMs {0};
+};
+
+EOSMGMNAMESPACE_END
@@ -29,16 +29,136 @@
 #include "mgm/tgc/RealTapeGcMgm.hh"
 #include "mgm/tgc/SpaceNotFound.hh"
 #include "mgm/CtaUtils.hh"
+#include "mgm/nsscan/NsScanBus.hh"
+#include "mgm/ofs/XrdMgmOfs.hh"
 #include "namespace/interface/IFileMDSvc.hh"
 #include "namespace/ns_quarkdb/inspector/FileScanner.hh"
 #include "namespace/ns_quarkdb/qclient/include/qclient/QClient.hh"
 #include "namespace/Prefetcher.hh"
 
+#include <condition_variable>
 #include <sstream>
 #include <stdexcept>
 
 EOSTGCNAMESPACE_BEGIN
 
+namespace
+{
+using SpaceToReplicas =
+  std::map<std::string, std::set<ITapeGcMgm::FileIdAndCtime> >;
+
+//------------------------------------------------------------------------------
+// Add the disk replicas of the given file to the space to replicas map
+//------------------------------------------------------------------------------
+void
+addDiskReplicas(const eos::ns::FileMdProto& file,
+                const std::map<common::FileSystem::fsid_t, std::string>&
+                fsIdToSpace, const std::set<std::string>& spacesToMap,
+                SpaceToReplicas& spaceToReplicas, std::set<int>& fsIdsWithNoSpace)
+{
+  const auto ctime = CtaUtils::bufToTimespec(file.ctime());
+  const int locationsSize = file.locations_size();
+
+  for (int locationIndex = 0; locationIndex < locationsSize; locationIndex++) {
+    const int fsId = file.locations(locationIndex);
+    const auto itor = fsIdToSpace.find(fsId);
+
+    if (fsIdToSpace.end() == itor) {
+      fsIdsWithNoSpace.insert(fsId);
+    } else {
+      const std::string& space = itor->second;
+
+      if (spacesToMap.count(space)) {
+        spaceToReplicas[space].emplace(file.id(), ctime);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//! Namespace scan bus consumer collecting the disk replicas during one full
+//! scan cycle instead of running a dedicated file scan
+//------------------------------------------------------------------------------
+class DiskReplicaCollector: public NsScanConsumer
+{
+public:
+  DiskReplicaCollector(const std::map<common::FileSystem::fsid_t, std::string>&
+                       fsIdToSpace, const std::set<std::string>& spacesToMap):
+    mFsIdToSpace(fsIdToSpace), mSpacesToMap(spacesToMap)
+  {}
+
+  std::string GetScanConsumerName() const override
+  {
+    return "tgc";
+  }
+
+  bool WantsFiles() const override
+  {
+    return true;
+  }
+
+  bool FilterFile(const eos::ns::FileMdProto& proto) const override
+  {
+    return (proto.locations_size() != 0);
+  }
+
+  void CycleStart(uint64_t cycle, bool resumed) override
+  {
+    // Only a cycle seen from the beginning gives a complete map
+    mCollecting = !resumed;
+    mSpaceToReplicas.clear();
+    mFsIdsWithNoSpace.clear();
+    mNbFilesScanned = 0;
+  }
+
+  void ProcessFile(eos::ns::FileMdProto&& proto) override
+  {
+    if (mCollecting) {
+      addDiskReplicas(proto, mFsIdToSpace, mSpacesToMap, mSpaceToReplicas,
+                      mFsIdsWithNoSpace);
+      mNbFilesScanned++;
+    }
+  }
+
+  void CycleEnd(uint64_t cycle, bool complete) override
+  {
+    if (mCollecting && complete) {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mDone = true;
+      mCond.notify_all();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Wait until a complete cycle was collected
+  //!
+  //! @return true if done, false if stop was requested or the bus disabled
+  //----------------------------------------------------------------------------
+  bool WaitDone(const NsScanBus& bus, std::atomic<bool>& stop)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mDone && !stop && bus.IsEnabled()) {
+      mCond.wait_for(lock, std::chrono::seconds(1));
+    }
+
+    return mDone;
+  }
+
+  SpaceToReplicas mSpaceToReplicas;
+  std::set<int> mFsIdsWithNoSpace;
+  uint64_t mNbFilesScanned {0};
+
+private:
+  const std::map<common::FileSystem::fsid_t, std::string>& mFsIdToSpace;
+  const std::set<std::string>& mSpacesToMap;
+  bool mCollecting {false};
+  std::mutex mMutex;
+  std::condition_variable mCond;
+  bool mDone {false};
+};
+}
+
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
@@ -377,44 +497,49 @@ RealTapeGcMgm::getSpaceToDiskReplicasMap(const std::set<std::string>&
 
   std::map<std::string, std::set<FileIdAndCtime> > spaceToReplicas;
   const auto fsIdToSpace = getFsIdToSpaceMap();
-  qclient::QClient qdbClient(m_ofs.mQdbContactDetails.members,
-                             m_ofs.mQdbContactDetails.constructOptions());
-  FileScanner fileScanner(qdbClient);
   std::set<int> fsIdsWithNoSpace;
-
-  while (fileScanner.valid()) {
-    eos::ns::FileMdProto file;
-
-    if (stop) {
+  bool collected = false;
+
+  // Piggyback on the next namespace scan bus cycle if enabled
+  if (m_ofs.mNsScanBus && m_ofs.mNsScanBus->IsEnabled()) {
+    DiskReplicaCollector collector(fsIdToSpace, spacesToMap);
+    m_ofs.mNsScanBus->Register(&collector);
+    collected = collector.WaitDone(*m_ofs.mNsScanBus, stop);
+    m_ofs.mNsScanBus->Unregister(&collector);
+
+    if (collected) {
+      spaceToReplicas.swap(collector.mSpaceToReplicas);
+      fsIdsWithNoSpace.swap(collector.mFsIdsWithNoSpace);
+      nbFilesScanned = collector.mNbFilesScanned;
+    } else if (stop) {
       eos_static_info("The creation of the EOS space name to files map has been requested to stop");
-      break;
-    }
-
-    if (!fileScanner.getItem(file)) {
-      eos_static_warning("msg=\"fileScanner stopped iterating early\"");
-      break;
+      return spaceToReplicas;
     }
+  }
 
-    const auto ctime = CtaUtils::bufToTimespec(file.ctime());
-    const int locationsSize = file.locations_size();
+  if (!collected) {
+    qclient::QClient qdbClient(m_ofs.mQdbContactDetails.members,
+                               m_ofs.mQdbContactDetails.constructOptions());
+    FileScanner fileScanner(qdbClient);
 
-    for (int locationIndex = 0; locationIndex < locationsSize; locationIndex++) {
-      const int fsId = file.locations(locationIndex);
-      const auto itor = fsIdToSpace.find(fsId);
+    while (fileScanner.valid()) {
+      eos::ns::FileMdProto file;
 
-      if (fsIdToSpace.end() == itor) {
-        fsIdsWithNoSpace.insert(fsId);
-      } else {
-        const std::string& space = itor->second;
+      if (stop) {
+        eos_static_info("The creation of the EOS space name to files map has been requested to stop");
+        break;
+      }
 
-        if (spacesToMap.count(space)) {
-          spaceToReplicas[space].emplace(file.id(), ctime);
-        }
+      if (!fileScanner.getItem(file)) {
+        eos_static_warning("msg=\"fileScanner stopped iterating early\"");
+        break;
       }
-    }
 
-    nbFilesScanned++;
-    fileScanner.next();
+      addDiskReplicas(file, fsIdToSpace, spacesToMap, spaceToReplicas,
+                      fsIdsWithNoSpace);
+      nbFilesScanned++;
+      fileScanner.next();
+    }
   }
 
   if (!fsIdsWithNoSpace.empty()) {
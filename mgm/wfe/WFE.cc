@@ -84,6 +84,10 @@ WFE::WFE()
 bool
 WFE::Start()
 {
+  if (!mQueue) {
+    mQueue.reset(new WFEQueue(gOFS->mQdbContactDetails));
+  }
+
   try {
     mThread.reset(&WFE::WFEr, this);
   } catch (const std::system_error& e) {
@@ -117,6 +121,11 @@ WFE::WFEr(ThreadAssistant& assistant) noexcept
   time_t snoozetime = 10;
   size_t lWFEntx = 0;
   time_t cleanuptime = 0;
+  bool recovered = false;
+  bool drained = false;
+  assistant.registerCallback([this]() {
+    mQueue->Wakeup();
+  });
   gOFS->WaitUntilNamespaceIsBooted(assistant);
 
   if (assistant.terminationRequested()) {
@@ -132,8 +141,6 @@ WFE::WFEr(ThreadAssistant& assistant) noexcept
     time_t lStartTime = time(NULL);
     time_t lStopTime;
     time_t lKeepTime = 7 * 86400;
-    std::map<std::string, std::set<std::string> > wfedirs;
-    XrdOucString stdErr;
     {
       eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
 
@@ -162,117 +169,45 @@ WFE::WFEr(ThreadAssistant& assistant) noexcept
     }
 
     // Only a master needs to run WFE
-    if (gOFS->mMaster->IsMaster() && IsEnabledWFE) {
-      eos_static_debug("msg=\"start WFE scan\"");
-      // Find all directories defining an WFE policy
-      gOFS->MgmStats.Add("WFEFind", 0, 0, 1);
-      EXEC_TIMING_BEGIN("WFEFind");
-      // prepare four queries today, yesterday for queued and error jobs
-      std::string queries[4];
-
-      for (size_t i = 0; i < 4; ++i) {
-        queries[i] = gOFS->MgmProcWorkflowPath.c_str();
-        queries[i] += "/";
-      }
-
-      {
-        // today
-        time_t when = time(NULL);
-        std::string day = eos::common::Timing::UnixTimestamp_to_Day(when);
-        queries[0] += day;
-        queries[0] += "/q/";
-        queries[1] += day;
-        queries[1] += "/e/";
-        //yesterday
-        when -= (24 * 3600);
-        day = eos::common::Timing::UnixTimestamp_to_Day(when);
-        queries[2] += day;
-        queries[2] += "/q/";
-        queries[3] += day;
-        queries[3] += "/e/";
-      }
-
-      for (size_t i = 0; i < 4; ++i) {
-        eos_static_debug("query-path=%s", queries[i].c_str());
-        gOFS->_find(queries[i].c_str(), mError, stdErr, mRootVid, wfedirs, 0,
-                    0, false, 0, false, 0);
-      }
-
-      {
-        eos_static_debug("msg=\"finished WFE find\" WFE-dirs=%llu %s",
-                         wfedirs.size(), stdErr.c_str()
-                        );
-        time_t now = time(NULL);
-
-        for (auto it = wfedirs.begin(); it != wfedirs.end(); it++) {
-          // -------------------------------------------------------------------
-          // get workflows
-          // -------------------------------------------------------------------
-          if (it->second.size()) {
-            for (auto wit = it->second.begin(); wit != it->second.end(); ++wit) {
-              eos_static_debug("wfe-dir=\"%s\" wfe-job=\"%s\"", it->first.c_str(),
-                               wit->c_str());
-              std::string f = it->first;
-              f += *wit;
-              Job* job = new Job();
-
-              if (!job || job->Load(f)) {
-                eos_static_err("msg=\"cannot load workflow entry\" value=\"%s\"", f.c_str());
-
-                if (job) {
-                  delete job;
-                }
-              } else {
-                // don't schedule jobs for the future
-                if ((!job->mActions.size()) || (now < job->mActions[0].mTime)) {
-                  delete job;
-                  continue;
-                }
+    bool dispatchFromQueue = false;
 
-                // stop scheduling if there are too many jobs running
-                if (lWFEntx <= GetActiveJobs()) {
-                  if (lWFEntx > 0) {
-                    mDoneSignal.WaitMS(100);
+    if (gOFS->mMaster->IsMaster() && IsEnabledWFE) {
+      if (UseQueue()) {
+        if (!recovered) {
+          int64_t npending = mQueue->Recover();
+
+          if (npending >= 0) {
+            eos_static_info("msg=\"recovered workflow queue\" pending=%lld",
+                            (long long) npending);
+            recovered = true;
+          }
+        }
 
-                    if (lWFEntx <= GetActiveJobs()) {
-                      delete job;
-                      break;
-                    }
-                  }
-                }
+        // Run the jobs left in the proc queues before switching to QuarkDB
+        if (!drained) {
+          drained = (ScanProcQueues(lWFEntx) == 0);
+        }
 
-                if (!job->IsSync()) {
-                  // use the shared scheduler for asynchronous jobs
-                  XrdSysMutexHelper sLock(gSchedulerMutex);
-                  time_t storetime = 0;
-                  // move job into the scheduled queue
-                  job->Move(job->mActions[0].mQueue, "r", storetime);
-                  job->mActions[0].mQueue = "r";
-                  job->mActions[0].mTime = storetime;
-                  XrdOucString tst;
-                  job->mActions[0].mWhen = eos::common::StringConversion::GetSizeString(tst,
-                                           (unsigned long long) storetime);
-                  gScheduler->Schedule((XrdJob*) job);
-                  IncActiveJobs();
-                  eos_static_info("msg=\"scheduled workflow\" job=\"%s\"",
-                                  job->mDescription.c_str());
-                } else {
-                  delete job;
-                }
-              }
-            }
-          }
+        if (recovered) {
+          DispatchQueue(assistant, lWFEntx,
+                        std::chrono::seconds(std::max(lWFEInterval, (time_t) 1)));
+          dispatchFromQueue = true;
         }
+      } else {
+        drained = false;
+        ScanProcQueues(lWFEntx);
       }
-
-      EXEC_TIMING_END("WFEFind");
-      eos_static_debug("msg=\"finished WFE application\" WFE-dirs=%llu",
-                       wfedirs.size());
+    } else if (!gOFS->mMaster->IsMaster()) {
+      // A new master has to recover the claimed jobs
+      recovered = false;
     }
 
     lStopTime = time(NULL);
 
-    if ((lStopTime - lStartTime) < lWFEInterval) {
+    if (dispatchFromQueue) {
+      // The dispatcher already waited for due jobs during the interval
+      snoozetime = 0;
+    } else if ((lStopTime - lStartTime) < lWFEInterval) {
       snoozetime = lWFEInterval - (lStopTime - lStartTime);
     }
 
@@ -356,6 +291,128 @@ WFE::WFEr(ThreadAssistant& assistant) noexcept
   }
 }
 
+//------------------------------------------------------------------------------
+// Scan today's and yesterday's proc queues and schedule the due jobs
+//------------------------------------------------------------------------------
+size_t
+WFE::ScanProcQueues(size_t ntx)
+{
+  std::map<std::string, std::set<std::string> > wfedirs;
+  XrdOucString stdErr;
+  size_t njobs = 0;
+  eos_static_debug("msg=\"start WFE scan\"");
+  // Find all directories defining an WFE policy
+  gOFS->MgmStats.Add("WFEFind", 0, 0, 1);
+  EXEC_TIMING_BEGIN("WFEFind");
+  // prepare four queries today, yesterday for queued and error jobs
+  std::string queries[4];
+
+  for (size_t i = 0; i < 4; ++i) {
+    queries[i] = gOFS->MgmProcWorkflowPath.c_str();
+    queries[i] += "/";
+  }
+
+  {
+    // today
+    time_t when = time(NULL);
+    std::string day = eos::common::Timing::UnixTimestamp_to_Day(when);
+    queries[0] += day;
+    queries[0] += "/q/";
+    queries[1] += day;
+    queries[1] += "/e/";
+    //yesterday
+    when -= (24 * 3600);
+    day = eos::common::Timing::UnixTimestamp_to_Day(when);
+    queries[2] += day;
+    queries[2] += "/q/";
+    queries[3] += day;
+    queries[3] += "/e/";
+  }
+
+  for (size_t i = 0; i < 4; ++i) {
+    eos_static_debug("query-path=%s", queries[i].c_str());
+    gOFS->_find(queries[i].c_str(), mError, stdErr, mRootVid, wfedirs, 0,
+                0, false, 0, false, 0);
+  }
+
+  {
+    eos_static_debug("msg=\"finished WFE find\" WFE-dirs=%llu %s",
+                     wfedirs.size(), stdErr.c_str()
+                    );
+    time_t now = time(NULL);
+
+    for (auto it = wfedirs.begin(); it != wfedirs.end(); it++) {
+      // -------------------------------------------------------------------
+      // get workflows
+      // -------------------------------------------------------------------
+      if (it->second.size()) {
+        for (auto wit = it->second.begin(); wit != it->second.end(); ++wit) {
+          eos_static_debug("wfe-dir=\"%s\" wfe-job=\"%s\"", it->first.c_str(),
+                           wit->c_str());
+          std::string f = it->first;
+          f += *wit;
+          Job* job = new Job();
+
+          if (!job || job->Load(f)) {
+            eos_static_err("msg=\"cannot load workflow entry\" value=\"%s\"", f.c_str());
+
+            if (job) {
+              delete job;
+            }
+          } else {
+            // don't schedule jobs for the future
+            if ((!job->mActions.size()) || (now < job->mActions[0].mTime)) {
+              delete job;
+              continue;
+            }
+
+            // stop scheduling if there are too many jobs running
+            if (ntx <= GetActiveJobs()) {
+              if (ntx > 0) {
+                mDoneSignal.WaitMS(100);
+
+                if (ntx <= GetActiveJobs()) {
+                  delete job;
+                  break;
+                }
+              }
+            }
+
+            if (!job->IsSync()) {
+              // use the shared scheduler for asynchronous jobs
+              XrdSysMutexHelper sLock(gSchedulerMutex);
+              time_t storetime = 0;
+              // move job into the scheduled queue
+              job->Move(job->mActions[0].mQueue, "r", storetime);
+              job->mActions[0].mQueue = "r";
+              job->mActions[0].mTime = storetime;
+              XrdOucString tst;
+              job->mActions[0].mWhen = eos::common::StringConversion::GetSizeString(tst,
+                                       (unsigned long long) storetime);
+              gScheduler->Schedule((XrdJob*) job);
+              IncActiveJobs();
+              eos_static_info("msg=\"scheduled workflow\" job=\"%s\"",
+                              job->mDescription.c_str());
+            } else {
+              delete job;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  EXEC_TIMING_END("WFEFind");
+  eos_static_debug("msg=\"finished WFE application\" WFE-dirs=%llu",
+                   wfedirs.size());
+
+  for (const auto& wfedir : wfedirs) {
+    njobs += wfedir.second.size();
+  }
+
+  return njobs;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
  * @brief store a workflow jobs in the workflow queue
@@ -369,6 +426,31 @@ WFE::Job::Save(std::string queue, time_t& when, int action, int retry)
     return -1;
   }
 
+  if (mQueued) {
+    if (!when) {
+      when = time(nullptr);
+    }
+
+    mActions[action].mSavedOnDay = mActions[action].mDay;
+
+    // Running and finished jobs are only tracked by their claim in the queue
+    if ((queue != "q") && (queue != "e")) {
+      return SFS_OK;
+    }
+
+    WFEQueue* wfeQueue = gOFS->WFEd.GetQueue();
+    WFEQueue::Item item = ToQueueItem(queue, when, retry);
+
+    if (!wfeQueue || !wfeQueue->Enqueue(item)) {
+      eos_static_err("msg=\"failed to queue workflow job\" id=\"%s\"",
+                     item.mId.c_str());
+      return -1;
+    }
+
+    mQueueId = item.mId;
+    return SFS_OK;
+  }
+
   std::string workflowdir = gOFS->MgmProcWorkflowPath.c_str();
   workflowdir += "/";
   workflowdir += mActions[action].mDay;
@@ -552,6 +634,26 @@ WFE::Job::Move(std::string from_queue, std::string to_queue, time_t& when,
 {
   auto fromDay = mActions[0].mSavedOnDay;
 
+  if (mQueued) {
+    // Acknowledge the claim only once the job is stored in its next queue
+    const std::string claimed_id = mQueueId;
+
+    if (Save(to_queue, when, 0, retry) != SFS_OK) {
+      eos_static_err("msg=\"failed to save for move to queue\" queue=\"%s\"",
+                     to_queue.c_str());
+      return SFS_ERROR;
+    }
+
+    mActions[0].mQueue = to_queue;
+
+    if ((from_queue != to_queue) && !gOFS->WFEd.GetQueue()->Ack(claimed_id)) {
+      eos_static_err("msg=\"failed to remove for move from queue=\"%s\" to queue=\"%s\"",
+                     from_queue.c_str(), to_queue.c_str());
+    }
+
+    return SFS_OK;
+  }
+
   if (Save(to_queue, when, 0, retry) == SFS_OK) {
     mActions[0].mQueue = to_queue;
 
@@ -574,6 +676,18 @@ int
 WFE::Job::Results(std::string queue, int retc, XrdOucString log, time_t when)
 /*----------------------------------------------------------------------------*/
 {
+  if (mQueued) {
+    // Only the failed jobs are kept for inspection
+    if ((queue != "f") && (queue != "g")) {
+      return SFS_OK;
+    }
+
+    WFEQueue::Item item = ToQueueItem(queue, when, mRetry);
+    item.mId = mQueueId;
+    return gOFS->WFEd.GetQueue()->RecordFailure(item, retc, log.c_str()) ?
+           SFS_OK : -1;
+  }
+
   std::string workflowdir = gOFS->MgmProcWorkflowPath.c_str();
   workflowdir += "/";
   workflowdir += mActions[0].mDay;
@@ -671,6 +785,10 @@ WFE::Job::Delete(std::string queue, std::string fromDay)
     return SFS_ERROR;
   }
 
+  if (mQueued) {
+    return gOFS->WFEd.GetQueue()->Ack(mQueueId) ? SFS_OK : SFS_ERROR;
+  }
+
   std::string workflowdir = gOFS->MgmProcWorkflowPath.c_str();
   workflowdir += "/";
   // We have to remove from the day when it was saved
@@ -706,6 +824,65 @@ WFE::Job::Delete(std::string queue, std::string fromDay)
   }
 }
 
+//------------------------------------------------------------------------------
+// Build the QuarkDB queue item storing this job
+//------------------------------------------------------------------------------
+WFEQueue::Item
+WFE::Job::ToQueueItem(const std::string& queue, time_t when, int retry) const
+{
+  WFEQueue::Item item;
+  const std::string fxid = eos::common::FileId::Fid2Hex(mFid);
+  item.mId = std::to_string(when) + ":" + fxid + ":" + mActions[0].mEvent + ":" +
+             mActions[0].mWorkflow;
+  item.mTime = when;
+  item.mFields["fxid"] = fxid;
+  item.mFields["action"] = mActions[0].mAction;
+  item.mFields["event"] = mActions[0].mEvent;
+  item.mFields["workflow"] = mActions[0].mWorkflow;
+  item.mFields["queue"] = queue;
+  item.mFields["vid"] = eos::common::Mapping::VidToString(mVid);
+  item.mFields["retry"] = std::to_string(retry);
+  item.mFields["errmsg"] = mErrorMessage;
+  return item;
+}
+
+//------------------------------------------------------------------------------
+// Load the job from a QuarkDB queue item
+//------------------------------------------------------------------------------
+bool
+WFE::Job::FromQueueItem(const WFEQueue::Item& item)
+{
+  auto field = [&item](const char* key) -> std::string {
+    auto it = item.mFields.find(key);
+    return (it != item.mFields.end()) ? it->second : "";
+  };
+  const std::string fxid = field("fxid");
+  const std::string event = field("event");
+
+  if (fxid.empty() || event.empty() || field("action").empty()) {
+    eos_static_err("msg=\"illegal workflow queue entry\" id=\"%s\"",
+                   item.mId.c_str());
+    return false;
+  }
+
+  mFid = eos::common::FileId::Hex2Fid(fxid.c_str());
+  AddAction(field("action"), event, item.mTime, field("workflow"),
+            field("queue"));
+  const std::string vids = field("vid");
+
+  if (!eos::common::Mapping::VidFromString(mVid, vids.c_str())) {
+    eos_static_crit("parsing of %s failed - setting nobody\n", vids.c_str());
+    mVid = eos::common::VirtualIdentity::Nobody();
+  }
+
+  mRetry = (int) strtoul(field("retry").c_str(), nullptr, 10);
+  mErrorMessage = field("errmsg");
+  mQueued = true;
+  mQueueId = item.mId;
+  mWorkflowPath = item.mId;
+  return true;
+}
+
 /*----------------------------------------------------------------------------*/
 int
 WFE::Job::DoIt(bool issync, std::string& errorMsg, const char* const ininfo)
@@ -3148,6 +3325,104 @@ WFE::PublishActiveJobs()
       sactive, true);
 }
 
+//------------------------------------------------------------------------------
+// Check if the jobs are queued in QuarkDB
+//------------------------------------------------------------------------------
+bool
+WFE::UseQueue()
+{
+  eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+  return FsView::gFsView.mSpaceView.count("default") &&
+         (FsView::gFsView.mSpaceView["default"]->GetConfigMember("wfe.queue") ==
+          "qdb");
+}
+
+//------------------------------------------------------------------------------
+// Schedule the jobs of the QuarkDB queue as soon as they are due
+//------------------------------------------------------------------------------
+void
+WFE::DispatchQueue(ThreadAssistant& assistant, size_t ntx,
+                   std::chrono::seconds duration)
+{
+  // Maximum number of jobs claimed in a single transaction
+  static constexpr size_t kMaxBatch = 1000;
+  const auto deadline = std::chrono::steady_clock::now() + duration;
+
+  while (!assistant.terminationRequested()) {
+    const auto now = std::chrono::steady_clock::now();
+
+    if (now >= deadline) {
+      break;
+    }
+
+    size_t slots = kMaxBatch;
+
+    if (ntx) {
+      const size_t active = GetActiveJobs();
+      slots = (active < ntx) ? std::min(ntx - active, kMaxBatch) : 0;
+    }
+
+    // Without free slots this only waits for a job to finish
+    std::vector<WFEQueue::Item> items = mQueue->ClaimDue(slots,
+                                        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now));
+
+    if (items.size()) {
+      gOFS->MgmStats.Add("WFEDispatch", 0, 0, items.size());
+    }
+
+    for (const auto& item : items) {
+      Job* job = new Job();
+
+      if (!job->FromQueueItem(item)) {
+        mQueue->RecordFailure(item, EINVAL, "illegal workflow queue entry");
+        mQueue->Ack(item.mId);
+        delete job;
+        continue;
+      }
+
+      const time_t storetime = time(nullptr);
+      gOFS->MgmStats.AddExec("WFEDispatch",
+                             1000.0 * std::max((time_t) 0, storetime - item.mTime));
+      job->mActions[0].mQueue = "r";
+      job->mActions[0].mTime = storetime;
+      XrdOucString tst;
+      job->mActions[0].mWhen = eos::common::StringConversion::GetSizeString(tst,
+                               (unsigned long long) storetime);
+      {
+        XrdSysMutexHelper sLock(gSchedulerMutex);
+        gScheduler->Schedule((XrdJob*) job);
+      }
+      IncActiveJobs();
+      eos_static_info("msg=\"scheduled workflow\" job=\"%s\"",
+                      job->mDescription.c_str());
+    }
+
+    PublishQueueStats();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Publish the QuarkDB queue statistics in the space view
+//------------------------------------------------------------------------------
+void
+WFE::PublishQueueStats()
+{
+  const WFEQueue::Stats stats = mQueue->GetStats();
+  eos::common::RWMutexReadLock lock(FsView::gFsView.ViewMutex);
+
+  if (!FsView::gFsView.mSpaceView.count("default")) {
+    return;
+  }
+
+  auto space = FsView::gFsView.mSpaceView["default"];
+  space->SetConfigMember("stat.wfe.queued", std::to_string(stats.mPending),
+                         true);
+  space->SetConfigMember("stat.wfe.claimed", std::to_string(stats.mClaimed),
+                         true);
+  space->SetConfigMember("stat.wfe.latency",
+                         std::to_string((uint64_t) stats.mAvgLatencyMs), true);
+}
+
 IContainerMD::XAttrMap
 WFE::CollectAttributes(const std::string& fullPath)
 {
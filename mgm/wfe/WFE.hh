@@ -25,6 +25,7 @@
 #define __EOSMGM_WFE__HH__
 
 #include "mgm/Namespace.hh"
+#include "mgm/wfe/WFEQueue.hh"
 #include "common/Mapping.hh"
 #include "common/Timing.hh"
 #include "common/FileId.hh"
@@ -68,6 +69,33 @@ private:
   /// condition variable to get signalled for a done job
   XrdSysCondVar mDoneSignal;
 
+  /// job queue in QuarkDB, used instead of the proc queues if configured
+  std::unique_ptr<WFEQueue> mQueue;
+
+  // ---------------------------------------------------------------------------
+  //! Scan today's and yesterday's proc queues and schedule the due jobs
+  //!
+  //! @param ntx maximum number of active jobs, 0 for unlimited
+  //!
+  //! @return number of jobs found in the queues
+  // ---------------------------------------------------------------------------
+  size_t ScanProcQueues(size_t ntx);
+
+  // ---------------------------------------------------------------------------
+  //! Schedule the jobs of the QuarkDB queue as soon as they are due
+  //!
+  //! @param assistant thread assistant
+  //! @param ntx maximum number of active jobs, 0 for unlimited
+  //! @param duration time after which to return
+  // ---------------------------------------------------------------------------
+  void DispatchQueue(ThreadAssistant& assistant, size_t ntx,
+                     std::chrono::seconds duration);
+
+  // ---------------------------------------------------------------------------
+  //! Publish the QuarkDB queue statistics in the space view
+  // ---------------------------------------------------------------------------
+  void PublishQueueStats();
+
 public:
 
   /* Default Constructor - use it to run the WFE thread by calling Start
@@ -104,6 +132,21 @@ public:
    */
   void WFEr(ThreadAssistant& assistant) noexcept;
 
+  /**
+   * @brief get the QuarkDB job queue
+   * @return queue or nullptr if the engine was not started
+   */
+  WFEQueue* GetQueue()
+  {
+    return mQueue.get();
+  }
+
+  /**
+   * @brief check if the jobs are queued in QuarkDB (space.wfe.queue=qdb)
+   * @return true if the QuarkDB queue is configured
+   */
+  static bool UseQueue();
+
   /**
    * @brief Destructor
    *
@@ -176,6 +219,8 @@ public:
       mDescription = other.mDescription;
       mRetry = other.mRetry;
       mErrorMessage = other.mErrorMessage;
+      mQueued = other.mQueued;
+      mQueueId = other.mQueueId;
     }
     // ---------------------------------------------------------------------------
     // Job execution function
@@ -307,6 +352,17 @@ public:
 
     int Delete(std::string queue, std::string fromDay);
 
+    //! @brief build the QuarkDB queue item storing this job
+    //! @param queue queue the job is stored in ("q" or "e")
+    //! @param when time at which the job is due
+    //! @param retry number of retries
+    WFEQueue::Item ToQueueItem(const std::string& queue, time_t when,
+                               int retry) const;
+
+    //! @brief load the job from a QuarkDB queue item
+    //! @return true if the item describes a valid job
+    bool FromQueueItem(const WFEQueue::Item& item);
+
     // -------------------------------------------------------------------------
 
     void AddAction(const std::string& action,
@@ -358,6 +414,8 @@ public:
     std::string mWorkflowPath;
     std::string mErrorMessage;
     int mRetry;///! number of retries
+    bool mQueued = false; ///! job persisted in the QuarkDB queue
+    std::string mQueueId; ///! id of the job in the QuarkDB queue
 
   private:
     //! @brief moving proto wf event jobs to retry queue
@@ -407,6 +465,10 @@ public:
   {
     mActiveJobs--;
     PublishActiveJobs();
+
+    if (mQueue) {
+      mQueue->Wakeup();
+    }
   }
 
   // ---------------------------------------------------------------------------
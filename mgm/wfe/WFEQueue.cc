@@ -0,0 +1,477 @@
+//------------------------------------------------------------------------------
+//! @file WFEQueue.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/wfe/WFEQueue.hh"
+#include "common/Logging.hh"
+#include <qclient/QClient.hh>
+#include <qclient/MultiBuilder.hh>
+#include <qclient/ResponseParsing.hh>
+#include <qclient/structures/QHash.hh>
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <thread>
+
+EOSMGMNAMESPACE_BEGIN
+
+namespace
+{
+const std::string kPendingKey = "eos-wfe-queue:pending";
+const std::string kClaimedKey = "eos-wfe-queue:claimed";
+const std::string kFailedKey = "eos-wfe-queue:failed";
+//! Number of entries fetched per HSCAN
+constexpr size_t kScanCount = 10000;
+
+//------------------------------------------------------------------------------
+// Append a length-prefixed string
+//------------------------------------------------------------------------------
+void AppendString(std::string& out, const std::string& str)
+{
+  out += std::to_string(str.size());
+  out += ':';
+  out += str;
+}
+
+//------------------------------------------------------------------------------
+// Read a length-prefixed string starting at pos, advancing pos past it
+//------------------------------------------------------------------------------
+bool ReadString(const std::string& in, size_t& pos, std::string& str)
+{
+  size_t colon = in.find(':', pos);
+
+  if ((colon == std::string::npos) || (colon == pos)) {
+    return false;
+  }
+
+  char* end = nullptr;
+  unsigned long long len = std::strtoull(in.c_str() + pos, &end, 10);
+
+  if ((end != in.c_str() + colon) || (len > in.size() - colon - 1)) {
+    return false;
+  }
+
+  str.assign(in, colon + 1, len);
+  pos = colon + 1 + len;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Check that the reply is not missing or an error
+//------------------------------------------------------------------------------
+bool IsOk(const qclient::redisReplyPtr& reply)
+{
+  return reply && (reply->type != REDIS_REPLY_ERROR);
+}
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+WFEQueue::WFEQueue(const QdbContactDetails& qdb_details):
+  mQcl(std::make_unique<qclient::QClient>(qdb_details.members,
+       qdb_details.constructOptions()))
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+WFEQueue::~WFEQueue() = default;
+
+//------------------------------------------------------------------------------
+// Serialize a job as a sequence of length-prefixed strings: the due time
+// followed by the key-value pairs of the job description
+//------------------------------------------------------------------------------
+std::string
+WFEQueue::Serialize(const Item& item)
+{
+  std::string out;
+  AppendString(out, std::to_string(item.mTime));
+
+  for (const auto& field : item.mFields) {
+    AppendString(out, field.first);
+    AppendString(out, field.second);
+  }
+
+  return out;
+}
+
+//------------------------------------------------------------------------------
+// Deserialize a job
+//------------------------------------------------------------------------------
+bool
+WFEQueue::Deserialize(const std::string& id, const std::string& data,
+                      Item& item)
+{
+  size_t pos = 0;
+  std::string time;
+  std::string key;
+  std::string value;
+
+  if (!ReadString(data, pos, time)) {
+    return false;
+  }
+
+  item.mId = id;
+  item.mTime = std::strtoll(time.c_str(), nullptr, 10);
+  item.mFields.clear();
+
+  while (pos < data.size()) {
+    if (!ReadString(data, pos, key) || !ReadString(data, pos, value)) {
+      return false;
+    }
+
+    item.mFields[key] = value;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Add a job to the in-memory schedule
+//------------------------------------------------------------------------------
+void
+WFEQueue::Schedule(const Item& item)
+{
+  auto it = mItems.find(item.mId);
+
+  if (it != mItems.end()) {
+    auto range = mSchedule.equal_range(it->second.mTime);
+
+    for (auto sit = range.first; sit != range.second; ++sit) {
+      if (sit->second == item.mId) {
+        mSchedule.erase(sit);
+        break;
+      }
+    }
+
+    it->second = item;
+  } else {
+    mItems.emplace(item.mId, item);
+  }
+
+  mSchedule.emplace(item.mTime, item.mId);
+}
+
+//------------------------------------------------------------------------------
+// Recover the queue
+//------------------------------------------------------------------------------
+int64_t
+WFEQueue::Recover()
+{
+  std::vector<Item> items;
+
+  try {
+    // Jobs claimed but never acknowledged were interrupted by a restart or a
+    // master change, they have to run again
+    std::vector<std::future<qclient::redisReplyPtr>> replies;
+    qclient::QHash claimed(*mQcl, kClaimedKey);
+
+    for (auto it = claimed.getIterator(kScanCount, "0"); it.valid(); it.next()) {
+      qclient::MultiBuilder multi;
+      multi.emplace_back("HSET", kPendingKey, it.getKey(), it.getValue());
+      multi.emplace_back("HDEL", kClaimedKey, it.getKey());
+      replies.push_back(mQcl->execute(multi.getDeque()));
+    }
+
+    for (auto& reply : replies) {
+      qclient::redisReplyPtr r = reply.get();
+
+      if (!IsOk(r)) {
+        eos_static_err("msg=\"failed to requeue claimed workflow job\" reply=\"%s\"",
+                       qclient::describeRedisReply(r).c_str());
+        return -1;
+      }
+    }
+
+    qclient::QHash pending(*mQcl, kPendingKey);
+
+    for (auto it = pending.getIterator(kScanCount, "0"); it.valid(); it.next()) {
+      Item item;
+
+      if (!Deserialize(it.getKey(), it.getValue(), item)) {
+        eos_static_err("msg=\"skip malformed workflow job\" id=\"%s\"",
+                       it.getKey().c_str());
+        continue;
+      }
+
+      items.push_back(std::move(item));
+    }
+  } catch (const std::exception& e) {
+    eos_static_err("msg=\"failed to recover workflow queue\" msg=\"%s\"",
+                   e.what());
+    return -1;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSchedule.clear();
+    mItems.clear();
+
+    for (const auto& item : items) {
+      Schedule(item);
+    }
+  }
+  mClaimed = 0;
+  mCv.notify_all();
+  return items.size();
+}
+
+//------------------------------------------------------------------------------
+// Persist a job in the pending queue
+//------------------------------------------------------------------------------
+bool
+WFEQueue::Enqueue(const Item& item)
+{
+  qclient::redisReplyPtr reply = mQcl->exec("HSET", kPendingKey, item.mId,
+                                 Serialize(item)).get();
+
+  if (!IsOk(reply)) {
+    eos_static_err("msg=\"failed to enqueue workflow job\" id=\"%s\" reply=\"%s\"",
+                   item.mId.c_str(), qclient::describeRedisReply(reply).c_str());
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    Schedule(item);
+  }
+  mCv.notify_one();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Wait for due jobs and claim them
+//------------------------------------------------------------------------------
+std::vector<WFEQueue::Item>
+WFEQueue::ClaimDue(size_t max_items, std::chrono::milliseconds timeout)
+{
+  std::vector<Item> due;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (!mWakeup) {
+      const time_t now = time(nullptr);
+      auto wake_up = deadline;
+
+      if (max_items && !mSchedule.empty()) {
+        if (mSchedule.begin()->first <= now) {
+          break;
+        }
+
+        wake_up = std::min(wake_up, std::chrono::steady_clock::now() +
+                           std::chrono::seconds(mSchedule.begin()->first - now));
+      }
+
+      if ((mCv.wait_until(lock, wake_up) == std::cv_status::timeout) &&
+          (std::chrono::steady_clock::now() >= deadline)) {
+        break;
+      }
+    }
+
+    mWakeup = false;
+    const time_t now = time(nullptr);
+
+    while ((due.size() < max_items) && !mSchedule.empty() &&
+           (mSchedule.begin()->first <= now)) {
+      auto it = mItems.find(mSchedule.begin()->second);
+      due.push_back(std::move(it->second));
+      mItems.erase(it);
+      mSchedule.erase(mSchedule.begin());
+    }
+  }
+
+  if (due.empty()) {
+    return due;
+  }
+
+  return Claim(std::move(due));
+}
+
+//------------------------------------------------------------------------------
+// Claim the given jobs in QuarkDB, moving them from the pending to the
+// claimed hash in a single transaction
+//------------------------------------------------------------------------------
+std::vector<WFEQueue::Item>
+WFEQueue::Claim(std::vector<Item>&& items)
+{
+  qclient::MultiBuilder multi;
+
+  for (const auto& item : items) {
+    multi.emplace_back("HDEL", kPendingKey, item.mId);
+    multi.emplace_back("HSET", kClaimedKey, item.mId, Serialize(item));
+  }
+
+  qclient::redisReplyPtr reply = mQcl->execute(multi.getDeque()).get();
+
+  if (!reply || (reply->type != REDIS_REPLY_ARRAY) ||
+      (reply->elements != 2 * items.size())) {
+    eos_static_err("msg=\"failed to claim workflow jobs\" count=%zu reply=\"%s\"",
+                   items.size(), qclient::describeRedisReply(reply).c_str());
+    {
+      // Keep them pending and back off before the next attempt
+      std::unique_lock<std::mutex> lock(mMutex);
+
+      for (const auto& item : items) {
+        Schedule(item);
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    return {};
+  }
+
+  std::vector<Item> claimed;
+  std::vector<std::string> stale;
+  const uint64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                          (std::chrono::system_clock::now().time_since_epoch()).count();
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    redisReply* hdel = reply->element[2 * i];
+
+    // A job no longer pending has already been claimed or acknowledged, drop the
+    // claimed entry written by the transaction so that it is not run again
+    // when the queue is recovered
+    if ((hdel->type != REDIS_REPLY_INTEGER) || (hdel->integer != 1)) {
+      eos_static_warning("msg=\"workflow job already claimed\" id=\"%s\"",
+                         items[i].mId.c_str());
+      stale.push_back(items[i].mId);
+      continue;
+    }
+
+    const uint64_t due_ms = std::max((time_t) 0, items[i].mTime) * 1000ull;
+    const uint64_t latency_ms = (now_ms > due_ms) ? (now_ms - due_ms) : 0;
+    mLatencySumMs += latency_ms;
+    uint64_t max_ms = mMaxLatencyMs;
+
+    while ((latency_ms > max_ms) &&
+           !mMaxLatencyMs.compare_exchange_weak(max_ms, latency_ms)) {}
+
+    claimed.push_back(std::move(items[i]));
+  }
+
+  if (!stale.empty()) {
+    qclient::MultiBuilder drop;
+
+    for (const auto& id : stale) {
+      drop.emplace_back("HDEL", kClaimedKey, id);
+    }
+
+    reply = mQcl->execute(drop.getDeque()).get();
+
+    if (!reply || (reply->type != REDIS_REPLY_ARRAY)) {
+      eos_static_err("msg=\"failed to drop stale claimed workflow jobs\" "
+                     "count=%zu reply=\"%s\"", stale.size(),
+                     qclient::describeRedisReply(reply).c_str());
+    }
+  }
+
+  mClaimed += claimed.size();
+  mDispatched += claimed.size();
+  return claimed;
+}
+
+//------------------------------------------------------------------------------
+// Acknowledge a claimed job
+//------------------------------------------------------------------------------
+bool
+WFEQueue::Ack(const std::string& id)
+{
+  qclient::redisReplyPtr reply = mQcl->exec("HDEL", kClaimedKey, id).get();
+
+  if (!IsOk(reply)) {
+    eos_static_err("msg=\"failed to acknowledge workflow job\" id=\"%s\" "
+                   "reply=\"%s\"", id.c_str(),
+                   qclient::describeRedisReply(reply).c_str());
+    return false;
+  }
+
+  if ((reply->type == REDIS_REPLY_INTEGER) && (reply->integer == 1)) {
+    uint64_t claimed = mClaimed;
+
+    while (claimed && !mClaimed.compare_exchange_weak(claimed, claimed - 1)) {}
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Record a failed job
+//------------------------------------------------------------------------------
+bool
+WFEQueue::RecordFailure(const Item& item, int retc, const std::string& log)
+{
+  Item failed = item;
+  failed.mFields["id"] = item.mId;
+  failed.mFields["retc"] = std::to_string(retc);
+  failed.mFields["log"] = log;
+  failed.mFields["failed"] = std::to_string(time(nullptr));
+  qclient::MultiBuilder multi;
+  multi.emplace_back("deque-push-back", kFailedKey, Serialize(failed));
+  multi.emplace_back("deque-trim-front", kFailedKey, std::to_string(kMaxFailed));
+  qclient::redisReplyPtr reply = mQcl->execute(multi.getDeque()).get();
+
+  if (!reply || (reply->type != REDIS_REPLY_ARRAY)) {
+    eos_static_err("msg=\"failed to record failed workflow job\" id=\"%s\" "
+                   "reply=\"%s\"", item.mId.c_str(),
+                   qclient::describeRedisReply(reply).c_str());
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Wake up a thread waiting in ClaimDue
+//------------------------------------------------------------------------------
+void
+WFEQueue::Wakeup()
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWakeup = true;
+  }
+  mCv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Get queue statistics
+//------------------------------------------------------------------------------
+WFEQueue::Stats
+WFEQueue::GetStats() const
+{
+  Stats stats;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    stats.mPending = mItems.size();
+  }
+  stats.mClaimed = mClaimed;
+  stats.mDispatched = mDispatched;
+  stats.mMaxLatencyMs = mMaxLatencyMs;
+
+  if (stats.mDispatched) {
+    stats.mAvgLatencyMs = (double) mLatencySumMs / stats.mDispatched;
+  }
+
+  return stats;
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+//! @file WFEQueue.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "mgm/Namespace.hh"
+#include "namespace/ns_quarkdb/QdbContactDetails.hh"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace qclient
+{
+class QClient;
+}
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Workflow job queue persisted in QuarkDB
+//!
+//! Pending jobs are kept in the hash "eos-wfe-queue:pending" and, once claimed
+//! for execution, in the hash "eos-wfe-queue:claimed" until they are
+//! acknowledged. A claim moves the job between the two hashes in a single
+//! transaction, so a job is never lost nor run twice by a crashing MGM: the
+//! claimed jobs are moved back to the pending ones when the queue is
+//! recovered. The failed jobs are appended to the capped deque
+//! "eos-wfe-queue:failed" for inspection.
+//!
+//! The pending jobs are mirrored in memory and ordered by the time at which
+//! they are due, so that the dispatcher is woken up by new jobs or due times
+//! instead of listing the queue.
+//------------------------------------------------------------------------------
+class WFEQueue
+{
+public:
+  //! Description of a job as a set of key-value pairs
+  using Fields = std::map<std::string, std::string>;
+
+  //----------------------------------------------------------------------------
+  //! Job stored in the queue
+  //----------------------------------------------------------------------------
+  struct Item {
+    std::string mId; ///< unique id of the job
+    time_t mTime = 0; ///< time at which the job is due
+    Fields mFields; ///< job description
+  };
+
+  //----------------------------------------------------------------------------
+  //! Queue statistics
+  //----------------------------------------------------------------------------
+  struct Stats {
+    size_t mPending = 0; ///< jobs waiting to be claimed
+    size_t mClaimed = 0; ///< jobs claimed and not yet acknowledged
+    uint64_t mDispatched = 0; ///< jobs claimed so far
+    double mAvgLatencyMs = 0; ///< average delay between due and claim time
+    uint64_t mMaxLatencyMs = 0; ///< maximum delay between due and claim time
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param qdb_details QuarkDB cluster where the queue is stored
+  //----------------------------------------------------------------------------
+  WFEQueue(const QdbContactDetails& qdb_details);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~WFEQueue();
+
+  //----------------------------------------------------------------------------
+  //! Move the claimed jobs back to the pending ones and reload the pending
+  //! jobs in memory. To be called before dispatching, e.g. after a restart or
+  //! a master change.
+  //!
+  //! @return number of pending jobs, -1 if the queue could not be read
+  //----------------------------------------------------------------------------
+  int64_t Recover();
+
+  //----------------------------------------------------------------------------
+  //! Persist a job in the pending queue
+  //!
+  //! @param item job to enqueue, replacing any pending job with the same id
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool Enqueue(const Item& item);
+
+  //----------------------------------------------------------------------------
+  //! Wait for due jobs and claim them
+  //!
+  //! @param max_items maximum number of jobs to claim, if 0 only wait to be
+  //!        woken up
+  //! @param timeout maximum time to wait for due jobs
+  //!
+  //! @return claimed jobs ordered by due time, possibly empty if the timeout
+  //!         expired or if Wakeup was called
+  //----------------------------------------------------------------------------
+  std::vector<Item> ClaimDue(size_t max_items,
+                             std::chrono::milliseconds timeout);
+
+  //----------------------------------------------------------------------------
+  //! Acknowledge a claimed job, removing it from the queue
+  //!
+  //! @param id job id
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool Ack(const std::string& id);
+
+  //----------------------------------------------------------------------------
+  //! Record a failed job
+  //!
+  //! @param item failed job
+  //! @param retc return code of the job
+  //! @param log message describing the failure
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool RecordFailure(const Item& item, int retc, const std::string& log);
+
+  //----------------------------------------------------------------------------
+  //! Wake up a thread waiting in ClaimDue
+  //----------------------------------------------------------------------------
+  void Wakeup();
+
+  //----------------------------------------------------------------------------
+  //! Get queue statistics
+  //----------------------------------------------------------------------------
+  Stats GetStats() const;
+
+  //----------------------------------------------------------------------------
+  //! Serialize/deserialize a job to/from its stored representation
+  //----------------------------------------------------------------------------
+  static std::string Serialize(const Item& item);
+  static bool Deserialize(const std::string& id, const std::string& data,
+                          Item& item);
+
+  //! Maximum number of failed jobs kept
+  static constexpr uint64_t kMaxFailed = 100000;
+
+private:
+  std::unique_ptr<qclient::QClient> mQcl;
+  //! Mutex protecting the in-memory schedule
+  mutable std::mutex mMutex;
+  //! Condition variable signalling new jobs or a wake up request
+  std::condition_variable mCv;
+  //! Flag set by Wakeup
+  bool mWakeup = false;
+  //! Pending job ids ordered by due time
+  std::multimap<time_t, std::string> mSchedule;
+  //! Pending jobs by id
+  std::unordered_map<std::string, Item> mItems;
+  std::atomic<uint64_t> mClaimed {0};
+  std::atomic<uint64_t> mDispatched {0};
+  std::atomic<uint64_t> mLatencySumMs {0};
+  std::atomic<uint64_t> mMaxLatencyMs {0};
+
+  //----------------------------------------------------------------------------
+  //! Add a job to the in-memory schedule, caller must hold mMutex
+  //----------------------------------------------------------------------------
+  void Schedule(const Item& item);
+
+  //----------------------------------------------------------------------------
+  //! Claim the given jobs in QuarkDB
+  //!
+  //! @return jobs which were successfully claimed
+  //----------------------------------------------------------------------------
+  std::vector<Item> Claim(std::vector<Item>&& items);
+};
+
+EOSMGMNAMESPACE_END
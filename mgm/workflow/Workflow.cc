@@ -237,6 +237,7 @@ Workflow::ExceptionThrowingCreate(eos::common::VirtualIdentity& vid,
   } else {
     if (WfeRecordingEnabled()) {
       job.AddAction(mAction, mEvent, t, mWorkflow, "q");
+      job.mQueued = WFE::UseQueue() && gOFS->WFEd.GetQueue();
       retc = job.Save("q", t);
 
       if (retc) {
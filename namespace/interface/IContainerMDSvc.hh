@@ -30,6 +30,7 @@
 #include "namespace/MDLocking.hh"
 #include <map>
 #include <string>
+#include <vector>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -185,6 +186,21 @@ public:
   //----------------------------------------------------------------------------
   virtual void blacklistBelow(ContainerIdentifier id) = 0;
 
+  //----------------------------------------------------------------------------
+  //! Persist the ids of the most recently used cached containers, so that
+  //! the next boot can warm up the cache with them
+  //!
+  //! @param max_num maximum number of ids to persist
+  //!
+  //! @return number of ids persisted
+  //----------------------------------------------------------------------------
+  virtual uint64_t saveHotSet(uint64_t max_num) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Load the ids persisted by saveHotSet, hottest first
+  //----------------------------------------------------------------------------
+  virtual std::vector<IContainerMD::id_t> loadHotSet() = 0;
+
 };
 
 EOSNSNAMESPACE_END
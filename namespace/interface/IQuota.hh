@@ -37,6 +37,70 @@ EOSNSNAMESPACE_BEGIN
 //! Forward declarations
 class IQuotaStats;
 
+//------------------------------------------------------------------------------
+//! Receives the quota updates applied to a quota node while it is being
+//! recomputed, so that the result can be reconciled with them
+//------------------------------------------------------------------------------
+class IQuotaUpdateListener
+{
+public:
+  virtual ~IQuotaUpdateListener() = default;
+
+  //----------------------------------------------------------------------------
+  //! Called for every file added to or removed from the quota node
+  //!
+  //! @param cont_id id of the container holding the file
+  //! @param uid file owner
+  //! @param gid file group
+  //! @param size signed change of the logical size
+  //! @param physical_size signed change of the physical size
+  //! @param files signed change of the number of files
+  //----------------------------------------------------------------------------
+  virtual void quotaUpdated(IContainerMD::id_t cont_id, uid_t uid, gid_t gid,
+                            int64_t size, int64_t physical_size,
+                            int64_t files) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Called when updates which can not be attributed to a container were
+  //! applied to the quota node e.g. a sub-quota node got melded in
+  //----------------------------------------------------------------------------
+  virtual void quotaReset() = 0;
+};
+
+//------------------------------------------------------------------------------
+//! Receives every file accounted to or out of any quota node, together with
+//! the file metadata as seen by the quota node
+//------------------------------------------------------------------------------
+class IQuotaFileListener
+{
+public:
+  virtual ~IQuotaFileListener() = default;
+
+  //----------------------------------------------------------------------------
+  //! Called for every file added to or removed from a quota node
+  //!
+  //! @param node_id quota node id
+  //! @param file file metadata
+  //! @param sign 1 if the file was added, -1 if it was removed
+  //----------------------------------------------------------------------------
+  virtual void fileAccounted(IContainerMD::id_t node_id, const IFileMD* file,
+                             int64_t sign) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Called when a quota node got melded into another one
+  //!
+  //! @param node_id id of the quota node receiving the contents
+  //! @param from_id id of the quota node melded in
+  //----------------------------------------------------------------------------
+  virtual void nodeMelded(IContainerMD::id_t node_id,
+                          IContainerMD::id_t from_id) {}
+
+  //----------------------------------------------------------------------------
+  //! Called when a quota node is removed
+  //----------------------------------------------------------------------------
+  virtual void nodeRemoved(IContainerMD::id_t node_id) {}
+};
+
 //------------------------------------------------------------------------------
 //! Placeholder for space occupancy statistics of an accounting node
 //------------------------------------------------------------------------------
@@ -169,6 +233,14 @@ public:
   //----------------------------------------------------------------------------
   virtual void updateCore(const QuotaNodeCore &updated) = 0;
 
+  //----------------------------------------------------------------------------
+  //! Attach a listener receiving all updates of the quota node or detach it
+  //! by passing nullptr. Ignored by the implementations which can not be
+  //! recomputed.
+  //----------------------------------------------------------------------------
+  virtual void setUpdateListener(std::shared_ptr<IQuotaUpdateListener>
+                                 listener) {}
+
 protected:
   IQuotaStats* pQuotaStats;
   IContainerMD::id_t pContainerId; ///< Id of the corresponding container
@@ -250,8 +322,44 @@ public:
     return (*pSizeMapper)(file);
   }
 
+  //----------------------------------------------------------------------------
+  //! Attach a listener receiving the files accounted by all the quota nodes
+  //! or detach it by passing nullptr
+  //----------------------------------------------------------------------------
+  void setFileListener(std::shared_ptr<IQuotaFileListener> listener)
+  {
+    std::atomic_store(&pFileListener, std::move(listener));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Forward the notifications of the quota nodes to the file listener
+  //----------------------------------------------------------------------------
+  void notifyFileAccounted(IContainerMD::id_t node_id, const IFileMD* file,
+                           int64_t sign)
+  {
+    if (auto listener = std::atomic_load(&pFileListener)) {
+      listener->fileAccounted(node_id, file, sign);
+    }
+  }
+
+  void notifyNodeMelded(IContainerMD::id_t node_id,
+                        IContainerMD::id_t from_id)
+  {
+    if (auto listener = std::atomic_load(&pFileListener)) {
+      listener->nodeMelded(node_id, from_id);
+    }
+  }
+
+  void notifyNodeRemoved(IContainerMD::id_t node_id)
+  {
+    if (auto listener = std::atomic_load(&pFileListener)) {
+      listener->nodeRemoved(node_id);
+    }
+  }
+
 protected:
   SizeMapper pSizeMapper;
+  std::shared_ptr<IQuotaFileListener> pFileListener;
 };
 
 EOSNSNAMESPACE_END
@@ -69,6 +69,9 @@ static const std::string sCacheInvalidationFidChannel {"eos-md-cache-invalidatio
 //! Channel for incoming cid cache invalidation notifications
 static const std::string sCacheInvalidationCidChannel {"eos-md-cache-invalidation-cid"};
 
+//! Key holding the ids of the hot containers saved for the next boot
+static const std::string sHotContainersKey {"eos-hot-containers"};
+
 //! Configuration key to trigger a refresh of the inode provider
 static const std::string sKeyInodeRefresh {"qdb_inode_refresh"};
 }
@@ -30,11 +30,13 @@
 #include "common/Murmur3.hh"
 #include "namespace/Namespace.hh"
 #include <google/dense_hash_map>
+#include <algorithm>
 #include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -160,6 +162,15 @@ public:
     }
   }
 
+  //----------------------------------------------------------------------------
+  //! Get the ids of the most recently used entries
+  //!
+  //! @param max_num maximum number of ids to return
+  //!
+  //! @return ids ordered from the most to the least recently used
+  //----------------------------------------------------------------------------
+  std::vector<IdT> GetMostRecent(std::uint64_t max_num) const;
+
   //----------------------------------------------------------------------------
   //! Get number of requests towards the cache
   //----------------------------------------------------------------------------
@@ -324,6 +335,25 @@ LRU<IdT, EntryT>::remove(IdT id)
   return true;
 }
 
+//------------------------------------------------------------------------------
+// Get the ids of the most recently used entries
+//------------------------------------------------------------------------------
+template <typename IdT, typename EntryT>
+std::vector<IdT>
+LRU<IdT, EntryT>::GetMostRecent(std::uint64_t max_num) const
+{
+  std::vector<IdT> ids;
+  std::unique_lock<std::mutex> lock(mMutex);
+  ids.reserve(std::min<std::uint64_t>(max_num, mMap.size()));
+
+  for (auto it = mList.rbegin();
+       (it != mList.rend()) && (ids.size() < max_num); ++it) {
+    ids.emplace_back((*it)->getId());
+  }
+
+  return ids;
+}
+
 //----------------------------------------------------------------------------
 // Cleaner job taking care of deallocating entries that are passed through
 // the queue to delete
@@ -0,0 +1,514 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Mergeable statistical sketches of the files of the quota nodes
+//------------------------------------------------------------------------------
+
+#include "namespace/ns_quarkdb/accounting/NamespaceSketch.hh"
+#include "common/LayoutId.hh"
+#include "common/Murmur3.hh"
+#include <cmath>
+
+EOSNSNAMESPACE_BEGIN
+
+using eos::common::LatencyHistogram;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Get the creation time bucket, rounding towards minus infinity
+//------------------------------------------------------------------------------
+int64_t
+CtimeBucket(int64_t ctime)
+{
+  const int64_t res = NamespaceSketch::sCtimeResolution;
+  return (ctime >= 0) ? (ctime / res) : -((res - 1 - ctime) / res);
+}
+
+//------------------------------------------------------------------------------
+// Get the rank of the given percentile out of total entries
+//------------------------------------------------------------------------------
+uint64_t
+PercentileRank(uint64_t total, double percentile)
+{
+  if (percentile < 0.0) {
+    percentile = 0.0;
+  } else if (percentile > 100.0) {
+    percentile = 100.0;
+  }
+
+  const uint64_t rank = (uint64_t) std::ceil(total * percentile / 100.0);
+  return rank ? rank : 1;
+}
+}
+
+//------------------------------------------------------------------------------
+// *** Class NamespaceSketch implementation ***
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Account a file
+//------------------------------------------------------------------------------
+void
+NamespaceSketch::update(uint64_t size, int64_t ctime, uint32_t stripes,
+                        uint64_t uid, int64_t weight)
+{
+  mSizes[LatencyHistogram::GetBucketIndex(size)] += weight;
+  mCtimes[CtimeBucket(ctime)] += weight;
+  mStripes[(stripes < sMaxStripes) ? stripes : sMaxStripes] += weight;
+  mFiles += weight;
+  mBytes += weight * (int64_t) size;
+
+  if (weight > 0) {
+    mUids.Add(uid);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Merge the contents of another sketch into the current one
+//------------------------------------------------------------------------------
+void
+NamespaceSketch::merge(const NamespaceSketch& other)
+{
+  for (size_t i = 0; i < mSizes.size(); ++i) {
+    mSizes[i] += other.mSizes[i];
+  }
+
+  for (const auto& elem : other.mCtimes) {
+    mCtimes[elem.first] += elem.second;
+  }
+
+  for (size_t i = 0; i < mStripes.size(); ++i) {
+    mStripes[i] += other.mStripes[i];
+  }
+
+  mUids.Merge(other.mUids);
+  mFiles += other.mFiles;
+  mBytes += other.mBytes;
+}
+
+//------------------------------------------------------------------------------
+// Get the file size below which the given percentage of the files fall
+//------------------------------------------------------------------------------
+uint64_t
+NamespaceSketch::getSizePercentile(double percentile) const
+{
+  const uint64_t total = getFiles();
+
+  if (total == 0) {
+    return 0;
+  }
+
+  const uint64_t rank = PercentileRank(total, percentile);
+  uint64_t seen = 0;
+
+  for (size_t i = 0; i < mSizes.size(); ++i) {
+    if (mSizes[i] > 0) {
+      seen += mSizes[i];
+    }
+
+    if (seen >= rank) {
+      return LatencyHistogram::GetBucketUpperBound(i);
+    }
+  }
+
+  return LatencyHistogram::GetBucketUpperBound(mSizes.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+// Get the age below which the given percentage of the files fall
+//------------------------------------------------------------------------------
+uint64_t
+NamespaceSketch::getAgePercentile(double percentile, time_t now) const
+{
+  const uint64_t total = getFiles();
+
+  if (total == 0) {
+    return 0;
+  }
+
+  const uint64_t rank = PercentileRank(total, percentile);
+  uint64_t seen = 0;
+  int64_t oldest = now;
+
+  // Youngest files first
+  for (auto it = mCtimes.rbegin(); it != mCtimes.rend(); ++it) {
+    if (it->second <= 0) {
+      continue;
+    }
+
+    seen += it->second;
+    oldest = it->first * sCtimeResolution;
+
+    if (seen >= rank) {
+      break;
+    }
+  }
+
+  return (now > oldest) ? (now - oldest) : 0;
+}
+
+//------------------------------------------------------------------------------
+// Get the sum of the ages of all the files
+//------------------------------------------------------------------------------
+double
+NamespaceSketch::getAgeSum(time_t now) const
+{
+  double sum = 0;
+
+  for (const auto& elem : mCtimes) {
+    const int64_t start = elem.first * sCtimeResolution;
+
+    if ((elem.second > 0) && (now > start)) {
+      sum += (double) elem.second * (now - start);
+    }
+  }
+
+  return sum;
+}
+
+//------------------------------------------------------------------------------
+// Get average number of stripes per file
+//------------------------------------------------------------------------------
+double
+NamespaceSketch::getMeanStripes() const
+{
+  double sum = 0;
+  double count = 0;
+
+  for (size_t i = 0; i < mStripes.size(); ++i) {
+    if (mStripes[i] > 0) {
+      sum += (double) i * mStripes[i];
+      count += mStripes[i];
+    }
+  }
+
+  return (count > 0) ? sum / count : 0.0;
+}
+
+//------------------------------------------------------------------------------
+// Get the cumulative number of files with size up to each of the bounds
+//------------------------------------------------------------------------------
+std::vector<uint64_t>
+NamespaceSketch::getSizeCumulative(const std::vector<uint64_t>& bounds) const
+{
+  std::vector<uint64_t> result;
+  result.reserve(bounds.size());
+  uint64_t seen = 0;
+  size_t index = 0;
+
+  for (const auto bound : bounds) {
+    const size_t last = LatencyHistogram::GetBucketIndex(bound);
+
+    for (; index <= last; ++index) {
+      if (mSizes[index] > 0) {
+        seen += mSizes[index];
+      }
+    }
+
+    result.push_back(seen);
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Get the cumulative number of files with age up to each of the bounds
+//------------------------------------------------------------------------------
+std::vector<uint64_t>
+NamespaceSketch::getAgeCumulative(const std::vector<uint64_t>& bounds,
+                                  time_t now) const
+{
+  std::vector<uint64_t> result;
+  result.reserve(bounds.size());
+  uint64_t seen = 0;
+  auto it = mCtimes.rbegin();
+
+  for (const auto bound : bounds) {
+    const int64_t first = CtimeBucket(now - (int64_t) bound);
+
+    for (; (it != mCtimes.rend()) && (it->first >= first); ++it) {
+      if (it->second > 0) {
+        seen += it->second;
+      }
+    }
+
+    result.push_back(seen);
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Get number of files per stripe count
+//------------------------------------------------------------------------------
+std::array<uint64_t, NamespaceSketch::sMaxStripes + 1>
+NamespaceSketch::getStripeHistogram() const
+{
+  std::array<uint64_t, sMaxStripes + 1> result {};
+
+  for (size_t i = 0; i < mStripes.size(); ++i) {
+    result[i] = (mStripes[i] > 0) ? mStripes[i] : 0;
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// *** Class NamespaceSketchAccounting implementation ***
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+NamespaceSketchAccounting::NamespaceSketchAccounting(uint64_t sample_rate):
+  mSampleRate(sample_rate ? sample_rate : 1)
+{}
+
+//------------------------------------------------------------------------------
+// Check if the given file is sampled
+//------------------------------------------------------------------------------
+bool
+NamespaceSketchAccounting::isSampled(IFileMD::id_t fid, uint64_t sample_rate)
+{
+  if (sample_rate <= 1) {
+    return true;
+  }
+
+  return (Murmur3::MurmurHasher<uint64_t>()(fid) % sample_rate) == 0;
+}
+
+//------------------------------------------------------------------------------
+// Get number of stripes of the given layout
+//------------------------------------------------------------------------------
+uint32_t
+NamespaceSketchAccounting::getStripes(IFileMD::layoutId_t layout_id)
+{
+  return eos::common::LayoutId::GetStripeNumber(layout_id) + 1;
+}
+
+//------------------------------------------------------------------------------
+// Account a file added to or removed from a quota node
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::fileAccounted(IContainerMD::id_t node_id,
+    const IFileMD* file, int64_t sign)
+{
+  ++mUpdates;
+
+  if (!isSampled(file->getId(), mSampleRate)) {
+    return;
+  }
+
+  IFileMD::ctime_t ctime;
+  file->getCTime(ctime);
+  account(node_id, file->getId(), file->getSize(), ctime.tv_sec,
+          getStripes(file->getLayoutId()), file->getCUid(), sign);
+}
+
+//------------------------------------------------------------------------------
+// Account a file directly
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::account(IContainerMD::id_t node_id,
+                                   IFileMD::id_t fid, uint64_t size,
+                                   int64_t ctime, uint32_t stripes,
+                                   uint64_t uid, int64_t sign)
+{
+  const uint64_t rate = mSampleRate;
+
+  if (!isSampled(fid, rate)) {
+    return;
+  }
+
+  const int64_t weight = sign * (int64_t) rate;
+  std::lock_guard<std::mutex> lock(mMutex);
+  mSketches[node_id].update(size, ctime, stripes, uid, weight);
+
+  if (mRebuilding) {
+    mDelta[node_id].update(size, ctime, stripes, uid, weight);
+  }
+
+  ++mSampled;
+}
+
+//------------------------------------------------------------------------------
+// Merge the sketch of a quota node into another one
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::nodeMelded(IContainerMD::id_t node_id,
+                                      IContainerMD::id_t from_id)
+{
+  if (node_id == from_id) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  for (auto* sketches : {
+         &mSketches, &mRebuilt, &mDelta
+       }) {
+    auto it = sketches->find(from_id);
+
+    if (it != sketches->end()) {
+      (*sketches)[node_id].merge(it->second);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Drop the sketch of a removed quota node
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::nodeRemoved(IContainerMD::id_t node_id)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mSketches.erase(node_id);
+  mRebuilt.erase(node_id);
+  mDelta.erase(node_id);
+}
+
+//------------------------------------------------------------------------------
+// Change the sample rate
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::setSampleRate(uint64_t sample_rate)
+{
+  if (sample_rate == 0) {
+    sample_rate = 1;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (sample_rate == mSampleRate) {
+    return;
+  }
+
+  // Sketches built with different rates can not be combined, start over
+  mSampleRate = sample_rate;
+  mSketches.clear();
+  mRebuilt.clear();
+  mDelta.clear();
+  mRebuilding = false;
+}
+
+//------------------------------------------------------------------------------
+// Drop all the sketches
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::reset()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mSketches.clear();
+  mRebuilt.clear();
+  mDelta.clear();
+  mRebuilding = false;
+}
+
+//------------------------------------------------------------------------------
+// Start rebuilding the sketches from a full scan
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::beginRebuild()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mRebuilt.clear();
+  mDelta.clear();
+  mRebuilding = true;
+}
+
+//------------------------------------------------------------------------------
+// Account a file found by the rebuild scan
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::rebuildFile(IContainerMD::id_t node_id,
+                                       IFileMD::id_t fid, uint64_t size,
+                                       int64_t ctime, uint32_t stripes,
+                                       uint64_t uid)
+{
+  const uint64_t rate = mSampleRate;
+
+  if (!mRebuilding || !isSampled(fid, rate)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (mRebuilding) {
+    mRebuilt[node_id].update(size, ctime, stripes, uid, (int64_t) rate);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Replace the sketches with the rebuilt ones or drop the rebuilt ones
+//------------------------------------------------------------------------------
+void
+NamespaceSketchAccounting::endRebuild(bool commit)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (!mRebuilding) {
+    return;
+  }
+
+  if (commit) {
+    for (const auto& elem : mDelta) {
+      mRebuilt[elem.first].merge(elem.second);
+    }
+
+    mSketches.swap(mRebuilt);
+    ++mRebuilds;
+    mLastRebuildTs = time(nullptr);
+  }
+
+  mRebuilt.clear();
+  mDelta.clear();
+  mRebuilding = false;
+}
+
+//------------------------------------------------------------------------------
+// Get a copy of the sketch of the given quota node
+//------------------------------------------------------------------------------
+bool
+NamespaceSketchAccounting::getSketch(IContainerMD::id_t node_id,
+                                     NamespaceSketch& sketch) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto it = mSketches.find(node_id);
+
+  if (it == mSketches.end()) {
+    return false;
+  }
+
+  sketch = it->second;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get a copy of all the sketches
+//------------------------------------------------------------------------------
+std::map<IContainerMD::id_t, NamespaceSketch>
+NamespaceSketchAccounting::getSketches() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mSketches;
+}
+
+EOSNSNAMESPACE_END
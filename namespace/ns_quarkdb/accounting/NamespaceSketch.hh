@@ -0,0 +1,296 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Mergeable statistical sketches of the files of the quota nodes
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "namespace/interface/IQuota.hh"
+#include "common/HyperLogLog.hh"
+#include "common/LatencyHistogram.hh"
+#include <array>
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Distribution of the files of a quota node: log-linear histogram of the
+//! file sizes, histogram of the creation time with one day resolution,
+//! histogram of the number of stripes from the layout and a HyperLogLog of
+//! the owners.
+//!
+//! All the histograms accept signed updates so that files can be removed.
+//! Counts are weighted by the caller e.g. by the sampling rate, therefore
+//! every query returns an estimate of the full population. Not thread-safe.
+//------------------------------------------------------------------------------
+class NamespaceSketch
+{
+public:
+  //! Stripe counts above this value are accounted in the last bucket
+  static constexpr uint32_t sMaxStripes = 32;
+  //! Resolution of the creation time histogram
+  static constexpr int64_t sCtimeResolution = 86400;
+
+  //----------------------------------------------------------------------------
+  //! Account a file
+  //!
+  //! @param size logical size
+  //! @param ctime creation time in seconds
+  //! @param stripes number of stripes/replicas of the layout
+  //! @param uid owner
+  //! @param weight signed number of files represented by this one
+  //----------------------------------------------------------------------------
+  void update(uint64_t size, int64_t ctime, uint32_t stripes, uint64_t uid,
+              int64_t weight);
+
+  //----------------------------------------------------------------------------
+  //! Merge the contents of another sketch into the current one
+  //----------------------------------------------------------------------------
+  void merge(const NamespaceSketch& other);
+
+  //----------------------------------------------------------------------------
+  //! Get estimated number of files
+  //----------------------------------------------------------------------------
+  inline uint64_t getFiles() const
+  {
+    return (mFiles > 0) ? mFiles : 0;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get estimated logical size of all the files
+  //----------------------------------------------------------------------------
+  inline uint64_t getBytes() const
+  {
+    return (mBytes > 0) ? mBytes : 0;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get estimated number of distinct owners. Owners of files removed since
+  //! the sketch was built are still counted.
+  //----------------------------------------------------------------------------
+  inline uint64_t getUids() const
+  {
+    return mUids.Estimate();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the file size below which the given percentage of the files fall
+  //!
+  //! @param percentile value in the range [0, 100]
+  //!
+  //! @return upper bound of the matching bucket, 0 if there are no files
+  //----------------------------------------------------------------------------
+  uint64_t getSizePercentile(double percentile) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the age in seconds below which the given percentage of the files
+  //! fall
+  //!
+  //! @param percentile value in the range [0, 100]
+  //! @param now reference time
+  //----------------------------------------------------------------------------
+  uint64_t getAgePercentile(double percentile, time_t now) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the sum of the ages of all the files in seconds
+  //----------------------------------------------------------------------------
+  double getAgeSum(time_t now) const;
+
+  //----------------------------------------------------------------------------
+  //! Get average number of stripes per file
+  //----------------------------------------------------------------------------
+  double getMeanStripes() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the cumulative number of files with size up to each of the given
+  //! bounds, the precision is the one of the size buckets
+  //----------------------------------------------------------------------------
+  std::vector<uint64_t>
+  getSizeCumulative(const std::vector<uint64_t>& bounds) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the cumulative number of files with age up to each of the given
+  //! bounds in seconds
+  //----------------------------------------------------------------------------
+  std::vector<uint64_t>
+  getAgeCumulative(const std::vector<uint64_t>& bounds, time_t now) const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of files per stripe count, the last entry holds the files
+  //! with at least sMaxStripes stripes
+  //----------------------------------------------------------------------------
+  std::array<uint64_t, sMaxStripes + 1> getStripeHistogram() const;
+
+private:
+  std::array<int64_t, eos::common::LatencyHistogram::sNumBuckets> mSizes {};
+  std::map<int64_t, int64_t> mCtimes; ///< Day since epoch to file count
+  std::array<int64_t, sMaxStripes + 1> mStripes {};
+  eos::common::HyperLogLog mUids;
+  int64_t mFiles {0};
+  int64_t mBytes {0};
+};
+
+//------------------------------------------------------------------------------
+//! Maintain a NamespaceSketch per quota node from the quota updates.
+//!
+//! Only the files whose id hashes into 1 out of sample rate buckets are
+//! accounted, with a weight equal to the sample rate. The selection is
+//! deterministic so a file is accounted by both its addition and removal.
+//!
+//! The sketches do not know about the files accounted before the listener
+//! was attached and the owner sketches can not forget removed files, so they
+//! are periodically rebuilt from a full scan: between beginRebuild() and
+//! endRebuild(true) the scanned files are accounted into new sketches and
+//! the live updates are recorded on the side, then the sum of both replaces
+//! the current sketches. Files changed while the scan runs may be counted
+//! twice or not at all, which bounds the error by the churn during the scan.
+//------------------------------------------------------------------------------
+class NamespaceSketchAccounting: public IQuotaFileListener
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param sample_rate account 1 out of sample_rate files
+  //----------------------------------------------------------------------------
+  explicit NamespaceSketchAccounting(uint64_t sample_rate = 1);
+
+  //----------------------------------------------------------------------------
+  //! Check if the given file is sampled
+  //----------------------------------------------------------------------------
+  static bool isSampled(IFileMD::id_t fid, uint64_t sample_rate);
+
+  //----------------------------------------------------------------------------
+  //! Get number of stripes of the given layout
+  //----------------------------------------------------------------------------
+  static uint32_t getStripes(IFileMD::layoutId_t layout_id);
+
+  //----------------------------------------------------------------------------
+  //! IQuotaFileListener interface
+  //----------------------------------------------------------------------------
+  void fileAccounted(IContainerMD::id_t node_id, const IFileMD* file,
+                     int64_t sign) override;
+  void nodeMelded(IContainerMD::id_t node_id,
+                  IContainerMD::id_t from_id) override;
+  void nodeRemoved(IContainerMD::id_t node_id) override;
+
+  //----------------------------------------------------------------------------
+  //! Account a file directly, used for the files without metadata object
+  //----------------------------------------------------------------------------
+  void account(IContainerMD::id_t node_id, IFileMD::id_t fid, uint64_t size,
+               int64_t ctime, uint32_t stripes, uint64_t uid, int64_t sign);
+
+  //----------------------------------------------------------------------------
+  //! Change the sample rate, drops all the sketches
+  //----------------------------------------------------------------------------
+  void setSampleRate(uint64_t sample_rate);
+
+  //----------------------------------------------------------------------------
+  //! Get the sample rate
+  //----------------------------------------------------------------------------
+  inline uint64_t getSampleRate() const
+  {
+    return mSampleRate.load();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Drop all the sketches
+  //----------------------------------------------------------------------------
+  void reset();
+
+  //----------------------------------------------------------------------------
+  //! Start rebuilding the sketches from a full scan
+  //----------------------------------------------------------------------------
+  void beginRebuild();
+
+  //----------------------------------------------------------------------------
+  //! Account a file found by the rebuild scan
+  //----------------------------------------------------------------------------
+  void rebuildFile(IContainerMD::id_t node_id, IFileMD::id_t fid,
+                   uint64_t size, int64_t ctime, uint32_t stripes,
+                   uint64_t uid);
+
+  //----------------------------------------------------------------------------
+  //! Replace the sketches with the rebuilt ones or drop the rebuilt ones
+  //!
+  //! @param commit if true install the rebuilt sketches
+  //----------------------------------------------------------------------------
+  void endRebuild(bool commit);
+
+  //----------------------------------------------------------------------------
+  //! Get a copy of the sketch of the given quota node
+  //!
+  //! @return false if there is no sketch for the node
+  //----------------------------------------------------------------------------
+  bool getSketch(IContainerMD::id_t node_id, NamespaceSketch& sketch) const;
+
+  //----------------------------------------------------------------------------
+  //! Get a copy of all the sketches
+  //----------------------------------------------------------------------------
+  std::map<IContainerMD::id_t, NamespaceSketch> getSketches() const;
+
+  //----------------------------------------------------------------------------
+  //! Statistics of the accounting itself
+  //----------------------------------------------------------------------------
+  inline uint64_t getNumUpdates() const
+  {
+    return mUpdates.load();
+  }
+
+  inline uint64_t getNumSampled() const
+  {
+    return mSampled.load();
+  }
+
+  inline uint64_t getNumRebuilds() const
+  {
+    return mRebuilds.load();
+  }
+
+  inline time_t getLastRebuildTs() const
+  {
+    return mLastRebuildTs.load();
+  }
+
+  inline bool isRebuilding() const
+  {
+    return mRebuilding.load();
+  }
+
+private:
+  std::atomic<uint64_t> mSampleRate;
+  mutable std::mutex mMutex;
+  std::map<IContainerMD::id_t, NamespaceSketch> mSketches;
+  //! Sketches being rebuilt and live updates received in the meantime
+  std::map<IContainerMD::id_t, NamespaceSketch> mRebuilt;
+  std::map<IContainerMD::id_t, NamespaceSketch> mDelta;
+  std::atomic<bool> mRebuilding {false};
+  std::atomic<uint64_t> mUpdates {0};
+  std::atomic<uint64_t> mSampled {0};
+  std::atomic<uint64_t> mRebuilds {0};
+  std::atomic<time_t> mLastRebuildTs {0};
+};
+
+EOSNSNAMESPACE_END
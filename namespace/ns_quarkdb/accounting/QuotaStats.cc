@@ -76,6 +76,8 @@ QuarkQuotaNode::addFile(const IFileMD* file)
     file->getSize(),
     size
   );
+  notifyListener(file, 1, size);
+  pQuotaStats->notifyFileAccounted(pContainerId, file, 1);
 }
 
 //------------------------------------------------------------------------------
@@ -105,6 +107,8 @@ QuarkQuotaNode::removeFile(const IFileMD* file)
     file->getSize(),
     size
   );
+  notifyListener(file, -1, size);
+  pQuotaStats->notifyFileAccounted(pContainerId, file, -1);
 }
 
 //------------------------------------------------------------------------------
@@ -146,6 +150,48 @@ QuarkQuotaNode::meld(const IQuotaNode* node)
 
   // Update the cached information
   pCore.meld(node->getCore());
+  pQuotaStats->notifyNodeMelded(pContainerId, node->getId());
+
+  if (mHasListener) {
+    std::lock_guard<std::mutex> lock(mListenerMutex);
+
+    if (mListener) {
+      mListener->quotaReset();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Attach or detach the listener receiving all quota updates
+//------------------------------------------------------------------------------
+void
+QuarkQuotaNode::setUpdateListener(std::shared_ptr<IQuotaUpdateListener>
+                                  listener)
+{
+  std::lock_guard<std::mutex> lock(mListenerMutex);
+  mListener = std::move(listener);
+  mHasListener = (mListener != nullptr);
+}
+
+//------------------------------------------------------------------------------
+// Forward a quota update to the listener, if any
+//------------------------------------------------------------------------------
+void
+QuarkQuotaNode::notifyListener(const IFileMD* file, int64_t sign,
+                               int64_t physical_size)
+{
+  if (!mHasListener) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mListenerMutex);
+
+  if (mListener) {
+    mListener->quotaUpdated(file->getContainerId(), file->getCUid(),
+                            file->getCGid(),
+                            sign * static_cast<int64_t>(file->getSize()),
+                            sign * physical_size, sign);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -416,6 +462,7 @@ QuarkQuotaStats::removeNode(IContainerMD::id_t node_id)
   std::string snode_id = std::to_string(node_id);
   pFlusher->del(KeyQuotaUidMap(snode_id));
   pFlusher->del(KeyQuotaGidMap(snode_id));
+  notifyNodeRemoved(node_id);
 }
 
 //------------------------------------------------------------------------------
@@ -24,6 +24,8 @@
 #pragma once
 #include "namespace/Namespace.hh"
 #include "namespace/interface/IQuota.hh"
+#include <atomic>
+#include <mutex>
 
 namespace qclient
 {
@@ -102,13 +104,27 @@ public:
   //----------------------------------------------------------------------------
   void updateCore(const QuotaNodeCore &updated) override;
 
+  //----------------------------------------------------------------------------
+  //! Attach or detach the listener receiving all quota updates
+  //----------------------------------------------------------------------------
+  void setUpdateListener(std::shared_ptr<IQuotaUpdateListener> listener)
+  override;
+
 private:
+  //----------------------------------------------------------------------------
+  //! Forward a quota update to the listener, if any
+  //----------------------------------------------------------------------------
+  void notifyListener(const IFileMD* file, int64_t sign, int64_t physical_size);
+
   //! Quota quota node uid hash key e.g. quota_node:id:uid
   std::string pQuotaUidKey;
   //! Quota quota node gid hash key e.g. quota_node:id:gid
   std::string pQuotaGidKey;
   qclient::QClient* pQcl; ///< Backend client from QuotaStats
   MetadataFlusher* pFlusher; ///< Metadata flusher object from QuotaStats
+  std::atomic<bool> mHasListener {false};
+  std::mutex mListenerMutex;
+  std::shared_ptr<IQuotaUpdateListener> mListener;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,479 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
+#include "namespace/MDException.hh"
+#include "common/Path.hh"
+#include <algorithm>
+#include <iterator>
+
+EOSNSNAMESPACE_BEGIN
+
+namespace
+{
+//! Maximum number of items explored in one go before handing them over
+constexpr size_t kBatchSize = 256;
+
+//------------------------------------------------------------------------------
+// Is the subtree with the given key entirely before the resume point, i.e.
+// before it without being one of its ancestors?
+//------------------------------------------------------------------------------
+bool subtreeBefore(const std::vector<std::string>& key,
+                   const std::vector<std::string>& resume)
+{
+  if (key.size() <= resume.size() &&
+      std::equal(key.begin(), key.end(), resume.begin())) {
+    return false;
+  }
+
+  return key < resume;
+}
+}
+
+//------------------------------------------------------------------------------
+//! Decider of a unit exploring only its container and files: the container
+//! is handled as usual, its subdirectories are never expanded but the
+//! decision for each of them is recorded for the unit to register it.
+//------------------------------------------------------------------------------
+class ParallelNamespaceExplorer::SplitDecider : public ExpansionDecider
+{
+public:
+  SplitDecider(std::shared_ptr<ExpansionDecider> inner):
+    mInner(std::move(inner)) {}
+
+  bool shouldExpandContainer(const eos::ns::ContainerMdProto& containerMd,
+                             const eos::IContainerMD::XAttrMap& linkedAttrs,
+                             const std::string& fullPath) override
+  {
+    const bool expand = !mInner ||
+                        mInner->shouldExpandContainer(containerMd, linkedAttrs, fullPath);
+
+    if (!mRootSeen) {
+      mRootSeen = true;
+      return expand;
+    }
+
+    mLastExpand = expand;
+    return false;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Decision for the last subdirectory seen
+  //----------------------------------------------------------------------------
+  bool lastExpand() const
+  {
+    return mLastExpand;
+  }
+
+private:
+  std::shared_ptr<ExpansionDecider> mInner;
+  bool mRootSeen = false;
+  bool mLastExpand = false;
+};
+
+//------------------------------------------------------------------------------
+//! Decider skipping the subtrees entirely before the resume point
+//------------------------------------------------------------------------------
+class ParallelNamespaceExplorer::ResumeDecider : public ExpansionDecider
+{
+public:
+  ResumeDecider(const Key& resume, std::shared_ptr<ExpansionDecider> inner):
+    mResume(resume), mInner(std::move(inner)) {}
+
+  bool shouldExpandContainer(const eos::ns::ContainerMdProto& containerMd,
+                             const eos::IContainerMD::XAttrMap& linkedAttrs,
+                             const std::string& fullPath) override
+  {
+    if (subtreeBefore(dfsKey(fullPath), mResume)) {
+      return false;
+    }
+
+    return !mInner ||
+           mInner->shouldExpandContainer(containerMd, linkedAttrs, fullPath);
+  }
+
+private:
+  const Key& mResume;
+  std::shared_ptr<ExpansionDecider> mInner;
+};
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ParallelNamespaceExplorer::ParallelNamespaceExplorer(const std::string& path,
+    const ExplorationOptions& options, qclient::QClient& qcl,
+    folly::Executor* exec, const Options& popts)
+  : mExplOptions(options), mOptions(popts), mQcl(qcl), mExecutor(exec)
+{
+  mWindow = (mOptions.window ? mOptions.window :
+             4 * std::max<size_t>(mOptions.threads, 1));
+
+  if (!mOptions.resumeAfter.empty()) {
+    mResumeKey = dfsKey(mOptions.resumeAfter);
+    mPastResume = false;
+  }
+
+  // The root unit is explored by the consumer, which needs it first anyway,
+  // and any error about the path itself is thrown right away
+  auto root = std::make_unique<Unit>();
+  root->path = path;
+  root->shallow = (mOptions.threads && mOptions.splitDepth);
+  root->started = root->inlined = true;
+  startUnit(*root);
+  mUnits.emplace(Key(), std::move(root));
+
+  for (size_t i = 0; i < mOptions.threads; ++i) {
+    mWorkers.emplace_back(&ParallelNamespaceExplorer::workerLoop, this);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ParallelNamespaceExplorer::~ParallelNamespaceExplorer()
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStop = true;
+
+    for (auto& unit : mUnits) {
+      unit.second->cv.notify_all();
+    }
+  }
+
+  mWorkCv.notify_all();
+
+  for (auto& worker : mWorkers) {
+    worker.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Depth-first ordering key of a path. Within a container the files come
+// before the subcontainers, each sorted by name, hence the prefix of every
+// component.
+//------------------------------------------------------------------------------
+std::vector<std::string>
+ParallelNamespaceExplorer::dfsKey(const std::string& path)
+{
+  std::vector<std::string> key;
+  size_t pos = 0;
+
+  while (pos < path.size()) {
+    size_t end = path.find('/', pos);
+
+    if (end == std::string::npos) {
+      key.emplace_back(std::string(1, '\0') + path.substr(pos));
+      break;
+    }
+
+    if (end > pos) {
+      key.emplace_back("\x01" + path.substr(pos, end - pos));
+    }
+
+    pos = end + 1;
+  }
+
+  return key;
+}
+
+//------------------------------------------------------------------------------
+// Is the subtree with the given key entirely before the resume point?
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::beforeResume(const Key& key) const
+{
+  return !mResumeKey.empty() && subtreeBefore(key, mResumeKey);
+}
+
+//------------------------------------------------------------------------------
+// Should a unit only explore its container and files?
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::isShallow(size_t level, size_t depth) const
+{
+  return mOptions.threads && (level < mOptions.splitDepth) &&
+         (depth + 1 < mExplOptions.depthLimit);
+}
+
+//------------------------------------------------------------------------------
+// Exploration options of a subtree
+//------------------------------------------------------------------------------
+ExplorationOptions
+ParallelNamespaceExplorer::subtreeOptions() const
+{
+  ExplorationOptions opts = mExplOptions;
+
+  if (!mResumeKey.empty()) {
+    opts.expansionDecider = std::make_shared<ResumeDecider>(mResumeKey,
+                            mExplOptions.expansionDecider);
+  }
+
+  return opts;
+}
+
+//------------------------------------------------------------------------------
+// Create the explorer of a unit
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::startUnit(Unit& unit)
+{
+  ExplorationOptions opts = subtreeOptions();
+
+  if (unit.shallow) {
+    unit.splitDecider = std::make_shared<SplitDecider>(opts.expansionDecider);
+    opts.expansionDecider = unit.splitDecider;
+  }
+
+  try {
+    unit.explorer.reset(new NamespaceExplorer(unit.path, opts, mQcl, mExecutor));
+  } catch (const MDException& e) {
+    // A subdirectory removed in the meantime is simply skipped
+    if ((e.getErrno() == ENOENT) && unit.level) {
+      return false;
+    }
+
+    throw;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Register a unit for a subdirectory
+//------------------------------------------------------------------------------
+void
+ParallelNamespaceExplorer::registerUnit(NamespaceItem&& item, bool expand,
+                                        size_t level)
+{
+  Key key = dfsKey(item.fullPath);
+
+  if (beforeResume(key)) {
+    return;
+  }
+
+  auto unit = std::make_unique<Unit>();
+  unit->path = item.fullPath;
+  unit->level = level;
+
+  if (expand) {
+    unit->shallow = isShallow(level,
+                              eos::common::Path(item.fullPath).GetSubPathSize());
+  } else {
+    // Nothing to explore, the unit is the container item alone
+    unit->items.push_back(std::move(item));
+    unit->started = unit->done = true;
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (mStop) {
+    return;
+  }
+
+  if (expand) {
+    mPending.insert(key);
+    mWorkCv.notify_one();
+  }
+
+  mUnits.emplace(std::move(key), std::move(unit));
+}
+
+//------------------------------------------------------------------------------
+// Explore the next items of a unit
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::produce(Unit& unit, std::deque<NamespaceItem>& out,
+                                   size_t max)
+{
+  size_t count = 0;
+
+  while (count < max) {
+    NamespaceItem item;
+
+    if (!unit.explorer->fetch(item)) {
+      return false;
+    }
+
+    if (unit.shallow && !item.isFile) {
+      if (unit.rootSeen) {
+        const bool expand = unit.splitDecider->lastExpand() &&
+                            (eos::common::Path(item.fullPath).GetSubPathSize() <
+                             mExplOptions.depthLimit);
+        registerUnit(std::move(item), expand, unit.level + 1);
+        continue;
+      }
+
+      unit.rootSeen = true;
+    }
+
+    out.push_back(std::move(item));
+    ++count;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Worker thread loop
+//------------------------------------------------------------------------------
+void
+ParallelNamespaceExplorer::workerLoop()
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWorkCv.wait(lock, [this]() {
+      return mStop || (!mPending.empty() && (mActive < mWindow));
+    });
+
+    if (mStop) {
+      return;
+    }
+
+    Unit& unit = *mUnits.at(*mPending.begin());
+    mPending.erase(mPending.begin());
+    unit.started = unit.byWorker = true;
+    ++mActive;
+    lock.unlock();
+
+    try {
+      bool more = startUnit(unit);
+
+      while (more) {
+        std::deque<NamespaceItem> batch;
+        more = produce(unit, batch, kBatchSize);
+        lock.lock();
+        unit.cv.wait(lock, [&]() {
+          return mStop || (unit.items.size() < mOptions.queueSize);
+        });
+
+        if (mStop) {
+          return;
+        }
+
+        std::move(batch.begin(), batch.end(), std::back_inserter(unit.items));
+        unit.cv.notify_all();
+        lock.unlock();
+      }
+
+      lock.lock();
+    } catch (...) {
+      if (!lock.owns_lock()) {
+        lock.lock();
+      }
+
+      unit.error = std::current_exception();
+    }
+
+    unit.done = true;
+    unit.cv.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Fetch next item
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::fetch(NamespaceItem& result)
+{
+  while (true) {
+    while (!mBatch.empty()) {
+      result = std::move(mBatch.front());
+      mBatch.pop_front();
+
+      if (!mPastResume) {
+        if (dfsKey(result.fullPath) <= mResumeKey) {
+          continue;
+        }
+
+        mPastResume = true;
+      }
+
+      return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (mUnits.empty()) {
+      return false;
+    }
+
+    auto it = mUnits.begin();
+    Unit& unit = *it->second;
+
+    if (!unit.started) {
+      // No worker got to it yet, explore it here rather than wait
+      unit.started = unit.inlined = true;
+      mPending.erase(it->first);
+      lock.unlock();
+
+      try {
+        unit.done = !startUnit(unit);
+      } catch (...) {
+        unit.done = true;
+        throw;
+      }
+
+      continue;
+    }
+
+    if (unit.inlined) {
+      if (unit.done) {
+        mUnits.erase(it);
+        continue;
+      }
+
+      lock.unlock();
+
+      try {
+        unit.done = !produce(unit, mBatch, kBatchSize);
+      } catch (...) {
+        unit.done = true;
+        throw;
+      }
+
+      continue;
+    }
+
+    unit.cv.wait(lock, [&]() {
+      return !unit.items.empty() || unit.done;
+    });
+
+    if (!unit.items.empty()) {
+      std::swap(mBatch, unit.items);
+      unit.cv.notify_all();
+      continue;
+    }
+
+    std::exception_ptr error = unit.error;
+
+    if (unit.byWorker) {
+      // The slot of the worker unit is free again
+      --mActive;
+      mWorkCv.notify_all();
+    }
+
+    mUnits.erase(it);
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+EOSNSNAMESPACE_END
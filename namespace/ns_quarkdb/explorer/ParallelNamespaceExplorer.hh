@@ -0,0 +1,204 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Class for exploring the namespace with several threads, keeping
+//!        the depth-first order of NamespaceExplorer
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "namespace/Namespace.hh"
+#include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Explores the namespace below some path like NamespaceExplorer does, and
+//! returns the very same items in the very same order, but spreads the work
+//! over several threads.
+//!
+//! The tree is cut into units: the first levels below the path are explored
+//! one directory at a time (the directory and its files), every subdirectory
+//! found there becoming a unit of its own, while the subtrees below these
+//! levels are explored as a whole by a NamespaceExplorer. Units are ordered
+//! like the depth-first traversal, the workers pick the first units not yet
+//! started and fill their bounded queues, and the consumer drains the units
+//! one after the other. A unit the consumer reaches before any worker picked
+//! it up is explored by the consumer itself.
+//!
+//! The exploration can be resumed after a given path: the items up to that
+//! path, in depth-first order, are skipped and the subtrees entirely before
+//! it are not explored at all.
+//!
+//! The expansion decider of the exploration options is called by all the
+//! threads concurrently.
+//------------------------------------------------------------------------------
+class ParallelNamespaceExplorer
+{
+public:
+  struct Options {
+    //! Number of worker threads, 0 to explore everything from the consumer
+    size_t threads = 4;
+    //! Number of levels below the path explored one directory at a time
+    size_t splitDepth = 2;
+    //! Maximum number of units explored ahead of the consumer, 0 for 4 per
+    //! worker thread
+    size_t window = 0;
+    //! Capacity of the item queue of every unit
+    size_t queueSize = 4096;
+    //! Resume the exploration after this path, as given by the fullPath of a
+    //! previously returned item
+    std::string resumeAfter;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor - starts the worker threads right away. No ownership of the
+  //! QClient object, it is shared by the workers.
+  //!
+  //! @throws MDException if the path cannot be explored, like NamespaceExplorer
+  //----------------------------------------------------------------------------
+  ParallelNamespaceExplorer(const std::string& path,
+                            const ExplorationOptions& options,
+                            qclient::QClient& qcl, folly::Executor* exec,
+                            const Options& popts);
+
+  //----------------------------------------------------------------------------
+  //! Destructor - interrupts any ongoing exploration
+  //----------------------------------------------------------------------------
+  ~ParallelNamespaceExplorer();
+
+  //----------------------------------------------------------------------------
+  //! Fetch next item, from a single thread
+  //!
+  //! @throws MDException if a subtree could not be explored
+  //----------------------------------------------------------------------------
+  bool fetch(NamespaceItem& result);
+
+  //----------------------------------------------------------------------------
+  //! Depth-first ordering key of a path as given by NamespaceItem::fullPath,
+  //! containers ending with '/'. Comparing the keys of two paths gives their
+  //! order in the exploration.
+  //----------------------------------------------------------------------------
+  static std::vector<std::string> dfsKey(const std::string& path);
+
+private:
+  using Key = std::vector<std::string>;
+  class SplitDecider;
+  class ResumeDecider;
+
+  //----------------------------------------------------------------------------
+  //! Part of the tree explored by a single thread
+  //----------------------------------------------------------------------------
+  struct Unit {
+    std::string path; ///< Path of the container the unit starts from
+    size_t level = 0; ///< Number of split levels between the root and path
+    bool shallow = false; ///< Only explore the container and its files
+    bool started = false; ///< Picked up by a worker or the consumer
+    bool inlined = false; ///< Explored by the consumer
+    bool byWorker = false; ///< Explored by a worker
+    bool done = false; ///< Fully explored
+    std::unique_ptr<NamespaceExplorer> explorer;
+    std::shared_ptr<SplitDecider> splitDecider;
+    bool rootSeen = false;
+    std::deque<NamespaceItem> items; ///< Items explored, not yet consumed
+    std::exception_ptr error;
+    std::condition_variable cv; ///< Signals new items, free space or done
+  };
+
+  //----------------------------------------------------------------------------
+  //! Worker thread loop
+  //----------------------------------------------------------------------------
+  void workerLoop();
+
+  //----------------------------------------------------------------------------
+  //! Explore the next items of a unit, registering the units found below it
+  //!
+  //! @param unit unit to explore
+  //! @param out where to append the items
+  //! @param max maximum number of items to append
+  //!
+  //! @return false if the unit is fully explored, otherwise true
+  //----------------------------------------------------------------------------
+  bool produce(Unit& unit, std::deque<NamespaceItem>& out, size_t max);
+
+  //----------------------------------------------------------------------------
+  //! Create the explorer of a unit
+  //!
+  //! @return false if the container of the unit does not exist anymore
+  //----------------------------------------------------------------------------
+  bool startUnit(Unit& unit);
+
+  //----------------------------------------------------------------------------
+  //! Register a unit for a subdirectory, caller must not hold mMutex
+  //!
+  //! @param item container item of the subdirectory
+  //! @param expand whether the subdirectory is to be explored
+  //! @param level split level of the subdirectory
+  //----------------------------------------------------------------------------
+  void registerUnit(NamespaceItem&& item, bool expand, size_t level);
+
+  //----------------------------------------------------------------------------
+  //! Is the subtree with the given key entirely before the resume point?
+  //----------------------------------------------------------------------------
+  bool beforeResume(const Key& key) const;
+
+  //----------------------------------------------------------------------------
+  //! Should a unit of the given level, at the given depth, only explore its
+  //! container and files?
+  //----------------------------------------------------------------------------
+  bool isShallow(size_t level, size_t depth) const;
+
+  //----------------------------------------------------------------------------
+  //! Exploration options of a subtree with the resume filter applied
+  //----------------------------------------------------------------------------
+  ExplorationOptions subtreeOptions() const;
+
+  ExplorationOptions mExplOptions;
+  Options mOptions;
+  qclient::QClient& mQcl;
+  folly::Executor* mExecutor;
+  Key mResumeKey;
+  bool mPastResume = true;
+  size_t mWindow;
+
+  std::mutex mMutex;
+  std::condition_variable mWorkCv; ///< Signals units to pick up
+  bool mStop = false;
+  //! Units not consumed yet, in depth-first order
+  std::map<Key, std::unique_ptr<Unit>> mUnits;
+  //! Units not started yet
+  std::set<Key> mPending;
+  //! Units started by the workers and not consumed yet
+  size_t mActive = 0;
+  std::vector<std::thread> mWorkers;
+  //! Consumer side batch of items
+  std::deque<NamespaceItem> mBatch;
+};
+
+EOSNSNAMESPACE_END
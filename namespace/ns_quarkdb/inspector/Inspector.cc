@@ -21,6 +21,7 @@
 #include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
 #include "namespace/ns_quarkdb/inspector/ContainerScanner.hh"
 #include "namespace/ns_quarkdb/inspector/FileScanner.hh"
+#include "namespace/ns_quarkdb/inspector/ParallelFileScanner.hh"
 #include "namespace/ns_quarkdb/inspector/Printing.hh"
 #include "namespace/ns_quarkdb/inspector/OutputSink.hh"
 #include "namespace/ns_quarkdb/inspector/FileMetadataFilter.hh"
@@ -44,6 +45,7 @@
 #include <qclient/ResponseParsing.hh>
 #include <google/protobuf/util/json_util.h>
 #include <json/json.h>
+#include <sys/stat.h>
 EOSNSNAMESPACE_BEGIN
 
 //------------------------------------------------------------------------------
@@ -506,6 +508,187 @@ int Inspector::scanFileMetadata(bool onlySizes, bool fullPaths,
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// Benchmark full file metadata scans
+//------------------------------------------------------------------------------
+int Inspector::scanBench(const QdbContactDetails& contactDetails,
+                         size_t maxPartitions, bool ordered, std::ostream& out, std::ostream& err)
+{
+  auto reportRate = [&out](const std::string & label, uint64_t items,
+  uint64_t misses, std::chrono::milliseconds elapsed) {
+    const double secs = std::max<double>(elapsed.count(), 1) / 1000.0;
+    out << label << " items=" << items << " misses=" << misses
+        << " elapsed_ms=" << elapsed.count()
+        << " items_per_sec=" << (uint64_t)(items / secs) << std::endl;
+  };
+  std::string errorString;
+  {
+    common::IntervalStopwatch stopwatch;
+    FileScanner fileScanner(mQcl);
+    uint64_t items = 0;
+
+    while (fileScanner.valid()) {
+      eos::ns::FileMdProto proto;
+
+      if (!fileScanner.getItem(proto)) {
+        break;
+      }
+
+      ++items;
+      fileScanner.next();
+    }
+
+    if (fileScanner.hasError(errorString)) {
+      err << errorString << std::endl;
+      return 1;
+    }
+
+    reportRate("scanner=single", items, 0, stopwatch.timeIntoCycle());
+  }
+
+  for (size_t partitions = 1; partitions <= maxPartitions; partitions *= 2) {
+    common::IntervalStopwatch stopwatch;
+    ParallelFileScanner::Options opts;
+    opts.partitions = partitions;
+    opts.ordered = ordered;
+    ParallelFileScanner fileScanner(contactDetails, opts);
+
+    while (fileScanner.valid()) {
+      fileScanner.next();
+    }
+
+    if (fileScanner.hasError(errorString)) {
+      err << errorString << std::endl;
+      return 1;
+    }
+
+    reportRate(SSTR("scanner=parallel partitions=" << partitions << " ordered="
+                    << ordered), fileScanner.getScannedSoFar(),
+               fileScanner.getMisses(), stopwatch.timeIntoCycle());
+  }
+
+  return 0;
+}
+
+namespace
+{
+//------------------------------------------------------------------------------
+//! Stream buffer discarding its input, only counting the bytes
+//------------------------------------------------------------------------------
+class CountingStreamBuf : public std::streambuf
+{
+public:
+  uint64_t getBytes() const
+  {
+    return mBytes;
+  }
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (ch != traits_type::eof()) {
+      ++mBytes;
+    }
+
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char*, std::streamsize n) override
+  {
+    mBytes += n;
+    return n;
+  }
+
+private:
+  uint64_t mBytes {0};
+};
+}
+
+//------------------------------------------------------------------------------
+// Benchmark exporting file metadata, JsonStreamSink versus the given sink
+//------------------------------------------------------------------------------
+int Inspector::exportBench(std::unique_ptr<OutputSink> fileSink,
+                           const std::string& label, const std::string& path,
+                           uint64_t maxFiles, std::ostream& out,
+                           std::ostream& err)
+{
+  FilePrintingOptions opts;
+  std::string errorString;
+  // Stream every file through the given sink, return number of rows or -1
+  auto exportTo = [&](OutputSink & sink) -> int64_t {
+    FileScanner fileScanner(mQcl);
+    int64_t rows = 0;
+
+    while (fileScanner.valid() && ((maxFiles == 0) || ((uint64_t)rows < maxFiles)))
+    {
+      eos::ns::FileMdProto proto;
+
+      if (!fileScanner.getItem(proto)) {
+        break;
+      }
+
+      if (!mMetadataFilter || mMetadataFilter->check(proto)) {
+        sink.print(proto, opts);
+        ++rows;
+      }
+
+      fileScanner.next();
+    }
+
+    if (fileScanner.hasError(errorString))
+    {
+      err << errorString << std::endl;
+      return -1;
+    }
+
+    return rows;
+  };
+  auto report = [&out](const std::string & label, int64_t rows,
+  uint64_t bytes, std::chrono::milliseconds elapsed) {
+    const double secs = std::max<double>(elapsed.count(), 1) / 1000.0;
+    out << "sink=" << label << " rows=" << rows << " bytes=" << bytes
+        << " bytes_per_row=" << (rows ? bytes / rows : 0)
+        << " elapsed_ms=" << elapsed.count()
+        << " rows_per_sec=" << (uint64_t)(rows / secs) << std::endl;
+  };
+  {
+    CountingStreamBuf counter;
+    std::ostream counting_stream(&counter);
+    common::IntervalStopwatch stopwatch;
+    int64_t rows;
+    {
+      JsonStreamSink sink(counting_stream, err);
+      rows = exportTo(sink);
+    }
+
+    if (rows < 0) {
+      return 1;
+    }
+
+    report("json", rows, counter.getBytes(), stopwatch.timeIntoCycle());
+  }
+  {
+    common::IntervalStopwatch stopwatch;
+    int64_t rows = exportTo(*fileSink);
+    // Destroying the sink flushes and closes the output file
+    fileSink.reset();
+
+    if (rows < 0) {
+      return 1;
+    }
+
+    struct stat info;
+    uint64_t bytes = 0;
+
+    if (::stat(path.c_str(), &info) == 0) {
+      bytes = info.st_size;
+    }
+
+    report(label, rows, bytes, stopwatch.timeIntoCycle());
+  }
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 // Scan all deathrow entries
 //------------------------------------------------------------------------------
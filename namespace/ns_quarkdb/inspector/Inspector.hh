@@ -27,6 +27,7 @@
 #include "proto/ContainerMd.pb.h"
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 #include <set>
 
@@ -41,6 +42,7 @@ class ContainerScanner;
 class FileScanner;
 class OutputSink;
 class FileMetadataFilter;
+class QdbContactDetails;
 
 struct CacheNotifications {
   CacheNotifications() {}
@@ -92,6 +94,27 @@ public:
   //----------------------------------------------------------------------------
   int scanFileMetadata(bool onlySizes, bool fullPaths, bool onlyUnknownFsids);
 
+  //----------------------------------------------------------------------------
+  //! Benchmark full file metadata scans: the single cursor FileScanner
+  //! followed by the ParallelFileScanner with 1, 2, 4 .. maxPartitions
+  //! partitions. Reports items/s for each run.
+  //----------------------------------------------------------------------------
+  int scanBench(const QdbContactDetails& contactDetails, size_t maxPartitions,
+                bool ordered, std::ostream& out, std::ostream& err);
+
+  //----------------------------------------------------------------------------
+  //! Benchmark exporting file metadata: JsonStreamSink (to a discarding
+  //! stream) versus the given sink writing to a file e.g. ParquetSink.
+  //! Reports rows/s and output size for each.
+  //!
+  //! @param fileSink sink under test, destroyed once all rows are written
+  //! @param label name of the sink in the report
+  //! @param path output file of the sink
+  //----------------------------------------------------------------------------
+  int exportBench(std::unique_ptr<OutputSink> fileSink,
+                  const std::string& label, const std::string& path,
+                  uint64_t maxFiles, std::ostream& out, std::ostream& err);
+
   //----------------------------------------------------------------------------
   //! Scan all deathrow entries
   //----------------------------------------------------------------------------
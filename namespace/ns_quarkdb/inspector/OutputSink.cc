@@ -36,10 +36,10 @@ static std::string to_octal_string(uint32_t v)
 }
 
 //------------------------------------------------------------------------------
-//! Return full path, if possible, otherwise empty
+// Return full path of the file, if possible, otherwise empty
 //------------------------------------------------------------------------------
-static std::string populateFullPath(const eos::ns::FileMdProto& proto,
-                                    FileScanner::Item& item)
+std::string OutputSink::populateFullPath(const eos::ns::FileMdProto& proto,
+    FileScanner::Item& item)
 {
   item.fullPath.wait();
 
@@ -57,10 +57,10 @@ static std::string populateFullPath(const eos::ns::FileMdProto& proto,
 }
 
 //------------------------------------------------------------------------------
-//! Return full path, if possible, otherwise empty
+// Return full path of the container, if possible, otherwise empty
 //------------------------------------------------------------------------------
-static std::string populateFullPath(const eos::ns::ContainerMdProto& proto,
-                                    ContainerScanner::Item& item)
+std::string OutputSink::populateFullPath(const eos::ns::ContainerMdProto&
+    proto, ContainerScanner::Item& item)
 {
   item.fullPath.wait();
 
@@ -86,35 +86,36 @@ public:
   //----------------------------------------------------------------------------
   //! Print everything known about a ContainerMD
   //----------------------------------------------------------------------------
-  void print(const eos::ns::ContainerMdProto& proto,
-             const ContainerPrintingOptions& opts);
+  virtual void print(const eos::ns::ContainerMdProto& proto,
+                     const ContainerPrintingOptions& opts);
 
   //----------------------------------------------------------------------------
   //! Print everything known about a ContainerMD -- custom path
   //----------------------------------------------------------------------------
-  void printWithCustomPath(const eos::ns::ContainerMdProto& proto,
-                           const ContainerPrintingOptions& opts,
-                           const std::string& customPath);
+  virtual void printWithCustomPath(const eos::ns::ContainerMdProto& proto,
+                                   const ContainerPrintingOptions& opts,
+                                   const std::string& customPath);
 
   //----------------------------------------------------------------------------
   //! Print everything known about a ContainerMD, including
   //! full path if available
   //----------------------------------------------------------------------------
-  void print(const eos::ns::ContainerMdProto& proto,
-             const ContainerPrintingOptions& opts,
-             ContainerScanner::Item& item, bool showCounts);
+  virtual void print(const eos::ns::ContainerMdProto& proto,
+                     const ContainerPrintingOptions& opts,
+                     ContainerScanner::Item& item, bool showCounts);
 
   //----------------------------------------------------------------------------
   //! Print everything known about a FileMD
   //----------------------------------------------------------------------------
-  void print(const eos::ns::FileMdProto& proto, const FilePrintingOptions& opts);
+  virtual void print(const eos::ns::FileMdProto& proto,
+                     const FilePrintingOptions& opts);
 
   //----------------------------------------------------------------------------
   //! Print everything known about a FileMD -- custom path
   //----------------------------------------------------------------------------
-  void printWithCustomPath(const eos::ns::FileMdProto& proto,
-                           const FilePrintingOptions& opts,
-                           const std::string& customPath);
+  virtual void printWithCustomPath(const eos::ns::FileMdProto& proto,
+                                   const FilePrintingOptions& opts,
+                                   const std::string& customPath);
 
   //----------------------------------------------------------------------------
   //! Print everything known about a FileMD -- custom path
@@ -125,10 +126,22 @@ public:
   //----------------------------------------------------------------------------
   //! Print everything known about a FileMD, including full path if available
   //----------------------------------------------------------------------------
-  void print(const eos::ns::FileMdProto& proto, const FilePrintingOptions& opts,
-             FileScanner::Item& item);
+  virtual void print(const eos::ns::FileMdProto& proto,
+                     const FilePrintingOptions& opts, FileScanner::Item& item);
 
 protected:
+  //----------------------------------------------------------------------------
+  //! Return full path of the file, if possible, otherwise empty
+  //----------------------------------------------------------------------------
+  static std::string populateFullPath(const eos::ns::FileMdProto& proto,
+                                      FileScanner::Item& item);
+
+  //----------------------------------------------------------------------------
+  //! Return full path of the container, if possible, otherwise empty
+  //----------------------------------------------------------------------------
+  static std::string populateFullPath(const eos::ns::ContainerMdProto& proto,
+                                      ContainerScanner::Item& item);
+
   std::ostream& mOut;
   std::ostream& mErr;
 };
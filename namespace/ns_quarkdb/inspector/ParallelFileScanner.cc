@@ -0,0 +1,422 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/inspector/ParallelFileScanner.hh"
+#include "namespace/ns_quarkdb/Constants.hh"
+#include "namespace/ns_quarkdb/persistency/RequestBuilder.hh"
+#include "namespace/ns_quarkdb/persistency/Serialization.hh"
+#include "common/ParseUtils.hh"
+#include <qclient/QClient.hh>
+#include <qclient/ResponseParsing.hh>
+#include <deque>
+
+EOSNSNAMESPACE_BEGIN
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Back off while waiting on a queue, spin a bit before sleeping
+//------------------------------------------------------------------------------
+void backoff(uint32_t& spins)
+{
+  if (++spins < 64) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ParallelFileScanner::ParallelFileScanner(const QdbContactDetails&
+    contactDetails, const Options& opts)
+  : mOptions(opts)
+{
+  if (mOptions.partitions == 0) {
+    mOptions.partitions = 1;
+  }
+
+  if (mOptions.pipelineDepth == 0) {
+    mOptions.pipelineDepth = 1;
+  }
+
+  // Upper bound of the file id keyspace
+  std::unique_ptr<qclient::QClient> qcl = std::make_unique<qclient::QClient>
+                                          (contactDetails.members, contactDetails.constructOptions());
+  qclient::redisReplyPtr reply = qcl->exec("HGET", constants::sMapMetaInfoKey,
+                                 constants::sLastUsedFid).get();
+
+  if (!reply) {
+    mError = "QuarkDB backend not available!";
+    mExhausted = true;
+    return;
+  }
+
+  if (reply->type == REDIS_REPLY_STRING) {
+    if (!eos::common::ParseUInt64(std::string(reply->str, reply->len),
+                                  mLastFid)) {
+      mError = SSTR("Could not parse " << constants::sLastUsedFid << ": "
+                    << std::string(reply->str, reply->len));
+      mExhausted = true;
+      return;
+    }
+  }
+
+  // Split [1, mLastFid] in contiguous ranges
+  const uint64_t total = mLastFid;
+  const size_t nparts = mOptions.partitions;
+
+  for (size_t i = 0; i < nparts; ++i) {
+    const uint64_t begin = 1 + (total * i) / nparts;
+    const uint64_t end = 1 + (total * (i + 1)) / nparts;
+    mPartitions.emplace_back(std::make_unique<Partition>(begin, end,
+                             mOptions.queueSize));
+  }
+
+  for (size_t i = 0; i < nparts; ++i) {
+    auto& part = *mPartitions[i];
+
+    if (i == 0) {
+      part.mQcl = std::move(qcl);
+    } else {
+      part.mQcl = std::make_unique<qclient::QClient>
+                  (contactDetails.members, contactDetails.constructOptions());
+    }
+
+    part.mThread = std::thread(&ParallelFileScanner::fetchPartition, this,
+                               std::ref(part));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ParallelFileScanner::~ParallelFileScanner()
+{
+  stop();
+}
+
+//------------------------------------------------------------------------------
+// Stop and join all the partition threads
+//------------------------------------------------------------------------------
+void ParallelFileScanner::stop()
+{
+  mStop = true;
+
+  for (auto& part : mPartitions) {
+    if (part->mThread.joinable()) {
+      part->mThread.join();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Record an error and stop the scan
+//------------------------------------------------------------------------------
+void ParallelFileScanner::setError(const std::string& err)
+{
+  std::unique_lock<std::mutex> lock(mErrorMutex);
+
+  if (mError.empty()) {
+    mError = err;
+  }
+
+  mStop = true;
+}
+
+//------------------------------------------------------------------------------
+// Fetch all the files of the given partition
+//------------------------------------------------------------------------------
+void ParallelFileScanner::fetchPartition(Partition& part)
+{
+  std::deque<std::pair<uint64_t, folly::Future<qclient::redisReplyPtr>>>
+      inflight;
+  uint64_t next_fid = part.mBegin;
+
+  while (!mStop) {
+    // Keep the pipeline full
+    while ((next_fid < part.mEnd) &&
+           (inflight.size() < mOptions.pipelineDepth)) {
+      inflight.emplace_back(next_fid, part.mQcl->follyExec
+                            (RequestBuilder::readFileProto(FileIdentifier(next_fid))));
+      ++next_fid;
+    }
+
+    if (inflight.empty()) {
+      break;
+    }
+
+    const uint64_t fid = inflight.front().first;
+    qclient::redisReplyPtr reply = std::move(inflight.front().second).get();
+    inflight.pop_front();
+
+    if (!reply) {
+      setError("QuarkDB backend not available!");
+      break;
+    }
+
+    if ((reply->type == REDIS_REPLY_NIL) ||
+        ((reply->type == REDIS_REPLY_STRING) && (reply->len == 0))) {
+      // Deleted file, gaps are expected in the keyspace
+      ++part.mMisses;
+      continue;
+    }
+
+    if (reply->type != REDIS_REPLY_STRING) {
+      setError(SSTR("Received unexpected response for fid=" << fid << ": "
+                    << qclient::describeRedisReply(reply)));
+      break;
+    }
+
+    eos::ns::FileMdProto proto;
+    MDStatus status = Serialization::deserialize(reply->str, reply->len, proto);
+
+    if (!status.ok()) {
+      setError(SSTR("Error while deserializing fid=" << fid << ": "
+                    << status.getError()));
+      break;
+    }
+
+    uint32_t spins = 0;
+
+    while (!part.mQueue.try_push(std::move(proto))) {
+      if (mStop) {
+        break;
+      }
+
+      backoff(spins);
+    }
+  }
+
+  // Drain the pipeline before the QClient object goes away
+  for (auto& elem : inflight) {
+    (void) std::move(elem.second).get();
+  }
+
+  part.mDone.store(true, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+// Try to pop an element from the given partition
+//------------------------------------------------------------------------------
+int ParallelFileScanner::popFrom(Partition& part, eos::ns::FileMdProto& proto)
+{
+  if (part.mQueue.try_pop(proto)) {
+    ++mScanned;
+    return 1;
+  }
+
+  // The producer might have pushed the last elements right before finishing,
+  // so check the queue once more after observing the done flag
+  if (part.mDone.load(std::memory_order_acquire)) {
+    if (part.mQueue.try_pop(proto)) {
+      ++mScanned;
+      return 1;
+    }
+
+    return -1;
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Fetch the next element for the iterator interface
+//------------------------------------------------------------------------------
+bool ParallelFileScanner::fetchNext()
+{
+  uint32_t spins = 0;
+
+  while (!mExhausted) {
+    if (mOptions.ordered) {
+      // Merge stage: the partitions are contiguous fid ranges, so draining
+      // them one after the other yields the increasing fid order
+      if (mCurrentPartition >= mPartitions.size()) {
+        mExhausted = true;
+        break;
+      }
+
+      int rc = popFrom(*mPartitions[mCurrentPartition], mCurrent);
+
+      if (rc == 1) {
+        return true;
+      } else if (rc == -1) {
+        ++mCurrentPartition;
+        continue;
+      }
+    } else {
+      size_t num_exhausted = 0;
+
+      for (size_t i = 0; i < mPartitions.size(); ++i) {
+        const size_t idx = (mCurrentPartition + i) % mPartitions.size();
+        int rc = popFrom(*mPartitions[idx], mCurrent);
+
+        if (rc == 1) {
+          // Continue with the next partition to keep them evenly drained
+          mCurrentPartition = (idx + 1) % mPartitions.size();
+          return true;
+        } else if (rc == -1) {
+          ++num_exhausted;
+        }
+      }
+
+      if (num_exhausted == mPartitions.size()) {
+        mExhausted = true;
+        break;
+      }
+    }
+
+    backoff(spins);
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Is the iterator valid?
+//------------------------------------------------------------------------------
+bool ParallelFileScanner::valid()
+{
+  if (!mHasCurrent) {
+    mHasCurrent = fetchNext();
+  }
+
+  return mHasCurrent;
+}
+
+//------------------------------------------------------------------------------
+// Advance iterator - only call when valid() == true
+//------------------------------------------------------------------------------
+void ParallelFileScanner::next()
+{
+  mHasCurrent = false;
+}
+
+//------------------------------------------------------------------------------
+// Get current element
+//------------------------------------------------------------------------------
+bool ParallelFileScanner::getItem(eos::ns::FileMdProto& proto)
+{
+  if (!valid()) {
+    return false;
+  }
+
+  proto = mCurrent;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Process all the files with the given number of threads
+//------------------------------------------------------------------------------
+void ParallelFileScanner::process(size_t nthreads,
+                                  const std::function<void(eos::ns::FileMdProto&&)>& func)
+{
+  if (nthreads == 0) {
+    nthreads = 1;
+  }
+
+  if (nthreads > mPartitions.size()) {
+    nthreads = mPartitions.size();
+  }
+
+  std::vector<std::thread> workers;
+
+  for (size_t t = 0; t < nthreads; ++t) {
+    workers.emplace_back([this, t, nthreads, &func]() {
+      std::vector<Partition*> owned;
+
+      for (size_t p = t; p < mPartitions.size(); p += nthreads) {
+        owned.push_back(mPartitions[p].get());
+      }
+
+      uint32_t spins = 0;
+
+      while (!owned.empty()) {
+        bool progress = false;
+
+        for (auto it = owned.begin(); it != owned.end();) {
+          eos::ns::FileMdProto proto;
+          int rc = popFrom(**it, proto);
+
+          if (rc == 1) {
+            func(std::move(proto));
+            progress = true;
+            ++it;
+          } else if (rc == -1) {
+            it = owned.erase(it);
+          } else {
+            ++it;
+          }
+        }
+
+        if (progress) {
+          spins = 0;
+        } else if (!owned.empty()) {
+          backoff(spins);
+        }
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  mExhausted = true;
+}
+
+//------------------------------------------------------------------------------
+// Is there an error?
+//------------------------------------------------------------------------------
+bool ParallelFileScanner::hasError(std::string& err) const
+{
+  std::unique_lock<std::mutex> lock(mErrorMutex);
+
+  if (!mError.empty()) {
+    err = mError;
+    return true;
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Get number of elements delivered so far
+//------------------------------------------------------------------------------
+uint64_t ParallelFileScanner::getScannedSoFar() const
+{
+  return mScanned;
+}
+
+//------------------------------------------------------------------------------
+// Get number of file ids with no metadata
+//------------------------------------------------------------------------------
+uint64_t ParallelFileScanner::getMisses() const
+{
+  uint64_t misses = 0;
+
+  for (const auto& part : mPartitions) {
+    misses += part->mMisses;
+  }
+
+  return misses;
+}
+
+EOSNSNAMESPACE_END
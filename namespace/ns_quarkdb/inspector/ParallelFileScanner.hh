@@ -0,0 +1,198 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Class for scanning through all file metadata using several
+//!        concurrent QuarkDB connections
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "namespace/ns_quarkdb/QdbContactDetails.hh"
+#include "common/concurrency/SpscQueue.hh"
+#include "proto/FileMd.pb.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace qclient
+{
+class QClient;
+}
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! ParallelFileScanner splits the file id keyspace [1, last_used_fid] into N
+//! contiguous ranges. Every range is fetched by its own thread over its own
+//! QClient connection using pipelined point lookups, and handed over to the
+//! consumer side through a lock-free single-producer single-consumer queue.
+//!
+//! Since the ranges are contiguous, the ordered mode (increasing fid order)
+//! only needs to drain the partitions one after the other while the others
+//! keep prefetching into their bounded queues. The unordered mode delivers
+//! whatever partition has data available.
+//!
+//! Files are either consumed through the FileScanner-like iterator interface
+//! from a single thread or through process() by several threads, partition p
+//! being always drained by thread p % nthreads.
+//------------------------------------------------------------------------------
+class ParallelFileScanner
+{
+public:
+  struct Options {
+    //! Number of partitions, each one has its own connection and thread
+    size_t partitions = 8;
+    //! Deliver the files in increasing fid order
+    bool ordered = false;
+    //! Number of outstanding requests per partition
+    size_t pipelineDepth = 512;
+    //! Capacity of the handoff queue of every partition
+    size_t queueSize = 4096;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor - starts the partition threads right away
+  //!
+  //! @param contactDetails QuarkDB cluster contact details
+  //! @param opts scanner options
+  //----------------------------------------------------------------------------
+  ParallelFileScanner(const QdbContactDetails& contactDetails,
+                      const Options& opts);
+
+  //----------------------------------------------------------------------------
+  //! Destructor - interrupts any ongoing scan
+  //----------------------------------------------------------------------------
+  ~ParallelFileScanner();
+
+  //----------------------------------------------------------------------------
+  //! Is the iterator valid? Blocks until the next element is available or
+  //! the scan is over.
+  //----------------------------------------------------------------------------
+  bool valid();
+
+  //----------------------------------------------------------------------------
+  //! Advance iterator - only call when valid() == true
+  //----------------------------------------------------------------------------
+  void next();
+
+  //----------------------------------------------------------------------------
+  //! Get current element
+  //----------------------------------------------------------------------------
+  bool getItem(eos::ns::FileMdProto& proto);
+
+  //----------------------------------------------------------------------------
+  //! Process all the (remaining) files with the given number of threads.
+  //! Must not be mixed with the iterator interface.
+  //!
+  //! @param nthreads number of processing threads
+  //! @param func function called for every file, it must be thread-safe
+  //----------------------------------------------------------------------------
+  void process(size_t nthreads,
+               const std::function<void(eos::ns::FileMdProto&&)>& func);
+
+  //----------------------------------------------------------------------------
+  //! Is there an error?
+  //----------------------------------------------------------------------------
+  bool hasError(std::string& err) const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of elements delivered so far
+  //----------------------------------------------------------------------------
+  uint64_t getScannedSoFar() const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of file ids in the keyspace with no metadata i.e. deleted
+  //----------------------------------------------------------------------------
+  uint64_t getMisses() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the last file id covered by the scan
+  //----------------------------------------------------------------------------
+  inline uint64_t getLastFid() const
+  {
+    return mLastFid;
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Partition state, the queue is written by the partition thread and read
+  //! by exactly one consumer thread
+  //----------------------------------------------------------------------------
+  struct Partition {
+    Partition(uint64_t begin, uint64_t end, size_t queue_size):
+      mBegin(begin), mEnd(end), mQueue(queue_size)
+    {}
+
+    const uint64_t mBegin; ///< First fid of the partition
+    const uint64_t mEnd; ///< One past the last fid of the partition
+    eos::common::SpscQueue<eos::ns::FileMdProto> mQueue;
+    std::atomic<bool> mDone {false}; ///< Producer finished
+    std::atomic<uint64_t> mMisses {0};
+    std::unique_ptr<qclient::QClient> mQcl;
+    std::thread mThread;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Fetch all the files of the given partition
+  //----------------------------------------------------------------------------
+  void fetchPartition(Partition& part);
+
+  //----------------------------------------------------------------------------
+  //! Try to pop an element from the given partition
+  //!
+  //! @return 1 if an element was popped, 0 if none available yet and -1 if
+  //!         the partition is exhausted
+  //----------------------------------------------------------------------------
+  int popFrom(Partition& part, eos::ns::FileMdProto& proto);
+
+  //----------------------------------------------------------------------------
+  //! Fetch the next element for the iterator interface
+  //----------------------------------------------------------------------------
+  bool fetchNext();
+
+  //----------------------------------------------------------------------------
+  //! Record an error and stop the scan
+  //----------------------------------------------------------------------------
+  void setError(const std::string& err);
+
+  //----------------------------------------------------------------------------
+  //! Stop and join all the partition threads
+  //----------------------------------------------------------------------------
+  void stop();
+
+  Options mOptions;
+  uint64_t mLastFid {0};
+  std::vector<std::unique_ptr<Partition>> mPartitions;
+  std::atomic<bool> mStop {false};
+  std::atomic<uint64_t> mScanned {0};
+  mutable std::mutex mErrorMutex;
+  std::string mError;
+  //! Iterator interface state
+  eos::ns::FileMdProto mCurrent;
+  bool mHasCurrent {false};
+  bool mExhausted {false};
+  size_t mCurrentPartition {0};
+};
+
+EOSNSNAMESPACE_END
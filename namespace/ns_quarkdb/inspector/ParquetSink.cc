@@ -0,0 +1,535 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/inspector/ParquetSink.hh"
+#include "namespace/utils/Checksum.hh"
+#ifdef PARQUET_FOUND
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+#endif
+
+EOSNSNAMESPACE_BEGIN
+
+#ifdef PARQUET_FOUND
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Convert serialized timespec to nanoseconds since epoch
+//------------------------------------------------------------------------------
+template<typename T>
+int64_t toNanoseconds(const T& bytes)
+{
+  struct timespec ts = Printing::parseTimespec(bytes);
+  return (int64_t) ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+}
+
+//------------------------------------------------------------------------------
+//! Arrow column builders and the Parquet file writer
+//------------------------------------------------------------------------------
+struct ParquetSink::Writer {
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  explicit Writer(const ParquetSinkOptions& opts):
+    mOpts(opts),
+    mCTime(arrow::timestamp(arrow::TimeUnit::NANO), arrow::default_memory_pool()),
+    mMTime(arrow::timestamp(arrow::TimeUnit::NANO), arrow::default_memory_pool()),
+    mSTime(arrow::timestamp(arrow::TimeUnit::NANO), arrow::default_memory_pool()),
+    mATime(arrow::timestamp(arrow::TimeUnit::NANO), arrow::default_memory_pool()),
+    mLocationValues(std::make_shared<arrow::UInt32Builder>()),
+    mUnlinkLocationValues(std::make_shared<arrow::UInt32Builder>()),
+    mLocations(arrow::default_memory_pool(), mLocationValues),
+    mUnlinkLocations(arrow::default_memory_pool(), mUnlinkLocationValues)
+  {
+    if (mOpts.rowGroupSize == 0) {
+      mOpts.rowGroupSize = 1;
+    }
+
+    auto ts_type = arrow::timestamp(arrow::TimeUnit::NANO);
+    std::vector<std::shared_ptr<arrow::Field>> fields = {
+      arrow::field("type", arrow::utf8(), false),
+      arrow::field("id", arrow::uint64(), false),
+      arrow::field("parent_id", arrow::uint64(), false),
+      arrow::field("name", arrow::utf8(), false),
+      arrow::field("path", arrow::utf8()),
+      arrow::field("uid", arrow::uint32(), false),
+      arrow::field("gid", arrow::uint32(), false),
+      arrow::field("size", arrow::uint64(), false),
+      arrow::field("layout_id", arrow::uint32()),
+      arrow::field("flags", arrow::uint32(), false),
+      arrow::field("mode", arrow::uint32()),
+      arrow::field("ctime", ts_type, false),
+      arrow::field("mtime", ts_type, false),
+      arrow::field("stime", ts_type),
+      arrow::field("atime", ts_type),
+      arrow::field("checksum", arrow::utf8()),
+      arrow::field("link_name", arrow::utf8()),
+      arrow::field("locations", arrow::list(arrow::uint32())),
+      arrow::field("unlink_locations", arrow::list(arrow::uint32()))
+    };
+
+    for (const auto& xattr : mOpts.xattrs) {
+      fields.push_back(arrow::field("xattr." + xattr, arrow::utf8()));
+      mXattrs.emplace_back(std::make_unique<arrow::StringBuilder>());
+    }
+
+    mSchema = arrow::schema(fields);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Open the output file
+  //----------------------------------------------------------------------------
+  arrow::Status open(const std::string& path)
+  {
+    ARROW_ASSIGN_OR_RAISE(mStream, arrow::io::FileOutputStream::Open(path));
+    parquet::WriterProperties::Builder props;
+    props.compression(parquet::Compression::ZSTD);
+    props.max_row_group_length(mOpts.rowGroupSize);
+    props.version(parquet::ParquetVersion::PARQUET_2_6);
+    parquet::ArrowWriterProperties::Builder arrow_props;
+    arrow_props.store_schema();
+    ARROW_ASSIGN_OR_RAISE(mFileWriter, parquet::arrow::FileWriter::Open(*mSchema,
+                          arrow::default_memory_pool(), mStream, props.build(),
+                          arrow_props.build()));
+    return arrow::Status::OK();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Builders in schema order
+  //----------------------------------------------------------------------------
+  std::vector<arrow::ArrayBuilder*> builders()
+  {
+    std::vector<arrow::ArrayBuilder*> all = {
+      &mType, &mId, &mParentId, &mName, &mPath, &mUid, &mGid, &mSize,
+      &mLayoutId, &mFlags, &mMode, &mCTime, &mMTime, &mSTime, &mATime,
+      &mChecksum, &mLinkName, &mLocations, &mUnlinkLocations
+    };
+
+    for (auto& builder : mXattrs) {
+      all.push_back(builder.get());
+    }
+
+    return all;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Keep track of the first failed append
+  //----------------------------------------------------------------------------
+  void check(const arrow::Status& st)
+  {
+    if (mStatus.ok() && !st.ok()) {
+      mStatus = st;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Append nullable string, empty values are stored as null
+  //----------------------------------------------------------------------------
+  void appendOptional(arrow::StringBuilder& builder, const std::string& val)
+  {
+    check(val.empty() ? builder.AppendNull() : builder.Append(val));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Append nullable timestamp, missing values are stored as null
+  //----------------------------------------------------------------------------
+  void appendOptional(arrow::TimestampBuilder& builder, const std::string& val)
+  {
+    check(val.empty() ? builder.AppendNull() :
+          builder.Append(toNanoseconds(val)));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Append location list
+  //----------------------------------------------------------------------------
+  template<typename T>
+  void appendLocations(arrow::ListBuilder& builder,
+                       arrow::UInt32Builder& values, const T& locations)
+  {
+    check(builder.Append());
+
+    for (const auto& loc : locations) {
+      check(values.Append(loc));
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Append selected extended attributes
+  //----------------------------------------------------------------------------
+  template<typename T>
+  void appendXattrs(const T& xattrs)
+  {
+    for (size_t i = 0; i < mOpts.xattrs.size(); ++i) {
+      auto it = xattrs.find(mOpts.xattrs[i]);
+
+      if (it == xattrs.end()) {
+        check(mXattrs[i]->AppendNull());
+      } else {
+        check(mXattrs[i]->Append(it->second));
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Append file row
+  //----------------------------------------------------------------------------
+  void append(const eos::ns::FileMdProto& proto, const std::string& path)
+  {
+    check(mType.Append("file"));
+    check(mId.Append(proto.id()));
+    check(mParentId.Append(proto.cont_id()));
+    check(mName.Append(proto.name()));
+    appendOptional(mPath, path);
+    check(mUid.Append(proto.uid()));
+    check(mGid.Append(proto.gid()));
+    check(mSize.Append(proto.size()));
+    check(mLayoutId.Append(proto.layout_id()));
+    check(mFlags.Append(proto.flags()));
+    check(mMode.AppendNull());
+    check(mCTime.Append(toNanoseconds(proto.ctime())));
+    check(mMTime.Append(toNanoseconds(proto.mtime())));
+    appendOptional(mSTime, proto.stime());
+    appendOptional(mATime, proto.atime());
+    std::string xs;
+    eos::appendChecksumOnStringProtobuf(proto, xs);
+    appendOptional(mChecksum, xs);
+    appendOptional(mLinkName, proto.link_name());
+    appendLocations(mLocations, *mLocationValues, proto.locations());
+    appendLocations(mUnlinkLocations, *mUnlinkLocationValues,
+                    proto.unlink_locations());
+    appendXattrs(proto.xattrs());
+    ++mPending;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Append container row
+  //----------------------------------------------------------------------------
+  void append(const eos::ns::ContainerMdProto& proto, const std::string& path)
+  {
+    check(mType.Append("container"));
+    check(mId.Append(proto.id()));
+    check(mParentId.Append(proto.parent_id()));
+    check(mName.Append(proto.name()));
+    appendOptional(mPath, path);
+    check(mUid.Append(proto.uid()));
+    check(mGid.Append(proto.gid()));
+    check(mSize.Append(proto.tree_size() > 0 ? proto.tree_size() : 0));
+    check(mLayoutId.AppendNull());
+    check(mFlags.Append(proto.flags()));
+    check(mMode.Append(proto.mode()));
+    check(mCTime.Append(toNanoseconds(proto.ctime())));
+    check(mMTime.Append(toNanoseconds(proto.mtime())));
+    appendOptional(mSTime, proto.stime());
+    check(mATime.AppendNull());
+    check(mChecksum.AppendNull());
+    check(mLinkName.AppendNull());
+    check(mLocations.AppendNull());
+    check(mUnlinkLocations.AppendNull());
+    appendXattrs(proto.xattrs());
+    ++mPending;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Write the buffered rows as one row group
+  //----------------------------------------------------------------------------
+  arrow::Status flush()
+  {
+    ARROW_RETURN_NOT_OK(mStatus);
+
+    if (mPending == 0) {
+      return arrow::Status::OK();
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+
+    for (auto* builder : builders()) {
+      std::shared_ptr<arrow::Array> array;
+      ARROW_RETURN_NOT_OK(builder->Finish(&array));
+      arrays.push_back(std::move(array));
+    }
+
+    auto table = arrow::Table::Make(mSchema, arrays, mPending);
+    mPending = 0;
+    return mFileWriter->WriteTable(*table, mOpts.rowGroupSize);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Flush and write the file footer
+  //----------------------------------------------------------------------------
+  arrow::Status close()
+  {
+    if (mClosed) {
+      return arrow::Status::OK();
+    }
+
+    mClosed = true;
+    arrow::Status st = flush();
+    arrow::Status close_st = mFileWriter->Close();
+
+    if (st.ok()) {
+      st = close_st;
+    }
+
+    close_st = mStream->Close();
+    return st.ok() ? close_st : st;
+  }
+
+  ParquetSinkOptions mOpts;
+  std::shared_ptr<arrow::Schema> mSchema;
+  std::shared_ptr<arrow::io::FileOutputStream> mStream;
+  std::unique_ptr<parquet::arrow::FileWriter> mFileWriter;
+  arrow::StringBuilder mType;
+  arrow::UInt64Builder mId;
+  arrow::UInt64Builder mParentId;
+  arrow::StringBuilder mName;
+  arrow::StringBuilder mPath;
+  arrow::UInt32Builder mUid;
+  arrow::UInt32Builder mGid;
+  arrow::UInt64Builder mSize;
+  arrow::UInt32Builder mLayoutId;
+  arrow::UInt32Builder mFlags;
+  arrow::UInt32Builder mMode;
+  arrow::TimestampBuilder mCTime;
+  arrow::TimestampBuilder mMTime;
+  arrow::TimestampBuilder mSTime;
+  arrow::TimestampBuilder mATime;
+  arrow::StringBuilder mChecksum;
+  arrow::StringBuilder mLinkName;
+  std::shared_ptr<arrow::UInt32Builder> mLocationValues;
+  std::shared_ptr<arrow::UInt32Builder> mUnlinkLocationValues;
+  arrow::ListBuilder mLocations;
+  arrow::ListBuilder mUnlinkLocations;
+  std::vector<std::unique_ptr<arrow::StringBuilder>> mXattrs;
+  size_t mPending {0}; ///< Rows buffered in the builders
+  arrow::Status mStatus; ///< First append error
+  bool mClosed {false};
+};
+
+//------------------------------------------------------------------------------
+// Create a Parquet sink writing to the given path
+//------------------------------------------------------------------------------
+std::unique_ptr<ParquetSink>
+ParquetSink::Create(const std::string& path, const ParquetSinkOptions& opts,
+                    std::ostream& out, std::ostream& err, std::string& errMsg)
+{
+  auto writer = std::make_unique<Writer>(opts);
+  arrow::Status st = writer->open(path);
+
+  if (!st.ok()) {
+    errMsg = "failed to open parquet output " + path + ": " + st.ToString();
+    return nullptr;
+  }
+
+  return std::unique_ptr<ParquetSink>(new ParquetSink(std::move(writer), out,
+                                      err));
+}
+
+//------------------------------------------------------------------------------
+// Flush pending rows and write the file footer
+//------------------------------------------------------------------------------
+bool ParquetSink::close()
+{
+  arrow::Status st = mWriter->close();
+
+  if (!st.ok()) {
+    reportError("failed to close parquet output: " + st.ToString());
+    return false;
+  }
+
+  return !mFailed;
+}
+
+//------------------------------------------------------------------------------
+// Account for a new row, write a row group once enough rows are buffered
+//------------------------------------------------------------------------------
+void ParquetSink::rowAdded()
+{
+  ++mRows;
+
+  if (mWriter->mPending >= mWriter->mOpts.rowGroupSize) {
+    arrow::Status st = mWriter->flush();
+
+    if (!st.ok()) {
+      reportError("failed to write parquet row group: " + st.ToString());
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Add file row
+//------------------------------------------------------------------------------
+void ParquetSink::addRow(const eos::ns::FileMdProto& proto,
+                         const std::string& path)
+{
+  if (mFailed) {
+    return;
+  }
+
+  mWriter->append(proto, path);
+  rowAdded();
+}
+
+//------------------------------------------------------------------------------
+// Add container row
+//------------------------------------------------------------------------------
+void ParquetSink::addRow(const eos::ns::ContainerMdProto& proto,
+                         const std::string& path)
+{
+  if (mFailed) {
+    return;
+  }
+
+  mWriter->append(proto, path);
+  rowAdded();
+}
+
+#else
+
+//------------------------------------------------------------------------------
+//! Placeholder when built without Parquet support
+//------------------------------------------------------------------------------
+struct ParquetSink::Writer {};
+
+//------------------------------------------------------------------------------
+// Create a Parquet sink writing to the given path
+//------------------------------------------------------------------------------
+std::unique_ptr<ParquetSink>
+ParquetSink::Create(const std::string& path, const ParquetSinkOptions& opts,
+                    std::ostream& out, std::ostream& err, std::string& errMsg)
+{
+  errMsg = "parquet output not supported, built without Apache Parquet";
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+// Flush pending rows and write the file footer
+//------------------------------------------------------------------------------
+bool ParquetSink::close()
+{
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Add file row
+//------------------------------------------------------------------------------
+void ParquetSink::addRow(const eos::ns::FileMdProto& proto,
+                         const std::string& path)
+{}
+
+//------------------------------------------------------------------------------
+// Add container row
+//------------------------------------------------------------------------------
+void ParquetSink::addRow(const eos::ns::ContainerMdProto& proto,
+                         const std::string& path)
+{}
+
+#endif
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ParquetSink::ParquetSink(std::unique_ptr<Writer> writer, std::ostream& out,
+                         std::ostream& err)
+  : OutputSink(out, err), mWriter(std::move(writer))
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ParquetSink::~ParquetSink()
+{
+  (void) close();
+}
+
+//------------------------------------------------------------------------------
+// Report the first error to the error stream
+//------------------------------------------------------------------------------
+void ParquetSink::reportError(const std::string& msg)
+{
+  if (!mFailed) {
+    mFailed = true;
+    err(msg);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Print interfaces without a schema are not supported
+//------------------------------------------------------------------------------
+void ParquetSink::print(const std::map<std::string, std::string>& line)
+{
+  reportError("parquet output is only supported for file and container "
+              "metadata listings");
+}
+
+void ParquetSink::print(const std::string& out)
+{
+  print(std::map<std::string, std::string>());
+}
+
+void ParquetSink::print(const Json::Value& json_obj)
+{
+  print(std::map<std::string, std::string>());
+}
+
+//------------------------------------------------------------------------------
+// Typed print interfaces
+//------------------------------------------------------------------------------
+void ParquetSink::print(const eos::ns::ContainerMdProto& proto,
+                        const ContainerPrintingOptions& opts)
+{
+  addRow(proto, "");
+}
+
+void ParquetSink::printWithCustomPath(const eos::ns::ContainerMdProto& proto,
+                                      const ContainerPrintingOptions& opts,
+                                      const std::string& customPath)
+{
+  addRow(proto, customPath);
+}
+
+void ParquetSink::print(const eos::ns::ContainerMdProto& proto,
+                        const ContainerPrintingOptions& opts,
+                        ContainerScanner::Item& item, bool showCounts)
+{
+  addRow(proto, populateFullPath(proto, item));
+}
+
+void ParquetSink::print(const eos::ns::FileMdProto& proto,
+                        const FilePrintingOptions& opts)
+{
+  addRow(proto, "");
+}
+
+void ParquetSink::printWithCustomPath(const eos::ns::FileMdProto& proto,
+                                      const FilePrintingOptions& opts,
+                                      const std::string& customPath)
+{
+  addRow(proto, customPath);
+}
+
+void ParquetSink::print(const eos::ns::FileMdProto& proto,
+                        const FilePrintingOptions& opts, FileScanner::Item& item)
+{
+  addRow(proto, populateFullPath(proto, item));
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,154 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief OutputSink writing file and container metadata to a Parquet file
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/ns_quarkdb/inspector/OutputSink.hh"
+#include <memory>
+#include <string>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Options of the Parquet sink
+//------------------------------------------------------------------------------
+struct ParquetSinkOptions {
+  //! Number of rows buffered in memory before being written as a row group
+  size_t rowGroupSize = 128 * 1024;
+  //! Extended attributes exported as dedicated columns "xattr.<name>"
+  std::vector<std::string> xattrs;
+};
+
+//------------------------------------------------------------------------------
+//! OutputSink implementation writing a ZSTD compressed Parquet file. Files
+//! and containers share one schema, distinguished by the "type" column:
+//!
+//! type, id, parent_id, name, path, uid, gid, size, layout_id, flags, mode,
+//! ctime, mtime, stime, atime, checksum, link_name, locations,
+//! unlink_locations, xattr.<name> ...
+//!
+//! For containers "size" holds the tree size, fields not applicable to the
+//! entry type are null. Rows are accumulated in column builders and flushed
+//! as one row group every rowGroupSize rows, so memory usage stays bounded
+//! independently of the namespace size.
+//!
+//! Only the typed print interfaces are supported, everything else is
+//! reported as an error.
+//------------------------------------------------------------------------------
+class ParquetSink : public OutputSink
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Create a Parquet sink writing to the given path
+  //!
+  //! @param path output file path
+  //! @param opts sink options
+  //! @param out output stream for non-tabular messages
+  //! @param err error stream
+  //! @param errMsg error message in case of failure
+  //!
+  //! @return sink object or nullptr if the file could not be opened or the
+  //!         build has no Parquet support
+  //----------------------------------------------------------------------------
+  static std::unique_ptr<ParquetSink>
+  Create(const std::string& path, const ParquetSinkOptions& opts,
+         std::ostream& out, std::ostream& err, std::string& errMsg);
+
+  //----------------------------------------------------------------------------
+  //! Destructor - flushes pending rows and closes the file
+  //----------------------------------------------------------------------------
+  virtual ~ParquetSink();
+
+  //----------------------------------------------------------------------------
+  //! Flush pending rows and write the file footer
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool close();
+
+  //----------------------------------------------------------------------------
+  //! Get number of rows written so far
+  //----------------------------------------------------------------------------
+  uint64_t getRows() const
+  {
+    return mRows;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Print interfaces without a schema are not supported
+  //----------------------------------------------------------------------------
+  virtual void print(const std::map<std::string, std::string>& line) override;
+  virtual void print(const std::string& out) override;
+  virtual void print(const Json::Value& json_obj) override;
+
+  //----------------------------------------------------------------------------
+  //! Typed print interfaces, each call adds one row
+  //----------------------------------------------------------------------------
+  virtual void print(const eos::ns::ContainerMdProto& proto,
+                     const ContainerPrintingOptions& opts) override;
+  virtual void printWithCustomPath(const eos::ns::ContainerMdProto& proto,
+                                   const ContainerPrintingOptions& opts,
+                                   const std::string& customPath) override;
+  virtual void print(const eos::ns::ContainerMdProto& proto,
+                     const ContainerPrintingOptions& opts,
+                     ContainerScanner::Item& item, bool showCounts) override;
+  virtual void print(const eos::ns::FileMdProto& proto,
+                     const FilePrintingOptions& opts) override;
+  virtual void printWithCustomPath(const eos::ns::FileMdProto& proto,
+                                   const FilePrintingOptions& opts,
+                                   const std::string& customPath) override;
+  virtual void print(const eos::ns::FileMdProto& proto,
+                     const FilePrintingOptions& opts,
+                     FileScanner::Item& item) override;
+
+private:
+  struct Writer;
+
+  //----------------------------------------------------------------------------
+  //! Private constructor, use Create
+  //----------------------------------------------------------------------------
+  ParquetSink(std::unique_ptr<Writer> writer, std::ostream& out,
+              std::ostream& err);
+
+  //----------------------------------------------------------------------------
+  //! Add one row
+  //----------------------------------------------------------------------------
+  void addRow(const eos::ns::FileMdProto& proto, const std::string& path);
+  void addRow(const eos::ns::ContainerMdProto& proto, const std::string& path);
+
+  //----------------------------------------------------------------------------
+  //! Account for a new row, write a row group once enough rows are buffered
+  //----------------------------------------------------------------------------
+  void rowAdded();
+
+  //----------------------------------------------------------------------------
+  //! Report the first error to the error stream
+  //----------------------------------------------------------------------------
+  void reportError(const std::string& msg);
+
+  std::unique_ptr<Writer> mWriter;
+  uint64_t mRows {0};
+  bool mFailed {false};
+};
+
+EOSNSNAMESPACE_END
@@ -28,6 +28,7 @@
 #include "common/Assert.hh"
 #include "common/Logging.hh"
 #include "common/StacktraceHere.hh"
+#include <cstdlib>
 #include <memory>
 #include <numeric>
 
@@ -385,4 +386,71 @@ QuarkContainerMDSvc::blacklistBelow(ContainerIdentifier id)
   mUnifiedInodeProvider->blacklistContainerId(id.getUnderlyingUInt64());
 }
 
+//------------------------------------------------------------------------------
+// Persist the ids of the most recently used cached containers as a comma
+// separated list
+//------------------------------------------------------------------------------
+uint64_t
+QuarkContainerMDSvc::saveHotSet(uint64_t max_num)
+{
+  std::vector<ContainerIdentifier> ids =
+    mMetadataProvider->getHotContainers(max_num);
+  std::string value;
+  value.reserve(ids.size() * 8);
+
+  for (const auto& id : ids) {
+    if (!value.empty()) {
+      value += ',';
+    }
+
+    value += std::to_string(id.getUnderlyingUInt64());
+  }
+
+  qclient::redisReplyPtr reply =
+    pQcl->exec("SET", constants::sHotContainersKey, value).get();
+
+  if (!reply || (reply->type == REDIS_REPLY_ERROR)) {
+    MDException e(EIO);
+    e.getMessage() << __FUNCTION__ << " failed to save the hot containers";
+    throw e;
+  }
+
+  return ids.size();
+}
+
+//------------------------------------------------------------------------------
+// Load the ids persisted by saveHotSet
+//------------------------------------------------------------------------------
+std::vector<IContainerMD::id_t>
+QuarkContainerMDSvc::loadHotSet()
+{
+  std::vector<IContainerMD::id_t> ids;
+  qclient::redisReplyPtr reply =
+    pQcl->exec("GET", constants::sHotContainersKey).get();
+
+  if (!reply || (reply->type != REDIS_REPLY_STRING)) {
+    return ids;
+  }
+
+  const char* ptr = reply->str;
+  const char* end = reply->str + reply->len;
+
+  while (ptr < end) {
+    char* next = nullptr;
+    IContainerMD::id_t id = std::strtoull(ptr, &next, 10);
+
+    if (next == ptr) {
+      break;
+    }
+
+    if (id) {
+      ids.push_back(id);
+    }
+
+    ptr = (*next == ',') ? next + 1 : next;
+  }
+
+  return ids;
+}
+
 EOSNSNAMESPACE_END
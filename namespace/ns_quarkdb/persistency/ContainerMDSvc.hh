@@ -201,6 +201,16 @@ public:
   //----------------------------------------------------------------------------
   virtual void blacklistBelow(ContainerIdentifier id) override;
 
+  //----------------------------------------------------------------------------
+  //! Persist the ids of the most recently used cached containers
+  //----------------------------------------------------------------------------
+  uint64_t saveHotSet(uint64_t max_num) override;
+
+  //----------------------------------------------------------------------------
+  //! Load the ids persisted by saveHotSet, hottest first
+  //----------------------------------------------------------------------------
+  std::vector<IContainerMD::id_t> loadHotSet() override;
+
 private:
   typedef std::list<IContainerMDChangeListener*> ListenerList;
 
@@ -26,6 +26,7 @@
 #include "namespace/ns_quarkdb/QdbContactDetails.hh"
 #include <folly/Executor.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <algorithm>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -180,6 +181,33 @@ CacheStatistics MetadataProvider::getContainerMDCacheStats()
   return globalStats;
 }
 
+//------------------------------------------------------------------------------
+// Get the ids of the most recently used cached containers
+//------------------------------------------------------------------------------
+std::vector<ContainerIdentifier>
+MetadataProvider::getHotContainers(uint64_t max_num)
+{
+  std::vector<std::vector<ContainerIdentifier>> per_shard;
+  size_t longest = 0;
+
+  for (size_t i = 0; i < mShards.size(); i++) {
+    per_shard.emplace_back(mShards[i]->getHotContainers(max_num));
+    longest = std::max(longest, per_shard.back().size());
+  }
+
+  std::vector<ContainerIdentifier> ids;
+
+  for (size_t pos = 0; (pos < longest) && (ids.size() < max_num); pos++) {
+    for (size_t i = 0; (i < per_shard.size()) && (ids.size() < max_num); i++) {
+      if (pos < per_shard[i].size()) {
+        ids.push_back(per_shard[i][pos]);
+      }
+    }
+  }
+
+  return ids;
+}
+
 //------------------------------------------------------------------------------
 //! Pick shard based on FileIdentifier
 //------------------------------------------------------------------------------
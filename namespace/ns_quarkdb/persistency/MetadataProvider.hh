@@ -108,6 +108,14 @@ public:
   //----------------------------------------------------------------------------
   CacheStatistics getContainerMDCacheStats();
 
+  //----------------------------------------------------------------------------
+  //! Get the ids of the most recently used cached containers, interleaving
+  //! the shards so that each of them contributes evenly
+  //!
+  //! @param max_num maximum number of ids to return
+  //----------------------------------------------------------------------------
+  std::vector<ContainerIdentifier> getHotContainers(uint64_t max_num);
+
 private:
   //----------------------------------------------------------------------------
   //! Pick shard based on FileIdentifier
@@ -355,4 +355,13 @@ CacheStatistics MetadataProviderShard::getContainerMDCacheStats()
   return stats;
 }
 
+//------------------------------------------------------------------------------
+// Get the ids of the most recently used cached containers
+//------------------------------------------------------------------------------
+std::vector<ContainerIdentifier>
+MetadataProviderShard::getHotContainers(uint64_t max_num)
+{
+  return mContainerCache.GetMostRecent(max_num);
+}
+
 EOSNSNAMESPACE_END
@@ -112,6 +112,11 @@ public:
   //----------------------------------------------------------------------------
   CacheStatistics getContainerMDCacheStats();
 
+  //----------------------------------------------------------------------------
+  //! Get the ids of the most recently used cached containers
+  //----------------------------------------------------------------------------
+  std::vector<ContainerIdentifier> getHotContainers(uint64_t max_num);
+
 private:
   //----------------------------------------------------------------------------
   //! Turn an incoming FileMDProto into FileMD, removing from the inFlight
@@ -0,0 +1,273 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Batched file removal tests
+//------------------------------------------------------------------------------
+#include "common/Constants.hh"
+#include "namespace/ns_quarkdb/flusher/MetadataFlusher.hh"
+#include "namespace/ns_quarkdb/tests/TestUtils.hh"
+#include "namespace/ns_quarkdb/utils/BatchFileRemover.hh"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <thread>
+
+class BatchFileRemoverF : public eos::ns::testing::NsTestsFixture {};
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Hooks counting the calls and treating the files named "keep*" as handled
+//------------------------------------------------------------------------------
+class CountingHooks : public eos::BatchFileRemover::Hooks
+{
+public:
+  void throttle(size_t nfiles) override
+  {
+    mThrottled += nfiles;
+  }
+
+  bool handled(const eos::IContainerMDPtr& cont,
+               const eos::IFileMDPtr& fmd) override
+  {
+    return (fmd->getName().find("keep") == 0);
+  }
+
+  void unlinked(const eos::IContainerMDPtr& cont, const std::string& cont_uri,
+                const eos::IFileMDPtr& fmd) override
+  {
+    EXPECT_EQ(cont_uri, "/recycle/uid:1/");
+    ++mUnlinked;
+  }
+
+  void batchDone(const eos::IContainerMDPtr& cont,
+                 const std::vector<std::string>& names) override
+  {
+    mNames += names.size();
+    ++mBatches;
+  }
+
+  std::atomic<uint64_t> mThrottled {0};
+  std::atomic<uint64_t> mUnlinked {0};
+  std::atomic<uint64_t> mNames {0};
+  std::atomic<uint64_t> mBatches {0};
+};
+
+//------------------------------------------------------------------------------
+// Hooks renaming every file they handle, like a version or hard link keeper
+//------------------------------------------------------------------------------
+class RenamingHooks : public eos::BatchFileRemover::Hooks
+{
+public:
+  explicit RenamingHooks(eos::IView* view): mView(view) {}
+
+  bool handled(const eos::IContainerMDPtr& cont,
+               const eos::IFileMDPtr& fmd) override
+  {
+    mView->renameFile(fmd.get(), "..kept." + fmd->getName());
+    return true;
+  }
+
+  void batchDone(const eos::IContainerMDPtr& cont,
+                 const std::vector<std::string>& names) override
+  {
+    mNames.insert(mNames.end(), names.begin(), names.end());
+  }
+
+  eos::IView* mView;
+  std::vector<std::string> mNames;
+};
+}
+
+//------------------------------------------------------------------------------
+// Files are unlinked, accounted out of the quota node and their record dropped
+// once no replica is left
+//------------------------------------------------------------------------------
+TEST_F(BatchFileRemoverF, RemoveFiles)
+{
+  eos::IContainerMDPtr cont = view()->createContainer("/recycle/uid:1/", true);
+  eos::IQuotaNode* node = view()->registerQuotaNode(cont.get());
+  ASSERT_NE(node, nullptr);
+  std::vector<eos::IFileMD::id_t> ids;
+
+  for (int i = 0; i < 25; ++i) {
+    eos::IFileMDPtr file = view()->createFile(SSTR("/recycle/uid:1/f" << i));
+    file->setCUid(1);
+    file->setCGid(2);
+    file->setSize(100);
+
+    if (i % 5 == 0) {
+      file->addLocation(3);
+    }
+
+    if (i % 5 == 1) {
+      file->addLocation(eos::common::TAPE_FS_ID);
+    }
+
+    view()->updateFileStore(file.get());
+    node->addFile(file.get());
+    ids.push_back(file->getId());
+  }
+
+  eos::IFileMDPtr keep = view()->createFile("/recycle/uid:1/keep");
+  keep->setCUid(1);
+  keep->setCGid(2);
+  view()->updateFileStore(keep.get());
+  node->addFile(keep.get());
+  ASSERT_EQ(node->getNumFilesByUser(1), 26);
+  CountingHooks hooks;
+  eos::BatchFileRemover::Options opts;
+  opts.batchSize = 7;
+  opts.nsMutex = &nsMutex;
+  opts.dropLocation = eos::common::TAPE_FS_ID;
+  eos::BatchFileRemover remover(view(), fileSvc(), containerSvc(), opts,
+                                &hooks);
+  auto result = remover.removeFiles(cont->getId());
+  ASSERT_EQ(result.removed, 26);
+  ASSERT_EQ(result.failed, 0);
+  ASSERT_EQ(result.batches, 4);
+  ASSERT_EQ(hooks.mBatches, 4);
+  ASSERT_EQ(hooks.mThrottled, 26);
+  ASSERT_EQ(hooks.mNames, 26);
+  ASSERT_EQ(hooks.mUnlinked, 25);
+  ASSERT_EQ(node->getNumFilesByUser(1), 0);
+  ASSERT_EQ(node->getUsedSpaceByGroup(2), 0);
+  // Only the handled file is still attached
+  ASSERT_EQ(cont->getNumFiles(), 1);
+  mdFlusher()->synchronize();
+
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (i % 5 == 0) {
+      // Replica still to be deleted by the FST
+      eos::IFileMDPtr file = fileSvc()->getFileMD(ids[i]);
+      ASSERT_EQ(file->getContainerId(), 0);
+      ASSERT_EQ(file->getNumLocation(), 0);
+      ASSERT_EQ(file->getNumUnlinkedLocation(), 1);
+    } else {
+      ASSERT_THROW(fileSvc()->getFileMD(ids[i]), eos::MDException);
+    }
+  }
+
+  // Nothing left to do on a second pass but the handled file
+  result = remover.removeFiles(cont->getId());
+  ASSERT_EQ(result.removed, 1);
+  ASSERT_EQ(result.batches, 1);
+}
+
+//------------------------------------------------------------------------------
+// The batch reports the names the files had before the hooks renamed them
+//------------------------------------------------------------------------------
+TEST_F(BatchFileRemoverF, NamesBeforeHooks)
+{
+  eos::IContainerMDPtr cont = view()->createContainer("/recycle/uid:2/", true);
+
+  for (int i = 0; i < 3; ++i) {
+    eos::IFileMDPtr file = view()->createFile(SSTR("/recycle/uid:2/f" << i));
+    view()->updateFileStore(file.get());
+  }
+
+  RenamingHooks hooks(view());
+  eos::BatchFileRemover::Options opts;
+  opts.nsMutex = &nsMutex;
+  eos::BatchFileRemover remover(view(), fileSvc(), containerSvc(), opts,
+                                &hooks);
+  auto result = remover.removeFiles(cont->getId());
+  ASSERT_EQ(result.removed, 3);
+  std::sort(hooks.mNames.begin(), hooks.mNames.end());
+  ASSERT_EQ(hooks.mNames, (std::vector<std::string> {"f0", "f1", "f2"}));
+  ASSERT_TRUE(cont->findFile("..kept.f0") != nullptr);
+}
+
+//------------------------------------------------------------------------------
+// Fill a recycle bin with 1M entries spread over day shards and measure the
+// purge time. Run with --gtest_also_run_disabled_tests, the number of entries
+// and of threads can be changed with EOS_RECYCLE_BENCH_FILES and
+// EOS_RECYCLE_BENCH_THREADS.
+//------------------------------------------------------------------------------
+TEST_F(BatchFileRemoverF, DISABLED_BenchmarkPurge)
+{
+  const uint64_t nfiles = getenv("EOS_RECYCLE_BENCH_FILES") ?
+                          std::stoull(getenv("EOS_RECYCLE_BENCH_FILES")) :
+                          1000000;
+  const unsigned int nthreads = getenv("EOS_RECYCLE_BENCH_THREADS") ?
+                                std::stoul(getenv("EOS_RECYCLE_BENCH_THREADS")) :
+                                8;
+  const uint64_t nshards = 100;
+  const uint64_t per_shard = (nfiles + nshards - 1) / nshards;
+  eos::IContainerMDPtr top = view()->createContainer("/recycle/", true);
+  eos::IQuotaNode* node = view()->registerQuotaNode(top.get());
+  std::vector<eos::IContainerMD::id_t> shards;
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint64_t shard = 0; shard < nshards; ++shard) {
+    const std::string dpath = SSTR("/recycle/uid:1/2026/01/01/" << shard << "/");
+    shards.push_back(view()->createContainer(dpath, true)->getId());
+
+    for (uint64_t i = 0; i < per_shard; ++i) {
+      eos::IFileMDPtr file = view()->createFile(SSTR(dpath << "#:#eos#:#f"
+                             << i << ".0000000" << i));
+      file->setCUid(1);
+      file->setCGid(1);
+      file->setSize(4096);
+      view()->updateFileStore(file.get());
+      node->addFile(file.get());
+    }
+  }
+
+  mdFlusher()->synchronize();
+  auto fill_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                 (std::chrono::steady_clock::now() - start).count();
+  std::cout << "filled " << nshards * per_shard << " entries in " << fill_ms
+            << " ms" << std::endl;
+  eos::BatchFileRemover::Options opts;
+  opts.nsMutex = &nsMutex;
+  std::atomic<size_t> next {0};
+  std::atomic<uint64_t> removed {0};
+  start = std::chrono::steady_clock::now();
+  auto worker = [&]() {
+    eos::BatchFileRemover remover(view(), fileSvc(), containerSvc(), opts);
+
+    for (size_t idx = next++; idx < shards.size(); idx = next++) {
+      removed += remover.removeFiles(shards[idx]).removed;
+    }
+  };
+  std::vector<std::thread> workers;
+
+  for (unsigned int i = 0; i < nthreads; ++i) {
+    workers.emplace_back(worker);
+  }
+
+  for (auto& thread : workers) {
+    thread.join();
+  }
+
+  mdFlusher()->synchronize();
+  auto purge_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                  (std::chrono::steady_clock::now() - start).count();
+  std::cout << "purged " << removed << " entries with " << nthreads
+            << " threads in " << purge_ms << " ms ("
+            << (purge_ms ? 1000 * removed / purge_ms : removed)
+            << " files/s)" << std::endl;
+  ASSERT_EQ(removed, nshards * per_shard);
+  ASSERT_EQ(node->getNumFilesByUser(1), 0);
+}
@@ -27,6 +27,7 @@
 #include "namespace/ns_quarkdb/views/HierarchicalView.hh"
 #include "namespace/ns_quarkdb/tests/TestUtils.hh"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <memory>
 
 class ContainerMDSvcF : public eos::ns::testing::NsTestsFixture {};
@@ -143,4 +144,25 @@ TEST_F(ContainerMDSvcF, getContainerMDWhenContIsLockedShouldNotLock) {
     auto cont = containerSvc()->getContainerMD(id);
   });
   t.join();
-}
\ No newline at end of file
+}
+TEST_F(ContainerMDSvcF, HotSetSaveLoad)
+{
+  // Nothing saved yet
+  ASSERT_TRUE(containerSvc()->loadHotSet().empty());
+  auto cont1 = view()->createContainer("/hot1/", true);
+  auto cont2 = view()->createContainer("/hot2/", true);
+  auto cont3 = view()->createContainer("/hot3/", true);
+  // Make cont1 the most recently used container
+  ASSERT_EQ(containerSvc()->getContainerMD(cont1->getId()), cont1);
+  ASSERT_EQ(containerSvc()->saveHotSet(2), 2u);
+  std::vector<eos::IContainerMD::id_t> ids = containerSvc()->loadHotSet();
+  ASSERT_EQ(ids.size(), 2u);
+  ASSERT_EQ(ids[0], cont1->getId());
+  ASSERT_LE(containerSvc()->saveHotSet(100), 100u);
+  ids = containerSvc()->loadHotSet();
+  ASSERT_NE(std::find(ids.begin(), ids.end(), cont2->getId()), ids.end());
+  ASSERT_NE(std::find(ids.begin(), ids.end(), cont3->getId()), ids.end());
+  // An empty hot set overwrites the previous one
+  ASSERT_EQ(containerSvc()->saveHotSet(0), 0u);
+  ASSERT_TRUE(containerSvc()->loadHotSet().empty());
+}
@@ -0,0 +1,219 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Namespace statistics sketches tests
+//------------------------------------------------------------------------------
+#include "common/LayoutId.hh"
+#include "namespace/ns_quarkdb/accounting/NamespaceSketch.hh"
+#include "namespace/ns_quarkdb/tests/TestUtils.hh"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+
+class NamespaceSketchF : public eos::ns::testing::NsTestsFixture {};
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Check that the estimate is within the given relative error of the value
+//------------------------------------------------------------------------------
+void
+ExpectClose(double expected, double estimate, double rel_err,
+            const std::string& what)
+{
+  const double err = std::fabs(estimate - expected) / std::max(expected, 1.0);
+  EXPECT_LE(err, rel_err) << what << ": exact=" << expected << " estimate="
+                          << estimate;
+}
+}
+
+//------------------------------------------------------------------------------
+// Signed updates, merging and percentiles of a single sketch
+//------------------------------------------------------------------------------
+TEST(NamespaceSketch, UpdateAndMerge)
+{
+  eos::NamespaceSketch sketch;
+  const time_t now = 100 * 86400;
+
+  for (uint64_t i = 1; i <= 100; ++i) {
+    sketch.update(i * 1000, now - i * 86400, (i % 2) ? 2 : 1, i % 10, 1);
+  }
+
+  ASSERT_EQ(sketch.getFiles(), 100);
+  ASSERT_EQ(sketch.getBytes(), 5050 * 1000);
+  ASSERT_NEAR(sketch.getUids(), 10, 1);
+  ASSERT_DOUBLE_EQ(sketch.getMeanStripes(), 1.5);
+  // Bucket precision is 12.5%
+  ASSERT_NEAR(sketch.getSizePercentile(50), 50000, 50000 / 8);
+  ASSERT_EQ(sketch.getAgePercentile(50, now), 50 * 86400);
+  ASSERT_EQ(sketch.getAgeCumulative({10 * 86400}, now)[0], 10);
+  // Removing files is symmetric
+  eos::NamespaceSketch other;
+
+  for (uint64_t i = 1; i <= 50; ++i) {
+    other.update(i * 1000, now - i * 86400, (i % 2) ? 2 : 1, i % 10, -1);
+  }
+
+  sketch.merge(other);
+  ASSERT_EQ(sketch.getFiles(), 50);
+  ASSERT_EQ(sketch.getSizeCumulative({40000})[0], 0);
+  ASSERT_EQ(sketch.getSizeCumulative({200000})[0], 50);
+  ASSERT_EQ(sketch.getAgeCumulative({50 * 86400}, now)[0], 0);
+  ASSERT_EQ(sketch.getStripeHistogram()[1], 25);
+  ASSERT_EQ(sketch.getStripeHistogram()[2], 25);
+}
+
+//------------------------------------------------------------------------------
+// The sketches follow the files added to and removed from the quota nodes
+//------------------------------------------------------------------------------
+TEST_F(NamespaceSketchF, QuotaUpdates)
+{
+  auto accounting = std::make_shared<eos::NamespaceSketchAccounting>();
+  view()->getQuotaStats()->setFileListener(accounting);
+  eos::IContainerMDPtr top = view()->createContainer("/eos/top/", true);
+  eos::IContainerMDPtr sub = view()->createContainer("/eos/top/sub/", true);
+  eos::IQuotaNode* top_node = view()->registerQuotaNode(top.get());
+  eos::IQuotaNode* sub_node = view()->registerQuotaNode(sub.get());
+  const unsigned long layout = eos::common::LayoutId::GetId(
+                                 eos::common::LayoutId::kReplica,
+                                 eos::common::LayoutId::kAdler, 2);
+
+  for (int i = 0; i < 20; ++i) {
+    eos::IContainerMDPtr cont = (i < 10) ? top : sub;
+    eos::IFileMDPtr file = view()->createFile(SSTR(view()->getUri(cont.get())
+                           << "f" << i));
+    file->setCUid(i);
+    file->setSize(1024 * (i + 1));
+    file->setLayoutId(layout);
+    view()->updateFileStore(file.get());
+    ((i < 10) ? top_node : sub_node)->addFile(file.get());
+  }
+
+  eos::NamespaceSketch sketch;
+  ASSERT_TRUE(accounting->getSketch(top->getId(), sketch));
+  ASSERT_EQ(sketch.getFiles(), 10);
+  ASSERT_NEAR(sketch.getUids(), 10, 1);
+  ASSERT_DOUBLE_EQ(sketch.getMeanStripes(), 2.0);
+  ASSERT_TRUE(accounting->getSketch(sub->getId(), sketch));
+  ASSERT_EQ(sketch.getFiles(), 10);
+  // Size change seen as a removal followed by an addition
+  eos::IFileMDPtr file = view()->getFile("/eos/top/f0");
+  top_node->removeFile(file.get());
+  file->setSize(1ull << 30);
+  top_node->addFile(file.get());
+  ASSERT_TRUE(accounting->getSketch(top->getId(), sketch));
+  ASSERT_EQ(sketch.getFiles(), 10);
+  ASSERT_EQ(sketch.getSizePercentile(100), (1ull << 30) + (1ull << 27) - 1);
+  // Removing a quota node melds its sketch into the parent one
+  view()->removeQuotaNode(sub.get());
+  ASSERT_FALSE(accounting->getSketch(sub->getId(), sketch));
+  ASSERT_TRUE(accounting->getSketch(top->getId(), sketch));
+  ASSERT_EQ(sketch.getFiles(), 20);
+  ASSERT_NEAR(sketch.getUids(), 20, 1);
+  // Rebuild from a scan replaces the sketches, the live updates received in
+  // the meantime are kept
+  accounting->beginRebuild();
+  accounting->rebuildFile(top->getId(), 12345, 10, 0, 1, 1000);
+  file = view()->getFile("/eos/top/f1");
+  top_node->removeFile(file.get());
+  accounting->endRebuild(true);
+  ASSERT_TRUE(accounting->getSketch(top->getId(), sketch));
+  ASSERT_EQ(sketch.getFiles(), 0);
+  ASSERT_EQ(sketch.getBytes(), 0);
+  ASSERT_EQ(accounting->getNumRebuilds(), 1);
+  view()->getQuotaStats()->setFileListener(nullptr);
+}
+
+//------------------------------------------------------------------------------
+// Accuracy of the sampled sketches on a synthetic namespace of files with
+// log-normal sizes, ages spread over five years and a few thousand owners.
+// The number of files can be raised with EOS_NSSTATS_BENCH_FILES to check
+// the accuracy on a namespace of realistic size and with higher sample rates.
+//------------------------------------------------------------------------------
+TEST(NamespaceSketch, SampledAccuracy)
+{
+  const uint64_t nfiles = getenv("EOS_NSSTATS_BENCH_FILES") ?
+                          std::stoull(getenv("EOS_NSSTATS_BENCH_FILES")) :
+                          10000;
+  const time_t now = 2000000000;
+  std::mt19937_64 gen(42);
+  std::lognormal_distribution<double> size_dist(14.0, 2.5);
+  std::uniform_int_distribution<int64_t> age_dist(0, 5 * 365 * 86400);
+  std::uniform_int_distribution<uint64_t> uid_dist(1, 3000);
+  std::discrete_distribution<int> stripe_dist({0, 10, 70, 0, 0, 0, 20});
+  std::vector<uint64_t> sizes;
+  std::vector<int64_t> ages;
+  std::set<uint64_t> uids;
+  double stripe_sum = 0;
+  sizes.reserve(nfiles);
+  ages.reserve(nfiles);
+
+  for (uint64_t rate : {
+         1, 10, 100
+       }) {
+    // The error bounds below only hold with enough samples
+    if (nfiles / rate < 1000) {
+      continue;
+    }
+
+    eos::NamespaceSketchAccounting accounting(rate);
+    gen.seed(42);
+    sizes.clear();
+    ages.clear();
+    uids.clear();
+    stripe_sum = 0;
+
+    for (uint64_t fid = 1; fid <= nfiles; ++fid) {
+      const uint64_t size = (uint64_t) size_dist(gen);
+      const int64_t age = age_dist(gen);
+      const uint64_t uid = uid_dist(gen);
+      const int stripes = stripe_dist(gen);
+      sizes.push_back(size);
+      ages.push_back(age);
+      uids.insert(uid);
+      stripe_sum += stripes;
+      accounting.account(1, fid, size, now - age, stripes, uid, 1);
+    }
+
+    std::sort(sizes.begin(), sizes.end());
+    std::sort(ages.begin(), ages.end());
+    eos::NamespaceSketch sketch;
+    ASSERT_TRUE(accounting.getSketch(1, sketch));
+    // Sampling error of a proportion p out of n/rate samples plus the
+    // bucket precision of 12.5% for the sizes and one day for the ages
+    const double sampling = 4.0 / std::sqrt((double) nfiles / rate);
+    ExpectClose(nfiles, sketch.getFiles(), sampling, "files");
+    ExpectClose(sizes[nfiles / 2], sketch.getSizePercentile(50),
+                0.125 + 4 * sampling, "size p50");
+    ExpectClose(sizes[nfiles * 9 / 10], sketch.getSizePercentile(90),
+                0.125 + 4 * sampling, "size p90");
+    ExpectClose(ages[nfiles / 2], sketch.getAgePercentile(50, now),
+                0.01 + sampling, "age p50");
+    ExpectClose(ages[nfiles * 9 / 10], sketch.getAgePercentile(90, now),
+                0.01 + sampling, "age p90");
+    ExpectClose(stripe_sum / nfiles, sketch.getMeanStripes(), sampling,
+                "stripes mean");
+    // Owners without any sampled file are missed
+    ExpectClose(uids.size(), sketch.getUids(),
+                0.05 + std::exp(-(double) nfiles / rate / uids.size()), "uids");
+  }
+}
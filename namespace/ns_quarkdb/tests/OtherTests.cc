@@ -181,6 +181,34 @@ TEST(LRU, BasicSanity)
   ASSERT_TRUE(!cache.get(100));
 }
 
+TEST(LRU, MostRecent)
+{
+  struct Entry {
+    explicit Entry(std::uint64_t id) : id_(id) {}
+
+    std::uint64_t
+    getId() const
+    {
+      return id_;
+    }
+
+    std::uint64_t id_;
+  };
+  eos::LRU<std::uint64_t, Entry> cache{100};
+  ASSERT_TRUE(cache.GetMostRecent(10).empty());
+
+  for (std::uint64_t id = 0; id < 5; ++id) {
+    ASSERT_TRUE(cache.put(id, std::make_shared<Entry>(id)));
+  }
+
+  // Accessing an entry makes it the most recent one
+  ASSERT_TRUE(cache.get(1));
+  ASSERT_EQ(cache.GetMostRecent(3), std::vector<std::uint64_t>({1, 4, 3}));
+  ASSERT_EQ(cache.GetMostRecent(10),
+            std::vector<std::uint64_t>({1, 4, 3, 2, 0}));
+  ASSERT_TRUE(cache.GetMostRecent(0).empty());
+}
+
 TEST(PathProcessor, AbsPathTest)
 {
   std::string path = "/a/b/c/d/";
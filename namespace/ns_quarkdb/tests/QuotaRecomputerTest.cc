@@ -0,0 +1,345 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Parallel quota recomputation tests
+//------------------------------------------------------------------------------
+#include "common/LayoutId.hh"
+#include "namespace/ns_quarkdb/accounting/QuotaStats.hh"
+#include "namespace/ns_quarkdb/flusher/MetadataFlusher.hh"
+#include "namespace/ns_quarkdb/tests/TestUtils.hh"
+#include "namespace/ns_quarkdb/utils/QuotaRecomputer.hh"
+#include "namespace/ns_quarkdb/utils/QuotaRecomputeSession.hh"
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+
+class QuotaRecomputerF : public eos::ns::testing::NsTestsFixture {};
+
+using Range = eos::QuotaRecomputeSession::Range;
+using UsageMap = eos::QuotaRecomputeSession::UsageMap;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Physical size as computed by the QuotaRecomputer
+//------------------------------------------------------------------------------
+uint64_t
+mapSize(const eos::IFileMD* file)
+{
+  return file->getSize() *
+         eos::common::LayoutId::GetSizeFactor(file->getLayoutId());
+}
+
+eos::QuotaNodeCore::UsageInfo
+makeUsage(uint64_t space, uint64_t physical, uint64_t files)
+{
+  eos::QuotaNodeCore::UsageInfo info;
+  info.space = space;
+  info.physicalSpace = physical;
+  info.files = files;
+  return info;
+}
+
+Range
+makeRange(eos::IContainerMD::id_t id, const std::string& path, bool subtree)
+{
+  Range range;
+  range.mId = id;
+  range.mPath = path;
+  range.mSubtree = subtree;
+  return range;
+}
+
+//------------------------------------------------------------------------------
+// Create a file and account it in the given quota node
+//------------------------------------------------------------------------------
+eos::IFileMDPtr
+createFile(eos::IView* view, eos::IQuotaNode* node, const std::string& path,
+           uid_t uid, gid_t gid, uint64_t size)
+{
+  static const unsigned long layoutId = eos::common::LayoutId::GetId(
+      eos::common::LayoutId::kReplica, eos::common::LayoutId::kMD5, 2,
+      eos::common::LayoutId::k4k);
+  eos::IFileMDPtr file = view->createFile(path, true);
+  file->setCUid(uid);
+  file->setCGid(gid);
+  file->setSize(size);
+  file->setLayoutId(layoutId);
+  view->updateFileStore(file.get());
+
+  if (node) {
+    node->addFile(file.get());
+  }
+
+  return file;
+}
+
+//------------------------------------------------------------------------------
+// Populate a synthetic tree of ndirs directories holding nsubdirs
+// subdirectories with nfiles files each, plus nfiles files in the root
+//------------------------------------------------------------------------------
+void
+createTree(eos::IView* view, eos::IQuotaNode* node, const std::string& root,
+           int ndirs, int nsubdirs, int nfiles)
+{
+  for (int k = 0; k < nfiles; ++k) {
+    createFile(view, node, SSTR(root << "f" << k), k % 7, k % 3, 1000 + k);
+  }
+
+  for (int i = 0; i < ndirs; ++i) {
+    for (int j = 0; j < nsubdirs; ++j) {
+      for (int k = 0; k < nfiles; ++k) {
+        createFile(view, node, SSTR(root << "d" << i << "/s" << j << "/f" << k),
+                   (i + k) % 7, (j + k) % 3, 10 * i + j + k);
+      }
+    }
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+// Updates are dropped, applied or trigger a rescan depending on when they
+// happened relative to the scan of the range holding their container
+//------------------------------------------------------------------------------
+TEST(QuotaRecomputeSession, Reconcile)
+{
+  eos::QuotaRecomputeSession session(10, "/quota/");
+  ASSERT_TRUE(session.needsSplit());
+  std::vector<Range> ranges {makeRange(10, "/quota/", false),
+                             makeRange(11, "/quota/a/", true)};
+  session.setRanges(std::move(ranges), session.getGeneration());
+  ASSERT_FALSE(session.needsSplit());
+  // Before any scan, included in the scan results
+  session.quotaUpdated(11, 1, 1, 100, 200, 1);
+  uint64_t generation = 0;
+  ASSERT_EQ(session.getPendingRanges(generation).size(), 2);
+  session.completeRange(0, generation, 1, 1, UsageMap{{1, makeUsage(50, 100, 1)}},
+                        UsageMap{{1, makeUsage(50, 100, 1)}}, {10});
+  // Raced with the scan of the second range
+  session.quotaUpdated(12, 1, 1, 10, 20, 1);
+  session.completeRange(1, generation, 1, 2, UsageMap{{1, makeUsage(100, 200, 1)}},
+                        UsageMap{{1, makeUsage(100, 200, 1)}}, {11, 12});
+  ASSERT_EQ(session.reconcile(false), 1);
+  ASSERT_EQ(session.getProgress(), std::make_pair<size_t, size_t>(2, 2));
+  ASSERT_EQ(session.reconcile(true), 1);
+  auto pending = session.getPendingRanges(generation);
+  ASSERT_EQ(pending.size(), 1);
+  ASSERT_EQ(pending[0].first, 1);
+  session.completeRange(1, generation, 2, 2, UsageMap{{1, makeUsage(110, 220, 2)}},
+                        UsageMap{{1, makeUsage(110, 220, 2)}}, {11, 12});
+  ASSERT_EQ(session.reconcile(true), 0);
+  // After the scan: removal in a visited container, addition in a new one and
+  // removal in a container deleted before being scanned
+  session.quotaUpdated(10, 1, 1, -50, -100, -1);
+  session.quotaUpdated(13, 2, 2, 7, 14, 1);
+  session.quotaUpdated(14, 3, 3, -5, -10, -1);
+  auto unvisited = session.getUnvisitedContainers();
+  std::sort(unvisited.begin(), unvisited.end());
+  ASSERT_EQ(unvisited, (std::vector<eos::IContainerMD::id_t> {13, 14}));
+  session.setRemovedContainers({14});
+  eos::QuotaNodeCore core;
+  ASSERT_EQ(session.finalize(core), 0);
+  ASSERT_EQ(core.getUsedSpaceByUser(1), 110);
+  ASSERT_EQ(core.getPhysicalSpaceByUser(1), 220);
+  ASSERT_EQ(core.getNumFilesByUser(1), 2);
+  ASSERT_EQ(core.getUsedSpaceByGroup(2), 7);
+  ASSERT_EQ(core.getPhysicalSpaceByGroup(2), 14);
+  ASSERT_EQ(core.getNumFilesByUser(2), 1);
+  ASSERT_EQ(core.getNumFilesByUser(3), 0);
+  ASSERT_EQ(core.getUids().count(3), 0);
+}
+
+//------------------------------------------------------------------------------
+// A reset drops the ranges and the results of the scans in flight
+//------------------------------------------------------------------------------
+TEST(QuotaRecomputeSession, Reset)
+{
+  eos::QuotaRecomputeSession session(10, "/quota/");
+  session.setRanges({makeRange(10, "/quota/", true)}, session.getGeneration());
+  uint64_t generation = 0;
+  ASSERT_EQ(session.getPendingRanges(generation).size(), 1);
+  session.quotaReset();
+  ASSERT_TRUE(session.needsSplit());
+  session.completeRange(0, generation, 0, 0, UsageMap{{1, makeUsage(1, 1, 1)}},
+                        UsageMap{}, {10});
+  ASSERT_EQ(session.reconcile(true), 1);
+  // Ranges computed before the reset are ignored as well
+  session.setRanges({makeRange(10, "/quota/", true)}, generation);
+  ASSERT_TRUE(session.needsSplit());
+  eos::QuotaNodeCore core;
+  ASSERT_NE(session.finalize(core), 0);
+  ASSERT_TRUE(session.acquire());
+  ASSERT_FALSE(session.acquire());
+  session.release();
+  session.close();
+  session.quotaUpdated(10, 1, 1, 1, 1, 1);
+  ASSERT_TRUE(session.getUnvisitedContainers().empty());
+}
+
+//------------------------------------------------------------------------------
+// The parallel recomputation gives the same result as the serial one and
+// skips the nested quota nodes
+//------------------------------------------------------------------------------
+TEST_F(QuotaRecomputerF, ParallelMatchesSerial)
+{
+  setSizeMapper(mapSize);
+  eos::IContainerMDPtr quota = view()->createContainer("/quota/", true);
+  eos::IQuotaNode* node = view()->registerQuotaNode(quota.get());
+  ASSERT_NE(node, nullptr);
+  createTree(view(), node, "/quota/", 6, 3, 5);
+  eos::IContainerMDPtr nested = view()->createContainer("/quota/d0/nested/",
+                                true);
+  eos::IQuotaNode* nested_node = view()->registerQuotaNode(nested.get());
+
+  for (int k = 0; k < 4; ++k) {
+    createFile(view(), nested_node, SSTR("/quota/d0/nested/f" << k), 999, 999,
+               4242);
+  }
+
+  mdFlusher()->synchronize();
+  const std::string uri = view()->getUri(quota.get());
+  eos::QuotaRecomputer recomputer(&(qcl()), executor());
+  eos::QuotaNodeCore serial;
+  ASSERT_TRUE(recomputer.recompute(uri, quota->getId(), serial).ok());
+  ASSERT_EQ(serial.getNumFilesByUser(999), 0);
+  ASSERT_TRUE(serial == node->getCore());
+  bool resumed = true;
+  auto session = eos::QuotaRecomputer::openSession(node, uri, resumed);
+  ASSERT_NE(session, nullptr);
+  ASSERT_FALSE(resumed);
+  ASSERT_EQ(eos::QuotaRecomputer::openSession(node, uri, resumed), nullptr);
+  eos::QuotaRecomputer::ParallelOptions opts;
+  opts.threads = 4;
+  opts.nsMutex = &nsMutex;
+  opts.flusher = mdFlusher();
+  ASSERT_TRUE(recomputer.recomputeParallel(*session, opts).ok());
+  auto progress = session->getProgress();
+  ASSERT_GT(progress.first, 1);
+  ASSERT_EQ(progress.first, progress.second);
+  // An interrupted session is picked up again with its completed ranges
+  session->release();
+  auto same = eos::QuotaRecomputer::openSession(node, uri, resumed);
+  ASSERT_EQ(same, session);
+  ASSERT_TRUE(resumed);
+  ASSERT_TRUE(recomputer.recomputeParallel(*session, opts).ok());
+  eos::QuotaNodeCore parallel;
+  ASSERT_EQ(session->finalize(parallel), 0);
+  eos::QuotaRecomputer::closeSession(node, session);
+  ASSERT_TRUE(parallel == serial);
+}
+
+//------------------------------------------------------------------------------
+// Updates of the quota node done while the session is open are reflected in
+// the final result
+//------------------------------------------------------------------------------
+TEST_F(QuotaRecomputerF, ConcurrentUpdates)
+{
+  setSizeMapper(mapSize);
+  eos::IContainerMDPtr quota = view()->createContainer("/quota/", true);
+  eos::IQuotaNode* node = view()->registerQuotaNode(quota.get());
+  ASSERT_NE(node, nullptr);
+  createTree(view(), node, "/quota/", 4, 2, 5);
+  mdFlusher()->synchronize();
+  const std::string uri = view()->getUri(quota.get());
+  eos::QuotaRecomputer recomputer(&(qcl()), executor());
+  bool resumed = false;
+  auto session = eos::QuotaRecomputer::openSession(node, uri, resumed);
+  ASSERT_NE(session, nullptr);
+  // Update before the scan, already visible to it
+  createFile(view(), node, "/quota/d0/s0/early", 50, 50, 123);
+  eos::QuotaRecomputer::ParallelOptions opts;
+  opts.threads = 3;
+  opts.nsMutex = &nsMutex;
+  opts.flusher = mdFlusher();
+  ASSERT_TRUE(recomputer.recomputeParallel(*session, opts).ok());
+  // Updates after the scan: new file in a scanned directory, files in a new
+  // directory, a removed file and a removed directory
+  createFile(view(), node, "/quota/d1/s1/late", 51, 51, 456);
+  createFile(view(), node, "/quota/new/late1", 52, 52, 789);
+  createFile(view(), node, "/quota/new/late2", 52, 52, 1);
+  eos::IFileMDPtr victim = view()->getFile("/quota/d2/s0/f1");
+  node->removeFile(victim.get());
+  view()->unlinkFile(victim.get());
+  view()->removeFile(victim.get());
+  createFile(view(), node, "/quota/gone/tmp", 53, 53, 10);
+  eos::IFileMDPtr tmp = view()->getFile("/quota/gone/tmp");
+  node->removeFile(tmp.get());
+  view()->unlinkFile(tmp.get());
+  view()->removeFile(tmp.get());
+  view()->removeContainer("/quota/gone");
+  mdFlusher()->synchronize();
+  // Resolve the unvisited containers of the new updates
+  ASSERT_TRUE(recomputer.recomputeParallel(*session, opts).ok());
+  eos::QuotaNodeCore parallel;
+  ASSERT_EQ(session->finalize(parallel), 0);
+  eos::QuotaRecomputer::closeSession(node, session);
+  eos::QuotaNodeCore serial;
+  ASSERT_TRUE(recomputer.recompute(uri, quota->getId(), serial).ok());
+  ASSERT_EQ(parallel.getNumFilesByUser(50), 1);
+  ASSERT_EQ(parallel.getNumFilesByUser(52), 2);
+  ASSERT_EQ(parallel.getNumFilesByUser(53), 0);
+  ASSERT_TRUE(parallel == serial);
+}
+
+//------------------------------------------------------------------------------
+// Compare the serial and the parallel recomputation on a synthetic tree
+//------------------------------------------------------------------------------
+TEST_F(QuotaRecomputerF, BenchmarkSyntheticTree)
+{
+  setSizeMapper(mapSize);
+  eos::IContainerMDPtr quota = view()->createContainer("/bench/", true);
+  eos::IQuotaNode* node = view()->registerQuotaNode(quota.get());
+  ASSERT_NE(node, nullptr);
+  createTree(view(), nullptr, "/bench/", 50, 4, 50);
+  mdFlusher()->synchronize();
+  const std::string uri = view()->getUri(quota.get());
+  eos::QuotaRecomputer recomputer(&(qcl()), executor());
+  eos::QuotaNodeCore serial;
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(recomputer.recompute(uri, quota->getId(), serial).ok());
+  auto serial_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                   (std::chrono::steady_clock::now() - start).count();
+  std::cout << "serial: " << serial_ms << " ms" << std::endl;
+
+  for (unsigned int threads : {
+         1, 4, 16
+       }) {
+    bool resumed = false;
+    auto session = eos::QuotaRecomputer::openSession(node, uri, resumed);
+    ASSERT_NE(session, nullptr);
+    eos::QuotaRecomputer::ParallelOptions opts;
+    opts.threads = threads;
+    opts.nsMutex = &nsMutex;
+    opts.flusher = mdFlusher();
+    start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(recomputer.recomputeParallel(*session, opts).ok());
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>
+              (std::chrono::steady_clock::now() - start).count();
+    std::cout << "parallel threads=" << threads << " ranges="
+              << session->getProgress().first << ": " << ms << " ms"
+              << std::endl;
+    eos::QuotaNodeCore parallel;
+    ASSERT_EQ(session->finalize(parallel), 0);
+    eos::QuotaRecomputer::closeSession(node, session);
+    ASSERT_TRUE(parallel == serial);
+  }
+}
@@ -24,9 +24,12 @@
 #include <memory>
 #include <gtest/gtest.h>
 #include <cstring>
+#include <chrono>
+#include <sys/resource.h>
 
 #include "namespace/interface/ContainerIterators.hh"
 #include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
 #include "namespace/ns_quarkdb/persistency/ContainerMDSvc.hh"
 #include "namespace/ns_quarkdb/persistency/FileMDSvc.hh"
 #include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
@@ -1141,6 +1144,130 @@ TEST_F(NamespaceExplorerF, ExpansionDecider)
   ASSERT_FALSE(explorer.fetch(item));
 }
 
+//------------------------------------------------------------------------------
+// Collect the items found by an explorer as (path, filtered out) pairs
+//------------------------------------------------------------------------------
+template<typename Explorer>
+static std::vector<std::pair<std::string, bool>> exploreAll(Explorer& explorer)
+{
+  std::vector<std::pair<std::string, bool>> found;
+  NamespaceItem item;
+
+  while (explorer.fetch(item)) {
+    found.emplace_back(item.fullPath, item.expansionFilteredOut);
+  }
+
+  return found;
+}
+
+TEST_F(NamespaceExplorerF, ParallelSameAsSequential)
+{
+  populateDummyData1();
+
+  for (unsigned int depth : {2u, 3u, 4u, 999u}) {
+    for (bool filter : {false, true}) {
+      ExplorationOptions options;
+      options.depthLimit = depth;
+
+      if (filter) {
+        options.expansionDecider.reset(new ContainerFilter());
+      }
+
+      NamespaceExplorer explorer("/", options, qcl(), executor());
+      auto expected = exploreAll(explorer);
+
+      for (size_t threads : {0, 1, 4}) {
+        for (size_t split : {1, 2, 3}) {
+          ParallelNamespaceExplorer::Options popts;
+          popts.threads = threads;
+          popts.splitDepth = split;
+          popts.queueSize = 2;
+          ParallelNamespaceExplorer parallel("/", options, qcl(), executor(), popts);
+          ASSERT_EQ(exploreAll(parallel), expected) << "depth=" << depth
+              << " threads=" << threads << " split=" << split;
+        }
+      }
+    }
+  }
+
+  // A find on a single file
+  ExplorationOptions options;
+  options.depthLimit = 999;
+  ParallelNamespaceExplorer single("/eos/d2/d3-2/my-file", options, qcl(),
+                                   executor(), ParallelNamespaceExplorer::Options());
+  ASSERT_EQ(exploreAll(single).size(), 1u);
+  // Errors about the path itself are thrown right away
+  ASSERT_THROW(ParallelNamespaceExplorer("/eos/invalid/path", options, qcl(),
+                                         executor(), ParallelNamespaceExplorer::Options()),
+               eos::MDException);
+}
+
+TEST_F(NamespaceExplorerF, ParallelResume)
+{
+  populateDummyData1();
+  ExplorationOptions options;
+  options.depthLimit = 999;
+  NamespaceExplorer explorer("/eos", options, qcl(), executor());
+  auto expected = exploreAll(explorer);
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    ParallelNamespaceExplorer::Options popts;
+    popts.resumeAfter = expected[i].first;
+    ParallelNamespaceExplorer parallel("/eos", options, qcl(), executor(), popts);
+    ASSERT_EQ(exploreAll(parallel),
+              decltype(expected)(expected.begin() + i + 1, expected.end()))
+        << "resume after " << expected[i].first;
+  }
+
+  ASSERT_LT(ParallelNamespaceExplorer::dfsKey("/eos/d2/zzzzz6"),
+            ParallelNamespaceExplorer::dfsKey("/eos/d2/d3-1/"));
+  ASSERT_LT(ParallelNamespaceExplorer::dfsKey("/eos/d2/"),
+            ParallelNamespaceExplorer::dfsKey("/eos/d2/asdf1"));
+}
+
+//------------------------------------------------------------------------------
+// Explore a tree of 100k files sequentially and with several threads, printing
+// the entries/s and the peak memory of the process. Run with
+// --gtest_also_run_disabled_tests, the number of files can be changed with
+// EOS_FIND_BENCH_FILES.
+//------------------------------------------------------------------------------
+TEST_F(NamespaceExplorerF, DISABLED_BenchmarkParallel)
+{
+  const uint64_t nfiles = getenv("EOS_FIND_BENCH_FILES") ?
+                          std::stoull(getenv("EOS_FIND_BENCH_FILES")) : 100000;
+  const uint64_t ndirs = 1000;
+
+  for (uint64_t i = 0; i < ndirs; ++i) {
+    view()->createContainer(SSTR("/bench/d" << i / 10 << "/d" << i), true);
+  }
+
+  for (uint64_t i = 0; i < nfiles; ++i) {
+    view()->createFile(SSTR("/bench/d" << (i % ndirs) / 10 << "/d" << i % ndirs
+                            << "/f" << i));
+  }
+
+  mdFlusher()->synchronize();
+  ExplorationOptions options;
+  options.depthLimit = 999;
+
+  for (size_t threads : {0, 1, 4, 8, 16}) {
+    ParallelNamespaceExplorer::Options popts;
+    popts.threads = threads;
+    auto start = std::chrono::steady_clock::now();
+    ParallelNamespaceExplorer explorer("/bench", options, qcl(), executor(), popts);
+    const size_t nentries = exploreAll(explorer).size();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>
+              (std::chrono::steady_clock::now() - start).count();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "threads=" << threads << " entries=" << nentries << " time="
+              << ms << "ms rate=" << (ms ? 1000 * nentries / ms : nentries)
+              << " entries/s peak-rss=" << usage.ru_maxrss / 1024 << "MB"
+              << std::endl;
+    ASSERT_EQ(nentries, nfiles + ndirs + ndirs / 10 + 1);
+  }
+}
+
 TEST_F(VariousTests, LinkedExtendedAttributes)
 {
   IContainerMDPtr cont1 = view()->createContainer("/eos/dir1", true);
@@ -23,6 +23,8 @@
 #include "namespace/ns_quarkdb/inspector/FileMetadataFilter.hh"
 #include "namespace/ns_quarkdb/inspector/Inspector.hh"
 #include "namespace/ns_quarkdb/inspector/OutputSink.hh"
+#include "namespace/ns_quarkdb/inspector/ParquetSink.hh"
+#include "common/StringSplit.hh"
 #include <qclient/QClient.hh>
 #include <stdint.h>
 
@@ -84,6 +86,20 @@ void addClusterOptions(CLI::App* subcmd, std::string& membersStr,
   passwordGroup->require_option(0, 1);
 }
 
+//------------------------------------------------------------------------------
+// Columnar output options, common to all metadata listing commands
+//------------------------------------------------------------------------------
+void addParquetOptions(CLI::App* subcmd, std::string& parquetPath,
+                       std::string& parquetXattrs, size_t& rowGroupSize)
+{
+  subcmd->add_option("--parquet", parquetPath,
+                     "Write the metadata to the given file in ZSTD compressed Parquet format instead of printing it");
+  subcmd->add_option("--parquet-xattrs", parquetXattrs,
+                     "Comma separated list of extended attributes to export as dedicated Parquet columns");
+  subcmd->add_option("--row-group-size", rowGroupSize,
+                     "Number of rows per Parquet row group, bounds the memory usage - default 131072");
+}
+
 //------------------------------------------------------------------------------
 // Control dry-run, common to all dangerous commands
 //----------------------------------------------------------------------------
@@ -128,6 +144,9 @@ int main(int argc, char* argv[])
   uint32_t maxDepth = UINT32_MAX;
   bool json = false;
   bool minimal = false;
+  std::string parquetPath;
+  std::string parquetXattrs;
+  size_t rowGroupSize = 128 * 1024;
   dumpSubcommand->add_option("--path", dumpPath, "The target path to dump")
   ->required();
   dumpSubcommand->add_option("--attr-query", attrQuery,
@@ -165,6 +184,7 @@ int main(int argc, char* argv[])
   scanSubcommand->add_option("--maxdepth", maxDepth,
                              "Descend only <maxdepth> levels.");
   scanSubcommand->add_flag("--json", json, "Use json output");
+  addParquetOptions(scanSubcommand, parquetPath, parquetXattrs, rowGroupSize);
   //----------------------------------------------------------------------------
   // Set-up print subcommand..
   //----------------------------------------------------------------------------
@@ -227,6 +247,8 @@ int main(int argc, char* argv[])
   scanDirsSubcommand->add_option("--count-threshold", countThreshold,
                                  "Only print containers which contain more than the specified number of items. Useful for detecting huge containers on which 'ls' might hang");
   scanDirsSubcommand->add_flag("--json", json, "Use json output");
+  addParquetOptions(scanDirsSubcommand, parquetPath, parquetXattrs,
+                    rowGroupSize);
   //----------------------------------------------------------------------------
   // Set-up scan-files subcommand..
   //----------------------------------------------------------------------------
@@ -245,6 +267,38 @@ int main(int argc, char* argv[])
   scanFilesSubcommand->add_flag("--json", json, "Use json output");
   scanFilesSubcommand->add_option("--where", filterExpression,
                                   "Filter results using the given expression.\nNOTE: Filtering is done client side! All results still have to be streamed -- performance is the same.");
+  addParquetOptions(scanFilesSubcommand, parquetPath, parquetXattrs,
+                    rowGroupSize);
+  //----------------------------------------------------------------------------
+  // Set-up scan-bench subcommand..
+  //----------------------------------------------------------------------------
+  auto scanBenchSubcommand = app.add_subcommand("scan-bench",
+                             "Measure file metadata scan throughput, single cursor vs partitioned parallel scan");
+  addClusterOptions(scanBenchSubcommand, membersStr, memberValidator, password,
+                    passwordFile, connectionRetries);
+  size_t maxPartitions = 32;
+  bool ordered = false;
+  scanBenchSubcommand->add_option("--max-partitions", maxPartitions,
+                                  "Benchmark 1, 2, 4 .. up to this many partitions (default 32)");
+  scanBenchSubcommand->add_flag("--ordered", ordered,
+                                "Deliver files in increasing fid order through the merge stage");
+  //----------------------------------------------------------------------------
+  // Set-up export-bench subcommand..
+  //----------------------------------------------------------------------------
+  auto exportBenchSubcommand = app.add_subcommand("export-bench",
+                               "Measure file metadata export throughput and size, json vs parquet");
+  addClusterOptions(exportBenchSubcommand, membersStr, memberValidator, password,
+                    passwordFile, connectionRetries);
+  uint64_t maxFiles = 0;
+  exportBenchSubcommand->add_option("--parquet", parquetPath,
+                                    "Parquet output file used for the benchmark")
+  ->required();
+  exportBenchSubcommand->add_option("--parquet-xattrs", parquetXattrs,
+                                    "Comma separated list of extended attributes to export as dedicated Parquet columns");
+  exportBenchSubcommand->add_option("--row-group-size", rowGroupSize,
+                                    "Number of rows per Parquet row group - default 131072");
+  exportBenchSubcommand->add_option("--max-files", maxFiles,
+                                    "Stop after exporting this many files - default all");
   //----------------------------------------------------------------------------
   // Set-up scan-deathrow subcommand..
   //----------------------------------------------------------------------------
@@ -488,8 +542,23 @@ int main(int argc, char* argv[])
   // Set-up Inspector object, ensure sanity
   //----------------------------------------------------------------------------
   std::unique_ptr<OutputSink> outputSink;
+  ParquetSinkOptions parquetOpts;
+  parquetOpts.rowGroupSize = rowGroupSize;
+
+  for (const auto& xattr : eos::common::StringSplit(parquetXattrs, ",")) {
+    parquetOpts.xattrs.emplace_back(xattr);
+  }
 
-  if (json) {
+  if (!parquetPath.empty() && !exportBenchSubcommand->parsed()) {
+    std::string errMsg;
+    outputSink = ParquetSink::Create(parquetPath, parquetOpts, std::cout,
+                                     std::cerr, errMsg);
+
+    if (!outputSink) {
+      std::cerr << errMsg << std::endl;
+      return 1;
+    }
+  } else if (json) {
     if (!minimal) {
       outputSink.reset(new JsonStreamSink(std::cout, std::cerr));
     } else {
@@ -556,6 +625,25 @@ int main(int argc, char* argv[])
     return inspector.scanFileMetadata(onlySizes, fullPaths, findUnknownFsids);
   }
 
+  if (scanBenchSubcommand->parsed()) {
+    return inspector.scanBench(contactDetails, maxPartitions, ordered,
+                               std::cout, std::cerr);
+  }
+
+  if (exportBenchSubcommand->parsed()) {
+    std::string errMsg;
+    std::unique_ptr<OutputSink> parquetSink = ParquetSink::Create(parquetPath,
+        parquetOpts, std::cout, std::cerr, errMsg);
+
+    if (!parquetSink) {
+      std::cerr << errMsg << std::endl;
+      return 1;
+    }
+
+    return inspector.exportBench(std::move(parquetSink), "parquet", parquetPath,
+                                 maxFiles, std::cout, std::cerr);
+  }
+
   if (scanDeathrowSubcommand->parsed()) {
     return inspector.scanDeathrow(std::cout, std::cerr);
   }
@@ -0,0 +1,186 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Remove the files of a container in batches
+//------------------------------------------------------------------------------
+
+#include "namespace/ns_quarkdb/utils/BatchFileRemover.hh"
+#include "namespace/interface/ContainerIterators.hh"
+#include "namespace/interface/IContainerMDSvc.hh"
+#include "namespace/interface/IFileMDSvc.hh"
+#include "namespace/interface/IQuota.hh"
+#include "namespace/interface/IView.hh"
+#include "namespace/MDException.hh"
+#include "common/RWMutex.hh"
+#include <folly/futures/Future.h>
+#include <algorithm>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+BatchFileRemover::BatchFileRemover(IView* view, IFileMDSvc* file_svc,
+                                   IContainerMDSvc* cont_svc,
+                                   const Options& opts, Hooks* hooks):
+  mView(view), mFileSvc(file_svc), mContSvc(cont_svc), mOpts(opts),
+  mHooks(hooks)
+{
+  if (mOpts.batchSize == 0) {
+    mOpts.batchSize = 1;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Remove all the files of the given container
+//------------------------------------------------------------------------------
+BatchFileRemover::Result
+BatchFileRemover::removeFiles(IContainerMD::id_t cid)
+{
+  Result result;
+  IContainerMDPtr cont;
+
+  try {
+    cont = mContSvc->getContainerMD(cid);
+  } catch (const MDException& e) {
+    return result;
+  }
+
+  std::vector<IFileMD::id_t> ids;
+
+  for (auto it = FileMapIterator(cont); it.valid(); it.next()) {
+    ids.push_back(it.value());
+  }
+
+  std::vector<IFileMD::id_t> batch;
+  batch.reserve(std::min(ids.size(), mOpts.batchSize));
+
+  for (const auto& id : ids) {
+    batch.push_back(id);
+
+    if (batch.size() == mOpts.batchSize) {
+      removeBatch(cont, batch, result);
+      batch.clear();
+    }
+  }
+
+  if (!batch.empty()) {
+    removeBatch(cont, batch, result);
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Remove one batch of files of the container
+//------------------------------------------------------------------------------
+void
+BatchFileRemover::removeBatch(const IContainerMDPtr& cont,
+                              const std::vector<IFileMD::id_t>& ids,
+                              Result& result)
+{
+  // Bring the file metadata into the cache outside the namespace lock
+  std::vector<folly::Future<IFileMDPtr>> futs;
+  futs.reserve(ids.size());
+
+  for (const auto& id : ids) {
+    futs.emplace_back(mFileSvc->getFileMDFut(id));
+  }
+
+  folly::collectAll(futs).wait();
+
+  if (mHooks) {
+    mHooks->throttle(ids.size());
+  }
+
+  std::vector<std::string> names;
+  names.reserve(ids.size());
+  eos::common::RWMutexWriteLock lock;
+
+  if (mOpts.nsMutex) {
+    lock.Grab(*mOpts.nsMutex);
+  }
+
+  const std::string cont_uri = mView->getUri(cont.get());
+  IQuotaNode* quota = nullptr;
+
+  try {
+    quota = mView->getQuotaNode(cont.get());
+  } catch (const MDException& e) {
+    quota = nullptr;
+  }
+
+  for (const auto& id : ids) {
+    try {
+      IFileMDPtr fmd = mFileSvc->getFileMD(id);
+
+      // Moved or removed since the listing
+      if (fmd->getContainerId() != cont->getId()) {
+        continue;
+      }
+
+      // The hooks may rename the file e.g. to a version or hard link target
+      // name, the deletion is broadcasted under its original name
+      std::string name = fmd->getName();
+
+      if (quota) {
+        quota->removeFile(fmd.get());
+      }
+
+      if (!mHooks || !mHooks->handled(cont, fmd)) {
+        mView->unlinkFile(fmd.get());
+
+        if (mOpts.dropLocation &&
+            fmd->hasUnlinkedLocation(mOpts.dropLocation)) {
+          fmd->removeLocation(mOpts.dropLocation);
+        }
+
+        if ((fmd->getNumUnlinkedLocation() == 0) &&
+            (fmd->getNumLocation() == 0)) {
+          mView->removeFile(fmd.get());
+        }
+
+        if (mHooks) {
+          mHooks->unlinked(cont, cont_uri, fmd);
+        }
+      }
+
+      names.push_back(std::move(name));
+    } catch (const MDException& e) {
+      ++result.failed;
+    }
+  }
+
+  if (!names.empty()) {
+    cont->setMTimeNow();
+    cont->notifyMTimeChange(mContSvc);
+    mView->updateContainerStore(cont.get());
+  }
+
+  lock.Release();
+  result.removed += names.size();
+  ++result.batches;
+
+  if (mHooks && !names.empty()) {
+    mHooks->batchDone(cont, names);
+  }
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,149 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief Remove the files of a container in batches
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "namespace/interface/IContainerMD.hh"
+#include "namespace/interface/IFileMD.hh"
+#include <string>
+#include <vector>
+
+namespace eos
+{
+namespace common
+{
+class RWMutex;
+}
+}
+
+EOSNSNAMESPACE_BEGIN
+
+class IView;
+class IFileMDSvc;
+class IContainerMDSvc;
+
+//------------------------------------------------------------------------------
+//! Remove all the files of a container in batches. The metadata of a batch is
+//! fetched before taking the namespace lock, then the whole batch is unlinked
+//! under a single write lock acquisition and the container is updated once
+//! per batch instead of once per file.
+//!
+//! Each file is accounted out of the quota node of the container, unlinked
+//! and its record removed if no replica is left, as for a single deletion.
+//------------------------------------------------------------------------------
+class BatchFileRemover
+{
+public:
+  //! Settings of the removal
+  struct Options {
+    //! Maximum number of files removed under one lock acquisition
+    size_t batchSize = 1000;
+    //! Namespace lock, taken for write for each batch
+    eos::common::RWMutex* nsMutex = nullptr;
+    //! Unlinked location dropped before deciding whether the record can be
+    //! removed, 0 for none
+    IFileMD::location_t dropLocation = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Callbacks letting the caller extend the removal of each file
+  //----------------------------------------------------------------------------
+  class Hooks
+  {
+  public:
+    virtual ~Hooks() = default;
+
+    //--------------------------------------------------------------------------
+    //! Called without the namespace lock before each batch, can block to
+    //! enforce a rate limit
+    //!
+    //! @param nfiles number of files in the batch
+    //--------------------------------------------------------------------------
+    virtual void throttle(size_t nfiles) {}
+
+    //--------------------------------------------------------------------------
+    //! Called with the namespace lock held before unlinking a file
+    //!
+    //! @return true if the file was fully handled and must not be unlinked
+    //--------------------------------------------------------------------------
+    virtual bool handled(const IContainerMDPtr& cont, const IFileMDPtr& fmd)
+    {
+      return false;
+    }
+
+    //--------------------------------------------------------------------------
+    //! Called with the namespace lock held after a file was unlinked
+    //!
+    //! @param cont_uri container path ending with '/'
+    //--------------------------------------------------------------------------
+    virtual void unlinked(const IContainerMDPtr& cont,
+                          const std::string& cont_uri,
+                          const IFileMDPtr& fmd) {}
+
+    //--------------------------------------------------------------------------
+    //! Called without the namespace lock after a batch was committed
+    //!
+    //! @param names names of the files removed by the batch
+    //--------------------------------------------------------------------------
+    virtual void batchDone(const IContainerMDPtr& cont,
+                           const std::vector<std::string>& names) {}
+  };
+
+  //! Outcome of a removal
+  struct Result {
+    uint64_t removed = 0;
+    uint64_t failed = 0;
+    uint64_t batches = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  BatchFileRemover(IView* view, IFileMDSvc* file_svc,
+                   IContainerMDSvc* cont_svc, const Options& opts,
+                   Hooks* hooks = nullptr);
+
+  //----------------------------------------------------------------------------
+  //! Remove all the files of the given container
+  //!
+  //! @param cid container id
+  //!
+  //! @return result of the removal, the container itself is left in place
+  //----------------------------------------------------------------------------
+  Result removeFiles(IContainerMD::id_t cid);
+
+private:
+  //----------------------------------------------------------------------------
+  //! Remove one batch of files of the container
+  //----------------------------------------------------------------------------
+  void removeBatch(const IContainerMDPtr& cont,
+                   const std::vector<IFileMD::id_t>& ids, Result& result);
+
+  IView* mView;
+  IFileMDSvc* mFileSvc;
+  IContainerMDSvc* mContSvc;
+  Options mOpts;
+  Hooks* mHooks;
+};
+
+EOSNSNAMESPACE_END
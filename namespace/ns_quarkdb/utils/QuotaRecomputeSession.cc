@@ -0,0 +1,419 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief State of a partitioned quota node recomputation
+//------------------------------------------------------------------------------
+
+#include "namespace/ns_quarkdb/utils/QuotaRecomputeSession.hh"
+#include <algorithm>
+#include <limits>
+#include <set>
+
+EOSNSNAMESPACE_BEGIN
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Add a signed update to a usage entry
+//------------------------------------------------------------------------------
+void
+ApplyUpdate(QuotaRecomputeSession::UsageMap& map, uint64_t id, int64_t size,
+            int64_t physical_size, int64_t files)
+{
+  auto& info = map[id];
+  // Unsigned wrap-around gives the right result once all updates are summed
+  info.space += static_cast<uint64_t>(size);
+  info.physicalSpace += static_cast<uint64_t>(physical_size);
+  info.files += static_cast<uint64_t>(files);
+}
+
+//------------------------------------------------------------------------------
+// Clamp the entries which went negative and drop the empty ones
+//------------------------------------------------------------------------------
+void
+Normalize(QuotaRecomputeSession::UsageMap& map)
+{
+  constexpr uint64_t max = std::numeric_limits<int64_t>::max();
+
+  for (auto it = map.begin(); it != map.end();) {
+    auto& info = it->second;
+    info.space = (info.space > max) ? 0 : info.space;
+    info.physicalSpace = (info.physicalSpace > max) ? 0 : info.physicalSpace;
+    info.files = (info.files > max) ? 0 : info.files;
+
+    if ((info.space == 0) && (info.physicalSpace == 0) && (info.files == 0)) {
+      it = map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+QuotaRecomputeSession::QuotaRecomputeSession(IContainerMD::id_t node_id,
+    const std::string& uri):
+  mNodeId(node_id), mUri(uri), mCreationTime(time(nullptr))
+{}
+
+//------------------------------------------------------------------------------
+// Record a quota update
+//------------------------------------------------------------------------------
+void
+QuotaRecomputeSession::quotaUpdated(IContainerMD::id_t cont_id, uid_t uid,
+                                    gid_t gid, int64_t size,
+                                    int64_t physical_size, int64_t files)
+{
+  if (mClosed) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (mUpdates.size() >= sMaxUpdates) {
+    // Rescanning everything is cheaper than keeping the history around
+    resetLocked();
+  }
+
+  mUpdates.push_back({++mSeq, cont_id, uid, gid, size, physical_size, files});
+}
+
+//------------------------------------------------------------------------------
+// Drop all the ranges and the recorded updates
+//------------------------------------------------------------------------------
+void
+QuotaRecomputeSession::quotaReset()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  resetLocked();
+}
+
+//------------------------------------------------------------------------------
+// Reset the session, the sequence number keeps increasing so that the scans
+// in flight can not be confused with the ones of the new generation
+//------------------------------------------------------------------------------
+void
+QuotaRecomputeSession::resetLocked()
+{
+  ++mSeq;
+  ++mGeneration;
+  mRanges.clear();
+  mUpdates.clear();
+  mContRange.clear();
+  mRemovedConts.clear();
+}
+
+//------------------------------------------------------------------------------
+// Get the sequence number of the last recorded update
+//------------------------------------------------------------------------------
+uint64_t
+QuotaRecomputeSession::getSeq() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mSeq;
+}
+
+//------------------------------------------------------------------------------
+// Check if the ranges need to be (re)computed
+//------------------------------------------------------------------------------
+bool
+QuotaRecomputeSession::needsSplit() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mRanges.empty();
+}
+
+//------------------------------------------------------------------------------
+// Get the generation
+//------------------------------------------------------------------------------
+uint64_t
+QuotaRecomputeSession::getGeneration() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mGeneration;
+}
+
+//------------------------------------------------------------------------------
+// Set the ranges of the quota node tree
+//------------------------------------------------------------------------------
+void
+QuotaRecomputeSession::setRanges(std::vector<Range>&& ranges,
+                                 uint64_t generation)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (generation != mGeneration) {
+    return;
+  }
+
+  mRanges = std::move(ranges);
+  mContRange.clear();
+}
+
+//------------------------------------------------------------------------------
+// Get the ranges which still need to be scanned
+//------------------------------------------------------------------------------
+std::vector<std::pair<size_t, QuotaRecomputeSession::Range>>
+    QuotaRecomputeSession::getPendingRanges(uint64_t& generation) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::vector<std::pair<size_t, Range>> pending;
+  generation = mGeneration;
+
+  for (size_t idx = 0; idx < mRanges.size(); ++idx) {
+    if (!mRanges[idx].mDone) {
+      pending.emplace_back(idx, mRanges[idx]);
+    }
+  }
+
+  return pending;
+}
+
+//------------------------------------------------------------------------------
+// Store the result of a range scan
+//------------------------------------------------------------------------------
+void
+QuotaRecomputeSession::completeRange(size_t idx, uint64_t generation,
+                                     uint64_t start_seq, uint64_t end_seq,
+                                     UsageMap&& users, UsageMap&& groups,
+                                     const std::vector<IContainerMD::id_t>& conts)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if ((generation != mGeneration) || (idx >= mRanges.size())) {
+    return;
+  }
+
+  Range& range = mRanges[idx];
+  range.mDone = true;
+  range.mStartSeq = start_seq;
+  range.mEndSeq = end_seq;
+  range.mUsers = std::move(users);
+  range.mGroups = std::move(groups);
+  mContRange[range.mId] = idx;
+
+  for (const auto& cid : conts) {
+    mContRange[cid] = idx;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Find the ranges which raced with updates of their containers
+//------------------------------------------------------------------------------
+size_t
+QuotaRecomputeSession::reconcile(bool rescan)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (mRanges.empty()) {
+    return 1;
+  }
+
+  std::set<size_t> dirty;
+
+  for (size_t idx = 0; idx < mRanges.size(); ++idx) {
+    if (!mRanges[idx].mDone) {
+      dirty.insert(idx);
+    }
+  }
+
+  for (const auto& update : mUpdates) {
+    auto it = mContRange.find(update.mContId);
+
+    if (it == mContRange.end()) {
+      continue;
+    }
+
+    const Range& range = mRanges[it->second];
+
+    if ((update.mSeq > range.mStartSeq) && (update.mSeq <= range.mEndSeq)) {
+      dirty.insert(it->second);
+    }
+  }
+
+  if (rescan && !dirty.empty()) {
+    for (auto it = mContRange.begin(); it != mContRange.end();) {
+      if (dirty.count(it->second)) {
+        it = mContRange.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    for (const auto& idx : dirty) {
+      Range& range = mRanges[idx];
+      range.mDone = false;
+      range.mUsers.clear();
+      range.mGroups.clear();
+    }
+  }
+
+  return dirty.size();
+}
+
+//------------------------------------------------------------------------------
+// Get the containers which received updates but were not visited
+//------------------------------------------------------------------------------
+std::vector<IContainerMD::id_t>
+QuotaRecomputeSession::getUnvisitedContainers() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::unordered_set<IContainerMD::id_t> conts;
+
+  for (const auto& update : mUpdates) {
+    if (mContRange.find(update.mContId) == mContRange.end()) {
+      conts.insert(update.mContId);
+    }
+  }
+
+  return std::vector<IContainerMD::id_t>(conts.begin(), conts.end());
+}
+
+//------------------------------------------------------------------------------
+// Set the unvisited containers which no longer exist
+//------------------------------------------------------------------------------
+void
+QuotaRecomputeSession::setRemovedContainers(
+  std::unordered_set<IContainerMD::id_t>&& conts)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mRemovedConts = std::move(conts);
+}
+
+//------------------------------------------------------------------------------
+// Build the quota node contents from the ranges and the recorded updates
+//------------------------------------------------------------------------------
+size_t
+QuotaRecomputeSession::finalize(QuotaNodeCore& core) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  size_t approximate = (mRanges.empty() ? 1 : 0);
+  UsageMap users;
+  UsageMap groups;
+
+  for (const auto& range : mRanges) {
+    if (!range.mDone) {
+      ++approximate;
+      continue;
+    }
+
+    for (const auto& elem : range.mUsers) {
+      users[elem.first] += elem.second;
+    }
+
+    for (const auto& elem : range.mGroups) {
+      groups[elem.first] += elem.second;
+    }
+  }
+
+  uint64_t min_start = std::numeric_limits<uint64_t>::max();
+
+  for (const auto& range : mRanges) {
+    min_start = std::min(min_start, range.mStartSeq);
+  }
+
+  for (const auto& update : mUpdates) {
+    auto it = mContRange.find(update.mContId);
+
+    if (it == mContRange.end()) {
+      if ((update.mSeq <= min_start) || mRemovedConts.count(update.mContId)) {
+        continue; // container gone before being scanned
+      }
+    } else {
+      const Range& range = mRanges[it->second];
+
+      if (update.mSeq <= range.mStartSeq) {
+        continue; // already seen by the scan
+      }
+
+      if (update.mSeq <= range.mEndSeq) {
+        // Raced with the scan, which may or may not have seen it
+        ++approximate;
+        continue;
+      }
+    }
+
+    ApplyUpdate(users, update.mUid, update.mSize, update.mPhysicalSize,
+                update.mFiles);
+    ApplyUpdate(groups, update.mGid, update.mSize, update.mPhysicalSize,
+                update.mFiles);
+  }
+
+  Normalize(users);
+  Normalize(groups);
+  core = {};
+
+  for (const auto& elem : users) {
+    core.setByUid(elem.first, elem.second);
+  }
+
+  for (const auto& elem : groups) {
+    core.setByGid(elem.first, elem.second);
+  }
+
+  return approximate;
+}
+
+//------------------------------------------------------------------------------
+// Mark the session as used by a recomputation
+//------------------------------------------------------------------------------
+bool
+QuotaRecomputeSession::acquire()
+{
+  bool expected = false;
+  return mBusy.compare_exchange_strong(expected, true);
+}
+
+void
+QuotaRecomputeSession::release()
+{
+  mBusy = false;
+}
+
+//------------------------------------------------------------------------------
+// Stop recording and free the recorded updates
+//------------------------------------------------------------------------------
+void
+QuotaRecomputeSession::close()
+{
+  mClosed = true;
+  std::lock_guard<std::mutex> lock(mMutex);
+  resetLocked();
+}
+
+//------------------------------------------------------------------------------
+// Get the number of ranges and of completed ranges
+//------------------------------------------------------------------------------
+std::pair<size_t, size_t>
+QuotaRecomputeSession::getProgress() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  size_t done = 0;
+
+  for (const auto& range : mRanges) {
+    done += (range.mDone ? 1 : 0);
+  }
+
+  return {mRanges.size(), done};
+}
+
+EOSNSNAMESPACE_END
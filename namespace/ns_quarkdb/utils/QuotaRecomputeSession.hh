@@ -0,0 +1,252 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @author Elvin Sindrilaru <esindril@cern.ch>
+//! @brief State of a partitioned quota node recomputation
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "namespace/interface/IQuota.hh"
+#include "namespace/ns_quarkdb/accounting/QuotaNodeCore.hh"
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! State of a quota node recomputation split into container ranges which are
+//! scanned independently.
+//!
+//! The session is attached to the quota node as update listener for its whole
+//! duration and records every quota update with a sequence number. A range
+//! remembers the sequence numbers observed right before and right after its
+//! scan together with the containers it visited. An update of a visited
+//! container is then either already part of the scan (sequence before the
+//! start), not part of it (after the end) or ambiguous, in which case the range
+//! is scanned again. Updates of containers no range visited are applied on top
+//! of the scan results unless the container was removed in the meantime.
+//!
+//! The sequence numbers are only meaningful if the quota updates and the
+//! snapshots taken by the scanner are serialized by the namespace lock and the
+//! metadata flusher is synchronized after taking the start snapshot.
+//!
+//! Completed ranges are kept in the session so that an interrupted
+//! recomputation can be resumed.
+//------------------------------------------------------------------------------
+class QuotaRecomputeSession : public IQuotaUpdateListener
+{
+public:
+  using UsageMap = std::map<uint64_t, QuotaNodeCore::UsageInfo>;
+
+  //! Part of the quota node tree scanned as one unit
+  struct Range {
+    IContainerMD::id_t mId {0}; ///< Top container of the range
+    std::string mPath; ///< Path of the top container, ending with '/'
+    bool mSubtree {true}; ///< If false only the files of mId are included
+    bool mDone {false};
+    uint64_t mStartSeq {0};
+    uint64_t mEndSeq {0};
+    UsageMap mUsers;
+    UsageMap mGroups;
+  };
+
+  //! Maximum number of recorded updates before the session is reset
+  static constexpr size_t sMaxUpdates = 1 << 24;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param node_id quota node id
+  //! @param uri quota node path
+  //----------------------------------------------------------------------------
+  QuotaRecomputeSession(IContainerMD::id_t node_id, const std::string& uri);
+
+  //----------------------------------------------------------------------------
+  //! Record a quota update
+  //----------------------------------------------------------------------------
+  void quotaUpdated(IContainerMD::id_t cont_id, uid_t uid, gid_t gid,
+                    int64_t size, int64_t physical_size,
+                    int64_t files) override;
+
+  //----------------------------------------------------------------------------
+  //! Drop all the ranges and the recorded updates, everything is scanned again
+  //----------------------------------------------------------------------------
+  void quotaReset() override;
+
+  //----------------------------------------------------------------------------
+  //! Get the sequence number of the last recorded update
+  //----------------------------------------------------------------------------
+  uint64_t getSeq() const;
+
+  //----------------------------------------------------------------------------
+  //! Check if the ranges need to be (re)computed
+  //----------------------------------------------------------------------------
+  bool needsSplit() const;
+
+  //----------------------------------------------------------------------------
+  //! Set the ranges of the quota node tree
+  //!
+  //! @param ranges ranges covering the quota node tree
+  //! @param generation generation returned by getGeneration() before the
+  //!        ranges were computed, the ranges are dropped if it changed
+  //----------------------------------------------------------------------------
+  void setRanges(std::vector<Range>&& ranges, uint64_t generation);
+
+  //----------------------------------------------------------------------------
+  //! Get the generation, incremented at every reset
+  //----------------------------------------------------------------------------
+  uint64_t getGeneration() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the ranges which still need to be scanned
+  //!
+  //! @param generation current generation
+  //!
+  //! @return pending ranges with their index
+  //----------------------------------------------------------------------------
+  std::vector<std::pair<size_t, Range>> getPendingRanges(uint64_t& generation)
+  const;
+
+  //----------------------------------------------------------------------------
+  //! Store the result of a range scan, ignored if the session got reset in
+  //! the meantime
+  //!
+  //! @param idx range index
+  //! @param generation generation the range belongs to
+  //! @param start_seq sequence number before the scan
+  //! @param end_seq sequence number after the scan
+  //! @param users usage per uid
+  //! @param groups usage per gid
+  //! @param conts containers visited by the scan
+  //----------------------------------------------------------------------------
+  void completeRange(size_t idx, uint64_t generation, uint64_t start_seq,
+                     uint64_t end_seq, UsageMap&& users, UsageMap&& groups,
+                     const std::vector<IContainerMD::id_t>& conts);
+
+  //----------------------------------------------------------------------------
+  //! Find the ranges which raced with updates of their containers
+  //!
+  //! @param rescan if true mark these ranges as pending again
+  //!
+  //! @return number of such ranges, a reset session counts as one
+  //----------------------------------------------------------------------------
+  size_t reconcile(bool rescan);
+
+  //----------------------------------------------------------------------------
+  //! Get the containers which received updates but were not visited by any
+  //! range. They were either created after the scan of their range, in which
+  //! case their updates are applied, or removed before it.
+  //----------------------------------------------------------------------------
+  std::vector<IContainerMD::id_t> getUnvisitedContainers() const;
+
+  //----------------------------------------------------------------------------
+  //! Set the unvisited containers which no longer exist, their updates are
+  //! already reflected by the scan
+  //----------------------------------------------------------------------------
+  void setRemovedContainers(std::unordered_set<IContainerMD::id_t>&& conts);
+
+  //----------------------------------------------------------------------------
+  //! Build the quota node contents from the ranges and the recorded updates.
+  //! Must be called with the namespace lock held in write mode so that no
+  //! update is missed before the listener is detached.
+  //!
+  //! @param core output quota node contents
+  //!
+  //! @return number of updates which could not be placed exactly, non-zero
+  //!         means the result is approximate
+  //----------------------------------------------------------------------------
+  size_t finalize(QuotaNodeCore& core) const;
+
+  //----------------------------------------------------------------------------
+  //! Mark the session as used by a recomputation
+  //!
+  //! @return false if already in use
+  //----------------------------------------------------------------------------
+  bool acquire();
+  void release();
+
+  //----------------------------------------------------------------------------
+  //! Stop recording and free the recorded updates
+  //----------------------------------------------------------------------------
+  void close();
+
+  bool isClosed() const
+  {
+    return mClosed;
+  }
+
+  IContainerMD::id_t getNodeId() const
+  {
+    return mNodeId;
+  }
+
+  const std::string& getUri() const
+  {
+    return mUri;
+  }
+
+  time_t getCreationTime() const
+  {
+    return mCreationTime;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the number of ranges and of completed ranges
+  //----------------------------------------------------------------------------
+  std::pair<size_t, size_t> getProgress() const;
+
+private:
+  //! A recorded quota update
+  struct Update {
+    uint64_t mSeq;
+    IContainerMD::id_t mContId;
+    uid_t mUid;
+    gid_t mGid;
+    int64_t mSize;
+    int64_t mPhysicalSize;
+    int64_t mFiles;
+  };
+
+  void resetLocked();
+
+  const IContainerMD::id_t mNodeId;
+  const std::string mUri;
+  const time_t mCreationTime;
+  std::atomic<bool> mClosed {false};
+  std::atomic<bool> mBusy {false};
+  mutable std::mutex mMutex;
+  uint64_t mSeq {0};
+  uint64_t mGeneration {0};
+  std::vector<Range> mRanges;
+  std::vector<Update> mUpdates;
+  //! Container id to index of the completed range which visited it
+  std::unordered_map<IContainerMD::id_t, size_t> mContRange;
+  //! Unvisited containers known to be removed
+  std::unordered_set<IContainerMD::id_t> mRemovedConts;
+};
+
+EOSNSNAMESPACE_END
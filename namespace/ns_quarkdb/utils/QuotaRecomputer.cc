@@ -25,7 +25,17 @@
 #include "namespace/ns_quarkdb/views/HierarchicalView.hh"
 #include "namespace/Constants.hh"
 #include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/flusher/MetadataFlusher.hh"
+#include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
+#include "namespace/interface/IQuota.hh"
 #include "common/LayoutId.hh"
+#include "common/RWMutex.hh"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -64,6 +74,50 @@ private:
   uint64_t rootContainer;
 };
 
+//------------------------------------------------------------------------------
+// Filtering class for NamespaceExplorer to only list the files of the root
+//------------------------------------------------------------------------------
+class TopContainerFilter : public ExpansionDecider
+{
+public:
+  TopContainerFilter(uint64_t root) : rootContainer(root) {}
+
+  virtual bool shouldExpandContainer(const eos::ns::ContainerMdProto& proto,
+                                     const eos::IContainerMD::XAttrMap& attrs,
+                                     const std::string& fullPath) override
+  {
+    return (proto.id() == rootContainer);
+  }
+
+private:
+  uint64_t rootContainer;
+};
+
+namespace
+{
+//! Maximum depth at which the tree is split into ranges
+constexpr size_t sMaxSplitDepth = 4;
+
+std::mutex gSessionMutex;
+std::map<IContainerMD::id_t, std::shared_ptr<QuotaRecomputeSession>>
+    gSessions;
+
+//------------------------------------------------------------------------------
+// Take a snapshot of the session sequence number, no quota update can be in
+// progress while the namespace lock is held
+//------------------------------------------------------------------------------
+uint64_t
+SnapshotSeq(const QuotaRecomputeSession& session, eos::common::RWMutex* mutex)
+{
+  if (mutex) {
+    eos::common::RWMutexReadLock rd_lock(*mutex);
+    return session.getSeq();
+  }
+
+  return session.getSeq();
+}
+}
+
 //------------------------------------------------------------------------------
 // Given a quotanode, re-calculate the quota values,
 // store into QuotaNodeCore.
@@ -100,4 +154,357 @@ MDStatus QuotaRecomputer::recompute(const std::string& cont_uri,
   return MDStatus(); // OK
 }
 
+//------------------------------------------------------------------------------
+// Open a recomputation session for the given quota node
+//------------------------------------------------------------------------------
+std::shared_ptr<QuotaRecomputeSession>
+QuotaRecomputer::openSession(IQuotaNode* node, const std::string& cont_uri,
+                             bool& resumed)
+{
+  std::lock_guard<std::mutex> lock(gSessionMutex);
+  const time_t now = time(nullptr);
+  resumed = false;
+
+  // Drop the sessions which were abandoned, the listener they leave behind
+  // ignores all updates and gets replaced by the next session of the node
+  for (auto it = gSessions.begin(); it != gSessions.end();) {
+    auto& session = it->second;
+
+    if ((session->getCreationTime() + sSessionTtl < now) && session->acquire()) {
+      session->close();
+      session->release();
+      it = gSessions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto it = gSessions.find(node->getId());
+
+  if (it != gSessions.end()) {
+    if (!it->second->acquire()) {
+      return nullptr;
+    }
+
+    if (it->second->getUri() == cont_uri) {
+      resumed = true;
+      return it->second;
+    }
+
+    // Quota node was renamed, the ranges are not valid anymore
+    it->second->close();
+    it->second->release();
+    gSessions.erase(it);
+  }
+
+  auto session = std::make_shared<QuotaRecomputeSession>(node->getId(),
+                 cont_uri);
+  session->acquire();
+  node->setUpdateListener(session);
+  gSessions[node->getId()] = session;
+  return session;
+}
+
+//------------------------------------------------------------------------------
+// Detach the session from the quota node and drop it
+//------------------------------------------------------------------------------
+void
+QuotaRecomputer::closeSession(IQuotaNode* node,
+                              const std::shared_ptr<QuotaRecomputeSession>& session)
+{
+  if (node) {
+    node->setUpdateListener(nullptr);
+  }
+
+  session->close();
+  session->release();
+  std::lock_guard<std::mutex> lock(gSessionMutex);
+  auto it = gSessions.find(session->getNodeId());
+
+  if ((it != gSessions.end()) && (it->second == session)) {
+    gSessions.erase(it);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Recompute the quota node of the session in parallel
+//------------------------------------------------------------------------------
+MDStatus
+QuotaRecomputer::recomputeParallel(QuotaRecomputeSession& session,
+                                   const ParallelOptions& opts)
+{
+  if (session.getNodeId() == 0ull) {
+    return MDStatus(EINVAL, "error: requested computation for cid=0");
+  }
+
+  const unsigned int threads = std::max(1u, opts.threads);
+  const unsigned int max_passes = std::max(1u, opts.maxPasses);
+
+  for (unsigned int pass = 0; pass < max_passes; ++pass) {
+    if (session.needsSplit()) {
+      const uint64_t generation = session.getGeneration();
+
+      try {
+        session.setRanges(splitRanges(session.getNodeId(), session.getUri(),
+                                      threads * 4), generation);
+      } catch (const MDException& e) {
+        return MDStatus(e.getErrno(), e.what());
+      } catch (const std::exception& e) {
+        return MDStatus(EIO, e.what());
+      }
+    }
+
+    uint64_t generation = 0;
+    const auto pending = session.getPendingRanges(generation);
+    std::atomic<size_t> next {0};
+    std::mutex error_mutex;
+    MDStatus error;
+    auto worker = [&]() {
+      for (size_t i = next++; i < pending.size(); i = next++) {
+        MDStatus status;
+
+        try {
+          status = scanRange(session, pending[i].first, pending[i].second,
+                             generation, opts);
+        } catch (const std::exception& e) {
+          status = MDStatus(EIO, e.what());
+        }
+
+        if (!status.ok()) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+
+          if (error.ok()) {
+            error = status;
+          }
+
+          // Let the other workers finish the ranges they already started
+          next = pending.size();
+          return;
+        }
+      }
+    };
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < std::min<size_t>(threads, pending.size()); ++i) {
+      workers.emplace_back(worker);
+    }
+
+    for (auto& th : workers) {
+      th.join();
+    }
+
+    if (!error.ok()) {
+      return error;
+    }
+
+    if (session.reconcile(pass + 1 < max_passes) == 0) {
+      break;
+    }
+  }
+
+  try {
+    resolveUnvisited(session, opts);
+  } catch (const std::exception& e) {
+    return MDStatus(EIO, e.what());
+  }
+
+  return MDStatus();
+}
+
+//------------------------------------------------------------------------------
+// Split the quota node tree into ranges
+//------------------------------------------------------------------------------
+std::vector<QuotaRecomputeSession::Range>
+QuotaRecomputer::splitRanges(eos::IContainerMD::id_t cont_id,
+                             const std::string& cont_uri, size_t target)
+{
+  struct Candidate {
+    IContainerMD::id_t mId;
+    std::string mPath;
+    uint64_t mTreeFiles;
+    size_t mDepth;
+  };
+  std::vector<Candidate> candidates;
+  auto list_children = [&](IContainerMD::id_t id, const std::string & path,
+  size_t depth) {
+    auto cmap = MetadataFetcher::getContainerMap(*mQcl,
+                ContainerIdentifier(id)).get();
+    auto protos = MetadataFetcher::getContainersFromContainerMap(*mQcl, cmap);
+
+    for (auto& fut : protos) {
+      eos::ns::ContainerMdProto proto = std::move(fut).get();
+
+      if (proto.flags() & eos::QUOTA_NODE_FLAG) {
+        continue; // accounted by its own quota node
+      }
+
+      candidates.push_back({proto.id(), path + proto.name() + "/",
+                            proto.tree_files(), depth});
+    }
+  };
+  auto make_range = [](IContainerMD::id_t id, const std::string & path,
+  bool subtree) {
+    QuotaRecomputeSession::Range range;
+    range.mId = id;
+    range.mPath = path;
+    range.mSubtree = subtree;
+    return range;
+  };
+  std::vector<QuotaRecomputeSession::Range> ranges;
+  const std::string root_path = (cont_uri.empty() || cont_uri.back() != '/') ?
+                                cont_uri + "/" : cont_uri;
+  ranges.push_back(make_range(cont_id, root_path, false));
+  list_children(cont_id, root_path, 1);
+  uint64_t total = 0;
+
+  for (const auto& cand : candidates) {
+    total += cand.mTreeFiles;
+  }
+
+  // Replace the biggest candidates by their files and their children until
+  // there are enough ranges or all candidates are small enough
+  while (ranges.size() + candidates.size() < target) {
+    auto biggest = candidates.end();
+
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+      if ((it->mDepth < sMaxSplitDepth) &&
+          ((biggest == candidates.end()) ||
+           (it->mTreeFiles > biggest->mTreeFiles))) {
+        biggest = it;
+      }
+    }
+
+    if ((biggest == candidates.end()) ||
+        (biggest->mTreeFiles * target <= total)) {
+      break;
+    }
+
+    Candidate cand = *biggest;
+    candidates.erase(biggest);
+    ranges.push_back(make_range(cand.mId, cand.mPath, false));
+    list_children(cand.mId, cand.mPath, cand.mDepth + 1);
+  }
+
+  for (const auto& cand : candidates) {
+    ranges.push_back(make_range(cand.mId, cand.mPath, true));
+  }
+
+  return ranges;
+}
+
+//------------------------------------------------------------------------------
+// Scan one range and store the result in the session
+//------------------------------------------------------------------------------
+MDStatus
+QuotaRecomputer::scanRange(QuotaRecomputeSession& session, size_t idx,
+                           const QuotaRecomputeSession::Range& range,
+                           uint64_t generation, const ParallelOptions& opts)
+{
+  // Everything recorded up to the start snapshot is in QDB after the sync
+  const uint64_t start_seq = SnapshotSeq(session, opts.nsMutex);
+
+  if (opts.flusher) {
+    opts.flusher->synchronize();
+  }
+
+  ExplorationOptions options;
+  options.depthLimit = 2048;
+
+  if (range.mSubtree) {
+    options.expansionDecider.reset(new QuotaNodeFilter(range.mId));
+  } else {
+    options.expansionDecider.reset(new TopContainerFilter(range.mId));
+  }
+
+  QuotaRecomputeSession::UsageMap users;
+  QuotaRecomputeSession::UsageMap groups;
+  std::vector<IContainerMD::id_t> conts;
+
+  try {
+    NamespaceExplorer explorer(range.mPath, options, *mQcl, mExecutor);
+    NamespaceItem item;
+    bool first = true;
+
+    while (explorer.fetch(item)) {
+      if (first) {
+        first = false;
+
+        if (item.isFile || (item.containerMd.id() != range.mId)) {
+          throw_mdexception(ENOENT, "range container not found at " <<
+                            range.mPath);
+        }
+      }
+
+      if (item.isFile) {
+        QuotaNodeCore::UsageInfo info;
+        info.space = item.fileMd.size();
+        info.physicalSpace = item.fileMd.size() *
+                             eos::common::LayoutId::GetSizeFactor(item.fileMd.layout_id());
+        info.files = 1;
+        users[item.fileMd.uid()] += info;
+        groups[item.fileMd.gid()] += info;
+      } else if (!item.expansionFilteredOut) {
+        conts.push_back(item.containerMd.id());
+      }
+    }
+  } catch (const MDException& e) {
+    if (e.getErrno() != ENOENT) {
+      return MDStatus(e.getErrno(), e.what());
+    }
+
+    if (MetadataFetcher::doesContainerMdExist(*mQcl,
+        ContainerIdentifier(range.mId)).get()) {
+      // Top container was moved, the ranges have to be computed again
+      session.quotaReset();
+      return MDStatus();
+    }
+
+    // Top container was removed, nothing to account
+    users.clear();
+    groups.clear();
+    conts.clear();
+  }
+
+  const uint64_t end_seq = SnapshotSeq(session, opts.nsMutex);
+  session.completeRange(idx, generation, start_seq, end_seq, std::move(users),
+                        std::move(groups), conts);
+  return MDStatus();
+}
+
+//------------------------------------------------------------------------------
+// Find out which of the unvisited containers have been removed
+//------------------------------------------------------------------------------
+void
+QuotaRecomputer::resolveUnvisited(QuotaRecomputeSession& session,
+                                  const ParallelOptions& opts)
+{
+  const auto conts = session.getUnvisitedContainers();
+
+  if (conts.empty()) {
+    return;
+  }
+
+  if (opts.flusher) {
+    opts.flusher->synchronize();
+  }
+
+  std::vector<folly::Future<bool>> exists;
+  exists.reserve(conts.size());
+
+  for (const auto& cid : conts) {
+    exists.emplace_back(MetadataFetcher::doesContainerMdExist(*mQcl,
+                        ContainerIdentifier(cid)));
+  }
+
+  std::unordered_set<IContainerMD::id_t> removed;
+
+  for (size_t i = 0; i < conts.size(); ++i) {
+    if (!std::move(exists[i]).get()) {
+      removed.insert(conts[i]);
+    }
+  }
+
+  session.setRemovedContainers(std::move(removed));
+}
+
 EOSNSNAMESPACE_END
@@ -26,6 +26,10 @@
 #include "namespace/interface/IContainerMD.hh"
 #include "namespace/Namespace.hh"
 #include "namespace/MDException.hh"
+#include "namespace/ns_quarkdb/utils/QuotaRecomputeSession.hh"
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace qclient
 {
@@ -37,10 +41,20 @@ namespace folly
 class Executor;
 }
 
+namespace eos
+{
+namespace common
+{
+class RWMutex;
+}
+}
+
 EOSNSNAMESPACE_BEGIN
 
 class QuotaNodeCore;
 class IView;
+class IQuotaNode;
+class MetadataFlusher;
 
 //------------------------------------------------------------------------------
 //! Utility class to recompute a quotanode
@@ -48,6 +62,22 @@ class IView;
 class QuotaRecomputer
 {
 public:
+  //! Settings of the parallel recomputation
+  struct ParallelOptions {
+    //! Number of ranges scanned concurrently
+    unsigned int threads = 8;
+    //! Maximum number of passes over the ranges which raced with updates
+    unsigned int maxPasses = 3;
+    //! Lock serializing the quota updates, held for read while taking the
+    //! update snapshots. Only optional if there are no concurrent updates.
+    eos::common::RWMutex* nsMutex = nullptr;
+    //! Flusher of the file metadata, synchronized before each range scan
+    MetadataFlusher* flusher = nullptr;
+  };
+
+  //! Sessions not finished within this time are dropped
+  static constexpr time_t sSessionTtl = 86400;
+
   //----------------------------------------------------------------------------
   //! Constructor
   //----------------------------------------------------------------------------
@@ -66,7 +96,68 @@ public:
   MDStatus recompute(const std::string& cont_uri,
                      const eos::IContainerMD::id_t cont_id, QuotaNodeCore& core);
 
+  //----------------------------------------------------------------------------
+  //! Open a recomputation session for the given quota node, resuming the
+  //! unfinished one if any. The session is attached to the quota node so that
+  //! all its updates get recorded. Must be called with the namespace lock
+  //! held.
+  //!
+  //! @param node quota node
+  //! @param cont_uri quota node container uri
+  //! @param resumed set to true if an unfinished session is resumed
+  //!
+  //! @return session or nullptr if a recomputation of the same quota node is
+  //!         already running
+  //----------------------------------------------------------------------------
+  static std::shared_ptr<QuotaRecomputeSession>
+  openSession(IQuotaNode* node, const std::string& cont_uri, bool& resumed);
+
+  //----------------------------------------------------------------------------
+  //! Detach the session from the quota node and drop it. Must be called with
+  //! the namespace lock held for write, after QuotaRecomputeSession::finalize.
+  //----------------------------------------------------------------------------
+  static void closeSession(IQuotaNode* node,
+                           const std::shared_ptr<QuotaRecomputeSession>& session);
+
+  //----------------------------------------------------------------------------
+  //! Recompute the quota node of the session by splitting its tree into
+  //! container ranges which are scanned in parallel. The ranges which raced
+  //! with quota updates are scanned again, up to opts.maxPasses times. On
+  //! error the completed ranges are kept in the session and a later call
+  //! only scans the remaining ones. The result is obtained with
+  //! QuotaRecomputeSession::finalize.
+  //!
+  //! @param session session returned by openSession
+  //! @param opts parallel recomputation settings
+  //!
+  //! @return status
+  //----------------------------------------------------------------------------
+  MDStatus recomputeParallel(QuotaRecomputeSession& session,
+                             const ParallelOptions& opts);
+
 private:
+  //----------------------------------------------------------------------------
+  //! Split the quota node tree into about target ranges based on the number
+  //! of files below each container
+  //----------------------------------------------------------------------------
+  std::vector<QuotaRecomputeSession::Range>
+  splitRanges(eos::IContainerMD::id_t cont_id, const std::string& cont_uri,
+              size_t target);
+
+  //----------------------------------------------------------------------------
+  //! Scan one range and store the result in the session
+  //----------------------------------------------------------------------------
+  MDStatus scanRange(QuotaRecomputeSession& session, size_t idx,
+                     const QuotaRecomputeSession::Range& range,
+                     uint64_t generation, const ParallelOptions& opts);
+
+  //----------------------------------------------------------------------------
+  //! Find out which of the containers updated but not visited by the scan
+  //! have been removed
+  //----------------------------------------------------------------------------
+  void resolveUnvisited(QuotaRecomputeSession& session,
+                        const ParallelOptions& opts);
+
   qclient::QClient* mQcl;
   folly::Executor* mExecutor;
 };
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+//! @file EosCapabilityTimingTest.cc
+//! @author: Elvin Sindrilaru - CERN
+//----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/SymKeys.hh"
+#include "common/Timing.hh"
+#include <XrdOuc/XrdOucEnv.hh>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using eos::common::SymKey;
+using CapabilityFormat = SymKey::CapabilityFormat;
+
+//------------------------------------------------------------------------------
+// Build a capability input similar to what the MGM sends for an open
+//------------------------------------------------------------------------------
+static std::string
+CapInput(int i)
+{
+  return "mgm.access=read&mgm.ruid=1000&mgm.rgid=1000&mgm.uid=1000&"
+         "mgm.gid=1000&mgm.path=/eos/user/t/test/data/file." + std::to_string(i) +
+         "&mgm.manager=eosmgm.cern.ch:1094&mgm.fid=" + std::to_string(i) +
+         "&mgm.cid=1234&mgm.sec=krb5|test|host.cern.ch||test|||&mgm.lid=1048578&"
+         "mgm.bookingsize=0&mgm.fsid=17&mgm.localprefix=/data17&"
+         "mgm.sourcehostport=fst.cern.ch:1095";
+}
+
+//------------------------------------------------------------------------------
+// Create and extract n capabilities in the given format
+//------------------------------------------------------------------------------
+static void
+Run(SymKey* key, CapabilityFormat format, const char* name, int n)
+{
+  std::vector<std::string> caps;
+  caps.reserve(n);
+  eos::common::Timing tm(name);
+  COMMONTIMING("START", &tm);
+
+  for (int i = 0; i < n; ++i) {
+    XrdOucEnv inenv(CapInput(i).c_str());
+    XrdOucEnv* outenv = nullptr;
+
+    if (SymKey::CreateCapability(&inenv, outenv, key, std::chrono::minutes(5),
+                                 format)) {
+      fprintf(stderr, "error: failed to create capability\n");
+      exit(-1);
+    }
+
+    int envlen;
+    caps.emplace_back(outenv->Env(envlen));
+    delete outenv;
+  }
+
+  COMMONTIMING("CREATE", &tm);
+
+  for (int i = 0; i < n; ++i) {
+    XrdOucEnv inenv(caps[i].c_str());
+    XrdOucEnv* outenv = nullptr;
+
+    if (SymKey::ExtractCapability(&inenv, outenv)) {
+      fprintf(stderr, "error: failed to extract capability\n");
+      exit(-1);
+    }
+
+    delete outenv;
+  }
+
+  COMMONTIMING("EXTRACT", &tm);
+
+  // Same capability presented again e.g. reopen or retried request
+  for (int i = 0; i < n; ++i) {
+    XrdOucEnv inenv(caps[0].c_str());
+    XrdOucEnv* outenv = nullptr;
+
+    if (SymKey::ExtractCapability(&inenv, outenv)) {
+      fprintf(stderr, "error: failed to re-extract capability\n");
+      exit(-1);
+    }
+
+    delete outenv;
+  }
+
+  COMMONTIMING("RE-EXTRACT", &tm);
+  tm.Print();
+  fprintf(stdout, "%s: cap length=%zu bytes, %d caps/stage\n", name,
+          caps[0].length(), n);
+}
+
+int main(int argc, char* argv[])
+{
+  int n = 100000;
+
+  if (argc > 1) {
+    n = atoi(argv[1]);
+  }
+
+  SymKey* key = eos::common::gSymKeyStore.SetKey("12345678901234567890", 0);
+
+  if (!key) {
+    fprintf(stderr, "error: failed to set symmetric key\n");
+    exit(-1);
+  }
+
+  Run(key, CapabilityFormat::Aead, "Capability AEAD", n);
+  Run(key, CapabilityFormat::Compact, "Capability Compact", n);
+  return 0;
+}
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+// File: EosCloseLatencyBenchmark.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <XrdCl/XrdClFile.hh>
+#include <XrdCl/XrdClFileSystem.hh>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//! This executable measures the latency of the close operation for files
+//! written to an EOS instance. For each of the file sizes 1MB, 10MB, 100MB,
+//! 1GB and 10GB (capped by the <max_size> argument) it writes <num_files>
+//! files and reports the close latency percentiles. To compare synchronous
+//! and asynchronous close modes run it against FSTs started with and without
+//! EOS_FST_ASYNC_CLOSE=1.
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <xrootd_dir_url> [<num_files>] "
+              << "[<max_size_mb>]" << std::endl
+              << "  <xrootd_dir_url> - full XRootD URL of the directory where "
+              << "the files are written" << std::endl
+              << "  <num_files> - number of files written per size, default 10"
+              << std::endl
+              << "  <max_size_mb> - largest file size in MB, default 10240"
+              << std::endl;
+    exit(EINVAL);
+  }
+
+  std::string surl = argv[1];
+
+  if (surl.back() != '/') {
+    surl += '/';
+  }
+
+  if (!XrdCl::URL(surl).IsValid()) {
+    std::cerr << "error: given URL is not valid" << std::endl;
+    exit(EINVAL);
+  }
+
+  uint32_t num_files = 10;
+  uint64_t max_size_mb = 10240;
+
+  try {
+    if (argc >= 3) {
+      num_files = std::stoul(argv[2]);
+    }
+
+    if (argc >= 4) {
+      max_size_mb = std::stoull(argv[3]);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "error: failed to parse arguments" << std::endl;
+    exit(EINVAL);
+  }
+
+  // Fill the write buffer with random data so that checksums are realistic
+  const uint32_t block_size = 4 * 1024 * 1024;
+  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(block_size);
+  std::ifstream urandom("/dev/urandom", std::ios::in | std::ios::binary);
+  urandom.read(buffer.get(), block_size);
+  urandom.close();
+  std::cout << std::left << std::setw(10) << "size_mb" << std::setw(8) << "files"
+            << std::setw(12) << "p50_ms" << std::setw(12) << "p90_ms"
+            << std::setw(12) << "p99_ms" << std::setw(12) << "max_ms"
+            << std::endl;
+
+  for (uint64_t size_mb : {1ull, 10ull, 100ull, 1024ull, 10240ull}) {
+    if (size_mb > max_size_mb) {
+      break;
+    }
+
+    const uint64_t fsize = size_mb * 1024 * 1024;
+    std::vector<double> latencies;
+
+    for (uint32_t i = 0; i < num_files; ++i) {
+      const std::string furl = surl + "close_bench_" + std::to_string(size_mb) +
+                               "mb_" + std::to_string(i);
+      XrdCl::File file;
+      XrdCl::XRootDStatus status =
+        file.Open(furl, XrdCl::OpenFlags::Delete | XrdCl::OpenFlags::Write,
+                  XrdCl::Access::UR | XrdCl::Access::UW);
+
+      if (!status.IsOK()) {
+        std::cerr << "error: unable to open file " << furl << " errno="
+                  << status.errNo << std::endl;
+        exit(status.errNo ? status.errNo : EIO);
+      }
+
+      for (uint64_t offset = 0; offset < fsize; offset += block_size) {
+        const uint32_t len = std::min((uint64_t)block_size, fsize - offset);
+        status = file.Write(offset, len, buffer.get());
+
+        if (!status.IsOK()) {
+          std::cerr << "error: failed write file=" << furl << " offset="
+                    << offset << std::endl;
+          exit(status.errNo ? status.errNo : EIO);
+        }
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      status = file.Close();
+      const auto stop = std::chrono::steady_clock::now();
+
+      if (!status.IsOK()) {
+        std::cerr << "error: failed to close file " << furl << std::endl;
+        exit(EIO);
+      }
+
+      latencies.push_back(std::chrono::duration<double, std::milli>
+                          (stop - start).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double pct) {
+      size_t index = (size_t)(pct / 100.0 * (latencies.size() - 1) + 0.5);
+      return latencies[index];
+    };
+    std::cout << std::left << std::fixed << std::setprecision(2)
+              << std::setw(10) << size_mb << std::setw(8) << num_files
+              << std::setw(12) << percentile(50) << std::setw(12) << percentile(90)
+              << std::setw(12) << percentile(99) << std::setw(12)
+              << latencies.back() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,266 @@
+//------------------------------------------------------------------------------
+// File: EosCommitLoadTest.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/CommitBatcher.hh"
+#include <XrdCl/XrdClFile.hh>
+#include <XrdCl/XrdClFileSystem.hh>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using eos::fst::utils::CommitBatcher;
+
+//------------------------------------------------------------------------------
+//! Run a proc command against the MGM and return its raw output
+//------------------------------------------------------------------------------
+static std::string
+RunProc(const std::string& mgm_url, const std::string& cmd)
+{
+  XrdCl::File file;
+  std::string output;
+  const std::string url = mgm_url + "//proc/user/?" + cmd;
+
+  if (!file.Open(url, XrdCl::OpenFlags::Read).IsOK()) {
+    return output;
+  }
+
+  uint32_t nread = 0;
+  uint64_t offset = 0;
+  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(64 * 1024);
+
+  while (file.Read(offset, 64 * 1024, buffer.get(), nread).IsOK() && nread) {
+    output.append(buffer.get(), nread);
+    offset += nread;
+  }
+
+  (void) file.Close();
+  return output;
+}
+
+//------------------------------------------------------------------------------
+//! Send an opaque query to the MGM
+//------------------------------------------------------------------------------
+static bool
+Query(XrdCl::FileSystem& fs, const std::string& opaque, std::string& response)
+{
+  XrdCl::Buffer arg;
+  XrdCl::Buffer* raw = nullptr;
+  arg.FromString(opaque);
+  XrdCl::XRootDStatus status = fs.Query(XrdCl::QueryCode::OpaqueFile, arg, raw);
+  std::unique_ptr<XrdCl::Buffer> resp(raw);
+  response.clear();
+
+  if (resp && resp->GetBuffer()) {
+    response.assign(resp->GetBuffer(), strnlen(resp->GetBuffer(),
+                    resp->GetSize()));
+  }
+
+  return status.IsOK();
+}
+
+//------------------------------------------------------------------------------
+//! This executable simulates <num_fst> FSTs committing files to the MGM
+//! either one commit per request (mode "single") or using the batched
+//! commit protocol (mode "batch"). It reports the achieved commits/s and for
+//! the batched mode the namespace lock hold time reported by the MGM. It
+//! needs to run with sss credentials accepted by the MGM e.g.
+//! XrdSecPROTOCOL=sss XrdSecSSSKT=/etc/eos.keytab.
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc < 5) {
+    std::cerr << "Usage: " << argv[0] << " <mgm_url> <eos_dir> <fsid> "
+              << "<single|batch> [<num_fst>] [<files_per_fst>] [<batch_size>]"
+              << std::endl
+              << "  <mgm_url> - MGM URL e.g. root://localhost:1094" << std::endl
+              << "  <eos_dir> - EOS directory where the test files are created"
+              << std::endl
+              << "  <fsid> - file system id added as location by the commits"
+              << std::endl
+              << "  <num_fst> - number of simulated FSTs, default 8" << std::endl
+              << "  <files_per_fst> - commits sent per FST, default 1000"
+              << std::endl
+              << "  <batch_size> - commits per batch request, default 64"
+              << std::endl;
+    exit(EINVAL);
+  }
+
+  const std::string mgm_url = argv[1];
+  std::string eos_dir = argv[2];
+  const std::string fsid = argv[3];
+  const bool batch_mode = (std::string(argv[4]) == "batch");
+  uint32_t num_fst = 8;
+  uint32_t files_per_fst = 1000;
+  uint32_t batch_size = 64;
+
+  try {
+    if (argc >= 6) {
+      num_fst = std::stoul(argv[5]);
+    }
+
+    if (argc >= 7) {
+      files_per_fst = std::stoul(argv[6]);
+    }
+
+    if (argc >= 8) {
+      batch_size = std::stoul(argv[7]);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "error: failed to parse arguments" << std::endl;
+    exit(EINVAL);
+  }
+
+  if (eos_dir.back() != '/') {
+    eos_dir += '/';
+  }
+
+  // Create the test files and collect their file identifiers
+  XrdCl::URL url(mgm_url + "//dummy?xrd.wantprot=sss");
+
+  if (!url.IsValid()) {
+    std::cerr << "error: given URL is not valid" << std::endl;
+    exit(EINVAL);
+  }
+
+  XrdCl::FileSystem fs(url);
+  (void) fs.MkDir(eos_dir, XrdCl::MkDirFlags::MakePath,
+                  XrdCl::Access::UR | XrdCl::Access::UW | XrdCl::Access::UX);
+  std::vector<std::vector<std::string>> items(num_fst);
+  const std::string mtime = std::to_string(time(nullptr));
+  std::cout << "info: creating " << num_fst * files_per_fst << " files"
+            << std::endl;
+
+  for (uint32_t fst = 0; fst < num_fst; ++fst) {
+    for (uint32_t i = 0; i < files_per_fst; ++i) {
+      const std::string path = eos_dir + "commit_load_" + std::to_string(fst) +
+                               "_" + std::to_string(i);
+      (void) RunProc(mgm_url, "mgm.cmd=file&mgm.subcmd=touch&mgm.path=" + path);
+      const std::string info = RunProc(mgm_url, "mgm.cmd=fileinfo&mgm.path=" +
+                                       path + "&mgm.file.info.option=-m");
+      const size_t pos = info.find("fxid=");
+
+      if (pos == std::string::npos) {
+        std::cerr << "error: failed to create file " << path << std::endl;
+        exit(EIO);
+      }
+
+      std::string fxid = info.substr(pos + 5);
+      fxid = fxid.substr(0, fxid.find_first_of(" &\n"));
+      std::ostringstream oss;
+      oss << "mgm.path=" << path << "&mgm.fid=" << fxid
+          << "&mgm.add.fsid=" << fsid << "&mgm.size=0&mgm.mtime=" << mtime
+          << "&mgm.mtime_ns=0&mgm.commit.size=1&mgm.logid=commit_load";
+      items[fst].push_back(oss.str());
+    }
+  }
+
+  std::atomic<uint64_t> num_ok {0};
+  std::atomic<uint64_t> num_failed {0};
+  std::mutex mutex;
+  std::vector<uint64_t> lock_hold_us;
+  std::vector<std::thread> workers;
+  const auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t fst = 0; fst < num_fst; ++fst) {
+    workers.emplace_back([&, fst]() {
+      XrdCl::FileSystem fst_fs(url);
+      std::string response;
+      const auto& fst_items = items[fst];
+
+      if (!batch_mode) {
+        for (const auto& item : fst_items) {
+          if (Query(fst_fs, "/?mgm.pcmd=commit&" + item, response)) {
+            ++num_ok;
+          } else {
+            ++num_failed;
+          }
+        }
+
+        return;
+      }
+
+      for (size_t off = 0; off < fst_items.size(); off += batch_size) {
+        std::vector<std::string> batch
+        (fst_items.begin() + off, fst_items.begin() +
+         std::min(fst_items.size(), off + batch_size));
+        std::vector<int> retcs;
+
+        if (!Query(fst_fs, CommitBatcher::BuildRequest(batch), response) ||
+            !CommitBatcher::ParseResponse(response, batch.size(), retcs)) {
+          num_failed += batch.size();
+          continue;
+        }
+
+        for (int retc : retcs) {
+          (retc ? num_failed : num_ok)++;
+        }
+
+        const size_t pos = response.find("lock_us=");
+
+        if (pos != std::string::npos) {
+          std::lock_guard<std::mutex> lock(mutex);
+          lock_hold_us.push_back(std::stoull(response.substr(pos + 8)));
+        }
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  const double duration = std::chrono::duration<double>
+                          (std::chrono::steady_clock::now() - start).count();
+  std::cout << std::fixed << std::setprecision(2)
+            << "mode=" << (batch_mode ? "batch" : "single")
+            << " num_fst=" << num_fst
+            << " commits_ok=" << num_ok.load()
+            << " commits_failed=" << num_failed.load()
+            << " duration_s=" << duration
+            << " commits_per_s=" << (duration ? num_ok / duration : 0.0)
+            << std::endl;
+
+  if (!lock_hold_us.empty()) {
+    std::sort(lock_hold_us.begin(), lock_hold_us.end());
+    uint64_t total = 0ull;
+
+    for (auto val : lock_hold_us) {
+      total += val;
+    }
+
+    std::cout << "lock_hold batches=" << lock_hold_us.size()
+              << " avg_us=" << total / lock_hold_us.size()
+              << " p99_us=" << lock_hold_us[(lock_hold_us.size() - 1) * 99 / 100]
+              << " max_us=" << lock_hold_us.back()
+              << " per_commit_us=" << (double) total / (num_ok ? num_ok.load() : 1)
+              << std::endl;
+  }
+
+  return (num_failed ? EIO : 0);
+}
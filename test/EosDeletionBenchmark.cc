@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------------
+// File: EosDeletionBenchmark.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/DeletionExecutor.hh"
+#include <chrono>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+//------------------------------------------------------------------------------
+//! Path of a file inside a FST like tree i.e. <dir>/fs<fsid>/<fid/10k>/<fid>
+//------------------------------------------------------------------------------
+std::string
+FilePath(const std::string& dir, uint32_t fsid, uint64_t fid)
+{
+  char buff[64];
+  snprintf(buff, sizeof(buff), "/fs%u/%08llx/%08llx", fsid,
+           (unsigned long long)(fid / 10000), (unsigned long long) fid);
+  return dir + buff;
+}
+
+//------------------------------------------------------------------------------
+//! Create the files, spread round-robin over the file systems
+//------------------------------------------------------------------------------
+void
+Populate(const std::string& dir, uint32_t num_fs, uint64_t num_files)
+{
+  (void) mkdir(dir.c_str(), 0755);
+
+  for (uint32_t fsid = 1; fsid <= num_fs; ++fsid) {
+    (void) mkdir((dir + "/fs" + std::to_string(fsid)).c_str(), 0755);
+
+    for (uint64_t fid = 0; fid <= num_files; fid += 10000) {
+      const std::string path = FilePath(dir, fsid, fid);
+      (void) mkdir(path.substr(0, path.rfind('/')).c_str(), 0755);
+    }
+  }
+
+  for (uint64_t fid = 1; fid <= num_files; ++fid) {
+    const std::string path = FilePath(dir, 1 + (fid % num_fs), fid);
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY, 0644);
+
+    if (fd < 0) {
+      std::cerr << "error: failed to create " << path << " errno=" << errno
+                << std::endl;
+      exit(errno);
+    }
+
+    (void) close(fd);
+  }
+}
+
+//------------------------------------------------------------------------------
+//! Delete one file, optionally simulating the MGM drop round-trip
+//------------------------------------------------------------------------------
+bool
+DeleteFile(const std::string& dir, uint32_t fsid, uint64_t fid,
+           std::chrono::microseconds drop_latency)
+{
+  const bool ok = (unlink(FilePath(dir, fsid, fid).c_str()) == 0);
+
+  if (drop_latency.count()) {
+    std::this_thread::sleep_for(drop_latency);
+  }
+
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+//! Print the duration of a phase
+//------------------------------------------------------------------------------
+void
+Report(const std::string& phase, std::chrono::steady_clock::time_point start,
+       uint64_t count, const std::string& extra = "")
+{
+  using namespace std::chrono;
+  const double sec = duration_cast<microseconds>(steady_clock::now() -
+                     start).count() / 1e6;
+  std::cout << std::left << std::setw(36) << phase << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << sec << " s "
+            << std::setw(12) << std::setprecision(0)
+            << (sec > 0 ? count / sec : 0) << " unlinks/s " << extra
+            << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//! Run the deletion of all the files through the executor
+//!
+//! @param busy_fsid file system reported busy during the first seconds of
+//!        the run, 0 if none
+//------------------------------------------------------------------------------
+void
+RunExecutor(const std::string& dir, uint32_t num_fs, uint64_t num_files,
+            const eos::fst::utils::DeletionExecutor::Options& opts,
+            std::chrono::microseconds drop_latency, uint32_t busy_fsid)
+{
+  using namespace std::chrono;
+  using eos::fst::utils::DeletionExecutor;
+  Populate(dir, num_fs, num_files);
+  std::vector<std::vector<unsigned long long>> fids(num_fs + 1);
+
+  for (uint64_t fid = 1; fid <= num_files; ++fid) {
+    fids[1 + (fid % num_fs)].push_back(fid);
+  }
+
+  auto start = steady_clock::now();
+  DeletionExecutor executor([&](uint32_t fsid, uint64_t fid) {
+    return DeleteFile(dir, fsid, fid, drop_latency);
+  }, [busy_fsid, start](uint32_t fsid) {
+    return ((fsid == busy_fsid) && (steady_clock::now() - start < seconds(2)));
+  }, opts);
+
+  for (uint32_t fsid = 1; fsid <= num_fs; ++fsid) {
+    executor.Submit(fsid, fids[fsid]);
+  }
+
+  while (!executor.WaitIdle(seconds(5))) {
+    std::map<std::string, std::string> output;
+    executor.Publish(output);
+    std::cout << "  pending=" << output["stat.deletion.pending"]
+              << " rate=" << output["stat.deletion.rate"] << " Hz"
+              << " yields=" << output["stat.deletion.yields"] << std::endl;
+  }
+
+  std::string tag = "executor threads=" + std::to_string(opts.mNumThreads) +
+                    " per_fs=" + std::to_string(opts.mMaxPerFs);
+
+  if (busy_fsid) {
+    tag += " busy";
+  }
+
+  Report(tag, start, executor.GetNumDeleted(),
+         "failed=" + std::to_string(executor.GetNumFailed()) +
+         " yields=" + std::to_string(executor.GetNumYields()));
+}
+}
+
+//------------------------------------------------------------------------------
+//! This executable measures the FST deletion rate. It creates <num_files>
+//! empty files spread over <num_fs> file system directories under <dir>,
+//! ideally on a tmpfs so that the unlink cost is the file system overhead
+//! only, and then times:
+//!  - the deletion in a single thread, one file after the other, as done by
+//!    the Remover thread before the deletion executor
+//!  - the deletion through the executor with the given number of threads and
+//!    concurrent batches per file system
+//!  - the same with file system 1 reported busy for the first 2 seconds,
+//!    during which it gets a single batch at a time and a pause between
+//!    batches
+//! The optional <drop_latency_us> adds a sleep per file emulating the MGM
+//! drop call done after every unlink.
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <dir> [<num_files>] [<num_fs>] "
+              << "[<threads>] [<per_fs>] [<drop_latency_us>]" << std::endl
+              << "  <dir> - directory used for the test, preferably on tmpfs "
+              << "e.g. /dev/shm/eos-deletion" << std::endl
+              << "  <num_files> - number of files to delete, default 1000000"
+              << std::endl
+              << "  <num_fs> - number of file systems, default 4" << std::endl
+              << "  <threads> - executor threads, default 16" << std::endl
+              << "  <per_fs> - concurrent batches per file system, default 2"
+              << std::endl
+              << "  <drop_latency_us> - emulated MGM drop latency per file, "
+              << "default 0" << std::endl;
+    exit(EINVAL);
+  }
+
+  const std::string dir = argv[1];
+  uint64_t num_files = 1000000;
+  uint32_t num_fs = 4;
+  eos::fst::utils::DeletionExecutor::Options opts;
+  std::chrono::microseconds drop_latency {0};
+
+  try {
+    if (argc >= 3) {
+      num_files = std::stoull(argv[2]);
+    }
+
+    if (argc >= 4) {
+      num_fs = std::max(1ul, std::stoul(argv[3]));
+    }
+
+    if (argc >= 5) {
+      opts.mNumThreads = std::stoul(argv[4]);
+    }
+
+    if (argc >= 6) {
+      opts.mMaxPerFs = std::stoul(argv[5]);
+    }
+
+    if (argc >= 7) {
+      drop_latency = std::chrono::microseconds(std::stoull(argv[6]));
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "error: failed to parse arguments" << std::endl;
+    exit(EINVAL);
+  }
+
+  using namespace std::chrono;
+  auto start = steady_clock::now();
+  Populate(dir, num_fs, num_files);
+  Report("populate", start, num_files);
+  // Previous behaviour: one thread deleting one file after the other
+  start = steady_clock::now();
+  uint64_t count = 0;
+
+  for (uint64_t fid = 1; fid <= num_files; ++fid) {
+    count += DeleteFile(dir, 1 + (fid % num_fs), fid, drop_latency);
+  }
+
+  Report("sequential", start, count);
+  RunExecutor(dir, num_fs, num_files, opts, drop_latency, 0);
+  RunExecutor(dir, num_fs, num_files, opts, drop_latency, 1);
+  return 0;
+}
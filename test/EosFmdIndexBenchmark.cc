@@ -0,0 +1,295 @@
+//------------------------------------------------------------------------------
+// File: EosFmdIndexBenchmark.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/filemd/FmdIndex.hh"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <fts.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+constexpr auto sFmdAttrName = "user.eos.fmd";
+
+//------------------------------------------------------------------------------
+//! Path of a file inside a FST like tree i.e. <mount>/<fid/10k>/<fid hex>
+//------------------------------------------------------------------------------
+std::string
+FilePath(const std::string& mount, uint64_t fid)
+{
+  char buff[64];
+  snprintf(buff, sizeof(buff), "/%08llx/%08llx",
+           (unsigned long long)(fid / 10000), (unsigned long long) fid);
+  return mount + buff;
+}
+
+//------------------------------------------------------------------------------
+//! Try to drop the page, dentry and inode caches, needs root
+//------------------------------------------------------------------------------
+bool
+DropCaches()
+{
+  sync();
+  std::ofstream file("/proc/sys/vm/drop_caches");
+
+  if (!file.good()) {
+    return false;
+  }
+
+  file << "3" << std::endl;
+  return file.good();
+}
+
+//------------------------------------------------------------------------------
+//! Print the duration of a phase
+//------------------------------------------------------------------------------
+void
+Report(const std::string& phase, std::chrono::steady_clock::time_point start,
+       uint64_t count)
+{
+  using namespace std::chrono;
+  const double sec = duration_cast<microseconds>(steady_clock::now() -
+                     start).count() / 1e6;
+  std::cout << std::left << std::setw(36) << phase << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << sec << " s "
+            << std::setw(12) << std::setprecision(0)
+            << (sec > 0 ? count / sec : 0) << " entries/s" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//! Walk the tree like the FST does and apply the function to every file
+//------------------------------------------------------------------------------
+template <typename Fn>
+uint64_t
+Walk(const std::string& mount, Fn fn)
+{
+  std::string path = mount;
+  char* argv[] = {&path[0], nullptr};
+  FTS* tree = fts_open(argv, FTS_NOCHDIR, 0);
+  uint64_t count = 0;
+
+  if (!tree) {
+    return 0;
+  }
+
+  while (FTSENT* node = fts_read(tree)) {
+    if ((node->fts_level > 0) && (node->fts_name[0] == '.')) {
+      fts_set(tree, node, FTS_SKIP);
+    } else if (node->fts_info == FTS_F) {
+      fn(node->fts_path);
+      ++count;
+    }
+  }
+
+  (void) fts_close(tree);
+  return count;
+}
+
+//------------------------------------------------------------------------------
+//! Read and parse the Fmd xattr of the given file
+//------------------------------------------------------------------------------
+bool
+ReadFmdAttr(const char* path, eos::common::FmdHelper& fmd)
+{
+  char buff[4096];
+  ssize_t len = getxattr(path, sFmdAttrName, buff, sizeof(buff));
+  return (len > 0) && fmd.mProtoFmd.ParsePartialFromArray(buff, len);
+}
+}
+
+//------------------------------------------------------------------------------
+//! This executable compares the full scan and lookup of the FST file metadata
+//! through the per file extended attributes with the per file system Fmd
+//! index. It populates <dir> with <num_files> empty files carrying a
+//! user.eos.fmd xattr, laid out like an FST mountpoint, and then times:
+//!  - the tree walk reading every xattr, as done by the boot resync
+//!  - the index rebuild from the xattrs, done once when there is no index
+//!  - reopening the index after a clean shutdown
+//!  - iterating over all the index records
+//!  - random lookups by file id through the xattrs and through the index
+//! When run as root the caches are dropped before every phase.
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <dir> [<num_files>] [<num_lookups>]"
+              << std::endl
+              << "  <dir> - directory on a file system supporting user xattrs"
+              << std::endl
+              << "  <num_files> - number of files to create, default 1000000"
+              << std::endl
+              << "  <num_lookups> - number of random lookups, default 100000"
+              << std::endl;
+    exit(EINVAL);
+  }
+
+  const std::string mount = argv[1];
+  uint64_t num_files = 1000000;
+  uint64_t num_lookups = 100000;
+
+  try {
+    if (argc >= 3) {
+      num_files = std::stoull(argv[2]);
+    }
+
+    if (argc >= 4) {
+      num_lookups = std::stoull(argv[3]);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "error: failed to parse arguments" << std::endl;
+    exit(EINVAL);
+  }
+
+  using namespace std::chrono;
+  eos::fst::FmdIndex::Remove(mount);
+  auto start = steady_clock::now();
+
+  // Populate the tree, existing files are reused between runs
+  for (uint64_t fid = 1; fid <= num_files; ++fid) {
+    const std::string path = FilePath(mount, fid);
+
+    if (access(path.c_str(), F_OK) == 0) {
+      continue;
+    }
+
+    if ((fid == 1) || ((fid % 10000) == 0)) {
+      (void) mkdir(path.substr(0, path.rfind('/')).c_str(), 0755);
+    }
+
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY, 0644);
+
+    if (fd < 0) {
+      std::cerr << "error: failed to create " << path << " errno=" << errno
+                << std::endl;
+      exit(errno);
+    }
+
+    eos::common::FmdHelper fmd(fid, 1);
+    fmd.mProtoFmd.set_cid(fid / 100);
+    fmd.mProtoFmd.set_size(fid * 4096);
+    fmd.mProtoFmd.set_disksize(fid * 4096);
+    fmd.mProtoFmd.set_mgmsize(fid * 4096);
+    fmd.mProtoFmd.set_checksum("0a1b2c3d");
+    fmd.mProtoFmd.set_diskchecksum("0a1b2c3d");
+    fmd.mProtoFmd.set_mgmchecksum("0a1b2c3d");
+    fmd.mProtoFmd.set_lid(0x00100002);
+    fmd.mProtoFmd.set_locations("1,2");
+    std::string val;
+    fmd.mProtoFmd.SerializePartialToString(&val);
+
+    if (fsetxattr(fd, sFmdAttrName, val.data(), val.size(), 0)) {
+      std::cerr << "error: failed to set xattr on " << path << " errno="
+                << errno << std::endl;
+      exit(errno);
+    }
+
+    (void) close(fd);
+  }
+
+  Report("populate", start, num_files);
+  const bool drop = DropCaches();
+
+  if (!drop) {
+    std::cout << "info: not allowed to drop the caches, results are warm"
+              << std::endl;
+  }
+
+  // Current behaviour: walk the tree and read every xattr
+  start = steady_clock::now();
+  uint64_t count = Walk(mount, [](const char* path) {
+    eos::common::FmdHelper fmd;
+    (void) ReadFmdAttr(path, fmd);
+  });
+  Report("walk + getxattr", start, count);
+  // Index rebuild from the xattrs
+  (void)(drop && DropCaches());
+  start = steady_clock::now();
+  {
+    eos::fst::FmdIndex index(mount);
+    bool rebuild = false;
+
+    if (!index.Open(rebuild)) {
+      std::cerr << "error: failed to open the index" << std::endl;
+      exit(EIO);
+    }
+
+    count = Walk(mount, [&index](const char* path) {
+      eos::common::FmdHelper fmd;
+
+      if (ReadFmdAttr(path, fmd)) {
+        (void) index.Put(fmd);
+      }
+    });
+  }
+  Report("index rebuild (one-off)", start, count);
+  // Index reopen after a clean shutdown
+  (void)(drop && DropCaches());
+  start = steady_clock::now();
+  eos::fst::FmdIndex index(mount);
+  bool rebuild = false;
+
+  if (!index.Open(rebuild) || rebuild) {
+    std::cerr << "error: index not reused after clean close" << std::endl;
+    exit(EIO);
+  }
+
+  Report("index reopen", start, index.Size());
+  start = steady_clock::now();
+  count = index.ForEach([](const eos::common::FmdHelper&) {});
+  Report("index full scan", start, count);
+  // Random lookups by file id
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<uint64_t> dist(1, num_files);
+  std::vector<uint64_t> fids(num_lookups);
+
+  for (auto& fid : fids) {
+    fid = dist(gen);
+  }
+
+  (void)(drop && DropCaches());
+  start = steady_clock::now();
+
+  for (const auto fid : fids) {
+    eos::common::FmdHelper fmd;
+    (void) ReadFmdAttr(FilePath(mount, fid).c_str(), fmd);
+  }
+
+  Report("lookup getxattr", start, fids.size());
+  (void)(drop && DropCaches());
+  start = steady_clock::now();
+
+  for (const auto fid : fids) {
+    eos::common::FmdHelper fmd;
+    (void) index.Get(fid, fmd);
+  }
+
+  Report("lookup index", start, fids.size());
+  return 0;
+}
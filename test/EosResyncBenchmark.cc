@@ -0,0 +1,393 @@
+//------------------------------------------------------------------------------
+// File: EosResyncBenchmark.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/Fmd.hh"
+#include "common/StringConversion.hh"
+#include "fst/utils/PipelineStage.hh"
+#include "namespace/ns_quarkdb/QdbContactDetails.hh"
+#include "qclient/QClient.hh"
+#include <chrono>
+#include <fcntl.h>
+#include <fstream>
+#include <fts.h>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+constexpr auto sFmdAttrName = "user.eos.fmd";
+constexpr auto sQdbHashKey = "eos-resync-benchmark";
+//! Extended attributes read by the disk resync of every file
+const std::vector<std::string> sDiskAttrs {
+  "user.eos.checksumtype", "user.eos.filecxerror", "user.eos.blockcxerror",
+  "user.eos.timestamp", "user.eos.checksum"};
+
+//------------------------------------------------------------------------------
+//! Path of a file inside a FST like tree i.e. <mount>/<fid/10k>/<fid hex>
+//------------------------------------------------------------------------------
+std::string
+FilePath(const std::string& mount, uint64_t fid)
+{
+  char buff[64];
+  snprintf(buff, sizeof(buff), "/%08llx/%08llx",
+           (unsigned long long)(fid / 10000), (unsigned long long) fid);
+  return mount + buff;
+}
+
+//------------------------------------------------------------------------------
+//! Try to drop the page, dentry and inode caches, needs root
+//------------------------------------------------------------------------------
+bool
+DropCaches()
+{
+  sync();
+  std::ofstream file("/proc/sys/vm/drop_caches");
+
+  if (!file.good()) {
+    return false;
+  }
+
+  file << "3" << std::endl;
+  return file.good();
+}
+
+//------------------------------------------------------------------------------
+//! Print the duration of a phase
+//------------------------------------------------------------------------------
+void
+Report(const std::string& phase, std::chrono::steady_clock::time_point start,
+       uint64_t count)
+{
+  using namespace std::chrono;
+  const double sec = duration_cast<microseconds>(steady_clock::now() -
+                     start).count() / 1e6;
+  std::cout << std::left << std::setw(36) << phase << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << sec << " s "
+            << std::setw(12) << std::setprecision(0)
+            << (sec > 0 ? count / sec : 0) << " entries/s" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//! Walk the tree like the FST does and apply the function to every file
+//------------------------------------------------------------------------------
+template <typename Fn>
+uint64_t
+Walk(const std::string& mount, Fn fn)
+{
+  std::string path = mount;
+  char* argv[] = {&path[0], nullptr};
+  FTS* tree = fts_open(argv, FTS_NOCHDIR, 0);
+  uint64_t count = 0;
+
+  if (!tree) {
+    return 0;
+  }
+
+  while (FTSENT* node = fts_read(tree)) {
+    if ((node->fts_level > 0) && (node->fts_name[0] == '.')) {
+      fts_set(tree, node, FTS_SKIP);
+    } else if (node->fts_info == FTS_F) {
+      fn(node->fts_path);
+      ++count;
+    }
+  }
+
+  (void) fts_close(tree);
+  return count;
+}
+
+//------------------------------------------------------------------------------
+//! Read, modify and write back the Fmd xattr of the given file, which is what
+//! the local metadata update of the resync does
+//------------------------------------------------------------------------------
+void
+UpdateFmdAttr(const char* path, const eos::common::FmdHelper* mgm_fmd)
+{
+  char buff[4096];
+  ssize_t len = getxattr(path, sFmdAttrName, buff, sizeof(buff));
+  eos::common::FmdHelper fmd;
+
+  if ((len <= 0) || !fmd.mProtoFmd.ParsePartialFromArray(buff, len)) {
+    return;
+  }
+
+  if (mgm_fmd) {
+    fmd.mProtoFmd.set_mgmsize(mgm_fmd->mProtoFmd.mgmsize());
+    fmd.mProtoFmd.set_mgmchecksum(mgm_fmd->mProtoFmd.mgmchecksum());
+  } else {
+    fmd.mProtoFmd.set_disksize(fmd.mProtoFmd.size());
+  }
+
+  std::string val;
+  fmd.mProtoFmd.SerializePartialToString(&val);
+  (void) setxattr(path, sFmdAttrName, val.data(), val.size(), 0);
+}
+
+//------------------------------------------------------------------------------
+//! Disk resync of one file: stat, read the checksum related xattrs and
+//! update the Fmd
+//------------------------------------------------------------------------------
+void
+ResyncDisk(const char* path)
+{
+  struct stat info;
+  char buff[256];
+
+  if (stat(path, &info) || !S_ISREG(info.st_mode)) {
+    return;
+  }
+
+  for (const auto& attr : sDiskAttrs) {
+    (void) getxattr(path, attr.c_str(), buff, sizeof(buff));
+  }
+
+  UpdateFmdAttr(path, nullptr);
+}
+
+//------------------------------------------------------------------------------
+//! QuarkDB resync of all the files, the replies are merged into the local
+//! metadata either in the current thread or by the pipeline workers
+//------------------------------------------------------------------------------
+uint64_t
+ResyncQdb(qclient::QClient& qcl, const std::string& mount, uint64_t num_files,
+          uint32_t num_workers, size_t max_in_flight)
+{
+  using FidFmdPair = std::pair<uint64_t, eos::common::FmdHelper>;
+  auto apply = [&mount](FidFmdPair & entry) {
+    UpdateFmdAttr(FilePath(mount, entry.first).c_str(), &entry.second);
+  };
+  std::unique_ptr<eos::fst::utils::PipelineStage<FidFmdPair>> stage;
+
+  if (num_workers) {
+    stage.reset(new eos::fst::utils::PipelineStage<FidFmdPair>
+                (num_workers, max_in_flight, apply));
+  }
+
+  uint64_t fid = 1;
+  std::list<std::pair<uint64_t, std::future<qclient::redisReplyPtr>>> replies;
+
+  while ((fid <= num_files) || !replies.empty()) {
+    while ((fid <= num_files) && (replies.size() < max_in_flight)) {
+      replies.emplace_back(fid, qcl.exec("HGET", sQdbHashKey,
+                                         std::to_string(fid)));
+      ++fid;
+    }
+
+    FidFmdPair entry(replies.front().first, eos::common::FmdHelper());
+    qclient::redisReplyPtr reply = replies.front().second.get();
+    replies.pop_front();
+
+    if (reply && (reply->type == REDIS_REPLY_STRING)) {
+      (void) entry.second.mProtoFmd.ParsePartialFromArray(reply->str,
+          reply->len);
+    }
+
+    if (stage) {
+      stage->Push(std::move(entry));
+    } else {
+      apply(entry);
+    }
+  }
+
+  return num_files;
+}
+}
+
+//------------------------------------------------------------------------------
+//! This executable compares the sequential FST boot resync with the pipelined
+//! one. It populates <dir> with <num_files> empty files carrying the xattrs
+//! of an FST file, laid out like an FST mountpoint, and then times:
+//!  - the disk resync in the walking thread, as done before
+//!  - the disk resync with the walk feeding <n> worker threads, for every
+//!    value in the comma separated <workers> list
+//! If a QuarkDB <host:port> is given, one Fmd record per file is stored in a
+//! hash there and the QuarkDB resync is timed with the replies merged in the
+//! requesting thread and by the worker threads. The hash is deleted at the
+//! end. When run as root the caches are dropped before every phase.
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <dir> [<num_files>] [<workers>] "
+              << "[<qdb_host:port>]" << std::endl
+              << "  <dir> - directory on a file system supporting user xattrs"
+              << std::endl
+              << "  <num_files> - number of files to create, default 200000"
+              << std::endl
+              << "  <workers> - comma separated list of worker counts to "
+              << "test, default 4,8,16" << std::endl
+              << "  <qdb_host:port> - local QuarkDB instance used to time "
+              << "the QuarkDB resync, skipped if missing" << std::endl;
+    exit(EINVAL);
+  }
+
+  const std::string mount = argv[1];
+  uint64_t num_files = 200000;
+  std::vector<uint32_t> workers {4, 8, 16};
+  std::string qdb_members;
+
+  try {
+    if (argc >= 3) {
+      num_files = std::stoull(argv[2]);
+    }
+
+    if (argc >= 4) {
+      std::vector<std::string> tokens;
+      eos::common::StringConversion::Tokenize(argv[3], tokens, ",");
+      workers.clear();
+
+      for (const auto& token : tokens) {
+        workers.push_back(std::stoul(token));
+      }
+    }
+
+    if (argc >= 5) {
+      qdb_members = argv[4];
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "error: failed to parse arguments" << std::endl;
+    exit(EINVAL);
+  }
+
+  using namespace std::chrono;
+  auto start = steady_clock::now();
+
+  // Populate the tree, existing files are reused between runs
+  for (uint64_t fid = 1; fid <= num_files; ++fid) {
+    const std::string path = FilePath(mount, fid);
+
+    if (access(path.c_str(), F_OK) == 0) {
+      continue;
+    }
+
+    if ((fid == 1) || ((fid % 10000) == 0)) {
+      (void) mkdir(path.substr(0, path.rfind('/')).c_str(), 0755);
+    }
+
+    int fd = open(path.c_str(), O_CREAT | O_WRONLY, 0644);
+
+    if (fd < 0) {
+      std::cerr << "error: failed to create " << path << " errno=" << errno
+                << std::endl;
+      exit(errno);
+    }
+
+    eos::common::FmdHelper fmd(fid, 1);
+    fmd.mProtoFmd.set_size(fid * 4096);
+    fmd.mProtoFmd.set_checksum("0a1b2c3d");
+    std::string val;
+    fmd.mProtoFmd.SerializePartialToString(&val);
+    const char xs[4] = {0x0a, 0x1b, 0x2c, 0x3d};
+
+    if (fsetxattr(fd, sFmdAttrName, val.data(), val.size(), 0) ||
+        fsetxattr(fd, "user.eos.checksumtype", "adler", 5, 0) ||
+        fsetxattr(fd, "user.eos.checksum", xs, sizeof(xs), 0) ||
+        fsetxattr(fd, "user.eos.timestamp", "1700000000", 10, 0)) {
+      std::cerr << "error: failed to set xattr on " << path << " errno="
+                << errno << std::endl;
+      exit(errno);
+    }
+
+    (void) close(fd);
+  }
+
+  Report("populate", start, num_files);
+  const bool drop = DropCaches();
+
+  if (!drop) {
+    std::cout << "info: not allowed to drop the caches, results are warm"
+              << std::endl;
+  }
+
+  // Disk resync in the walking thread
+  start = steady_clock::now();
+  uint64_t count = Walk(mount, ResyncDisk);
+  Report("disk resync sequential", start, count);
+
+  // Disk resync with the walk feeding the workers
+  for (const auto num_workers : workers) {
+    (void)(drop && DropCaches());
+    start = steady_clock::now();
+    {
+      eos::fst::utils::PipelineStage<std::string> stage(num_workers, 1000,
+      [](std::string & path) {
+        ResyncDisk(path.c_str());
+      });
+      count = Walk(mount, [&stage](const char* path) {
+        stage.Push(std::string(path));
+      });
+    }
+    Report("disk resync workers=" + std::to_string(num_workers), start, count);
+  }
+
+  if (qdb_members.empty()) {
+    return 0;
+  }
+
+  // Store one Fmd record per file in QuarkDB
+  qclient::Members members = qclient::Members::fromString(qdb_members);
+  eos::QdbContactDetails contact_details(members, "");
+  qclient::QClient qcl(contact_details.members,
+                       contact_details.constructOptions());
+  start = steady_clock::now();
+  (void) qcl.exec("DEL", sQdbHashKey).get();
+  std::list<std::future<qclient::redisReplyPtr>> replies;
+
+  for (uint64_t fid = 1; fid <= num_files; ++fid) {
+    eos::common::FmdHelper fmd(fid, 1);
+    fmd.mProtoFmd.set_mgmsize(fid * 4096);
+    fmd.mProtoFmd.set_mgmchecksum("0a1b2c3d");
+    std::string val;
+    fmd.mProtoFmd.SerializePartialToString(&val);
+    replies.push_back(qcl.exec("HSET", sQdbHashKey, std::to_string(fid), val));
+
+    if (replies.size() >= 1000) {
+      (void) replies.front().get();
+      replies.pop_front();
+    }
+  }
+
+  for (auto& reply : replies) {
+    (void) reply.get();
+  }
+
+  Report("qdb populate", start, num_files);
+  (void)(drop && DropCaches());
+  start = steady_clock::now();
+  count = ResyncQdb(qcl, mount, num_files, 0, 1000);
+  Report("qdb resync sequential", start, count);
+
+  for (const auto num_workers : workers) {
+    (void)(drop && DropCaches());
+    start = steady_clock::now();
+    count = ResyncQdb(qcl, mount, num_files, num_workers, 1000);
+    Report("qdb resync workers=" + std::to_string(num_workers), start, count);
+  }
+
+  (void) qcl.exec("DEL", sQdbHashKey).get();
+  return 0;
+}
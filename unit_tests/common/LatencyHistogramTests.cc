@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+// File: LatencyHistogramTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/LatencyHistogram.hh"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using eos::common::LatencyHistogram;
+
+TEST(LatencyHistogram, BucketBounds)
+{
+  for (uint64_t val : {0ull, 1ull, 7ull, 8ull, 15ull, 16ull, 17ull, 1000ull,
+                       123456789ull, (1ull << 40) + 3, ~0ull}) {
+    const size_t index = LatencyHistogram::GetBucketIndex(val);
+    ASSERT_LT(index, LatencyHistogram::sNumBuckets);
+    ASSERT_LE(LatencyHistogram::GetBucketLowerBound(index), val);
+    ASSERT_GE(LatencyHistogram::GetBucketUpperBound(index), val);
+  }
+
+  // Buckets must be contiguous
+  for (size_t i = 1; i < LatencyHistogram::sNumBuckets; ++i) {
+    ASSERT_EQ(LatencyHistogram::GetBucketUpperBound(i - 1) + 1,
+              LatencyHistogram::GetBucketLowerBound(i));
+  }
+}
+
+TEST(LatencyHistogram, Percentiles)
+{
+  LatencyHistogram histo;
+  ASSERT_EQ(0, histo.GetPercentile(50));
+
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    histo.Add(i);
+  }
+
+  ASSERT_EQ(1000, histo.GetCount());
+  ASSERT_EQ(1000, histo.GetMax());
+  ASSERT_DOUBLE_EQ(500.5, histo.GetMean());
+  // Relative error is bounded by 1/sSubBuckets
+  const double max_err = 1.0 / LatencyHistogram::sSubBuckets;
+
+  for (double pct : {10.0, 50.0, 90.0, 99.0}) {
+    const double expected = pct * 10;
+    const double value = histo.GetPercentile(pct);
+    ASSERT_GE(value, expected);
+    ASSERT_LE(value, expected * (1 + max_err));
+  }
+
+  ASSERT_EQ(1000, histo.GetPercentile(100));
+  histo.Reset();
+  ASSERT_EQ(0, histo.GetCount());
+  ASSERT_EQ(0, histo.GetPercentile(99));
+}
+
+TEST(LatencyHistogram, MergeConcurrent)
+{
+  const int num_threads = 8;
+  const uint64_t per_thread = 10000;
+  LatencyHistogram shared;
+  std::vector<LatencyHistogram> local(num_threads);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        shared.Add(i);
+        local[t].Add(i);
+      }
+    });
+  }
+
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  LatencyHistogram merged;
+
+  for (const auto& histo : local) {
+    merged.Merge(histo);
+  }
+
+  ASSERT_EQ(num_threads * per_thread, shared.GetCount());
+  ASSERT_EQ(shared.GetCount(), merged.GetCount());
+  ASSERT_EQ(shared.GetSum(), merged.GetSum());
+  ASSERT_EQ(shared.GetMax(), merged.GetMax());
+  ASSERT_EQ(shared.GetPercentile(99), merged.GetPercentile(99));
+}
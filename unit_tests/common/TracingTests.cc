@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+// File: TracingTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/Tracing.hh"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using eos::common::SpanKind;
+using eos::common::TraceEvent;
+using eos::common::Tracer;
+using eos::common::TraceRequest;
+using eos::common::TraceSpan;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Simulated request with a few phases
+//------------------------------------------------------------------------------
+__attribute__((noinline)) uint64_t
+DoRequest(uint64_t val)
+{
+  TraceRequest request("test.request");
+  {
+    TraceSpan span("test.lookup");
+    val = val * 2862933555777941757ull + 3037000493ull;
+  }
+  TraceSpan span("test.wait", SpanKind::kLockWait);
+  return val ^ (val >> 29);
+}
+
+//------------------------------------------------------------------------------
+// Same request without tracing
+//------------------------------------------------------------------------------
+__attribute__((noinline)) uint64_t
+DoPlainRequest(uint64_t val)
+{
+  val = val * 2862933555777941757ull + 3037000493ull;
+  return val ^ (val >> 29);
+}
+}
+
+//------------------------------------------------------------------------------
+// Sampled requests record nested spans and histograms
+//------------------------------------------------------------------------------
+TEST(Tracing, SampledSpans)
+{
+  Tracer& tracer = Tracer::Instance();
+  tracer.Reset();
+  Tracer::SetSampleRate(1);
+  std::thread worker([]() {
+    for (int i = 0; i < 10; ++i) {
+      (void) DoRequest(i);
+    }
+
+    // Spans outside a request are ignored
+    TraceSpan orphan("test.orphan");
+  });
+  worker.join();
+  Tracer::SetSampleRate(0);
+  ASSERT_FALSE(Tracer::IsTracing());
+  ASSERT_EQ(tracer.GetNumTraces(), 10);
+  ASSERT_EQ(tracer.GetNumSpans(), 30);
+  auto events = tracer.GetEvents();
+  ASSERT_EQ(events.size(), 30);
+  std::map<uint64_t, uint64_t> roots;
+
+  for (const auto& event : events) {
+    if (event.mKind == SpanKind::kRequest) {
+      ASSERT_STREQ(event.mName, "test.request");
+      ASSERT_EQ(event.mParentId, 0);
+      roots[event.mTraceId] = event.mSpanId;
+    }
+  }
+
+  ASSERT_EQ(roots.size(), 10);
+
+  for (const auto& event : events) {
+    if (event.mKind != SpanKind::kRequest) {
+      ASSERT_EQ(roots[event.mTraceId], event.mParentId);
+    }
+  }
+
+  auto hists = tracer.GetHistograms();
+  ASSERT_EQ(hists.size(), 3);
+  ASSERT_EQ(hists["test.request"]->GetCount(), 10);
+  ASSERT_EQ(hists["test.lookup"]->GetCount(), 10);
+  ASSERT_EQ(hists["lock.test.wait"]->GetCount(), 10);
+  // Exports
+  std::ostringstream chrome;
+  tracer.WriteChromeTrace(chrome, events);
+  ASSERT_NE(chrome.str().find("\"traceEvents\":["), std::string::npos);
+  ASSERT_NE(chrome.str().find("\"name\":\"test.lookup\",\"cat\":\"phase\","
+                              "\"ph\":\"X\""), std::string::npos);
+  std::ostringstream otlp;
+  tracer.WriteOtlp(otlp, events);
+  ASSERT_NE(otlp.str().find("\"resourceSpans\""), std::string::npos);
+  ASSERT_NE(otlp.str().find("\"parentSpanId\""), std::string::npos);
+  ASSERT_NE(tracer.GetStats("", true).find("span=test.lookup count=10"),
+            std::string::npos);
+  tracer.Reset();
+}
+
+//------------------------------------------------------------------------------
+// One request out of sample rate is traced and the ring buffer only keeps the
+// most recent spans
+//------------------------------------------------------------------------------
+TEST(Tracing, SampleRateAndRing)
+{
+  Tracer& tracer = Tracer::Instance();
+  tracer.Reset();
+  Tracer::SetSampleRate(10);
+  const uint64_t num_requests = 10 * Tracer::sRingCapacity;
+  std::thread worker([&]() {
+    for (uint64_t i = 0; i < num_requests; ++i) {
+      (void) DoRequest(i);
+    }
+  });
+  worker.join();
+  Tracer::SetSampleRate(0);
+  ASSERT_EQ(tracer.GetNumTraces(), num_requests / 10);
+  ASSERT_EQ(tracer.GetNumSpans(), 3 * num_requests / 10);
+  ASSERT_EQ(tracer.GetNumOverwritten(), 3 * num_requests / 10 -
+            Tracer::sRingCapacity);
+  ASSERT_EQ(tracer.GetEvents().size(), Tracer::sRingCapacity);
+  tracer.Reset();
+}
+
+//------------------------------------------------------------------------------
+// Spans can be closed out of order, those closed after the end of the request
+// are dropped
+//------------------------------------------------------------------------------
+TEST(Tracing, EarlyEnd)
+{
+  Tracer& tracer = Tracer::Instance();
+  tracer.Reset();
+  Tracer::SetSampleRate(1);
+  {
+    TraceRequest request("test.request");
+    TraceSpan first("test.first");
+    TraceSpan second("test.second");
+    first.End();
+    request.End();
+    ASSERT_FALSE(Tracer::IsTracing());
+  }
+  Tracer::SetSampleRate(0);
+  ASSERT_EQ(tracer.GetNumSpans(), 2);
+  tracer.Reset();
+}
+
+//------------------------------------------------------------------------------
+// Overhead of the spans when sampling is off compared to an untraced request
+// and when every request is sampled
+//------------------------------------------------------------------------------
+TEST(Tracing, Overhead)
+{
+  using namespace std::chrono;
+  const uint64_t num_requests = 10000000;
+  Tracer& tracer = Tracer::Instance();
+  tracer.Reset();
+  uint64_t val = 0;
+  auto start = steady_clock::now();
+
+  for (uint64_t i = 0; i < num_requests; ++i) {
+    val += DoPlainRequest(i);
+  }
+
+  const double plain_ns = duration_cast<nanoseconds>
+                          (steady_clock::now() - start).count() /
+                          (double) num_requests;
+  Tracer::SetSampleRate(0);
+  start = steady_clock::now();
+
+  for (uint64_t i = 0; i < num_requests; ++i) {
+    val += DoRequest(i);
+  }
+
+  const double off_ns = duration_cast<nanoseconds>
+                        (steady_clock::now() - start).count() /
+                        (double) num_requests;
+  Tracer::SetSampleRate(1);
+  start = steady_clock::now();
+
+  for (uint64_t i = 0; i < num_requests / 100; ++i) {
+    val += DoRequest(i);
+  }
+
+  const double on_ns = duration_cast<nanoseconds>
+                       (steady_clock::now() - start).count() /
+                       (double)(num_requests / 100);
+  Tracer::SetSampleRate(0);
+  std::cout << "plain=" << plain_ns << "ns/request off=" << off_ns
+            << "ns/request sampled=" << on_ns << "ns/request val="
+            << (val & 0xff) << std::endl;
+  // A request with three spans adds a few nanoseconds when sampling is off,
+  // i.e. well below 1% of the fastest MGM open or FST read of a few us
+  ASSERT_LT(off_ns - plain_ns, 20.0);
+  tracer.Reset();
+}
@@ -174,3 +174,32 @@ TEST(UriCapCipher, EncodeDecodeConcurrent)
 
   EXPECT_EQ(failures.load(), 0);
 }
+
+TEST(UriCapCipher, CompactRoundTrip)
+{
+  using eos::common::UriCapCipher;
+  UriCapCipher cipher(UriCapCipher::PasswordTag{},
+                      UriCapCipher::FixedSaltTag{},
+                      std::string(32, 'k'));
+  const std::string payload = "mgm.path=/eos/dir/file&mgm.fid=1a2b&cap.valid=42";
+  std::string token = cipher.encryptCompact(payload, 1234567890ull);
+  ASSERT_FALSE(token.empty());
+  // Token must be usable as an opaque value without any escaping
+  ASSERT_EQ(std::string::npos, token.find_first_of("&=+/#\n"));
+  uint64_t expiry = 0;
+  ASSERT_EQ(payload, cipher.decryptCompact(token, expiry));
+  ASSERT_EQ(1234567890ull, expiry);
+  // Tampering with the header (expiry) or the payload must be detected
+  std::string tampered = token;
+  tampered[8] = (tampered[8] == 'A' ? 'B' : 'A');
+  ASSERT_EQ("", cipher.decryptCompact(tampered, expiry));
+  tampered = token;
+  tampered[token.size() / 2] = (tampered[token.size() / 2] == 'A' ? 'B' : 'A');
+  ASSERT_EQ("", cipher.decryptCompact(tampered, expiry));
+  ASSERT_EQ("", cipher.decryptCompact(token.substr(0, 10), expiry));
+  // Different key must not be able to decrypt
+  UriCapCipher other(UriCapCipher::PasswordTag{},
+                     UriCapCipher::FixedSaltTag{},
+                     std::string(32, 'x'));
+  ASSERT_EQ("", other.decryptCompact(token, expiry));
+}
@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+// File: SpscQueueTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/concurrency/SpscQueue.hh"
+#include <memory>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+
+TEST(SpscQueue, Basic)
+{
+  eos::common::SpscQueue<std::string> queue(3);
+  ASSERT_EQ(4, queue.capacity());
+  ASSERT_TRUE(queue.empty());
+  std::string out;
+  ASSERT_FALSE(queue.try_pop(out));
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.try_push(std::to_string(i)));
+  }
+
+  std::string extra = "extra";
+  ASSERT_FALSE(queue.try_push(std::move(extra)));
+  ASSERT_EQ("extra", extra);
+  ASSERT_EQ(4, queue.size());
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.try_pop(out));
+    ASSERT_EQ(std::to_string(i), out);
+  }
+
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.try_pop(out));
+}
+
+TEST(SpscQueue, MoveOnly)
+{
+  eos::common::SpscQueue<std::unique_ptr<int>> queue(2);
+  ASSERT_TRUE(queue.try_push(std::make_unique<int>(42)));
+  std::unique_ptr<int> out;
+  ASSERT_TRUE(queue.try_pop(out));
+  ASSERT_EQ(42, *out);
+}
+
+TEST(SpscQueue, ProducerConsumer)
+{
+  constexpr uint64_t num_items = 1000000;
+  eos::common::SpscQueue<uint64_t> queue(64);
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < num_items; ++i) {
+      uint64_t val = i;
+
+      while (!queue.try_push(std::move(val))) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  uint64_t expected = 0;
+
+  while (expected < num_items) {
+    uint64_t val;
+
+    if (queue.try_pop(val)) {
+      ASSERT_EQ(expected, val);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+// File: CommitBatcherTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/CommitBatcher.hh"
+#include "common/ErrnoToString.hh"
+#include "common/SymKeys.hh"
+#include "gtest/gtest.h"
+#include <XrdOuc/XrdOucEnv.hh>
+#include <atomic>
+
+using eos::fst::utils::CommitBatcher;
+
+//------------------------------------------------------------------------------
+// Request building and response parsing
+//------------------------------------------------------------------------------
+TEST(CommitBatcher, BuildAndParse)
+{
+  std::vector<std::string> items {"mgm.path=/eos/a&mgm.fid=1&mgm.size=10",
+                                  "mgm.path=/eos/b&mgm.fid=2&mgm.size=20"};
+  const std::string request = CommitBatcher::BuildRequest(items);
+  ASSERT_EQ(0u, request.find("/?mgm.pcmd=commitbatch&mgm.commit.n=2"));
+  XrdOucEnv env(request.substr(2).c_str());
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    const std::string key = "mgm.commit." + std::to_string(i);
+    std::string decoded;
+    ASSERT_TRUE(env.Get(key.c_str()));
+    ASSERT_TRUE(eos::common::SymKey::Base64Decode(env.Get(key.c_str()),
+                decoded));
+    ASSERT_EQ(items[i], decoded);
+  }
+
+  std::vector<int> retcs;
+  ASSERT_TRUE(CommitBatcher::ParseResponse("n=3 lock_us=12 0:0 1:43 2:0", 3,
+              retcs));
+  ASSERT_EQ((std::vector<int> {0, 43, 0}), retcs);
+  ASSERT_FALSE(CommitBatcher::ParseResponse("n=2 0:0 1:0", 3, retcs));
+  ASSERT_FALSE(CommitBatcher::ParseResponse("n=2 0:0 5:0", 2, retcs));
+  ASSERT_FALSE(CommitBatcher::ParseResponse("error", 1, retcs));
+}
+
+//------------------------------------------------------------------------------
+// Concurrent commits are aggregated and get their own result
+//------------------------------------------------------------------------------
+TEST(CommitBatcher, Aggregation)
+{
+  std::atomic<int> num_sends {0};
+  auto send = [&](const std::string & manager, const std::string & request,
+  std::string & response) {
+    ++num_sends;
+    XrdOucEnv env(request.substr(2).c_str());
+    const int n = std::stoi(env.Get("mgm.commit.n"));
+    response = "n=" + std::to_string(n);
+
+    for (int i = 0; i < n; ++i) {
+      std::string item;
+      const std::string key = "mgm.commit." + std::to_string(i);
+      eos::common::SymKey::Base64Decode(env.Get(key.c_str()), item);
+      // Odd file ids fail with EIDRM
+      XrdOucEnv item_env(item.c_str());
+      const int fid = std::stoi(item_env.Get("mgm.fid"));
+      response += " " + std::to_string(i) + ":" +
+                  std::to_string((fid % 2) ? EIDRM : 0);
+    }
+
+    return 0;
+  };
+  CommitBatcher batcher(send, std::chrono::milliseconds(50), 16);
+  std::vector<std::future<int>> futs;
+
+  for (int i = 0; i < 32; ++i) {
+    futs.push_back(batcher.Submit("", "mgm.fid=" + std::to_string(i)));
+  }
+
+  for (int i = 0; i < 32; ++i) {
+    ASSERT_EQ((i % 2) ? EIDRM : 0, futs[i].get());
+  }
+
+  ASSERT_EQ(32u, batcher.GetNumCommits());
+  ASSERT_LT(num_sends.load(), 32);
+  ASSERT_GE(num_sends.load(), 2);
+}
+
+//------------------------------------------------------------------------------
+// Failed batch requests notify the callers to fall back to single commits
+//------------------------------------------------------------------------------
+TEST(CommitBatcher, NotDelivered)
+{
+  auto send = [](const std::string & manager, const std::string & request,
+  std::string & response) {
+    return ENOTSUP;
+  };
+  CommitBatcher batcher(send, std::chrono::milliseconds(1));
+  ASSERT_EQ(CommitBatcher::sNotDelivered,
+            batcher.Submit("mgm:1094", "mgm.fid=1").get());
+  ASSERT_EQ(0u, batcher.GetNumBatches());
+}
+
+//------------------------------------------------------------------------------
+// Per item errors carry the same code as for single commits so that a replica
+// of a file deleted in the meantime is unlinked by the caller
+//------------------------------------------------------------------------------
+TEST(CommitBatcher, RejectedReplica)
+{
+  // Error messages of the MGM commit per file id, mapped to the item result
+  // code the same way the MGM CommitBatch does it
+  const std::map<int, std::string> errors {
+    {1, "commit filesize change - file is already removed [EIDRM]"},
+    {2, "commit replica - file checksum is wrong [EBADR]"},
+    {3, "commit filesize change - no such file"}
+  };
+  auto send = [&](const std::string & manager, const std::string & request,
+  std::string & response) {
+    XrdOucEnv env(request.substr(2).c_str());
+    const int n = std::stoi(env.Get("mgm.commit.n"));
+    response = "n=" + std::to_string(n);
+
+    for (int i = 0; i < n; ++i) {
+      std::string item;
+      const std::string key = "mgm.commit." + std::to_string(i);
+      eos::common::SymKey::Base64Decode(env.Get(key.c_str()), item);
+      XrdOucEnv item_env(item.c_str());
+      const auto it = errors.find(std::stoi(item_env.Get("mgm.fid")));
+      const int retc = ((it == errors.end()) ? 0 :
+                        eos::common::ErrnoFromMsgTag(it->second, ECOMM));
+      response += " " + std::to_string(i) + ":" + std::to_string(retc);
+    }
+
+    return 0;
+  };
+  CommitBatcher batcher(send, std::chrono::milliseconds(10));
+  auto fut_removed = batcher.Submit("", "mgm.fid=1");
+  auto fut_xs = batcher.Submit("", "mgm.fid=2");
+  auto fut_unknown = batcher.Submit("", "mgm.fid=3");
+  auto fut_ok = batcher.Submit("", "mgm.fid=4");
+  const int retc_removed = fut_removed.get();
+  ASSERT_EQ(EIDRM, retc_removed);
+  ASSERT_TRUE(CommitBatcher::IsReplicaRejected(retc_removed));
+  ASSERT_TRUE(CommitBatcher::IsReplicaRejected(fut_xs.get()));
+  // Errors without a known tag keep the replica like for single commits
+  const int retc_unknown = fut_unknown.get();
+  ASSERT_EQ(ECOMM, retc_unknown);
+  ASSERT_FALSE(CommitBatcher::IsReplicaRejected(retc_unknown));
+  ASSERT_EQ(0, fut_ok.get());
+}
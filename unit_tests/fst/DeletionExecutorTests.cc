@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+//! @file DeletionExecutorTests.cc
+//! @brief Unit tests for the FST deletion executor
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/DeletionExecutor.hh"
+#include "gtest/gtest.h"
+#include <set>
+
+using eos::fst::utils::DeletionExecutor;
+
+namespace
+{
+std::vector<unsigned long long> MakeFids(uint64_t first, uint64_t num)
+{
+  std::vector<unsigned long long> fids;
+
+  for (uint64_t fid = first; fid < first + num; ++fid) {
+    fids.push_back(fid);
+  }
+
+  return fids;
+}
+}
+
+//------------------------------------------------------------------------------
+// All the submitted files are deleted exactly once on the right file system
+//------------------------------------------------------------------------------
+TEST(DeletionExecutor, DeleteAll)
+{
+  std::mutex mutex;
+  std::multiset<std::pair<uint32_t, uint64_t>> deleted;
+  DeletionExecutor::Options opts;
+  opts.mNumThreads = 4;
+  opts.mBatchSize = 10;
+  DeletionExecutor executor([&](uint32_t fsid, uint64_t fid) {
+    std::unique_lock<std::mutex> lock(mutex);
+    deleted.emplace(fsid, fid);
+    return (fid % 100) != 0;
+  }, nullptr, opts);
+  executor.Submit(1, MakeFids(1, 1000));
+  executor.Submit(2, MakeFids(1, 500));
+  executor.Submit(1, MakeFids(1001, 1000));
+  ASSERT_TRUE(executor.WaitIdle(std::chrono::seconds(30)));
+  ASSERT_EQ(0u, executor.GetPending());
+  ASSERT_EQ(2500u, deleted.size());
+  ASSERT_EQ(25u, executor.GetNumFailed());
+  ASSERT_EQ(2475u, executor.GetNumDeleted());
+
+  for (uint64_t fid = 1; fid <= 2000; ++fid) {
+    ASSERT_EQ(1u, deleted.count({1, fid}));
+    ASSERT_EQ((fid <= 500) ? 1u : 0u, deleted.count({2, fid}));
+  }
+
+  std::map<std::string, std::string> output;
+  executor.Publish(output);
+  ASSERT_EQ("0", output["stat.deletion.pending"]);
+  ASSERT_EQ("2475", output["stat.deletion.done"]);
+  ASSERT_EQ("25", output["stat.deletion.failed"]);
+}
+
+//------------------------------------------------------------------------------
+// No more than the configured number of batches run on one file system and
+// only one while the file system is busy
+//------------------------------------------------------------------------------
+TEST(DeletionExecutor, PerFsLimit)
+{
+  std::mutex mutex;
+  std::map<uint32_t, uint32_t> active;
+  std::map<uint32_t, uint32_t> max_active;
+  std::atomic<bool> busy {false};
+  DeletionExecutor::Options opts;
+  opts.mNumThreads = 8;
+  opts.mMaxPerFs = 2;
+  opts.mBatchSize = 1;
+  opts.mBackoff = std::chrono::milliseconds(1);
+  DeletionExecutor executor([&](uint32_t fsid, uint64_t fid) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      max_active[fsid] = std::max(max_active[fsid], ++active[fsid]);
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    std::unique_lock<std::mutex> lock(mutex);
+    --active[fsid];
+    return true;
+  }, [&](uint32_t fsid) {
+    return busy.load();
+  }, opts);
+  executor.Submit(1, MakeFids(1, 200));
+  executor.Submit(2, MakeFids(1, 200));
+  ASSERT_TRUE(executor.WaitIdle(std::chrono::seconds(30)));
+  ASSERT_EQ(2u, max_active[1]);
+  ASSERT_EQ(2u, max_active[2]);
+  ASSERT_EQ(0u, executor.GetNumYields());
+  // Once the file system reports busy it gets one batch at a time
+  busy = true;
+  executor.Submit(1, MakeFids(1, 2));
+  ASSERT_TRUE(executor.WaitIdle(std::chrono::seconds(30)));
+  ASSERT_EQ(2u, executor.GetNumYields());
+  max_active.clear();
+  executor.Submit(1, MakeFids(1, 100));
+  ASSERT_TRUE(executor.WaitIdle(std::chrono::seconds(30)));
+  ASSERT_EQ(1u, max_active[1]);
+  ASSERT_EQ(102u, executor.GetNumYields());
+}
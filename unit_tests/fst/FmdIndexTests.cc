@@ -0,0 +1,264 @@
+//------------------------------------------------------------------------------
+//! @file FmdIndexTests.cc
+//! @brief Unit tests for the per file system Fmd index
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#define IN_TEST_HARNESS
+#include "fst/filemd/FmdIndex.hh"
+#undef IN_TEST_HARNESS
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <set>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using eos::fst::FmdIndex;
+using eos::common::FmdHelper;
+
+namespace
+{
+std::string MakeTempDir()
+{
+  char tmpl[] = "/tmp/eos-fmdindex-test-XXXXXX";
+  char* dir = mkdtemp(tmpl);
+  EXPECT_NE(dir, nullptr);
+  return dir ? std::string(dir) : std::string();
+}
+
+void RemoveDir(const std::string& dir)
+{
+  FmdIndex::Remove(dir);
+  (void) rmdir(dir.c_str());
+}
+
+FmdHelper MakeFmd(uint64_t fid, uint64_t size)
+{
+  FmdHelper fmd(fid, 7);
+  fmd.mProtoFmd.set_size(size);
+  fmd.mProtoFmd.set_disksize(size);
+  fmd.mProtoFmd.set_checksum("abcdef01");
+  return fmd;
+}
+
+uint64_t LogSize(const std::string& dir)
+{
+  struct stat info;
+
+  if (stat((dir + "/" + FmdIndex::sLogName).c_str(), &info)) {
+    return 0;
+  }
+
+  return info.st_size;
+}
+}
+
+//------------------------------------------------------------------------------
+// Put, get, update and delete
+//------------------------------------------------------------------------------
+TEST(FmdIndex, PutGetDelete)
+{
+  const std::string dir = MakeTempDir();
+  {
+    FmdIndex index(dir);
+    bool rebuild = false;
+    ASSERT_TRUE(index.Open(rebuild));
+    ASSERT_TRUE(rebuild);
+    ASSERT_FALSE(index.Put(MakeFmd(0, 1)));
+
+    for (uint64_t fid = 1; fid <= 100; ++fid) {
+      ASSERT_TRUE(index.Put(MakeFmd(fid, fid * 10)));
+    }
+
+    ASSERT_EQ(100u, index.Size());
+    ASSERT_TRUE(index.Put(MakeFmd(42, 4242)));
+    ASSERT_EQ(100u, index.Size());
+    FmdHelper fmd;
+    ASSERT_TRUE(index.Get(42, fmd));
+    ASSERT_EQ(4242u, fmd.mProtoFmd.size());
+    ASSERT_EQ(7u, fmd.mProtoFmd.fsid());
+    ASSERT_TRUE(index.Delete(42));
+    ASSERT_TRUE(index.Delete(4242));
+    ASSERT_FALSE(index.Contains(42));
+    ASSERT_FALSE(index.Get(42, fmd));
+    ASSERT_EQ(99u, index.Size());
+    std::set<uint64_t> fids;
+    ASSERT_EQ(99u, index.ForEach([&](const FmdHelper & elem) {
+      ASSERT_EQ(elem.mProtoFmd.fid() * 10, elem.mProtoFmd.size());
+      fids.insert(elem.mProtoFmd.fid());
+    }));
+    ASSERT_EQ(99u, fids.size());
+    ASSERT_EQ(0u, fids.count(42));
+  }
+  RemoveDir(dir);
+}
+
+//------------------------------------------------------------------------------
+// A cleanly closed index is reused as is
+//------------------------------------------------------------------------------
+TEST(FmdIndex, ReopenClean)
+{
+  const std::string dir = MakeTempDir();
+  {
+    FmdIndex index(dir);
+    bool rebuild = false;
+    ASSERT_TRUE(index.Open(rebuild));
+
+    for (uint64_t fid = 1; fid <= 1000; ++fid) {
+      ASSERT_TRUE(index.Put(MakeFmd(fid, fid)));
+    }
+
+    ASSERT_TRUE(index.Delete(500));
+  }
+  {
+    FmdIndex index(dir);
+    bool rebuild = true;
+    ASSERT_TRUE(index.Open(rebuild));
+    ASSERT_FALSE(rebuild);
+    ASSERT_EQ(999u, index.Size());
+    FmdHelper fmd;
+    ASSERT_TRUE(index.Get(1000, fmd));
+    ASSERT_EQ(1000u, fmd.mProtoFmd.size());
+    ASSERT_FALSE(index.Contains(500));
+  }
+  RemoveDir(dir);
+}
+
+//------------------------------------------------------------------------------
+// After an unclean close on the same boot the table is rebuilt from the log
+// and a torn record at the end of the log is dropped
+//------------------------------------------------------------------------------
+TEST(FmdIndex, ReplayAfterCrash)
+{
+  const std::string dir = MakeTempDir();
+  {
+    FmdIndex index(dir);
+    bool rebuild = false;
+    ASSERT_TRUE(index.Open(rebuild));
+
+    for (uint64_t fid = 1; fid <= 1000; ++fid) {
+      ASSERT_TRUE(index.Put(MakeFmd(fid, fid)));
+    }
+
+    ASSERT_TRUE(index.Delete(10));
+    ASSERT_TRUE(index.Put(MakeFmd(20, 2000)));
+    // Simulate a crash by not closing the index
+    index.UnmapTable();
+    (void) close(index.mLogFd);
+    index.mLogFd = -1;
+  }
+  // Append a torn record
+  int fd = open((dir + "/" + FmdIndex::sLogName).c_str(), O_WRONLY | O_APPEND);
+  ASSERT_GE(fd, 0);
+  const uint64_t good_size = LogSize(dir);
+  ASSERT_EQ(10, write(fd, "FMDRgarbag", 10));
+  (void) close(fd);
+  {
+    FmdIndex index(dir);
+    bool rebuild = true;
+    ASSERT_TRUE(index.Open(rebuild));
+    ASSERT_FALSE(rebuild);
+    ASSERT_EQ(999u, index.Size());
+    ASSERT_EQ(good_size, LogSize(dir));
+    FmdHelper fmd;
+    ASSERT_FALSE(index.Contains(10));
+    ASSERT_TRUE(index.Get(20, fmd));
+    ASSERT_EQ(2000u, fmd.mProtoFmd.size());
+  }
+  RemoveDir(dir);
+}
+
+//------------------------------------------------------------------------------
+// The table grows past its initial capacity
+//------------------------------------------------------------------------------
+TEST(FmdIndex, Grow)
+{
+  const std::string dir = MakeTempDir();
+  const uint64_t num = 200000;
+  {
+    FmdIndex index(dir);
+    bool rebuild = false;
+    ASSERT_TRUE(index.Open(rebuild));
+
+    for (uint64_t fid = 1; fid <= num; ++fid) {
+      ASSERT_TRUE(index.Put(MakeFmd(fid, fid)));
+    }
+
+    ASSERT_EQ(num, index.Size());
+  }
+  {
+    FmdIndex index(dir);
+    bool rebuild = true;
+    ASSERT_TRUE(index.Open(rebuild));
+    ASSERT_FALSE(rebuild);
+    ASSERT_EQ(num, index.Size());
+
+    for (uint64_t fid = 1; fid <= num; fid += 997) {
+      FmdHelper fmd;
+      ASSERT_TRUE(index.Get(fid, fmd));
+      ASSERT_EQ(fid, fmd.mProtoFmd.size());
+    }
+  }
+  RemoveDir(dir);
+}
+
+//------------------------------------------------------------------------------
+// The log is compacted while the index is open once it is mostly made of
+// stale records
+//------------------------------------------------------------------------------
+TEST(FmdIndex, OnlineCompaction)
+{
+  const std::string dir = MakeTempDir();
+  {
+    FmdIndex index(dir);
+    index.mCompactMinLogSize = 64 * 1024;
+    bool rebuild = false;
+    ASSERT_TRUE(index.Open(rebuild));
+    uint64_t max_log_size = 0;
+
+    for (uint64_t i = 0; i < 10000; ++i) {
+      ASSERT_TRUE(index.Put(MakeFmd(1 + i % 10, i)));
+
+      if (i % 100 == 99) {
+        ASSERT_TRUE(index.Delete(1 + i % 10));
+      }
+
+      max_log_size = std::max(max_log_size, LogSize(dir));
+    }
+
+    ASSERT_LE(max_log_size, index.mCompactMinLogSize + 1024);
+    ASSERT_EQ(9u, index.Size());
+    ASSERT_FALSE(index.Contains(10));
+    FmdHelper fmd;
+    ASSERT_TRUE(index.Get(9, fmd));
+    ASSERT_EQ(9998u, fmd.mProtoFmd.size());
+    ASSERT_EQ(9u, index.ForEach([](const FmdHelper&) {}));
+  }
+  {
+    FmdIndex index(dir);
+    bool rebuild = true;
+    ASSERT_TRUE(index.Open(rebuild));
+    ASSERT_FALSE(rebuild);
+    ASSERT_EQ(9u, index.Size());
+  }
+  RemoveDir(dir);
+}
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+//! @file PipelineStageTests.cc
+//! @brief Unit tests for the bounded pipeline stage
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/PipelineStage.hh"
+#include "gtest/gtest.h"
+#include <set>
+
+using eos::fst::utils::PipelineStage;
+
+//------------------------------------------------------------------------------
+// All the pushed items are processed exactly once by the workers
+//------------------------------------------------------------------------------
+TEST(PipelineStage, ProcessAll)
+{
+  std::mutex mutex;
+  std::multiset<uint64_t> seen;
+  std::atomic<uint32_t> num_init {0};
+  PipelineStage<uint64_t> stage(4, 16, [&](uint64_t& item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    seen.insert(item);
+  }, [&]() {
+    ++num_init;
+  });
+
+  for (uint64_t i = 0; i < 10000; ++i) {
+    uint64_t item = i;
+    stage.Push(std::move(item));
+  }
+
+  stage.Finish();
+  ASSERT_EQ(4u, num_init.load());
+  ASSERT_EQ(10000u, stage.GetProcessed());
+  ASSERT_EQ(10000u, seen.size());
+
+  for (uint64_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ(1u, seen.count(i));
+  }
+}
+
+//------------------------------------------------------------------------------
+// The number of queued items never exceeds the capacity
+//------------------------------------------------------------------------------
+TEST(PipelineStage, Bounded)
+{
+  std::atomic<int64_t> pushed {0};
+  std::atomic<int64_t> max_pending {0};
+  {
+    PipelineStage<int> stage(1, 8, [&](int&) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    });
+
+    for (int i = 0; i < 500; ++i) {
+      stage.Push(std::move(i));
+      ++pushed;
+      // Pending items are the ones queued plus the one being processed
+      int64_t pending = pushed - (int64_t) stage.GetProcessed();
+
+      if (pending > max_pending) {
+        max_pending = pending;
+      }
+    }
+  }
+  ASSERT_LE(max_pending.load(), 8 + 1);
+}
@@ -28,6 +28,7 @@
 #undef IN_TEST_HARNESS
 #include "fst/Load.hh"
 #include "fst/utils/ScanRate.hh"
+#include "fst/utils/ScanReader.hh"
 #include "common/Constants.hh"
 #include "unit_tests/fst/TmpDirTree.hh"
 //------------------------------------------------------------------------------
@@ -172,6 +173,173 @@ TEST(ScanDir, EnforceScanRateInvalidRate)
   ASSERT_LT(duration_cast<seconds>(steady_clock::now() - start_ts).count(), 5);
 }
 
+//------------------------------------------------------------------------------
+// Once the disk load drops the rate must recover step by step and not jump
+// straight back to the maximum
+//------------------------------------------------------------------------------
+TEST(ScanDir, AdjustScanRateRecovery)
+{
+  using ::testing::_;
+  using ::testing::Return;
+  MockLoad load;
+  EXPECT_CALL(load, GetDiskRate(_, _)).WillOnce(Return(800.0))
+  .WillOnce(Return(600.0)).WillRepeatedly(Return(100.0));
+  eos::fst::utils::ScanRateLimiter rate_limiter(100, &load, "/var/", 100);
+  rate_limiter.Throttle(0);
+  ASSERT_EQ(rate_limiter.GetRate(), 90);
+  // Load between the thresholds keeps the current rate
+  rate_limiter.Throttle(0);
+  ASSERT_EQ(rate_limiter.GetRate(), 90);
+  rate_limiter.Throttle(0);
+  ASSERT_EQ(rate_limiter.GetRate(), 100);
+  rate_limiter.Throttle(0);
+  ASSERT_EQ(rate_limiter.GetRate(), 100);
+}
+
+//------------------------------------------------------------------------------
+// The double-buffered reader must hand out the data in order whether or not
+// the read-ahead thread kicks in and must propagate read errors
+//------------------------------------------------------------------------------
+TEST(ScanDir, ScanReaderReadAhead)
+{
+  const uint32_t buff_sz = 16;
+  char buff1[buff_sz], buff2[buff_sz];
+  std::string content;
+
+  for (int i = 0; i < 1000; ++i) {
+    content += (char)('a' + i % 26);
+  }
+
+  // Read callback over the first sz bytes of the content
+  auto get_read_func = [&content](size_t sz) {
+    return [&content, sz](off_t offset, char* buff, uint32_t len) {
+      if ((size_t)offset >= sz) {
+        return (int64_t)0;
+      }
+
+      int64_t nread = std::min<int64_t>(len, sz - offset);
+      memcpy(buff, content.data() + offset, nread);
+      return nread;
+    };
+  };
+  char* chunk = nullptr;
+  off_t offset = 0;
+  int64_t nread = 0;
+
+  for (size_t sz : {0ul, 10ul, 16ul, 17ul, 1000ul}) {
+    eos::fst::utils::ScanReader reader(buff1, buff2, buff_sz);
+    reader.SetReadFunc(get_read_func(sz));
+    std::string out;
+
+    while ((nread = reader.Next(chunk, offset)) > 0) {
+      ASSERT_EQ((size_t)offset, out.size());
+      out.append(chunk, nread);
+    }
+
+    ASSERT_EQ(nread, 0);
+    ASSERT_EQ((size_t)offset, sz);
+    ASSERT_EQ(out, content.substr(0, sz));
+  }
+
+  // Read error in the middle of the file
+  auto read_func = get_read_func(content.size());
+  eos::fst::utils::ScanReader reader(buff1, buff2, buff_sz);
+  reader.SetReadFunc([&read_func](off_t offset, char* buff, uint32_t len) {
+    return (offset >= 64) ? (int64_t) - 1 : read_func(offset, buff, len);
+  });
+
+  while ((nread = reader.Next(chunk, offset)) > 0) {}
+
+  ASSERT_EQ(nread, -1);
+  ASSERT_EQ(offset, 64);
+  // Stopping early must not block on the read-ahead thread
+  eos::fst::utils::ScanReader early(buff1, buff2, buff_sz);
+  early.SetReadFunc(read_func);
+  ASSERT_EQ(early.Next(chunk, offset), buff_sz);
+}
+
+//------------------------------------------------------------------------------
+// Local files are read through their own descriptor, falling back to buffered
+// reads when O_DIRECT is not supported
+//------------------------------------------------------------------------------
+TEST(ScanDir, ScanReaderLocalFile)
+{
+  char tmp_name[] = "/tmp/fst_scan_reader.XXXXXX";
+  int fd = mkstemp(tmp_name);
+  ASSERT_NE(fd, -1);
+  std::string content(3 * 4096 + 100, 'x');
+
+  for (size_t i = 0; i < content.size(); ++i) {
+    content[i] = (char)(i % 251);
+  }
+
+  ASSERT_EQ(write(fd, content.data(), content.size()), (ssize_t)content.size());
+  (void) close(fd);
+  const uint32_t buff_sz = 4096;
+  char* buff1 = nullptr;
+  char* buff2 = nullptr;
+  ASSERT_EQ(posix_memalign((void**) &buff1, 4096, buff_sz), 0);
+  ASSERT_EQ(posix_memalign((void**) &buff2, 4096, buff_sz), 0);
+  {
+    eos::fst::utils::ScanReader reader(buff1, buff2, buff_sz);
+    ASSERT_FALSE(reader.OpenUncached("/tmp/fst_scan_reader_missing", true));
+  }
+
+  for (bool try_direct : {false, true}) {
+    eos::fst::utils::ScanReader reader(buff1, buff2, buff_sz);
+    ASSERT_TRUE(reader.OpenUncached(tmp_name, try_direct));
+
+    if (!try_direct) {
+      ASSERT_FALSE(reader.IsDirect());
+    }
+
+    std::string out;
+    char* chunk = nullptr;
+    off_t offset = 0;
+    int64_t nread = 0;
+
+    while ((nread = reader.Next(chunk, offset)) > 0) {
+      out.append(chunk, nread);
+    }
+
+    ASSERT_EQ(nread, 0);
+
+    ASSERT_EQ(out, content);
+  }
+
+  free(buff1);
+  free(buff2);
+  (void) unlink(tmp_name);
+}
+
+//------------------------------------------------------------------------------
+// Scan throughput and pass ETA reporting
+//------------------------------------------------------------------------------
+TEST(ScanDir, ScanPassStats)
+{
+  using namespace std::chrono;
+  eos::fst::ScanDir sd("/", 1, nullptr, false, 0, 50, true);
+  auto& clock = sd.GetClock();
+  double rate_mbs = 0.0;
+  uint64_t eta_sec = 0ull;
+  sd.GetScanStats(1000000000ull, rate_mbs, eta_sec);
+  ASSERT_EQ(rate_mbs, 0.0);
+  ASSERT_EQ(eta_sec, 0ull);
+  sd.ScanPassStarted();
+  // Walked 100 MB out of 1 GB in 10 seconds, out of which 50 MB were read
+  sd.ScanPassAccount(100000000ull, 0ull);
+  sd.ScanPassAccount(0ull, 50000000ull);
+  clock.advance(seconds(10));
+  sd.GetScanStats(1000000000ull, rate_mbs, eta_sec);
+  ASSERT_DOUBLE_EQ(rate_mbs, 5.0);
+  ASSERT_EQ(eta_sec, 90ull);
+  sd.ScanPassDone();
+  // The rate of the last pass is kept, there is no ETA between passes
+  sd.GetScanStats(1000000000ull, rate_mbs, eta_sec);
+  ASSERT_DOUBLE_EQ(rate_mbs, 5.0);
+  ASSERT_EQ(eta_sec, 0ull);
+}
+
 TEST_F(TmpDirTree, ScanDirSetConfig)
 {
   MockLoad load;
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "fusex/md/shardmap.hh"
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(fusex_shardmap, basic)
+{
+  shardmap<uint64_t, std::shared_ptr<int>> map;
+  std::shared_ptr<int> val;
+  EXPECT_FALSE(map.get(1, val));
+  map.set(1, std::make_shared<int>(42));
+  ASSERT_TRUE(map.get(1, val));
+  EXPECT_EQ(42, *val);
+  map.set(1, std::make_shared<int>(43));
+  ASSERT_TRUE(map.get(1, val));
+  EXPECT_EQ(43, *val);
+  EXPECT_EQ(1u, map.size());
+  EXPECT_TRUE(map.erase(1));
+  EXPECT_FALSE(map.erase(1));
+  EXPECT_FALSE(map.get(1, val));
+  EXPECT_EQ(0u, map.size());
+
+  for (uint64_t i = 0; i < 1000; ++i) {
+    map.set(i, nullptr);
+  }
+
+  EXPECT_EQ(1000u, map.size());
+  map.clear();
+  EXPECT_EQ(0u, map.size());
+}
+
+TEST(fusex_shardmap, spread)
+{
+  // sequential inode numbers have to be spread over all shards
+  using map_t = shardmap<uint64_t, int>;
+  std::set<size_t> used;
+
+  for (uint64_t ino = 0x10000000; ino < 0x10000000 + 4 * map_t::kShards; ++ino) {
+    ASSERT_LT(map_t::shard_index(ino), map_t::kShards);
+    used.insert(map_t::shard_index(ino));
+  }
+
+  EXPECT_EQ(map_t::kShards, used.size());
+}
+
+TEST(fusex_shardmap, concurrent)
+{
+  shardmap<uint64_t, uint64_t> map;
+  const uint64_t n = 10000;
+  std::atomic<uint64_t> mismatch {0};
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&, t]() {
+      for (uint64_t i = t; i < n; i += 4) {
+        map.set(i, i * 2);
+      }
+    });
+    workers.emplace_back([&]() {
+      for (uint64_t i = 0; i < n; ++i) {
+        uint64_t v;
+
+        if (map.get(i, v) && (v != i * 2)) {
+          ++mismatch;
+        }
+      }
+    });
+  }
+
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  EXPECT_EQ(0u, mismatch.load());
+  EXPECT_EQ(n, map.size());
+}
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+// File: AclTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "mgm/acl/Acl.hh"
+#include "mgm/acl/AclProgram.hh"
+
+using eos::mgm::Acl;
+using eos::mgm::AclProgram;
+
+namespace
+{
+eos::common::VirtualIdentity
+MakeIdentity(uid_t uid, gid_t gid, std::set<gid_t> gids = {})
+{
+  eos::common::VirtualIdentity vid;
+  vid.uid = uid;
+  vid.gid = gid;
+  vid.allowed_gids = gids;
+  vid.allowed_gids.insert(gid);
+  return vid;
+}
+}
+
+//------------------------------------------------------------------------------
+// Rules are compiled to numeric subjects and parsed permission flags
+//------------------------------------------------------------------------------
+TEST(AclProgram, Compile)
+{
+  AclProgram program("u:1234:rwo,g:5678:!d+u,z:x,k:key:r,u:1234,egroup:eg",
+                     "u:root:q", true);
+  ASSERT_EQ(program.mRules.size(), 5);
+  ASSERT_EQ(program.mRules[0].mSubject, AclProgram::Subject::kUid);
+  ASSERT_EQ(program.mRules[0].mId, 1234);
+  ASSERT_EQ(program.mRules[0].mNumFlags, 2);
+  ASSERT_TRUE(program.mFlags[1].mWriteOnce);
+  ASSERT_EQ(program.mRules[1].mSubject, AclProgram::Subject::kGid);
+  ASSERT_TRUE(program.mFlags[program.mRules[1].mFirstFlag].mDeny);
+  ASSERT_TRUE(program.mFlags[program.mRules[1].mFirstFlag + 1].mReallow);
+  ASSERT_EQ(program.mRules[2].mSubject, AclProgram::Subject::kAny);
+  ASSERT_EQ(program.mRules[3].mSubject, AclProgram::Subject::kKey);
+  ASSERT_EQ(program.mRules[3].mName, "key");
+  // User acl rule with the name resolved to the uid
+  ASSERT_EQ(program.mRules[4].mSubject, AclProgram::Subject::kUid);
+  ASSERT_EQ(program.mRules[4].mId, 0);
+  ASSERT_FALSE(program.mRules[4].mIsSysAcl);
+  ASSERT_TRUE(program.mEgroups.empty());
+}
+
+//------------------------------------------------------------------------------
+// Evaluation of the compiled rules for different identities
+//------------------------------------------------------------------------------
+TEST(AclProgram, Evaluate)
+{
+  Acl acl;
+  acl.Set("u:1234:rwx!d,g:5678:rx,z:!u", "u:1234:+dq", "",
+          MakeIdentity(1234, 1000), true);
+  ASSERT_TRUE(acl.HasAcl());
+  ASSERT_TRUE(acl.CanRead());
+  ASSERT_TRUE(acl.CanWrite());
+  ASSERT_FALSE(acl.CanUpdate());
+  ASSERT_TRUE(acl.CanNotDelete());
+  // '+d' and 'q' are ignored in the user acl
+  ASSERT_FALSE(acl.CanSetQuota());
+  acl.Set("u:1234:rwx!d,g:5678:rx,z:!u", "u:1234:+dq", "",
+          MakeIdentity(4321, 1000), true);
+  ASSERT_FALSE(acl.CanRead());
+  ASSERT_TRUE(acl.CanNotUpdate());
+  // Secondary groups are matched only if enabled
+  const auto vid = MakeIdentity(4321, 1000, {5678});
+  eos::common::Mapping::gSecondaryGroups = false;
+  acl.Set("g:5678:rx", "", "", vid, false);
+  ASSERT_FALSE(acl.CanRead());
+  eos::common::Mapping::gSecondaryGroups = true;
+  acl.Set("g:5678:rx", "", "", vid, false);
+  ASSERT_TRUE(acl.CanRead());
+  ASSERT_TRUE(acl.CanBrowse());
+  eos::common::Mapping::gSecondaryGroups = false;
+  // Write-once does not grant write
+  acl.Set("z:wo", "", "", vid, false);
+  ASSERT_TRUE(acl.CanWriteOnce());
+  ASSERT_FALSE(acl.CanWrite());
+  // Reallow in the sys.acl beats a previous denial
+  acl.Set("z:rw!d,u:4321:+d", "", "", vid, false);
+  ASSERT_FALSE(acl.CanNotDelete());
+  ASSERT_TRUE(acl.CanDelete());
+  // Name based rule
+  acl.Set("u:root:rx", "", "", MakeIdentity(0, 1000), false);
+  ASSERT_TRUE(acl.CanRead());
+}
+
+//------------------------------------------------------------------------------
+// Numeric subjects match by id and by the name of users/groups having a
+// numeric name
+//------------------------------------------------------------------------------
+TEST(AclProgram, NumericName)
+{
+  eos::common::Mapping::cacheUserIds(51001, "424242");
+  eos::common::Mapping::cacheGroupIds(61001, "535353");
+  AclProgram::ClearCache();
+  AclProgram program("u:424242:rx,g:535353:w,u:1234:r", "", false);
+  ASSERT_EQ(program.mRules.size(), 3);
+  ASSERT_EQ(program.mRules[0].mSubject, AclProgram::Subject::kUidOrUserName);
+  ASSERT_EQ(program.mRules[0].mId, 424242);
+  ASSERT_EQ(program.mRules[0].mName, "424242");
+  ASSERT_EQ(program.mRules[1].mSubject, AclProgram::Subject::kGidOrGroupName);
+  ASSERT_EQ(program.mRules[2].mSubject, AclProgram::Subject::kUid);
+  ASSERT_TRUE(program.mHasUserNames);
+  ASSERT_TRUE(program.mHasGroupNames);
+  Acl acl;
+  // Matched by uid
+  acl.Set("u:424242:rx", "", "", MakeIdentity(424242, 1000), false);
+  ASSERT_TRUE(acl.CanRead());
+  // Matched by the user name of uid 51001
+  acl.Set("u:424242:rx", "", "", MakeIdentity(51001, 1000), false);
+  ASSERT_TRUE(acl.CanRead());
+  acl.Set("u:424242:rx", "", "", MakeIdentity(51002, 1000), false);
+  ASSERT_FALSE(acl.CanRead());
+  // Matched by gid and by the group name of gid 61001
+  acl.Set("g:535353:rx", "", "", MakeIdentity(51002, 535353), false);
+  ASSERT_TRUE(acl.CanRead());
+  acl.Set("g:535353:rx", "", "", MakeIdentity(51002, 61001), false);
+  ASSERT_TRUE(acl.CanRead());
+  AclProgram::ClearCache();
+}
+
+//------------------------------------------------------------------------------
+// Programs are cached by the ACL strings
+//------------------------------------------------------------------------------
+TEST(AclProgram, Cache)
+{
+  AclProgram::ClearCache();
+  auto first = AclProgram::Get("u:1234:rx", "u:1:rw", false);
+  ASSERT_EQ(first, AclProgram::Get("u:1234:rx", "u:2:rw", false));
+  ASSERT_EQ(first, AclProgram::Get("u:1234:rx", "", true));
+  ASSERT_NE(first, AclProgram::Get("u:1234:rx", "u:1:rw", true));
+  ASSERT_NE(first, AclProgram::Get("u:1234:rwx", "", false));
+  ASSERT_EQ(AclProgram::GetCacheSize(), 3);
+  AclProgram::ClearCache();
+  ASSERT_EQ(AclProgram::GetCacheSize(), 0);
+}
+
+//------------------------------------------------------------------------------
+// Access checks for ACLs of 1 to 500 rules, compiled every time and cached.
+// Run with --gtest_also_run_disabled_tests, the number of checks can be
+// changed with EOS_ACL_BENCH_CHECKS.
+//------------------------------------------------------------------------------
+TEST(AclProgram, DISABLED_Benchmark)
+{
+  const size_t checks = getenv("EOS_ACL_BENCH_CHECKS") ?
+                        std::stoull(getenv("EOS_ACL_BENCH_CHECKS")) : 1000;
+  const auto vid = MakeIdentity(100000, 200000, {200001, 200002});
+  eos::common::Mapping::gSecondaryGroups = true;
+
+  for (size_t num_rules : {
+         1, 10, 50, 100, 500
+       }) {
+    // The matching rule is the last one
+    std::string sysacl;
+
+    for (size_t i = 1; i < num_rules; ++i) {
+      sysacl += ((i % 2) ? "u:" : "g:") + std::to_string(i) + ":rwx!d,";
+    }
+
+    sysacl += "g:200002:rx";
+
+    for (size_t i = 0; i < checks / num_rules + 1; ++i) {
+      AclProgram program(sysacl, "", false);
+      ASSERT_EQ(program.mRules.size(), num_rules);
+    }
+
+    Acl acl;
+
+    for (size_t i = 0; i < checks; ++i) {
+      acl.Set(sysacl, "", "", vid, false);
+    }
+
+    ASSERT_TRUE(acl.CanRead());
+    ASSERT_FALSE(acl.CanWrite());
+  }
+
+  eos::common::Mapping::gSecondaryGroups = false;
+  AclProgram::ClearCache();
+}
@@ -0,0 +1,358 @@
+//------------------------------------------------------------------------------
+// File: CachePrefetchPolicyTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "mgm/cache/CachePrefetchPolicy.hh"
+#include <algorithm>
+#include <list>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+
+using eos::mgm::CachePrefetchPolicy;
+
+namespace
+{
+//------------------------------------------------------------------------------
+//! Byte-capacity LRU standing in for the cache space
+//------------------------------------------------------------------------------
+class SimCache
+{
+public:
+  explicit SimCache(uint64_t capacity): mCapacity(capacity) {}
+
+  bool Contains(const std::string& path) const
+  {
+    return mMap.count(path);
+  }
+
+  //! Access a file, returns true on hit. Misses are admitted (read-through).
+  bool Access(const std::string& path, uint64_t size)
+  {
+    auto it = mMap.find(path);
+
+    if (it != mMap.end()) {
+      mLru.splice(mLru.begin(), mLru, it->second);
+      return true;
+    }
+
+    Insert(path, size);
+    return false;
+  }
+
+  void Insert(const std::string& path, uint64_t size)
+  {
+    if (mMap.count(path)) {
+      return;
+    }
+
+    mLru.emplace_front(path, size);
+    mMap[path] = mLru.begin();
+    mUsed += size;
+
+    while (mUsed > mCapacity) {
+      mUsed -= mLru.back().second;
+      mMap.erase(mLru.back().first);
+      mLru.pop_back();
+    }
+  }
+
+private:
+  uint64_t mCapacity;
+  uint64_t mUsed {0};
+  std::list<std::pair<std::string, uint64_t>> mLru;
+  std::unordered_map<std::string,
+      std::list<std::pair<std::string, uint64_t>>::iterator> mMap;
+};
+
+struct SimResult {
+  uint64_t mReads {0};
+  uint64_t mMisses {0};
+  uint64_t mWarmedFiles {0};
+  uint64_t mWarmedBytes {0};
+  uint64_t mWarmedHits {0}; ///< First reads served by a warmed file
+  uint64_t mMaxTickBytes {0};
+};
+
+//------------------------------------------------------------------------------
+//! Replay an access log with lines "<timestamp> <path> <size>" against a
+//! simulated cache space, prefetching every tick when a policy is given
+//------------------------------------------------------------------------------
+SimResult
+Replay(std::istream& log, CachePrefetchPolicy* policy, uint64_t capacity,
+       time_t tick, uint64_t budget)
+{
+  SimResult res;
+  SimCache cache(capacity);
+  // Namespace as seen by the replay: directory -> files and file sizes
+  std::map<std::string, std::set<std::string>> dirs;
+  std::map<std::string, uint64_t> sizes;
+  std::set<std::string> warmed_unread;
+  std::vector<std::tuple<time_t, std::string, uint64_t>> records;
+  std::string line;
+
+  while (std::getline(log, line)) {
+    std::istringstream iss(line);
+    time_t ts;
+    std::string path;
+    uint64_t size;
+
+    if (line.empty() || (line[0] == '#') || !(iss >> ts >> path >> size)) {
+      continue;
+    }
+
+    records.emplace_back(ts, path, size);
+    dirs[path.substr(0, path.rfind('/') + 1)].insert(path);
+    sizes[path] = size;
+  }
+
+  if (records.empty()) {
+    return res;
+  }
+
+  time_t next_tick = std::get<0>(records.front()) + tick;
+  auto expand = [&](const CachePrefetchPolicy::Candidate & dir) {
+    const auto& files = dirs[dir.mPath];
+    return std::vector<std::string>(files.begin(), files.end());
+  };
+  auto size_of = [&](const CachePrefetchPolicy::Candidate & file) -> int64_t {
+    return cache.Contains(file.mPath) ? -1 : (int64_t) sizes[file.mPath];
+  };
+
+  for (const auto& rec : records) {
+    const time_t ts = std::get<0>(rec);
+
+    while (policy && (ts >= next_tick)) {
+      uint64_t planned = 0;
+
+      for (const auto& file : policy->Plan(next_tick, 1000, budget, expand,
+                                           size_of, planned)) {
+        cache.Insert(file.mPath, sizes[file.mPath]);
+        warmed_unread.insert(file.mPath);
+        ++res.mWarmedFiles;
+        res.mWarmedBytes += sizes[file.mPath];
+      }
+
+      res.mMaxTickBytes = std::max(res.mMaxTickBytes, planned);
+      next_tick += tick;
+    }
+
+    const std::string& path = std::get<1>(rec);
+    ++res.mReads;
+
+    if (!cache.Access(path, std::get<2>(rec))) {
+      ++res.mMisses;
+    } else if (warmed_unread.erase(path)) {
+      ++res.mWarmedHits;
+    }
+
+    if (policy) {
+      policy->RecordAccess(path, ts);
+    }
+  }
+
+  return res;
+}
+
+//------------------------------------------------------------------------------
+//! Access log of job waves over datasets plus single user reads, in the
+//! format written by the iostat report replay tooling
+//------------------------------------------------------------------------------
+std::string
+RecordedWaveLog()
+{
+  std::vector<std::tuple<time_t, std::string, uint64_t>> records;
+  const uint64_t file_size = 50 * 1024 * 1024;
+  const time_t start = 1700000000;
+
+  for (int run = 0; run < 5; ++run) {
+    const time_t wave = start + run * 7200;
+
+    // 10 jobs started every 2 minutes, each reading the 40 files of the
+    // dataset sequentially, one every 20 seconds
+    for (int job = 0; job < 10; ++job) {
+      for (int file = 0; file < 40; ++file) {
+        records.emplace_back(wave + job * 120 + file * 20,
+                             "/eos/exp/run" + std::to_string(run) + "/f" +
+                             std::to_string(file) + ".root", file_size);
+      }
+    }
+
+    // Unrelated single reads in user areas
+    for (int user = 0; user < 20; ++user) {
+      records.emplace_back(wave + user * 97, "/eos/user/u" +
+                           std::to_string(run * 20 + user) + "/notes.txt", 4096);
+    }
+  }
+
+  std::sort(records.begin(), records.end());
+  std::ostringstream oss;
+  oss << "# timestamp path size" << std::endl;
+
+  for (const auto& rec : records) {
+    oss << std::get<0>(rec) << " " << std::get<1>(rec) << " "
+        << std::get<2>(rec) << std::endl;
+  }
+
+  return oss.str();
+}
+}
+
+//------------------------------------------------------------------------------
+// A directory becomes a candidate once several of its files are read within
+// a short period, a directory read steadily over a day does not
+//------------------------------------------------------------------------------
+TEST(CachePrefetchPolicy, TrendingDirectory)
+{
+  CachePrefetchPolicy policy;
+  const time_t now = 1700000000;
+
+  // Steady reads, one every 10 minutes during a day
+  for (time_t ts = now - 86400; ts < now; ts += 600) {
+    policy.RecordAccess("/eos/steady/f" + std::to_string(ts % 7), ts);
+  }
+
+  policy.RecordAccess("/eos/new/f1", now - 50);
+  policy.RecordAccess("/eos/new/f2", now - 30);
+  auto candidates = policy.GetCandidates(now, 10);
+  ASSERT_TRUE(candidates.empty());
+  policy.RecordAccess("/eos/new/f3", now - 10);
+  candidates = policy.GetCandidates(now, 10);
+  ASSERT_EQ(1u, candidates.size());
+  ASSERT_EQ("/eos/new/", candidates[0].mPath);
+  ASSERT_TRUE(candidates[0].mDirectory);
+  ASSERT_FALSE(candidates[0].mPolicy);
+  // A single file read repeatedly is a file candidate as well
+  policy.RecordAccess("/eos/other/hot", now);
+  policy.RecordAccess("/eos/other/hot", now);
+  policy.RecordAccess("/eos/other/hot", now);
+  candidates = policy.GetCandidates(now, 10);
+  std::set<std::string> paths;
+
+  for (const auto& candidate : candidates) {
+    paths.insert(candidate.mPath);
+  }
+
+  ASSERT_EQ((std::set<std::string> {"/eos/new/", "/eos/other/",
+                                    "/eos/other/hot"
+                                   }), paths);
+  // Popularity fades away
+  ASSERT_TRUE(policy.GetCandidates(now + 3600, 10).empty());
+}
+
+//------------------------------------------------------------------------------
+// Policy directories are candidates without any read
+//------------------------------------------------------------------------------
+TEST(CachePrefetchPolicy, PolicyDirectory)
+{
+  CachePrefetchPolicy::Options opts;
+  opts.mPaths = {"/eos/hot", "/eos/calib/"};
+  CachePrefetchPolicy policy(opts);
+  ASSERT_TRUE(policy.MatchesPathPolicy("/eos/hot/file"));
+  ASSERT_TRUE(policy.MatchesPathPolicy("/eos/calib/sub/file"));
+  ASSERT_FALSE(policy.MatchesPathPolicy("/eos/hotter/file"));
+  auto candidates = policy.GetCandidates(1700000000, 10);
+  ASSERT_EQ(2u, candidates.size());
+
+  for (const auto& candidate : candidates) {
+    ASSERT_TRUE(candidate.mPolicy);
+    ASSERT_TRUE(candidate.mDirectory);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Plan respects the budget and the cooldown of the selected entries
+//------------------------------------------------------------------------------
+TEST(CachePrefetchPolicy, PlanBudget)
+{
+  CachePrefetchPolicy::Options opts;
+  opts.mPaths = {"/eos/hot/"};
+  CachePrefetchPolicy policy(opts);
+  const time_t now = 1700000000;
+  auto expand = [](const CachePrefetchPolicy::Candidate & dir) {
+    std::vector<std::string> files;
+
+    for (int i = 0; i < 10; ++i) {
+      files.push_back(dir.mPath + "f" + std::to_string(i));
+    }
+
+    return files;
+  };
+  auto size_of = [](const CachePrefetchPolicy::Candidate & file) -> int64_t {
+    // f9 is already cached
+    return (file.mPath.back() == '9') ? -1 : 100;
+  };
+  uint64_t planned = 0;
+  auto selected = policy.Plan(now, 10, 450, expand, size_of, planned);
+  ASSERT_EQ(4u, selected.size());
+  ASSERT_EQ(400u, planned);
+  // The directory was not completed so it is revisited, skipping the files
+  // selected in the previous round
+  selected = policy.Plan(now + 60, 10, 10000, expand, size_of, planned);
+  ASSERT_EQ(5u, selected.size());
+  ASSERT_EQ(500u, planned);
+  ASSERT_EQ("/eos/hot/f4", selected[0].mPath);
+  // Directory completed, nothing else until the cooldown expires
+  selected = policy.Plan(now + 120, 10, 10000, expand, size_of, planned);
+  ASSERT_TRUE(selected.empty());
+  ASSERT_EQ(0u, planned);
+  selected = policy.Plan(now + 60 + opts.mCooldown.count(), 10, 10000, expand,
+                         size_of, planned);
+  ASSERT_EQ(9u, selected.size());
+}
+
+//------------------------------------------------------------------------------
+// Replay a recorded access log: prefetching trending datasets must remove
+// most of the first-reader misses without warming unrelated files or
+// exceeding the bandwidth budget
+//------------------------------------------------------------------------------
+TEST(CachePrefetchPolicy, SimulationReplay)
+{
+  const uint64_t capacity = 100ull * 1024 * 1024 * 1024;
+  const time_t tick = 60;
+  // 20 MB/s prefetch bandwidth
+  const uint64_t budget = 20ull * 1024 * 1024 * tick;
+  const std::string log = RecordedWaveLog();
+  std::istringstream log_no_prefetch(log);
+  const SimResult base = Replay(log_no_prefetch, nullptr, capacity, tick,
+                                budget);
+  std::istringstream log_prefetch(log);
+  CachePrefetchPolicy policy;
+  const SimResult res = Replay(log_prefetch, &policy, capacity, tick, budget);
+  ASSERT_EQ(base.mReads, res.mReads);
+  // Every file is cold on its first read without prefetching
+  ASSERT_EQ(5u * 40 + 5 * 20, base.mMisses);
+  ASSERT_EQ(0u, base.mWarmedFiles);
+  // With prefetching only the first reads of each dataset, until it starts
+  // trending, and the unrelated user files miss
+  ASSERT_LE(res.mMisses, 5u * 10 + 5 * 20);
+  ASSERT_GT(res.mWarmedHits, 0u);
+  ASSERT_EQ(res.mWarmedFiles, res.mWarmedHits);
+  ASSERT_EQ(base.mMisses, res.mMisses + res.mWarmedHits);
+  ASSERT_LE(res.mMaxTickBytes, budget);
+  std::cout << "reads=" << res.mReads << " misses=" << base.mMisses << "->"
+            << res.mMisses << " warmed_files=" << res.mWarmedFiles
+            << " warmed_bytes=" << res.mWarmedBytes
+            << " warmed_hits=" << res.mWarmedHits << std::endl;
+}
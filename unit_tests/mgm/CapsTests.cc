@@ -200,9 +200,9 @@ TEST_F(CapsTest, StoreUpdateClientID) {
   EXPECT_EQ((*k)()->id(),123);
   EXPECT_EQ((*k)()->clientid(), "cid1");
   // Test the 3 different views
-  auto& client_caps = mCaps.ClientCaps();
-  auto& ino_caps = mCaps.ClientInoCaps();
-  const auto& mcaps = mCaps.GetCaps();
+  auto client_caps = mCaps.ClientCaps();
+  auto ino_caps = mCaps.ClientInoCaps();
+  auto mcaps = mCaps.GetCaps();
 
   EXPECT_EQ(client_caps["cid1"].count("authid1"), 1);
   EXPECT_EQ(ino_caps["cid1"][123].count("authid1"),1);
@@ -215,12 +215,15 @@ TEST_F(CapsTest, StoreUpdateClientID) {
   // If only the clientid is updated without changing the id the other views do
   //not get deleted
   mCaps.Store(c1,&vid1);
-  EXPECT_EQ(mCaps.ncaps(), 2); // new vtime -> more mTimeOrderedCap entry.
+  EXPECT_EQ(mCaps.ncaps(), 2); // new vtime -> one more expiry timer
 
   auto k2 = mCaps.Get(authid);
   EXPECT_EQ((*k2)()->id(),123);
   EXPECT_EQ((*k2)()->clientid(), "clientid_1");
 
+  client_caps = mCaps.ClientCaps();
+  ino_caps = mCaps.ClientInoCaps();
+  mcaps = mCaps.GetCaps();
   EXPECT_EQ(client_caps["cid1"].count("authid1"), 1);
   EXPECT_EQ(ino_caps["cid1"][123].count("authid1"),1);
   // now check the updated values
@@ -242,9 +245,9 @@ TEST_F(CapsTest, StoreUpdateID) {
   EXPECT_EQ((*k)()->id(),123);
   EXPECT_EQ((*k)()->clientid(), "cid1");
   // Test the 3 different views
-  auto& client_caps = mCaps.ClientCaps();
-  auto& ino_caps = mCaps.ClientInoCaps();
-  const auto& mcaps = mCaps.GetCaps();
+  auto client_caps = mCaps.ClientCaps();
+  auto ino_caps = mCaps.ClientInoCaps();
+  auto mcaps = mCaps.GetCaps();
 
   EXPECT_EQ(client_caps["cid1"].count("authid1"), 1);
   EXPECT_EQ(ino_caps["cid1"][123].count("authid1"),1);
@@ -254,7 +257,8 @@ TEST_F(CapsTest, StoreUpdateID) {
   // now update this cap
   c1.set_clientid("clientid_1");
   c1.set_id(1234);
-  // client_caps & ino_caps will now drop the old client entries, however TimeOrderedCaps will not drop the cap
+  // client_caps & ino_caps will now drop the old client entries, however the
+  // expiry timer of the old cap is only dropped once due
   mCaps.Store(c1,&vid1);
   EXPECT_EQ(mCaps.ncaps(), 2);
 
@@ -262,6 +266,10 @@ TEST_F(CapsTest, StoreUpdateID) {
   EXPECT_EQ((*k2)()->id(),1234);
   EXPECT_EQ((*k2)()->clientid(), "clientid_1");
 
+  client_caps = mCaps.ClientCaps();
+  ino_caps = mCaps.ClientInoCaps();
+  mcaps = mCaps.GetCaps();
+
   EXPECT_EQ(client_caps["cid1"].size(), 0);
   EXPECT_EQ(ino_caps["cid1"][123].size(),0);
   // now check the updated values
@@ -272,27 +280,36 @@ TEST_F(CapsTest, StoreUpdateID) {
 
 }
 
-TEST_F(CapsTest, PopCaps) {
+TEST_F(CapsTest, TimerWheel) {
   auto vid1 = make_vid(1,1);
-  auto vid2 = make_vid(2,2);
-
-  mCaps.Store(make_cap(1,"client1","auth1"), &vid1);
-  mCaps.Store(make_cap(2,"client2","auth2"), &vid2);
+  const uint64_t now = static_cast<uint64_t>(time(nullptr));
 
-  EXPECT_EQ(mCaps.ncaps(), 2);
-  mCaps.pop();
-  EXPECT_EQ(mCaps.ncaps(), 1);
+  // one cap per turn of the wheel, all of them in the same slot
+  for (uint64_t i = 0; i < 3; ++i) {
+    mCaps.Store(make_cap(i + 1, "client" + std::to_string(i),
+                         "auth" + std::to_string(i),
+                         now + i * Caps::kWheelSlots), &vid1);
+  }
 
-  // pop only pops from time ordered caps, the other cap should still be present
+  EXPECT_EQ(mCaps.ncaps(), 3);
+  EXPECT_EQ(mCaps.ExpireCaps(now + Caps::kExpiryGrace - 1), 0);
+  EXPECT_EQ(mCaps.ExpireCaps(now + Caps::kExpiryGrace), 1);
+  EXPECT_FALSE(mCaps.HasCap("auth0"));
   EXPECT_TRUE(mCaps.HasCap("auth1"));
-  EXPECT_TRUE(mCaps.HasCap("auth2"));
+  EXPECT_EQ(mCaps.ncaps(), 2);
 
+  // print by time order
   std::string filter;
   std::string option{"t"};
-
   std::string out = mCaps.Print(option, filter);
-  EXPECT_TRUE(out.find("client2") != std::string::npos);
-  EXPECT_TRUE(out.find("client1") == std::string::npos);
+  EXPECT_TRUE(out.find("client0") == std::string::npos);
+  EXPECT_LT(out.find("client1"), out.find("client2"));
+
+  // after a pause longer than a turn of the wheel
+  EXPECT_EQ(mCaps.ExpireCaps(now + 2 * Caps::kWheelSlots + Caps::kExpiryGrace),
+            2);
+  EXPECT_EQ(mCaps.ncaps(), 0);
+  EXPECT_EQ(mCaps.Size(), 0);
 }
 
 TEST_F(CapsTest, ExpireCaps)
@@ -308,7 +325,7 @@ TEST_F(CapsTest, ExpireCaps)
   EXPECT_EQ(mCaps.GetCaps().size(), 2);
 
   // Now expire the caps
-  EXPECT_TRUE(mCaps.expire());
+  EXPECT_EQ(mCaps.ExpireCaps(), 1);
   EXPECT_EQ(mCaps.GetCaps().size(), 1);
   EXPECT_TRUE(mCaps.HasCap("auth2"));
   EXPECT_FALSE(mCaps.HasCap("auth1"));
@@ -348,19 +365,15 @@ TEST_F(CapsTest, Remove)
   mCaps.Store(make_cap(1,"client1","auth1"), &vid1);
   mCaps.Store(make_cap(2,"client2","auth2"), &vid2);
 
-  const auto& client_caps = mCaps.ClientCaps();
-  const auto& ino_caps = mCaps.ClientInoCaps();
-  const auto& mcaps = mCaps.GetCaps();
-
-  EXPECT_EQ(client_caps.size(), 2);
-  EXPECT_EQ(ino_caps.size(), 2);
-  EXPECT_EQ(mcaps.size(), 2);
+  EXPECT_EQ(mCaps.ClientCaps().size(), 2);
+  EXPECT_EQ(mCaps.ClientInoCaps().size(), 2);
+  EXPECT_EQ(mCaps.GetCaps().size(), 2);
 
   EXPECT_TRUE(mCaps.Remove(mCaps.Get("auth1")));
   EXPECT_FALSE(mCaps.Remove(mCaps.Get("foo")));
-  EXPECT_EQ(client_caps.size(), 1);
-  EXPECT_EQ(ino_caps.size(), 1);
-  EXPECT_EQ(mcaps.size(), 1);
+  EXPECT_EQ(mCaps.ClientCaps().size(), 1);
+  EXPECT_EQ(mCaps.ClientInoCaps().size(), 1);
+  EXPECT_EQ(mCaps.GetCaps().size(), 1);
 
 }
 
@@ -374,21 +387,17 @@ TEST_F(CapsTest, Delete)
   mCaps.Store(make_cap(2,"client2","auth2"), &vid2);
   mCaps.Store(make_cap(1,"client3","auth3"), &vid3);
 
-  const auto& client_caps = mCaps.ClientCaps();
-  const auto& ino_caps = mCaps.ClientInoCaps();
-  const auto& mcaps = mCaps.GetCaps();
-
-  EXPECT_EQ(client_caps.size(), 3);
-  EXPECT_EQ(ino_caps.size(), 3);
-  EXPECT_EQ(mcaps.size(), 3);
+  EXPECT_EQ(mCaps.ClientCaps().size(), 3);
+  EXPECT_EQ(mCaps.ClientInoCaps().size(), 3);
+  EXPECT_EQ(mCaps.GetCaps().size(), 3);
 
   EXPECT_EQ(mCaps.Delete(1), 0);
   EXPECT_EQ(mCaps.Delete(123), ENONET);
 
   EXPECT_TRUE(mCaps.HasCap("auth2"));
-  EXPECT_EQ(client_caps.size(), 1);
-  EXPECT_EQ(ino_caps.size(), 1);
-  EXPECT_EQ(mcaps.size(), 1);
+  EXPECT_EQ(mCaps.ClientCaps().size(), 1);
+  EXPECT_EQ(mCaps.ClientInoCaps().size(), 1);
+  EXPECT_EQ(mCaps.GetCaps().size(), 1);
 
 }
 
@@ -476,13 +485,7 @@ TEST_F(CapsTest, MonitorCapsSimple)
   EXPECT_EQ(mCaps.GetCaps().size(), 2);
 
   // Now expire the caps
-  while (true) {
-    if (mCaps.expire()) {
-      mCaps.pop();
-    } else {
-      break;
-    }
-  }
+  mCaps.ExpireCaps();
 
   EXPECT_EQ(mCaps.GetCaps().size(), 0);
   EXPECT_EQ(mCaps.ncaps(), 0);
@@ -507,13 +510,7 @@ TEST_F(CapsTest, MonitorCapsUpdate)
   EXPECT_EQ(mCaps.GetCaps().size(), 3);
 
   // Now expire the caps
-  while (true) {
-    if (mCaps.expire()) {
-      mCaps.pop();
-    } else {
-      break;
-    }
-  }
+  mCaps.ExpireCaps();
 
   EXPECT_EQ(mCaps.GetCaps().size(), 1);
   EXPECT_EQ(mCaps.ncaps(), 1);
@@ -522,31 +519,19 @@ TEST_F(CapsTest, MonitorCapsUpdate)
   ucap.set_vtime(static_cast<uint64_t>(time(nullptr)) - 7);
   mCaps.Store(ucap, &vid3);
   EXPECT_EQ(mCaps.GetCaps().size(), 1);
-  EXPECT_EQ(mCaps.ncaps(), 2);   // should this be 2 as we've a new time?
+  EXPECT_EQ(mCaps.ncaps(), 2);   // one expiry timer per stored version
 
   std::this_thread::sleep_for(2s);
 
   // Now expire the caps
-  while (true) {
-    if (mCaps.expire()) {
-      mCaps.pop();
-    } else {
-      break;
-    }
-  }
+  mCaps.ExpireCaps();
 
   EXPECT_EQ(mCaps.GetCaps().size(),1);
   EXPECT_EQ(mCaps.ncaps(), 1);
 
   std::this_thread::sleep_for(1s);
   // Now expire the caps
-  while (true) {
-    if (mCaps.expire()) {
-      mCaps.pop();
-    } else {
-      break;
-    }
-  }
+  mCaps.ExpireCaps();
 
 
   EXPECT_EQ(mCaps.GetCaps().size(), 0) ;
@@ -581,7 +566,7 @@ TEST_F(CapsTest, GetAllCaps)
 
   // Update authid1 -> authid4
   mCaps.Store(make_cap(4,"client4","auth1"), &vid4);
-  EXPECT_EQ(mCaps.ncaps(),4); // TimeCaps will still have entry corresponding to unexpiredtimes
+  EXPECT_EQ(mCaps.ncaps(),4); // expiry timers are only dropped once due
   EXPECT_EQ(mCaps.GetCaps().size(),3);
 
   {
@@ -661,3 +646,63 @@ TEST_F(CapsTest, ImplyCapsMulti)
   deleter.join();
   implier.join();
 }
+
+//------------------------------------------------------------------------------
+// Cap churn from many clients: every client renews caps on a shared set of
+// directories, looks up the audience of broadcasts and finally drops all its
+// caps while the expiry runs in the background. Run with
+// --gtest_also_run_disabled_tests, the number of operations per client can be
+// changed with EOS_CAPS_BENCH_OPS.
+//------------------------------------------------------------------------------
+TEST_F(CapsTest, DISABLED_CapsChurn)
+{
+  const size_t ops = getenv("EOS_CAPS_BENCH_OPS") ?
+                     std::stoull(getenv("EOS_CAPS_BENCH_OPS")) : 1000;
+  const uint64_t n_inodes = 1000;
+
+  for (size_t nthreads : {
+         1, 4, 16
+       }) {
+    Caps caps;
+    std::atomic<bool> done {false};
+    std::thread expirer([&]() {
+      while (!done) {
+        caps.ExpireCaps();
+        std::this_thread::sleep_for(1ms);
+      }
+    });
+    std::vector<std::thread> clients;
+
+    for (size_t t = 0; t < nthreads; ++t) {
+      clients.emplace_back([&, t]() {
+        auto vid = make_vid(t, t);
+        const std::string uuid = "uuid" + std::to_string(t);
+        const std::string client_id = "client" + std::to_string(t);
+        const uint64_t vtime = static_cast<uint64_t>(time(nullptr)) + 300;
+
+        for (size_t i = 0; i < ops; ++i) {
+          const uint64_t ino = 1 + (i * 7919 + t * 104729) % n_inodes;
+
+          if (i % 4) {
+            caps.Store(make_cap(ino, client_id, client_id + ":" + std::to_string(ino),
+                                uuid, vtime), &vid);
+          } else {
+            (void) caps.GetBroadcastCapsTS(ino);
+          }
+        }
+
+        caps.dropCaps(uuid);
+      });
+    }
+
+    for (auto& client : clients) {
+      client.join();
+    }
+
+    done = true;
+    expirer.join();
+    EXPECT_EQ(caps.Size(), 0);
+    EXPECT_TRUE(caps.ClientCaps().empty());
+    EXPECT_TRUE(caps.GetBroadcastCapsTS(1).empty());
+  }
+}
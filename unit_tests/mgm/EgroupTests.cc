@@ -23,10 +23,28 @@
 
 #include "gtest/gtest.h"
 #include "mgm/egroup/Egroup.hh"
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
 
 using namespace eos::mgm;
 using namespace eos::common;
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Wait until the asynchronous refreshes are done
+//------------------------------------------------------------------------------
+void
+WaitForRefreshes(Egroup& egroup)
+{
+  while (egroup.getPendingQueueSize() != 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+}
+
 //------------------------------------------------------------------------------
 // Test basic Egroup functionality
 //------------------------------------------------------------------------------
@@ -79,7 +97,7 @@ TEST(Egroup, BasicSanity)
   ASSERT_EQ(egroup.DumpMember("user3", "awesome-users"),
             "egroup=awesome-users user=user3 member=true lifetime=-1");
 
-  while (egroup.getPendingQueueSize() != 0) {}
+  WaitForRefreshes(egroup);
 
   ASSERT_EQ(egroup.DumpMember("user3", "awesome-users"),
             "egroup=awesome-users user=user3 member=true lifetime=1800");
@@ -93,17 +111,18 @@ TEST(Egroup, BasicSanity)
   ASSERT_EQ(egroup.DumpMember("user3", "awesome-users"),
             "egroup=awesome-users user=user3 member=true lifetime=-8300");
 
-  while (egroup.getPendingQueueSize() != 0) { }
+  WaitForRefreshes(egroup);
 
   ASSERT_EQ(egroup.DumpMember("user3", "awesome-users"),
             "egroup=awesome-users user=user3 member=false lifetime=1800");
+  // All the egroups of user3 were refreshed by the same lookup
   ASSERT_EQ(egroup.DumpMembers(),
             "egroup=awesome-users user=user1 member=true lifetime=-10101\n"
             "egroup=awesome-users user=user2 member=false lifetime=-10101\n"
             "egroup=awesome-users user=user3 member=false lifetime=1800\n"
             "egroup=groovy-users user=user1 member=false lifetime=-10101\n"
             "egroup=groovy-users user=user2 member=true lifetime=-10101\n"
-            "egroup=groovy-users user=user3 member=true lifetime=-10101\n");
+            "egroup=groovy-users user=user3 member=true lifetime=1800\n");
 }
 
 TEST(Egroup, ExplicitRefresh)
@@ -125,3 +144,186 @@ TEST(Egroup, ExplicitRefresh)
             "egroup=awesome-users user=user1 member=true lifetime=1800");
 }
 
+
+TEST(Egroup, BulkFetch)
+{
+  SteadyClock clock(true);
+  Egroup egroup(&clock);
+
+  for (int i = 0; i < 20; ++i) {
+    egroup.inject("user1", "group-" + std::to_string(i), Egroup::Status::kMember);
+  }
+
+  // All the memberships of a user are fetched with a single lookup, the
+  // egroups not returned are cached as negative entries
+  for (int i = 0; i < 30; ++i) {
+    ASSERT_EQ(egroup.Member("user1", "group-" + std::to_string(i)), i < 20);
+  }
+
+  ASSERT_EQ(egroup.getLdapQueryCount(), 1u);
+  ASSERT_FALSE(egroup.Member("user2", "group-1"));
+  ASSERT_FALSE(egroup.Member("user2", "group-2"));
+  ASSERT_EQ(egroup.getLdapQueryCount(), 2u);
+  ASSERT_EQ(egroup.DumpMember("user2", "group-3"),
+            "egroup=group-3 user=user2 member=false lifetime=1800");
+  // Explicit refresh updates all the cached pairs of the user
+  egroup.inject("user2", "group-1", Egroup::Status::kMember);
+  egroup.inject("user2", "group-2", Egroup::Status::kMember);
+  clock.advance(std::chrono::seconds(10));
+  egroup.refresh("user2", "group-1");
+  ASSERT_EQ(egroup.DumpMember("user2", "group-2"),
+            "egroup=group-2 user=user2 member=true lifetime=1800");
+  ASSERT_EQ(egroup.getLdapQueryCount(), 3u);
+}
+
+TEST(Egroup, NegativeCaching)
+{
+  SteadyClock clock(true);
+  Egroup egroup(&clock);
+  egroup.inject("user1", "awesome-users", Egroup::Status::kError);
+  // Failed lookups are cached for a short time only
+  ASSERT_EQ(egroup.DumpMember("user1", "awesome-users"),
+            "egroup=awesome-users user=user1 member=false lifetime=60");
+  ASSERT_EQ(egroup.DumpMember("user1", "groovy-users"),
+            "egroup=groovy-users user=user1 member=false lifetime=60");
+  ASSERT_EQ(egroup.getLdapQueryCount(), 1u);
+  // A failing explicit refresh leaves the cache untouched
+  ASSERT_EQ(egroup.refresh("user1", "awesome-users").isMember, false);
+  ASSERT_EQ(egroup.DumpMember("user1", "awesome-users"),
+            "egroup=awesome-users user=user1 member=false lifetime=60");
+  egroup.inject("user1", "awesome-users", Egroup::Status::kMember);
+  clock.advance(std::chrono::seconds(61));
+  ASSERT_EQ(egroup.DumpMember("user1", "awesome-users"),
+            "egroup=awesome-users user=user1 member=false lifetime=-1");
+
+  WaitForRefreshes(egroup);
+
+  ASSERT_EQ(egroup.DumpMember("user1", "awesome-users"),
+            "egroup=awesome-users user=user1 member=true lifetime=1800");
+  ASSERT_EQ(egroup.DumpMember("user1", "groovy-users"),
+            "egroup=groovy-users user=user1 member=false lifetime=1800");
+  // Once known, the memberships are kept when the LDAP server fails
+  egroup.inject("user1", "groovy-users", Egroup::Status::kError);
+  clock.advance(std::chrono::seconds(1801));
+  ASSERT_EQ(egroup.DumpMember("user1", "awesome-users"),
+            "egroup=awesome-users user=user1 member=true lifetime=-1");
+
+  WaitForRefreshes(egroup);
+
+  ASSERT_EQ(egroup.DumpMember("user1", "awesome-users"),
+            "egroup=awesome-users user=user1 member=true lifetime=-1");
+}
+
+TEST(Egroup, ConcurrentColdMisses)
+{
+  Egroup egroup;
+  egroup.inject("user1", "awesome-users", Egroup::Status::kMember);
+  egroup.injectLatency(std::chrono::milliseconds(100));
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&egroup, i]() {
+      ASSERT_EQ(egroup.Member("user1", (i % 2) ? "awesome-users" : "groovy-users"),
+                (i % 2) == 1);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // All the threads waited for the same lookup
+  ASSERT_EQ(egroup.getLdapQueryCount(), 1u);
+}
+
+TEST(Egroup, Snapshot)
+{
+  const std::string path = "/tmp/eos-egroup-snapshot." +
+                           std::to_string(getpid());
+  {
+    Egroup egroup;
+    egroup.inject("user1", "awesome-users", Egroup::Status::kMember);
+    egroup.inject("user2", "groovy-users", Egroup::Status::kMember);
+    ASSERT_EQ(egroup.SetSnapshotPath(path), 0u);
+    ASSERT_TRUE(egroup.Member("user1", "awesome-users"));
+    ASSERT_TRUE(egroup.Member("user2", "groovy-users"));
+    // The snapshot is saved on destruction
+  }
+  {
+    Egroup egroup;
+    egroup.inject("user1", "awesome-users", Egroup::Status::kNotMember);
+    ASSERT_EQ(egroup.SetSnapshotPath(path), 2u);
+    // Served from the snapshot without any lookup
+    ASSERT_TRUE(egroup.Member("user1", "awesome-users"));
+    ASSERT_FALSE(egroup.Member("user1", "groovy-users"));
+    ASSERT_TRUE(egroup.Member("user2", "groovy-users"));
+    ASSERT_EQ(egroup.getLdapQueryCount(), 0u);
+    ASSERT_TRUE(egroup.SaveSnapshot());
+  }
+  ASSERT_EQ(unlink(path.c_str()), 0);
+}
+
+TEST(Egroup, CaseInsensitiveNames)
+{
+  SteadyClock clock(true);
+  Egroup egroup(&clock);
+  egroup.inject("user1", "Awesome-Users", Egroup::Status::kMember);
+  ASSERT_TRUE(egroup.Member("user1", "awesome-users"));
+  ASSERT_TRUE(egroup.Member("user1", "AWESOME-USERS"));
+  ASSERT_TRUE(egroup.Member("user1", "Awesome-Users"));
+  ASSERT_FALSE(egroup.Member("user1", "awesome-user"));
+  // All the spellings are served by the same lookup
+  ASSERT_EQ(egroup.getLdapQueryCount(), 1u);
+  // Also after the cached memberships of the user are refreshed
+  clock.advance(std::chrono::seconds(1801));
+  ASSERT_TRUE(egroup.Member("user1", "AWESOME-USERS"));
+  WaitForRefreshes(egroup);
+  ASSERT_EQ(egroup.DumpMember("user1", "awesome-users"),
+            "egroup=awesome-users user=user1 member=true lifetime=1800");
+  ASSERT_EQ(egroup.DumpMember("user1", "AWESOME-USERS"),
+            "egroup=AWESOME-USERS user=user1 member=true lifetime=1800");
+}
+
+//------------------------------------------------------------------------------
+// Latency of the egroup checks of an ACL listing several egroups on a cold
+// cache, with a simulated LDAP round-trip of 1ms. The number of users is
+// given by EOS_EGROUP_BENCH_USERS, 100 by default.
+//------------------------------------------------------------------------------
+TEST(Egroup, DISABLED_ColdCacheAclBenchmark)
+{
+  using namespace std::chrono;
+  size_t num_users = 100;
+  const size_t num_egroups = 20;
+
+  if (getenv("EOS_EGROUP_BENCH_USERS")) {
+    num_users = std::strtoull(getenv("EOS_EGROUP_BENCH_USERS"), nullptr, 10);
+  }
+
+  Egroup egroup;
+  egroup.injectLatency(milliseconds(1));
+
+  for (size_t i = 0; i < num_users; ++i) {
+    egroup.inject("user" + std::to_string(i),
+                  "group-" + std::to_string(i % num_egroups),
+                  Egroup::Status::kMember);
+  }
+
+  auto start = steady_clock::now();
+
+  for (size_t i = 0; i < num_users; ++i) {
+    // An ACL with a rule per egroup, the first matching one wins
+    for (size_t j = 0; j < num_egroups; ++j) {
+      if (egroup.Member("user" + std::to_string(i),
+                        "group-" + std::to_string(j))) {
+        break;
+      }
+    }
+  }
+
+  const double acl_us = duration_cast<microseconds>
+                        (steady_clock::now() - start).count() / (double) num_users;
+  ASSERT_EQ(egroup.getLdapQueryCount(), num_users);
+  std::cout << "users=" << num_users << " egroups=" << num_egroups
+            << " cold-cache acl-check=" << acl_us << "us ldap-queries="
+            << egroup.getLdapQueryCount() << std::endl;
+}
@@ -0,0 +1,446 @@
+//------------------------------------------------------------------------------
+// File: NsScanBusTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "mgm/nsscan/NsScanBus.hh"
+#include <set>
+#include <thread>
+#include <tuple>
+
+using namespace eos::mgm;
+
+namespace
+{
+//! Scan order of the entries, parent container id, name and id
+using ScanKey = std::tuple<uint64_t, std::string, uint64_t>;
+
+//------------------------------------------------------------------------------
+//! In-memory namespace shared by a source and its clones
+//------------------------------------------------------------------------------
+struct FakeNamespace {
+  std::mutex mMutex;
+  std::map<ScanKey, eos::ns::FileMdProto> mFiles;
+  std::map<ScanKey, eos::ns::ContainerMdProto> mContainers;
+  std::map<std::string, std::string> mCheckpoint;
+
+  void AddFile(uint64_t parent, const std::string& name, uint64_t id)
+  {
+    eos::ns::FileMdProto proto;
+    proto.set_id(id);
+    proto.set_cont_id(parent);
+    proto.set_name(name);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFiles[ScanKey(parent, name, id)] = proto;
+  }
+
+  void AddContainer(uint64_t parent, const std::string& name, uint64_t id)
+  {
+    eos::ns::ContainerMdProto proto;
+    proto.set_id(id);
+    proto.set_parent_id(parent);
+    proto.set_name(name);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mContainers[ScanKey(parent, name, id)] = proto;
+  }
+};
+
+//------------------------------------------------------------------------------
+//! Scan source over the in-memory namespace
+//------------------------------------------------------------------------------
+class FakeSource: public NsScanSource
+{
+public:
+  FakeSource(std::shared_ptr<FakeNamespace> ns): mNs(ns) {}
+
+  bool ScanFiles(const FileCallback& cb, std::string& err) override
+  {
+    std::map<ScanKey, eos::ns::FileMdProto> files;
+    {
+      std::unique_lock<std::mutex> lock(mNs->mMutex);
+      files = mNs->mFiles;
+    }
+
+    for (auto& elem : files) {
+      if (!cb(std::move(elem.second))) {
+        break;
+      }
+    }
+
+    return true;
+  }
+
+  bool ScanContainers(const ContainerCallback& cb, std::string& err) override
+  {
+    std::map<ScanKey, eos::ns::ContainerMdProto> conts;
+    {
+      std::unique_lock<std::mutex> lock(mNs->mMutex);
+      conts = mNs->mContainers;
+    }
+
+    for (auto& elem : conts) {
+      if (!cb(std::move(elem.second))) {
+        break;
+      }
+    }
+
+    return true;
+  }
+
+  std::map<std::string, std::string> LoadCheckpoint() override
+  {
+    std::unique_lock<std::mutex> lock(mNs->mMutex);
+    return mNs->mCheckpoint;
+  }
+
+  void StoreCheckpoint(const std::map<std::string, std::string>& fields)
+  override
+  {
+    std::unique_lock<std::mutex> lock(mNs->mMutex);
+
+    for (const auto& elem : fields) {
+      mNs->mCheckpoint[elem.first] = elem.second;
+    }
+  }
+
+  std::unique_ptr<NsScanSource> Clone() const override
+  {
+    return std::make_unique<FakeSource>(mNs);
+  }
+
+private:
+  std::shared_ptr<FakeNamespace> mNs;
+};
+
+//------------------------------------------------------------------------------
+//! Consumer recording the entries it gets
+//------------------------------------------------------------------------------
+class RecordingConsumer: public NsScanConsumer
+{
+public:
+  RecordingConsumer(const std::string& name, uint64_t budget = 0):
+    mName(name), mBudget(budget)
+  {}
+
+  std::string GetScanConsumerName() const override
+  {
+    return mName;
+  }
+
+  bool WantsFiles() const override
+  {
+    return true;
+  }
+
+  bool WantsContainers() const override
+  {
+    return true;
+  }
+
+  bool FilterFile(const eos::ns::FileMdProto& proto) const override
+  {
+    return !mEvenOnly || ((proto.id() % 2) == 0);
+  }
+
+  uint64_t GetRateBudget() override
+  {
+    return mBudget;
+  }
+
+  void CycleStart(uint64_t cycle, bool resumed) override
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCycle = cycle;
+    mResumed = resumed;
+  }
+
+  void ProcessFile(eos::ns::FileMdProto&& proto) override
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFiles.push_back(proto.id());
+
+    if (mOnFile) {
+      mOnFile(mFiles.size(), lock);
+    }
+  }
+
+  void ProcessContainer(eos::ns::ContainerMdProto&& proto) override
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mContainers.push_back(proto.id());
+  }
+
+  void CycleEnd(uint64_t cycle, bool complete) override
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mComplete = complete;
+    mDone = true;
+    mDoneTs = std::chrono::steady_clock::now();
+    mCond.notify_all();
+  }
+
+  bool WaitDone(std::chrono::seconds timeout)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mCond.wait_for(lock, timeout, [this]() {
+      return mDone;
+    });
+  }
+
+  bool IsDone()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mDone;
+  }
+
+  void Reset()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFiles.clear();
+    mContainers.clear();
+    mDone = mComplete = mResumed = false;
+  }
+
+  std::string mName;
+  uint64_t mBudget;
+  bool mEvenOnly {false};
+  std::mutex mMutex;
+  std::condition_variable mCond;
+  //! Hook called with the mutex locked after every file
+  std::function<void(size_t, std::unique_lock<std::mutex>&)> mOnFile;
+  std::vector<uint64_t> mFiles;
+  std::vector<uint64_t> mContainers;
+  uint64_t mCycle {0};
+  bool mResumed {false};
+  bool mComplete {false};
+  bool mDone {false};
+  std::chrono::steady_clock::time_point mDoneTs;
+};
+
+//------------------------------------------------------------------------------
+// Run one cycle of the bus in an assisted thread
+//------------------------------------------------------------------------------
+bool
+RunCycle(NsScanBus& bus)
+{
+  bool complete = false;
+  AssistedThread thread;
+  thread.reset([&](ThreadAssistant & assistant) {
+    complete = bus.RunCycle(assistant);
+  });
+  thread.blockUntilThreadJoins();
+  return complete;
+}
+
+//------------------------------------------------------------------------------
+// Build a namespace with the given number of files and containers
+//------------------------------------------------------------------------------
+std::shared_ptr<FakeNamespace>
+MakeNamespace(uint64_t num_files, uint64_t num_conts)
+{
+  auto ns = std::make_shared<FakeNamespace>();
+
+  for (uint64_t id = 1; id <= num_files; ++id) {
+    ns->AddFile(100 + id / 10, "file" + std::to_string(id), id);
+  }
+
+  for (uint64_t id = 1; id <= num_conts; ++id) {
+    ns->AddContainer(1, "dir" + std::to_string(id), 100 + id);
+  }
+
+  return ns;
+}
+
+//------------------------------------------------------------------------------
+// Get the file ids of the namespace in scan order
+//------------------------------------------------------------------------------
+std::vector<uint64_t>
+FileIds(FakeNamespace& ns, const ScanKey& from = ScanKey())
+{
+  std::vector<uint64_t> ids;
+
+  for (auto it = ns.mFiles.lower_bound(from); it != ns.mFiles.end(); ++it) {
+    ids.push_back(it->second.id());
+  }
+
+  return ids;
+}
+}
+
+//------------------------------------------------------------------------------
+// Every consumer gets all the entries it is interested in, once and in order
+//------------------------------------------------------------------------------
+TEST(NsScanBus, FanOut)
+{
+  auto ns = MakeNamespace(2000, 50);
+  NsScanBus bus(std::make_unique<FakeSource>(ns), []() {
+    return true;
+  });
+  bus.SetEnabled(true);
+  RecordingConsumer all("all"), even("even");
+  even.mEvenOnly = true;
+  bus.Register(&all);
+  bus.Register(&even);
+  ASSERT_TRUE(RunCycle(bus));
+  ASSERT_TRUE(all.WaitDone(std::chrono::seconds(10)));
+  ASSERT_TRUE(even.WaitDone(std::chrono::seconds(10)));
+  const std::vector<uint64_t> expected = FileIds(*ns);
+  std::vector<uint64_t> expected_even;
+
+  for (auto id : expected) {
+    if (id % 2 == 0) {
+      expected_even.push_back(id);
+    }
+  }
+
+  ASSERT_EQ(expected, all.mFiles);
+  ASSERT_EQ(expected_even, even.mFiles);
+  ASSERT_EQ(50u, all.mContainers.size());
+  ASSERT_EQ(50u, even.mContainers.size());
+  ASSERT_TRUE(all.mComplete);
+  ASSERT_TRUE(even.mComplete);
+  ASSERT_FALSE(all.mResumed);
+  ASSERT_EQ("2", ns->mCheckpoint["phase"]);
+  bus.Unregister(&all);
+  bus.Unregister(&even);
+}
+
+//------------------------------------------------------------------------------
+// A consumer with a small rate budget is paced and falls behind without
+// delaying the others, it finishes the cycle with its own scan
+//------------------------------------------------------------------------------
+TEST(NsScanBus, SlowConsumerDoesNotDelayOthers)
+{
+  using namespace std::chrono;
+  auto ns = MakeNamespace(300, 0);
+  NsScanBus bus(std::make_unique<FakeSource>(ns), []() {
+    return true;
+  }, 50);
+  bus.SetEnabled(true);
+  RecordingConsumer fast("fast"), slow("slow", 200);
+  bus.Register(&fast);
+  bus.Register(&slow);
+  const auto start = steady_clock::now();
+  ASSERT_TRUE(RunCycle(bus));
+  ASSERT_TRUE(fast.WaitDone(seconds(10)));
+  ASSERT_FALSE(slow.IsDone());
+  ASSERT_NE(std::string::npos,
+            bus.GetStats(true).find("consumer.slow.catch_up=true"));
+  ASSERT_TRUE(slow.WaitDone(seconds(30)));
+  // 300 entries at 200 Hz take at least 1.5 seconds
+  ASSERT_GE(duration_cast<milliseconds>(slow.mDoneTs - start).count(), 1400);
+  ASSERT_LT(fast.mDoneTs, slow.mDoneTs);
+  ASSERT_EQ(FileIds(*ns), fast.mFiles);
+  ASSERT_EQ(FileIds(*ns), slow.mFiles);
+  ASSERT_TRUE(slow.mComplete);
+  const std::string stats = bus.GetStats(true);
+  ASSERT_NE(std::string::npos, stats.find("consumer.slow.catch_up.cycles=1"));
+  bus.Unregister(&fast);
+  bus.Unregister(&slow);
+}
+
+//------------------------------------------------------------------------------
+// An interrupted cycle resumes from the key of the first entry not processed
+// even if entries before it were created or deleted in the meantime
+//------------------------------------------------------------------------------
+TEST(NsScanBus, ResumeByKey)
+{
+  auto ns = MakeNamespace(3000, 10);
+  std::atomic<bool> master {true};
+  NsScanBus bus(std::make_unique<FakeSource>(ns), [&master]() {
+    return master.load();
+  });
+  bus.SetEnabled(true);
+  RecordingConsumer consumer("consumer");
+  bool release = false;
+  consumer.mOnFile = [&](size_t count, std::unique_lock<std::mutex>& lock) {
+    if ((count == 1500) && !release) {
+      // Lose mastership while this entry is being processed
+      master = false;
+      consumer.mCond.wait(lock, [&]() {
+        return release;
+      });
+    }
+  };
+  bus.Register(&consumer);
+  ASSERT_FALSE(RunCycle(bus));
+  {
+    std::unique_lock<std::mutex> lock(consumer.mMutex);
+    release = true;
+    consumer.mCond.notify_all();
+  }
+  ASSERT_TRUE(consumer.WaitDone(std::chrono::seconds(10)));
+  // The entry in flight is the first one to be delivered again
+  const std::vector<uint64_t> first = FileIds(*ns);
+  const uint64_t resume_id = first[1499];
+  ASSERT_EQ("0", ns->mCheckpoint["phase"]);
+  ASSERT_EQ(std::to_string(resume_id), ns->mCheckpoint["id"]);
+  const ScanKey resume_key(std::stoull(ns->mCheckpoint["parent"]),
+                           ns->mCheckpoint["name"], resume_id);
+  // Delete and create entries before and after the resume position
+  {
+    std::unique_lock<std::mutex> lock(ns->mMutex);
+
+    for (size_t i = 0; i < 20; ++i) {
+      auto it = ns->mFiles.begin();
+      std::advance(it, i * 10);
+      ns->mFiles.erase(it);
+    }
+  }
+
+  for (uint64_t id = 5000; id < 5020; ++id) {
+    ns->AddFile(50, "new" + std::to_string(id), id);
+    ns->AddFile(999, "new" + std::to_string(id), id + 100);
+  }
+
+  consumer.Reset();
+  master = true;
+  ASSERT_TRUE(RunCycle(bus));
+  ASSERT_TRUE(consumer.WaitDone(std::chrono::seconds(10)));
+  ASSERT_TRUE(consumer.mResumed);
+  ASSERT_TRUE(consumer.mComplete);
+  ASSERT_EQ(FileIds(*ns, resume_key), consumer.mFiles);
+  ASSERT_EQ(resume_id, consumer.mFiles.front());
+  ASSERT_EQ(10u, consumer.mContainers.size());
+  ASSERT_EQ("2", ns->mCheckpoint["phase"]);
+  bus.Unregister(&consumer);
+}
+
+//------------------------------------------------------------------------------
+// A checkpoint holding only an ordinal offset restarts its phase
+//------------------------------------------------------------------------------
+TEST(NsScanBus, ResumeOffsetCheckpoint)
+{
+  auto ns = MakeNamespace(100, 0);
+  ns->mCheckpoint = {{"cycle", "7"}, {"phase", "0"}, {"offset", "42"}};
+  NsScanBus bus(std::make_unique<FakeSource>(ns), []() {
+    return true;
+  });
+  bus.SetEnabled(true);
+  RecordingConsumer consumer("consumer");
+  bus.Register(&consumer);
+  ASSERT_TRUE(RunCycle(bus));
+  ASSERT_TRUE(consumer.WaitDone(std::chrono::seconds(10)));
+  ASSERT_EQ(7u, consumer.mCycle);
+  ASSERT_FALSE(consumer.mResumed);
+  ASSERT_EQ(FileIds(*ns), consumer.mFiles);
+  bus.Unregister(&consumer);
+}
@@ -95,6 +95,32 @@ public:
     mStore->erase(bulkRequest->getId());
   }
 
+  std::unique_ptr<File> getFile(const std::string& bulkRequestId,
+                                const BulkRequest::Type& type,
+                                const std::string& path) override
+  {
+    if (type != BulkRequest::PREPARE_STAGE) {
+      return nullptr;
+    }
+
+    const auto it = mStore->find(bulkRequestId);
+
+    if (it == mStore->end()) {
+      return nullptr;
+    }
+
+    const auto& files = it->second->getFilesMap();
+    const auto fileItor = files->find(path);
+
+    if (fileItor == files->end()) {
+      return nullptr;
+    }
+
+    auto file = std::make_unique<File>(path);
+    file->setError(fileItor->second->getError());
+    return file;
+  }
+
 private:
   static std::unique_ptr<StageBulkRequest> cloneStageRequest(
     const StageBulkRequest& src)
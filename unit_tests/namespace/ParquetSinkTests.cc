@@ -0,0 +1,215 @@
+//------------------------------------------------------------------------------
+// File: ParquetSinkTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "namespace/ns_quarkdb/inspector/ParquetSink.hh"
+#include "namespace/ns_quarkdb/inspector/Printing.hh"
+#include <arrow/api.h>
+#include <parquet/arrow/reader.h>
+#include <sstream>
+#include <unistd.h>
+
+using namespace eos;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Serialize timespec the way it is stored in the metadata protobufs
+//------------------------------------------------------------------------------
+std::string
+Timespec(time_t sec, long nsec)
+{
+  struct timespec ts = {};
+  ts.tv_sec = sec;
+  ts.tv_nsec = nsec;
+  return std::string((const char*)&ts, sizeof(ts));
+}
+
+//------------------------------------------------------------------------------
+// Get the values of an integer column
+//------------------------------------------------------------------------------
+template<typename ArrayType>
+std::vector<int64_t>
+IntValues(const std::shared_ptr<arrow::ChunkedArray>& column)
+{
+  std::vector<int64_t> values;
+
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<ArrayType>(chunk);
+
+    for (int64_t i = 0; i < array->length(); ++i) {
+      values.push_back(array->IsNull(i) ? -1 : (int64_t) array->Value(i));
+    }
+  }
+
+  return values;
+}
+
+//------------------------------------------------------------------------------
+// Get the values of a string column, null values are returned as "<null>"
+//------------------------------------------------------------------------------
+std::vector<std::string>
+StringValues(const std::shared_ptr<arrow::ChunkedArray>& column)
+{
+  std::vector<std::string> values;
+
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<arrow::StringArray>(chunk);
+
+    for (int64_t i = 0; i < array->length(); ++i) {
+      values.push_back(array->IsNull(i) ? "<null>" : array->GetString(i));
+    }
+  }
+
+  return values;
+}
+
+//------------------------------------------------------------------------------
+// Get the location lists, null lists are returned as empty
+//------------------------------------------------------------------------------
+std::vector<std::vector<uint32_t>>
+ListValues(const std::shared_ptr<arrow::ChunkedArray>& column)
+{
+  std::vector<std::vector<uint32_t>> values;
+
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<arrow::ListArray>(chunk);
+    auto items = std::static_pointer_cast<arrow::UInt32Array>(array->values());
+
+    for (int64_t i = 0; i < array->length(); ++i) {
+      std::vector<uint32_t> list;
+
+      for (int32_t j = array->value_offset(i); j < array->value_offset(i + 1);
+           ++j) {
+        list.push_back(items->Value(j));
+      }
+
+      values.push_back(list);
+    }
+  }
+
+  return values;
+}
+}
+
+//------------------------------------------------------------------------------
+// Rows written by the sink are read back unchanged, split in row groups
+//------------------------------------------------------------------------------
+TEST(ParquetSink, RoundTrip)
+{
+  char path[] = "/tmp/eos-parquet-sink-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_NE(-1, fd);
+  close(fd);
+  std::ostringstream out, err;
+  std::string err_msg;
+  ParquetSinkOptions opts;
+  opts.rowGroupSize = 2;
+  opts.xattrs = {"user.tag"};
+  {
+    std::unique_ptr<ParquetSink> sink = ParquetSink::Create(path, opts, out, err,
+                                        err_msg);
+    ASSERT_NE(nullptr, sink) << err_msg;
+    FilePrintingOptions fopts;
+    ContainerPrintingOptions copts;
+
+    for (uint64_t id = 1; id <= 3; ++id) {
+      eos::ns::FileMdProto proto;
+      proto.set_id(id);
+      proto.set_cont_id(10);
+      proto.set_name("file" + std::to_string(id));
+      proto.set_uid(1000 + id);
+      proto.set_gid(2000);
+      proto.set_size(id * 4096);
+      proto.set_ctime(Timespec(1700000000, 5));
+      proto.set_mtime(Timespec(1700000001, 0));
+      proto.add_locations(id);
+      proto.add_locations(id + 100);
+
+      if (id == 2) {
+        (*proto.mutable_xattrs())["user.tag"] = "hot";
+      }
+
+      sink->printWithCustomPath(proto, fopts, "/eos/dir/file" + std::to_string(id));
+    }
+
+    eos::ns::ContainerMdProto cont;
+    cont.set_id(10);
+    cont.set_parent_id(1);
+    cont.set_name("dir");
+    cont.set_mode(0755);
+    cont.set_tree_size(12288);
+    cont.set_ctime(Timespec(1600000000, 0));
+    cont.set_mtime(Timespec(1600000000, 0));
+    sink->print(cont, copts);
+    ASSERT_EQ(4u, sink->getRows());
+    ASSERT_TRUE(sink->close());
+  }
+  ASSERT_TRUE(err.str().empty()) << err.str();
+  // Read the file back
+  parquet::arrow::FileReaderBuilder builder;
+  ASSERT_TRUE(builder.OpenFile(path).ok());
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  ASSERT_TRUE(builder.Build(&reader).ok());
+  ASSERT_EQ(2, reader->num_row_groups());
+  std::shared_ptr<arrow::Table> table;
+  ASSERT_TRUE(reader->ReadTable(&table).ok());
+  ASSERT_EQ(4, table->num_rows());
+  ASSERT_EQ(20, table->num_columns());
+  ASSERT_EQ((std::vector<std::string> {"file", "file", "file", "container"}),
+            StringValues(table->GetColumnByName("type")));
+  ASSERT_EQ((std::vector<int64_t> {1, 2, 3, 10}),
+            IntValues<arrow::UInt64Array>(table->GetColumnByName("id")));
+  ASSERT_EQ((std::vector<int64_t> {10, 10, 10, 1}),
+            IntValues<arrow::UInt64Array>(table->GetColumnByName("parent_id")));
+  ASSERT_EQ((std::vector<std::string> {"file1", "file2", "file3", "dir"}),
+            StringValues(table->GetColumnByName("name")));
+  ASSERT_EQ((std::vector<std::string> {"/eos/dir/file1", "/eos/dir/file2",
+                                        "/eos/dir/file3", "<null>"}),
+            StringValues(table->GetColumnByName("path")));
+  ASSERT_EQ((std::vector<int64_t> {1001, 1002, 1003, 0}),
+            IntValues<arrow::UInt32Array>(table->GetColumnByName("uid")));
+  ASSERT_EQ((std::vector<int64_t> {4096, 8192, 12288, 12288}),
+            IntValues<arrow::UInt64Array>(table->GetColumnByName("size")));
+  ASSERT_EQ((std::vector<int64_t> { -1, -1, -1, 0755}),
+            IntValues<arrow::UInt32Array>(table->GetColumnByName("mode")));
+  ASSERT_EQ(1700000000000000005ll,
+            IntValues<arrow::TimestampArray>(table->GetColumnByName("ctime"))[0]);
+  ASSERT_EQ((std::vector<std::vector<uint32_t>> {{1, 101}, {2, 102}, {3, 103}, {}}),
+            ListValues(table->GetColumnByName("locations")));
+  ASSERT_EQ((std::vector<std::string> {"<null>", "hot", "<null>", "<null>"}),
+            StringValues(table->GetColumnByName("xattr.user.tag")));
+  unlink(path);
+}
+
+//------------------------------------------------------------------------------
+// Creating a sink in a missing directory fails with an error message
+//------------------------------------------------------------------------------
+TEST(ParquetSink, CreateFailure)
+{
+  std::ostringstream out, err;
+  std::string err_msg;
+  ParquetSinkOptions opts;
+  ASSERT_EQ(nullptr, ParquetSink::Create("/nonexistent/dir/out.parquet", opts,
+                                         out, err, err_msg));
+  ASSERT_FALSE(err_msg.empty());
+}
@@ -0,0 +1,133 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Tests related to the QuarkDB bulk-request store
+//------------------------------------------------------------------------------
+
+#include "unit_tests/with_qdb/TestUtils.hh"
+#include "mgm/bulk-request/dao/qdb/QdbBulkRequestStore.hh"
+#include <cstdlib>
+
+using namespace eos;
+using eos::mgm::bulk::BulkRequest;
+using eos::mgm::bulk::QdbBulkRequestStore;
+class BulkRequestStoreTests : public eos::UnitTestsWithQDBFixture {};
+
+TEST_F(BulkRequestStoreTests, SaveGetDelete)
+{
+  QdbBulkRequestStore store(getContactDetails());
+  QdbBulkRequestStore::Entries entries {
+    {"issuer_uid", "1000"},
+    {"creation_time", "50"},
+    {QdbBulkRequestStore::LAST_ACCESS_TIME_FIELD, "100"},
+    {"fid.1", ""},
+    {"fid.2", "prepare submission error"},
+    {"fid.%2Feos%2Fmissing%2Efile", ""}
+  };
+  ASSERT_FALSE(store.exists("req", BulkRequest::PREPARE_STAGE));
+  store.saveBulkRequest("req", BulkRequest::PREPARE_STAGE, entries);
+  ASSERT_TRUE(store.exists("req", BulkRequest::PREPARE_STAGE));
+  // Cancellations update the stage bulk-request
+  ASSERT_TRUE(store.exists("req", BulkRequest::PREPARE_CANCEL));
+  QdbBulkRequestStore::Entries fetched;
+  ASSERT_TRUE(store.getBulkRequest("req", BulkRequest::PREPARE_STAGE, fetched));
+  ASSERT_EQ(fetched, entries);
+  std::string value;
+  ASSERT_TRUE(store.getEntry("req", BulkRequest::PREPARE_STAGE, "fid.2", value));
+  ASSERT_EQ(value, "prepare submission error");
+  ASSERT_TRUE(store.getEntry("req", BulkRequest::PREPARE_STAGE, "fid.1", value));
+  ASSERT_EQ(value, "");
+  ASSERT_FALSE(store.getEntry("req", BulkRequest::PREPARE_STAGE, "fid.3", value));
+  ASSERT_FALSE(store.getEntry("other", BulkRequest::PREPARE_STAGE, "fid.1",
+                              value));
+  // Last access time in the index
+  ASSERT_EQ(store.getBulkRequestsNotAccessedSince(BulkRequest::PREPARE_STAGE,
+            100).size(), 0u);
+  ASSERT_EQ(store.getBulkRequestsNotAccessedSince(BulkRequest::PREPARE_STAGE,
+            101), std::vector<std::string> {"req"});
+  store.updateLastAccessTime("req", BulkRequest::PREPARE_CANCEL, 200);
+  ASSERT_EQ(store.getBulkRequestsNotAccessedSince(BulkRequest::PREPARE_STAGE,
+            150).size(), 0u);
+  ASSERT_TRUE(store.getEntry("req", BulkRequest::PREPARE_STAGE,
+                             QdbBulkRequestStore::LAST_ACCESS_TIME_FIELD, value));
+  ASSERT_EQ(value, "200");
+  // Saving again replaces the previous content
+  store.saveBulkRequest("req", BulkRequest::PREPARE_STAGE, {{"fid.4", ""}});
+  fetched.clear();
+  ASSERT_TRUE(store.getBulkRequest("req", BulkRequest::PREPARE_STAGE, fetched));
+  ASSERT_EQ(fetched.size(), 1u);
+  store.deleteBulkRequest("req", BulkRequest::PREPARE_STAGE);
+  ASSERT_FALSE(store.exists("req", BulkRequest::PREPARE_STAGE));
+  fetched.clear();
+  ASSERT_FALSE(store.getBulkRequest("req", BulkRequest::PREPARE_STAGE, fetched));
+  ASSERT_EQ(store.getBulkRequestsNotAccessedSince(BulkRequest::PREPARE_STAGE,
+            1000).size(), 0u);
+}
+
+//------------------------------------------------------------------------------
+// Persisting a bulk-request with many files (prepare), fetching it back
+// (query-prepare) and looking up single files (cancel). The sizes are bounded
+// by EOS_BULK_REQUEST_TEST_FILES, 1k files by default, and go up to 1M files.
+//------------------------------------------------------------------------------
+TEST_F(BulkRequestStoreTests, LargeRequest)
+{
+  size_t max_files = 1000;
+
+  if (getenv("EOS_BULK_REQUEST_TEST_FILES")) {
+    max_files = std::strtoull(getenv("EOS_BULK_REQUEST_TEST_FILES"), nullptr, 10);
+  }
+
+  QdbBulkRequestStore store(getContactDetails());
+
+  for (size_t nb_files : {1000ul, 100000ul, 1000000ul}) {
+    if (nb_files > max_files) {
+      break;
+    }
+
+    const std::string id = "large-" + std::to_string(nb_files);
+    QdbBulkRequestStore::Entries entries {
+      {"issuer_uid", "1000"},
+      {"creation_time", "50"},
+      {QdbBulkRequestStore::LAST_ACCESS_TIME_FIELD, "100"}
+    };
+
+    for (size_t i = 1; i <= nb_files; ++i) {
+      entries.emplace("fid." + std::to_string(i), std::to_string(i));
+    }
+
+    store.saveBulkRequest(id, BulkRequest::PREPARE_STAGE, entries);
+    QdbBulkRequestStore::Entries fetched;
+    ASSERT_TRUE(store.getBulkRequest(id, BulkRequest::PREPARE_STAGE, fetched));
+    ASSERT_EQ(fetched, entries);
+    std::string value;
+
+    for (size_t i = 0; i < 1000; ++i) {
+      const size_t fid = 1 + (i * 7919) % nb_files;
+      ASSERT_TRUE(store.getEntry(id, BulkRequest::PREPARE_STAGE,
+                                 "fid." + std::to_string(fid), value));
+      ASSERT_EQ(value, std::to_string(fid));
+    }
+
+    ASSERT_FALSE(store.getEntry(id, BulkRequest::PREPARE_STAGE,
+                                "fid." + std::to_string(nb_files + 1), value));
+    store.deleteBulkRequest(id, BulkRequest::PREPARE_STAGE);
+    QdbBulkRequestStore::Entries deleted;
+    ASSERT_FALSE(store.getBulkRequest(id, BulkRequest::PREPARE_STAGE, deleted));
+  }
+}
@@ -0,0 +1,233 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Tests related to the QuarkDB workflow job queue
+//------------------------------------------------------------------------------
+
+#include "unit_tests/with_qdb/TestUtils.hh"
+#include "mgm/wfe/WFEQueue.hh"
+#include <qclient/QClient.hh>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+using namespace eos;
+using eos::mgm::WFEQueue;
+class WFEQueueTests : public eos::UnitTestsWithQDBFixture {};
+
+namespace
+{
+WFEQueue::Item MakeItem(const std::string& id, time_t when)
+{
+  WFEQueue::Item item;
+  item.mId = id;
+  item.mTime = when;
+  item.mFields["fxid"] = "0000abcd";
+  item.mFields["event"] = "closew";
+  item.mFields["action"] = "bash:shell:log echo <eos::wfe::path>";
+  item.mFields["errmsg"] = "";
+  return item;
+}
+}
+
+TEST_F(WFEQueueTests, Serialization)
+{
+  WFEQueue::Item item = MakeItem("1:0000abcd:closew:default", 1234);
+  item.mFields["with:colons"] = "12:34:";
+  WFEQueue::Item parsed;
+  ASSERT_TRUE(WFEQueue::Deserialize(item.mId, WFEQueue::Serialize(item),
+                                    parsed));
+  ASSERT_EQ(parsed.mId, item.mId);
+  ASSERT_EQ(parsed.mTime, item.mTime);
+  ASSERT_EQ(parsed.mFields, item.mFields);
+  ASSERT_FALSE(WFEQueue::Deserialize("id", "", parsed));
+  ASSERT_FALSE(WFEQueue::Deserialize("id", "4:12", parsed));
+  ASSERT_FALSE(WFEQueue::Deserialize("id", "4:12345:key", parsed));
+}
+
+TEST_F(WFEQueueTests, EnqueueClaimAck)
+{
+  using namespace std::chrono;
+  WFEQueue queue(getContactDetails());
+  ASSERT_EQ(queue.Recover(), 0);
+  const time_t now = time(nullptr);
+  ASSERT_TRUE(queue.Enqueue(MakeItem("late", now - 10)));
+  ASSERT_TRUE(queue.Enqueue(MakeItem("early", now - 20)));
+  ASSERT_TRUE(queue.Enqueue(MakeItem("future", now + 3600)));
+  // Due jobs are claimed in due time order
+  auto items = queue.ClaimDue(10, milliseconds(0));
+  ASSERT_EQ(items.size(), 2u);
+  ASSERT_EQ(items[0].mId, "early");
+  ASSERT_EQ(items[1].mId, "late");
+  ASSERT_EQ(items[0].mFields, MakeItem("early", 0).mFields);
+  WFEQueue::Stats stats = queue.GetStats();
+  ASSERT_EQ(stats.mPending, 1u);
+  ASSERT_EQ(stats.mClaimed, 2u);
+  ASSERT_EQ(stats.mDispatched, 2u);
+  ASSERT_GE(stats.mMaxLatencyMs, 20000u);
+  // Nothing else is due
+  ASSERT_TRUE(queue.ClaimDue(10, milliseconds(100)).empty());
+  // The claim limit is respected
+  ASSERT_TRUE(queue.Enqueue(MakeItem("new", now)));
+  ASSERT_TRUE(queue.ClaimDue(0, milliseconds(0)).empty());
+  ASSERT_EQ(queue.ClaimDue(1, milliseconds(0)).size(), 1u);
+  ASSERT_TRUE(queue.Ack("early"));
+  ASSERT_TRUE(queue.Ack("late"));
+  ASSERT_TRUE(queue.RecordFailure(items[1], 5, "failed"));
+  ASSERT_EQ(queue.GetStats().mClaimed, 1u);
+  // A job enqueued while waiting wakes up the claimer
+  std::thread producer([&queue]() {
+    std::this_thread::sleep_for(milliseconds(100));
+    queue.Enqueue(MakeItem("event", time(nullptr)));
+  });
+  auto start = steady_clock::now();
+  items = queue.ClaimDue(10, milliseconds(10000));
+  producer.join();
+  ASSERT_EQ(items.size(), 1u);
+  ASSERT_EQ(items[0].mId, "event");
+  ASSERT_LT(steady_clock::now() - start, milliseconds(5000));
+  // Wakeup interrupts the wait
+  std::thread waker([&queue]() {
+    std::this_thread::sleep_for(milliseconds(100));
+    queue.Wakeup();
+  });
+  start = steady_clock::now();
+  ASSERT_TRUE(queue.ClaimDue(10, milliseconds(10000)).empty());
+  waker.join();
+  ASSERT_LT(steady_clock::now() - start, milliseconds(5000));
+  auto qcl = makeQClient();
+  auto reply = qcl->exec("deque-len", "eos-wfe-queue:failed").get();
+  ASSERT_EQ(reply->integer, 1);
+}
+
+TEST_F(WFEQueueTests, Recover)
+{
+  const time_t now = time(nullptr);
+  {
+    WFEQueue queue(getContactDetails());
+    ASSERT_TRUE(queue.Enqueue(MakeItem("a", now)));
+    ASSERT_TRUE(queue.Enqueue(MakeItem("b", now)));
+    ASSERT_TRUE(queue.Enqueue(MakeItem("c", now + 3600)));
+    ASSERT_EQ(queue.ClaimDue(1, std::chrono::milliseconds(0)).size(), 1u);
+  }
+  // The claimed job was never acknowledged and is pending again
+  WFEQueue queue(getContactDetails());
+  ASSERT_EQ(queue.Recover(), 3);
+  auto items = queue.ClaimDue(10, std::chrono::milliseconds(0));
+  ASSERT_EQ(items.size(), 2u);
+
+  for (const auto& item : items) {
+    ASSERT_TRUE(queue.Ack(item.mId));
+  }
+
+  ASSERT_EQ(queue.Recover(), 1);
+  ASSERT_EQ(queue.GetStats().mClaimed, 0u);
+}
+
+//------------------------------------------------------------------------------
+// A job removed from the pending ones by somebody else is neither dispatched
+// nor left claimed to be run again on recovery
+//------------------------------------------------------------------------------
+TEST_F(WFEQueueTests, ClaimNoLongerPending)
+{
+  WFEQueue queue(getContactDetails());
+  ASSERT_EQ(queue.Recover(), 0);
+  ASSERT_TRUE(queue.Enqueue(MakeItem("gone", time(nullptr))));
+  auto qcl = makeQClient();
+  auto reply = qcl->exec("HDEL", "eos-wfe-queue:pending", "gone").get();
+  ASSERT_EQ(reply->integer, 1);
+  ASSERT_TRUE(queue.ClaimDue(10, std::chrono::milliseconds(0)).empty());
+  reply = qcl->exec("HEXISTS", "eos-wfe-queue:claimed", "gone").get();
+  ASSERT_EQ(reply->integer, 0);
+  WFEQueue recovered(getContactDetails());
+  ASSERT_EQ(recovered.Recover(), 0);
+}
+
+//------------------------------------------------------------------------------
+// Synthetic workflow events fired from several producers while workers claim
+// and acknowledge them, checking that every event is dispatched exactly
+// once. The number of events is given by EOS_WFE_QUEUE_TEST_EVENTS, 1k by
+// default.
+//------------------------------------------------------------------------------
+TEST_F(WFEQueueTests, LoadTest)
+{
+  using namespace std::chrono;
+  size_t nb_events = 1000;
+
+  if (getenv("EOS_WFE_QUEUE_TEST_EVENTS")) {
+    nb_events = std::strtoull(getenv("EOS_WFE_QUEUE_TEST_EVENTS"), nullptr, 10);
+  }
+
+  const size_t nb_producers = 8;
+  const size_t nb_workers = 8;
+  WFEQueue queue(getContactDetails());
+  ASSERT_EQ(queue.Recover(), 0);
+  std::unique_ptr<std::atomic<int>[]> seen(new std::atomic<int>[nb_events]());
+  std::atomic<size_t> processed {0};
+  std::atomic<size_t> duplicates {0};
+  std::atomic<bool> stop {false};
+  std::vector<std::thread> threads;
+  const auto deadline = steady_clock::now() + minutes(10);
+
+  for (size_t w = 0; w < nb_workers; ++w) {
+    threads.emplace_back([&]() {
+      while (!stop) {
+        for (const auto& item : queue.ClaimDue(100, milliseconds(100))) {
+          const size_t idx = std::strtoull(item.mFields.at("idx").c_str(),
+                                           nullptr, 10);
+
+          if (seen[idx]++) {
+            ++duplicates;
+          }
+
+          queue.Ack(item.mId);
+          ++processed;
+        }
+      }
+    });
+  }
+
+  for (size_t p = 0; p < nb_producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (size_t i = p; i < nb_events; i += nb_producers) {
+        WFEQueue::Item item = MakeItem(std::to_string(i), time(nullptr));
+        item.mFields["idx"] = std::to_string(i);
+        queue.Enqueue(item);
+      }
+    });
+  }
+
+  while ((processed < nb_events) && (steady_clock::now() < deadline)) {
+    std::this_thread::sleep_for(milliseconds(10));
+  }
+
+  stop = true;
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const WFEQueue::Stats stats = queue.GetStats();
+  ASSERT_EQ(processed, nb_events);
+  ASSERT_EQ(duplicates, 0u);
+  ASSERT_EQ(stats.mPending, 0u);
+  ASSERT_EQ(stats.mClaimed, 0u);
+}